@@ -0,0 +1,49 @@
+# Toolchain for the bare-metal Cortex-M builds in host_sim/mcu:
+#
+#   cmake -S host_sim/mcu -B build-mcu \
+#         -DCMAKE_TOOLCHAIN_FILE=host_sim/cmake/arm-none-eabi.cmake \
+#         -DHOST_SIM_MCU_CPU=cortex-m7 -DCMSIS_DSP_ROOT=... -DCMSIS_CORE_ROOT=...
+#
+# HOST_SIM_MCU_CPU picks -mcpu and the matching FPU flags (cortex-m0plus,
+# cortex-m4 or cortex-m7; cortex-m55 for Helium).  The compilers come from
+# PATH unless ARM_TOOLCHAIN_DIR names the toolchain's bin directory.
+
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+set(HOST_SIM_MCU_CPU "cortex-m4" CACHE STRING "Target core: cortex-m0plus, cortex-m4, cortex-m7 or cortex-m55")
+set(ARM_TOOLCHAIN_DIR "" CACHE PATH "Directory holding arm-none-eabi-gcc (default: PATH)")
+if(ARM_TOOLCHAIN_DIR)
+    set(_arm_prefix "${ARM_TOOLCHAIN_DIR}/arm-none-eabi-")
+else()
+    set(_arm_prefix "arm-none-eabi-")
+endif()
+
+set(CMAKE_C_COMPILER "${_arm_prefix}gcc")
+set(CMAKE_CXX_COMPILER "${_arm_prefix}g++")
+set(CMAKE_ASM_COMPILER "${_arm_prefix}gcc")
+set(CMAKE_OBJCOPY "${_arm_prefix}objcopy")
+set(CMAKE_SIZE "${_arm_prefix}size")
+
+# No hosted link step when CMake probes the compilers.
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+if(HOST_SIM_MCU_CPU STREQUAL "cortex-m0plus")
+    set(_arm_cpu_flags "-mcpu=cortex-m0plus -mthumb -mfloat-abi=soft")
+elseif(HOST_SIM_MCU_CPU STREQUAL "cortex-m4")
+    set(_arm_cpu_flags "-mcpu=cortex-m4 -mthumb -mfpu=fpv4-sp-d16 -mfloat-abi=hard")
+elseif(HOST_SIM_MCU_CPU STREQUAL "cortex-m7")
+    set(_arm_cpu_flags "-mcpu=cortex-m7 -mthumb -mfpu=fpv5-d16 -mfloat-abi=hard")
+elseif(HOST_SIM_MCU_CPU STREQUAL "cortex-m55")
+    # MVE (Helium); host_sim/mcu adds ARM_MATH_MVEI for the CMSIS-DSP Helium kernels.
+    set(_arm_cpu_flags "-mcpu=cortex-m55 -mthumb -mfloat-abi=hard")
+else()
+    message(FATAL_ERROR "Unknown HOST_SIM_MCU_CPU '${HOST_SIM_MCU_CPU}'")
+endif()
+
+set(CMAKE_C_FLAGS_INIT "${_arm_cpu_flags} -ffunction-sections -fdata-sections")
+set(CMAKE_CXX_FLAGS_INIT "${_arm_cpu_flags} -ffunction-sections -fdata-sections")
+set(CMAKE_ASM_FLAGS_INIT "${_arm_cpu_flags}")
+set(CMAKE_EXE_LINKER_FLAGS_INIT "${_arm_cpu_flags} -Wl,--gc-sections")
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
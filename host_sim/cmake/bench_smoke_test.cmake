@@ -0,0 +1,45 @@
+# bench_smoke_test.cmake
+# Run every host_sim_bench benchmark once at a tiny --min-time, require the
+# allocation-free kernels to stay allocation-free, and round-trip the JSON
+# through tools/compare_bench.py.
+# Expects: HOST_SIM_BENCH, COMPARE_SCRIPT, WORK_DIR
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+set(RESULTS "${WORK_DIR}/bench.json")
+
+execute_process(
+    COMMAND "${HOST_SIM_BENCH}" --min-time 0.002 --repetitions 1 --json "${RESULTS}"
+    OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 120)
+message("BENCH: ${_out}")
+if(NOT _rc EQUAL 0)
+    message(FATAL_ERROR "host_sim_bench failed (rc=${_rc}):\n${_err}")
+endif()
+
+file(READ "${RESULTS}" _json)
+string(JSON _count LENGTH "${_json}" benchmarks)
+if(_count LESS 20)
+    message(FATAL_ERROR "Expected at least 20 benchmarks, got ${_count}")
+endif()
+math(EXPR _last "${_count} - 1")
+foreach(_i RANGE ${_last})
+    string(JSON _name GET "${_json}" benchmarks ${_i} name)
+    string(JSON _allocs GET "${_json}" benchmarks ${_i} allocs_per_iter)
+    if(_name MATCHES "^(demod/|soft/llrs|soft/hamming)" AND NOT _allocs EQUAL 0)
+        message(FATAL_ERROR "${_name}: ${_allocs} allocations per iteration, expected none")
+    endif()
+endforeach()
+
+find_program(PYTHON_EXE NAMES python3 python)
+if(PYTHON_EXE)
+    execute_process(
+        COMMAND "${PYTHON_EXE}" "${COMPARE_SCRIPT}" "${RESULTS}" "${RESULTS}"
+        OUTPUT_VARIABLE _cmp_out ERROR_VARIABLE _cmp_err RESULT_VARIABLE _cmp_rc TIMEOUT 30)
+    if(NOT _cmp_rc EQUAL 0)
+        message(FATAL_ERROR "compare_bench failed:\n${_cmp_out}${_cmp_err}")
+    endif()
+    message("COMPARE: ${_cmp_out}")
+endif()
+
+message("BENCH_SMOKE_OK: ${_count} benchmarks")
@@ -0,0 +1,44 @@
+# replay_bench_test.cmake
+# Encode a packet with lora_tx, run `lora_replay --bench 2` on it and check
+# that both runs decode it with CRC OK and the report carries throughput,
+# latency percentiles and the phase breakdown.
+# Expects: LORA_TX, LORA_REPLAY, WORK_DIR
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+set(TX_IQ "${WORK_DIR}/tx.cf32")
+set(META  "${WORK_DIR}/tx.json")
+set(PAYLOAD "bench")
+
+file(WRITE "${META}"
+    "{\"sf\":7,\"bw\":125000,\"sample_rate\":500000,\"cr\":1,\"payload_len\":5,\"has_crc\":true,\"implicit_header\":false,\"ldro\":false,\"preamble_len\":8,\"sync_word\":18}")
+
+execute_process(
+    COMMAND "${LORA_TX}" --sf 7 --cr 1 --bw 125000 --sample-rate 500000
+        --payload "${PAYLOAD}" --output "${TX_IQ}"
+    OUTPUT_VARIABLE _tx_out ERROR_VARIABLE _tx_err RESULT_VARIABLE _tx_rc TIMEOUT 30)
+if(NOT _tx_rc EQUAL 0)
+    message(FATAL_ERROR "TX encode failed:\n${_tx_err}")
+endif()
+
+# The metadata is found next to the capture.
+execute_process(
+    COMMAND "${LORA_REPLAY}" --iq "${TX_IQ}" --payload "${PAYLOAD}" --bench 2
+    OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 60)
+message("BENCH: ${_out}")
+if(NOT _rc EQUAL 0)
+    message(FATAL_ERROR "lora_replay --bench failed (rc=${_rc}):\n${_err}")
+endif()
+
+foreach(_expect
+        "run 0: 1 packet\\(s\\), 1 CRC OK"
+        "run 1: 1 packet\\(s\\), 1 CRC OK"
+        "packets/s, real-time factor [0-9.]+x, 2/2 CRC OK"
+        "latency: p50 [0-9.]+ ms, p99 [0-9.]+ ms"
+        "alignment +[0-9.]+ ms"
+        "payload +[0-9.]+ ms")
+    if(NOT _out MATCHES "${_expect}")
+        message(FATAL_ERROR "Bench report is missing '${_expect}'")
+    endif()
+endforeach()
@@ -0,0 +1,65 @@
+# replay_packet_sink_test.cmake
+# Encode two packets with lora_tx, stream them through
+# `lora_replay --stream --packet-format ndjson` and check stdout holds
+# exactly one JSON record per packet (CRC OK, payload hex) while the
+# human-readable lines move to stderr; then check `--packet-format binary
+# --packet-output` writes the records to the file instead.
+# Expects: LORA_TX, LORA_REPLAY, WORK_DIR
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+set(TX_IQ "${WORK_DIR}/tx.cf32")
+set(META  "${WORK_DIR}/tx.json")
+set(RECORDS "${WORK_DIR}/packets.bin")
+
+file(WRITE "${META}"
+    "{\"sf\":7,\"bw\":125000,\"sample_rate\":500000,\"cr\":1,\"payload_len\":5,\"has_crc\":true,\"implicit_header\":false,\"ldro\":false,\"preamble_len\":8,\"sync_word\":18}")
+
+execute_process(
+    COMMAND "${LORA_TX}" --sf 7 --cr 1 --bw 125000 --sample-rate 500000
+        --payload "sink!" --count 2 --seed 1 --output "${TX_IQ}"
+    OUTPUT_VARIABLE _tx_out ERROR_VARIABLE _tx_err RESULT_VARIABLE _tx_rc TIMEOUT 30)
+if(NOT _tx_rc EQUAL 0)
+    message(FATAL_ERROR "TX encode failed:\n${_tx_err}")
+endif()
+
+execute_process(
+    COMMAND "${LORA_REPLAY}" --stream --metadata "${META}" --packet-format ndjson
+    INPUT_FILE "${TX_IQ}"
+    OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 60)
+message("NDJSON: ${_out}")
+if(NOT _rc EQUAL 0)
+    message(FATAL_ERROR "lora_replay --packet-format ndjson failed (rc=${_rc}):\n${_err}")
+endif()
+string(REGEX MATCHALL "[^\n]+" _lines "${_out}")
+list(LENGTH _lines _n)
+if(NOT _n EQUAL 2)
+    message(FATAL_ERROR "Expected 2 NDJSON records on stdout, got ${_n}")
+endif()
+foreach(_line IN LISTS _lines)
+    if(NOT _line MATCHES "^{\"index\":[01],.*\"sf\":7,\"cr\":1,.*\"crc_ok\":true,.*\"payload\":\"73696e6b21\"}$")
+        message(FATAL_ERROR "Unexpected NDJSON record: ${_line}")
+    endif()
+endforeach()
+if(NOT _err MATCHES "EOF — 2 packet")
+    message(FATAL_ERROR "Human-readable summary did not go to stderr:\n${_err}")
+endif()
+
+execute_process(
+    COMMAND "${LORA_REPLAY}" --stream --metadata "${META}" --packet-format binary
+        --packet-output "${RECORDS}"
+    INPUT_FILE "${TX_IQ}"
+    OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 60)
+if(NOT _rc EQUAL 0)
+    message(FATAL_ERROR "lora_replay --packet-format binary failed (rc=${_rc}):\n${_err}")
+endif()
+if(NOT _out MATCHES "EOF — 2 packet")
+    message(FATAL_ERROR "Summary missing from stdout with --packet-output:\n${_out}")
+endif()
+# Two version-2 records: a 4-byte size, 54 fixed bytes, the 5-byte
+# payload and the 8-byte source time each.
+file(SIZE "${RECORDS}" _size)
+if(NOT _size EQUAL 142)
+    message(FATAL_ERROR "Binary packet output is ${_size} bytes, expected 142")
+endif()
@@ -0,0 +1,74 @@
+# replay_stage_dump_test.cmake
+# Encode one packet with lora_tx and dump its decode stages with
+# `lora_replay --dump-stages` three ways: text, binary and delta.  Convert
+# the .stage files back to text with tools/convert_stage_dumps.py and check
+# they match the text dumps line for line, so the C++ writer and the Python
+# reader agree on the format; then check text -> delta -> text through the
+# converter alone is lossless.
+# Expects: LORA_TX, LORA_REPLAY, CONVERTER, WORK_DIR
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/text" "${WORK_DIR}/binary" "${WORK_DIR}/delta" "${WORK_DIR}/again")
+
+set(TX_IQ "${WORK_DIR}/tx.cf32")
+set(META  "${WORK_DIR}/tx.json")
+set(STAGES fft gray deinterleaver hamming)
+
+file(WRITE "${META}"
+    "{\"sf\":7,\"bw\":125000,\"sample_rate\":500000,\"cr\":1,\"payload_len\":5,\"has_crc\":true,\"implicit_header\":false,\"ldro\":false,\"preamble_len\":8,\"sync_word\":18}")
+
+execute_process(
+    COMMAND "${LORA_TX}" --sf 7 --cr 1 --bw 125000 --sample-rate 500000
+        --payload "stage" --seed 1 --output "${TX_IQ}"
+    OUTPUT_VARIABLE _tx_out ERROR_VARIABLE _tx_err RESULT_VARIABLE _tx_rc TIMEOUT 30)
+if(NOT _tx_rc EQUAL 0)
+    message(FATAL_ERROR "TX encode failed:\n${_tx_err}")
+endif()
+
+foreach(_format text binary delta)
+    execute_process(
+        COMMAND "${LORA_REPLAY}" --iq "${TX_IQ}" --metadata "${META}" --payload stage
+            --dump-stages "${WORK_DIR}/${_format}/tx" --stage-format ${_format}
+        OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 60)
+    if(NOT _rc EQUAL 0 OR NOT _out MATCHES "Dumped stage outputs")
+        message(FATAL_ERROR "lora_replay --stage-format ${_format} failed (rc=${_rc}):\n${_out}${_err}")
+    endif()
+endforeach()
+
+foreach(_stage IN LISTS STAGES)
+    if(EXISTS "${WORK_DIR}/binary/tx_${_stage}.txt" OR NOT EXISTS "${WORK_DIR}/binary/tx_${_stage}.stage")
+        message(FATAL_ERROR "--stage-format binary did not write only tx_${_stage}.stage")
+    endif()
+endforeach()
+
+execute_process(
+    COMMAND "${PYTHON}" "${CONVERTER}" "${WORK_DIR}/binary" "${WORK_DIR}/delta" --to text
+    OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 60)
+if(NOT _rc EQUAL 0 OR NOT _out MATCHES "Converted 8 stage dump")
+    message(FATAL_ERROR "convert_stage_dumps.py --to text failed (rc=${_rc}):\n${_out}${_err}")
+endif()
+
+foreach(_stage IN LISTS STAGES)
+    file(COPY "${WORK_DIR}/text/tx_${_stage}.txt" DESTINATION "${WORK_DIR}/again")
+endforeach()
+foreach(_to delta text)
+    execute_process(
+        COMMAND "${PYTHON}" "${CONVERTER}" "${WORK_DIR}/again" --to ${_to} --remove
+        OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 60)
+    if(NOT _rc EQUAL 0)
+        message(FATAL_ERROR "convert_stage_dumps.py --to ${_to} failed (rc=${_rc}):\n${_err}")
+    endif()
+endforeach()
+
+foreach(_stage IN LISTS STAGES)
+    file(READ "${WORK_DIR}/text/tx_${_stage}.txt" _expected)
+    if(_expected STREQUAL "")
+        message(FATAL_ERROR "Text dump tx_${_stage}.txt is empty")
+    endif()
+    foreach(_dir binary delta again)
+        file(READ "${WORK_DIR}/${_dir}/tx_${_stage}.txt" _actual)
+        if(NOT _actual STREQUAL _expected)
+            message(FATAL_ERROR "${_dir}/tx_${_stage} does not match the text dump")
+        endif()
+    endforeach()
+endforeach()
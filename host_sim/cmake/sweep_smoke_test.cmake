@@ -0,0 +1,53 @@
+# sweep_smoke_test.cmake
+# Run a small lora_sweep grid at high SNR, require zero PER, and check the
+# per-point summaries with tools/compare_summary_metrics.py.
+# Expects: LORA_SWEEP, COMPARE_SCRIPT, WORK_DIR
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+set(RESULTS "${WORK_DIR}/sweep.json")
+set(SUMMARIES "${WORK_DIR}/points")
+
+execute_process(
+    COMMAND "${LORA_SWEEP}"
+        --sf 7,8 --cr 1,4 --snr 0 --cfo 0,2000
+        --packets 6 --payload-len 12 --seed 7
+        --max-per 0
+        --summary-dir "${SUMMARIES}"
+        --output "${RESULTS}"
+    OUTPUT_VARIABLE _out ERROR_VARIABLE _err RESULT_VARIABLE _rc TIMEOUT 120)
+message("SWEEP: ${_out}")
+if(NOT _rc EQUAL 0)
+    message(FATAL_ERROR "lora_sweep failed (rc=${_rc}):\n${_err}")
+endif()
+
+file(READ "${RESULTS}" _json)
+string(JSON _points LENGTH "${_json}" points)
+if(NOT _points EQUAL 8)
+    message(FATAL_ERROR "Expected 8 sweep points, got ${_points}")
+endif()
+math(EXPR _last "${_points} - 1")
+foreach(_i RANGE ${_last})
+    string(JSON _per GET "${_json}" points ${_i} per)
+    string(JSON _ber GET "${_json}" points ${_i} ber)
+    string(JSON _name GET "${_json}" points ${_i} name)
+    if(NOT _per EQUAL 0 OR NOT _ber EQUAL 0)
+        message(FATAL_ERROR "${_name}: PER ${_per}, BER ${_ber} at 0 dB SNR")
+    endif()
+endforeach()
+
+find_program(PYTHON_EXE NAMES python3 python)
+if(PYTHON_EXE)
+    file(WRITE "${WORK_DIR}/baseline.json"
+        "[{\"capture\": \"sf7_bw125000_cr1_snr0.0_cfo0_sfo0.cf32\", \"metrics\": {\"packets\": 6, \"crc_ok\": 6, \"per\": {\"value\": 0.0, \"tolerance\": 0.0, \"mode\": \"absolute\"}}}]")
+    execute_process(
+        COMMAND "${PYTHON_EXE}" "${COMPARE_SCRIPT}" "${WORK_DIR}/baseline.json" "${SUMMARIES}"
+        OUTPUT_VARIABLE _cmp_out ERROR_VARIABLE _cmp_err RESULT_VARIABLE _cmp_rc TIMEOUT 30)
+    if(NOT _cmp_rc EQUAL 0)
+        message(FATAL_ERROR "compare_summary_metrics failed:\n${_cmp_out}${_cmp_err}")
+    endif()
+    message("COMPARE: ${_cmp_out}")
+endif()
+
+message("SWEEP_SMOKE_OK: ${_points} points decoded without packet errors")
@@ -2,6 +2,7 @@
 
 #include <complex>
 #include <cstddef>
+#include <memory_resource>
 #include <span>
 #include <vector>
 #include <optional>
@@ -86,22 +87,95 @@ struct PreambleSearchResult
     int score{0};
 };
 
+/// Full-fold preamble spectra kept from the winning fine-scan offset.
+///
+/// They are exactly the FFTs FftDemodulator::estimate_frequency_offsets()
+/// takes of the preamble at that offset (same dechirp fold, same plan), so
+/// a caller estimating CFO/SFO there can pass them in instead of
+/// recomputing them.
+struct PreambleSpectra
+{
+    PreambleSpectra() = default;
+    /// Bins allocated from @p memory; handed over without a copy when the
+    /// scan ran on the same resource.
+    explicit PreambleSpectra(std::pmr::memory_resource* memory) : bins(memory) {}
+
+    std::size_t offset{0};   ///< Alignment offset the spectra were taken at
+    int symbols{0};          ///< Symbols held; 0 when nothing was kept
+    std::pmr::vector<std::complex<float>> bins;   ///< symbols × N, symbol-major
+
+    /// Spectra of the first `count` symbols when they were taken at
+    /// `at_offset`, else an empty span.
+    std::span<const std::complex<float>> first(std::size_t at_offset, int count) const
+    {
+        if (symbols <= 0 || count <= 0 || count > symbols || at_offset != offset) {
+            return {};
+        }
+        return std::span<const std::complex<float>>(bins).first(
+            bins.size() / static_cast<std::size_t>(symbols) * static_cast<std::size_t>(count));
+    }
+};
+
+/// How find_symbol_alignment_cfo_aware() scores its fine-scan offsets.
+enum class FineScanMode
+{
+    /// zoom from SF11 up, fft below; HOST_SIM_ALIGN_FINE=fft|zoom forces one.
+    automatic,
+    /// Full N-point FFT of every preamble symbol, peak over all bins.
+    fft,
+    /// Direct DFT of only the few bins around each coarse candidate's
+    /// preamble bin: O(K·N) per symbol instead of O(N log N).
+    zoom,
+};
+
 /// CFO-aware preamble search.  Works even when the carrier frequency offset
 /// is large (tens of kHz).  Scans all N bins and all sample offsets to find
 /// the combination that yields the longest run of identical-bin symbols.
 /// The returned preamble_bin is the raw demodulated bin value, which equals
 /// the integer CFO that should be fed to set_frequency_offsets().
+///
+/// When `spectra` is given, the preamble FFTs of the winning offset are
+/// stored there if the scan still holds them (always for a serial FFT
+/// scan; a parallel one may not, and a zoom scan never does), otherwise
+/// spectra->symbols is 0.
+///
+/// The scan's scratch (per-worker FFT buffers, candidate lists, zoom
+/// twiddles) comes from @p memory.
 PreambleSearchResult find_symbol_alignment_cfo_aware(
     std::span<const std::complex<float>> samples,
     const FftDemodulator& demod,
-    int preamble_symbols = 8);
+    int preamble_symbols = 8,
+    PreambleSpectra* spectra = nullptr,
+    FineScanMode fine_scan = FineScanMode::automatic,
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+/// A run of consecutive symbol windows whose dechirped peak stays within
+/// ±1 bin of its neighbour — the signature of a preamble at the
+/// demodulator's spreading factor.
+struct PreambleRun
+{
+    std::size_t first_symbol{0};  ///< Window index where the run starts
+    int length{0};                ///< Number of consistent windows
+    int bin{0};                   ///< Peak bin of the first window
+};
+
+/// Demodulate `samples` in back-to-back symbol windows from sample 0 and
+/// return every run of at least `min_run` consistent windows, in order.
+/// The windows need not be symbol-aligned: a misaligned upchirp train
+/// still dechirps to a constant (shifted) bin, while other spreading
+/// factors, data symbols and noise scatter.  Used to find preambles of
+/// each SF independently inside a burst that may hold several packets.
+std::vector<PreambleRun> find_preamble_runs(
+    std::span<const std::complex<float>> samples,
+    const FftDemodulator& demod,
+    int min_run);
 
 /// Find the symbol index where the header begins, by detecting sync words.
 /// Returns std::nullopt if sync words cannot be found.
 /// sync_word is the 8-bit sync word (e.g., 0x12), which is split into
 /// sync_high = (sync_word >> 4) << 3 and sync_low = (sync_word & 0xF) << 3.
 std::optional<std::size_t> find_header_symbol_index(
-    const std::vector<uint16_t>& symbols,
+    std::span<const uint16_t> symbols,
     int sync_word,
     int sf);
 
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace host_sim
+{
+
+/// Bounded lock-free multi-producer/multi-consumer queue (Vyukov's
+/// sequence-numbered ring).
+///
+/// try_push()/try_pop() never block and never allocate.  push()/pop()
+/// wait on std::atomic::wait() when the queue is full/empty, which gives
+/// backpressure between pipeline stages without a mutex.  close() wakes
+/// every waiter: pushes fail from then on and pops drain what is left.
+///
+/// T must be default-constructible and movable.
+template <typename T>
+class BoundedQueue
+{
+public:
+    /// Capacity is rounded up to a power of two (at least 2).
+    explicit BoundedQueue(std::size_t min_capacity)
+    {
+        capacity_ = 2;
+        while (capacity_ < min_capacity) {
+            capacity_ <<= 1;
+        }
+        cells_ = std::make_unique<Cell[]>(capacity_);
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    std::size_t capacity() const { return capacity_; }
+
+    /// Items currently queued; exact only when no other thread is active.
+    std::size_t size() const
+    {
+        const auto head = enqueue_pos_.load(std::memory_order_acquire);
+        const auto tail = dequeue_pos_.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+
+    /// Move @p value in if there is room; leaves it untouched otherwise.
+    bool try_push(T& value)
+    {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & (capacity_ - 1)];
+            const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    bump(pushed_);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Move the oldest item into @p out if there is one.
+    bool try_pop(T& out)
+    {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & (capacity_ - 1)];
+            const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.seq.store(pos + capacity_, std::memory_order_release);
+                    bump(popped_);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Wait for room, then push.  Returns false (value untouched) once
+    /// the queue is closed.
+    bool push(T& value)
+    {
+        for (;;) {
+            const std::uint32_t seen = popped_.load(std::memory_order_acquire);
+            if (closed_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (try_push(value)) {
+                return true;
+            }
+            popped_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    /// Wait for an item.  Returns false once the queue is closed and empty.
+    bool pop(T& out)
+    {
+        for (;;) {
+            const std::uint32_t seen = pushed_.load(std::memory_order_acquire);
+            if (try_pop(out)) {
+                return true;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                return try_pop(out);
+            }
+            pushed_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    /// No more pushes; wakes every blocked producer and consumer.
+    void close()
+    {
+        closed_.store(true, std::memory_order_release);
+        bump(pushed_);
+        bump(popped_);
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> seq{0};
+        T value{};
+    };
+
+    // Bumped on every push / pop so the other side can block in
+    // std::atomic::wait() without a lock.
+    static void bump(std::atomic<std::uint32_t>& counter)
+    {
+        counter.fetch_add(1, std::memory_order_release);
+        counter.notify_all();
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t capacity_{0};
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_pos_{0};
+    alignas(64) std::atomic<std::uint32_t> pushed_{0};
+    alignas(64) std::atomic<std::uint32_t> popped_{0};
+    std::atomic<bool> closed_{false};
+};
+
+} // namespace host_sim
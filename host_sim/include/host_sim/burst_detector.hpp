@@ -0,0 +1,146 @@
+#pragma once
+
+#include "host_sim/alignment.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace host_sim
+{
+
+/// Start and end of a burst found by BurstDetector, in samples relative
+/// to the start of the caller's buffer.
+struct BurstExtent {
+    std::size_t end{0};             ///< One past the last burst sample (plus tail margin)
+    bool complete{false};           ///< False when the buffer ends before the quiet tail
+    double power_acc{0.0};          ///< Sum of above-threshold window powers
+    std::size_t power_count{0};     ///< Number of above-threshold windows
+};
+
+/// One burst found by BurstIndex::bursts(): [start, end) in samples.
+struct BurstInterval {
+    std::size_t start{0};
+    std::size_t end{0};             ///< One past the last burst sample (plus tail margin)
+    float signal_power{0.0f};       ///< Mean power of the first above-threshold window
+    bool complete{false};           ///< False when the capture ends before the quiet tail
+};
+
+/// Power envelope of a whole capture, computed once.
+///
+/// detect_burst_ex() depends on its search origin only through the window
+/// it starts scanning from: the window powers and the lowest-quartile noise
+/// floor cover the entire buffer.  BurstIndex computes both once, so
+/// successive find_start() calls for the packets of a multi-packet capture
+/// cost one scan from the origin each instead of a full recomputation and
+/// sort, with bit-identical results.  bursts() lists every burst interval
+/// up front for callers that decode them independently.
+class BurstIndex
+{
+public:
+    BurstIndex(const std::complex<float>* samples, std::size_t n_samples, std::size_t window,
+               float threshold_factor = 6.0f, int min_consec = 1);
+
+    std::size_t window() const { return window_; }
+    std::size_t window_count() const { return powers_.size(); }
+    float noise_floor() const { return noise_floor_; }
+    float window_power(std::size_t w) const { return powers_[w]; }
+
+    /// detect_burst_ex(samples, n, window, threshold, search_from,
+    /// prior_noise, min_consec) without touching the samples again.
+    std::optional<BurstDetectResult> find_start(std::size_t search_from, float prior_noise = 0.0f) const;
+
+    /// Every burst in order: each starts where find_start() from the
+    /// previous end finds it and ends, like BurstDetector::find_end(),
+    /// @p tail_margin windows after @p tail_windows quiet windows.
+    std::vector<BurstInterval> bursts(std::size_t tail_windows = 5, std::size_t tail_margin = 4) const;
+
+private:
+    std::size_t window_;
+    float threshold_factor_;
+    int min_consec_;
+    std::size_t n_samples_;
+    std::vector<float> powers_;
+    float noise_floor_{0.0f};
+};
+
+/// Incremental power-envelope burst detector for streaming input.
+///
+/// Same decision rule as detect_burst_ex() — per-window mean power, noise
+/// floor from the mean of the lowest quartile of windows, a burst starts
+/// at the first run of @p min_consec windows above threshold — but the
+/// window powers persist across calls.  update() only touches samples
+/// that arrived since the previous call, and the quartile is kept in an
+/// order-statistic split (O(log n) per window) rather than re-sorted.
+///
+/// The window grid is anchored at absolute stream positions; consume()
+/// mirrors StreamingIqReader::consume() and retires windows that start
+/// before the new buffer head.  Consuming whole windows keeps the grid
+/// aligned with the buffer start, matching detect_burst_ex() exactly.
+class BurstDetector
+{
+public:
+    explicit BurstDetector(std::size_t window, float threshold_factor = 6.0f, int min_consec = 2);
+
+    /// Fold in samples @p buffer[seen .. available) not yet accounted for.
+    /// @p buffer must be the caller's current buffer head, i.e. the same
+    /// samples minus whatever was passed to consume().
+    void update(const std::complex<float>* buffer, std::size_t available);
+
+    /// Drop @p n samples from the buffer head.
+    void consume(std::size_t n);
+
+    /// Forget all state (start of a new stream).
+    void reset();
+
+    std::size_t window() const { return window_; }
+
+    /// Number of complete windows currently held.
+    std::size_t window_count() const { return powers_.size(); }
+
+    /// Mean power of the lowest quartile of held windows (0 when empty).
+    float noise_floor() const;
+
+    /// First burst at or after @p search_from.  A positive @p prior_noise
+    /// is blended 70/30 with the fresh quartile, as in detect_burst_ex().
+    std::optional<BurstDetectResult> find_start(std::size_t search_from, float prior_noise = 0.0f) const;
+
+    /// Scan forward from the window holding @p start until
+    /// @p tail_windows consecutive windows fall to or below
+    /// @p noise_floor × threshold factor; the end is then placed
+    /// @p tail_margin windows past the first quiet window.
+    BurstExtent find_end(std::size_t start, float noise_floor, std::size_t tail_windows = 5,
+                         std::size_t tail_margin = 4) const;
+
+private:
+    /// Buffer-relative start sample of held window @p i.
+    std::size_t window_start(std::size_t i) const;
+
+    /// Held window containing buffer-relative sample @p sample.
+    std::size_t window_index(std::size_t sample) const;
+
+    void insert_power(float p);
+    void erase_power(float p);
+    void rebalance();
+
+    std::size_t window_;
+    float threshold_factor_;
+    int min_consec_;
+
+    std::uint64_t consumed_{0};     ///< Absolute index of the buffer head
+    std::uint64_t seen_{0};         ///< Absolute index of the next unread sample
+    std::uint64_t first_window_{0}; ///< Absolute window index of powers_.front()
+    std::deque<float> powers_;
+    double partial_acc_{0.0};
+
+    // Lowest-quartile split: low_ holds the max(1, n/4) smallest powers.
+    std::multiset<float> low_;
+    std::multiset<float> high_;
+    double low_sum_{0.0};
+};
+
+} // namespace host_sim
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "host_sim/worker_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+namespace host_sim
+{
+
+/// View of the running search handed to each candidate probe.
+class CandidateContext
+{
+public:
+    CandidateContext(std::size_t index, std::size_t worker, const std::atomic<std::size_t>& winner)
+        : index_(index), worker_(worker), winner_(winner)
+    {
+    }
+
+    /// Candidate being evaluated (position in the caller's ordered list).
+    std::size_t index() const { return index_; }
+
+    /// Worker slot running this probe, in [0, candidate_search_workers()).
+    /// Probes use it to pick per-worker scratch such as a demodulator.
+    std::size_t worker() const { return worker_; }
+
+    /// True once a lower-index candidate has succeeded.  The probe's result
+    /// can no longer win, so long-running probes should return early.
+    bool superseded() const { return winner_.load(std::memory_order_relaxed) < index_; }
+
+private:
+    std::size_t index_;
+    std::size_t worker_;
+    const std::atomic<std::size_t>& winner_;
+};
+
+/// Returns true when the candidate is a hit.  Probes run concurrently and
+/// must only write to state owned by their index or their worker slot.
+using CandidateProbe = std::function<bool(const CandidateContext&)>;
+
+/// Evaluate candidates [0, count) across worker threads and return the
+/// lowest index whose probe returned true, or nullopt when none did.
+///
+/// Candidates are handed out in increasing order and any candidate above
+/// the current best hit is skipped, so every candidate below the winner
+/// is always evaluated and the result is identical to a sequential
+/// first-hit loop regardless of thread timing.  Runs on
+/// WorkerPool::shared(); per-worker state goes in a PerWorker<T>.
+std::optional<std::size_t> find_first_candidate(std::size_t count, const CandidateProbe& probe);
+
+/// Worker slots used by find_first_candidate() (the shared WorkerPool).
+std::size_t candidate_search_workers();
+
+} // namespace host_sim
@@ -1,57 +1,181 @@
 #pragma once
 
+#include "host_sim/decimator.hpp"
+#include "host_sim/q15.hpp"
+
 #include <complex>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace host_sim
 {
 
+class IqSource;
+
 std::vector<std::complex<float>> load_cf32(const std::filesystem::path& file_path);
 
+/// Read-only, memory-mapped view of a .cf32 capture.
+///
+/// Opening is O(1): pages are faulted in on first access and, being clean
+/// file-backed pages, can be dropped again by the kernel, so multi-GB
+/// captures decode without a full in-memory copy.  The mapping is advised
+/// for sequential access.  On platforms without mmap the file is read
+/// into an owned buffer instead.
+class MappedCapture {
+public:
+    explicit MappedCapture(const std::filesystem::path& file_path);
+    ~MappedCapture();
+
+    MappedCapture(MappedCapture&& other) noexcept;
+    MappedCapture& operator=(MappedCapture&& other) noexcept;
+    MappedCapture(const MappedCapture&) = delete;
+    MappedCapture& operator=(const MappedCapture&) = delete;
+
+    std::span<const std::complex<float>> samples() const { return {data_, size_}; }
+    const std::complex<float>* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void unmap();
+
+    const std::complex<float>* data_{nullptr};
+    std::size_t size_{0};
+    void* mapping_{nullptr};
+    std::size_t mapping_bytes_{0};
+    std::vector<std::complex<float>> fallback_;
+};
+
 /// Read complex-float32 IQ samples from stdin until EOF.
 std::vector<std::complex<float>> load_cf32_stdin();
 
 /// Read HackRF-native signed-int8 IQ from stdin and convert to complex float32.
 std::vector<std::complex<float>> load_hackrf_stdin();
 
-/// IQ format for streaming reader.
-enum class IqFormat : uint8_t { cf32, hackrf_int8 };
+/// Read interleaved signed-int16 (sc16) IQ from stdin, scaled to [-1, 1).
+std::vector<std::complex<float>> load_sc16_stdin();
 
-/// Incremental stdin reader for real-time streaming decode.
-/// Reads IQ in fixed-size chunks without waiting for EOF.
-/// Uses offset-based consume for O(1) amortised discard.
+/// On-the-wire IQ sample formats.
+enum class IqFormat : uint8_t { cf32, hackrf_int8, sc16 };
+
+/// Load a capture straight into Q15 for the fixed-point pipeline.  int8
+/// and sc16 files convert without a float intermediate (sc16 is read in
+/// place); cf32 files are quantised with saturation.
+std::vector<Q15Complex> load_q15(const std::filesystem::path& file_path, IqFormat format);
+
+/// What the streaming reader's I/O thread does when the ring is full.
+enum class OverflowPolicy : uint8_t {
+    block,  ///< Stop reading until the decoder consumes (lossless; the pipe backs up)
+    drop,   ///< Discard the incoming block and count it (live radios)
+};
+
+/// Incremental IQ reader for real-time streaming decode.
+///
+/// A dedicated I/O thread reads the source (stdin by default, or any
+/// IqSource: UDP, VITA-49, ZeroMQ, SoapySDR), converts it to complex
+/// float and fills a lock-free IqRingBuffer, so the source keeps draining
+/// while a burst decodes.  The decode thread sees the
+/// unconsumed samples as one contiguous span through data()/available(),
+/// even across the ring wrap.
+///
+/// read_chunk() exposes the same fixed-size chunks the source would give
+/// a blocking reader, so decoding does not depend on I/O timing.
+///
+/// With a @p front_end decimator the I/O thread also filters and
+/// decimates each block before it enters the ring: everything the reader
+/// exposes (chunks, capacity, data()) is then at the decimated rate.
+///
+/// Sources that timestamp their samples (VITA-49, SoapySDR with hardware
+/// time) leave marks that timestamp_ns() extrapolates from, and the
+/// samples they report lost are counted apart from the ring's own drops.
 class StreamingIqReader {
 public:
-    explicit StreamingIqReader(IqFormat format, std::size_t chunk_samples = 65536);
-
-    /// Read one chunk from stdin.  Returns the number of new samples
-    /// appended to the internal buffer.  Returns 0 on EOF.
+    /// @param capacity_samples Ring size; 0 picks 64 chunks.
+    explicit StreamingIqReader(IqFormat format, std::size_t chunk_samples = 65536,
+                               std::size_t capacity_samples = 0,
+                               OverflowPolicy policy = OverflowPolicy::block,
+                               std::FILE* source = stdin,
+                               std::optional<Decimator> front_end = std::nullopt);
+    /// Read from @p source, which the I/O thread owns from here on.
+    StreamingIqReader(std::unique_ptr<IqSource> source, std::size_t chunk_samples,
+                      std::size_t capacity_samples = 0,
+                      OverflowPolicy policy = OverflowPolicy::block,
+                      std::optional<Decimator> front_end = std::nullopt);
+    ~StreamingIqReader();
+
+    StreamingIqReader(const StreamingIqReader&) = delete;
+    StreamingIqReader& operator=(const StreamingIqReader&) = delete;
+
+    /// Wait for the next chunk and make it available.  Returns the number
+    /// of new samples, which is short only at end of input or when the
+    /// ring is full().  Returns 0 on EOF.
     std::size_t read_chunk();
 
-    /// True after stdin reaches EOF.
+    /// True after the source reaches EOF and every sample has been made
+    /// available.
     bool eof() const { return eof_; }
 
     /// Total unconsumed samples in the buffer.
-    std::size_t available() const { return buffer_.size() - offset_; }
+    std::size_t available() const { return available_; }
 
-    /// Pointer to the first unconsumed sample.
-    const std::complex<float>* data() const { return buffer_.data() + offset_; }
+    /// Pointer to the first unconsumed sample (contiguous for available()).
+    const std::complex<float>* data() const;
 
     /// Discard the first @p n unconsumed samples.
     void consume(std::size_t n);
 
+    /// Ring size in samples.
+    std::size_t capacity() const;
+
+    /// True when available() fills the ring: nothing more can arrive until
+    /// the caller consumes, so it must work with what it has.
+    bool full() const { return available_ >= capacity(); }
+
+    /// Times the I/O thread found the ring full (stalled or dropped).
+    std::uint64_t overflows() const;
+
+    /// Samples discarded under OverflowPolicy::drop.
+    std::uint64_t dropped_samples() const;
+
+    /// Overflows the source itself flagged (radio FIFO, socket buffer).
+    std::uint64_t source_overflows() const;
+
+    /// Samples the source reported lost before they reached the reader.
+    std::uint64_t source_lost_samples() const;
+
+    /// Samples consumed so far: the stream index of data()[0].
+    std::uint64_t position() const { return consumed_; }
+
+    /// Source time of stream sample @p index (ring rate) at @p sample_rate,
+    /// extrapolated from the closest timestamp at or before it.  Empty for
+    /// untimed sources and for samples before the first timestamp.
+    std::optional<std::int64_t> timestamp_ns(std::uint64_t index, double sample_rate) const;
+
+    /// The source as a URI (see IqSource::describe()).
+    const std::string& source_name() const { return source_name_; }
+
 private:
-    void compact();
+    struct Shared;
+
+    void start(std::unique_ptr<IqSource> source, std::size_t capacity_samples, OverflowPolicy policy,
+               std::optional<Decimator> front_end);
+    static void io_main(std::shared_ptr<Shared> shared, std::size_t chunk_samples, OverflowPolicy policy,
+                        std::optional<Decimator> front_end);
 
-    std::vector<std::complex<float>> buffer_;
-    std::vector<int8_t> hackrf_scratch_;
-    std::size_t offset_{0};
-    IqFormat format_;
+    std::shared_ptr<Shared> shared_;
+    std::thread io_thread_;
     std::size_t chunk_samples_;
+    std::size_t available_{0};
+    std::uint64_t consumed_{0};
     bool eof_{false};
-    bool binary_set_{false};
+    std::string source_name_;
 };
 
 struct CaptureStats
@@ -62,6 +186,6 @@ struct CaptureStats
     float mean_power{0.0F};
 };
 
-CaptureStats analyse_capture(const std::vector<std::complex<float>>& samples);
+CaptureStats analyse_capture(std::span<const std::complex<float>> samples);
 
 } // namespace host_sim
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace host_sim
+{
+
+class FftPlan;
+
+/// Polyphase FFT filter-bank channelizer for wideband captures.
+///
+/// Splits one complex stream at `input_rate` into per-channel streams at
+/// `output_rate` (the demodulator's sample rate), one per requested
+/// centre offset.  A single windowed-sinc prototype low-pass is folded
+/// into `branches()` polyphase arms; every output instant costs one
+/// L-tap fold and one branches()-point FFT shared by all channels, so
+/// adding channels is nearly free.  The decimation need not divide the
+/// branch count (weighted overlap-add with a circular-shift phase fix).
+///
+/// Channel offsets are snapped to the nearest FFT bin and the remainder
+/// is removed with a per-channel NCO on the decimated output.  The
+/// prototype passes `bandwidth / 2` plus that worst-case remainder and
+/// stops everything that would alias into it after decimation.
+class PolyphaseChannelizer
+{
+public:
+    /// @param input_rate       Wideband sample rate (Hz).
+    /// @param output_rate      Per-channel sample rate; must divide input_rate.
+    /// @param bandwidth        Signal bandwidth to preserve per channel (Hz).
+    /// @param channel_offsets  Channel centres relative to the capture centre (Hz).
+    /// Throws std::runtime_error when the rates cannot be met.
+    PolyphaseChannelizer(double input_rate, double output_rate, double bandwidth,
+                         std::vector<double> channel_offsets);
+
+    std::size_t channel_count() const { return channels_.size(); }
+    std::size_t decimation() const { return decimation_; }
+    std::size_t branches() const { return branches_; }
+    std::size_t taps() const { return taps_.size() / 2; }
+    double channel_offset(std::size_t c) const { return channels_[c].offset_hz; }
+
+    /// Number of outputs per channel produced for a stream of `n` input
+    /// samples (output n sits at input sample n * decimation()).
+    std::size_t output_count(std::size_t n_input) const;
+
+    /// Channelize a whole capture; splits the work across the shared
+    /// worker pool.  Equivalent to one process() call on a fresh instance.
+    std::vector<std::vector<std::complex<float>>> channelize(
+        std::span<const std::complex<float>> input) const;
+
+    /// Streaming form: consume `input` and append each channel's new
+    /// outputs to out[c] (resized to channel_count() if needed).
+    void process(std::span<const std::complex<float>> input,
+                 std::vector<std::vector<std::complex<float>>>& out);
+
+    /// Forget stream history (start of a new stream).
+    void reset();
+
+private:
+    struct Channel
+    {
+        double offset_hz{0.0};
+        std::size_t bin{0};
+        double nco_step{0.0};   ///< Residual rotation per output (radians)
+    };
+
+    struct Scratch
+    {
+        std::vector<float> fold;
+        std::vector<std::complex<float>> fft_in;
+        std::vector<std::complex<float>> fft_out;
+    };
+
+    /// Output `n`, given the taps() input samples ending at input n * D
+    /// (oldest first).  Writes one sample per channel to out[c][index].
+    void compute_output(const std::complex<float>* window, std::uint64_t n, Scratch& scratch,
+                        std::vector<std::vector<std::complex<float>>>& out,
+                        std::size_t index) const;
+
+    Scratch make_scratch() const;
+
+    std::size_t decimation_{1};
+    std::size_t branches_{1};
+    std::vector<float> taps_;           ///< Prototype, time-reversed, each tap duplicated for I/Q
+    std::vector<Channel> channels_;
+    const FftPlan* plan_{nullptr};
+
+    // Streaming state: the last taps()-1 inputs and the absolute input
+    // index of the next sample.
+    std::vector<std::complex<float>> history_;
+    std::uint64_t consumed_{0};
+    Scratch scratch_;
+};
+
+} // namespace host_sim
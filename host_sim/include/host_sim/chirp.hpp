@@ -4,6 +4,7 @@
 
 #include <complex>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace host_sim
@@ -26,4 +27,43 @@ ChirpTables build_chirps_with_id(int sf, int oversample_factor, int id);
 ChirpTablesQ15 build_chirps_q15(int sf, int oversample_factor);
 ChirpTablesQ15 build_chirps_q15_with_id(int sf, int oversample_factor, int id);
 
+/// Process-wide, thread-safe cache of the id-0 tables per (sf, os).  The
+/// first request builds them; later ones (every demodulator, stage reset
+/// and worker) share the same immutable copy.
+std::shared_ptr<const ChirpTables> shared_chirps(int sf, int oversample_factor);
+std::shared_ptr<const ChirpTablesQ15> shared_chirps_q15(int sf, int oversample_factor);
+
+/// Number of distinct (sf, os) float / Q15 table sets built so far.
+std::size_t shared_chirp_cache_size();
+
+/// TX chirp synthesis from one base upchirp per (sf, os).
+///
+/// Symbol k's upchirp equals the base upchirp advanced cyclically by k·os
+/// samples times the constant phase exp(-j2π(k²/2N - k/2)), so writing a
+/// symbol is a rotated copy with one complex multiply per sample and no
+/// transcendental calls.  Matches build_chirps_with_id() to float
+/// rounding (the base is computed in double).
+class ChirpModulator
+{
+public:
+    ChirpModulator(int sf, int oversample_factor);
+
+    int sf() const { return sf_; }
+    int oversample_factor() const { return os_; }
+    std::size_t samples_per_symbol() const { return base_.size(); }
+
+    /// Write symbol @p id's upchirp to out[0, samples_per_symbol()).
+    void upchirp(int id, std::complex<float>* out) const;
+
+    /// Write the first @p count samples (<= samples_per_symbol()) of the
+    /// base downchirp to @p out.
+    void downchirp(std::complex<float>* out, std::size_t count) const;
+
+private:
+    int sf_;
+    int os_;
+    std::vector<std::complex<float>> base_;
+    std::vector<std::complex<float>> symbol_phase_;   ///< exp(-j2π(k²/2N - k/2)), per k
+};
+
 }
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace host_sim
+{
+
+namespace detail
+{
+
+/// kCrc16Slices[k][b]: CRC-16/CCITT (poly 0x1021, MSB first) register
+/// contribution of byte b followed by k zero bytes.  Slice 0 is the
+/// classic byte-at-a-time table; slices 1..7 let crc16_ccitt() fold eight
+/// input bytes per step.
+inline constexpr auto kCrc16Slices = [] {
+    std::array<std::array<uint16_t, 256>, 8> table{};
+    for (int b = 0; b < 256; ++b) {
+        uint16_t crc = static_cast<uint16_t>(b << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+        }
+        table[0][static_cast<std::size_t>(b)] = crc;
+    }
+    for (std::size_t k = 1; k < 8; ++k) {
+        for (std::size_t b = 0; b < 256; ++b) {
+            const uint16_t prev = table[k - 1][b];
+            table[k][b] = static_cast<uint16_t>((prev << 8) ^ table[0][prev >> 8]);
+        }
+    }
+    return table;
+}();
+
+} // namespace detail
+
+/// Advance a CRC-16/CCITT register (poly 0x1021, no reflection, no final
+/// XOR) over @p count bytes.  Start from 0x0000 for the LoRa payload CRC;
+/// feeding a message in pieces gives the same result as one call.
+constexpr uint16_t crc16_ccitt(const uint8_t* data, std::size_t count, uint16_t crc = 0x0000)
+{
+    const auto& t = detail::kCrc16Slices;
+    while (count >= 8) {
+        const uint8_t b0 = static_cast<uint8_t>(data[0] ^ (crc >> 8));
+        const uint8_t b1 = static_cast<uint8_t>(data[1] ^ (crc & 0xFF));
+        crc = static_cast<uint16_t>(t[7][b0] ^ t[6][b1] ^ t[5][data[2]] ^ t[4][data[3]] ^
+                                    t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]]);
+        data += 8;
+        count -= 8;
+    }
+    while (count-- > 0) {
+        crc = static_cast<uint16_t>((crc << 8) ^ t[0][static_cast<uint8_t>((crc >> 8) ^ *data++)]);
+    }
+    return crc;
+}
+
+/// One-byte step of crc16_ccitt().
+constexpr uint16_t crc16_ccitt_update(uint16_t crc, uint8_t byte)
+{
+    return static_cast<uint16_t>((crc << 8) ^ detail::kCrc16Slices[0][static_cast<uint8_t>((crc >> 8) ^ byte)]);
+}
+
+} // namespace host_sim
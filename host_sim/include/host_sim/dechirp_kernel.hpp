@@ -0,0 +1,66 @@
+#pragma once
+
+#include "host_sim/chirp.hpp"
+
+#include <complex>
+#include <memory>
+
+namespace host_sim
+{
+
+/// Per-symbol dechirp of FftDemodulator for one (SF, OS, base tap).
+///
+/// The demodulator keeps one tap per chip (base_tap + k·OS), derotates it
+/// and multiplies it by the downchirp at the same position.  The kernel
+/// holds those 2^SF decimated downchirp taps contiguously in one 64-byte
+/// aligned block, so the dispatched kernels::dechirp_decimated() gathers
+/// only the sample stream; a split re/im copy of the taps serves
+/// dechirp_split() on PolyphaseSamples planes.  Output is bit-identical to
+/// kernels::dechirp().
+class DechirpKernel
+{
+public:
+    DechirpKernel(const ChirpTables& chirps, int sf, int os, int base_tap);
+
+    DechirpKernel(const DechirpKernel&) = delete;
+    DechirpKernel& operator=(const DechirpKernel&) = delete;
+
+    /// out[k] = samples[k·OS] · rotation[k] · downchirp[base_tap + k·OS]
+    /// for k < 2^SF; @p samples already points at the base tap and
+    /// @p rotation may be null (no derotation).
+    void dechirp(const std::complex<float>* samples,
+                 const std::complex<float>* rotation,
+                 std::complex<float>* out) const;
+
+    /// Same product on split operands: @p re / @p im hold the 2^SF taps
+    /// contiguously (PolyphaseSamples::real_from / imag_from).
+    void dechirp_split(const float* re,
+                       const float* im,
+                       const std::complex<float>* rotation,
+                       std::complex<float>* out) const;
+
+    int sf() const { return sf_; }
+    int oversample_factor() const { return os_; }
+
+private:
+    struct AlignedDelete
+    {
+        void operator()(float* p) const;
+    };
+
+    int sf_;
+    int os_;
+    int n_;
+    // Interleaved taps (2N floats), then the re and im planes (N each).
+    std::unique_ptr<float[], AlignedDelete> storage_;
+};
+
+/// Whether a kernel is built: SF7–12 × OS 1, 2, 4, 8, 16.
+bool dechirp_kernel_supported(int sf, int oversample_factor);
+
+/// Process-wide kernel for (sf, os, base_tap), built once from the shared
+/// chirp tables; null when dechirp_kernel_supported() is false, in which
+/// case callers stay on kernels::dechirp().
+std::shared_ptr<const DechirpKernel> shared_dechirp_kernel(int sf, int oversample_factor, int base_tap);
+
+} // namespace host_sim
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace host_sim
+{
+
+/// Streaming anti-alias FIR + integer decimator.
+///
+/// Brings an oversampled capture down to a lower oversampling factor once,
+/// on arrival, so every later stage (burst envelope, alignment, dechirp)
+/// touches `factor()` times fewer samples.  The low-pass is a linear-phase
+/// windowed sinc whose length is chosen so its group delay is a whole
+/// number of output samples: timing is preserved exactly, only shifted by
+/// delay(), which is what the fractional-timing search downstream needs.
+///
+/// The filter passes |f| <= passband and stops everything that would fold
+/// into that band after decimation, so keep the output oversampled (OS
+/// 2 or 4) to leave a transition band.
+class Decimator
+{
+public:
+    /// @param factor    Integer decimation (>= 1; 1 is a pass-through copy).
+    /// @param passband  One-sided signal bandwidth as a fraction of the
+    ///                  input rate (bw / 2 / fs); must be < 1 / (2 * factor).
+    /// Throws std::runtime_error when the passband cannot survive decimation.
+    Decimator(std::size_t factor, double passband);
+
+    std::size_t factor() const { return factor_; }
+    std::size_t taps() const { return taps_.size() / 2; }
+
+    /// Group delay in output samples: output m + delay() lines up with
+    /// input m * factor().
+    std::size_t delay() const { return delay_; }
+
+    /// Upper bound on the outputs produced for @p n more inputs.
+    std::size_t max_output(std::size_t n) const { return n / factor_ + 1; }
+
+    /// Filter @p n inputs and write the decimated outputs to @p out (room
+    /// for max_output(n)); returns the number written.  Output m is taken
+    /// at input sample m * factor() counted from the first input since
+    /// construction or reset().
+    std::size_t process(const std::complex<float>* in, std::size_t n, std::complex<float>* out);
+
+    /// Forget stream history.
+    void reset();
+
+private:
+    std::size_t factor_;
+    std::size_t delay_{0};
+    std::vector<float> taps_;           ///< Time-reversed, each tap duplicated for I/Q
+    std::vector<std::complex<float>> buffer_;   ///< taps()-1 history followed by new input
+    std::size_t phase_{0};              ///< Inputs to skip before the next output
+};
+
+} // namespace host_sim
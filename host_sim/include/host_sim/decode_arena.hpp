@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace host_sim
+{
+
+/// Per-packet scratch memory for the burst decode path.
+///
+/// A monotonic arena over one reusable block: the symbol buffers, header
+/// nibbles, polyphase planes and alignment scratch of a decode are carved
+/// out of resource() and never freed individually; reset() between
+/// packets drops them all at once.  A packet that outgrows the block
+/// spills into the heap, and the next reset() replaces the block with one
+/// large enough for it, so once the block has reached the largest packet
+/// seen, decoding makes no allocator calls at all.
+///
+/// Not thread-safe: one arena serves one decoder thread at a time (each
+/// Receiver decoder keeps one per SF).
+class DecodeArena
+{
+public:
+    static constexpr std::size_t kDefaultBytes = std::size_t{256} << 10;
+
+    explicit DecodeArena(std::size_t initial_bytes = kDefaultBytes);
+
+    DecodeArena(const DecodeArena&) = delete;
+    DecodeArena& operator=(const DecodeArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*arena_; }
+
+    /// Release everything allocated since the last reset.  Every container
+    /// built on resource() must be gone by then.
+    void reset();
+
+    /// Size of the reusable block.
+    std::size_t capacity() const { return capacity_; }
+
+    /// Bytes taken from the heap since the last reset because the block was
+    /// full (0 in steady state).
+    std::size_t spilled() const { return spill_.bytes; }
+
+private:
+    /// Upstream of the arena: the heap, counted.
+    struct Spill : std::pmr::memory_resource
+    {
+        std::size_t bytes{0};
+
+        void* do_allocate(std::size_t size, std::size_t align) override;
+        void do_deallocate(void* p, std::size_t size, std::size_t align) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    std::size_t capacity_;
+    std::unique_ptr<std::byte[]> block_;
+    Spill spill_;
+    std::optional<std::pmr::monotonic_buffer_resource> arena_;
+};
+
+} // namespace host_sim
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace host_sim
+{
+
+/// Receiver phases wall time is attributed to.
+enum class DecodePhase : std::size_t
+{
+    other,          ///< Anything outside a scoped phase
+    detection,      ///< Burst detection on the incoming stream
+    alignment,      ///< CFO-aware preamble alignment
+    cfo_sfo,        ///< Frequency-offset estimation and sub-sample refinement
+    demod,          ///< Preamble-grid demodulation
+    header,         ///< Header location and decode on the grid
+    fallback,       ///< SFD re-demod, timing sweeps and the OS=2 fallback
+    payload,        ///< Payload decode and CRC
+    count
+};
+
+constexpr std::size_t kDecodePhaseCount = static_cast<std::size_t>(DecodePhase::count);
+
+const char* phase_name(DecodePhase phase);
+
+/// Nanoseconds per phase.
+struct PhaseTimes
+{
+    std::array<double, kDecodePhaseCount> ns{};
+
+    double& operator[](DecodePhase phase) { return ns[static_cast<std::size_t>(phase)]; }
+    double operator[](DecodePhase phase) const { return ns[static_cast<std::size_t>(phase)]; }
+    double total() const;
+    PhaseTimes& operator+=(const PhaseTimes& other);
+};
+
+/// While alive, PhaseScopes on the constructing thread charge their wall
+/// time to @p sink; time outside any scope goes to DecodePhase::other.
+/// Recordings do not nest.  Without one, a PhaseScope costs a
+/// thread-local check.
+class PhaseRecording
+{
+public:
+    explicit PhaseRecording(PhaseTimes& sink);
+    ~PhaseRecording();
+
+    /// Whether a recording is active on the calling thread.
+    static bool active();
+
+    PhaseRecording(const PhaseRecording&) = delete;
+    PhaseRecording& operator=(const PhaseRecording&) = delete;
+};
+
+/// Charge the enclosed wall time to @p phase.  Scopes nest exclusively: an
+/// inner scope's time is taken out of the outer one, which resumes when
+/// the inner one ends.  Work a phase hands to other threads is covered by
+/// the time the recording thread spends waiting for it.
+class PhaseScope
+{
+public:
+    explicit PhaseScope(DecodePhase phase);
+    ~PhaseScope();
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    DecodePhase previous_{DecodePhase::other};
+    bool active_{false};
+};
+
+} // namespace host_sim
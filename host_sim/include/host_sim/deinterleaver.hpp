@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -14,6 +15,35 @@ struct DeinterleaverConfig
     bool ldro{false};
 };
 
+/// Largest block either direction handles: sf_app <= 12 codewords of
+/// cw_len <= 8 bits.
+constexpr std::size_t kMaxInterleaverRows = 12;
+constexpr std::size_t kMaxInterleaverCols = 8;
+
 std::vector<uint8_t> deinterleave(const std::vector<uint16_t>& symbols, const DeinterleaverConfig& cfg, std::size_t& consumed);
 
+/// Allocation-free deinterleave of one block: reads cw_len symbols from
+/// @p symbols (@p count must be at least that) and writes sf_app
+/// codewords to @p out (room for kMaxInterleaverRows).  The diagonal
+/// permutation is a bit-matrix transpose on 64-bit words, with no
+/// per-bit loop.  Returns the number of codewords written; bit-identical
+/// to deinterleave_reference().
+std::size_t deinterleave_block(const uint16_t* symbols,
+                               std::size_t count,
+                               const DeinterleaverConfig& cfg,
+                               uint8_t* out);
+
+/// Inverse of deinterleave_block() for the TX side: @p count (<= sf_app)
+/// codewords, missing ones taken as zero, become cw_len symbol values
+/// (gray-decoded, LDRO-shifted, +1) in @p out.  Returns cw_len.
+std::size_t interleave_block(const uint8_t* codewords,
+                             std::size_t count,
+                             const DeinterleaverConfig& cfg,
+                             uint16_t* out);
+
+/// Bit-matrix reference kept for cross-checking the word-level path.
+std::vector<uint8_t> deinterleave_reference(const std::vector<uint16_t>& symbols,
+                                            const DeinterleaverConfig& cfg,
+                                            std::size_t& consumed);
+
 } // namespace host_sim
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "host_sim/q15.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace host_sim
+{
+
+/// Cached phase ramp for per-sample CFO/SFO derotation.
+///
+/// The demodulators correct each decimated tap `sample_idx = bin * os + base`
+/// by exp(j * w * sample_idx), where `w` (radians per sample) folds the
+/// fractional CFO and the symbol-dependent SFO term together.  Instead of
+/// one cos/sin pair per bin and per symbol, the ramp is generated once per
+/// distinct `w` with a recursive phasor that is re-seeded from an exact
+/// std::polar every kResyncInterval taps, and reused for as long as `w`
+/// does not change (the common case when no SFO is applied).
+///
+/// Every table entry stays within kTolerance of the exact rotation per
+/// component, which is well below the argument rounding the previous
+/// per-bin float cos/sin formulation carried at SF12.
+class Derotator
+{
+public:
+    static constexpr int kResyncInterval = 64;
+    static constexpr float kTolerance = 1e-6f;
+
+    void configure(int n_bins, int oversample_factor, int base);
+
+    /// Per-sample phase step for the given offsets, matching the legacy
+    /// demodulator formula: fractional CFO plus SFO drift of `symbol_index`.
+    static double phase_step(float cfo_frac, float sfo_slope,
+                             std::size_t symbol_index, int samples_per_symbol);
+
+    /// Rotation table (one entry per bin) for phase step `w`.  The returned
+    /// reference stays valid until the next ramp() call with a different `w`.
+    const std::vector<std::complex<float>>& ramp(double w);
+
+    /// Q15 variant of ramp(); entries are float_to_q15_complex() of the
+    /// float table, so both demodulators see the same rotation.
+    const std::vector<Q15Complex>& ramp_q15(double w);
+
+    /// True when `w` yields the identity rotation for every bin.
+    static bool is_identity(double w) { return w == 0.0; }
+
+    void invalidate();
+
+private:
+    int n_bins_{0};
+    int oversample_factor_{1};
+    int base_{0};
+    std::vector<std::complex<float>> table_;
+    std::vector<Q15Complex> table_q15_;
+    double table_w_{0.0};
+    double table_q15_w_{0.0};
+    bool table_valid_{false};
+    bool table_q15_valid_{false};
+
+    void build(double w);
+};
+
+} // namespace host_sim
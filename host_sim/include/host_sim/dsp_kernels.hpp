@@ -0,0 +1,124 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+namespace host_sim::kernels
+{
+
+/// Instruction-set variants of the hot DSP loops.  The best supported
+/// variant is picked at first use (CPUID on x86, NEON is baseline on
+/// aarch64); HOST_SIM_KERNEL_ISA=scalar|avx2|avx512|neon forces one.
+///
+/// Every variant is bit-identical to the scalar reference: the kernels
+/// use the same operation order per output element and the translation
+/// unit is built without FP contraction, so dispatch never changes a
+/// demodulated symbol.
+enum class Isa
+{
+    scalar,
+    avx2,
+    avx512,
+    neon,
+};
+
+/// Best and second-best spectral peaks, with the same tie semantics as
+/// the sequential scan they replace: `best_bin` is the first index of
+/// the maximum, `second_bin` the first index of the maximum over all
+/// other bins.  Magnitudes are -1 when fewer than one/two bins exist.
+struct PeakPair
+{
+    int best_bin{0};
+    float best_mag{-1.0f};
+    int second_bin{0};
+    float second_mag{-1.0f};
+};
+
+/// Integer variant of PeakPair for the Q15 pipeline (|X|² in int64).
+struct PeakPairQ15
+{
+    int best_bin{0};
+    int64_t best_mag{-1};
+    int second_bin{0};
+    int64_t second_mag{-1};
+};
+
+Isa active_isa();
+const char* isa_name(Isa isa);
+bool isa_supported(Isa isa);
+
+/// Select a variant explicitly (tests, benchmarking).  Returns false and
+/// leaves the selection unchanged when the CPU does not support it.
+bool set_isa(Isa isa);
+
+/// out[k] = samples[k·stride] × rotation[k] × chirp[k·stride] for k < n.
+/// `rotation` may be null, in which case the product skips it.
+void dechirp(const std::complex<float>* samples,
+             const std::complex<float>* rotation,
+             const std::complex<float>* chirp,
+             int n,
+             int stride,
+             std::complex<float>* out);
+
+/// dechirp() against a pre-decimated chirp: out[k] = samples[k·stride] ×
+/// rotation[k] × taps[k], so only the sample stream is strided.
+void dechirp_decimated(const std::complex<float>* samples,
+                       const std::complex<float>* rotation,
+                       const std::complex<float>* taps,
+                       int n,
+                       int stride,
+                       std::complex<float>* out);
+
+/// Polyphase fold: out[k] = Σ_m samples[k·os + m] × chirp[k·os + m] for
+/// m = 0, fold_stride, 2·fold_stride, … < os, accumulated in order.
+void dechirp_fold(const std::complex<float>* samples,
+                  const std::complex<float>* chirp,
+                  int n,
+                  int os,
+                  int fold_stride,
+                  std::complex<float>* out);
+
+/// dechirp() on split (structure-of-arrays) operands: out[k] =
+/// (re[k], im[k]) × rotation[k] × (chirp_re[k], chirp_im[k]).  Rotation
+/// and output stay interleaved; `rotation` may be null.
+void dechirp_split(const float* re,
+                   const float* im,
+                   const std::complex<float>* rotation,
+                   const float* chirp_re,
+                   const float* chirp_im,
+                   int n,
+                   std::complex<float>* out);
+
+/// out[k] = re² + im² of spectrum[k].
+void magnitude_sq(const std::complex<float>* spectrum, int n, float* out);
+
+/// Fused |X|² and two-best argmax.  When `mag_out` is non-null the
+/// per-bin powers are written there as a side effect.
+PeakPair find_two_peaks(const std::complex<float>* spectrum, int n, float* mag_out = nullptr);
+
+/// Two-best argmax over interleaved Q15 (re, im) pairs, |X|² in int64.
+PeakPairQ15 find_two_peaks_q15(const int16_t* spectrum_iq, int n);
+
+/// Interleaved int8 IQ (HackRF native) → complex float in [-1, 1):
+/// out[k] = (iq[2k] / 128, iq[2k+1] / 128) for k < n_samples.
+void int8_to_cf32(const int8_t* iq, std::size_t n_samples, std::complex<float>* out);
+
+/// Interleaved int16 IQ (sc16) → complex float: value / 32768.
+void int16_to_cf32(const int16_t* iq, std::size_t n_samples, std::complex<float>* out);
+
+/// Interleaved int8 IQ → interleaved Q15 (value << 8), the same scale as
+/// quantising the int8_to_cf32() output, without the float round trip.
+void int8_to_q15(const int8_t* iq, std::size_t n_samples, int16_t* out_iq);
+
+/// out[r] = Σ_k x[k] × rows[r·n + k] for r < count (rows are n values
+/// apart).  Products are summed in 8 partial sums, lane k mod 8, which are
+/// then added in lane order; a few direct DFT bins are this with rows of
+/// twiddles.
+void dot_rows(const std::complex<float>* x,
+              const std::complex<float>* rows,
+              int n,
+              int count,
+              std::complex<float>* out);
+
+} // namespace host_sim::kernels
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+
+namespace host_sim
+{
+
+/// FFT implementations the float demodulation path can run on.
+///
+/// The default comes from the HOST_SIM_FFT_BACKEND CMake option
+/// (kissfft unless configured otherwise); the HOST_SIM_FFT_BACKEND
+/// environment variable overrides it at first use.  The Q15 pipeline
+/// always uses the fixed-point KissFFT build.
+///
+/// `cuda` (-DHOST_SIM_WITH_CUDA=ON, selected through the environment only)
+/// moves FftDemodulator::demodulate_block() calls of kGpuMinBatch windows
+/// and more onto the GPU (host_sim/gpu_demod.hpp); single FFTs and smaller
+/// blocks keep running on the configured CPU backend.  Without a device
+/// it is unavailable and the CPU backend stays active.
+enum class FftBackend
+{
+    kissfft,
+    radix4,
+    fftw,
+    cuda,
+};
+
+/// Forward complex FFT of a fixed size (unnormalised, e^{-j2πkn/N}).
+///
+/// Plans are immutable once built and forward() is reentrant as long as
+/// each caller passes its own buffers, so a single plan can be shared by
+/// every demodulator and worker thread using that size.  `in` and `out`
+/// must not alias.
+class FftPlan
+{
+public:
+    virtual ~FftPlan() = default;
+
+    virtual void forward(const std::complex<float>* in, std::complex<float>* out) const = 0;
+
+    /// Transform `count` contiguous size()-point vectors.  The default runs
+    /// forward() per vector; backends with a native batched mode override it.
+    virtual void forward_batch(const std::complex<float>* in,
+                               std::complex<float>* out,
+                               std::size_t count) const
+    {
+        const auto n = static_cast<std::size_t>(size_);
+        for (std::size_t i = 0; i < count; ++i) {
+            forward(in + i * n, out + i * n);
+        }
+    }
+
+    int size() const { return size_; }
+
+protected:
+    explicit FftPlan(int size) : size_(size) {}
+
+private:
+    int size_;
+};
+
+/// Process-wide cached plan for `size` on the active backend.  Plans are
+/// created on first request and live until exit; each thread additionally
+/// keeps a lock-free lookup of the sizes it has used.
+const FftPlan& fft_plan(int size);
+
+FftBackend active_fft_backend();
+const char* fft_backend_name(FftBackend backend);
+bool fft_backend_available(FftBackend backend);
+
+/// Build an uncached plan on a specific backend (tests, benchmarks); a
+/// `cuda` plan is the configured CPU backend's.  Throws std::runtime_error
+/// when the backend is not compiled in.
+std::unique_ptr<FftPlan> make_fft_plan(FftBackend backend, int size);
+
+} // namespace host_sim
@@ -1,15 +1,19 @@
 #pragma once
 
 #include "host_sim/chirp.hpp"
+#include "host_sim/dechirp_kernel.hpp"
+#include "host_sim/derotator.hpp"
+#include "host_sim/fft_backend.hpp"
+#include "host_sim/gpu_demod.hpp"
+#include "host_sim/polyphase_samples.hpp"
 
 #include <complex>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
-extern "C" {
-#include "kiss_fft.h"
-}
-
 namespace host_sim
 {
 
@@ -17,13 +21,52 @@ class FftDemodulator
 {
 public:
     FftDemodulator(int sf, int sample_rate, int bandwidth);
-    ~FftDemodulator();
 
     FftDemodulator(const FftDemodulator&) = delete;
     FftDemodulator& operator=(const FftDemodulator&) = delete;
 
     uint16_t demodulate(const std::complex<float>* symbol_samples) const;
 
+    /// Demodulate `n_symbols` consecutive symbols in one call.  Symbol i
+    /// starts at samples + round(i * stride); a fractional stride covers the
+    /// SFO-compensated re-demod grids.  Equivalent to calling demodulate()
+    /// on each window in turn (symbol counter, CFO tracking, last_residual()
+    /// and get_fft_magnitudes_sq() all end up in the same state), but the
+    /// dechirp and FFT stages run over a contiguous multi-symbol scratch.
+    ///
+    /// `residuals` (n_symbols floats) receives each symbol's last_residual();
+    /// `mag_sq_out` (n_symbols × 2^SF floats) each symbol's |X|² spectrum.
+    /// Both may be null.
+    ///
+    /// On the `cuda` FFT backend a block of kGpuMinBatch symbols or more,
+    /// without CFO tracking or `mag_sq_out`, runs on the GPU instead
+    /// (host_sim/gpu_demod.hpp); a CUDA error logs once and leaves every
+    /// later block on the CPU.
+    void demodulate_block(const std::complex<float>* samples,
+                          std::size_t n_symbols,
+                          double stride,
+                          uint16_t* out,
+                          float* residuals = nullptr,
+                          float* mag_sq_out = nullptr) const;
+
+    /// demodulate_block() over a burst held as polyphase planes: symbol i
+    /// starts at sample first + round(i * stride).  The taps are read from
+    /// the split planes when an (SF, OS) dechirp kernel exists and from
+    /// the interleaved source otherwise; either way the symbols match the
+    /// pointer overload on the same samples.  Throws std::runtime_error
+    /// when the planes' oversampling differs from the demodulator's.
+    void demodulate_block(const PolyphaseSamples& samples,
+                          std::size_t first,
+                          std::size_t n_symbols,
+                          double stride,
+                          uint16_t* out,
+                          float* residuals = nullptr,
+                          float* mag_sq_out = nullptr) const;
+
+    /// Number of whole symbol windows demodulate_block() can read from
+    /// `n_samples` samples at the given stride.
+    std::size_t block_capacity(std::size_t n_samples, double stride) const;
+
     // Return |fft_out_[n]|² for all N bins after the most recent demodulate() call.
     // Returns a reference to an internal buffer; valid until next demodulate/get_fft_magnitudes_sq call.
     const std::vector<float>& get_fft_magnitudes_sq() const;
@@ -41,8 +84,17 @@ public:
         float sfo_slope{0.0f};
     };
 
+    /// CFO/SFO from `symbol_count` preamble symbols starting at `samples`.
+    /// Works in buffers owned by the demodulator, so repeated calls do not
+    /// allocate once they have seen the largest symbol_count.
     FrequencyEstimate estimate_frequency_offsets(const std::complex<float>* samples,
                                                  int symbol_count) const;
+
+    /// Same estimate from the preamble's full-fold spectra (symbol_count × N
+    /// values, symbol-major), e.g. PreambleSpectra kept by the CFO-aware
+    /// alignment, skipping the dechirp and FFT of every symbol.
+    FrequencyEstimate estimate_frequency_offsets(std::span<const std::complex<float>> spectra,
+                                                 int symbol_count) const;
     void set_frequency_offsets(float cfo_frac, int cfo_int, float sfo_slope);
     void reset_symbol_counter() const { symbol_counter_ = 0; }
 
@@ -63,7 +115,7 @@ public:
         cfo_track_delay_ = delay_symbols;
     }
 
-    const ChirpTables& chirps() const { return chirps_; }
+    const ChirpTables& chirps() const { return *chirps_; }
 
 private:
     int sf_;
@@ -72,11 +124,25 @@ private:
     int bandwidth_;
     int oversample_factor_;
     int samples_per_symbol_;
-    ChirpTables chirps_;
-    kiss_fft_cfg kiss_cfg_{nullptr};
-    mutable std::vector<kiss_fft_cpx> fft_in_;
-    mutable std::vector<kiss_fft_cpx> fft_out_;
+    std::shared_ptr<const ChirpTables> chirps_;   ///< shared_chirps(), never rebuilt per instance
+    std::shared_ptr<const DechirpKernel> dechirp_kernel_;   ///< Decimated taps for (SF, OS, tap); null = generic kernel
+    const FftPlan* fft_plan_{nullptr};
+    mutable std::vector<std::complex<float>> fft_in_;
+    mutable std::vector<std::complex<float>> fft_out_;
     mutable std::vector<float> mag_sq_buf_;
+    mutable std::vector<std::complex<float>> block_in_;
+    mutable std::vector<std::complex<float>> block_out_;
+    // demodulate_on_gpu() window list and results
+    mutable std::vector<std::size_t> gpu_offsets_;
+    mutable std::vector<double> gpu_steps_;
+    mutable std::vector<GpuPeak> gpu_peaks_;
+    // estimate_frequency_offsets() workspace
+    mutable std::vector<std::complex<float>> estimate_spectra_;
+    mutable std::vector<float> estimate_power_;
+    mutable std::vector<int> estimate_inlier_symbols_;
+    mutable std::vector<double> estimate_inlier_bins_;
+    mutable Derotator derotator_;
+    int base_tap_{0};
     mutable float cfo_frac_{0.0f};
     int cfo_int_{0};
     float sfo_slope_{0.0f};
@@ -86,8 +152,35 @@ private:
     mutable float last_residual_{0.0f};
 
     void initialize_fft();
+    const std::complex<float>* rotation_for(std::size_t symbol_index) const;
+    void dechirp_symbol(const std::complex<float>* symbol_samples,
+                        std::size_t symbol_index,
+                        std::complex<float>* output) const;
+    void dechirp_symbol(const PolyphaseSamples& samples,
+                        std::size_t start,
+                        std::size_t symbol_index,
+                        std::complex<float>* output) const;
+    template <typename Dechirp>
+    void demodulate_windows(std::size_t n_symbols,
+                            const Dechirp& dechirp,
+                            uint16_t* out,
+                            float* residuals,
+                            float* mag_sq_out) const;
+    /// The GPU half of demodulate_block(): false, with nothing changed,
+    /// when the block stays on the CPU.
+    bool demodulate_on_gpu(const std::complex<float>* samples,
+                           std::size_t first,
+                           std::size_t n_symbols,
+                           double stride,
+                           uint16_t* out,
+                           float* residuals,
+                           float* mag_sq_out) const;
+    uint16_t pick_symbol(const std::complex<float>* spectrum, float* mag_sq) const;
+    /// pick_symbol() once the peak search is done: `bin` is the peak after
+    /// the adjacent-tie rule, `mag_prev`/`mag_next` |X|² either side of it.
+    uint16_t decide_symbol(const kernels::PeakPair& peaks, int bin, float mag_prev, float mag_next) const;
     void compute_fft(const std::complex<float>* symbol_samples,
-                     kiss_fft_cpx* output) const;
+                     std::complex<float>* output) const;
 };
 
 }
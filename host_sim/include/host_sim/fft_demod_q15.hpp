@@ -1,16 +1,15 @@
 #pragma once
 
 #include "host_sim/chirp.hpp"
+#include "host_sim/derotator.hpp"
 #include "host_sim/q15.hpp"
+#include "host_sim/q15_fft.hpp"
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
-// Forward-declare the opaque KissFFT Q15 config.
-struct kiss_fft_state;
-typedef struct kiss_fft_state* kiss_fft_q15_cfg;
-
 namespace host_sim
 {
 
@@ -18,12 +17,13 @@ namespace host_sim
 ///
 /// All signal processing (downchirp multiply, FFT, peak detection) runs
 /// in Q15/Q31 arithmetic.  Only the final parabolic interpolation and
-/// CFO-tracking EMA use a few floats.
+/// CFO-tracking EMA use a few floats.  The multiplies and the FFT go
+/// through q15_cmplx_mult() and Q15Fft, so a CMSIS-DSP build runs them
+/// on the Arm kernels.
 class FftDemodulatorQ15
 {
 public:
     FftDemodulatorQ15(int sf, int sample_rate, int bandwidth);
-    ~FftDemodulatorQ15();
 
     FftDemodulatorQ15(const FftDemodulatorQ15&) = delete;
     FftDemodulatorQ15& operator=(const FftDemodulatorQ15&) = delete;
@@ -48,13 +48,15 @@ private:
     int oversample_factor_;
     int samples_per_symbol_;
 
-    ChirpTablesQ15 chirps_q15_;
-    kiss_fft_q15_cfg kiss_cfg_{nullptr};
+    std::shared_ptr<const ChirpTablesQ15> chirps_q15_;   ///< shared_chirps_q15()
+    Q15Fft fft_;
 
     // Scratch buffers (pre-allocated, reused per demodulate call).
-    struct Q15Cpx { int16_t r; int16_t i; };
-    std::vector<Q15Cpx> fft_in_;
-    std::vector<Q15Cpx> fft_out_;
+    std::vector<Q15Complex> downchirp_taps_;   ///< downchirp at the base tap of each bin
+    std::vector<Q15Complex> fft_in_;
+    std::vector<Q15Complex> fft_out_;
+    Derotator derotator_;
+    int base_tap_{0};
 
     float cfo_frac_{0.0f};
     int cfo_int_{0};
@@ -1,12 +1,12 @@
 #pragma once
 
+#include "host_sim/fft_backend.hpp"
+
 #include <complex>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
-extern "C" {
-#include "kiss_fft.h"
-}
-
 namespace host_sim
 {
 
@@ -14,7 +14,6 @@ class FftDemodReference
 {
 public:
     FftDemodReference(int sf, int sample_rate, int bandwidth);
-    ~FftDemodReference();
 
     FftDemodReference(const FftDemodReference&) = delete;
     FftDemodReference& operator=(const FftDemodReference&) = delete;
@@ -32,10 +31,10 @@ private:
     int oversample_factor_;
     int samples_per_symbol_;
 
-    std::vector<std::complex<float>> downchirp_;
-    kiss_fft_cfg kiss_cfg_;
-    mutable std::vector<kiss_fft_cpx> fft_input_;
-    mutable std::vector<kiss_fft_cpx> fft_output_;
+    std::shared_ptr<const std::vector<std::complex<float>>> downchirp_;
+    const FftPlan* fft_plan_{nullptr};
+    mutable std::vector<std::complex<float>> fft_input_;
+    mutable std::vector<std::complex<float>> fft_output_;
     float fractional_offset_{0.0f};
     float sfo_slope_{0.0f};
     int cfo_int_{0};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "host_sim/dsp_kernels.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+
+namespace host_sim
+{
+
+/// Peak search of one window on the device: the two strongest bins as
+/// kernels::find_two_peaks() reports them, plus |X|² either side of the
+/// bin FftDemodulator settles on after its adjacent-tie rule, which is all
+/// its interpolation and decision need.
+struct GpuPeak
+{
+    kernels::PeakPair peaks;
+    float prev_mag{0.0f};
+    float next_mag{0.0f};
+};
+
+/// Batched dechirp + FFT + peak search on a GPU (-DHOST_SIM_WITH_CUDA=ON).
+///
+/// One launch covers thousands of symbol windows: window i starts at
+/// samples + offsets[i] and is derotated by phase step phase_steps[i]
+/// (Derotator::phase_step()), decimated at the demodulator's tap and
+/// dechirped on the device, transformed by one batched cuFFT plan and
+/// reduced to a GpuPeak without the spectra ever crossing the bus.  The
+/// samples are staged through two pinned buffers on two streams, so the
+/// copy of one batch out of host memory (typically a MappedCapture)
+/// overlaps the kernels of the previous one.
+///
+/// Rotations are evaluated per tap on the device rather than from the
+/// Derotator's recursive table, and cuFFT rounds differently from the CPU
+/// backends, so a peak within float rounding of its neighbour can resolve
+/// the other way; symbols otherwise match the CPU path.
+///
+/// Calls are serialised per instance; throws std::runtime_error on a CUDA
+/// error.
+class GpuDemodulator
+{
+public:
+    virtual ~GpuDemodulator() = default;
+
+    virtual void demodulate(const std::complex<float>* samples,
+                            const std::size_t* offsets,
+                            const double* phase_steps,
+                            std::size_t count,
+                            GpuPeak* peaks) const = 0;
+
+    int sf() const { return sf_; }
+    int oversample_factor() const { return os_; }
+    int base_tap() const { return base_tap_; }
+
+protected:
+    GpuDemodulator(int sf, int oversample_factor, int base_tap)
+        : sf_(sf), os_(oversample_factor), base_tap_(base_tap)
+    {
+    }
+
+private:
+    int sf_;
+    int os_;
+    int base_tap_;
+};
+
+/// Fewest windows worth a launch; smaller blocks stay on the CPU.
+constexpr std::size_t kGpuMinBatch = 256;
+
+/// True when the CUDA backend is compiled in and a device answered; probed
+/// once.
+bool gpu_available();
+
+/// Process-wide device demodulator per (sf, os, decimation tap), built on
+/// first use; nullptr when no GPU is available.
+std::shared_ptr<const GpuDemodulator> shared_gpu_demodulator(int sf, int oversample_factor, int base_tap);
+
+} // namespace host_sim
@@ -5,13 +5,15 @@
 namespace host_sim
 {
 
-inline uint16_t gray_decode(uint16_t symbol)
+/// Inverse Gray code: each output bit is the XOR of the input bits at and
+/// above it, computed as a four-step prefix XOR (no table, no loop).
+constexpr uint16_t gray_decode(uint16_t symbol)
 {
-    uint16_t result = symbol;
-    while (symbol >>= 1u) {
-        result ^= symbol;
-    }
-    return result;
+    symbol ^= static_cast<uint16_t>(symbol >> 1);
+    symbol ^= static_cast<uint16_t>(symbol >> 2);
+    symbol ^= static_cast<uint16_t>(symbol >> 4);
+    symbol ^= static_cast<uint16_t>(symbol >> 8);
+    return symbol;
 }
 
 } // namespace host_sim
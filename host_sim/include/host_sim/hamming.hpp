@@ -1,13 +1,147 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
 namespace host_sim
 {
 
+namespace detail
+{
+
+// Codeword layout (gr-lora_sdr): the MSB of a (cr+4)-bit codeword is d0,
+// then d1..d3, then the check bits.  These helpers generate the tables
+// at compile time from the same rules the bitwise reference applies.
+
+constexpr uint8_t hamming_encode_bits(uint8_t nibble, int cr)
+{
+    const int d0 = nibble & 1;
+    const int d1 = (nibble >> 1) & 1;
+    const int d2 = (nibble >> 2) & 1;
+    const int d3 = (nibble >> 3) & 1;
+    if (cr == 1) {
+        return static_cast<uint8_t>((d0 << 4) | (d1 << 3) | (d2 << 2) | (d3 << 1) | (d0 ^ d1 ^ d2 ^ d3));
+    }
+    const int p0 = d0 ^ d1 ^ d2;
+    const int p1 = d1 ^ d2 ^ d3;
+    const int p2 = d0 ^ d1 ^ d3;
+    const int p3 = d0 ^ d2 ^ d3;
+    const int full = (d0 << 7) | (d1 << 6) | (d2 << 5) | (d3 << 4) | (p0 << 3) | (p1 << 2) | (p2 << 1) | p3;
+    return static_cast<uint8_t>(full >> (4 - cr));
+}
+
+constexpr uint8_t hamming_decode_bits(uint8_t codeword, int cr)
+{
+    const int len = cr + 4;
+    // b[k] is codeword bit (len - 1 - k): b[0] = d0.
+    int b[8] = {};
+    int ones = 0;
+    for (int k = 0; k < len; ++k) {
+        b[k] = (codeword >> (len - 1 - k)) & 1;
+        ones += b[k];
+    }
+    int data[4] = {b[3], b[2], b[1], b[0]};
+    // CR 4/8 corrects single errors only when the overall parity fails;
+    // CR 4/7 always corrects; CR 4/5 and 4/6 only detect.
+    if (cr == 3 || (cr == 4 && ones % 2 != 0)) {
+        const int s0 = b[0] ^ b[1] ^ b[2] ^ b[4];
+        const int s1 = b[1] ^ b[2] ^ b[3] ^ b[5];
+        const int s2 = b[0] ^ b[1] ^ b[3] ^ b[6];
+        switch (s0 | (s1 << 1) | (s2 << 2)) {
+        case 5: data[3] ^= 1; break;
+        case 7: data[2] ^= 1; break;
+        case 3: data[1] ^= 1; break;
+        case 6: data[0] ^= 1; break;
+        default: break;
+        }
+    }
+    return static_cast<uint8_t>((data[0] << 3) | (data[1] << 2) | (data[2] << 1) | data[3]);
+}
+
+// True when the check bits flag an error the decoder cannot repair: a
+// parity failure at CR 4/5, a non-zero syndrome at CR 4/6, a double error
+// (even parity, non-zero syndrome) at CR 4/8.  CR 4/7 corrects every
+// syndrome, so nothing is flagged there.
+constexpr bool hamming_uncorrectable_bits(uint8_t codeword, int cr)
+{
+    const int len = cr + 4;
+    int b[8] = {};
+    int ones = 0;
+    for (int k = 0; k < len; ++k) {
+        b[k] = (codeword >> (len - 1 - k)) & 1;
+        ones += b[k];
+    }
+    const int s0 = b[0] ^ b[1] ^ b[2] ^ b[4];
+    const int s1 = b[1] ^ b[2] ^ b[3] ^ b[5];
+    const int s2 = b[0] ^ b[1] ^ b[3] ^ b[6];
+    switch (cr) {
+    case 1: return ones % 2 != 0;
+    case 2: return (s0 | s1) != 0;
+    case 4: return ones % 2 == 0 && (s0 | s1 | s2) != 0;
+    default: return false;
+    }
+}
+
+/// kHammingEncode[cr - 1][nibble]
+inline constexpr auto kHammingEncode = [] {
+    std::array<std::array<uint8_t, 16>, 4> table{};
+    for (int cr = 1; cr <= 4; ++cr) {
+        for (int d = 0; d < 16; ++d) {
+            table[cr - 1][d] = hamming_encode_bits(static_cast<uint8_t>(d), cr);
+        }
+    }
+    return table;
+}();
+
+/// kHammingDecode[cr - 1][codeword]; bits above cr + 4 are ignored.
+inline constexpr auto kHammingDecode = [] {
+    std::array<std::array<uint8_t, 256>, 4> table{};
+    for (int cr = 1; cr <= 4; ++cr) {
+        for (int cw = 0; cw < 256; ++cw) {
+            table[cr - 1][cw] = hamming_decode_bits(static_cast<uint8_t>(cw), cr);
+        }
+    }
+    return table;
+}();
+
+/// kHammingUncorrectable[cr - 1][codeword]; bits above cr + 4 are ignored.
+inline constexpr auto kHammingUncorrectable = [] {
+    std::array<std::array<bool, 256>, 4> table{};
+    for (int cr = 1; cr <= 4; ++cr) {
+        for (int cw = 0; cw < 256; ++cw) {
+            table[cr - 1][cw] = hamming_uncorrectable_bits(static_cast<uint8_t>(cw), cr);
+        }
+    }
+    return table;
+}();
+
+} // namespace detail
+
+/// Encode a data nibble into its (cr+4)-bit codeword (table lookup).
+constexpr uint8_t hamming_encode(uint8_t nibble, int cr)
+{
+    return detail::kHammingEncode[static_cast<std::size_t>(cr - 1)][nibble & 0xFu];
+}
+
+/// Hard-decision decode of one codeword (table lookup for cr_app 1..4).
 uint8_t hamming_decode(uint8_t codeword, int cr_app);
 
+/// Whether the check bits of a (cr+4)-bit codeword flag an error that
+/// hamming_decode() passes through uncorrected (cr_app 1..4).
+constexpr bool hamming_uncorrectable(uint8_t codeword, int cr_app)
+{
+    return detail::kHammingUncorrectable[static_cast<std::size_t>(cr_app - 1)][codeword];
+}
+
 std::vector<uint8_t> hamming_decode_block(const std::vector<uint8_t>& codewords, bool header, int cr);
 
+/// Allocation-free hamming_decode_block(): decodes @p count codewords into
+/// @p out (room for @p count nibbles) and returns @p count.
+std::size_t hamming_decode_block(const uint8_t* codewords, std::size_t count, bool header, int cr, uint8_t* out);
+
+/// Bit-by-bit decoder the tables are checked against.
+uint8_t hamming_decode_reference(uint8_t codeword, int cr_app);
+
 } // namespace host_sim
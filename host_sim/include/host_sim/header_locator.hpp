@@ -0,0 +1,86 @@
+#pragma once
+
+#include "host_sim/lora_params.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace host_sim
+{
+
+/// 5-bit explicit-header checksum over the first three header nibbles
+/// (length high, length low, CR/CRC flags), as gr-lora_sdr computes it.
+constexpr int header_checksum(int n0, int n1, int n2)
+{
+    const auto bit = [](int nibble, int b) { return (nibble >> b) & 1; };
+    const int c4 = bit(n0, 3) ^ bit(n0, 2) ^ bit(n0, 1) ^ bit(n0, 0);
+    const int c3 = bit(n0, 3) ^ bit(n1, 3) ^ bit(n1, 2) ^ bit(n1, 1) ^ bit(n2, 0);
+    const int c2 = bit(n0, 2) ^ bit(n1, 3) ^ bit(n1, 0) ^ bit(n2, 3) ^ bit(n2, 1);
+    const int c1 = bit(n0, 1) ^ bit(n1, 2) ^ bit(n1, 0) ^ bit(n2, 2) ^ bit(n2, 1) ^ bit(n2, 0);
+    const int c0 = bit(n0, 0) ^ bit(n1, 1) ^ bit(n2, 3) ^ bit(n2, 2) ^ bit(n2, 1) ^ bit(n2, 0);
+    return (c4 << 4) | (c3 << 3) | (c2 << 2) | (c1 << 1) | c0;
+}
+
+/// The fields carried by the five explicit-header nibbles.
+struct HeaderFields
+{
+    int payload_len{0};
+    int cr{0};
+    bool has_crc{false};
+    int checksum_field{-1};
+    int checksum_computed{-1};
+    std::size_t consumed_symbols{0};   ///< Symbols the header blocks occupy
+    bool valid{false};                 ///< Checksum matches, length > 0, CR 1..4
+};
+
+/// Parse five header nibbles (low 4 bits of each) into fields.
+constexpr HeaderFields parse_header_nibbles(const uint8_t* nibbles)
+{
+    const int n0 = nibbles[0] & 0xF;
+    const int n1 = nibbles[1] & 0xF;
+    const int n2 = nibbles[2] & 0xF;
+    HeaderFields fields;
+    fields.payload_len = (n0 << 4) | n1;
+    fields.has_crc = (n2 & 0x1) != 0;
+    fields.cr = (n2 >> 1) & 0x7;
+    fields.checksum_field = ((nibbles[3] & 0x1) << 4) | (nibbles[4] & 0xF);
+    fields.checksum_computed = header_checksum(n0, n1, n2);
+    // The 5-bit checksum passes one false lock in 32; a coding rate outside
+    // 4/5..4/8 is never valid and would make the payload deinterleaver throw.
+    fields.valid = fields.payload_len > 0 && fields.cr >= 1 && fields.cr <= 4 &&
+                   fields.checksum_field == fields.checksum_computed;
+    return fields;
+}
+
+/// Decode the explicit header whose first symbol is @p symbols[start],
+/// in place: each 8-symbol block is deinterleaved and Hamming-decoded
+/// into stack buffers (two blocks at SF6, whose first block carries only
+/// four nibbles).  `valid` is false when the symbols run out.
+HeaderFields decode_header_at(std::span<const uint16_t> symbols, std::size_t start, const LoRaMetadata& meta);
+
+/// How a locate_header() call went.
+struct HeaderLocation
+{
+    std::size_t index{0};              ///< First header symbol
+    HeaderFields fields;
+    std::optional<std::size_t> sync_index;   ///< Header index the sync word predicts
+    std::size_t candidates{0};         ///< Header positions decoded
+};
+
+/// Find the explicit header in a stream of demodulated symbols.
+///
+/// Candidates are decoded with decode_header_at() and kept when the
+/// checksum passes and the fields agree with what @p meta pins down
+/// (payload length, CR, and CRC presence when `has_crc` is set).  The
+/// sync word (0x12, else 0x34) predicts where the header should sit, so
+/// the positions within two symbols of that prediction are tried first
+/// and the passing one closest to it wins (lower index on a tie).  With
+/// no sync word, or no passing candidate near it, every position is
+/// scanned and the first passing one wins — the false lock a 5-bit
+/// checksum lets through once in 32 candidates is thereby confined to
+/// streams that carry no usable sync word.
+std::optional<HeaderLocation> locate_header(std::span<const uint16_t> symbols, const LoRaMetadata& meta);
+
+} // namespace host_sim
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "host_sim/lora_params.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace host_sim
+{
+
+/// A decoded packet as cancel_packet() re-synthesises it: what the TX
+/// encoder needs to rebuild its data symbols, and where and how it was
+/// received.
+struct CancelTarget
+{
+    std::vector<uint8_t> payload;   ///< Dewhitened payload bytes
+    int cr{1};
+    bool has_crc{true};
+    std::size_t preamble_offset{0}; ///< A preamble window start, buffer samples
+    float cfo_hz{0.0f};
+    float sfo{0.0f};                ///< Bins per symbol
+};
+
+/// Where the re-synthesised frame was placed and how much it removed.
+struct CancelResult
+{
+    std::size_t begin{0};           ///< First buffer sample of the frame (clipped to the buffer)
+    std::size_t end{0};             ///< One past its last sample (clipped)
+    std::ptrdiff_t frame_start{0};  ///< First preamble chirp; negative when the buffer cut it off
+    float suppression_db{0.0f};     ///< Power over [begin, end) before against after
+};
+
+/// Successive interference cancellation of one decoded packet.
+///
+/// The payload is re-encoded and modulated with the TX chain
+/// (tx::encode_packet_symbols(), tx::modulate_packet_into()), rotated by
+/// the estimated CFO, and placed chirp by chirp: the frame start is
+/// searched over whole symbols around `preamble_offset` (the preamble
+/// lock does not say how many upchirps came before it) and ±2 samples,
+/// scored on the sync word, SFD and first data chirps; each chirp then
+/// follows the SFO drift, re-centred within ±1 sample on its own
+/// correlation peak.  Every chirp is subtracted with its own least-squares
+/// complex gain, which absorbs the amplitude, the carrier phase and what
+/// the CFO estimate left over.  Samples of other packets are orthogonal
+/// enough to the replica that the fit barely sees them.
+///
+/// Placement is to the whole sample, so at OS=1 a capture whose timing
+/// falls between samples is suppressed less deeply.  Returns std::nullopt
+/// when no part of the frame lies in @p samples.
+std::optional<CancelResult> cancel_packet(std::span<std::complex<float>> samples,
+                                          const LoRaMetadata& metadata,
+                                          const CancelTarget& target);
+
+} // namespace host_sim
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace host_sim
+{
+
+/// Lock-free single-producer/single-consumer ring of complex samples.
+///
+/// The storage is mapped twice back to back ("magic" ring), so the
+/// readable region is always one contiguous span even when it wraps:
+/// read_ptr()[0 .. readable()) is valid without any copy.  Where the
+/// double mapping is unavailable the ring keeps a mirrored second copy
+/// instead, with the same contiguity guarantee at the cost of one extra
+/// write per sample.
+///
+/// push() may only be called by one producer thread and read_ptr() /
+/// consume() by one consumer thread; readable() and write_space() are
+/// safe from either side.
+class IqRingBuffer
+{
+public:
+    /// Capacity is rounded up to a whole number of memory pages.
+    explicit IqRingBuffer(std::size_t min_capacity);
+    ~IqRingBuffer();
+
+    IqRingBuffer(const IqRingBuffer&) = delete;
+    IqRingBuffer& operator=(const IqRingBuffer&) = delete;
+
+    std::size_t capacity() const { return capacity_; }
+
+    /// True when the storage is double-mapped rather than mirrored.
+    bool double_mapped() const { return mapping_ != nullptr; }
+
+    // ── Producer side ──
+
+    /// Free slots the producer can fill without overwriting unread data.
+    std::size_t write_space() const;
+
+    /// Copy up to @p n samples in and publish them; returns how many fit.
+    std::size_t push(const std::complex<float>* samples, std::size_t n);
+
+    // ── Consumer side ──
+
+    /// Samples published but not yet consumed.
+    std::size_t readable() const;
+
+    /// First unconsumed sample; contiguous for readable() samples.
+    const std::complex<float>* read_ptr() const;
+
+    /// Release the first @p n readable samples back to the producer.
+    void consume(std::size_t n);
+
+private:
+    std::complex<float>* base_{nullptr};
+    std::size_t capacity_{0};
+    void* mapping_{nullptr};
+    std::size_t mapping_bytes_{0};
+    std::vector<std::complex<float>> mirror_;
+
+    alignas(64) std::atomic<std::uint64_t> write_pos_{0};
+    alignas(64) std::atomic<std::uint64_t> read_pos_{0};
+};
+
+} // namespace host_sim
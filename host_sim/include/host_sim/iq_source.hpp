@@ -0,0 +1,101 @@
+#pragma once
+
+#include "host_sim/capture.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace host_sim
+{
+
+/// Sample sources StreamingIqReader can read from.
+///
+/// file reads a FILE* (stdin by default) in the --format encoding.  udp
+/// takes raw datagrams of that encoding; vita49 takes VITA-49 IF data
+/// packets (sc16, big-endian, as SDR servers send them) and reports lost
+/// packets and their timestamps.  zmq subscribes to a ZeroMQ PUB socket,
+/// so any number of decoders can share one radio; soapysdr streams from
+/// a radio (HackRF, RTL-SDR, USRP, ...) through SoapySDR without a pipe.
+/// zmq and soapysdr are built only with HOST_SIM_WITH_ZMQ and
+/// HOST_SIM_WITH_SOAPYSDR.
+enum class IqSourceKind
+{
+    file,
+    udp,
+    vita49,
+    zmq,
+    soapysdr,
+};
+
+/// Which source to open and how.
+struct IqSourceSpec
+{
+    IqSourceKind kind{IqSourceKind::file};
+    IqFormat format{IqFormat::cf32};    ///< Wire encoding (file, udp, zmq)
+    std::string address;                ///< udp/vita49: bind address ("" = any); zmq: endpoint; soapysdr: device args
+    std::uint16_t port{0};              ///< udp/vita49: 0 picks a free port
+    double frequency_hz{0.0};           ///< soapysdr
+    double sample_rate{0.0};            ///< soapysdr
+    std::optional<double> gain_db;      ///< soapysdr: unset = automatic gain
+    std::string antenna;                ///< soapysdr: "" = driver default
+    std::size_t channel{0};             ///< soapysdr
+};
+
+/// Parse a --source URI:
+///
+///     -  or  stdin                    FILE* source in `format`
+///     udp://[addr]:port               raw datagrams in `format`
+///     vita49://[addr]:port            VITA-49 IF data packets
+///     zmq+tcp://host:port             ZeroMQ SUB (any zmq transport: zmq+ipc://...)
+///     soapy://[args][?freq=..&rate=..&gain=..&antenna=..&channel=..]
+///
+/// SoapySDR device args are the usual "driver=hackrf,serial=..." list;
+/// freq and rate take plain or exponent notation (868.1e6).  Throws
+/// std::runtime_error on a malformed URI.
+IqSourceSpec parse_iq_source(std::string_view uri, IqFormat format);
+
+/// One IqSource::read().
+struct IqSourceRead
+{
+    std::size_t samples{0};                 ///< Complex samples written to `out`
+    bool end{false};                        ///< The source is finished (EOF, interrupt)
+    std::uint64_t lost_samples{0};          ///< Samples the source lost just before these
+    bool overflow{false};                   ///< The radio or network reported an overflow
+    std::optional<std::int64_t> time_ns;    ///< Source time of the first sample written
+};
+
+/// Where StreamingIqReader's I/O thread gets its samples.  read() is only
+/// called from that thread; interrupt() may be called from any other.
+class IqSource
+{
+public:
+    virtual ~IqSource() = default;
+
+    /// Wait for samples and convert up to @p max_samples of them to
+    /// complex float in @p out.  A short read is not the end of the
+    /// stream; `end` is.
+    virtual IqSourceRead read(std::complex<float>* out, std::size_t max_samples) = 0;
+
+    /// Make a blocked read() return with `end` soon.  Returns false when
+    /// the source cannot do that (a FILE* in fread()); the reader then
+    /// leaves its thread to finish on its own.
+    virtual bool interrupt() { return false; }
+
+    /// The source as a URI, with the port actually bound (logs, tests).
+    virtual std::string describe() const = 0;
+};
+
+/// Open @p spec; a file source reads @p file.  Throws std::runtime_error
+/// when the source cannot be opened or its kind is not built.
+std::unique_ptr<IqSource> open_iq_source(const IqSourceSpec& spec, std::FILE* file = stdin);
+
+const char* iq_source_kind_name(IqSourceKind kind);
+bool iq_source_available(IqSourceKind kind);
+
+} // namespace host_sim
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace host_sim
 {
@@ -21,6 +22,15 @@ struct LoRaMetadata
     bool ldro{false};
     int sync_word{0x12};
     std::optional<std::string> payload_hex;
+
+    /// Wideband captures: when `channels` is non-empty the capture runs at
+    /// `capture_sample_rate` and each listed channel is channelized down
+    /// to `sample_rate` before decoding.  Entries are absolute frequencies
+    /// when `center_freq` (the capture's tuning) is given, otherwise
+    /// offsets from the capture centre; all in Hz.
+    int capture_sample_rate{0};
+    std::optional<double> center_freq;
+    std::vector<double> channels;
 };
 
 LoRaMetadata load_metadata(const std::filesystem::path& path);
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/lora_replay/header_decoder.hpp"
+#include "host_sim/lora_replay/options.hpp"
+#include "host_sim/lora_replay/stage_processing.hpp"
+#include "host_sim/payload_decoder.hpp"
+#include "host_sim/polyphase_samples.hpp"
+#include "host_sim/soft_decode.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace host_sim::lora_replay
+{
+
+// Per-burst decode steps shared by lora_replay's batch and stream paths
+// and by the in-process sweep harness.
+
+// CRC-16/CCITT: computes CRC over ALL input bytes (no XOR with trailing bytes).
+// Different from host_sim::lora_replay::compute_lora_crc which includes the
+// gr-lora_sdr last-2-byte XOR.  Used by probe_payload_crc which does the XOR manually.
+uint16_t compute_raw_crc16(const std::vector<uint8_t>& payload);
+
+// Implicit-header stand-in for the first block at `symbols`: the block is
+// deinterleaved at the header rate (CR 4/8) and its nibbles placed after
+// five zero placeholders for the absent header fields, which come from
+// `meta` instead.
+HeaderDecodeResult implicit_header(std::span<const uint16_t> symbols,
+                                   const host_sim::LoRaMetadata& meta,
+                                   std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+// Upsample complex IQ data by 2x using linear interpolation into @p out
+// (2·count − 1 samples), reusing its capacity.  The OS=2 fallbacks read
+// their half-sample windows from a FarrowResampler instead; this stays for
+// tools that want the whole upsampled burst.
+void upsample_2x(const std::complex<float>* data, std::size_t count, std::vector<std::complex<float>>& out);
+
+// SFO rate candidates (ppm) for the OS=2 upsample fallback: 0 first, then
+// spiralling outward in 10 ppm steps to ±100 ppm.
+std::vector<int> os2_sfo_candidates();
+
+// Whether the demodulation passes over a burst at oversampling `os`
+// should read polyphase planes (host_sim::PolyphaseSamples) instead of
+// gathering taps from the interleaved samples: from OS 8 on, unless
+// HOST_SIM_SAMPLE_LAYOUT=interleaved|split forces either layout.
+bool use_polyphase_planes(int os);
+
+// Demodulate up to `max_symbols` windows starting at burst sample
+// `offset`, spaced by a (possibly fractional) `stride`, and append them to
+// `symbols`.  The taps come from `planes` when set (split once from the
+// same burst), from `burst` otherwise.  With `llrs` set, per-symbol soft
+// values are appended too; the first eight symbols of the span are treated
+// as the reduced-rate header block.  A span continuing an earlier one
+// passes the index its first symbol has within it.  Scratch comes from
+// the resource `symbols` allocates from.
+void demodulate_span(const host_sim::FftDemodulator& demod,
+                     std::span<const std::complex<float>> burst,
+                     const host_sim::PolyphaseSamples* planes,
+                     std::size_t offset,
+                     double stride,
+                     std::size_t max_symbols,
+                     const host_sim::LoRaMetadata& meta,
+                     std::pmr::vector<uint16_t>& symbols,
+                     std::pmr::vector<host_sim::SoftSymbol>* llrs = nullptr,
+                     std::size_t first_index = 0);
+
+// Which pass of decode_stream_burst() locked the header.
+enum class DecodePath : std::uint8_t
+{
+    none,           // no header
+    grid,           // preamble-grid demodulation
+    sfd_redemod,    // SFD re-demod (tracked, with quarter-offset/timing sweeps)
+    os2,            // OS=2 fallback
+    count
+};
+
+constexpr std::size_t kDecodePathCount = static_cast<std::size_t>(DecodePath::count);
+
+const char* decode_path_name(DecodePath path);
+
+using DecodeEffort = Options::DecodeEffort;
+
+constexpr std::size_t kDecodeEffortCount = 3;
+
+const char* decode_effort_name(DecodeEffort effort);
+
+// Effort tier and wall-clock deadline for the fallback passes of one
+// burst.  exhausted() turns true once `budget_ms` has passed (never for a
+// budget of 0) and stays true; it is safe to call from the OS=2 candidate
+// workers.
+class FallbackBudget
+{
+public:
+    FallbackBudget(DecodeEffort effort, double budget_ms);
+
+    DecodeEffort effort() const { return effort_; }
+    // Deepest tier whose passes ran.
+    DecodeEffort reached() const { return reached_; }
+    void escalate(DecodeEffort tier) { reached_ = std::max(reached_, tier); }
+    bool exhausted();
+    bool was_exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+private:
+    DecodeEffort effort_;
+    DecodeEffort reached_{DecodeEffort::fast};
+    bool limited_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<bool> exhausted_{false};
+};
+
+// Header locked by a fallback pass, with the symbols (and LLRs, when soft)
+// demodulated from its first data symbol on.  header.success is false when
+// the pass found nothing.
+struct FallbackDecode
+{
+    explicit FallbackDecode(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : header(memory), symbols(memory), llrs(memory)
+    {
+    }
+
+    HeaderDecodeResult header;
+    std::pmr::vector<uint16_t> symbols;
+    std::pmr::vector<host_sim::SoftSymbol> llrs;
+    std::size_t data_sample{0};     // first data symbol, burst samples
+};
+
+// SFD re-demod: demodulate the data symbols again from `sync_pos`, the
+// preamble-grid index find_header_symbol_index() gives for the first data
+// symbol, at quarter-symbol offsets 1, 0, 2 and 3 past it.  Each pass runs
+// closed-loop symbol timing from a nominal `stride` (SFO-compensated by the
+// caller); a header whose payload fails its CRC gets a timing sweep of
+// ±(max(os, 4) + 2) samples, and an implicit header is only taken once the
+// CRC passes.  Every pass restarts from the CFO `demod` holds on entry.
+// Fast effort stops after quarter offset 1 without the sweep.
+FallbackDecode redemod_from_sfd(host_sim::FftDemodulator& demod,
+                                std::span<const std::complex<float>> burst,
+                                const host_sim::PolyphaseSamples* planes,
+                                std::size_t alignment_offset,
+                                std::size_t sync_pos,
+                                double stride,
+                                const host_sim::LoRaMetadata& meta,
+                                bool soft,
+                                FallbackBudget& budget,
+                                std::ostream& out,
+                                std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+// OS=2 fallback for an OS=1 burst: the burst from `alignment_offset` on is
+// read at twice the rate (resampled on demand) and the data symbols after
+// `sync_pos` demodulated for every SFO rate in os2_sfo_candidates(), at
+// quarter offset 1 (every offset at exhaustive effort), with CFO
+// `cfo_frac`/`cfo_int`.  The first candidate in sweep order whose header
+// and payload CRC check out wins; if none does, the header hits are retried
+// with a ±3-sample timing sweep.  A header without a CRC is taken as is.
+// Candidates run on the worker pool; not run at fast effort.
+FallbackDecode redemod_at_os2(std::span<const std::complex<float>> burst,
+                              std::size_t alignment_offset,
+                              std::size_t sync_pos,
+                              float cfo_frac,
+                              int cfo_int,
+                              const host_sim::LoRaMetadata& meta,
+                              bool soft,
+                              FallbackBudget& budget,
+                              std::ostream& out);
+
+// Outcome of decoding one streamed burst, folded into the PER/BER counters
+// by the caller.
+struct StreamDecodeResult
+{
+    DecodePath path{DecodePath::none};
+    bool header_ok{false};
+    bool crc_ok{false};
+    bool crc_expected{false};
+    bool payload_failure{false};
+    bool payload_mismatch{false};
+    int bit_errors{0};
+    int total_bits{0};
+    int cr{0};                      // coding rate in use (0 without a header)
+    float cfo_hz{0.0f};             // preamble CFO estimate
+    float sfo{0.0f};                // preamble SFO slope, bins per symbol
+    std::size_t preamble_offset{0}; // first preamble window, burst samples
+    DecodeEffort effort{DecodeEffort::fast};   // deepest tier whose passes ran
+    bool budget_exhausted{false};   // stopped escalating at the decode_budget_ms deadline
+    std::vector<uint8_t> payload;   // dewhitened payload bytes (empty without a header)
+};
+
+// Preamble lock of a burst: where its symbols start and the CFO/SFO
+// found there.  lock_preamble() leaves the CFO set on the demodulator.
+struct PreambleLock
+{
+    std::size_t alignment_offset{0};    // first preamble window, burst samples
+    float sfo{0.0f};                    // SFO slope, bins per symbol
+    float cfo_hz{0.0f};
+};
+
+// Alignment, CFO/SFO estimation and sub-sample refinement on the burst
+// head, writing the CFO line of the report to `out`.  Reads no more than
+// the first preamble_len + 9 symbols of `burst_samples`.
+PreambleLock lock_preamble(std::span<const std::complex<float>> burst_samples,
+                           host_sim::FftDemodulator& demod,
+                           const host_sim::LoRaMetadata& metadata,
+                           std::ostream& out,
+                           std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+// Report a finished payload decode: copy the dewhitened payload into
+// `result`, print it with its CRC verdict, and check it against the
+// expected `options.payload` for the BER counters.
+void conclude_payload(const host_sim::PayloadDecoder& decoder,
+                      int payload_len,
+                      const Options& options,
+                      StreamDecodeResult& result,
+                      std::ostream& out);
+
+// Decode one burst with `demod` (alignment, CFO/SFO estimation, header
+// search with SFD re-demod and OS=2 fallback, payload and CRC), writing
+// the report to `out`.  Safe to run concurrently on distinct demodulators.
+// Only `payload` (expected bytes, for BER), `soft`, `cfo_track_alpha`,
+// `effort` and `decode_budget_ms` are read from `options`.
+//
+// `effort` bounds the escalation after the preamble-grid pass: fast stops
+// after one SFD re-demod pass (quarter offset 1, no CRC timing sweep);
+// standard adds the other quarter offsets, the sweeps and the OS=2
+// fallback; exhaustive also runs OS=2 at every quarter offset.  With a
+// `decode_budget_ms`, no further pass starts once that much wall time
+// has gone, and the decode reports the best result it has.
+//
+// The decode's scratch state (alignment buffers, symbol and LLR vectors,
+// polyphase planes, header nibbles) is allocated from `memory`, typically
+// a host_sim::DecodeArena reset after the call; only the returned payload
+// and the OS=2 fallback's parallel candidates use the heap.
+StreamDecodeResult decode_stream_burst(std::span<const std::complex<float>> burst_samples,
+                                       host_sim::FftDemodulator& demod,
+                                       const host_sim::LoRaMetadata& metadata,
+                                       const Options& options,
+                                       std::ostream& out,
+                                       std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+} // namespace host_sim::lora_replay
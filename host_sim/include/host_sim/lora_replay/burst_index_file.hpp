@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace host_sim::lora_replay
+{
+
+// ── Burst index sidecar ─────────────────────────────────────────────
+// `lora_replay --write-index` records what acquisition found for every
+// packet of a capture; `--read-index` seeks straight to each packet and
+// reuses it instead of re-running burst detection, alignment and the
+// CFO/SFO search.  Little-endian throughout:
+//
+//     char magic[4]        "LBIX"
+//     u8   version         1
+//     u8   reserved[3]
+//     u64  capture_samples sample count of the indexed capture
+//     u64  count
+//
+// then `count` records of kBurstIndexRecordBytes:
+//
+//     u64  offset          burst start (sample)
+//     u64  length          samples from offset to the decoded end
+//     u64  alignment       refined symbol alignment (absolute sample)
+//     i32  preamble_bin
+//     i32  cfo_int
+//     f32  cfo_frac
+//     f32  sfo_slope
+//     u8   sf
+//     u8   flags           bit 0: header decoded
+//     u8   reserved[2]
+
+constexpr std::size_t kBurstIndexHeaderBytes = 24;
+constexpr std::size_t kBurstIndexRecordBytes = 44;
+
+struct BurstIndexEntry
+{
+    std::uint64_t offset{0};
+    std::uint64_t length{0};
+    std::uint64_t alignment{0};
+    int preamble_bin{0};
+    int cfo_int{0};
+    float cfo_frac{0.0f};
+    float sfo_slope{0.0f};
+    int sf{0};
+    bool header_ok{false};
+
+    bool operator==(const BurstIndexEntry&) const = default;
+};
+
+struct BurstIndexFile
+{
+    std::uint64_t capture_samples{0};
+    std::vector<BurstIndexEntry> bursts;
+};
+
+std::string encode_burst_index(const BurstIndexFile& index);
+
+// Throws std::runtime_error when `bytes` is not a well-formed index.
+BurstIndexFile decode_burst_index(const std::string& bytes);
+
+void write_burst_index(const std::filesystem::path& path, const BurstIndexFile& index);
+
+// Throws std::runtime_error when `path` cannot be read or is malformed.
+BurstIndexFile read_burst_index(const std::filesystem::path& path);
+
+} // namespace host_sim::lora_replay
@@ -3,17 +3,25 @@
 #include "host_sim/lora_params.hpp"
 #include "host_sim/lora_replay/stage_processing.hpp"
 
+#include <cstddef>
 #include <cstdint>
-#include <vector>
+#include <memory_resource>
+#include <span>
 
 namespace host_sim::lora_replay
 {
 
-HeaderDecodeResult try_decode_header(const std::vector<uint16_t>& symbols,
+// Header block at `start`; the result's codewords and nibbles come from
+// `memory`.
+HeaderDecodeResult try_decode_header(std::span<const uint16_t> symbols,
                                      std::size_t start,
-                                     const host_sim::LoRaMetadata& meta);
+                                     const host_sim::LoRaMetadata& meta,
+                                     std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
-bool probe_payload_crc(const std::vector<uint16_t>& symbols,
+// Quick CRC probe: decode payload from symbols and check CRC.
+// Used for data-start timing refinement at low oversampling,
+// where SFO-induced timing drift can shift data symbols by ±1 bin.
+bool probe_payload_crc(std::span<const uint16_t> symbols,
                        const HeaderDecodeResult& hdr,
                        const host_sim::LoRaMetadata& meta);
 
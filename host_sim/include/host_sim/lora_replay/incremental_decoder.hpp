@@ -0,0 +1,111 @@
+#pragma once
+
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/lora_replay/options.hpp"
+#include "host_sim/payload_decoder.hpp"
+#include "host_sim/soft_decode.hpp"
+#include "host_sim/symbol_timing.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
+#include <span>
+
+namespace host_sim::lora_replay
+{
+
+// Decode of a burst that is still arriving, one symbol at a time.
+//
+// advance() is handed the burst as received so far, each call with more
+// samples at the end.  Once the preamble head is in it locks alignment
+// and CFO/SFO (lock_preamble()), follows the preamble grid to the sync
+// word, then demodulates every data symbol the moment its window is
+// complete, timing-tracked like the first SFD re-demod pass of
+// decode_stream_burst().  The header block gives the payload length, each
+// payload block is decoded as its last symbol lands, and the decode ends
+// with the packet's final symbol: nothing past it is read.
+//
+// There is no second pass.  A missing sync word, a header that fails its
+// checksum or disagrees with the metadata, or a payload that fails its
+// CRC ends the decode as `failed`, and the caller decodes the whole burst
+// with decode_stream_burst() and its sweeps and fallbacks instead.
+//
+// Only `payload`, `soft` and `cfo_track_alpha` are read from `options`.
+// `demod`, `out` and `memory` must outlive the decoder.
+class IncrementalBurstDecoder
+{
+public:
+    enum class Status
+    {
+        pending,    // waiting for more samples
+        done,       // the packet decoded cleanly
+        failed,     // left to a whole-burst decode
+    };
+
+    IncrementalBurstDecoder(host_sim::FftDemodulator& demod,
+                            const host_sim::LoRaMetadata& metadata,
+                            const Options& options,
+                            std::ostream& out,
+                            std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // Carry on over `burst`, which extends the span of the previous call.
+    Status advance(std::span<const std::complex<float>> burst);
+
+    Status status() const { return status_; }
+
+    // Burst samples up to the end of the last window demodulated.
+    std::size_t consumed() const { return consumed_; }
+
+    // Data symbols demodulated so far, header block included.
+    std::size_t data_symbols() const { return symbols_.size(); }
+
+    // Filled in as the decode goes; final once status() is done.
+    const StreamDecodeResult& result() const { return result_; }
+
+private:
+    enum class Stage
+    {
+        preamble,   // waiting for the preamble head
+        sync,       // preamble grid up to the sync word
+        header,     // first data block
+        payload,
+    };
+
+    bool lock(std::span<const std::complex<float>> burst);
+    bool find_sync(std::span<const std::complex<float>> burst);
+    bool decode_header();
+    // Demodulate windows until `count` data symbols are in; false while
+    // the burst is too short for them.
+    bool demodulate_to(std::span<const std::complex<float>> burst, std::size_t count);
+    Status fail(const char* why);
+
+    host_sim::FftDemodulator& demod_;
+    host_sim::LoRaMetadata metadata_;
+    const Options& options_;
+    std::ostream& out_;
+    std::pmr::memory_resource* memory_;
+    std::size_t sps_{0};
+
+    Stage stage_{Stage::preamble};
+    Status status_{Status::pending};
+    PreambleLock lock_;
+    std::pmr::vector<uint16_t> grid_;
+    std::size_t sync_index_{0};
+    std::size_t data_sample_{0};
+    std::optional<host_sim::SymbolTimingTracker> timing_;
+    std::pmr::vector<uint16_t> symbols_;
+    std::pmr::vector<host_sim::SoftSymbol> llrs_;
+    HeaderDecodeResult header_;
+    std::optional<host_sim::PayloadDecoder> payload_;
+    int payload_len_{0};
+    std::size_t cursor_{0};             // next data symbol for the payload decoder
+    std::size_t consumed_{0};
+    StreamDecodeResult result_;
+};
+
+} // namespace host_sim::lora_replay
@@ -19,14 +19,33 @@ struct Options
     std::optional<std::filesystem::path> dump_stages;
     std::optional<std::filesystem::path> dump_payload;
     std::optional<std::filesystem::path> summary_output;
+    std::optional<std::filesystem::path> trace_output;   // --trace: Chrome trace_event JSON
+    std::optional<std::filesystem::path> metrics_output; // --metrics: Prometheus textfile (--stream)
+    double metrics_interval_s{10.0};
+    std::optional<std::filesystem::path> packet_output;  // --packet-output: packet records (--stream; default stdout)
+    std::optional<std::filesystem::path> write_index;    // --write-index: burst index sidecar to record
+    std::optional<std::filesystem::path> read_index;     // --read-index: sidecar replacing acquisition
+    std::string source{"-"};  // --source: stream input URI (stdin, udp://, vita49://, zmq+..., soapy://)
     bool multi_packet{false};
     bool soft{false};
     bool verbose{false};
     bool stream{false};
     bool per_stats{false};
     bool multi_sf{false};
+    bool realtime{false};          // --realtime: paced, pipelined scheduler run
+    bool drop_on_overflow{false};  // --overflow drop: shed input/bursts instead of blocking
     float cfo_track_alpha{0.0f};
-    enum class IqFormat { cf32, hackrf } iq_format{IqFormat::cf32};
+    int decimate_os{0};  // --stream front-end target oversampling (0 = off)
+    int bench_runs{0};   // --bench: timed decode runs over the capture (0 = off)
+    double decode_budget_ms{0.0};  // --decode-budget: per-packet escalation deadline (0 = none)
+    bool defer_recovery{false};    // --defer-recovery: re-decode cut-short failures in the background
+    bool incremental{false};       // --incremental: decode packets symbol by symbol as they arrive
+    int cancel_collisions{0};      // --cancel-collisions: further packets per burst found by cancellation
+    enum class IqFormat { cf32, hackrf, sc16 } iq_format{IqFormat::cf32};
+    enum class PacketFormat { text, ndjson, binary } packet_format{PacketFormat::text};
+    enum class StageFormat { text, binary, delta } stage_format{StageFormat::text};  // --dump-stages files
+    // --effort: how far decode_stream_burst() escalates after the grid pass
+    enum class DecodeEffort { fast, standard, exhaustive } effort{DecodeEffort::standard};
     bool read_stdin{false};
 };
 
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace host_sim::lora_replay
+{
+
+// ── Binary stage dumps ──────────────────────────────────────────────
+// `<prefix>_<stage>.stage` holds the same values as the one-per-line
+// `<prefix>_<stage>.txt` dumps, typed and packed:
+//
+//     char magic[4]   "LSTG"
+//     u8   version    1
+//     u8   encoding   StageEncoding
+//     u8   width      bytes per value: 1, 2, 4 or 8
+//     u8   flags      bit 0: values are signed (two's complement)
+//     u64  count      little-endian
+//
+// then `count` little-endian values of `width` bytes (raw), or `count`
+// LEB128 varints of the zigzagged difference to the previous value
+// (delta_varint, starting from 0).  The writer picks the narrowest width
+// that holds every value, so FFT bins take two bytes and Hamming nibbles
+// one.  tools/convert_stage_dumps.py converts between the two forms.
+
+enum class StageEncoding : std::uint8_t
+{
+    raw = 0,            ///< Fixed width; read in place from the mapping
+    delta_varint = 1,   ///< Smaller on disk; unpacked to raw once on open
+};
+
+constexpr std::size_t kStageDumpHeaderBytes = 16;
+
+/// A stage dump file, memory-mapped.  Raw dumps are read straight from
+/// the mapping; delta dumps are unpacked into one buffer of `width`-byte
+/// values.  Either way indexing never materialises a vector of
+/// `long long`.
+class StageDump
+{
+public:
+    /// Throws std::runtime_error when @p path cannot be read or is not a
+    /// well-formed stage dump.
+    explicit StageDump(const std::filesystem::path& path);
+    ~StageDump();
+
+    StageDump(StageDump&& other) noexcept;
+    StageDump& operator=(StageDump&& other) noexcept;
+    StageDump(const StageDump&) = delete;
+    StageDump& operator=(const StageDump&) = delete;
+
+    std::size_t size() const { return count_; }
+    int width() const { return width_; }
+    bool is_signed() const { return signed_; }
+    StageEncoding encoding() const { return encoding_; }
+
+    long long operator[](std::size_t index) const
+    {
+        const std::uint8_t* p = values_ + index * static_cast<std::size_t>(width_);
+        std::uint64_t bits = 0;
+        for (int b = 0; b < width_; ++b) {
+            bits |= static_cast<std::uint64_t>(p[b]) << (8 * b);
+        }
+        if (signed_ && width_ < 8 && (bits >> (8 * width_ - 1)) != 0) {
+            bits |= ~std::uint64_t{0} << (8 * width_);
+        }
+        return static_cast<long long>(bits);
+    }
+
+private:
+    void unmap();
+
+    const std::uint8_t* values_{nullptr};
+    std::size_t count_{0};
+    int width_{1};
+    bool signed_{false};
+    StageEncoding encoding_{StageEncoding::raw};
+    void* mapping_{nullptr};
+    std::size_t mapping_bytes_{0};
+    std::vector<std::uint8_t> owned_;   // unpacked delta values, or the file without mmap
+};
+
+/// Packs values one at a time behind the header; the value range has to
+/// be known up front to fix the width.
+class StageDumpEncoder
+{
+public:
+    StageDumpEncoder(long long min_value, long long max_value, std::size_t count, StageEncoding encoding);
+
+    void push(long long value);
+
+    /// The encoded file; throws std::logic_error unless exactly `count`
+    /// values were pushed.
+    std::string take();
+
+private:
+    std::string bytes_;
+    std::size_t expected_{0};
+    std::size_t pushed_{0};
+    int width_{1};
+    StageEncoding encoding_{StageEncoding::raw};
+    long long previous_{0};
+};
+
+/// Serialise @p values in the binary dump format.
+template <typename Value>
+std::string encode_stage_dump(const std::vector<Value>& values, StageEncoding encoding = StageEncoding::raw)
+{
+    long long lo = 0;
+    long long hi = 0;
+    if (!values.empty()) {
+        const auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+        lo = static_cast<long long>(*min_it);
+        hi = static_cast<long long>(*max_it);
+    }
+    StageDumpEncoder encoder(lo, hi, values.size(), encoding);
+    for (auto value : values) {
+        encoder.push(static_cast<long long>(value));
+    }
+    return encoder.take();
+}
+
+void write_stage_bytes(const std::filesystem::path& path, const std::string& bytes);
+
+/// Write @p values to @p path in the binary dump format.
+template <typename Value>
+void write_stage_dump(const std::filesystem::path& path, const std::vector<Value>& values,
+                      StageEncoding encoding = StageEncoding::raw)
+{
+    write_stage_bytes(path, encode_stage_dump(values, encoding));
+}
+
+} // namespace host_sim::lora_replay
@@ -3,16 +3,19 @@
 #include "host_sim/capture.hpp"
 #include "host_sim/lora_params.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory_resource>
 #include <optional>
 #include <ostream>
 #include <string>
 #include <stdexcept>
 #include <type_traits>
 #include <tuple>
+#include <utility>
 #include <vector>
 #include <limits>
 
@@ -21,6 +24,13 @@ namespace host_sim::lora_replay
 
 struct HeaderDecodeResult
 {
+    HeaderDecodeResult() = default;
+    // Codewords and nibbles allocated from `memory` (a decode arena).
+    explicit HeaderDecodeResult(std::pmr::memory_resource* memory)
+        : codewords(memory), nibbles(memory)
+    {
+    }
+
     bool success{false};
     int payload_len{0};
     int cr{0};
@@ -29,8 +39,8 @@ struct HeaderDecodeResult
     int consumed_symbols{0};
     int checksum_field{0};
     int checksum_computed{0};
-    std::vector<uint16_t> codewords;
-    std::vector<uint8_t> nibbles;
+    std::pmr::vector<uint16_t> codewords;
+    std::pmr::vector<uint8_t> nibbles;
 };
 
 struct StageOutputs
@@ -77,10 +87,164 @@ struct StageComparisonResult
     bool reference_missing{false};
 };
 
-template <typename HostType>
+namespace detail
+{
+
+// ── Stage alignment engine ──────────────────────────────────────────
+// compare_stage slides the shorter stage along the longer one and keeps
+// the offset with the fewest mismatches, the earliest on ties.  `Longer`
+// and `Shorter` map an index to the value there as long long.
+
+/// Mismatches of `shorter[0, len)` against `longer[offset, offset + len)`,
+/// counted in branch-free blocks; stops early and returns a count above
+/// @p limit once it is exceeded.
+template <typename Longer, typename Shorter>
+std::size_t count_stage_mismatches(const Longer& longer, const Shorter& shorter,
+                                   std::size_t offset, std::size_t len, std::size_t limit)
+{
+    constexpr std::size_t kBlock = 64;
+    std::size_t mismatches = 0;
+    for (std::size_t begin = 0; begin < len; begin += kBlock) {
+        const std::size_t end = std::min(len, begin + kBlock);
+        for (std::size_t idx = begin; idx < end; ++idx) {
+            mismatches += static_cast<std::size_t>(longer(offset + idx) != shorter(idx));
+        }
+        if (mismatches > limit) {
+            break;
+        }
+    }
+    return mismatches;
+}
+
+/// First offset in [0, max_offset] where `shorter[0, len)` occurs in
+/// `longer` exactly (Knuth-Morris-Pratt, linear time).
+template <typename Longer, typename Shorter>
+std::optional<std::size_t> find_exact_alignment(const Longer& longer, const Shorter& shorter,
+                                                std::size_t len, std::size_t max_offset)
+{
+    std::vector<std::size_t> border(len, 0);
+    for (std::size_t i = 1, k = 0; i < len; ++i) {
+        while (k > 0 && shorter(i) != shorter(k)) {
+            k = border[k - 1];
+        }
+        if (shorter(i) == shorter(k)) {
+            ++k;
+        }
+        border[i] = k;
+    }
+    const std::size_t text_len = max_offset + len;
+    for (std::size_t i = 0, k = 0; i < text_len; ++i) {
+        while (k > 0 && longer(i) != shorter(k)) {
+            k = border[k - 1];
+        }
+        if (longer(i) == shorter(k)) {
+            ++k;
+        }
+        if (k == len) {
+            return i + 1 - len;
+        }
+    }
+    return std::nullopt;
+}
+
+/// Likely offset when there is no exact alignment: up to 16 q-grams of
+/// the shorter stage are located in the longer one by rolling hash and
+/// each hit votes for the offset it implies.  Only seeds the search, so
+/// hash collisions cost time, never correctness.
+template <typename Longer, typename Shorter>
+std::optional<std::size_t> seed_alignment(const Longer& longer, const Shorter& shorter,
+                                          std::size_t len, std::size_t max_offset)
+{
+    constexpr std::size_t kGram = 8;
+    constexpr std::size_t kAnchors = 16;
+    constexpr std::uint64_t kBase = 0x100000001b3ull;
+    if (len < kGram) {
+        return std::nullopt;
+    }
+    std::uint64_t top = 1;   // kBase^(kGram - 1)
+    for (std::size_t i = 1; i < kGram; ++i) {
+        top *= kBase;
+    }
+    auto gram_hash = [&](const auto& values, std::size_t begin) {
+        std::uint64_t hash = 0;
+        for (std::size_t i = 0; i < kGram; ++i) {
+            hash = hash * kBase + static_cast<std::uint64_t>(values(begin + i));
+        }
+        return hash;
+    };
+
+    const std::size_t stride = std::max<std::size_t>(1, (len - kGram) / (kAnchors - 1));
+    std::vector<std::pair<std::uint64_t, std::size_t>> anchors;   // (hash, position), sorted
+    for (std::size_t pos = 0; pos + kGram <= len && anchors.size() < kAnchors; pos += stride) {
+        anchors.emplace_back(gram_hash(shorter, pos), pos);
+    }
+    std::sort(anchors.begin(), anchors.end());
+
+    std::vector<std::uint32_t> votes(max_offset + 1, 0);
+    std::uint64_t hash = gram_hash(longer, 0);
+    const std::size_t text_len = max_offset + len;
+    for (std::size_t pos = 0;; ++pos) {
+        auto hit = std::lower_bound(anchors.begin(), anchors.end(), std::make_pair(hash, std::size_t{0}));
+        for (; hit != anchors.end() && hit->first == hash; ++hit) {
+            if (pos >= hit->second && pos - hit->second <= max_offset) {
+                ++votes[pos - hit->second];
+            }
+        }
+        if (pos + kGram >= text_len) {
+            break;
+        }
+        hash = (hash - static_cast<std::uint64_t>(longer(pos)) * top) * kBase +
+               static_cast<std::uint64_t>(longer(pos + kGram));
+    }
+    const auto best = std::max_element(votes.begin(), votes.end());
+    if (*best == 0) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(best - votes.begin());
+}
+
+/// (offset, mismatches) of the best alignment: an exact match is found in
+/// linear time; otherwise the seeded offset bounds the exhaustive sweep,
+/// whose counts stop as soon as an offset can no longer win.
+template <typename Longer, typename Shorter>
+std::pair<std::size_t, std::size_t> best_stage_alignment(const Longer& longer, const Shorter& shorter,
+                                                         std::size_t len, std::size_t max_offset)
+{
+    constexpr std::size_t kNoLimit = std::numeric_limits<std::size_t>::max();
+    if (max_offset == 0) {
+        return {0, count_stage_mismatches(longer, shorter, 0, len, kNoLimit)};
+    }
+    if (const auto exact = find_exact_alignment(longer, shorter, len, max_offset)) {
+        return {*exact, 0};
+    }
+    std::size_t best_offset = seed_alignment(longer, shorter, len, max_offset).value_or(0);
+    std::size_t best = count_stage_mismatches(longer, shorter, best_offset, len, kNoLimit);
+    for (std::size_t offset = 0; offset <= max_offset; ++offset) {
+        if (offset == best_offset) {
+            continue;
+        }
+        // An earlier offset wins ties, a later one has to do strictly better.
+        const std::size_t limit = offset < best_offset ? best : best - 1;
+        const std::size_t mismatches = count_stage_mismatches(longer, shorter, offset, len, limit);
+        if (mismatches <= limit) {
+            best = mismatches;
+            best_offset = offset;
+        }
+    }
+    return {best_offset, best};
+}
+
+} // namespace detail
+
+/// Best-offset comparison of a host stage against a reference:
+/// `Reference` is anything indexable with size() yielding integers (the
+/// parsed text dump or a mapped StageDump).  The shorter sequence is slid
+/// along the longer; the result is the offset with the fewest mismatches,
+/// the earliest on ties.
+template <typename HostType, typename Reference>
 StageComparisonResult compare_stage(const std::string& label,
                                     const std::vector<HostType>& host,
-                                    const std::vector<long long>& reference)
+                                    const Reference& reference)
 {
     StageComparisonResult result;
     result.label = label;
@@ -88,16 +252,16 @@ StageComparisonResult compare_stage(const std::string& label,
     result.ref_count = reference.size();
 
     if (host.empty()) {
-        if (!reference.empty()) {
+        if (reference.size() != 0) {
             result.mismatches = reference.size();
             result.alignment_offset = 0;
             result.first_diff_index = 0;
-            result.ref_value = reference.front();
+            result.ref_value = static_cast<long long>(reference[0]);
         }
         return result;
     }
 
-    if (reference.empty()) {
+    if (reference.size() == 0) {
         result.mismatches = result.host_count;
         result.alignment_relative_to_reference = false;
         result.alignment_offset = 0;
@@ -108,69 +272,33 @@ StageComparisonResult compare_stage(const std::string& label,
 
     const bool host_is_longer = result.host_count >= result.ref_count;
     const std::size_t compare_len = host_is_longer ? result.ref_count : result.host_count;
-    if (compare_len == 0) {
-        return result;
-    }
-
     const std::size_t max_offset =
         host_is_longer ? (result.host_count - compare_len) : (result.ref_count - compare_len);
 
-    auto evaluate_alignment = [&](std::size_t host_start, std::size_t ref_start) {
-        std::size_t mismatches = 0;
-        std::optional<std::size_t> first_diff;
-        std::optional<long long> first_host;
-        std::optional<long long> first_ref;
+    auto host_at = [&](std::size_t idx) { return static_cast<long long>(host[idx]); };
+    auto ref_at = [&](std::size_t idx) { return static_cast<long long>(reference[idx]); };
+    const auto [best_offset, best_mismatches] =
+        host_is_longer ? detail::best_stage_alignment(host_at, ref_at, compare_len, max_offset)
+                       : detail::best_stage_alignment(ref_at, host_at, compare_len, max_offset);
+
+    result.mismatches = best_mismatches;
+    result.alignment_offset = best_offset;
+    result.alignment_relative_to_reference = !host_is_longer;
+    if (best_mismatches > 0) {
+        const std::size_t host_start = host_is_longer ? best_offset : 0;
+        const std::size_t ref_start = host_is_longer ? 0 : best_offset;
         for (std::size_t idx = 0; idx < compare_len; ++idx) {
-            const long long host_val = static_cast<long long>(host[host_start + idx]);
-            const long long ref_val = reference[ref_start + idx];
+            const long long host_val = host_at(host_start + idx);
+            const long long ref_val = ref_at(ref_start + idx);
             if (host_val != ref_val) {
-                ++mismatches;
-                if (!first_diff) {
-                    first_diff = idx;
-                    first_host = host_val;
-                    first_ref = ref_val;
-                }
-            }
-        }
-        return std::tuple<std::size_t,
-                          std::optional<std::size_t>,
-                          std::optional<long long>,
-                          std::optional<long long>>(mismatches, first_diff, first_host, first_ref);
-    };
-
-    std::size_t best_offset = 0;
-    std::size_t best_mismatches = std::numeric_limits<std::size_t>::max();
-    std::optional<std::size_t> best_first_diff;
-    std::optional<long long> best_host_value;
-    std::optional<long long> best_ref_value;
-
-    for (std::size_t offset = 0; offset <= max_offset; ++offset) {
-        const std::size_t host_start = host_is_longer ? offset : 0;
-        const std::size_t ref_start = host_is_longer ? 0 : offset;
-        auto [mism, first_diff, host_val, ref_val] = evaluate_alignment(host_start, ref_start);
-        if (mism < best_mismatches) {
-            best_mismatches = mism;
-            best_offset = offset;
-            best_first_diff = first_diff;
-            best_host_value = host_val;
-            best_ref_value = ref_val;
-            if (best_mismatches == 0) {
+                result.first_diff_index = idx;
+                result.host_value = host_val;
+                result.ref_value = ref_val;
                 break;
             }
         }
     }
 
-    result.mismatches = (best_mismatches == std::numeric_limits<std::size_t>::max())
-                            ? compare_len
-                            : best_mismatches;
-    result.alignment_offset = best_offset;
-    result.alignment_relative_to_reference = !host_is_longer;
-    if (best_first_diff) {
-        result.first_diff_index = best_first_diff;
-        result.host_value = best_host_value;
-        result.ref_value = best_ref_value;
-    }
-
     return result;
 }
 
@@ -226,6 +354,7 @@ struct SummaryReport
     double rt_min_deadline_margin_ns{0.0};
     std::size_t rt_overrun_count{0};
     std::size_t rt_underrun_count{0};
+    double rt_capacity{0.0};   // symbol period / bottleneck stage cost
     struct RealTimeEvent
     {
         std::size_t symbol_index{0};
@@ -245,6 +374,7 @@ struct SummaryReport
         std::size_t max_scratch_bytes{0};
     };
     std::vector<StageInstrumentationEntry> stage_instrumentation;
+    std::vector<std::pair<std::string, std::uint64_t>> trace_counters;   // --trace work counters
 };
 
 std::string build_stage_summary_token(const StageComparisonResult& result);
@@ -263,6 +393,10 @@ StageDiffReport build_stage_diff_report(const std::vector<StageComparisonResult>
 
 void write_summary_json(const std::filesystem::path& path, const SummaryReport& report);
 
+// Same document written to `out`, e.g. to embed one capture's summary
+// in a larger report.
+void write_summary_json(std::ostream& out, const SummaryReport& report);
+
 std::vector<StageComparisonResult> compare_with_reference(const StageOutputs& outputs,
                                                           const std::filesystem::path& compare_root);
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "host_sim/decode_phase.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace host_sim
+{
+
+struct ReceiverStats;
+
+/// Nearest-rank percentile `p` (0-100) of an unsorted sample; 0 when empty.
+double percentile(std::vector<double> values, double p);
+
+/// Fixed-bucket histogram of durations.  observe() is a few relaxed atomic
+/// adds, so decoder threads never block on it; readers see each bucket
+/// monotonically, not a consistent cut across buckets.
+class LatencyHistogram
+{
+public:
+    /// Upper bucket bounds, seconds; one more bucket catches the rest.
+    static constexpr std::array<double, 12> kBounds{0.001, 0.002, 0.005, 0.01, 0.02, 0.05,
+                                                     0.1,   0.2,   0.5,   1.0,  2.0,  5.0};
+    static constexpr std::size_t kBuckets = kBounds.size() + 1;
+
+    void observe(double seconds);
+
+    /// Observations in each bucket (not cumulative).
+    std::array<std::uint64_t, kBuckets> counts() const;
+    std::uint64_t count() const;
+    double sum() const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+    std::atomic<std::uint64_t> sum_ns_{0};
+};
+
+/// Live decode counters of a Receiver, updated lock-free by whichever
+/// thread decoded the packet.
+struct ReceiverMetrics
+{
+    static constexpr int kMinSf = 6;
+    static constexpr int kMaxSf = 12;
+    static constexpr std::size_t kSfCount = kMaxSf - kMinSf + 1;
+
+    std::atomic<std::uint64_t> packets{0};
+    std::atomic<std::uint64_t> headers_ok{0};
+    std::atomic<std::uint64_t> crc_ok{0};
+    std::atomic<std::uint64_t> crc_failed{0};       ///< CRC expected and wrong
+    std::atomic<std::uint64_t> payload_mismatches{0};
+    std::atomic<std::uint64_t> bit_errors{0};
+    std::atomic<std::uint64_t> payload_bits{0};
+    std::array<std::atomic<std::uint64_t>, lora_replay::kDecodePathCount> paths{};
+    std::array<std::atomic<std::uint64_t>, kDecodePhaseCount> phase_ns{};   ///< Wall time on receiver threads
+    std::atomic<std::uint64_t> decode_cpu_ns{0};    ///< Thread CPU time spent decoding bursts
+    std::array<std::atomic<std::uint64_t>, kSfCount> sf_packets{};
+    std::array<std::atomic<std::uint64_t>, kSfCount> sf_decode_ns{};
+    LatencyHistogram decode_latency;
+    /// Decode latency by the deepest effort tier the decode reached,
+    /// recovery re-decodes included.
+    std::array<LatencyHistogram, lora_replay::kDecodeEffortCount> effort_latency;
+    std::atomic<std::uint64_t> budget_exhausted{0};     ///< Decodes cut short by the budget
+    std::atomic<std::uint64_t> recoveries_queued{0};
+    std::atomic<std::uint64_t> recoveries_dropped{0};   ///< Recovery queue full
+    std::atomic<std::uint64_t> recoveries_ok{0};        ///< Re-decodes that came out clean
+    std::atomic<std::uint64_t> collision_packets{0};    ///< Found after cancelling another packet
+
+    /// Fold one decoded packet in.
+    void record_packet(int sf, const lora_replay::StreamDecodeResult& result, double decode_ms);
+    void add_phases(const PhaseTimes& times);
+};
+
+/// State of the stream around the receiver, sampled by its driver.
+struct StreamGauges
+{
+    double uptime_s{0.0};               ///< Wall time since the stream started
+    double stream_s{0.0};               ///< Input consumed, in stream time
+    double packets_per_s{0.0};          ///< Over the last snapshot interval
+    std::size_t reader_buffered{0};     ///< Samples waiting in the reader ring
+    std::size_t reader_capacity{0};
+    std::uint64_t reader_overflows{0};
+    std::uint64_t reader_dropped_samples{0};
+    std::uint64_t source_overflows{0};      ///< Flagged by the radio or socket
+    std::uint64_t source_lost_samples{0};   ///< Lost before the reader
+};
+
+/// Prometheus text exposition of @p metrics, @p stats and @p gauges.
+/// Counters are `host_sim_*_total`; the decode latency is a histogram in
+/// seconds; `host_sim_realtime_lag_seconds` grows while the node falls
+/// behind its input.
+std::string format_prometheus(const ReceiverMetrics& metrics, const ReceiverStats& stats,
+                              const StreamGauges& gauges);
+
+/// Replace @p path with @p text atomically (write a sibling, then rename),
+/// so a collector polling the file never reads half a snapshot.
+void write_metrics_file(const std::filesystem::path& path, const std::string& text);
+
+} // namespace host_sim
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "host_sim/bounded_queue.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace host_sim
+{
+
+struct ReceivedPacket;
+
+/// One decoded packet as the stream front-end reports it.
+struct PacketRecord
+{
+    std::uint64_t index{0};             ///< Packet number in stream order
+    std::uint64_t start_sample{0};      ///< Capture-rate sample the decode started at
+    std::uint64_t length{0};            ///< Capture-rate samples to the burst end
+    double time_s{0.0};                 ///< start_sample in seconds
+    double duration_s{0.0};             ///< length in seconds
+    int sf{0};
+    int cr{0};                          ///< From the header (0 without one)
+    float snr_db{0.0f};
+    float cfo_hz{0.0f};
+    double decode_ms{0.0};
+    bool header_ok{false};
+    bool crc_expected{false};
+    bool crc_ok{false};
+    bool payload_mismatch{false};
+    lora_replay::DecodePath path{lora_replay::DecodePath::none};
+    lora_replay::DecodeEffort effort{lora_replay::DecodeEffort::fast};  ///< Deepest tier reached
+    bool budget_exhausted{false};       ///< Escalation stopped at the decode budget
+    bool recovered{false};              ///< Deferred re-decode (ReceivedPacket::recovered)
+    std::optional<std::int64_t> source_time_ns;   ///< Source timestamp of start_sample (timed sources)
+    std::vector<std::uint8_t> payload;  ///< Dewhitened payload bytes
+    std::string report;                 ///< Decoder log; only the text format prints it
+};
+
+/// Record for @p pkt, converting positions by @p sample_scale (decimation
+/// factor) and @p sample_rate (capture rate).
+PacketRecord make_packet_record(ReceivedPacket pkt, std::uint64_t index, std::size_t sample_scale,
+                                int sample_rate);
+
+enum class PacketFormat
+{
+    text,       ///< The human-readable report lora_replay has always printed
+    ndjson,     ///< One JSON object per line
+    binary,     ///< Length-prefixed little-endian records (see append_binary_record)
+};
+
+/// Append @p record to @p out as the text report or as one NDJSON line.
+/// `show_sf` adds the SF to the text burst line (multi-SF runs).
+void append_text_record(const PacketRecord& record, bool show_sf, std::string& out);
+void append_ndjson_record(const PacketRecord& record, std::string& out);
+
+/// Binary layout, little-endian, version 2:
+///
+///     u32 size        bytes after this field
+///     u8  version     2
+///     u8  flags       bit 0 header_ok, 1 crc_expected, 2 crc_ok, 3 payload_mismatch,
+///                     4 source_time_ns valid, 5 budget_exhausted, 6 recovered
+///     u8  sf, cr, path (lora_replay::DecodePath)
+///     u8  effort (lora_replay::DecodeEffort)
+///     u8  reserved[2]
+///     u64 index, start_sample, length
+///     f64 time_s
+///     f32 snr_db, cfo_hz, decode_ms
+///     u16 payload length n, then n payload bytes
+///     i64 source_time_ns                              (version 2)
+///
+/// Later versions only append fields, so a reader takes the ones it
+/// knows and steps `size` bytes to the next record.
+void append_binary_record(const PacketRecord& record, std::string& out);
+
+/// Parse the record at the front of @p data into @p out.  Returns the
+/// bytes it took, or 0 when @p data does not hold a whole record yet.
+/// Throws std::runtime_error on a malformed record.
+std::size_t parse_binary_record(std::span<const std::uint8_t> data, PacketRecord& out);
+
+struct PacketSinkConfig
+{
+    PacketFormat format{PacketFormat::text};
+    bool show_sf{false};                ///< Text format: print the SF of each packet
+    std::size_t queue_capacity{256};    ///< Records in flight before write() blocks
+    std::size_t max_batch{64};          ///< Records formatted per write and flush
+};
+
+/// Formats and writes packet records on a thread of its own, so the
+/// stream loop only moves a record into a queue.  The writer takes every
+/// record already queued (up to max_batch), formats them into one buffer
+/// and issues a single write and flush per batch; an idle stream still
+/// sees each packet as soon as it is decoded.
+class PacketSink
+{
+public:
+    PacketSink(std::ostream& out, PacketSinkConfig config);
+    ~PacketSink();
+
+    PacketSink(const PacketSink&) = delete;
+    PacketSink& operator=(const PacketSink&) = delete;
+
+    /// Queue @p record, waiting while the queue is full.
+    void write(PacketRecord record);
+
+    /// Write what is queued and stop the writer.  Throws
+    /// std::runtime_error if the output failed.  Idempotent.
+    void close();
+
+    /// Records written so far.
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    void writer_main();
+
+    std::ostream& out_;
+    const PacketSinkConfig config_;
+    BoundedQueue<PacketRecord> queue_;
+    std::atomic<std::uint64_t> written_{0};
+    std::exception_ptr error_;
+    std::thread writer_;
+};
+
+} // namespace host_sim
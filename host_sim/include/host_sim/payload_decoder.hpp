@@ -0,0 +1,92 @@
+#pragma once
+
+#include "host_sim/deinterleaver.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace host_sim
+{
+
+struct PayloadDecoderConfig
+{
+    int sf{7};
+    int cr{1};                      ///< Payload coding rate 1..4 (4/5..4/8)
+    bool ldro{false};
+    int payload_len{0};             ///< Bytes, 1..255
+    bool has_crc{true};
+    /// Give up once more than this many codewords, and more than a third
+    /// of those decoded so far, carry an error Hamming flags but cannot
+    /// correct (see hamming_uncorrectable()); -1 = never.
+    int max_uncorrectable{-1};
+};
+
+/// Incremental LoRa payload decoder: takes one interleaver block at a time
+/// as the symbols arrive, Hamming-decodes it and packs bytes, then
+/// dewhitens the block's bytes and folds them into the CRC-16 in one fused
+/// pass, so the CRC verdict is ready the moment the last CRC byte is.
+/// Holds everything in fixed buffers; nothing is allocated after
+/// construction.
+///
+/// With `max_uncorrectable >= 0` a candidate whose blocks keep failing
+/// their check bits is abandoned early: CRC sweeps over timing/CFO
+/// candidates stop decoding a hopeless one after a few blocks instead of
+/// running it to the end.
+class PayloadDecoder
+{
+public:
+    explicit PayloadDecoder(const PayloadDecoderConfig& config);
+
+    /// Symbols per payload block (cr + 4).
+    std::size_t block_symbols() const { return static_cast<std::size_t>(config_.cr) + 4; }
+
+    /// Append already-decoded nibbles: the payload nibbles an SF > 6
+    /// header block carries past its five header fields, or the output of
+    /// a soft-decision block decoder.
+    void push_nibbles(const uint8_t* nibbles, std::size_t count);
+
+    /// Hard-decode the block starting at @p symbols (@p count available).
+    /// Returns the symbols consumed: block_symbols(), or 0 when fewer are
+    /// available or the decode is complete or aborted.
+    std::size_t push_block(const uint16_t* symbols, std::size_t count);
+
+    /// Every payload byte (and both CRC bytes, with a CRC) is in.
+    bool complete() const { return size_ >= target_; }
+    /// Stopped by `max_uncorrectable`.
+    bool aborted() const { return aborted_; }
+    bool needs_more() const { return !complete() && !aborted_; }
+    std::size_t uncorrectable_codewords() const { return uncorrectable_; }
+
+    /// Dewhitened payload bytes followed by the CRC bytes as received, as
+    /// far as decoded (at most payload_len + 2).
+    std::span<const uint8_t> bytes() const { return {bytes_.data(), size_}; }
+
+    /// Complete, with a CRC and payload_len >= 2: the CRC fields are set.
+    bool crc_checked() const;
+    bool crc_ok() const { return crc_checked() && crc_computed() == crc_received(); }
+    /// gr-lora_sdr convention: CRC-16 of the first payload_len - 2 bytes
+    /// XORed with the last two payload bytes (MSB, LSB).
+    uint16_t crc_computed() const;
+    /// The two CRC bytes after the payload, little-endian.
+    uint16_t crc_received() const;
+
+private:
+    void push_nibble(uint8_t nibble);
+    /// Dewhiten bytes [from, size_) and fold the CRC-covered ones into crc_.
+    void settle(std::size_t from);
+
+    PayloadDecoderConfig config_;
+    DeinterleaverConfig block_cfg_;
+    std::size_t target_{0};
+    std::array<uint8_t, 257> bytes_{};
+    std::size_t size_{0};
+    int pending_nibble_{-1};
+    uint16_t crc_{0};
+    std::size_t codewords_{0};
+    std::size_t uncorrectable_{0};
+    bool aborted_{false};
+};
+
+} // namespace host_sim
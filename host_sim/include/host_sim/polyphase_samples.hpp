@@ -0,0 +1,60 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace host_sim
+{
+
+/// A burst split once into its `os` polyphase planes, each stored as
+/// separate real and imaginary arrays (structure of arrays).
+///
+/// The single-tap demodulator reads samples start + base_tap + k·os, i.e.
+/// every os-th sample of one plane.  On the interleaved burst that is a
+/// strided gather per chip; here the same taps are two contiguous float
+/// runs, so every re-demodulation pass over the burst (grid, SFD re-demod,
+/// SFO sweeps) streams them with plain vector loads.  The split costs one
+/// pass over the burst and 8 bytes per sample.
+///
+/// The interleaved source is kept by reference for the paths that still
+/// need it; it must outlive this object.  The planes are allocated from
+/// @p memory (a decoder's per-packet arena).
+class PolyphaseSamples
+{
+public:
+    PolyphaseSamples(std::span<const std::complex<float>> samples,
+                     int oversample_factor,
+                     std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    int oversample_factor() const { return os_; }
+    std::size_t size() const { return samples_.size(); }
+    std::span<const std::complex<float>> interleaved() const { return samples_; }
+
+    /// Real / imaginary parts of samples index, index + os, index + 2·os, …
+    const float* real_from(std::size_t index) const { return re_.data() + offset(index); }
+    const float* imag_from(std::size_t index) const { return im_.data() + offset(index); }
+
+    /// Number of samples real_from(index) can read.
+    std::size_t run_length(std::size_t index) const
+    {
+        return index < samples_.size() ? (samples_.size() - index - 1) / static_cast<std::size_t>(os_) + 1 : 0;
+    }
+
+private:
+    std::size_t offset(std::size_t index) const
+    {
+        const auto os = static_cast<std::size_t>(os_);
+        return plane_start_[index % os] + index / os;
+    }
+
+    std::span<const std::complex<float>> samples_;
+    int os_;
+    std::pmr::vector<std::size_t> plane_start_;   ///< Offset of plane p in re_/im_
+    std::pmr::vector<float> re_;
+    std::pmr::vector<float> im_;
+};
+
+} // namespace host_sim
@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <complex>
+#include <cstddef>
 #include <cstdint>
 
 namespace host_sim
@@ -74,5 +76,65 @@ inline Q15Complex q15_mul(const Q15Complex& a, const Q15Complex& b)
     return {saturate_q15(real), saturate_q15(imag)};
 }
 
+// ── Block floating point ──
+
+/// Block-floating-point exponent of a Q15 block: the shift (-1..14) that
+/// brings its largest |component| to just under 2^14, one bit below full
+/// scale so the complex multiplies of the dechirp cannot saturate.  An
+/// all-zero block gets 0.
+inline int block_exponent_q15(const Q15Complex* samples, std::size_t count)
+{
+    int32_t peak = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        peak = std::max(peak, std::max(std::abs(static_cast<int32_t>(samples[i].real)),
+                                       std::abs(static_cast<int32_t>(samples[i].imag))));
+    }
+    if (peak == 0) {
+        return 0;
+    }
+    if (peak >= (1 << 14)) {
+        return -1;
+    }
+    int shift = 0;
+    while ((peak << (shift + 1)) < (1 << 14)) {
+        ++shift;
+    }
+    return shift;
+}
+
+/// out = samples · 2^exponent (arithmetic shift; in == out is fine).
+inline void scale_block_q15(const Q15Complex* samples, std::size_t count, int exponent, Q15Complex* out)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const int32_t re = samples[i].real;
+        const int32_t im = samples[i].imag;
+        out[i] = exponent >= 0 ? Q15Complex{saturate_q15(re << exponent), saturate_q15(im << exponent)}
+                               : Q15Complex{static_cast<int16_t>(re >> -exponent),
+                                            static_cast<int16_t>(im >> -exponent)};
+    }
+}
+
+/// Quantise a float block to Q15 with one power-of-two gain for the whole
+/// block, chosen like block_exponent_q15() (largest |component| in
+/// [0.25, 0.5)).  Returns the exponent: out = samples · 2^exponent.
+inline int quantise_block_q15(const std::complex<float>* samples, std::size_t count, Q15Complex* out)
+{
+    float peak = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        peak = std::max(peak, std::max(std::abs(samples[i].real()), std::abs(samples[i].imag())));
+    }
+    int exponent = 0;
+    if (peak > 0.0f) {
+        std::frexp(peak, &exponent);   // peak = f · 2^exponent, f in [0.5, 1)
+        exponent = -exponent - 1;
+    }
+    const float gain = std::ldexp(static_cast<float>(kQ15Scale), exponent);
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = {saturate_q15(static_cast<int32_t>(std::lrint(samples[i].real() * gain))),
+                  saturate_q15(static_cast<int32_t>(std::lrint(samples[i].imag() * gain)))};
+    }
+    return exponent;
+}
+
 } // namespace host_sim
 
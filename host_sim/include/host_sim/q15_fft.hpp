@@ -0,0 +1,48 @@
+#pragma once
+
+#include "host_sim/q15.hpp"
+
+#include <cstddef>
+
+// Forward-declare the opaque KissFFT Q15 config.
+struct kiss_fft_state;
+typedef struct kiss_fft_state* kiss_fft_q15_cfg;
+
+namespace host_sim
+{
+
+/// One Q15 KissFFT configuration per size, shared by every Q15 FFT:
+/// out-of-place kiss_fft_q15 only reads it, so sharing is reentrant.
+/// Never freed.
+kiss_fft_q15_cfg shared_q15_plan(int nfft);
+
+/// Forward Q15 FFT of one power-of-two size, scaled by 1/N.
+///
+/// KissFFT (FIXED_POINT=16) by default; arm_cfft_q15 when the library is
+/// built with HOST_SIM_WITH_CMSIS_DSP, whose constant twiddle tables
+/// cover 16 .. 4096 points.  Copyable and stateless apart from the shared
+/// plan, so one object may serve any number of threads.
+class Q15Fft
+{
+public:
+    explicit Q15Fft(int nfft);
+
+    /// `out` = FFT(`in`) / N.  `in` and `out` may not alias.
+    void forward(const Q15Complex* in, Q15Complex* out) const;
+
+    int size() const { return nfft_; }
+
+    /// "kissfft" or "cmsis-dsp".
+    static const char* backend_name();
+
+private:
+    int nfft_;
+    const void* plan_{nullptr};   ///< kiss_fft_state or arm_cfft_instance_q15
+};
+
+/// out[k] = q15_mul(a[k], b[k]) for k < n.  `out` may alias `a` or `b`.
+/// With CMSIS-DSP this is arm_cmplx_mult_cmplx_q15 (3.13 output) shifted
+/// back to 1.15, which drops the two low bits the scalar path keeps.
+void q15_cmplx_mult(const Q15Complex* a, const Q15Complex* b, Q15Complex* out, std::size_t n);
+
+} // namespace host_sim
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/chirp.hpp"
+#include "host_sim/fft_demod_q15.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/q15.hpp"
+#include "host_sim/q15_fft.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace host_sim
+{
+
+// ── Work accounting ──
+
+/// Work done by the fixed-point chain, by operation class, for MCU cycle
+/// estimates.
+struct Q15OpCounts
+{
+    uint64_t detect_samples{0};     ///< |x|² accumulations of the power envelope
+    uint64_t agc_samples{0};        ///< Samples scanned and shifted by the block AGC
+    uint64_t complex_macs{0};       ///< Q15 complex multiplies (dechirp, fold, derotation)
+    uint64_t ffts{0};
+    uint64_t fft_butterflies{0};    ///< Radix-2 equivalent: N/2 · log2 N per FFT
+    uint64_t peak_bins{0};          ///< |X|² bins evaluated by peak searches
+    uint64_t cordic_steps{0};
+
+    Q15OpCounts& operator+=(const Q15OpCounts& other);
+};
+
+// ── Integer burst detection ──
+
+/// Burst start found by detect_burst_q15().  Powers are mean |x|² per
+/// sample of Q15 components, i.e. in units of 2^-30.
+struct Q15BurstStart
+{
+    std::size_t burst_start{0};
+    uint32_t noise_floor{0};
+    uint32_t signal_power{0};
+};
+
+/// detect_burst_ex() on Q15 samples with integer arithmetic only: window
+/// powers summed in 64 bits, the noise floor the mean of the lowest
+/// quartile of windows, and an integer threshold factor.  Same decision
+/// rule, window grid and two-window back-off.  The envelope's work is
+/// added to @p ops when given.
+std::optional<Q15BurstStart> detect_burst_q15(const Q15Complex* samples,
+                                              std::size_t n_samples,
+                                              int samples_per_symbol,
+                                              uint32_t threshold_factor = 6,
+                                              std::size_t search_from = 0,
+                                              int min_consec = 1,
+                                              Q15OpCounts* ops = nullptr);
+
+// ── Integer phase ──
+
+/// atan2(y, x) in Q15 turns (-0.5 .. 0.5 turn ↦ -32768 .. 32767) by a
+/// 16-step CORDIC; (0, 0) gives 0.
+int16_t atan2_q15_turns(int64_t y, int64_t x);
+
+// ── Fixed-point receive chain ──
+
+/// Per-operation cycle costs of one MCU core.  The figures are estimates
+/// for the Q15 kernels as CMSIS-DSP style code would run them, meant for
+/// comparing budgets, not cycle-accurate.
+struct McuCostModel
+{
+    std::string name;
+    double freq_mhz{0.0};
+    double detect_sample{0.0};
+    double agc_sample{0.0};
+    double complex_mac{0.0};
+    double fft_butterfly{0.0};
+    double peak_bin{0.0};
+    double cordic_step{0.0};
+};
+
+/// Cortex-M0+, Cortex-M4F and Cortex-M7 at typical LoRa-node clocks.
+std::span<const McuCostModel> mcu_cost_models();
+
+/// Cycle estimate of one burst on one core, in the terms of
+/// lora_replay's SummaryReport::McuCycleSummary.
+struct McuCycleEstimate
+{
+    std::string name;
+    double freq_mhz{0.0};
+    double cycles{0.0};                     ///< Whole burst
+    double cycles_per_symbol{0.0};          ///< cycles / burst symbol periods
+    double cycles_per_symbol_budget{0.0};   ///< Core cycles in one symbol period
+    double utilisation{0.0};                ///< > 1: slower than real time
+};
+
+/// Cost of `ops` on `model` for a burst spanning `symbols` symbol periods
+/// of `symbol_period_s` seconds each.
+McuCycleEstimate estimate_mcu_cycles(const Q15OpCounts& ops,
+                                     std::size_t symbols,
+                                     double symbol_period_s,
+                                     const McuCostModel& model);
+
+/// Outcome of Q15Receiver::decode().
+struct Q15DecodeResult
+{
+    bool header_ok{false};
+    bool crc_ok{false};
+    int payload_len{0};
+    int cr{0};
+    std::vector<uint8_t> payload;   ///< Dewhitened payload bytes
+    std::size_t alignment_offset{0};
+    int cfo_int{0};
+    int16_t cfo_frac_q15{0};        ///< Fractional CFO, bins · 2^15 (-0.5 .. 0.5)
+    int agc_exponent{0};            ///< Block AGC shift applied to the burst
+    std::size_t burst_symbols{0};   ///< Symbol periods the burst spans
+};
+
+/// Fixed-point LoRa receive chain for MCU targets.
+///
+/// Everything between the Q15 samples and the symbols is integer: a
+/// block-floating-point AGC shifts the burst to one bit below full scale,
+/// the CFO-aware alignment scan (the same coarse/fine search as
+/// find_symbol_alignment_cfo_aware(), run serially) dechirps with
+/// ChirpTablesQ15 and takes Q15 FFTs, and the CFO estimate accumulates
+/// preamble power and phase in 64-bit integers with a CORDIC for the
+/// fractional part.  Symbols come from FftDemodulatorQ15; the header and
+/// payload go through the shared allocation-free decoders.  No SFO
+/// estimate and no OS=2 fallback: the chain targets what a node would
+/// run, not every recovery path of decode_stream_burst().  Explicit
+/// headers only.
+///
+/// Buffers are sized at construction (and by the longest burst seen);
+/// ops() counts the work of the last decode() for estimate_mcu_cycles().
+class Q15Receiver
+{
+public:
+    Q15Receiver(int sf, int sample_rate, int bandwidth);
+
+    Q15Receiver(const Q15Receiver&) = delete;
+    Q15Receiver& operator=(const Q15Receiver&) = delete;
+
+    /// Block AGC plus the three acquisition steps below, then header and
+    /// payload.  `burst` should start shortly before the preamble, as
+    /// detect_burst_q15() leaves it.
+    Q15DecodeResult decode(std::span<const Q15Complex> burst, const LoRaMetadata& meta);
+
+    /// CFO-aware alignment of (already scaled) samples.
+    PreambleSearchResult align(std::span<const Q15Complex> samples, int preamble_symbols);
+
+    struct FrequencyEstimate
+    {
+        int cfo_int{0};
+        int16_t cfo_frac_q15{0};
+    };
+    /// Integer CFO from `symbol_count` preamble symbols at `samples`.
+    FrequencyEstimate estimate_frequency_offsets(const Q15Complex* samples, int symbol_count);
+
+    const Q15OpCounts& ops() const { return ops_; }
+    int samples_per_symbol() const { return sps_; }
+
+private:
+    /// Fold `samples` (N·os values) against the downchirp into fft_in_,
+    /// every `fold_stride`-th tap, and FFT it into `out`.
+    void dechirp_fft(const Q15Complex* samples, int fold_stride, Q15Complex* out);
+
+    int sf_;
+    int n_bins_;
+    int os_;
+    int sps_;
+    std::shared_ptr<const ChirpTablesQ15> chirps_;
+    Q15Fft fft_;
+    FftDemodulatorQ15 demod_;
+    Q15OpCounts ops_;
+
+    std::vector<Q15Complex> scaled_;
+    std::vector<Q15Complex> fft_in_;
+    std::vector<Q15Complex> fft_out_;
+    std::vector<Q15Complex> spectra_;
+    std::vector<int64_t> mag_per_bin_;
+    std::vector<int> peaks_;
+    std::vector<uint16_t> symbols_;
+};
+
+} // namespace host_sim
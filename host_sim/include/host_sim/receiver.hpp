@@ -0,0 +1,243 @@
+#pragma once
+
+#include "host_sim/burst_detector.hpp"
+#include "host_sim/decode_arena.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/metrics.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace host_sim
+{
+
+/// What a Receiver listens for and how it decodes.
+struct ReceiverConfig
+{
+    LoRaMetadata metadata;          ///< Stream parameters; `sf` is ignored with multi_sf
+    bool multi_sf{false};           ///< Listen on SF6–SF12 at once
+    bool soft{false};               ///< Soft-decision Hamming decoding
+    float cfo_track_alpha{0.0f};    ///< Per-symbol CFO tracking EMA (0 = off)
+    std::string expected_payload;   ///< When set, packets are checked byte-exact and for BER
+    std::size_t decoder_threads{0}; ///< 0 = decode on the thread calling push()/finish()
+    std::size_t chunk_samples{0};   ///< Samples per detection step; 0 = ~100 ms
+    bool drop_on_overflow{false};   ///< Drop bursts instead of blocking when decoders are busy
+    bool verbose{false};            ///< Detector and multi-SF probe traces on stderr
+    bool reports{true};             ///< Fill ReceivedPacket::report; off skips the log formatting
+    lora_replay::DecodeEffort effort{lora_replay::DecodeEffort::standard};  ///< Escalation tier
+    double decode_budget_ms{0.0};   ///< Per-packet escalation deadline; 0 = none
+    /// Re-decode packets that failed with escalation cut short (by the
+    /// tier or the budget) at exhaustive effort on a low-priority thread.
+    bool defer_recovery{false};
+    /// Decode each packet symbol by symbol as its samples arrive and hand
+    /// it out with its last symbol, instead of after the burst's quiet
+    /// tail; a packet that fails this way is decoded whole as before.
+    /// Single SF only; `chunk_samples` then defaults to one symbol.
+    bool incremental{false};
+    /// Collision mode: after a clean decode, subtract the packet's
+    /// re-synthesised waveform from the burst and decode what the residual
+    /// still holds, up to this many further packets per burst (0 = off).
+    /// Single SF only.
+    int cancel_collisions{0};
+};
+
+/// One packet recovered from the stream.
+struct ReceivedPacket
+{
+    std::uint64_t burst{0};         ///< Sequence number of the burst it was found in
+    std::size_t start{0};           ///< Stream sample index the decode started at
+    std::size_t length{0};          ///< Samples from `start` to the burst end
+    float snr_db{0.0f};             ///< Burst SNR from the power envelope (-99 when unknown)
+    int sf{0};
+    lora_replay::StreamDecodeResult result;
+    std::string report;             ///< Decoder log, as lora_replay prints it
+    double decode_ms{0.0};
+    /// A deferred re-decode of an earlier failed packet of the same burst.
+    /// It is pulled as soon as it decodes, after packets of later bursts.
+    bool recovered{false};
+    /// Decoded as it arrived (ReceiverConfig::incremental); `length` then
+    /// ends at the packet's last symbol.
+    bool incremental{false};
+    /// Found in the burst's residual after this many packets were
+    /// cancelled from it (ReceiverConfig::cancel_collisions); 0 otherwise.
+    int cancelled{0};
+};
+
+/// Per-SF work accounting (one entry per SF listened on).
+struct ReceiverSfStats
+{
+    int sf{0};
+    std::size_t preambles{0};       ///< Preamble runs long enough to decode
+    std::size_t packets{0};         ///< Of those, packets that decoded cleanly
+    double cpu_ms{0.0};             ///< Preamble scans plus decodes
+};
+
+struct ReceiverStats
+{
+    std::size_t decoders{0};
+    std::uint64_t bursts_queued{0};
+    std::uint64_t bursts_dropped{0};
+    std::uint64_t detector_stalls{0};
+    std::size_t queue_high_water{0};
+    std::size_t queue_capacity{0};
+    std::uint64_t incremental_packets{0};   ///< Packets decoded as they arrived
+    std::uint64_t incremental_fallbacks{0}; ///< Bursts the incremental decode left to a whole-burst one
+    std::vector<ReceiverSfStats> sf;
+};
+
+/// Streaming LoRa receiver: push samples in, pull decoded packets out.
+///
+/// push() appends to an internal buffer and runs one detection step per
+/// `chunk_samples` of input, however the input is sliced: the incremental
+/// BurstDetector finds a burst, waits for its quiet tail, and hands a copy
+/// of it to a decoder.  With `incremental` the detection thread instead
+/// decodes the burst symbol by symbol from its start and releases its
+/// samples with the packet's last symbol.
+/// Each decoder owns a demodulator bank (one FftDemodulator and one
+/// DecodeArena per SF) that is reused across bursts, so steady-state
+/// decoding allocates only the burst copy and the packets it returns.
+/// With `cancel_collisions` a decoder subtracts each packet it gets out of
+/// a burst and decodes the residual, so packets overlapping on the same SF
+/// are recovered too.
+/// Decoders finish out of order; pull() returns packets strictly in burst
+/// order, except the re-decodes of `defer_recovery`, which follow whenever
+/// the recovery thread gets them to decode.  With `decoder_threads == 0`
+/// decoding happens inside push() and finish(), which is what an
+/// embedding caller with its own threads wants.
+///
+/// A Receiver is driven by one thread; push(), finish() and pull() must not
+/// be called concurrently.
+class Receiver
+{
+public:
+    explicit Receiver(ReceiverConfig config);
+    ~Receiver();
+
+    Receiver(const Receiver&) = delete;
+    Receiver& operator=(const Receiver&) = delete;
+
+    /// Append samples at the receiver's sample rate.
+    void push(std::span<const std::complex<float>> samples);
+
+    /// End of input: decode what is still buffered and wait for every
+    /// decoder.  push() must not be called afterwards.
+    void finish();
+
+    /// Next decoded packet in stream order, if one is ready.  Once
+    /// finish() has run and every packet was pulled, rethrows the first
+    /// exception a decoder hit.
+    std::optional<ReceivedPacket> pull();
+
+    const ReceiverConfig& config() const { return config_; }
+
+    /// Samples per symbol of the largest SF listened on.
+    std::size_t max_samples_per_symbol() const;
+
+    std::size_t chunk_samples() const { return chunk_; }
+
+    /// Counters; the per-SF figures are complete once finish() returned.
+    ReceiverStats stats() const;
+
+    /// Live decode metrics, safe to read from any thread at any time.
+    const ReceiverMetrics& metrics() const { return metrics_; }
+
+private:
+    // One SF of a decoder's bank: its demodulator, the arena its decodes
+    // allocate scratch from (reset before each packet) plus the per-SF
+    // work accounting.
+    struct SfCtx
+    {
+        std::unique_ptr<FftDemodulator> demod;
+        std::unique_ptr<DecodeArena> arena;
+        int sps{0};
+        std::size_t preambles{0};
+        std::size_t packets{0};
+        double cpu_ms{0.0};
+    };
+    using Bank = std::vector<SfCtx>;
+    struct BurstJob;
+    struct Incremental;
+
+    /// SF6–SF12 with multi_sf, otherwise just the metadata's SF.
+    static Bank make_bank(const LoRaMetadata& meta, bool multi_sf);
+
+    /// One detection step; false once the input is exhausted.
+    bool step();
+
+    /// Drop @p n samples (rounded down to whole detector windows) from the
+    /// buffer head; returns the number dropped.
+    std::size_t compact(std::size_t n);
+
+    /// Start decoding the burst at buffer index @p start as it arrives.
+    void begin_incremental(std::size_t start, float snr_db);
+    /// Feed the incremental decode what has arrived; false once it gave
+    /// the burst up to the whole-burst path.
+    bool advance_incremental();
+
+    void submit(BurstJob& job, std::span<const std::complex<float>> burst);
+    void complete(std::uint64_t burst, std::vector<ReceivedPacket> packets);
+    void account(const std::vector<ReceivedPacket>& packets, double cpu_ms);
+    std::vector<ReceivedPacket> decode(const BurstJob& job, std::span<const std::complex<float>> burst,
+                                       Bank& bank) const;
+    std::vector<ReceivedPacket> decode_multi_sf(Bank& bank, std::span<const std::complex<float>> burst) const;
+    /// Collision mode: cancel the clean decodes of @p packets from a copy
+    /// of @p burst and append the packets the residual decodes to.
+    void decode_residual(const BurstJob& job, std::span<const std::complex<float>> burst, SfCtx& ctx,
+                         std::vector<ReceivedPacket>& packets) const;
+    void decoder_main(std::size_t index);
+
+    /// Queue the packets of @p burst that could still decode with more
+    /// effort for the recovery thread.
+    void defer(const BurstJob& job, std::span<const std::complex<float>> burst,
+               const std::vector<ReceivedPacket>& packets);
+    void recovery_main();
+
+    ReceiverConfig config_;
+    lora_replay::Options options_;      // decode_stream_burst() view of config_
+    std::vector<Bank> banks_;           // one per decoder (one when decoding inline)
+
+    std::size_t chunk_{0};
+    std::size_t window_{0};             // detector window: smallest SF's symbol
+    std::size_t min_accumulate_{0};
+    std::size_t capacity_{0};
+    std::vector<std::complex<float>> buffer_;
+    std::uint64_t buffer_origin_{0};    // stream index of buffer_[0]
+    std::size_t pending_{0};            // samples pushed since the last step
+    BurstDetector detector_;
+    std::size_t search_offset_{0};
+    float tracked_noise_floor_{0.0f};
+    bool eof_{false};
+    bool finished_{false};
+
+    struct Queue;
+    std::unique_ptr<Queue> queue_;
+    std::vector<std::thread> decoders_;
+    std::unique_ptr<Queue> recovery_queue_;
+    Bank recovery_bank_;
+    lora_replay::Options recovery_options_;
+    std::thread recovery_;
+    std::unique_ptr<Incremental> incremental_;
+    ReceiverStats counters_;
+    ReceiverMetrics metrics_;
+
+    mutable std::mutex mutex_;          // guards everything below
+    std::map<std::uint64_t, std::vector<ReceivedPacket>> completed_;   // decoded, not yet in order
+    std::deque<ReceivedPacket> ready_;
+    std::uint64_t next_burst_{0};
+    std::exception_ptr error_;
+};
+
+} // namespace host_sim
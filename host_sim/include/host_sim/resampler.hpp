@@ -0,0 +1,46 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <span>
+
+namespace host_sim
+{
+
+/// Fractional-delay resampler over one sample buffer: the cubic Lagrange
+/// interpolator of the Farrow structure, evaluated lazily at whatever
+/// positions are asked for.
+///
+/// A sample at position p = n + µ (0 ≤ µ < 1) comes from the four
+/// neighbours x[n-1] .. x[n+2] with weights that are cubics in µ; taps past
+/// either end repeat the edge sample.  Whole positions return the input
+/// unchanged.  Compared with linear interpolation the cubic keeps much more
+/// of the upper band, where an OS=1 chirp spends the ends of every symbol:
+/// at a half-sample delay a tone at a quarter of the sample rate comes
+/// through at 0.88 instead of 0.71.
+///
+/// Nothing is precomputed or allocated: a symbol window at a fractional
+/// start costs one 4-tap filter per output sample, so callers that only
+/// need a few windows of a long burst never resample the rest.
+class FarrowResampler
+{
+public:
+    /// @p input must outlive the resampler.
+    explicit FarrowResampler(std::span<const std::complex<float>> input);
+
+    /// Input samples; valid positions are [0, size() - 1].
+    std::size_t size() const { return input_.size(); }
+
+    /// Interpolated sample at @p position.
+    std::complex<float> at(double position) const;
+
+    /// Write @p count samples at positions start, start + 1, ... to @p out.
+    /// The fractional part is shared, so the filter weights are computed
+    /// once per window.
+    void window(double start, std::size_t count, std::complex<float>* out) const;
+
+private:
+    std::span<const std::complex<float>> input_;
+};
+
+} // namespace host_sim
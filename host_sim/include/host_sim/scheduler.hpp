@@ -3,7 +3,9 @@
 #include "host_sim/stage.hpp"
 #include "host_sim/symbol_source.hpp"
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -26,6 +28,74 @@ public:
         std::vector<std::size_t>* symbol_memory_bytes{nullptr};
     };
 
+    /// Real-time mode (run_realtime): symbols are released at the symbol
+    /// period, and with `pipelined` every stage runs on its own thread so
+    /// stage N of symbol k overlaps stage N-1 of symbol k+1.
+    struct RealTimeOptions
+    {
+        bool pipelined{true};
+        bool pace{true};                ///< false: release as fast as the source allows
+        double symbol_period_ns{0.0};   ///< 0 = 2^sf / bandwidth
+        std::size_t slots{8};           ///< Symbols in flight, preallocated
+        double underrun_tolerance{0.1}; ///< Late release tolerated, in symbol periods
+    };
+
+    /// Fixed-bin histogram over [-4T, +4T) in symbol periods; recording
+    /// never allocates.
+    struct PeriodHistogram
+    {
+        static constexpr std::size_t kBins = 64;
+        static constexpr double kRangePeriods = 4.0;
+
+        std::array<std::uint64_t, kBins> bins{};
+        std::uint64_t below{0};
+        std::uint64_t above{0};
+
+        void record(double periods);
+        /// Lower edge of bin @p i, in symbol periods.
+        static double bin_low(std::size_t i);
+    };
+
+    struct RealTimeEvent
+    {
+        std::size_t symbol_index{0};
+        double timestamp_ns{0.0};   ///< Since the run started
+        double delta_ns{0.0};       ///< How late
+    };
+
+    /// What run_realtime() measured.  A symbol's deadline is its release
+    /// plus `depth` periods (one per pipeline stage, one when serial):
+    /// finishing later is an overrun.  Reaching the first stage more than
+    /// the tolerance after its release is an underrun.
+    struct RealTimeStats
+    {
+        static constexpr std::size_t kMaxEvents = 32;
+
+        std::size_t symbols{0};
+        std::size_t depth{1};
+        double symbol_period_ns{0.0};
+        double wall_ns{0.0};
+        double sum_start_lag_ns{0.0};
+        double max_start_lag_ns{0.0};
+        double sum_margin_ns{0.0};
+        double min_margin_ns{0.0};
+        std::size_t overruns{0};
+        std::size_t underruns{0};
+        std::array<RealTimeEvent, kMaxEvents> overrun_events{};    ///< First min(overruns, kMaxEvents)
+        std::array<RealTimeEvent, kMaxEvents> underrun_events{};
+        PeriodHistogram margin;     ///< Deadline minus completion
+        PeriodHistogram start_lag;  ///< First-stage start minus release
+        std::vector<double> stage_busy_ns;  ///< Per stage, sized once per run
+        std::vector<double> stage_max_ns;
+
+        /// Stage with the largest average service time.
+        std::size_t bottleneck_stage() const;
+        /// Symbol period over the per-symbol cost that limits throughput
+        /// (the bottleneck stage when pipelined, all stages when serial):
+        /// above 1 the configuration keeps up with the air rate.
+        double capacity(bool pipelined) const;
+    };
+
     void configure(const Config& config);
 
     void attach_stage(std::shared_ptr<Stage> stage);
@@ -33,16 +103,19 @@ public:
 
     void reset();
     void run(SymbolSource& source);
+    const RealTimeStats& run_realtime(SymbolSource& source, const RealTimeOptions& options);
 
     const Config& config() const { return config_; }
 
     void set_instrumentation(Instrumentation instrumentation) { instrumentation_ = instrumentation; }
+    const RealTimeStats& realtime_stats() const { return realtime_stats_; }
 
 private:
     Config config_{};
     std::vector<std::shared_ptr<Stage>> stages_;
     std::size_t processed_symbols_{0};
     Instrumentation instrumentation_{};
+    RealTimeStats realtime_stats_{};
 };
 
 } // namespace host_sim
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#if !defined(HOST_SIM_SINGLE_THREADED)
+#include <mutex>
+#endif
+#include <utility>
+
+namespace host_sim
+{
+
+/// Build-once, share-forever cache of immutable values.
+///
+/// get() returns the value for @p key, calling @p make (which returns a
+/// std::shared_ptr<const Value>) the first time the key is seen; every
+/// later caller, on any thread, gets the same object.  Entries are never
+/// evicted, so holders can keep plain pointers into them as long as the
+/// cache itself lives (the process-wide instances live until exit).
+/// Building happens under the lock: concurrent first requests for a key
+/// build it once, and construction of distinct keys is serialised, which
+/// is fine for start-up-time tables.  HOST_SIM_SINGLE_THREADED (the
+/// bare-metal builds in host_sim/mcu, whose libstdc++ has no std::mutex)
+/// drops the lock.
+template <typename Key, typename Value>
+class SharedCache
+{
+public:
+    template <typename Make>
+    std::shared_ptr<const Value> get(const Key& key, Make&& make)
+    {
+        Lock lock(mutex_);
+        auto& entry = entries_[key];
+        if (!entry) {
+            entry = std::forward<Make>(make)();
+        }
+        return entry;
+    }
+
+    std::size_t size() const
+    {
+        Lock lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+#if defined(HOST_SIM_SINGLE_THREADED)
+    struct Mutex
+    {
+    };
+    struct Lock
+    {
+        explicit Lock(Mutex&) {}
+    };
+#else
+    using Mutex = std::mutex;
+    using Lock = std::lock_guard<std::mutex>;
+#endif
+    mutable Mutex mutex_;
+    std::map<Key, std::shared_ptr<const Value>> entries_;
+};
+
+} // namespace host_sim
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -28,10 +30,52 @@ std::vector<std::vector<float>> deinterleave_soft(
 // data nibble by scoring all 16 possible codewords.
 uint8_t hamming_decode_soft(const std::vector<float>& cw_llrs, int cr_app);
 
+// Same decision from a fixed-size array of cr_app+4 LLRs: all 16
+// correlations are accumulated together against a ±1 codebook.
+uint8_t hamming_decode_soft(const float* cw_llrs, int cr_app);
+
 // Convenience: soft-decode a block of symbols, returning nibbles.
 std::vector<uint8_t> soft_decode_block(
     const std::vector<SymbolLLR>& symbol_llrs,
     int sf, int cr, bool is_header, bool ldro,
     std::size_t& consumed);
 
+// ── Fixed-size soft pipeline ──
+//
+// Same decisions as the vector API above, but every value lives in
+// fixed-size arrays the caller owns, so decoding a packet allocates
+// nothing beyond the caller's own symbol storage.
+
+constexpr std::size_t kMaxSoftBits = 12;       // sf_app <= 12
+constexpr std::size_t kMaxSoftCodewordBits = 8;  // cw_len <= 8
+
+// One symbol's LLRs; the first sf_app entries are valid.
+using SoftSymbol = std::array<float, kMaxSoftBits>;
+// One deinterleaved codeword's LLRs; the first cw_len entries are valid.
+using SoftCodeword = std::array<float, kMaxSoftCodewordBits>;
+
+// Write sf_app LLRs for one symbol to `llrs`, reading each of the 2^sf
+// magnitudes once (e.g. straight from get_fft_magnitudes_sq()).  The
+// bins are folded into gray order once, then a max-pyramid resolves
+// every bit: gray bit b is constant over aligned runs of 2^b values, so
+// bit b costs N / 2^b comparisons instead of N.  Bit-identical to
+// compute_symbol_llrs().
+void compute_symbol_llrs(const float* fft_mag_sq, int sf,
+                         bool is_header_or_ldro, int cfo_int, float* llrs);
+
+SoftSymbol compute_soft_symbol(const float* fft_mag_sq, int sf,
+                               bool is_header_or_ldro, int cfo_int = 0);
+
+// Soft deinterleave of one block: reads cw_len symbols (count must be at
+// least that), writes sf_app codewords, returns sf_app.
+std::size_t deinterleave_soft(const SoftSymbol* symbols, std::size_t count,
+                              int sf, int cr, bool is_header, bool ldro,
+                              SoftCodeword* codewords);
+
+// Soft-decode one block into `nibbles` (room for kMaxSoftBits); returns
+// the nibble count and sets `consumed` to cw_len.
+std::size_t soft_decode_block(const SoftSymbol* symbols, std::size_t count,
+                              int sf, int cr, bool is_header, bool ldro,
+                              uint8_t* nibbles, std::size_t& consumed);
+
 } // namespace host_sim
@@ -30,7 +30,6 @@ public:
         current_scale_ = 1.0f;
         if constexpr (Traits::is_fixed_point) {
             quantised_buffer_.clear();
-            float_buffer_.clear();
         }
     }
 
@@ -41,23 +40,29 @@ public:
         }
 
         if constexpr (Traits::is_fixed_point) {
-            quantised_buffer_.resize(context.samples.size());
-            float_buffer_.resize(context.samples.size());
-            float max_component = 0.0f;
-            for (const auto& sample : context.samples) {
-                max_component = std::max(max_component, std::max(std::abs(sample.real()), std::abs(sample.imag())));
-            }
-            current_scale_ = 1.0f;
-            if (max_component > 1.0f) {
-                current_scale_ = 1.0f / max_component;
-            }
-            for (std::size_t i = 0; i < context.samples.size(); ++i) {
-                const auto scaled = context.samples[i] * current_scale_;
-                quantised_buffer_[i] = Traits::to_complex(scaled);
-                float_buffer_[i] = scaled;
+            if (!context.samples_q15.empty()) {
+                // Native Q15 input is already in range: no scan, no copy.
+                current_scale_ = 1.0f;
+                demod_->set_input_scale(current_scale_);
+                context.demod_symbol = demod_->demodulate(context.samples_q15.data());
+                context.has_demod_symbol = true;
+                return;
             }
+            // Block floating point: one power-of-two gain per symbol,
+            // applied while quantising, so the float input is read once.
+            quantised_buffer_.resize(context.samples.size());
+            const int exponent =
+                quantise_block_q15(context.samples.data(), context.samples.size(), quantised_buffer_.data());
+            current_scale_ = std::ldexp(1.0f, exponent);
             demod_->set_input_scale(current_scale_);
             context.demod_symbol = demod_->demodulate(quantised_buffer_.data());
+        } else if (context.samples.empty() && !context.samples_q15.empty()) {
+            float_buffer_.resize(context.samples_q15.size());
+            for (std::size_t i = 0; i < context.samples_q15.size(); ++i) {
+                float_buffer_[i] = {q15_to_float(context.samples_q15[i].real),
+                                    q15_to_float(context.samples_q15[i].imag)};
+            }
+            context.demod_symbol = demod_->demodulate(float_buffer_.data());
         } else {
             context.demod_symbol = demod_->demodulate(context.samples.data());
         }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "host_sim/q15.hpp"
+
 #include <complex>
 #include <cstdint>
 #include <cstddef>
@@ -12,6 +14,7 @@ struct SymbolContext
 {
     std::size_t symbol_index{0};
     std::span<const std::complex<float>> samples;
+    std::span<const Q15Complex> samples_q15;  ///< Set when the source is native Q15
     uint16_t demod_symbol{0};
     bool has_demod_symbol{false};
     double stage_elapsed_ns{0.0};
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "host_sim/q15.hpp"
+
 #include <complex>
+#include <cstddef>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace host_sim
@@ -10,6 +14,16 @@ namespace host_sim
 struct SymbolBuffer
 {
     std::vector<std::complex<float>> samples;
+    /// Native Q15 samples.  Sources fed from integer captures fill this
+    /// instead of `samples`, and fixed-point stages consume it directly.
+    std::vector<Q15Complex> samples_q15;
+};
+
+/// Borrowed view of one symbol; either lane may be empty, as in SymbolBuffer.
+struct SymbolView
+{
+    std::span<const std::complex<float>> samples;
+    std::span<const Q15Complex> samples_q15;
 };
 
 class SymbolSource
@@ -19,6 +33,54 @@ public:
 
     virtual void reset() = 0;
     virtual std::optional<SymbolBuffer> next_symbol() = 0;
+
+    /// Lend the next symbol without handing over ownership.  The view is
+    /// valid until the next next_view() or reset() call, or for the whole
+    /// run when views_persist().  The default keeps next_symbol()'s buffer
+    /// and lends that, so sources that only implement next_symbol() still
+    /// work (and still allocate per symbol); sources that can lend storage
+    /// they already hold override this and allocate nothing.
+    virtual std::optional<SymbolView> next_view();
+
+    /// True when lent views stay valid until the source is destroyed, so a
+    /// consumer may hold several at once (the pipelined scheduler does).
+    virtual bool views_persist() const { return false; }
+
+private:
+    SymbolBuffer lent_;
+};
+
+/// Lends consecutive fixed-size symbols straight out of a contiguous
+/// capture the caller keeps alive: no copy and no allocation per symbol.
+/// Symbols that would run past the end of the capture are not produced.
+class SpanSymbolSource : public SymbolSource
+{
+public:
+    SpanSymbolSource(std::span<const std::complex<float>> samples,
+                     std::size_t offset,
+                     std::size_t samples_per_symbol,
+                     std::size_t symbol_count);
+    /// Native Q15 capture: views fill `samples_q15` only.
+    SpanSymbolSource(std::span<const Q15Complex> samples,
+                     std::size_t offset,
+                     std::size_t samples_per_symbol,
+                     std::size_t symbol_count);
+
+    void reset() override { index_ = 0; }
+    /// Copying fallback for callers that need an owned buffer.
+    std::optional<SymbolBuffer> next_symbol() override;
+    std::optional<SymbolView> next_view() override;
+    bool views_persist() const override { return true; }
+
+    std::size_t symbol_count() const { return symbol_count_; }
+
+private:
+    std::span<const std::complex<float>> samples_;
+    std::span<const Q15Complex> samples_q15_;
+    std::size_t offset_;
+    std::size_t samples_per_symbol_;
+    std::size_t symbol_count_;
+    std::size_t index_{0};
 };
 
 } // namespace host_sim
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/soft_decode.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace host_sim
+{
+
+struct SymbolTimingConfig
+{
+    double nominal_stride{0.0};     ///< Samples per symbol after the preamble SFO estimate
+    int samples_per_symbol{0};
+    int sf{7};
+    float kp{0.2f};                 ///< Proportional gain: window step per bin of error
+    float ki{0.02f};                ///< Integral gain: stride step per bin of error
+    int delay_symbols{8};           ///< Open-loop windows first (the header block)
+    float max_error{0.15f};         ///< Per-symbol error clamp, bins
+    float peak_gate{3.0f};          ///< Peaks below peak_gate·ln(2^SF)× the mean bin power are ignored
+};
+
+/// Closed-loop symbol timing tracker: a second-order loop on the
+/// demodulator's fractional-bin residual (FftDemodulator::last_residual()).
+///
+/// A window off by d samples reads d·2^SF/sps bins off, so the residual is
+/// a direct, if noisy, timing error.  Each update moves the next window by
+/// it (proportional path) and corrects the stride (integral path), which
+/// absorbs whatever the preamble SFO estimate got wrong with no standing
+/// timing error.  Windows start on whole samples; the known rounding part
+/// of each residual is taken out before it drives the loop.
+///
+/// Near the sensitivity limit many peaks are wrong symbols whose residuals
+/// are noise; the peak gate and the error clamp keep those from walking the
+/// loop off.  At OS=1 a sub-sample timing error already costs symbols near
+/// the chirp wrap, so a large SFO still needs the OS=2 fallback there.
+class SymbolTimingTracker
+{
+public:
+    explicit SymbolTimingTracker(const SymbolTimingConfig& config);
+
+    /// Start of the next window relative to the first one, in samples.
+    std::size_t next_offset() const;
+
+    /// Whether a window's |X|² spectrum (2^SF bins) passes the peak gate.
+    bool reliable(const float* fft_mag_sq) const;
+
+    /// Feed the residual of the window just demodulated at next_offset();
+    /// an unreliable one only advances by the current stride.
+    void update(float residual, bool reliable = true);
+
+    /// Stride the loop currently advances by.
+    double stride() const { return stride_; }
+    std::size_t symbols() const { return symbols_; }
+
+private:
+    SymbolTimingConfig config_;
+    double samples_per_bin_{0.0};
+    double position_{0.0};
+    double stride_{0.0};
+    std::size_t symbols_{0};
+};
+
+/// Demodulate up to @p max_symbols windows of @p samples from @p first,
+/// placed by @p tracker, appending to @p symbols (and per-symbol LLRs with
+/// @p llrs, the tracker's first eight windows at the reduced header rate).
+/// Stops at the first window that runs past the buffer, so a later call
+/// with more samples and the same tracker carries on from there; returns
+/// how many were appended.
+std::size_t demodulate_tracked(const FftDemodulator& demod,
+                               std::span<const std::complex<float>> samples,
+                               std::size_t first,
+                               SymbolTimingTracker& tracker,
+                               std::size_t max_symbols,
+                               const LoRaMetadata& meta,
+                               std::pmr::vector<uint16_t>& symbols,
+                               std::pmr::vector<SoftSymbol>* llrs = nullptr);
+
+} // namespace host_sim
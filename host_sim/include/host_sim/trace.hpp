@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ── Hot-path tracing ────────────────────────────────────────────────
+// Scoped spans and work counters for the decode pipeline.  The
+// HOST_SIM_TRACE_SPAN / HOST_SIM_TRACE_COUNT macros compile to nothing
+// unless the tree is built with -DHOST_SIM_TRACE=ON; even then nothing
+// is recorded until trace::set_enabled(true).
+//
+// Each thread writes its own fixed-size ring of span events, stamped
+// with the TSC where there is one, with no locks or allocation after its
+// first event.  Rings wrap: a long run keeps its most recent events.
+// Export and counters() read the rings without stopping the writers, so
+// call them once the traced work has finished.
+
+namespace host_sim::trace
+{
+
+/// Work counted across every thread while tracing is enabled.
+enum class Counter : std::size_t
+{
+    ffts,               ///< Symbol-sized forward FFTs (demodulation and alignment)
+    bursts,             ///< Bursts handed to a decoder
+    candidates,         ///< Probes run by find_first_candidate()
+    demod_passes,       ///< Demodulation passes over a run of symbols (grid, tracked, resampled)
+    header_attempts,    ///< Header blocks decoded
+    crc_probes,         ///< Payload CRC probes
+    redemod_passes,     ///< SFD, timing and OS=2 re-demodulation passes
+    count
+};
+
+constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::count);
+
+using Counters = std::array<std::uint64_t, kCounterCount>;
+
+const char* counter_name(Counter counter);
+
+/// Whether the HOST_SIM_* macros record anything in this build.
+constexpr bool compiled_in()
+{
+#ifdef HOST_SIM_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+namespace detail
+{
+extern std::atomic<bool> enabled;
+std::uint64_t now();
+void record(const char* name, std::uint64_t begin, std::uint64_t end);
+void add(Counter counter, std::uint64_t n);
+} // namespace detail
+
+inline bool enabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+/// Start or stop recording on every thread.  Enabling does not clear
+/// what was recorded before; reset() does.
+void set_enabled(bool on);
+
+/// Drop every recorded event and zero the counters.
+void reset();
+
+inline void count(Counter counter, std::uint64_t n = 1)
+{
+    if (enabled()) {
+        detail::add(counter, n);
+    }
+}
+
+/// Records [construction, destruction) as an event named @p name, which
+/// must outlive the export (a string literal).
+class Span
+{
+public:
+    explicit Span(const char* name) : name_(name), begin_(enabled() ? detail::now() : 0) {}
+    ~Span()
+    {
+        if (begin_ != 0) {
+            detail::record(name_, begin_, detail::now());
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name_;
+    std::uint64_t begin_;
+};
+
+/// Counters summed over every thread.
+Counters counters();
+
+/// (name, value) for every counter, in enum order.
+std::vector<std::pair<std::string, std::uint64_t>> counter_list();
+
+/// Events overwritten by ring wrap-around since the last reset().
+std::uint64_t dropped_events();
+
+/// Write every recorded span as Chrome trace_event JSON ("X" events, one
+/// track per thread), loadable in chrome://tracing or Perfetto.  Counters
+/// go in as a final "C" event.  Returns the number of spans written.
+std::size_t write_chrome_trace(const std::filesystem::path& path);
+
+} // namespace host_sim::trace
+
+#define HOST_SIM_TRACE_CONCAT_(a, b) a##b
+#define HOST_SIM_TRACE_CONCAT(a, b) HOST_SIM_TRACE_CONCAT_(a, b)
+
+#ifdef HOST_SIM_TRACE
+#define HOST_SIM_TRACE_SPAN(name) \
+    const ::host_sim::trace::Span HOST_SIM_TRACE_CONCAT(host_sim_trace_span_, __LINE__)(name)
+#define HOST_SIM_TRACE_COUNT(counter, n) ::host_sim::trace::count(::host_sim::trace::Counter::counter, (n))
+#else
+#define HOST_SIM_TRACE_SPAN(name) static_cast<void>(0)
+#define HOST_SIM_TRACE_COUNT(counter, n) static_cast<void>(0)
+#endif
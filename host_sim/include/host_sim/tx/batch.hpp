@@ -0,0 +1,70 @@
+#pragma once
+
+#include "host_sim/tx/channel.hpp"
+#include "host_sim/tx/packet.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace host_sim
+{
+class WorkerPool;
+}
+
+namespace host_sim::tx
+{
+
+struct BatchOptions
+{
+    PacketParams packet;
+    ChannelParams channel;
+    std::size_t count{1};
+    /// Fixed payload for every packet; empty draws payload_len random bytes
+    /// per packet from its own stream.
+    std::vector<uint8_t> payload;
+    std::size_t payload_len{16};
+    uint64_t seed{1};
+    /// Packets generated per parallel wave, which bounds memory; 0 picks
+    /// four per worker.
+    std::size_t window{0};
+};
+
+struct BatchPacket
+{
+    std::size_t index{0};
+    std::vector<uint8_t> payload;
+    std::vector<std::complex<float>> iq;
+    ChannelReport channel;
+};
+
+/// Generates packets 0..count-1 on a worker pool and hands them to the
+/// sink in index order, at most `window` at a time.  Packet i's payload
+/// and noise come from counter-based streams keyed by (seed, i), so the
+/// output depends only on the options, never on the worker count or
+/// scheduling.
+class BatchGenerator
+{
+public:
+    using Sink = std::function<void(const BatchPacket&)>;
+
+    explicit BatchGenerator(BatchOptions options);
+
+    const BatchOptions& options() const { return options_; }
+
+    /// Packet @p index on its own (what run() emits at that position).
+    BatchPacket generate(std::size_t index) const;
+
+    void run(const Sink& sink, WorkerPool* pool = nullptr) const;
+
+private:
+    BatchOptions options_;
+};
+
+/// Append @p packet's samples as interleaved little-endian float32 I/Q.
+void write_cf32(std::ostream& out, const BatchPacket& packet);
+
+} // namespace host_sim::tx
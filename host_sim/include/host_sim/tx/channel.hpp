@@ -0,0 +1,67 @@
+#pragma once
+
+#include "host_sim/tx/counter_rng.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace host_sim
+{
+class WorkerPool;
+}
+
+namespace host_sim::tx
+{
+
+/// Impairments lora_tx applies, in order: CFO, SFO, AWGN.
+struct ChannelParams
+{
+    float snr_db{NAN};    // NaN = no noise
+    float cfo_hz{0.0f};   // carrier frequency offset
+    float sfo_ppm{0.0f};  // sampling frequency offset
+};
+
+struct ChannelReport
+{
+    double signal_power{0.0};   ///< mean power of the non-silent samples
+    float noise_std{0.0f};      ///< per-component AWGN sigma (0 without AWGN)
+};
+
+// Every impairment works on fixed-size chunks that @p pool (nullptr runs
+// serially) may process in any order: each chunk's phase and noise come
+// straight from the sample index, and the power estimate is summed per
+// chunk then combined in chunk order, so the output is bit-identical for
+// any worker count.
+
+/// Rotate by e^{j2π·cfo·n/fs}.
+void apply_cfo(std::span<std::complex<float>> iq, double cfo_hz, double sample_rate, WorkerPool* pool = nullptr);
+
+/// Resample by linear interpolation at 1 + ppm·1e-6 input samples per
+/// output sample.
+std::vector<std::complex<float>> apply_sfo(std::span<const std::complex<float>> iq,
+                                           double ppm,
+                                           WorkerPool* pool = nullptr);
+
+/// Mean power of the samples above the silence floor.
+double signal_power(std::span<const std::complex<float>> iq, WorkerPool* pool = nullptr);
+
+/// Add complex AWGN at @p snr_db relative to signal_power(), to the
+/// non-silent samples only (the leading/trailing silence stays clean so
+/// the receiver's energy detector still finds the burst).  Sample n's
+/// noise is rng.normal_pair(n).
+ChannelReport add_awgn(std::span<std::complex<float>> iq,
+                       float snr_db,
+                       const CounterRng& rng,
+                       WorkerPool* pool = nullptr);
+
+/// CFO, SFO then AWGN per @p params; @p iq may be replaced (SFO).
+ChannelReport apply_channel(std::vector<std::complex<float>>& iq,
+                            const ChannelParams& params,
+                            double sample_rate,
+                            const CounterRng& rng,
+                            WorkerPool* pool = nullptr);
+
+} // namespace host_sim::tx
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <numbers>
+
+namespace host_sim::tx
+{
+
+/// Counter-based random numbers: the value at position n of a stream is a
+/// pure function of (key, n), so any thread can produce any slice of it
+/// and results never depend on how work was split.  The mixing function
+/// is the SplitMix64 finaliser; streams are keyed by hashing the user
+/// seed with a stream id (packet index, purpose).
+class CounterRng
+{
+public:
+    constexpr explicit CounterRng(uint64_t key) : key_(key) {}
+
+    /// Stream @p stream of seed @p seed; distinct (seed, stream) pairs give
+    /// unrelated sequences.
+    static constexpr CounterRng stream(uint64_t seed, uint64_t stream)
+    {
+        return CounterRng(mix(mix(seed) ^ (stream * kGamma + kGamma)));
+    }
+
+    constexpr uint64_t bits(uint64_t counter) const { return mix(key_ ^ (counter * kGamma + kGamma)); }
+
+    /// Uniform in (0, 1]: never 0, so it is safe under log().
+    float uniform(uint64_t counter) const { return to_unit(static_cast<uint32_t>(bits(counter) >> 32)); }
+
+    /// Two independent N(0, 1) draws from one counter (Box-Muller), as the
+    /// real and imaginary parts.
+    std::complex<float> normal_pair(uint64_t counter) const
+    {
+        const uint64_t b = bits(counter);
+        const float u0 = to_unit(static_cast<uint32_t>(b >> 32));
+        const float u1 = to_unit(static_cast<uint32_t>(b));
+        const float r = std::sqrt(-2.0f * std::log(u0));
+        const float theta = 2.0f * std::numbers::pi_v<float> * u1;
+        return {r * std::cos(theta), r * std::sin(theta)};
+    }
+
+private:
+    static constexpr uint64_t kGamma = 0x9e3779b97f4a7c15ull;
+
+    static constexpr uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    static float to_unit(uint32_t v)
+    {
+        // 24 significant bits, mapped to (0, 1].
+        return (static_cast<float>(v >> 8) + 1.0f) * (1.0f / 16777216.0f);
+    }
+
+    uint64_t key_;
+};
+
+} // namespace host_sim::tx
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "host_sim/chirp.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace host_sim::tx
+{
+
+/// Frame and air-interface parameters for one transmitted packet.
+struct PacketParams
+{
+    int sf{7};
+    int cr{1};  // 1..4
+    int bw{125000};
+    int sample_rate{125000};
+    int preamble_len{8};
+    int sync_word{0x12};
+    bool has_crc{true};
+    bool implicit_header{false};
+    bool ldro{false};
+
+    int oversample_factor() const { return sample_rate / bw; }
+};
+
+/// LDRO as LoRa radios enable it by default: symbols longer than 16 ms.
+bool ldro_required(int sf, int bw);
+
+/// Whitened payload (+ CRC) bytes as the data symbols of a frame: the
+/// CR 4/8 header block (carrying the explicit header, if any) followed by
+/// blocks at the packet's CR.
+std::vector<uint16_t> encode_packet_symbols(int sf,
+                                            int cr,
+                                            bool has_crc,
+                                            bool ldro,
+                                            bool implicit_header,
+                                            const std::vector<uint8_t>& payload);
+std::vector<uint16_t> encode_packet_symbols(const PacketParams& params, const std::vector<uint8_t>& payload);
+
+/// Silent symbols before and after the burst.  The receiver's burst
+/// detector estimates noise from the lowest-power quartile of its
+/// windows, so the silence must exceed 25% of the capture.
+int padding_symbols(int preamble_len, std::size_t data_symbol_count);
+
+/// Samples modulate_packet_into() writes for @p data_symbol_count symbols:
+/// padding, preamble, 2 sync chirps, 2.25 downchirps, data, padding.
+std::size_t packet_length(int sf, int os_factor, int preamble_len, std::size_t data_symbol_count);
+
+/// Modulate into @p out, which must hold packet_length() samples.
+void modulate_packet_into(const ChirpModulator& modulator,
+                          int sync_word,
+                          int preamble_len,
+                          const std::vector<uint16_t>& data_symbols,
+                          std::span<std::complex<float>> out);
+
+std::vector<std::complex<float>> modulate_packet(int sf,
+                                                 int os_factor,
+                                                 int sync_word,
+                                                 int preamble_len,
+                                                 const std::vector<uint16_t>& data_symbols);
+
+/// Process-wide modulator per (sf, os), built on first use.
+std::shared_ptr<const ChirpModulator> shared_modulator(int sf, int oversample_factor);
+
+} // namespace host_sim::tx
@@ -1,12 +1,115 @@
 #pragma once
 
+#include "host_sim/crc16.hpp"
+
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <span>
 #include <vector>
 
 namespace host_sim
 {
 
+namespace detail
+{
+
+constexpr std::size_t kWhiteningPeriod = 255;
+constexpr std::size_t kWhiteningSpan = 32;   ///< Widest window read in one step
+
+/// The LoRa whitening sequence (LFSR x^8 + x^6 + x^5 + x^4 + 1 from 0xFF,
+/// period 255) followed by its first kWhiteningSpan bytes again, so a
+/// window of up to kWhiteningSpan bytes starting at any phase reads
+/// without wrapping.
+inline constexpr auto kWhiteningTable = [] {
+    std::array<uint8_t, kWhiteningPeriod + kWhiteningSpan> table{};
+    uint8_t state = 0xFF;
+    for (std::size_t i = 0; i < kWhiteningPeriod; ++i) {
+        table[i] = state;
+        const int feedback = ((state >> 7) ^ (state >> 5) ^ (state >> 4) ^ (state >> 3)) & 1;
+        state = static_cast<uint8_t>((state << 1) | feedback);
+    }
+    for (std::size_t i = 0; i < kWhiteningSpan; ++i) {
+        table[kWhiteningPeriod + i] = table[i];
+    }
+    return table;
+}();
+
+static_assert(kWhiteningTable[0] == 0xFF && kWhiteningTable[7] == 0x85 && kWhiteningTable[254] == 0x7F,
+              "whitening LFSR");
+
+/// XOR @p count (at most kWhiteningSpan) bytes with the sequence from
+/// @p phase, a 64-bit word at a time.
+inline void xor_whitening_window(uint8_t* data, std::size_t count, std::size_t phase)
+{
+    const uint8_t* mask = kWhiteningTable.data() + phase;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t word;
+        uint64_t key;
+        std::memcpy(&word, data + i, 8);
+        std::memcpy(&key, mask + i, 8);
+        word ^= key;
+        std::memcpy(data + i, &word, 8);
+    }
+    for (; i < count; ++i) {
+        data[i] ^= mask[i];
+    }
+}
+
+} // namespace detail
+
+/// Byte @p index of the LoRa whitening sequence (period 255).
+constexpr uint8_t whitening_byte(std::size_t index)
+{
+    return detail::kWhiteningTable[index % detail::kWhiteningPeriod];
+}
+
+/// XOR @p bytes in place with the whitening sequence starting at sequence
+/// index @p offset.  Whitening and de-whitening are the same operation.
+inline void whiten_in_place(std::span<uint8_t> bytes, std::size_t offset = 0)
+{
+    std::size_t phase = offset % detail::kWhiteningPeriod;
+    for (std::size_t done = 0; done < bytes.size();) {
+        const std::size_t step = std::min(detail::kWhiteningSpan, bytes.size() - done);
+        detail::xor_whitening_window(bytes.data() + done, step, phase);
+        done += step;
+        phase = (phase + step) % detail::kWhiteningPeriod;
+    }
+}
+
+/// Fused TX pass: advance CRC-16/CCITT @p crc over the plain @p bytes,
+/// then whiten them in place, one cache-resident window at a time.
+inline uint16_t crc16_then_whiten(std::span<uint8_t> bytes, uint16_t crc = 0x0000, std::size_t offset = 0)
+{
+    std::size_t phase = offset % detail::kWhiteningPeriod;
+    for (std::size_t done = 0; done < bytes.size();) {
+        const std::size_t step = std::min(detail::kWhiteningSpan, bytes.size() - done);
+        crc = crc16_ccitt(bytes.data() + done, step, crc);
+        detail::xor_whitening_window(bytes.data() + done, step, phase);
+        done += step;
+        phase = (phase + step) % detail::kWhiteningPeriod;
+    }
+    return crc;
+}
+
+/// Fused RX pass: de-whiten @p bytes in place and advance CRC-16/CCITT
+/// @p crc over the recovered bytes.
+inline uint16_t dewhiten_then_crc16(std::span<uint8_t> bytes, uint16_t crc = 0x0000, std::size_t offset = 0)
+{
+    std::size_t phase = offset % detail::kWhiteningPeriod;
+    for (std::size_t done = 0; done < bytes.size();) {
+        const std::size_t step = std::min(detail::kWhiteningSpan, bytes.size() - done);
+        detail::xor_whitening_window(bytes.data() + done, step, phase);
+        crc = crc16_ccitt(bytes.data() + done, step, crc);
+        done += step;
+        phase = (phase + step) % detail::kWhiteningPeriod;
+    }
+    return crc;
+}
+
 class WhiteningSequencer
 {
 public:
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/resampler.hpp"
+#include "host_sim/soft_decode.hpp"
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace host_sim
+{
+
+/// Memoised symbol-window demodulation over one sample buffer.
+///
+/// The recovery sweeps re-demodulate a burst once per (SFO rate, timing)
+/// candidate, yet the candidates' window grids round to the same start
+/// samples for most symbols: ±100 ppm moves an OS=2 window by about one
+/// sample over 40 symbols.  The cache keeps what a demodulator yields for
+/// the window at each start sample (the hard symbol and, when soft, the
+/// |X|² spectrum), and demodulate() assembles a candidate's symbols from
+/// it, running an FFT only for windows no candidate has visited yet.  The
+/// cost of a sweep becomes one FFT per distinct window instead of one per
+/// candidate and symbol.
+///
+/// Only valid while a demodulator's output depends on the window's start
+/// sample alone — fixed CFO, zero SFO slope, no CFO tracking — which is how
+/// the sweeps configure theirs.  Thread-safe: parallel candidates bring
+/// their own, identically configured demodulators.
+///
+/// Over a FarrowResampler the cache reads a virtual buffer `factor` times
+/// the input rate without ever building it: grid positions are in output
+/// samples, and each visited window is resampled on demand from input
+/// position start / factor.  The demodulator then runs at the input rate,
+/// which is what a single-tap OS=factor demodulator over an upsampled
+/// buffer reads anyway.
+class DemodWindowCache
+{
+public:
+    /// @p samples must outlive the cache.  With @p keep_spectra the |X|²
+    /// vectors are kept so demodulate() can produce LLRs.
+    DemodWindowCache(std::span<const std::complex<float>> samples, int sf, bool keep_spectra);
+
+    /// Windows on a grid of @p factor samples per @p source sample; the
+    /// resampler must outlive the cache.
+    DemodWindowCache(const FarrowResampler& source, int factor, int sf, bool keep_spectra);
+
+    /// Length of the (possibly virtual) buffer the grid positions index.
+    std::size_t size() const;
+
+    /// Append the symbols of grid windows first + round(i·stride) for
+    /// i = begin .. end-1, stopping at the first window that runs past the
+    /// buffer (a window spans samples_per_symbol() input samples, so
+    /// factor times that on the grid); returns how many were appended.  With @p llrs (requires
+    /// keep_spectra) each symbol's LLRs are appended too, at the reduced
+    /// rate for i < 8 (the header block) or with LDRO.  What a fresh
+    /// demodulate() or demodulate_block() pass over the same grid returns.
+    std::size_t demodulate(const FftDemodulator& demod,
+                           std::size_t first,
+                           double stride,
+                           std::size_t begin,
+                           std::size_t end,
+                           const LoRaMetadata& meta,
+                           std::pmr::vector<uint16_t>& symbols,
+                           std::pmr::vector<SoftSymbol>* llrs = nullptr);
+
+    /// Windows demodulated so far (FFTs run).
+    std::size_t windows() const { return windows_.load(std::memory_order_relaxed); }
+    /// Windows requested so far, hits included.
+    std::size_t lookups() const { return lookups_.load(std::memory_order_relaxed); }
+
+private:
+    struct Window
+    {
+        uint16_t symbol{0};
+        std::vector<float> spectrum;    // |X|², only with keep_spectra
+    };
+
+    const Window& window(const FftDemodulator& demod, std::size_t start);
+
+    std::span<const std::complex<float>> samples_;
+    const FarrowResampler* source_{nullptr};
+    int factor_{1};
+    int sf_{0};
+    bool keep_spectra_{false};
+    std::mutex mutex_;
+    std::unordered_map<std::size_t, Window> entries_;   // by start sample; nodes never move
+    std::atomic<std::size_t> windows_{0};
+    std::atomic<std::size_t> lookups_{0};
+};
+
+} // namespace host_sim
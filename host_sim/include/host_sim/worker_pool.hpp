@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace host_sim
+{
+
+/// Persistent worker threads shared by alignment, candidate sweeps and
+/// multi-SF probing, so short parallel sections do not pay thread
+/// creation on every call.
+///
+/// worker_count() slots are available to a job: slot 0 is the calling
+/// thread and slots 1..n-1 are pool threads.  The shared pool is sized
+/// from the HOST_SIM_THREADS environment variable (1 disables threading)
+/// or the hardware concurrency.
+class WorkerPool
+{
+public:
+    using Task = std::function<void(std::size_t index, std::size_t worker)>;
+
+    explicit WorkerPool(std::size_t workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    static WorkerPool& shared();
+
+    std::size_t worker_count() const { return worker_count_; }
+
+    /// Run task(i, worker) for every i in [0, count) and wait for all of
+    /// them.  Indices are handed out in increasing order.  If a task
+    /// throws, the remaining indices are skipped and the first exception
+    /// is rethrown here once the running tasks have finished.
+    ///
+    /// Calls made from inside a pool task, or while another thread is
+    /// running a job on this pool, execute serially on the calling thread
+    /// as worker 0, so nesting can never deadlock.
+    void parallel_for(std::size_t count, const Task& task);
+
+private:
+    struct Job;
+
+    void worker_main(std::size_t worker);
+    static void run_job(Job& job, std::size_t worker);
+
+    std::size_t worker_count_;
+    std::vector<std::thread> threads_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    Job* job_{nullptr};
+    std::uint64_t generation_{0};
+    std::size_t busy_{0};
+    bool stop_{false};
+};
+
+/// Lazily built per-worker state (scratch buffers, demodulators) for one
+/// parallel section, indexed by the worker slot passed to each task.
+template <typename T>
+class PerWorker
+{
+public:
+    explicit PerWorker(const WorkerPool& pool = WorkerPool::shared())
+        : slots_(pool.worker_count())
+    {
+    }
+
+    template <typename Factory>
+    T& get(std::size_t worker, Factory&& make)
+    {
+        auto& slot = slots_[worker];
+        if (!slot) {
+            slot = make();
+        }
+        return *slot;
+    }
+
+private:
+    std::vector<std::unique_ptr<T>> slots_;
+};
+
+} // namespace host_sim
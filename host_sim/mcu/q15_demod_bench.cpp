@@ -0,0 +1,127 @@
+/// q15_demod_bench.cpp — Bare-metal cycle count of FftDemodulatorQ15 on
+/// the CMSIS-DSP kernels: clean symbols at SF7 .. HOST_SIM_MCU_MAX_SF
+/// (OS=1, BW 125 kHz) timed with DWT->CYCCNT (SysTick on Armv6-M), one
+/// line per SF in the terms of lora_replay's McuCycleSummary:
+/// cycles/symbol against the core cycles of one symbol period.
+
+#include "host_sim/chirp.hpp"
+#include "host_sim/fft_demod_q15.hpp"
+#include "host_sim/q15_fft.hpp"
+
+#include HOST_SIM_MCU_DEVICE_HEADER
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t kCoreHz = HOST_SIM_MCU_FREQ_HZ;
+constexpr int kBandwidth = 125000;
+constexpr int kSymbolsPerSf = 32;
+
+// ── Cycle counter ──
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+void cycle_counter_start()
+{
+    CoreDebug->DEMCR = CoreDebug->DEMCR | CoreDebug_DEMCR_TRCENA_Msk;
+#if defined(__CORE_CM7_H_GENERIC)
+    DWT->LAR = 0xC5ACCE55;   // Cortex-M7 locks the DWT until unlocked
+#endif
+    DWT->CYCCNT = 0;
+    DWT->CTRL = DWT->CTRL | DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t cycle_count()
+{
+    return DWT->CYCCNT;
+}
+#else
+// Armv6-M has no DWT cycle counter: run SysTick free at the core clock.
+// 24 bits wrap after 16.7 M cycles, ample for one symbol.
+void cycle_counter_start()
+{
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+uint32_t cycle_count()
+{
+    // Counts down; negate so differences come out positive.
+    return (0u - SysTick->VAL) & SysTick_LOAD_RELOAD_Msk;
+}
+#endif
+
+uint32_t elapsed(uint32_t start, uint32_t end)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    return end - start;
+#else
+    return (end - start) & SysTick_LOAD_RELOAD_Msk;
+#endif
+}
+
+// ── Benchmark ──
+
+struct SfResult
+{
+    uint32_t avg_cycles{0};
+    uint32_t max_cycles{0};
+    uint32_t budget_cycles{0};
+    int errors{0};
+};
+
+SfResult bench_sf(int sf)
+{
+    const int n_bins = 1 << sf;
+    host_sim::FftDemodulatorQ15 demod(sf, kBandwidth, kBandwidth);
+    const auto chirps = host_sim::shared_chirps_q15(sf, 1);
+    std::vector<host_sim::Q15Complex> symbol(static_cast<std::size_t>(n_bins));
+
+    SfResult result;
+    uint64_t total = 0;
+    for (int s = 0; s < kSymbolsPerSf; ++s) {
+        const int value = (s * 37 + 5) % n_bins;
+        for (int i = 0; i < n_bins; ++i) {
+            symbol[static_cast<std::size_t>(i)] = chirps->upchirp[static_cast<std::size_t>((i + value) % n_bins)];
+        }
+        const uint32_t start = cycle_count();
+        const uint16_t decoded = demod.demodulate(symbol.data());
+        const uint32_t cycles = elapsed(start, cycle_count());
+        total += cycles;
+        result.max_cycles = std::max(result.max_cycles, cycles);
+        if (decoded != value) {
+            ++result.errors;
+        }
+    }
+    result.avg_cycles = static_cast<uint32_t>(total / kSymbolsPerSf);
+    result.budget_cycles = static_cast<uint32_t>(static_cast<uint64_t>(kCoreHz) * n_bins / kBandwidth);
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    cycle_counter_start();
+    std::printf("q15_demod_bench: %s @ %lu MHz, %s, BW %d Hz, OS 1\n", HOST_SIM_MCU_CPU_NAME,
+                static_cast<unsigned long>(kCoreHz / 1000000u), host_sim::Q15Fft::backend_name(), kBandwidth);
+    int errors = 0;
+    for (int sf = 7; sf <= HOST_SIM_MCU_MAX_SF; ++sf) {
+        const SfResult r = bench_sf(sf);
+        // Utilisation in per mille: > 1000 is slower than real time.
+        std::printf("SF%-2d cycles/symbol avg %8lu max %8lu budget %9lu utilisation avg %4lu max %4lu permille%s\n",
+                    sf, static_cast<unsigned long>(r.avg_cycles), static_cast<unsigned long>(r.max_cycles),
+                    static_cast<unsigned long>(r.budget_cycles),
+                    static_cast<unsigned long>(1000ull * r.avg_cycles / r.budget_cycles),
+                    static_cast<unsigned long>(1000ull * r.max_cycles / r.budget_cycles),
+                    r.errors ? "  SYMBOL ERRORS" : "");
+        errors += r.errors;
+    }
+    std::printf("q15_demod_bench: %d symbol errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -1,21 +1,65 @@
 #include "host_sim/alignment.hpp"
+#include "host_sim/burst_detector.hpp"
 
+#include "host_sim/dsp_kernels.hpp"
+#include "host_sim/fft_backend.hpp"
 #include "host_sim/fft_demod.hpp"
+#include "host_sim/trace.hpp"
+#include "host_sim/worker_pool.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <span>
-#include <thread>
+#include <string_view>
 #include <vector>
 
-extern "C" {
-#include "kiss_fft.h"
-}
-
 namespace host_sim
 {
 
+namespace
+{
+
+// Below this many FFT output points (offsets × symbols × bins) a scan
+// finishes faster inline than the pool can wake up, so it stays serial.
+constexpr std::size_t kParallelMinPoints = std::size_t{1} << 15;
+
+// Zoom fine scan.  A fine window spans ±coarse_stride = ±2 chips around
+// its coarse candidate, and the aliased preamble bin moves one bin per
+// chip of offset, so a probe's peak is within kZoomReach bins of the
+// candidate's bin shifted by its chip offset, give or take the coarse
+// bin's own error.  Each probe evaluates kZoomBins bins centred there.
+constexpr int kZoomReach = 2;
+constexpr int kZoomHalfWidth = 2;
+constexpr int kZoomBins = 2 * kZoomHalfWidth + 1;
+constexpr int kZoomRowsPerWindow = 2 * (kZoomReach + kZoomHalfWidth) + 1;
+
+// Below SF11 the fine-scan FFTs are cheap enough that the full search
+// costs little more than the zoom.
+constexpr int kZoomMinSf = 11;
+
+FineScanMode resolve_fine_scan(FineScanMode mode, int sf)
+{
+    if (mode != FineScanMode::automatic) {
+        return mode;
+    }
+    static const char* forced = std::getenv("HOST_SIM_ALIGN_FINE");
+    if (forced != nullptr && std::string_view(forced) == "fft") {
+        return FineScanMode::fft;
+    }
+    if (forced != nullptr && std::string_view(forced) == "zoom") {
+        return FineScanMode::zoom;
+    }
+    return sf >= kZoomMinSf ? FineScanMode::zoom : FineScanMode::fft;
+}
+
+} // namespace
+
 std::optional<BurstDetectResult> detect_burst_ex(
     const std::complex<float>* samples,
     std::size_t n_samples,
@@ -28,81 +72,9 @@ std::optional<BurstDetectResult> detect_burst_ex(
     if (!samples || n_samples == 0 || samples_per_symbol <= 0) {
         return std::nullopt;
     }
-
-    const std::size_t window = static_cast<std::size_t>(samples_per_symbol);
-    const std::size_t n_windows = n_samples / window;
-    if (n_windows < 3) {
-        return std::nullopt;
-    }
-
-    const std::size_t start_window = search_from / window;
-    if (start_window >= n_windows) {
-        return std::nullopt;
-    }
-
-    // Compute per-window mean power.
-    std::vector<float> powers(n_windows, 0.0f);
-    for (std::size_t w = 0; w < n_windows; ++w) {
-        double acc = 0.0;
-        for (std::size_t i = 0; i < window; ++i) {
-            const auto& s = samples[w * window + i];
-            acc += static_cast<double>(s.real()) * s.real() +
-                   static_cast<double>(s.imag()) * s.imag();
-        }
-        powers[w] = static_cast<float>(acc / static_cast<double>(window));
-    }
-
-    // Estimate noise floor from lowest quartile of windows,
-    // or use the caller-supplied prior if available.
-    float noise_floor;
-    if (prior_noise > 0.0f) {
-        // Use prior and blend with fresh quartile for stability.
-        std::vector<float> sorted_powers(powers);
-        std::sort(sorted_powers.begin(), sorted_powers.end());
-        const std::size_t q1_end = std::max<std::size_t>(1, n_windows / 4);
-        double noise_acc = 0.0;
-        for (std::size_t i = 0; i < q1_end; ++i) {
-            noise_acc += sorted_powers[i];
-        }
-        const float fresh = static_cast<float>(noise_acc / static_cast<double>(q1_end));
-        // EMA blend: 70% prior, 30% fresh — smooths jumps while adapting.
-        noise_floor = 0.7f * prior_noise + 0.3f * fresh;
-    } else {
-        std::vector<float> sorted_powers(powers);
-        std::sort(sorted_powers.begin(), sorted_powers.end());
-        const std::size_t q1_end = std::max<std::size_t>(1, n_windows / 4);
-        double noise_acc = 0.0;
-        for (std::size_t i = 0; i < q1_end; ++i) {
-            noise_acc += sorted_powers[i];
-        }
-        noise_floor = static_cast<float>(noise_acc / static_cast<double>(q1_end));
-    }
-    const float threshold = noise_floor * threshold_factor;
-
-    // Find first window at or after start_window that exceeds threshold.
-    // Require min_consec consecutive windows above threshold to confirm.
-    int consec = 0;
-    std::size_t first_high = 0;
-    for (std::size_t w = start_window; w < n_windows; ++w) {
-        if (powers[w] > threshold) {
-            if (consec == 0) first_high = w;
-            ++consec;
-            if (consec >= min_consec) {
-                const std::size_t w_detect = first_high;
-                const std::size_t margin = (w_detect >= 2 && w_detect - 2 >= start_window) ? 2
-                                         : (w_detect > start_window ? w_detect - start_window : 0);
-                BurstDetectResult r;
-                r.burst_start = (w_detect - margin) * window;
-                r.noise_floor = noise_floor;
-                r.signal_power = powers[w_detect];
-                return r;
-            }
-        } else {
-            consec = 0;
-        }
-    }
-
-    return std::nullopt;
+    const BurstIndex index(samples, n_samples, static_cast<std::size_t>(samples_per_symbol),
+                           threshold_factor, min_consec);
+    return index.find_start(search_from, prior_noise);
 }
 
 std::optional<std::size_t> detect_burst_start(const std::complex<float>* samples,
@@ -135,6 +107,7 @@ AlignmentResult find_symbol_alignment_scored(
     if (samples.size() < static_cast<std::size_t>(sps * preamble_symbols)) {
         return {0U, 0};
     }
+    HOST_SIM_TRACE_SPAN("align/exhaustive");
 
     std::size_t best_offset = 0U;
     int best_score = -1;
@@ -170,8 +143,44 @@ std::size_t find_symbol_alignment(std::span<const std::complex<float>> samples,
     return find_symbol_alignment_scored(samples, demod, preamble_symbols).offset;
 }
 
+std::vector<PreambleRun> find_preamble_runs(
+    std::span<const std::complex<float>> samples,
+    const FftDemodulator& demod,
+    int min_run)
+{
+    std::vector<PreambleRun> runs;
+    const double sps = static_cast<double>(demod.samples_per_symbol());
+    const std::size_t count = demod.block_capacity(samples.size(), sps);
+    if (count == 0) {
+        return runs;
+    }
+    std::vector<uint16_t> bins(count);
+    demod.demodulate_block(samples.data(), count, sps, bins.data());
+
+    const int n_bins = 1 << demod.sf();
+    const auto close_bins = [n_bins](int a, int b) {
+        const int d = std::abs(a - b);
+        return std::min(d, n_bins - d) <= 1;
+    };
+    const auto emit = [&](std::size_t first, std::size_t end) {
+        const int length = static_cast<int>(end - first);
+        if (length >= std::max(1, min_run)) {
+            runs.push_back({first, length, bins[first]});
+        }
+    };
+    std::size_t first = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        if (!close_bins(bins[i], bins[i - 1])) {
+            emit(first, i);
+            first = i;
+        }
+    }
+    emit(first, count);
+    return runs;
+}
+
 std::optional<std::size_t> find_header_symbol_index(
-    const std::vector<uint16_t>& symbols,
+    std::span<const uint16_t> symbols,
     int sync_word,
     int sf)
 {
@@ -231,13 +240,21 @@ std::optional<std::size_t> find_header_symbol_index(
 PreambleSearchResult find_symbol_alignment_cfo_aware(
     std::span<const std::complex<float>> samples,
     const FftDemodulator& demod,
-    int preamble_symbols)
+    int preamble_symbols,
+    PreambleSpectra* spectra,
+    FineScanMode fine_scan,
+    std::pmr::memory_resource* memory)
 {
     const int sps = demod.samples_per_symbol();
     const int n_bins = 1 << demod.sf();
     const int os = demod.oversample_factor();
 
     PreambleSearchResult result{};
+    if (spectra) {
+        spectra->symbols = 0;
+    }
+    // Zoom mode never forms full spectra, so keeps none.
+    const bool zoom = resolve_fine_scan(fine_scan, demod.sf()) == FineScanMode::zoom;
 
     if (samples.size() < static_cast<std::size_t>(sps * preamble_symbols)) {
         return result;
@@ -257,17 +274,71 @@ PreambleSearchResult find_symbol_alignment_cfo_aware(
     // recovers precision, and this halves the coarse scan time.
     const int coarse_preamble = std::min(preamble_symbols, 4);
 
-    // Allocate FFT resources once
-    kiss_fft_cfg cfg = kiss_fft_alloc(n_bins, 0, nullptr, nullptr);
-    if (!cfg) {
-        // Fallback to legacy alignment
-        result.alignment_offset = find_symbol_alignment(samples, demod, preamble_symbols);
-        return result;
+    // The cached plan is shared (read-only) by all pool workers; each
+    // worker keeps its own dechirp/FFT scratch.
+    const FftPlan& plan = fft_plan(n_bins);
+    const auto& downchirp = demod.chirps().downchirp;
+    WorkerPool& pool = WorkerPool::shared();
+
+    struct ScanScratch {
+        explicit ScanScratch(std::pmr::memory_resource* m)
+            : fft_in(m), fft_out(m), peaks(m), mag_per_bin(m), probe_spectra(m), kept_spectra(m)
+        {
+        }
+        std::pmr::vector<std::complex<float>> fft_in;
+        std::pmr::vector<std::complex<float>> fft_out;
+        std::pmr::vector<int> peaks;
+        std::pmr::vector<float> mag_per_bin;
+        // Level-2 spectra, only when the caller asked for them: the probe
+        // being scored, and the best probe this worker has seen so far.
+        std::pmr::vector<std::complex<float>> probe_spectra;
+        std::pmr::vector<std::complex<float>> kept_spectra;
+        int probe_symbols{0};
+        int kept_symbols{0};
+        float kept_mag{-1.0f};
+        std::size_t kept_probe{SIZE_MAX};
+    };
+    // One slot per worker, sized on first use.  `memory` need not be
+    // thread-safe, so workers size theirs under a lock.
+    std::pmr::vector<ScanScratch> scratch(memory);
+    scratch.reserve(pool.worker_count());
+    for (std::size_t w = 0; w < pool.worker_count(); ++w) {
+        scratch.emplace_back(memory);
     }
+    std::mutex scratch_mutex;
+    auto worker_scratch = [&](std::size_t worker) -> ScanScratch& {
+        ScanScratch& s = scratch[worker];
+        if (s.fft_in.empty()) {
+            const std::lock_guard<std::mutex> lock(scratch_mutex);
+            s.fft_in.resize(n_bins);
+            s.fft_out.resize(n_bins);
+            s.peaks.resize(std::max(preamble_symbols, 1));
+            s.mag_per_bin.resize(n_bins);
+            if (spectra && !zoom) {
+                const auto spectra_len = static_cast<std::size_t>(std::max(preamble_symbols, 1)) *
+                                         static_cast<std::size_t>(n_bins);
+                s.probe_spectra.resize(spectra_len);
+                s.kept_spectra.resize(spectra_len);
+            }
+        }
+        return s;
+    };
 
-    const auto& downchirp = demod.chirps().downchirp;
-    std::vector<kiss_fft_cpx> fft_in(n_bins);
-    std::vector<kiss_fft_cpx> fft_out(n_bins);
+    // Every scan below scores each offset independently into an array
+    // (in parallel when the work is large enough to be worth waking the
+    // pool), then selects from that array sequentially in offset order, so
+    // the result is identical for any worker count.
+    // The pool gets the task by reference, so no std::function copies
+    // (and heap-allocates) its captures.
+    auto for_each_offset = [&](std::size_t count, std::size_t ffts_per_offset, const auto& task) {
+        if (count * ffts_per_offset * static_cast<std::size_t>(n_bins) >= kParallelMinPoints) {
+            pool.parallel_for(count, std::cref(task));
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                task(i, 0);
+            }
+        }
+    };
 
     // Partial polyphase fold stride for the coarse scan.
     // For os > 4, use os/2 taps (~6dB more SNR than single tap).
@@ -276,39 +347,25 @@ PreambleSearchResult find_symbol_alignment_cfo_aware(
 
     // Polyphase fold: higher SNR (~10·log₁₀(os) dB better than
     // single-tap).  Used for the fine scan where precision matters.
-    auto dechirp_symbol = [&](std::size_t sample_offset, float* out_peak_mag = nullptr) -> int {
-        for (int bin = 0; bin < n_bins; ++bin) {
-            std::complex<float> acc{0.0f, 0.0f};
-            for (int m = 0; m < os; ++m) {
-                const int idx = bin * os + m;
-                acc += samples[sample_offset + idx] * downchirp[idx];
-            }
-            fft_in[bin].r = acc.real();
-            fft_in[bin].i = acc.imag();
-        }
-        kiss_fft(cfg, fft_in.data(), fft_out.data());
-
-        int best_bin = 0;
-        float best_mag = -1.0f;
-        for (int bin = 0; bin < n_bins; ++bin) {
-            const float mag = fft_out[bin].r * fft_out[bin].r +
-                              fft_out[bin].i * fft_out[bin].i;
-            if (mag > best_mag) {
-                best_mag = mag;
-                best_bin = bin;
-            }
-        }
-        if (out_peak_mag) {
-            *out_peak_mag = best_mag;
-        }
-        return best_bin;
+    // The spectrum lands in `fft_out` (n_bins values).
+    auto dechirp_symbol = [&](ScanScratch& s, std::size_t sample_offset,
+                              std::complex<float>* fft_out, float* out_peak_mag) -> int {
+        kernels::dechirp_fold(samples.data() + sample_offset, downchirp.data(),
+                              n_bins, os, 1, s.fft_in.data());
+        plan.forward(s.fft_in.data(), fft_out);
+        HOST_SIM_TRACE_COUNT(ffts, 1);
+
+        const kernels::PeakPair peak =
+            kernels::find_two_peaks(fft_out, n_bins);
+        *out_peak_mag = peak.best_mag;
+        return peak.best_bin;
     };
 
     // Coarse scan — score by accumulated peak MAGNITUDE of the majority bin.
-    // Uses single-tap decimation (dechirp_symbol_fast) for speed; the fine
-    // scan below uses the full polyphase fold for precision.
+    // Uses a partial fold for speed; the fine scan below uses the full
+    // polyphase fold for precision.
     // Keep the top-K coarse candidates so that the polyphase fine scan
-    // can rescue cases where single-tap picks the wrong region.
+    // can rescue cases where the coarse fold picks the wrong region.
     // At high OS the coarse scan is more reliable, so fewer candidates
     // suffice — this also saves fine-scan time.
     struct CoarseCandidate {
@@ -317,29 +374,22 @@ PreambleSearchResult find_symbol_alignment_cfo_aware(
         int   bin;
     };
     const int K_COARSE = (os > 4) ? 3 : 5;
-    std::vector<CoarseCandidate> top_candidates(K_COARSE, {-1.0f, 0, 0});
-
-    // Decide whether to parallelise the coarse scan.  Thread creation has
-    // overhead (~0.1–0.5 ms per thread), so we only parallelise when the
-    // workload is large enough to amortise it (SF10+ at high OS).
-    const unsigned hw_threads =
-        std::max(1u, std::thread::hardware_concurrency());
-    const bool parallel_coarse =
-        (coarse_steps * coarse_preamble >= 2048) && (hw_threads > 1);
-
-    // Lambda: scan a range of coarse offsets, maintaining a thread-local
-    // top-K.  Allocates its own FFT resources for thread-safety.
-    auto coarse_scan_range = [&](int ci_start, int ci_end,
-                                 std::vector<CoarseCandidate>& local_tops) {
-        kiss_fft_cfg local_cfg = kiss_fft_alloc(n_bins, 0, nullptr, nullptr);
-        std::vector<kiss_fft_cpx> local_in(n_bins);
-        std::vector<kiss_fft_cpx> local_out(n_bins);
-        std::vector<int> local_peaks(coarse_preamble);
-        std::vector<float> mag_per_bin(n_bins);
-
-        for (int ci = ci_start; ci < ci_end; ++ci) {
-            const int offset = ci * coarse_stride;
-            std::fill(mag_per_bin.begin(), mag_per_bin.end(), 0.0f);
+    std::pmr::vector<CoarseCandidate> top_candidates(K_COARSE, {-1.0f, 0, 0}, memory);
+
+    struct OffsetScore {
+        float mag{-1.0f};
+        int bin{0};
+        bool accepted{false};
+    };
+    std::pmr::vector<OffsetScore> coarse_scores(static_cast<std::size_t>(coarse_steps), memory);
+
+    {
+        HOST_SIM_TRACE_SPAN("align/coarse");
+        for_each_offset(coarse_scores.size(), static_cast<std::size_t>(coarse_preamble),
+                        [&](std::size_t ci, std::size_t worker) {
+            ScanScratch& s = worker_scratch(worker);
+            const int offset = static_cast<int>(ci) * coarse_stride;
+            std::fill(s.mag_per_bin.begin(), s.mag_per_bin.end(), 0.0f);
 
             int valid_syms = 0;
             for (int sym = 0; sym < coarse_preamble; ++sym) {
@@ -347,107 +397,58 @@ PreambleSearchResult find_symbol_alignment_cfo_aware(
                                           static_cast<std::size_t>(sym) * sps;
                 if (base_sample + sps > samples.size()) break;
 
-                // Inline dechirp_symbol_fast with thread-local buffers
-                for (int bin = 0; bin < n_bins; ++bin) {
-                    std::complex<float> acc{0.0f, 0.0f};
-                    for (int m = 0; m < os; m += coarse_fold_stride) {
-                        const int idx = bin * os + m;
-                        acc += samples[base_sample + idx] * downchirp[idx];
-                    }
-                    local_in[bin].r = acc.real();
-                    local_in[bin].i = acc.imag();
-                }
-                kiss_fft(local_cfg, local_in.data(), local_out.data());
-
-                int peak = 0;
-                float peak_mag = -1.0f;
-                for (int bin = 0; bin < n_bins; ++bin) {
-                    const float mag = local_out[bin].r * local_out[bin].r +
-                                      local_out[bin].i * local_out[bin].i;
-                    if (mag > peak_mag) { peak_mag = mag; peak = bin; }
-                }
+                kernels::dechirp_fold(samples.data() + base_sample, downchirp.data(),
+                                      n_bins, os, coarse_fold_stride,
+                                      s.fft_in.data());
+                plan.forward(s.fft_in.data(), s.fft_out.data());
+                HOST_SIM_TRACE_COUNT(ffts, 1);
 
-                local_peaks[sym] = peak;
-                mag_per_bin[peak] += peak_mag;
+                const kernels::PeakPair coarse_peak =
+                    kernels::find_two_peaks(s.fft_out.data(), n_bins);
+                const int peak = coarse_peak.best_bin;
+                const float peak_mag = coarse_peak.best_mag;
+
+                s.peaks[sym] = peak;
+                s.mag_per_bin[peak] += peak_mag;
                 int left = (peak - 1 + n_bins) % n_bins;
                 int right = (peak + 1) % n_bins;
-                mag_per_bin[left] += peak_mag * 0.01f;
-                mag_per_bin[right] += peak_mag * 0.01f;
+                s.mag_per_bin[left] += peak_mag * 0.01f;
+                s.mag_per_bin[right] += peak_mag * 0.01f;
                 ++valid_syms;
             }
 
             int local_best_bin = 0;
             float local_best_mag = -1.0f;
             for (int b = 0; b < n_bins; ++b) {
-                if (mag_per_bin[b] > local_best_mag) {
-                    local_best_mag = mag_per_bin[b];
+                if (s.mag_per_bin[b] > local_best_mag) {
+                    local_best_mag = s.mag_per_bin[b];
                     local_best_bin = b;
                 }
             }
 
             int count_near = 0;
             for (int sym = 0; sym < valid_syms; ++sym) {
-                int diff = std::abs(local_peaks[sym] - local_best_bin);
+                int diff = std::abs(s.peaks[sym] - local_best_bin);
                 diff = std::min(diff, n_bins - diff);
                 if (diff <= 1) ++count_near;
             }
 
-            if (count_near >= (coarse_preamble + 1) / 2) {
-                int worst_idx = 0;
-                for (int k = 1; k < K_COARSE; ++k) {
-                    if (local_tops[k].mag_sum < local_tops[worst_idx].mag_sum)
-                        worst_idx = k;
-                }
-                if (local_best_mag > local_tops[worst_idx].mag_sum) {
-                    local_tops[worst_idx] = {local_best_mag, offset, local_best_bin};
-                }
+            coarse_scores[ci] = {local_best_mag, local_best_bin,
+                                 count_near >= (coarse_preamble + 1) / 2};
+        });
+
+        for (int ci = 0; ci < coarse_steps; ++ci) {
+            const OffsetScore& score = coarse_scores[static_cast<std::size_t>(ci)];
+            if (!score.accepted) continue;
+            int worst_idx = 0;
+            for (int k = 1; k < K_COARSE; ++k) {
+                if (top_candidates[k].mag_sum < top_candidates[worst_idx].mag_sum)
+                    worst_idx = k;
             }
-        }
-
-        free(local_cfg);
-    };
-
-    if (parallel_coarse) {
-        const int n_threads = std::min(static_cast<int>(hw_threads),
-                                       std::max(1, coarse_steps / 8));
-        const int steps_per_thread =
-            (coarse_steps + n_threads - 1) / n_threads;
-        std::vector<std::vector<CoarseCandidate>> thread_tops(n_threads);
-        std::vector<std::thread> threads;
-        threads.reserve(n_threads);
-
-        for (int t = 0; t < n_threads; ++t) {
-            const int ci_start = t * steps_per_thread;
-            const int ci_end = std::min(ci_start + steps_per_thread,
-                                        coarse_steps);
-            if (ci_start >= coarse_steps) break;
-            thread_tops[t].assign(K_COARSE, {-1.0f, 0, 0});
-            threads.emplace_back(coarse_scan_range, ci_start, ci_end,
-                                 std::ref(thread_tops[t]));
-        }
-
-        for (auto& t : threads) t.join();
-
-        // Merge thread-local top-K into global top_candidates.
-        for (const auto& tops : thread_tops) {
-            for (const auto& cand : tops) {
-                if (cand.mag_sum < 0.0f) continue;
-                int worst_idx = 0;
-                for (int k = 1; k < K_COARSE; ++k) {
-                    if (top_candidates[k].mag_sum <
-                        top_candidates[worst_idx].mag_sum)
-                        worst_idx = k;
-                }
-                if (cand.mag_sum > top_candidates[worst_idx].mag_sum) {
-                    top_candidates[worst_idx] = cand;
-                }
+            if (score.mag > top_candidates[worst_idx].mag_sum) {
+                top_candidates[worst_idx] = {score.mag, ci * coarse_stride, score.bin};
             }
         }
-    } else {
-        // Single-threaded coarse scan for small workloads.
-        std::vector<CoarseCandidate> local_tops(K_COARSE, {-1.0f, 0, 0});
-        coarse_scan_range(0, coarse_steps, local_tops);
-        top_candidates = std::move(local_tops);
     }
 
     // --- Phase 2: fine scan around each coarse candidate ---
@@ -458,82 +459,216 @@ PreambleSearchResult find_symbol_alignment_cfo_aware(
     // OS=16).  A two-level hierarchical scan reduces FFT count by ~4×:
     //   Level 1: stride = max(4, os/2) with fewer preamble symbols
     //   Level 2: ±fine_stride around the Level-1 winner, sample-by-sample
+    // Both levels flatten (candidate, offset) pairs into one parallel
+    // section each.
+    //
+    // In zoom mode (FineScanMode::zoom) each probe skips the FFT and
+    // evaluates only the kZoomBins bins its candidate can reach by direct
+    // DFT (kernels::dot_rows() against rows of twiddles), O(K·N) instead
+    // of O(N log N) per symbol.  Any peak outside those bins is ignored,
+    // which only changes the score of offsets that are not the preamble's.
+    HOST_SIM_TRACE_SPAN("align/fine");
     const int fine_stride = std::max(2, os / 2);
     const int fine_preamble_L1 = std::min(preamble_symbols, 4);
 
-    float best_mag_sum = -1.0f;
-    std::size_t best_offset = 0;
-    int best_bin = 0;
+    // Zoom probe: kZoomBins consecutive twiddle rows (n_bins each) for
+    // bins first_bin, first_bin + 1, … (mod N).
+    struct ZoomBins {
+        const std::complex<float>* rows;
+        int first_bin;
+    };
 
-    for (const auto& cand : top_candidates) {
-        if (cand.mag_sum < 0.0f) continue;  // unused slot
-        int fine_start = std::max(0, cand.offset - coarse_stride);
-        int fine_end = std::min(sps - 1, cand.offset + coarse_stride);
+    // Dominant accumulated peak magnitude over `n_syms` symbols at `offset`.
+    // With `keep_spectra`, the per-symbol FFTs are left in s.probe_spectra.
+    auto score_fine_offset = [&](ScanScratch& s, int offset, int n_syms,
+                                 bool keep_spectra, const ZoomBins* zoom_bins) -> OffsetScore {
+        std::fill(s.mag_per_bin.begin(), s.mag_per_bin.end(), 0.0f);
+        s.probe_symbols = 0;
+        for (int sym = 0; sym < n_syms; ++sym) {
+            std::size_t base_sample = static_cast<std::size_t>(offset) +
+                                      static_cast<std::size_t>(sym) * sps;
+            if (base_sample + sps > samples.size()) break;
+            float peak_mag = 0.0f;
+            int peak = 0;
+            if (zoom_bins) {
+                kernels::dechirp_fold(samples.data() + base_sample, downchirp.data(),
+                                      n_bins, os, 1, s.fft_in.data());
+                std::complex<float> values[kZoomBins];
+                kernels::dot_rows(s.fft_in.data(), zoom_bins->rows, n_bins, kZoomBins, values);
+                int best = 0;
+                peak_mag = -1.0f;
+                for (int k = 0; k < kZoomBins; ++k) {
+                    const float mag = std::norm(values[k]);
+                    if (mag > peak_mag) {
+                        peak_mag = mag;
+                        best = k;
+                    }
+                }
+                peak = (zoom_bins->first_bin + best) & (n_bins - 1);
+            } else {
+                std::complex<float>* fft_out =
+                    keep_spectra ? s.probe_spectra.data() + static_cast<std::size_t>(sym) * n_bins
+                                 : s.fft_out.data();
+                peak = dechirp_symbol(s, base_sample, fft_out, &peak_mag);
+            }
+            s.mag_per_bin[peak] += peak_mag;
+            ++s.probe_symbols;
+        }
 
-        // Level 1: coarse fine scan with stride
-        int l1_best_offset = fine_start;
-        float l1_best_mag = -1.0f;
+        OffsetScore score{};
+        for (int b = 0; b < n_bins; ++b) {
+            if (s.mag_per_bin[b] > score.mag) {
+                score.mag = s.mag_per_bin[b];
+                score.bin = b;
+            }
+        }
+        return score;
+    };
 
+    struct FineWindow {
+        int start;
+        int end;
+        int l1_best_offset;
+        int coarse_offset;
+        int coarse_bin;
+        std::size_t zoom_rows;   ///< First of kZoomRowsPerWindow rows in zoom_rows
+    };
+    struct FineProbe {
+        std::size_t window;
+        int offset;
+    };
+    std::pmr::vector<FineWindow> windows(memory);
+    std::pmr::vector<FineProbe> probes(memory);
+    for (const auto& cand : top_candidates) {
+        if (cand.mag_sum < 0.0f) continue;  // unused slot
+        const int fine_start = std::max(0, cand.offset - coarse_stride);
+        const int fine_end = std::min(sps - 1, cand.offset + coarse_stride);
         for (int offset = fine_start; offset <= fine_end; offset += fine_stride) {
-            std::vector<float> fine_mag_per_bin(n_bins, 0.0f);
+            probes.push_back({windows.size(), offset});
+        }
+        windows.push_back({fine_start, fine_end, fine_start, cand.offset, cand.bin, 0});
+    }
 
-            for (int sym = 0; sym < fine_preamble_L1; ++sym) {
-                std::size_t base_sample = static_cast<std::size_t>(offset) +
-                                          static_cast<std::size_t>(sym) * sps;
-                if (base_sample + sps > samples.size()) break;
-                float peak_mag = 0.0f;
-                int peak = dechirp_symbol(base_sample, &peak_mag);
-                fine_mag_per_bin[peak] += peak_mag;
+    // Twiddle rows for every window's reachable bins, shared between
+    // windows around the same coarse bin.
+    std::pmr::vector<std::complex<float>> zoom_rows(memory);
+    if (zoom) {
+        std::pmr::vector<std::complex<float>> twiddle(static_cast<std::size_t>(n_bins), memory);
+        for (int m = 0; m < n_bins; ++m) {
+            const double angle = -2.0 * M_PI * static_cast<double>(m) / n_bins;
+            twiddle[static_cast<std::size_t>(m)] = {static_cast<float>(std::cos(angle)),
+                                                    static_cast<float>(std::sin(angle))};
+        }
+        const std::size_t block = static_cast<std::size_t>(kZoomRowsPerWindow) * n_bins;
+        std::pmr::vector<int> block_bins(memory);
+        for (auto& w : windows) {
+            const auto shared = std::find(block_bins.begin(), block_bins.end(), w.coarse_bin);
+            if (shared != block_bins.end()) {
+                w.zoom_rows = static_cast<std::size_t>(shared - block_bins.begin()) * block;
+                continue;
             }
-
-            float dominant_mag = -1.0f;
-            for (int b = 0; b < n_bins; ++b) {
-                if (fine_mag_per_bin[b] > dominant_mag) {
-                    dominant_mag = fine_mag_per_bin[b];
+            w.zoom_rows = zoom_rows.size();
+            block_bins.push_back(w.coarse_bin);
+            zoom_rows.resize(zoom_rows.size() + block);
+            std::complex<float>* row = zoom_rows.data() + w.zoom_rows;
+            for (int r = 0; r < kZoomRowsPerWindow; ++r, row += n_bins) {
+                const int bin = (w.coarse_bin - kZoomReach - kZoomHalfWidth + r) & (n_bins - 1);
+                for (int n = 0, m = 0; n < n_bins; ++n, m = (m + bin) & (n_bins - 1)) {
+                    row[n] = twiddle[static_cast<std::size_t>(m)];
                 }
             }
+        }
+    }
+
+    // The zoom bins of a probe at `offset` in window `w`.
+    auto zoom_bins_for = [&](const FineWindow& w, int offset) -> ZoomBins {
+        const int diff = offset - w.coarse_offset;
+        const int half_chip = os / 2;
+        int shift = (diff >= 0 ? diff + half_chip : diff - half_chip) / os;
+        shift = std::clamp(shift, -kZoomReach, kZoomReach);
+        const int first_row = kZoomReach + shift;
+        return {zoom_rows.data() + w.zoom_rows + static_cast<std::size_t>(first_row) * n_bins,
+                (w.coarse_bin - kZoomReach - kZoomHalfWidth + first_row) & (n_bins - 1)};
+    };
 
-            if (dominant_mag > l1_best_mag) {
-                l1_best_mag = dominant_mag;
-                l1_best_offset = offset;
+    // Level 1: coarse fine scan with stride
+    std::pmr::vector<OffsetScore> probe_scores(probes.size(), memory);
+    for_each_offset(probes.size(), static_cast<std::size_t>(fine_preamble_L1),
+                    [&](std::size_t i, std::size_t worker) {
+        const ZoomBins bins = zoom ? zoom_bins_for(windows[probes[i].window], probes[i].offset) : ZoomBins{};
+        probe_scores[i] = score_fine_offset(worker_scratch(worker), probes[i].offset,
+                                            fine_preamble_L1, false, zoom ? &bins : nullptr);
+    });
+    {
+        std::pmr::vector<float> l1_best_mag(windows.size(), -1.0f, memory);
+        for (std::size_t i = 0; i < probes.size(); ++i) {
+            const std::size_t w = probes[i].window;
+            if (probe_scores[i].mag > l1_best_mag[w]) {
+                l1_best_mag[w] = probe_scores[i].mag;
+                windows[w].l1_best_offset = probes[i].offset;
             }
         }
+    }
 
-        // Level 2: refine around L1 winner, sample-by-sample, full preamble
-        const int l2_start = std::max(fine_start, l1_best_offset - fine_stride);
-        const int l2_end = std::min(fine_end, l1_best_offset + fine_stride);
-
+    // Level 2: refine around L1 winner, sample-by-sample, full preamble
+    probes.clear();
+    for (std::size_t w = 0; w < windows.size(); ++w) {
+        const int l2_start = std::max(windows[w].start, windows[w].l1_best_offset - fine_stride);
+        const int l2_end = std::min(windows[w].end, windows[w].l1_best_offset + fine_stride);
         for (int offset = l2_start; offset <= l2_end; ++offset) {
-            std::vector<float> fine_mag_per_bin(n_bins, 0.0f);
+            probes.push_back({w, offset});
+        }
+    }
+    //
+    // When spectra are wanted, each worker applies the selection rule below
+    // to the probes it scores (in increasing index order) and keeps the
+    // spectra of its own leader.  In a serial scan that leader is the
+    // overall winner; in a parallel one it usually is, and when it is not
+    // the caller simply recomputes them.
+    probe_scores.assign(probes.size(), OffsetScore{});
+    for_each_offset(probes.size(), static_cast<std::size_t>(preamble_symbols),
+                    [&](std::size_t i, std::size_t worker) {
+        ScanScratch& s = worker_scratch(worker);
+        const ZoomBins bins = zoom ? zoom_bins_for(windows[probes[i].window], probes[i].offset) : ZoomBins{};
+        probe_scores[i] = score_fine_offset(s, probes[i].offset, preamble_symbols,
+                                            spectra != nullptr && !zoom, zoom ? &bins : nullptr);
+        if (spectra && !zoom && probe_scores[i].mag > s.kept_mag * 1.001f) {
+            s.kept_mag = probe_scores[i].mag;
+            s.kept_probe = i;
+            s.kept_symbols = s.probe_symbols;
+            s.probe_spectra.swap(s.kept_spectra);
+        }
+    });
 
-            for (int sym = 0; sym < preamble_symbols; ++sym) {
-                std::size_t base_sample = static_cast<std::size_t>(offset) +
-                                          static_cast<std::size_t>(sym) * sps;
-                if (base_sample + sps > samples.size()) break;
-                float peak_mag = 0.0f;
-                int peak = dechirp_symbol(base_sample, &peak_mag);
-                fine_mag_per_bin[peak] += peak_mag;
-            }
+    float best_mag_sum = -1.0f;
+    std::size_t best_probe = SIZE_MAX;
+    std::size_t best_offset = 0;
+    int best_bin = 0;
+    for (std::size_t i = 0; i < probes.size(); ++i) {
+        if (probe_scores[i].mag > best_mag_sum * 1.001f) {
+            best_mag_sum = probe_scores[i].mag;
+            best_probe = i;
+            best_offset = static_cast<std::size_t>(probes[i].offset);
+            best_bin = probe_scores[i].bin;
+        }
+    }
 
-            int dominant_bin = 0;
-            float dominant_mag = -1.0f;
-            for (int b = 0; b < n_bins; ++b) {
-                if (fine_mag_per_bin[b] > dominant_mag) {
-                    dominant_mag = fine_mag_per_bin[b];
-                    dominant_bin = b;
+    if (spectra && !zoom && best_probe != SIZE_MAX) {
+        for (ScanScratch& s : scratch) {
+            if (s.kept_probe == best_probe && s.kept_symbols > 0) {
+                if (spectra->bins.get_allocator() == s.kept_spectra.get_allocator()) {
+                    spectra->bins.swap(s.kept_spectra);
+                } else {
+                    spectra->bins.assign(s.kept_spectra.begin(), s.kept_spectra.end());
                 }
-            }
-
-            if (dominant_mag > best_mag_sum * 1.001f) {
-                best_mag_sum = dominant_mag;
-                best_offset = static_cast<std::size_t>(offset);
-                best_bin = dominant_bin;
+                spectra->bins.resize(static_cast<std::size_t>(s.kept_symbols) *
+                                     static_cast<std::size_t>(n_bins));
+                spectra->symbols = s.kept_symbols;
+                spectra->offset = best_offset;
             }
         }
     }
 
-    free(cfg);
-
     result.alignment_offset = best_offset;
     result.preamble_bin = best_bin;
     result.score = static_cast<int>(best_mag_sum > 0.0f ? preamble_symbols : 0);
@@ -0,0 +1,333 @@
+#include "host_sim/burst_detector.hpp"
+#include "host_sim/trace.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+// ── BurstIndex ──
+
+BurstIndex::BurstIndex(const std::complex<float>* samples, std::size_t n_samples, std::size_t window,
+                       float threshold_factor, int min_consec)
+    : window_(window), threshold_factor_(threshold_factor), min_consec_(std::max(1, min_consec)),
+      n_samples_(n_samples)
+{
+    if (window_ == 0) {
+        throw std::runtime_error("BurstIndex window must be positive");
+    }
+    if (samples == nullptr) {
+        return;
+    }
+    HOST_SIM_TRACE_SPAN("burst_detect");
+    const std::size_t n_windows = n_samples / window_;
+    powers_.resize(n_windows);
+    for (std::size_t w = 0; w < n_windows; ++w) {
+        const auto* p = samples + w * window_;
+        double acc = 0.0;
+        for (std::size_t i = 0; i < window_; ++i) {
+            acc += static_cast<double>(p[i].real()) * p[i].real() +
+                   static_cast<double>(p[i].imag()) * p[i].imag();
+        }
+        powers_[w] = static_cast<float>(acc / static_cast<double>(window_));
+    }
+    if (n_windows == 0) {
+        return;
+    }
+
+    // Mean of the lowest quartile, summed in ascending order as a full
+    // sort would, but only the quartile itself gets sorted.
+    std::vector<float> sorted(powers_);
+    const std::size_t q1_end = std::max<std::size_t>(1, n_windows / 4);
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(q1_end - 1), sorted.end());
+    std::sort(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(q1_end));
+    double noise_acc = 0.0;
+    for (std::size_t i = 0; i < q1_end; ++i) {
+        noise_acc += sorted[i];
+    }
+    noise_floor_ = static_cast<float>(noise_acc / static_cast<double>(q1_end));
+}
+
+std::optional<BurstDetectResult> BurstIndex::find_start(std::size_t search_from, float prior_noise) const
+{
+    const std::size_t n_windows = powers_.size();
+    if (n_windows < 3) {
+        return std::nullopt;
+    }
+    const std::size_t start_window = search_from / window_;
+    if (start_window >= n_windows) {
+        return std::nullopt;
+    }
+    // EMA blend with a caller-supplied prior: 70% prior, 30% fresh.
+    const float noise = prior_noise > 0.0f ? 0.7f * prior_noise + 0.3f * noise_floor_ : noise_floor_;
+    const float threshold = noise * threshold_factor_;
+
+    int consec = 0;
+    std::size_t first_high = 0;
+    for (std::size_t w = start_window; w < n_windows; ++w) {
+        if (powers_[w] <= threshold) {
+            consec = 0;
+            continue;
+        }
+        if (consec == 0) {
+            first_high = w;
+        }
+        if (++consec < min_consec_) {
+            continue;
+        }
+        // Back off up to two windows to catch the ramp-up, never before
+        // the search origin.
+        const std::size_t margin = std::min<std::size_t>(2, first_high - start_window);
+        BurstDetectResult r;
+        r.burst_start = (first_high - margin) * window_;
+        r.noise_floor = noise;
+        r.signal_power = powers_[first_high];
+        return r;
+    }
+    return std::nullopt;
+}
+
+std::vector<BurstInterval> BurstIndex::bursts(std::size_t tail_windows, std::size_t tail_margin) const
+{
+    std::vector<BurstInterval> out;
+    const std::size_t n_windows = powers_.size();
+    const float threshold = noise_floor_ * threshold_factor_;
+    std::size_t from = 0;
+    while (const auto start = find_start(from)) {
+        BurstInterval burst;
+        burst.start = start->burst_start;
+        burst.signal_power = start->signal_power;
+        std::size_t end_window = n_windows;
+        std::size_t quiet_run = 0;
+        for (std::size_t w = burst.start / window_; w < n_windows; ++w) {
+            if (powers_[w] > threshold) {
+                quiet_run = 0;
+            } else if (++quiet_run >= tail_windows) {
+                end_window = w - tail_windows + 1;
+                burst.complete = true;
+                break;
+            }
+        }
+        burst.end = std::min((end_window + tail_margin) * window_, n_samples_);
+        out.push_back(burst);
+        if (!burst.complete) {
+            break;
+        }
+        from = std::max(burst.end, burst.start + window_);
+    }
+    return out;
+}
+
+// ── BurstDetector ──
+
+BurstDetector::BurstDetector(std::size_t window, float threshold_factor, int min_consec)
+    : window_(window), threshold_factor_(threshold_factor), min_consec_(std::max(1, min_consec))
+{
+    if (window_ == 0) {
+        throw std::runtime_error("BurstDetector window must be positive");
+    }
+}
+
+void BurstDetector::reset()
+{
+    consumed_ = 0;
+    seen_ = 0;
+    first_window_ = 0;
+    powers_.clear();
+    partial_acc_ = 0.0;
+    low_.clear();
+    high_.clear();
+    low_sum_ = 0.0;
+}
+
+void BurstDetector::update(const std::complex<float>* buffer, std::size_t available)
+{
+    const std::uint64_t end = consumed_ + available;
+    while (seen_ < end) {
+        // Accumulate up to the next window boundary, then close it.
+        const std::uint64_t boundary = (seen_ / window_ + 1) * window_;
+        const std::uint64_t stop = std::min(boundary, end);
+        const auto* p = buffer + (seen_ - consumed_);
+        double acc = partial_acc_;
+        for (std::uint64_t i = seen_; i < stop; ++i, ++p) {
+            acc += static_cast<double>(p->real()) * p->real() +
+                   static_cast<double>(p->imag()) * p->imag();
+        }
+        seen_ = stop;
+        if (stop < boundary) {
+            partial_acc_ = acc;
+            break;
+        }
+        partial_acc_ = 0.0;
+
+        // A window whose head was consumed before it closed is dropped.
+        const std::uint64_t index = boundary / window_ - 1;
+        if (index * window_ < consumed_) {
+            first_window_ = index + 1;
+            continue;
+        }
+        if (powers_.empty()) {
+            first_window_ = index;
+        }
+        const float power = static_cast<float>(acc / static_cast<double>(window_));
+        powers_.push_back(power);
+        insert_power(power);
+    }
+}
+
+void BurstDetector::consume(std::size_t n)
+{
+    consumed_ += n;
+    while (!powers_.empty() && first_window_ * window_ < consumed_) {
+        const float power = powers_.front();
+        powers_.pop_front();
+        ++first_window_;
+        erase_power(power);
+    }
+    if (seen_ < consumed_) {
+        // Skipped samples were never read; the window they fall in is
+        // incomplete and will be dropped when it closes.
+        seen_ = consumed_;
+        partial_acc_ = 0.0;
+    }
+}
+
+float BurstDetector::noise_floor() const
+{
+    if (low_.empty()) {
+        return 0.0f;
+    }
+    return static_cast<float>(low_sum_ / static_cast<double>(low_.size()));
+}
+
+std::optional<BurstDetectResult> BurstDetector::find_start(std::size_t search_from,
+                                                           float prior_noise) const
+{
+    const std::size_t n_windows = powers_.size();
+    if (n_windows < 3) {
+        return std::nullopt;
+    }
+    const std::size_t start_window = window_index(search_from);
+    if (start_window >= n_windows) {
+        return std::nullopt;
+    }
+
+    const float fresh = noise_floor();
+    const float noise = prior_noise > 0.0f ? 0.7f * prior_noise + 0.3f * fresh : fresh;
+    const float threshold = noise * threshold_factor_;
+
+    int consec = 0;
+    std::size_t first_high = 0;
+    for (std::size_t w = start_window; w < n_windows; ++w) {
+        if (powers_[w] <= threshold) {
+            consec = 0;
+            continue;
+        }
+        if (consec == 0) {
+            first_high = w;
+        }
+        if (++consec < min_consec_) {
+            continue;
+        }
+        // Back off up to two windows to catch the ramp-up, never before
+        // the search origin.
+        const std::size_t margin = std::min<std::size_t>(2, first_high - start_window);
+        BurstDetectResult r;
+        r.burst_start = window_start(first_high - margin);
+        r.noise_floor = noise;
+        r.signal_power = powers_[first_high];
+        return r;
+    }
+    return std::nullopt;
+}
+
+BurstExtent BurstDetector::find_end(std::size_t start, float noise_floor, std::size_t tail_windows,
+                                    std::size_t tail_margin) const
+{
+    const std::size_t n_windows = powers_.size();
+    const float threshold = noise_floor * threshold_factor_;
+    const std::size_t buffered = static_cast<std::size_t>(seen_ - consumed_);
+
+    BurstExtent extent;
+    std::size_t end_window = n_windows;
+    std::size_t quiet_run = 0;
+    for (std::size_t w = window_index(start); w < n_windows; ++w) {
+        const float wp = powers_[w];
+        if (wp > threshold) {
+            extent.power_acc += wp;
+            ++extent.power_count;
+            quiet_run = 0;
+            continue;
+        }
+        if (++quiet_run >= tail_windows) {
+            end_window = w - tail_windows + 1;
+            extent.complete = true;
+            break;
+        }
+    }
+    const std::size_t end_sample = end_window < n_windows ? window_start(end_window)
+                                 : n_windows > 0          ? window_start(n_windows - 1) + window_
+                                                          : 0;
+    extent.end = std::min(end_sample + tail_margin * window_, buffered);
+    return extent;
+}
+
+std::size_t BurstDetector::window_start(std::size_t i) const
+{
+    return static_cast<std::size_t>((first_window_ + i) * window_ - consumed_);
+}
+
+std::size_t BurstDetector::window_index(std::size_t sample) const
+{
+    if (powers_.empty() || sample <= window_start(0)) {
+        return 0;
+    }
+    return (sample - window_start(0)) / window_;
+}
+
+void BurstDetector::insert_power(float p)
+{
+    if (low_.empty() || p <= *low_.rbegin()) {
+        low_.insert(p);
+        low_sum_ += p;
+    } else {
+        high_.insert(p);
+    }
+    rebalance();
+}
+
+void BurstDetector::erase_power(float p)
+{
+    if (!low_.empty() && p <= *low_.rbegin()) {
+        low_.erase(low_.find(p));
+        low_sum_ -= p;
+    } else {
+        high_.erase(high_.find(p));
+    }
+    if (low_.empty() && high_.empty()) {
+        // Reset so rounding drift cannot outlive the windows it came from.
+        low_sum_ = 0.0;
+    }
+    rebalance();
+}
+
+void BurstDetector::rebalance()
+{
+    const std::size_t target = std::max<std::size_t>(1, powers_.size() / 4);
+    while (low_.size() > target) {
+        const auto it = std::prev(low_.end());
+        low_sum_ -= *it;
+        high_.insert(*it);
+        low_.erase(it);
+    }
+    while (low_.size() < target && !high_.empty()) {
+        const auto it = high_.begin();
+        low_sum_ += *it;
+        low_.insert(*it);
+        high_.erase(it);
+    }
+}
+
+} // namespace host_sim
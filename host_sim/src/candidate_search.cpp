@@ -0,0 +1,46 @@
+#include "host_sim/candidate_search.hpp"
+
+#include "host_sim/trace.hpp"
+
+#include <limits>
+
+namespace host_sim
+{
+
+namespace
+{
+
+constexpr std::size_t kNoWinner = std::numeric_limits<std::size_t>::max();
+
+} // namespace
+
+std::size_t candidate_search_workers()
+{
+    return WorkerPool::shared().worker_count();
+}
+
+std::optional<std::size_t> find_first_candidate(std::size_t count, const CandidateProbe& probe)
+{
+    std::atomic<std::size_t> winner{kNoWinner};
+    WorkerPool::shared().parallel_for(count, [&](std::size_t index, std::size_t worker) {
+        if (index > winner.load(std::memory_order_relaxed)) {
+            return;
+        }
+        HOST_SIM_TRACE_COUNT(candidates, 1);
+        if (!probe(CandidateContext(index, worker, winner))) {
+            return;
+        }
+        std::size_t best = winner.load(std::memory_order_relaxed);
+        while (index < best &&
+               !winner.compare_exchange_weak(best, index, std::memory_order_relaxed)) {
+        }
+    });
+
+    const std::size_t best = winner.load();
+    if (best == kNoWinner) {
+        return std::nullopt;
+    }
+    return best;
+}
+
+} // namespace host_sim
@@ -1,18 +1,32 @@
 #include "host_sim/capture.hpp"
 
+#include "host_sim/dsp_kernels.hpp"
+#include "host_sim/iq_ring_buffer.hpp"
+#include "host_sim/iq_source.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <stdexcept>
+#include <utility>
 
 #ifdef _WIN32
 #include <fcntl.h>
 #include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 namespace host_sim
@@ -39,7 +53,87 @@ std::vector<std::complex<float>> load_cf32(const std::filesystem::path& file_pat
     return samples;
 }
 
-CaptureStats analyse_capture(const std::vector<std::complex<float>>& samples)
+// ── MappedCapture ────────────────────────────────────────────────
+
+MappedCapture::MappedCapture(const std::filesystem::path& file_path)
+{
+    if (!std::filesystem::exists(file_path)) {
+        throw std::runtime_error("CF32 file not found: " + file_path.string());
+    }
+
+    const auto file_size = std::filesystem::file_size(file_path);
+    if (file_size % (sizeof(float) * 2) != 0) {
+        throw std::runtime_error("CF32 file size is not a multiple of complex float width");
+    }
+    if (file_size == 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    fallback_ = load_cf32(file_path);
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+#else
+    const int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open CF32 file for reading: " + file_path.string());
+    }
+    void* mapping = ::mmap(nullptr, static_cast<std::size_t>(file_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Unable to memory-map CF32 file: " + file_path.string());
+    }
+    ::madvise(mapping, static_cast<std::size_t>(file_size), MADV_SEQUENTIAL);
+
+    mapping_ = mapping;
+    mapping_bytes_ = static_cast<std::size_t>(file_size);
+    data_ = static_cast<const std::complex<float>*>(mapping);
+    size_ = mapping_bytes_ / sizeof(std::complex<float>);
+#endif
+}
+
+MappedCapture::~MappedCapture()
+{
+    unmap();
+}
+
+MappedCapture::MappedCapture(MappedCapture&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedCapture& MappedCapture::operator=(MappedCapture&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        fallback_ = std::move(other.fallback_);
+        data_ = other.mapping_ ? other.data_ : fallback_.data();
+        size_ = other.size_;
+        mapping_ = other.mapping_;
+        mapping_bytes_ = other.mapping_bytes_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapping_ = nullptr;
+        other.mapping_bytes_ = 0;
+    }
+    return *this;
+}
+
+void MappedCapture::unmap()
+{
+#ifndef _WIN32
+    if (mapping_) {
+        ::munmap(mapping_, mapping_bytes_);
+    }
+#endif
+    mapping_ = nullptr;
+    mapping_bytes_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+    fallback_.clear();
+}
+
+CaptureStats analyse_capture(std::span<const std::complex<float>> samples)
 {
     CaptureStats stats;
     stats.sample_count = samples.size();
@@ -99,22 +193,27 @@ std::vector<std::complex<float>> load_cf32_stdin()
     return samples;
 }
 
-std::vector<std::complex<float>> load_hackrf_stdin()
+namespace
+{
+
+/// Read interleaved integer IQ from stdin until EOF and convert it with
+/// @p convert, one 64K-sample chunk at a time.
+template <typename T, typename Convert>
+std::vector<std::complex<float>> load_integer_stdin(Convert convert)
 {
     set_stdin_binary();
-    constexpr std::size_t chunk_bytes = 131072; // 64K complex samples per read
+    constexpr std::size_t chunk_samples = 65536;
     std::vector<std::complex<float>> samples;
-    std::vector<int8_t> buf(chunk_bytes);
+    std::vector<T> buf(chunk_samples * 2);
 
     while (true) {
-        const auto n = std::fread(buf.data(), 1, chunk_bytes, stdin);
+        const auto n = std::fread(buf.data(), sizeof(T), buf.size(), stdin);
         if (n == 0) break;
-        const auto pairs = (n / 2) * 2;
-        for (std::size_t i = 0; i < pairs; i += 2) {
-            samples.emplace_back(
-                static_cast<float>(buf[i]) / 128.0F,
-                static_cast<float>(buf[i + 1]) / 128.0F);
-        }
+        // Ensure pairs (drop trailing lone component if any)
+        const std::size_t pairs = n / 2;
+        const std::size_t old_size = samples.size();
+        samples.resize(old_size + pairs);
+        convert(buf.data(), pairs, samples.data() + old_size);
     }
     if (samples.empty()) {
         throw std::runtime_error("No IQ samples read from stdin");
@@ -122,79 +221,320 @@ std::vector<std::complex<float>> load_hackrf_stdin()
     return samples;
 }
 
+} // namespace
+
+std::vector<std::complex<float>> load_hackrf_stdin()
+{
+    return load_integer_stdin<int8_t>(kernels::int8_to_cf32);
+}
+
+std::vector<std::complex<float>> load_sc16_stdin()
+{
+    return load_integer_stdin<int16_t>(kernels::int16_to_cf32);
+}
+
+std::vector<Q15Complex> load_q15(const std::filesystem::path& file_path, IqFormat format)
+{
+    if (format == IqFormat::cf32) {
+        const auto samples = load_cf32(file_path);
+        std::vector<Q15Complex> out(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            out[i] = float_to_q15_complex(samples[i].real(), samples[i].imag());
+        }
+        return out;
+    }
+
+    if (!std::filesystem::exists(file_path)) {
+        throw std::runtime_error("IQ file not found: " + file_path.string());
+    }
+    const std::size_t component = (format == IqFormat::hackrf_int8) ? 1 : 2;
+    const auto file_size = std::filesystem::file_size(file_path);
+    if (file_size % (component * 2) != 0) {
+        throw std::runtime_error("IQ file size is not a multiple of the complex sample width");
+    }
+    std::ifstream input(file_path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("Unable to open IQ file for reading: " + file_path.string());
+    }
+
+    std::vector<Q15Complex> out(file_size / (component * 2));
+    static_assert(sizeof(Q15Complex) == 2 * sizeof(int16_t), "Q15Complex must be two packed int16");
+    if (format == IqFormat::sc16) {
+        // sc16 already is Q15: read it in place.
+        input.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(file_size));
+    } else {
+        std::vector<int8_t> raw(static_cast<std::size_t>(file_size));
+        input.read(reinterpret_cast<char*>(raw.data()), static_cast<std::streamsize>(file_size));
+        kernels::int8_to_q15(raw.data(), out.size(), reinterpret_cast<int16_t*>(out.data()));
+    }
+    return out;
+}
+
 // ── StreamingIqReader ────────────────────────────────────────────
 
-StreamingIqReader::StreamingIqReader(IqFormat format, std::size_t chunk_samples)
-    : format_(format), chunk_samples_(chunk_samples)
+struct StreamingIqReader::Shared
 {
-    if (format_ == IqFormat::hackrf_int8) {
-        hackrf_scratch_.resize(chunk_samples_ * 2);
+    Shared(std::size_t capacity, std::unique_ptr<IqSource> source_in)
+        : ring(capacity), source(std::move(source_in))
+    {
     }
+
+    /// Source time of ring sample `sample`.
+    struct TimeMark
+    {
+        std::uint64_t sample;
+        std::int64_t time_ns;
+    };
+
+    /// Record a timestamp.  A mark on the line through the two before it
+    /// (a continuous stream at a steady rate) replaces the last one, so
+    /// marks only accumulate where the timeline breaks.
+    void add_mark(std::uint64_t sample, std::int64_t time_ns)
+    {
+        constexpr std::size_t kMaxMarks = 1024;
+        constexpr double kToleranceNs = 1000.0;
+        std::lock_guard<std::mutex> lock(marks_mutex);
+        if (marks.size() >= 2) {
+            const TimeMark& a = marks[marks.size() - 2];
+            const TimeMark& b = marks.back();
+            const double slope = static_cast<double>(b.time_ns - a.time_ns) / static_cast<double>(b.sample - a.sample);
+            const double predicted = static_cast<double>(b.time_ns) + slope * static_cast<double>(sample - b.sample);
+            if (std::abs(predicted - static_cast<double>(time_ns)) < kToleranceNs) {
+                marks.back() = {sample, time_ns};
+                return;
+            }
+        }
+        if (!marks.empty() && marks.back().sample == sample) {
+            marks.back().time_ns = time_ns;
+            return;
+        }
+        marks.push_back({sample, time_ns});
+        if (marks.size() > kMaxMarks) {
+            marks.pop_front();
+        }
+    }
+
+    IqRingBuffer ring;
+    std::unique_ptr<IqSource> source;
+    // Bumped on every publish / consume so the other side can block in
+    // std::atomic::wait() without a lock.
+    std::atomic<std::uint32_t> produced{0};
+    std::atomic<std::uint32_t> consumed{0};
+    std::atomic<bool> done{false};
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> overflows{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> source_overflows{0};
+    std::atomic<std::uint64_t> source_lost{0};
+    std::exception_ptr error;   ///< Written by the I/O thread before `done`
+    mutable std::mutex marks_mutex;
+    std::deque<TimeMark> marks;
+};
+
+namespace
+{
+
+void bump(std::atomic<std::uint32_t>& seq)
+{
+    seq.fetch_add(1, std::memory_order_release);
+    seq.notify_all();
 }
 
-std::size_t StreamingIqReader::read_chunk()
+} // namespace
+
+/// I/O thread body: read blocks from the source, convert them and push
+/// them into the ring until the source ends or stop.
+void StreamingIqReader::io_main(std::shared_ptr<Shared> shared, std::size_t chunk_samples,
+                                OverflowPolicy policy, std::optional<Decimator> front_end)
 {
-    if (eof_) return 0;
-    if (!binary_set_) {
-        set_stdin_binary();
-        binary_set_ = true;
+    // chunk_samples counts ring (output) samples; read the matching
+    // number of source samples when decimating.
+    std::vector<std::complex<float>> decimated;
+    if (front_end) {
+        decimated.resize(front_end->max_output(chunk_samples * front_end->factor()));
+        chunk_samples *= front_end->factor();
     }
+    std::vector<std::complex<float>> block(chunk_samples);
+    std::uint64_t ring_index = 0;   // ring samples produced, pushed or dropped
 
-    const std::size_t before = buffer_.size();
+    try {
+        while (!shared->stop.load(std::memory_order_relaxed)) {
+            const IqSourceRead got = shared->source->read(block.data(), chunk_samples);
+            if (got.overflow) {
+                shared->source_overflows.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (got.lost_samples > 0) {
+                shared->source_lost.fetch_add(got.lost_samples, std::memory_order_relaxed);
+            }
 
-    if (format_ == IqFormat::hackrf_int8) {
-        // 2 int8 bytes per complex sample — use persistent scratch buffer
-        const std::size_t nbytes = chunk_samples_ * 2;
-        const auto n = std::fread(hackrf_scratch_.data(), 1, nbytes, stdin);
-        if (n == 0) { eof_ = true; return 0; }
-        const auto pairs = (n / 2) * 2;
-        buffer_.reserve(buffer_.size() + pairs / 2);
-        for (std::size_t i = 0; i < pairs; i += 2) {
-            buffer_.emplace_back(
-                static_cast<float>(hackrf_scratch_[i]) / 128.0F,
-                static_cast<float>(hackrf_scratch_[i + 1]) / 128.0F);
+            std::size_t count = got.samples;
+            const std::complex<float>* ready = block.data();
+            if (front_end) {
+                count = front_end->process(block.data(), count, decimated.data());
+                ready = decimated.data();
+            }
+            if (got.time_ns && got.samples > 0) {
+                shared->add_mark(ring_index, *got.time_ns);
+            }
+            ring_index += count;
+
+            std::size_t pushed = 0;
+            bool stalled = false;
+            while (pushed < count) {
+                const std::uint32_t seen = shared->consumed.load(std::memory_order_acquire);
+                const std::size_t n = shared->ring.push(ready + pushed, count - pushed);
+                if (n > 0) {
+                    pushed += n;
+                    bump(shared->produced);
+                    continue;
+                }
+                if (!stalled) {
+                    shared->overflows.fetch_add(1, std::memory_order_relaxed);
+                    stalled = true;
+                }
+                if (policy == OverflowPolicy::drop) {
+                    shared->dropped.fetch_add(count - pushed, std::memory_order_relaxed);
+                    break;
+                }
+                if (shared->stop.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                shared->consumed.wait(seen, std::memory_order_acquire);
+            }
+
+            if (got.end) {
+                break;
+            }
         }
-        if (n < nbytes) eof_ = true;
-    } else {
-        // cf32: read directly into buffer (complex<float> is layout-compatible
-        // with float[2] per C++11 §26.4/4).
-        const std::size_t old_size = buffer_.size();
-        buffer_.resize(old_size + chunk_samples_);
-        const auto n = std::fread(
-            reinterpret_cast<float*>(buffer_.data() + old_size),
-            sizeof(float), chunk_samples_ * 2, stdin);
-        const auto samples_read = n / 2;
-        buffer_.resize(old_size + samples_read);
-        if (n == 0) { eof_ = true; buffer_.resize(old_size); return 0; }
-        if (n < chunk_samples_ * 2) eof_ = true;
+    } catch (...) {
+        // Surfaces from read_chunk() once the samples before it are read.
+        shared->error = std::current_exception();
     }
 
-    return buffer_.size() - before;
+    shared->done.store(true, std::memory_order_release);
+    bump(shared->produced);
 }
 
-void StreamingIqReader::consume(std::size_t n)
+StreamingIqReader::StreamingIqReader(IqFormat format, std::size_t chunk_samples,
+                                     std::size_t capacity_samples, OverflowPolicy policy,
+                                     std::FILE* source, std::optional<Decimator> front_end)
+    : chunk_samples_(std::max<std::size_t>(1, chunk_samples))
+{
+    IqSourceSpec spec;
+    spec.format = format;
+    start(open_iq_source(spec, source), capacity_samples, policy, std::move(front_end));
+}
+
+StreamingIqReader::StreamingIqReader(std::unique_ptr<IqSource> source, std::size_t chunk_samples,
+                                     std::size_t capacity_samples, OverflowPolicy policy,
+                                     std::optional<Decimator> front_end)
+    : chunk_samples_(std::max<std::size_t>(1, chunk_samples))
+{
+    start(std::move(source), capacity_samples, policy, std::move(front_end));
+}
+
+void StreamingIqReader::start(std::unique_ptr<IqSource> source, std::size_t capacity_samples,
+                              OverflowPolicy policy, std::optional<Decimator> front_end)
+{
+    const std::size_t capacity =
+        capacity_samples > 0 ? std::max(capacity_samples, chunk_samples_) : chunk_samples_ * 64;
+    source_name_ = source->describe();
+    shared_ = std::make_shared<Shared>(capacity, std::move(source));
+    io_thread_ = std::thread(&StreamingIqReader::io_main, shared_, chunk_samples_, policy, std::move(front_end));
+}
+
+StreamingIqReader::~StreamingIqReader()
 {
-    const std::size_t avail = buffer_.size() - offset_;
-    if (n >= avail) {
-        buffer_.clear();
-        offset_ = 0;
+    shared_->stop.store(true, std::memory_order_relaxed);
+    bump(shared_->consumed);
+    if (shared_->done.load(std::memory_order_acquire) || shared_->source->interrupt()) {
+        io_thread_.join();
     } else {
-        offset_ += n;
-        // Compact when the dead zone exceeds half the total allocation.
-        if (offset_ > buffer_.size() / 2) {
-            compact();
+        // Blocked in fread() on a source that has not closed yet.  The
+        // thread holds its own reference to the ring and exits on its
+        // next read.
+        io_thread_.detach();
+    }
+}
+
+std::size_t StreamingIqReader::read_chunk()
+{
+    if (eof_) return 0;
+
+    bool done = false;
+    std::size_t ready = 0;
+    for (;;) {
+        const std::uint32_t seen = shared_->produced.load(std::memory_order_acquire);
+        done = shared_->done.load(std::memory_order_acquire);
+        ready = shared_->ring.readable() - available_;
+        if (ready >= chunk_samples_ || done || available_ + ready >= capacity()) {
+            break;
         }
+        shared_->produced.wait(seen, std::memory_order_acquire);
     }
+
+    const std::size_t n = std::min(ready, chunk_samples_);
+    available_ += n;
+    // Mirror a blocking fread(): EOF shows up with the first short chunk.
+    if (done && n == ready && n < chunk_samples_) {
+        eof_ = true;
+        if (shared_->error) {
+            std::rethrow_exception(shared_->error);
+        }
+    }
+    return n;
+}
+
+const std::complex<float>* StreamingIqReader::data() const
+{
+    return shared_->ring.read_ptr();
+}
+
+void StreamingIqReader::consume(std::size_t n)
+{
+    n = std::min(n, available_);
+    shared_->ring.consume(n);
+    available_ -= n;
+    consumed_ += n;
+    bump(shared_->consumed);
 }
 
-void StreamingIqReader::compact()
+std::size_t StreamingIqReader::capacity() const
 {
-    if (offset_ == 0) return;
-    const std::size_t live = buffer_.size() - offset_;
-    std::memmove(buffer_.data(), buffer_.data() + offset_,
-                 live * sizeof(std::complex<float>));
-    buffer_.resize(live);
-    offset_ = 0;
+    return shared_->ring.capacity();
+}
+
+std::uint64_t StreamingIqReader::overflows() const
+{
+    return shared_->overflows.load(std::memory_order_relaxed);
+}
+
+std::uint64_t StreamingIqReader::dropped_samples() const
+{
+    return shared_->dropped.load(std::memory_order_relaxed);
+}
+
+std::uint64_t StreamingIqReader::source_overflows() const
+{
+    return shared_->source_overflows.load(std::memory_order_relaxed);
+}
+
+std::uint64_t StreamingIqReader::source_lost_samples() const
+{
+    return shared_->source_lost.load(std::memory_order_relaxed);
+}
+
+std::optional<std::int64_t> StreamingIqReader::timestamp_ns(std::uint64_t index, double sample_rate) const
+{
+    std::lock_guard<std::mutex> lock(shared_->marks_mutex);
+    const auto& marks = shared_->marks;
+    auto after = std::upper_bound(marks.begin(), marks.end(), index,
+                                  [](std::uint64_t i, const Shared::TimeMark& m) { return i < m.sample; });
+    if (after == marks.begin() || !(sample_rate > 0.0)) {
+        return std::nullopt;
+    }
+    const Shared::TimeMark& mark = *std::prev(after);
+    return mark.time_ns + std::llround(static_cast<double>(index - mark.sample) * 1e9 / sample_rate);
 }
 
 } // namespace host_sim
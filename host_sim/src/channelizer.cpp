@@ -0,0 +1,234 @@
+#include "host_sim/channelizer.hpp"
+
+#include "host_sim/fft_backend.hpp"
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+
+namespace host_sim
+{
+
+namespace
+{
+
+// Outputs per pool task in channelize(); large enough that the fold and
+// FFT dominate the hand-off.
+constexpr std::size_t kBlockOutputs = 2048;
+
+std::size_t next_pow2(std::size_t v)
+{
+    std::size_t p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+} // namespace
+
+PolyphaseChannelizer::PolyphaseChannelizer(double input_rate, double output_rate, double bandwidth,
+                                           std::vector<double> channel_offsets)
+{
+    if (input_rate <= 0.0 || output_rate <= 0.0 || bandwidth <= 0.0) {
+        throw std::runtime_error("Channelizer rates must be positive");
+    }
+    const double ratio = input_rate / output_rate;
+    decimation_ = static_cast<std::size_t>(std::llround(ratio));
+    if (decimation_ < 1 || std::abs(ratio - static_cast<double>(decimation_)) > 1e-6 * ratio) {
+        throw std::runtime_error("Channelizer output rate " + std::to_string(output_rate) +
+                                 " Hz must divide the input rate " + std::to_string(input_rate) + " Hz");
+    }
+    if (bandwidth >= output_rate) {
+        throw std::runtime_error("Channelizer needs an oversampled output (sample_rate > bw)");
+    }
+
+    // Bins at most half the guard band apart, so snapping a channel to its
+    // bin leaves a residual the prototype still passes.
+    const double guard = output_rate - bandwidth;
+    branches_ = std::max<std::size_t>(2, next_pow2(static_cast<std::size_t>(std::ceil(2.0 * input_rate / guard))));
+    const double bin_hz = input_rate / static_cast<double>(branches_);
+
+    // Pass |f| <= (bandwidth + bin) / 2; stop from output_rate minus that,
+    // the first frequency that folds back into the passband.
+    const double transition = guard - bin_hz;
+    const std::size_t min_taps = static_cast<std::size_t>(std::ceil(5.5 * input_rate / transition));
+    const std::size_t per_branch = std::max<std::size_t>(1, (min_taps + branches_ - 1) / branches_);
+    const std::size_t n_taps = per_branch * branches_;
+
+    // Blackman-windowed sinc with cutoff output_rate / 2, unit DC gain.
+    std::vector<double> h(n_taps);
+    const double fc = 0.5 * output_rate / input_rate;
+    const double mid = 0.5 * static_cast<double>(n_taps - 1);
+    double sum = 0.0;
+    for (std::size_t l = 0; l < n_taps; ++l) {
+        const double t = static_cast<double>(l) - mid;
+        const double x = 2.0 * std::numbers::pi * fc * t;
+        const double sinc = (t == 0.0) ? 2.0 * fc : std::sin(x) / (std::numbers::pi * t);
+        const double phase = 2.0 * std::numbers::pi * static_cast<double>(l) / static_cast<double>(n_taps - 1);
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        h[l] = sinc * window;
+        sum += h[l];
+    }
+    // Time-reversed so the fold is a straight multiply over the input
+    // window (oldest first), duplicated per I/Q lane.
+    taps_.resize(2 * n_taps);
+    for (std::size_t j = 0; j < n_taps; ++j) {
+        const auto g = static_cast<float>(h[n_taps - 1 - j] / sum);
+        taps_[2 * j] = g;
+        taps_[2 * j + 1] = g;
+    }
+
+    const double limit = 0.5 * (input_rate - bandwidth);
+    for (const double offset : channel_offsets) {
+        if (std::abs(offset) > limit) {
+            throw std::runtime_error("Channel offset " + std::to_string(offset) +
+                                     " Hz is outside the captured band");
+        }
+        const auto k = static_cast<long long>(std::llround(offset / bin_hz));
+        Channel ch;
+        ch.offset_hz = offset;
+        const auto m = static_cast<long long>(branches_);
+        ch.bin = static_cast<std::size_t>(((k % m) + m) % m);
+        const double residual = offset - static_cast<double>(k) * bin_hz;
+        ch.nco_step = -2.0 * std::numbers::pi * residual * static_cast<double>(decimation_) / input_rate;
+        channels_.push_back(ch);
+    }
+
+    plan_ = &fft_plan(static_cast<int>(branches_));
+    scratch_ = make_scratch();
+    reset();
+}
+
+std::size_t PolyphaseChannelizer::output_count(std::size_t n_input) const
+{
+    return n_input == 0 ? 0 : (n_input - 1) / decimation_ + 1;
+}
+
+PolyphaseChannelizer::Scratch PolyphaseChannelizer::make_scratch() const
+{
+    Scratch s;
+    s.fold.resize(2 * branches_);
+    s.fft_in.resize(branches_);
+    s.fft_out.resize(branches_);
+    return s;
+}
+
+void PolyphaseChannelizer::reset()
+{
+    history_.assign(taps() - 1, std::complex<float>{});
+    consumed_ = 0;
+}
+
+void PolyphaseChannelizer::compute_output(const std::complex<float>* window, std::uint64_t n,
+                                          Scratch& scratch,
+                                          std::vector<std::vector<std::complex<float>>>& out,
+                                          std::size_t index) const
+{
+    // a[q] = sum over taps j ≡ q (mod M) of g[j] * x[j]: one multiply per
+    // tap over contiguous floats.
+    const std::size_t lanes = 2 * branches_;
+    const auto* x = reinterpret_cast<const float*>(window);
+    float* fold = scratch.fold.data();
+    std::fill(fold, fold + lanes, 0.0f);
+    for (std::size_t p = 0; p < taps_.size(); p += lanes) {
+        const float* g = taps_.data() + p;
+        const float* xp = x + p;
+        for (std::size_t q = 0; q < lanes; ++q) {
+            fold[q] += g[q] * xp[q];
+        }
+    }
+
+    // Polyphase arm r is a[M-1-r]; rotating the FFT input by s = nD mod M
+    // supplies the exp(-j2πk·nD/M) term mixing bin k to baseband.
+    const std::size_t m = branches_;
+    const std::size_t s = static_cast<std::size_t>((n * decimation_) % m);
+    const auto* a = reinterpret_cast<const std::complex<float>*>(fold);
+    for (std::size_t r = 0; r < m; ++r) {
+        scratch.fft_in[r] = a[m - 1 - (s + m - r) % m];
+    }
+    plan_->forward(scratch.fft_in.data(), scratch.fft_out.data());
+
+    for (std::size_t c = 0; c < channels_.size(); ++c) {
+        const auto& ch = channels_[c];
+        auto y = scratch.fft_out[ch.bin];
+        if (ch.nco_step != 0.0) {
+            const double phase = std::fmod(ch.nco_step * static_cast<double>(n), 2.0 * std::numbers::pi);
+            y *= std::complex<float>(static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase)));
+        }
+        out[c][index] = y;
+    }
+}
+
+std::vector<std::vector<std::complex<float>>> PolyphaseChannelizer::channelize(
+    std::span<const std::complex<float>> input) const
+{
+    const std::size_t count = output_count(input.size());
+    std::vector<std::vector<std::complex<float>>> out(channels_.size());
+    for (auto& ch : out) {
+        ch.resize(count);
+    }
+    if (count == 0 || channels_.empty()) {
+        return out;
+    }
+
+    const std::size_t history = taps() - 1;
+    auto& pool = WorkerPool::shared();
+    PerWorker<Scratch> scratch(pool);
+    const std::size_t blocks = (count + kBlockOutputs - 1) / kBlockOutputs;
+    pool.parallel_for(blocks, [&](std::size_t b, std::size_t worker) {
+        auto& s = scratch.get(worker, [&] { return std::make_unique<Scratch>(make_scratch()); });
+        std::vector<std::complex<float>> padded;
+        const std::size_t end = std::min(count, (b + 1) * kBlockOutputs);
+        for (std::size_t n = b * kBlockOutputs; n < end; ++n) {
+            const std::size_t at = n * decimation_;
+            if (at >= history) {
+                compute_output(input.data() + (at - history), n, s, out, n);
+                continue;
+            }
+            // Start of the capture: the stream is zero before sample 0.
+            padded.assign(taps(), std::complex<float>{});
+            std::copy(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(at + 1),
+                      padded.end() - static_cast<std::ptrdiff_t>(at + 1));
+            compute_output(padded.data(), n, s, out, n);
+        }
+    });
+    return out;
+}
+
+void PolyphaseChannelizer::process(std::span<const std::complex<float>> input,
+                                   std::vector<std::vector<std::complex<float>>>& out)
+{
+    out.resize(channels_.size());
+    if (input.empty()) {
+        return;
+    }
+    const std::size_t history = taps() - 1;
+    std::vector<std::complex<float>> buffer;
+    buffer.reserve(history + input.size());
+    buffer.insert(buffer.end(), history_.begin(), history_.end());
+    buffer.insert(buffer.end(), input.begin(), input.end());
+
+    const std::uint64_t end = consumed_ + input.size();
+    std::uint64_t n = (consumed_ + decimation_ - 1) / decimation_;
+    const std::size_t first = out.empty() ? 0 : out.front().size();
+    const std::size_t produced =
+        static_cast<std::size_t>(end > n * decimation_ ? (end - n * decimation_ - 1) / decimation_ + 1 : 0);
+    for (auto& ch : out) {
+        ch.resize(first + produced);
+    }
+    for (std::size_t i = 0; i < produced; ++i, ++n) {
+        // buffer[k] holds input sample consumed_ - history + k.
+        const auto at = static_cast<std::size_t>(n * decimation_ - consumed_);
+        compute_output(buffer.data() + at, n, scratch_, out, first + i);
+    }
+
+    history_.assign(buffer.end() - static_cast<std::ptrdiff_t>(history), buffer.end());
+    consumed_ = end;
+}
+
+} // namespace host_sim
@@ -1,7 +1,11 @@
 #include "host_sim/chirp.hpp"
+#include "host_sim/shared_cache.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <numbers>
+#include <stdexcept>
+#include <utility>
 
 namespace host_sim
 {
@@ -11,6 +15,20 @@ namespace
 
 constexpr float kTwoPi = 2.0f * std::numbers::pi_v<float>;
 
+using ChirpKey = std::pair<int, int>;
+
+SharedCache<ChirpKey, ChirpTables>& chirp_cache()
+{
+    static SharedCache<ChirpKey, ChirpTables> cache;
+    return cache;
+}
+
+SharedCache<ChirpKey, ChirpTablesQ15>& chirp_cache_q15()
+{
+    static SharedCache<ChirpKey, ChirpTablesQ15> cache;
+    return cache;
+}
+
 }
 
 ChirpTables build_chirps_with_id(int sf, int oversample_factor, int id)
@@ -67,4 +85,76 @@ ChirpTablesQ15 build_chirps_q15(int sf, int oversample_factor)
     return build_chirps_q15_with_id(sf, oversample_factor, 0);
 }
 
+std::shared_ptr<const ChirpTables> shared_chirps(int sf, int oversample_factor)
+{
+    return chirp_cache().get({sf, oversample_factor}, [&] {
+        return std::make_shared<const ChirpTables>(build_chirps(sf, oversample_factor));
+    });
+}
+
+std::shared_ptr<const ChirpTablesQ15> shared_chirps_q15(int sf, int oversample_factor)
+{
+    return chirp_cache_q15().get({sf, oversample_factor}, [&] {
+        return std::make_shared<const ChirpTablesQ15>(build_chirps_q15(sf, oversample_factor));
+    });
+}
+
+std::size_t shared_chirp_cache_size()
+{
+    return chirp_cache().size() + chirp_cache_q15().size();
+}
+
+ChirpModulator::ChirpModulator(int sf, int oversample_factor) : sf_(sf), os_(oversample_factor)
+{
+    if (sf < 1 || sf > 16 || oversample_factor < 1) {
+        throw std::runtime_error("ChirpModulator: invalid sf or oversampling factor");
+    }
+    const int n_bins = 1 << sf;
+    const auto sps = static_cast<std::size_t>(n_bins) * static_cast<std::size_t>(oversample_factor);
+    const double N = static_cast<double>(n_bins);
+    const double os = static_cast<double>(oversample_factor);
+    const double two_pi = 2.0 * std::numbers::pi;
+
+    base_.resize(sps);
+    for (std::size_t n = 0; n < sps; ++n) {
+        const double n_d = static_cast<double>(n);
+        double phase = n_d * n_d / (2.0 * N * os * os) - 0.5 * n_d / os;
+        phase -= std::floor(phase);
+        base_[n] = {static_cast<float>(std::cos(two_pi * phase)), static_cast<float>(std::sin(two_pi * phase))};
+    }
+    symbol_phase_.resize(static_cast<std::size_t>(n_bins));
+    for (int k = 0; k < n_bins; ++k) {
+        const double k_d = static_cast<double>(k);
+        double phase = -(k_d * k_d / (2.0 * N) - 0.5 * k_d);
+        phase -= std::floor(phase);
+        symbol_phase_[static_cast<std::size_t>(k)] = {static_cast<float>(std::cos(two_pi * phase)),
+                                                      static_cast<float>(std::sin(two_pi * phase))};
+    }
+}
+
+void ChirpModulator::upchirp(int id, std::complex<float>* out) const
+{
+    const int n_bins = 1 << sf_;
+    const auto k = static_cast<std::size_t>(((id % n_bins) + n_bins) % n_bins);
+    const std::size_t sps = base_.size();
+    const std::size_t shift = k * static_cast<std::size_t>(os_);
+    const std::complex<float> rot = symbol_phase_[k];
+    // Two straight runs instead of a modulo per sample.
+    const std::size_t head = sps - shift;
+    for (std::size_t n = 0; n < head; ++n) {
+        out[n] = base_[n + shift] * rot;
+    }
+    for (std::size_t n = head; n < sps; ++n) {
+        out[n] = base_[n - head] * rot;
+    }
+}
+
+void ChirpModulator::downchirp(std::complex<float>* out, std::size_t count) const
+{
+    const std::size_t n = std::min(count, base_.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = std::conj(base_[i]);
+    }
+}
+
 } // namespace host_sim
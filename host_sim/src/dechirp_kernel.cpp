@@ -0,0 +1,77 @@
+#include "host_sim/dechirp_kernel.hpp"
+
+#include "host_sim/dsp_kernels.hpp"
+#include "host_sim/shared_cache.hpp"
+
+#include <new>
+#include <tuple>
+
+namespace host_sim
+{
+
+namespace
+{
+
+constexpr std::align_val_t kTapAlignment{64};
+
+} // namespace
+
+void DechirpKernel::AlignedDelete::operator()(float* p) const
+{
+    ::operator delete[](p, kTapAlignment);
+}
+
+DechirpKernel::DechirpKernel(const ChirpTables& chirps, int sf, int os, int base_tap)
+    : sf_(sf),
+      os_(os),
+      n_(1 << sf),
+      storage_(static_cast<float*>(
+          ::operator new[](sizeof(float) * 4 * static_cast<std::size_t>(n_), kTapAlignment)))
+{
+    auto* taps = reinterpret_cast<std::complex<float>*>(storage_.get());
+    float* taps_re = storage_.get() + 2 * n_;
+    float* taps_im = taps_re + n_;
+    for (int k = 0; k < n_; ++k) {
+        const auto tap = chirps.downchirp[static_cast<std::size_t>(base_tap + k * os)];
+        taps[k] = tap;
+        taps_re[k] = tap.real();
+        taps_im[k] = tap.imag();
+    }
+}
+
+void DechirpKernel::dechirp(const std::complex<float>* samples,
+                            const std::complex<float>* rotation,
+                            std::complex<float>* out) const
+{
+    const auto* taps = reinterpret_cast<const std::complex<float>*>(storage_.get());
+    kernels::dechirp_decimated(samples, rotation, taps, n_, os_, out);
+}
+
+void DechirpKernel::dechirp_split(const float* re,
+                                  const float* im,
+                                  const std::complex<float>* rotation,
+                                  std::complex<float>* out) const
+{
+    const float* taps_re = storage_.get() + 2 * n_;
+    kernels::dechirp_split(re, im, rotation, taps_re, taps_re + n_, n_, out);
+}
+
+bool dechirp_kernel_supported(int sf, int oversample_factor)
+{
+    const int os = oversample_factor;
+    return sf >= 7 && sf <= 12 && (os == 1 || os == 2 || os == 4 || os == 8 || os == 16);
+}
+
+std::shared_ptr<const DechirpKernel> shared_dechirp_kernel(int sf, int oversample_factor, int base_tap)
+{
+    if (!dechirp_kernel_supported(sf, oversample_factor) || base_tap < 0 || base_tap >= oversample_factor) {
+        return nullptr;
+    }
+    static SharedCache<std::tuple<int, int, int>, DechirpKernel> cache;
+    return cache.get({sf, oversample_factor, base_tap}, [&] {
+        const auto chirps = shared_chirps(sf, oversample_factor);
+        return std::make_shared<const DechirpKernel>(*chirps, sf, oversample_factor, base_tap);
+    });
+}
+
+} // namespace host_sim
@@ -0,0 +1,94 @@
+#include "host_sim/decimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+
+namespace host_sim
+{
+
+Decimator::Decimator(std::size_t factor, double passband) : factor_(factor)
+{
+    if (factor_ < 1) {
+        throw std::runtime_error("Decimation factor must be at least 1");
+    }
+    if (factor_ == 1) {
+        taps_ = {1.0f, 1.0f};
+        reset();
+        return;
+    }
+    // Pass [0, passband], stop from 1/D - passband: the first frequency
+    // that folds back onto the passband edge.
+    const double transition = 1.0 / static_cast<double>(factor_) - 2.0 * passband;
+    if (passband <= 0.0 || transition <= 0.0) {
+        throw std::runtime_error("Decimation by " + std::to_string(factor_) +
+                                 " would alias the signal band");
+    }
+    // Blackman needs about 5.5 / transition taps; round to 2kD + 1 so the
+    // (L - 1) / 2 group delay is k whole output samples.
+    const auto min_taps = static_cast<std::size_t>(std::ceil(5.5 / transition));
+    const std::size_t half = std::max<std::size_t>(1, (min_taps + 2 * factor_ - 2) / (2 * factor_));
+    delay_ = half;
+    const std::size_t n_taps = 2 * half * factor_ + 1;
+
+    std::vector<double> h(n_taps);
+    const double fc = 0.5 / static_cast<double>(factor_);
+    const double mid = static_cast<double>(half * factor_);
+    double sum = 0.0;
+    for (std::size_t l = 0; l < n_taps; ++l) {
+        const double t = static_cast<double>(l) - mid;
+        const double sinc = (t == 0.0) ? 2.0 * fc : std::sin(2.0 * std::numbers::pi * fc * t) / (std::numbers::pi * t);
+        const double phase = 2.0 * std::numbers::pi * static_cast<double>(l) / static_cast<double>(n_taps - 1);
+        h[l] = sinc * (0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+        sum += h[l];
+    }
+    // Symmetric, so already "time-reversed"; duplicate per I/Q lane.
+    taps_.resize(2 * n_taps);
+    for (std::size_t l = 0; l < n_taps; ++l) {
+        taps_[2 * l] = static_cast<float>(h[l] / sum);
+        taps_[2 * l + 1] = static_cast<float>(h[l] / sum);
+    }
+    reset();
+}
+
+void Decimator::reset()
+{
+    buffer_.assign(taps() - 1, std::complex<float>{});
+    phase_ = 0;
+}
+
+std::size_t Decimator::process(const std::complex<float>* in, std::size_t n, std::complex<float>* out)
+{
+    if (factor_ == 1) {
+        std::copy(in, in + n, out);
+        return n;
+    }
+    const std::size_t history = taps() - 1;
+    buffer_.resize(history + n);
+    std::copy(in, in + n, buffer_.begin() + static_cast<std::ptrdiff_t>(history));
+
+    // Output at new input j uses buffer_[j, j + taps()), oldest first.
+    const std::size_t lanes = taps_.size();
+    const float* g = taps_.data();
+    std::size_t written = 0;
+    std::size_t j = phase_;
+    for (; j < n; j += factor_) {
+        const auto* x = reinterpret_cast<const float*>(buffer_.data() + j);
+        float re = 0.0f;
+        float im = 0.0f;
+        for (std::size_t q = 0; q < lanes; q += 2) {
+            re += g[q] * x[q];
+            im += g[q + 1] * x[q + 1];
+        }
+        out[written++] = {re, im};
+    }
+    phase_ = j - n;
+
+    std::copy(buffer_.end() - static_cast<std::ptrdiff_t>(history), buffer_.end(), buffer_.begin());
+    buffer_.resize(history);
+    return written;
+}
+
+} // namespace host_sim
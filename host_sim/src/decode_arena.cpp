@@ -0,0 +1,41 @@
+#include "host_sim/decode_arena.hpp"
+
+namespace host_sim
+{
+
+void* DecodeArena::Spill::do_allocate(std::size_t size, std::size_t align)
+{
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, align);
+}
+
+void DecodeArena::Spill::do_deallocate(void* p, std::size_t size, std::size_t align)
+{
+    std::pmr::new_delete_resource()->deallocate(p, size, align);
+}
+
+bool DecodeArena::Spill::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+DecodeArena::DecodeArena(std::size_t initial_bytes)
+    : capacity_(initial_bytes),
+      block_(new std::byte[initial_bytes])
+{
+    arena_.emplace(block_.get(), capacity_, &spill_);
+}
+
+void DecodeArena::reset()
+{
+    arena_.reset();   // returns the spilled chunks to the heap
+    if (spill_.bytes > 0) {
+        // Room for everything the last packet needed in one block.
+        capacity_ += spill_.bytes;
+        block_.reset(new std::byte[capacity_]);
+        spill_.bytes = 0;
+    }
+    arena_.emplace(block_.get(), capacity_, &spill_);
+}
+
+} // namespace host_sim
@@ -0,0 +1,104 @@
+#include "host_sim/decode_phase.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+struct Recorder
+{
+    PhaseTimes* sink{nullptr};
+    DecodePhase current{DecodePhase::other};
+    Clock::time_point since{};
+};
+
+thread_local Recorder recorder;
+
+// Charge the time since the last switch to the current phase.
+void charge(Clock::time_point now)
+{
+    (*recorder.sink)[recorder.current] += std::chrono::duration<double, std::nano>(now - recorder.since).count();
+    recorder.since = now;
+}
+
+} // namespace
+
+const char* phase_name(DecodePhase phase)
+{
+    switch (phase) {
+    case DecodePhase::other: return "other";
+    case DecodePhase::detection: return "detection";
+    case DecodePhase::alignment: return "alignment";
+    case DecodePhase::cfo_sfo: return "cfo_sfo";
+    case DecodePhase::demod: return "demod";
+    case DecodePhase::header: return "header";
+    case DecodePhase::fallback: return "fallback";
+    case DecodePhase::payload: return "payload";
+    case DecodePhase::count: break;
+    }
+    return "?";
+}
+
+double PhaseTimes::total() const
+{
+    double sum = 0.0;
+    for (double v : ns) {
+        sum += v;
+    }
+    return sum;
+}
+
+PhaseTimes& PhaseTimes::operator+=(const PhaseTimes& other)
+{
+    for (std::size_t i = 0; i < ns.size(); ++i) {
+        ns[i] += other.ns[i];
+    }
+    return *this;
+}
+
+PhaseRecording::PhaseRecording(PhaseTimes& sink)
+{
+    if (recorder.sink) {
+        throw std::runtime_error("PhaseRecording: a recording is already active on this thread");
+    }
+    recorder = {&sink, DecodePhase::other, Clock::now()};
+}
+
+PhaseRecording::~PhaseRecording()
+{
+    charge(Clock::now());
+    recorder = {};
+}
+
+bool PhaseRecording::active()
+{
+    return recorder.sink != nullptr;
+}
+
+PhaseScope::PhaseScope(DecodePhase phase)
+{
+    if (!recorder.sink) {
+        return;
+    }
+    charge(Clock::now());
+    previous_ = recorder.current;
+    recorder.current = phase;
+    active_ = true;
+}
+
+PhaseScope::~PhaseScope()
+{
+    if (!active_ || !recorder.sink) {
+        return;
+    }
+    charge(Clock::now());
+    recorder.current = previous_;
+}
+
+} // namespace host_sim
@@ -2,6 +2,8 @@
 
 #include "host_sim/gray.hpp"
 
+#include <algorithm>
+#include <array>
 #include <stdexcept>
 
 namespace host_sim
@@ -37,9 +39,136 @@ inline int modulo(int a, int m)
     return result;
 }
 
+// ── Word-level transpose ──
+//
+// A block is an sf_app x cw_len bit matrix: codeword r is row r, symbol
+// i is column i, and the diagonal interleave is a per-column rotation.
+// Rows are transposed into 16-bit lanes of 64-bit accumulators (lane L
+// of acc[L / 4]), four bits per table lookup.
+
+/// Nibble bit k -> bit 16k.
+constexpr auto kSpread16 = [] {
+    std::array<uint64_t, 16> table{};
+    for (std::size_t v = 0; v < table.size(); ++v) {
+        for (std::size_t k = 0; k < 4; ++k) {
+            if ((v >> k) & 1u) {
+                table[v] |= uint64_t{1} << (16 * k);
+            }
+        }
+    }
+    return table;
+}();
+
+struct BlockGeometry
+{
+    int sf_app;
+    int cw_len;
+    bool use_ldro;
+};
+
+BlockGeometry block_geometry(const DeinterleaverConfig& cfg)
+{
+    const bool use_ldro = cfg.ldro || cfg.is_header;
+    const int sf_app = use_ldro ? cfg.sf - 2 : cfg.sf;
+    const int cw_len = cfg.is_header ? 8 : cfg.cr + 4;
+    if (sf_app < 1 || sf_app > static_cast<int>(kMaxInterleaverRows) ||
+        cw_len > static_cast<int>(kMaxInterleaverCols)) {
+        throw std::runtime_error("Unsupported interleaver geometry");
+    }
+    return {sf_app, cw_len, use_ldro};
+}
+
+inline uint16_t rotl(uint16_t value, int by, int width, uint16_t mask)
+{
+    return by == 0 ? value : static_cast<uint16_t>(((value << by) | (value >> (width - by))) & mask);
+}
+
+inline uint16_t rotr(uint16_t value, int by, int width, uint16_t mask)
+{
+    return by == 0 ? value : static_cast<uint16_t>(((value >> by) | (value << (width - by))) & mask);
+}
+
+inline uint16_t lane(const uint64_t* acc, int index)
+{
+    return static_cast<uint16_t>(acc[index >> 2] >> (16 * (index & 3)));
+}
+
+} // namespace
+
+std::size_t deinterleave_block(const uint16_t* symbols,
+                               std::size_t count,
+                               const DeinterleaverConfig& cfg,
+                               uint8_t* out)
+{
+    const auto [sf_app, cw_len, use_ldro] = block_geometry(cfg);
+    if (count < static_cast<std::size_t>(cw_len)) {
+        throw std::runtime_error("Not enough symbols to deinterleave block");
+    }
+    const uint16_t mask_full = static_cast<uint16_t>((1u << cfg.sf) - 1u);
+    const uint16_t mask_app = static_cast<uint16_t>((1u << sf_app) - 1u);
+
+    // Codeword r takes bit (r - i) mod sf_app of symbol i's gray-mapped
+    // value as its bit (cw_len - 1 - i): rotate left by i, then lane r
+    // of the transpose collects it.
+    uint64_t acc[3] = {0, 0, 0};
+    for (int i = 0; i < cw_len; ++i) {
+        uint16_t raw = static_cast<uint16_t>(((symbols[i] & mask_full) - 1u) & mask_full);
+        if (use_ldro) {
+            raw = static_cast<uint16_t>(raw >> 2);
+        }
+        const auto mapped = static_cast<uint16_t>((raw ^ (raw >> 1)) & mask_app);
+        const uint16_t r = rotl(mapped, i % sf_app, sf_app, mask_app);
+        const int shift = cw_len - 1 - i;
+        acc[0] |= kSpread16[r & 0xFu] << shift;
+        acc[1] |= kSpread16[(r >> 4) & 0xFu] << shift;
+        acc[2] |= kSpread16[(r >> 8) & 0xFu] << shift;
+    }
+    for (int row = 0; row < sf_app; ++row) {
+        out[row] = static_cast<uint8_t>(lane(acc, row));
+    }
+    return static_cast<std::size_t>(sf_app);
+}
+
+std::size_t interleave_block(const uint8_t* codewords,
+                             std::size_t count,
+                             const DeinterleaverConfig& cfg,
+                             uint16_t* out)
+{
+    const auto [sf_app, cw_len, use_ldro] = block_geometry(cfg);
+    const uint16_t mask_full = static_cast<uint16_t>((1u << cfg.sf) - 1u);
+    const uint16_t mask_app = static_cast<uint16_t>((1u << sf_app) - 1u);
+
+    // Transpose: lane k holds bit k of every codeword, codeword r at bit r.
+    uint64_t acc[2] = {0, 0};
+    const std::size_t rows = std::min(count, static_cast<std::size_t>(sf_app));
+    for (std::size_t row = 0; row < rows; ++row) {
+        acc[0] |= kSpread16[codewords[row] & 0xFu] << row;
+        acc[1] |= kSpread16[(codewords[row] >> 4) & 0xFu] << row;
+    }
+    // Symbol i bit p is codeword (i + p) mod sf_app's bit (cw_len - 1 - i),
+    // then the inverse of the RX mapping: gray decode, LDRO shift, +1.
+    for (int i = 0; i < cw_len; ++i) {
+        const uint16_t value = rotr(lane(acc, cw_len - 1 - i), i % sf_app, sf_app, mask_app);
+        uint16_t decoded = gray_decode(value);
+        if (use_ldro) {
+            decoded = static_cast<uint16_t>((decoded << 2) & mask_full);
+        }
+        out[i] = static_cast<uint16_t>((decoded + 1u) & mask_full);
+    }
+    return static_cast<std::size_t>(cw_len);
 }
 
 std::vector<uint8_t> deinterleave(const std::vector<uint16_t>& symbols, const DeinterleaverConfig& cfg, std::size_t& consumed)
+{
+    uint8_t codewords[kMaxInterleaverRows];
+    const std::size_t n = deinterleave_block(symbols.data(), symbols.size(), cfg, codewords);
+    consumed = static_cast<std::size_t>(block_geometry(cfg).cw_len);
+    return std::vector<uint8_t>(codewords, codewords + n);
+}
+
+std::vector<uint8_t> deinterleave_reference(const std::vector<uint16_t>& symbols,
+                                            const DeinterleaverConfig& cfg,
+                                            std::size_t& consumed)
 {
     const bool use_ldro = cfg.ldro || cfg.is_header;
     const int sf_app = use_ldro ? cfg.sf - 2 : cfg.sf;
@@ -0,0 +1,86 @@
+#include "host_sim/derotator.hpp"
+
+#include <cmath>
+#include <numbers>
+
+namespace host_sim
+{
+
+void Derotator::configure(int n_bins, int oversample_factor, int base)
+{
+    n_bins_ = n_bins;
+    oversample_factor_ = oversample_factor;
+    base_ = base;
+    table_.assign(static_cast<std::size_t>(n_bins_), std::complex<float>{1.0f, 0.0f});
+    table_q15_.assign(static_cast<std::size_t>(n_bins_), Q15Complex{});
+    invalidate();
+}
+
+void Derotator::invalidate()
+{
+    table_valid_ = false;
+    table_q15_valid_ = false;
+}
+
+double Derotator::phase_step(float cfo_frac, float sfo_slope,
+                             std::size_t symbol_index, int samples_per_symbol)
+{
+    // Legacy formula, per tap:
+    //   -2π (cfo_frac + slope·k) · chip / N  +  (-2π slope·k / sps) · sample_idx
+    // with chip = sample_idx / os and N·os = sps, i.e. a single linear ramp
+    // over sample_idx with slope -2π (cfo_frac + 2·slope·k) / sps.
+    const double k = static_cast<double>(symbol_index);
+    const double fractional = static_cast<double>(cfo_frac) +
+                              static_cast<double>(sfo_slope) * k;
+    const double sfo = static_cast<double>(sfo_slope) * k;
+    return -2.0 * std::numbers::pi * (fractional + sfo) /
+           static_cast<double>(samples_per_symbol);
+}
+
+void Derotator::build(double w)
+{
+    // Recursive phasor in double precision: p[bin+1] = p[bin] · exp(j·w·os).
+    // Re-seeding from std::polar bounds the accumulated drift to a few
+    // double ulps between resyncs, so the float table is correctly rounded
+    // to within kTolerance.
+    const double step_phase = w * static_cast<double>(oversample_factor_);
+    const std::complex<double> step = std::polar(1.0, step_phase);
+    std::complex<double> phasor{1.0, 0.0};
+    for (int bin = 0; bin < n_bins_; ++bin) {
+        if ((bin % kResyncInterval) == 0) {
+            const double sample_idx =
+                static_cast<double>(bin) * oversample_factor_ + base_;
+            phasor = std::polar(1.0, w * sample_idx);
+        }
+        table_[static_cast<std::size_t>(bin)] = std::complex<float>(
+            static_cast<float>(phasor.real()), static_cast<float>(phasor.imag()));
+        phasor *= step;
+    }
+    table_w_ = w;
+    table_valid_ = true;
+}
+
+const std::vector<std::complex<float>>& Derotator::ramp(double w)
+{
+    if (!table_valid_ || table_w_ != w) {
+        build(w);
+    }
+    return table_;
+}
+
+const std::vector<Q15Complex>& Derotator::ramp_q15(double w)
+{
+    if (!table_q15_valid_ || table_q15_w_ != w) {
+        const auto& table = ramp(w);
+        for (int bin = 0; bin < n_bins_; ++bin) {
+            const auto& rot = table[static_cast<std::size_t>(bin)];
+            table_q15_[static_cast<std::size_t>(bin)] =
+                float_to_q15_complex(rot.real(), rot.imag());
+        }
+        table_q15_w_ = w;
+        table_q15_valid_ = true;
+    }
+    return table_q15_;
+}
+
+} // namespace host_sim
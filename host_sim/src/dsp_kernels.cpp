@@ -0,0 +1,1291 @@
+/// Vectorised DSP kernels with runtime ISA dispatch.
+///
+/// Each kernel has a scalar reference and SIMD variants that compute the
+/// same per-element operations in the same order.  This file is compiled
+/// with -ffp-contract=off (see host_sim/CMakeLists.txt) so neither the
+/// scalar loops nor the intrinsics get fused into FMAs behind our back;
+/// that is what keeps all variants bit-identical.
+///
+/// Peak searches vectorise as W independent lanes, each lane running the
+/// sequential best/second-best update over the bins congruent to it mod W.
+/// merge_lanes() then recovers the exact result of the sequential scan:
+/// the best is the lane best with the highest value (lowest bin on ties),
+/// the second is the strongest of the other lanes' bests and the winning
+/// lane's own second.
+
+#include "host_sim/dsp_kernels.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HOST_SIM_KERNELS_X86 1
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define HOST_SIM_KERNELS_NEON 1
+#endif
+
+namespace host_sim::kernels
+{
+
+namespace
+{
+
+struct KernelTable
+{
+    Isa isa;
+    void (*dechirp)(const std::complex<float>*, const std::complex<float>*,
+                    const std::complex<float>*, int, int, int, std::complex<float>*);
+    void (*dechirp_fold)(const std::complex<float>*, const std::complex<float>*,
+                         int, int, int, std::complex<float>*);
+    void (*dechirp_split)(const float*, const float*, const std::complex<float>*,
+                          const float*, const float*, int, std::complex<float>*);
+    PeakPair (*find_two_peaks)(const std::complex<float>*, int, float*);
+    PeakPairQ15 (*find_two_peaks_q15)(const int16_t*, int);
+    void (*int8_to_cf32)(const int8_t*, std::size_t, std::complex<float>*);
+    void (*int16_to_cf32)(const int16_t*, std::size_t, std::complex<float>*);
+    void (*int8_to_q15)(const int8_t*, std::size_t, int16_t*);
+    void (*dot_rows)(const std::complex<float>*, const std::complex<float>*, int, int,
+                     std::complex<float>*);
+};
+
+// ── Shared lane helpers ──
+
+template <typename T>
+struct LaneState
+{
+    T best;
+    int best_bin;
+    T second;
+    int second_bin;
+};
+
+template <typename T>
+inline void lane_update(LaneState<T>& lane, T value, int bin)
+{
+    if (value > lane.best) {
+        lane.second = lane.best;
+        lane.second_bin = lane.best_bin;
+        lane.best = value;
+        lane.best_bin = bin;
+    } else if (value > lane.second) {
+        lane.second = value;
+        lane.second_bin = bin;
+    }
+}
+
+template <typename T>
+inline bool beats(T value, int bin, T ref, int ref_bin)
+{
+    return value > ref || (value == ref && bin < ref_bin);
+}
+
+template <typename T, typename Pair>
+Pair merge_lanes(const LaneState<T>* lanes, int count)
+{
+    int winner = 0;
+    for (int l = 1; l < count; ++l) {
+        if (beats(lanes[l].best, lanes[l].best_bin,
+                  lanes[winner].best, lanes[winner].best_bin)) {
+            winner = l;
+        }
+    }
+    T second = lanes[winner].second;
+    int second_bin = lanes[winner].second_bin;
+    for (int l = 0; l < count; ++l) {
+        if (l != winner && beats(lanes[l].best, lanes[l].best_bin, second, second_bin)) {
+            second = lanes[l].best;
+            second_bin = lanes[l].best_bin;
+        }
+    }
+    Pair result;
+    result.best_bin = lanes[winner].best_bin;
+    result.best_mag = lanes[winner].best;
+    result.second_bin = second_bin;
+    result.second_mag = second;
+    return result;
+}
+
+// ── Scalar reference ──
+
+inline std::complex<float> cmul(std::complex<float> a, std::complex<float> b)
+{
+    const float ar = a.real();
+    const float ai = a.imag();
+    const float br = b.real();
+    const float bi = b.imag();
+    return {ar * br - ai * bi, ar * bi + ai * br};
+}
+
+inline float power(std::complex<float> v)
+{
+    return v.real() * v.real() + v.imag() * v.imag();
+}
+
+void dechirp_scalar_from(const std::complex<float>* samples,
+                         const std::complex<float>* rotation,
+                         const std::complex<float>* chirp,
+                         int start,
+                         int n,
+                         int stride,
+                         int chirp_stride,
+                         std::complex<float>* out)
+{
+    for (int k = start; k < n; ++k) {
+        std::complex<float> v = samples[static_cast<std::size_t>(k) * stride];
+        if (rotation != nullptr) {
+            v = cmul(v, rotation[k]);
+        }
+        out[k] = cmul(v, chirp[static_cast<std::size_t>(k) * chirp_stride]);
+    }
+}
+
+void dechirp_scalar(const std::complex<float>* samples,
+                    const std::complex<float>* rotation,
+                    const std::complex<float>* chirp,
+                    int n,
+                    int stride,
+                    int chirp_stride,
+                    std::complex<float>* out)
+{
+    dechirp_scalar_from(samples, rotation, chirp, 0, n, stride, chirp_stride, out);
+}
+
+void dechirp_fold_scalar_from(const std::complex<float>* samples,
+                              const std::complex<float>* chirp,
+                              int start,
+                              int n,
+                              int os,
+                              int fold_stride,
+                              std::complex<float>* out)
+{
+    for (int k = start; k < n; ++k) {
+        std::complex<float> acc{0.0f, 0.0f};
+        for (int m = 0; m < os; m += fold_stride) {
+            const std::size_t idx = static_cast<std::size_t>(k) * os + m;
+            acc += cmul(samples[idx], chirp[idx]);
+        }
+        out[k] = acc;
+    }
+}
+
+void dechirp_fold_scalar(const std::complex<float>* samples,
+                         const std::complex<float>* chirp,
+                         int n,
+                         int os,
+                         int fold_stride,
+                         std::complex<float>* out)
+{
+    dechirp_fold_scalar_from(samples, chirp, 0, n, os, fold_stride, out);
+}
+
+void dechirp_split_scalar_from(const float* re,
+                               const float* im,
+                               const std::complex<float>* rotation,
+                               const float* chirp_re,
+                               const float* chirp_im,
+                               int start,
+                               int n,
+                               std::complex<float>* out)
+{
+    for (int k = start; k < n; ++k) {
+        std::complex<float> v{re[k], im[k]};
+        if (rotation != nullptr) {
+            v = cmul(v, rotation[k]);
+        }
+        out[k] = cmul(v, {chirp_re[k], chirp_im[k]});
+    }
+}
+
+void dechirp_split_scalar(const float* re,
+                          const float* im,
+                          const std::complex<float>* rotation,
+                          const float* chirp_re,
+                          const float* chirp_im,
+                          int n,
+                          std::complex<float>* out)
+{
+    dechirp_split_scalar_from(re, im, rotation, chirp_re, chirp_im, 0, n, out);
+}
+
+PeakPair find_two_peaks_scalar(const std::complex<float>* spectrum, int n, float* mag_out)
+{
+    LaneState<float> lane{-1.0f, 0, -1.0f, 0};
+    for (int k = 0; k < n; ++k) {
+        const float mag = power(spectrum[k]);
+        if (mag_out != nullptr) {
+            mag_out[k] = mag;
+        }
+        lane_update(lane, mag, k);
+    }
+    return merge_lanes<float, PeakPair>(&lane, 1);
+}
+
+inline int64_t power_q15(const int16_t* iq)
+{
+    const int32_t re = iq[0];
+    const int32_t im = iq[1];
+    return static_cast<int64_t>(re) * re + static_cast<int64_t>(im) * im;
+}
+
+PeakPairQ15 find_two_peaks_q15_scalar(const int16_t* spectrum_iq, int n)
+{
+    LaneState<int64_t> lane{-1, 0, -1, 0};
+    for (int k = 0; k < n; ++k) {
+        lane_update(lane, power_q15(spectrum_iq + 2 * k), k);
+    }
+    return merge_lanes<int64_t, PeakPairQ15>(&lane, 1);
+}
+
+// Integer → float conversions scale by a power of two, which is exact,
+// so every variant matches the scalar loop bit for bit.
+constexpr float kInt8Scale = 1.0f / 128.0f;
+constexpr float kInt16Scale = 1.0f / 32768.0f;
+
+void int8_to_cf32_scalar_from(const int8_t* iq, std::size_t start, std::size_t n_samples,
+                              std::complex<float>* out)
+{
+    for (std::size_t k = start; k < n_samples; ++k) {
+        out[k] = {static_cast<float>(iq[2 * k]) * kInt8Scale,
+                  static_cast<float>(iq[2 * k + 1]) * kInt8Scale};
+    }
+}
+
+void int8_to_cf32_scalar(const int8_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    int8_to_cf32_scalar_from(iq, 0, n_samples, out);
+}
+
+void int16_to_cf32_scalar_from(const int16_t* iq, std::size_t start, std::size_t n_samples,
+                               std::complex<float>* out)
+{
+    for (std::size_t k = start; k < n_samples; ++k) {
+        out[k] = {static_cast<float>(iq[2 * k]) * kInt16Scale,
+                  static_cast<float>(iq[2 * k + 1]) * kInt16Scale};
+    }
+}
+
+void int16_to_cf32_scalar(const int16_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    int16_to_cf32_scalar_from(iq, 0, n_samples, out);
+}
+
+void int8_to_q15_scalar_from(const int8_t* iq, std::size_t start, std::size_t n_samples,
+                             int16_t* out_iq)
+{
+    for (std::size_t i = 2 * start; i < 2 * n_samples; ++i) {
+        out_iq[i] = static_cast<int16_t>(static_cast<int16_t>(iq[i]) * 256);
+    }
+}
+
+void int8_to_q15_scalar(const int8_t* iq, std::size_t n_samples, int16_t* out_iq)
+{
+    int8_to_q15_scalar_from(iq, 0, n_samples, out_iq);
+}
+
+// dot_rows() accumulates lane k mod kDotLanes in its own partial sum and
+// adds the partial sums in lane order.  The lanes are one AVX-512 vector
+// or two AVX2 vectors of complex values, so SIMD variants only run their
+// tails through the scalar loop.
+constexpr int kDotLanes = 8;
+
+void dot_rows_scalar_from(const std::complex<float>* x,
+                          const std::complex<float>* row,
+                          int start,
+                          int n,
+                          std::complex<float>* lanes)
+{
+    for (int k = start; k < n; ++k) {
+        lanes[k % kDotLanes] += cmul(x[k], row[k]);
+    }
+}
+
+std::complex<float> sum_lanes(const std::complex<float>* lanes)
+{
+    std::complex<float> sum = lanes[0];
+    for (int l = 1; l < kDotLanes; ++l) {
+        sum += lanes[l];
+    }
+    return sum;
+}
+
+void dot_rows_scalar(const std::complex<float>* x,
+                     const std::complex<float>* rows,
+                     int n,
+                     int count,
+                     std::complex<float>* out)
+{
+    for (int r = 0; r < count; ++r) {
+        std::complex<float> lanes[kDotLanes]{};
+        dot_rows_scalar_from(x, rows + static_cast<std::size_t>(r) * n, 0, n, lanes);
+        out[r] = sum_lanes(lanes);
+    }
+}
+
+constexpr KernelTable kScalarTable{
+    Isa::scalar,
+    dechirp_scalar,
+    dechirp_fold_scalar,
+    dechirp_split_scalar,
+    find_two_peaks_scalar,
+    find_two_peaks_q15_scalar,
+    int8_to_cf32_scalar,
+    int16_to_cf32_scalar,
+    int8_to_q15_scalar,
+    dot_rows_scalar,
+};
+
+#if defined(HOST_SIM_KERNELS_X86)
+
+// ── AVX2 (4 complex / 8 floats per vector) ──
+
+__attribute__((target("avx2")))
+inline __m256 cmul_avx2(__m256 a, __m256 b)
+{
+    const __m256 br = _mm256_moveldup_ps(b);
+    const __m256 bi = _mm256_movehdup_ps(b);
+    const __m256 a_swapped = _mm256_permute_ps(a, 0xB1);
+    // even lanes: ar·br − ai·bi, odd lanes: ai·br + ar·bi
+    return _mm256_addsub_ps(_mm256_mul_ps(a, br), _mm256_mul_ps(a_swapped, bi));
+}
+
+__attribute__((target("avx2")))
+inline __m256 load4_avx2(const std::complex<float>* p, int stride, __m256i gather_idx)
+{
+    if (stride == 1) {
+        return _mm256_loadu_ps(reinterpret_cast<const float*>(p));
+    }
+    // A complex<float> is 8 bytes: gather it as one double.
+    return _mm256_castpd_ps(
+        _mm256_i64gather_pd(reinterpret_cast<const double*>(p), gather_idx, 8));
+}
+
+__attribute__((target("avx2")))
+void dechirp_avx2(const std::complex<float>* samples,
+                  const std::complex<float>* rotation,
+                  const std::complex<float>* chirp,
+                  int n,
+                  int stride,
+                  int chirp_stride,
+                  std::complex<float>* out)
+{
+    const long long s = stride;
+    const long long c = chirp_stride;
+    const __m256i gather_idx = _mm256_set_epi64x(3 * s, 2 * s, s, 0);
+    const __m256i chirp_idx = _mm256_set_epi64x(3 * c, 2 * c, c, 0);
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256 v = load4_avx2(samples + static_cast<std::size_t>(k) * stride, stride, gather_idx);
+        if (rotation != nullptr) {
+            v = cmul_avx2(v, _mm256_loadu_ps(reinterpret_cast<const float*>(rotation + k)));
+        }
+        v = cmul_avx2(v, load4_avx2(chirp + static_cast<std::size_t>(k) * chirp_stride, chirp_stride, chirp_idx));
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + k), v);
+    }
+    dechirp_scalar_from(samples, rotation, chirp, k, n, stride, chirp_stride, out);
+}
+
+__attribute__((target("avx2")))
+void dechirp_fold_avx2(const std::complex<float>* samples,
+                       const std::complex<float>* chirp,
+                       int n,
+                       int os,
+                       int fold_stride,
+                       std::complex<float>* out)
+{
+    const long long s = os;
+    const __m256i gather_idx = _mm256_set_epi64x(3 * s, 2 * s, s, 0);
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int m = 0; m < os; m += fold_stride) {
+            const std::size_t idx = static_cast<std::size_t>(k) * os + m;
+            acc = _mm256_add_ps(acc, cmul_avx2(load4_avx2(samples + idx, os, gather_idx),
+                                               load4_avx2(chirp + idx, os, gather_idx)));
+        }
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + k), acc);
+    }
+    dechirp_fold_scalar_from(samples, chirp, k, n, os, fold_stride, out);
+}
+
+// Split re/im planes: the same two products per element as cmul(), in
+// separate real and imaginary vectors, so no shuffles sit between the
+// multiplies and only the interleaved rotation and output are permuted.
+__attribute__((target("avx2")))
+void dechirp_split_avx2(const float* re,
+                        const float* im,
+                        const std::complex<float>* rotation,
+                        const float* chirp_re,
+                        const float* chirp_im,
+                        int n,
+                        std::complex<float>* out)
+{
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256 vr = _mm256_loadu_ps(re + k);
+        __m256 vi = _mm256_loadu_ps(im + k);
+        if (rotation != nullptr) {
+            const auto* r = reinterpret_cast<const float*>(rotation + k);
+            const __m256 lo = _mm256_loadu_ps(r);
+            const __m256 hi = _mm256_loadu_ps(r + 8);
+            // shuffle_ps works per 128-bit lane; the 64-bit permute restores order.
+            const __m256 rr = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(_mm256_shuffle_ps(lo, hi, 0x88)), 0xD8));
+            const __m256 ri = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(_mm256_shuffle_ps(lo, hi, 0xDD)), 0xD8));
+            const __m256 tr = _mm256_sub_ps(_mm256_mul_ps(vr, rr), _mm256_mul_ps(vi, ri));
+            vi = _mm256_add_ps(_mm256_mul_ps(vr, ri), _mm256_mul_ps(vi, rr));
+            vr = tr;
+        }
+        const __m256 cr = _mm256_loadu_ps(chirp_re + k);
+        const __m256 ci = _mm256_loadu_ps(chirp_im + k);
+        const __m256 yr = _mm256_sub_ps(_mm256_mul_ps(vr, cr), _mm256_mul_ps(vi, ci));
+        const __m256 yi = _mm256_add_ps(_mm256_mul_ps(vr, ci), _mm256_mul_ps(vi, cr));
+        const __m256 lo = _mm256_unpacklo_ps(yr, yi);
+        const __m256 hi = _mm256_unpackhi_ps(yr, yi);
+        auto* y = reinterpret_cast<float*>(out + k);
+        _mm256_storeu_ps(y, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(y + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    dechirp_split_scalar_from(re, im, rotation, chirp_re, chirp_im, k, n, out);
+}
+
+__attribute__((target("avx2")))
+PeakPair find_two_peaks_avx2(const std::complex<float>* spectrum, int n, float* mag_out)
+{
+    constexpr int W = 8;
+    const float* x = reinterpret_cast<const float*>(spectrum);
+    __m256 best = _mm256_set1_ps(-1.0f);
+    __m256 second = best;
+    __m256i best_bin = _mm256_setzero_si256();
+    __m256i second_bin = best_bin;
+    __m256i bins = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(W);
+
+    int k = 0;
+    for (; k + W <= n; k += W) {
+        const __m256 a = _mm256_loadu_ps(x + 2 * k);
+        const __m256 b = _mm256_loadu_ps(x + 2 * k + 8);
+        // hadd pairs (re², im²) as re² + im², then restore bin order.
+        const __m256 h = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+        const __m256 mag = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), 0xD8));
+        if (mag_out != nullptr) {
+            _mm256_storeu_ps(mag_out + k, mag);
+        }
+
+        const __m256 gt_best = _mm256_cmp_ps(mag, best, _CMP_GT_OQ);
+        const __m256 gt_second = _mm256_andnot_ps(gt_best, _mm256_cmp_ps(mag, second, _CMP_GT_OQ));
+        second = _mm256_blendv_ps(second, best, gt_best);
+        second_bin = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_castsi256_ps(second_bin), _mm256_castsi256_ps(best_bin), gt_best));
+        second = _mm256_blendv_ps(second, mag, gt_second);
+        second_bin = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_castsi256_ps(second_bin), _mm256_castsi256_ps(bins), gt_second));
+        best = _mm256_blendv_ps(best, mag, gt_best);
+        best_bin = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_castsi256_ps(best_bin), _mm256_castsi256_ps(bins), gt_best));
+        bins = _mm256_add_epi32(bins, step);
+    }
+
+    alignas(32) float best_v[W];
+    alignas(32) float second_v[W];
+    alignas(32) int32_t best_i[W];
+    alignas(32) int32_t second_i[W];
+    _mm256_store_ps(best_v, best);
+    _mm256_store_ps(second_v, second);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(best_i), best_bin);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(second_i), second_bin);
+
+    LaneState<float> lanes[W];
+    for (int l = 0; l < W; ++l) {
+        lanes[l] = {best_v[l], best_i[l], second_v[l], second_i[l]};
+    }
+    for (int t = 0; k < n; ++k, ++t) {
+        const float mag = power(spectrum[k]);
+        if (mag_out != nullptr) {
+            mag_out[k] = mag;
+        }
+        lane_update(lanes[t], mag, k);
+    }
+    return merge_lanes<float, PeakPair>(lanes, W);
+}
+
+__attribute__((target("avx2")))
+inline void q15_lane_step_avx2(__m256i mag, __m256i bins,
+                               __m256i& best, __m256i& best_bin,
+                               __m256i& second, __m256i& second_bin)
+{
+    const __m256i gt_best = _mm256_cmpgt_epi64(mag, best);
+    const __m256i gt_second = _mm256_andnot_si256(gt_best, _mm256_cmpgt_epi64(mag, second));
+    second = _mm256_blendv_epi8(second, best, gt_best);
+    second_bin = _mm256_blendv_epi8(second_bin, best_bin, gt_best);
+    second = _mm256_blendv_epi8(second, mag, gt_second);
+    second_bin = _mm256_blendv_epi8(second_bin, bins, gt_second);
+    best = _mm256_blendv_epi8(best, mag, gt_best);
+    best_bin = _mm256_blendv_epi8(best_bin, bins, gt_best);
+}
+
+__attribute__((target("avx2")))
+PeakPairQ15 find_two_peaks_q15_avx2(const int16_t* spectrum_iq, int n)
+{
+    // 8 bins per load; |X|² via madd (re·re + im·im, exact in uint32)
+    // widened to int64 and tracked in 4 lanes.
+    constexpr int W = 4;
+    __m256i best = _mm256_set1_epi64x(-1);
+    __m256i second = best;
+    __m256i best_bin = _mm256_setzero_si256();
+    __m256i second_bin = best_bin;
+    __m256i bins = _mm256_setr_epi64x(0, 1, 2, 3);
+    const __m256i step = _mm256_set1_epi64x(W);
+
+    int k = 0;
+    for (; k + 2 * W <= n; k += 2 * W) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(spectrum_iq + 2 * k));
+        const __m256i p = _mm256_madd_epi16(v, v);
+        const __m256i lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(p));
+        const __m256i hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(p, 1));
+        q15_lane_step_avx2(lo, bins, best, best_bin, second, second_bin);
+        bins = _mm256_add_epi64(bins, step);
+        q15_lane_step_avx2(hi, bins, best, best_bin, second, second_bin);
+        bins = _mm256_add_epi64(bins, step);
+    }
+
+    alignas(32) int64_t best_v[W];
+    alignas(32) int64_t second_v[W];
+    alignas(32) int64_t best_i[W];
+    alignas(32) int64_t second_i[W];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(best_v), best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(second_v), second);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(best_i), best_bin);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(second_i), second_bin);
+
+    LaneState<int64_t> lanes[W];
+    for (int l = 0; l < W; ++l) {
+        lanes[l] = {best_v[l], static_cast<int>(best_i[l]),
+                    second_v[l], static_cast<int>(second_i[l])};
+    }
+    for (; k < n; ++k) {
+        lane_update(lanes[k % W], power_q15(spectrum_iq + 2 * k), k);
+    }
+    return merge_lanes<int64_t, PeakPairQ15>(lanes, W);
+}
+
+// 16 int8 (8 complex) per iteration: sign-extend 8 at a time to int32.
+__attribute__((target("avx2")))
+void int8_to_cf32_avx2(const int8_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    const __m256 scale = _mm256_set1_ps(kInt8Scale);
+    float* dst = reinterpret_cast<float*>(out);
+    std::size_t k = 0;
+    for (; k + 8 <= n_samples; k += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iq + 2 * k));
+        const __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(raw));
+        const __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(raw, 8)));
+        _mm256_storeu_ps(dst + 2 * k, _mm256_mul_ps(lo, scale));
+        _mm256_storeu_ps(dst + 2 * k + 8, _mm256_mul_ps(hi, scale));
+    }
+    int8_to_cf32_scalar_from(iq, k, n_samples, out);
+}
+
+__attribute__((target("avx2")))
+void int16_to_cf32_avx2(const int16_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    float* dst = reinterpret_cast<float*>(out);
+    std::size_t k = 0;
+    for (; k + 4 <= n_samples; k += 4) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iq + 2 * k));
+        const __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw));
+        _mm256_storeu_ps(dst + 2 * k, _mm256_mul_ps(v, scale));
+    }
+    int16_to_cf32_scalar_from(iq, k, n_samples, out);
+}
+
+__attribute__((target("avx2")))
+void int8_to_q15_avx2(const int8_t* iq, std::size_t n_samples, int16_t* out_iq)
+{
+    std::size_t k = 0;
+    for (; k + 8 <= n_samples; k += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iq + 2 * k));
+        const __m256i v = _mm256_slli_epi16(_mm256_cvtepi8_epi16(raw), 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_iq + 2 * k), v);
+    }
+    int8_to_q15_scalar_from(iq, k, n_samples, out_iq);
+}
+
+__attribute__((target("avx2")))
+void dot_rows_avx2(const std::complex<float>* x,
+                   const std::complex<float>* rows,
+                   int n,
+                   int count,
+                   std::complex<float>* out)
+{
+    const auto* xf = reinterpret_cast<const float*>(x);
+    for (int r = 0; r < count; ++r) {
+        const auto* row = rows + static_cast<std::size_t>(r) * n;
+        const auto* rf = reinterpret_cast<const float*>(row);
+        __m256 lo = _mm256_setzero_ps();   // lanes 0–3
+        __m256 hi = _mm256_setzero_ps();   // lanes 4–7
+        int k = 0;
+        for (; k + kDotLanes <= n; k += kDotLanes) {
+            lo = _mm256_add_ps(lo, cmul_avx2(_mm256_loadu_ps(xf + 2 * k), _mm256_loadu_ps(rf + 2 * k)));
+            hi = _mm256_add_ps(hi, cmul_avx2(_mm256_loadu_ps(xf + 2 * k + 8), _mm256_loadu_ps(rf + 2 * k + 8)));
+        }
+        std::complex<float> lanes[kDotLanes];
+        _mm256_storeu_ps(reinterpret_cast<float*>(lanes), lo);
+        _mm256_storeu_ps(reinterpret_cast<float*>(lanes + 4), hi);
+        dot_rows_scalar_from(x, row, k, n, lanes);
+        out[r] = sum_lanes(lanes);
+    }
+}
+
+constexpr KernelTable kAvx2Table{
+    Isa::avx2,
+    dechirp_avx2,
+    dechirp_fold_avx2,
+    dechirp_split_avx2,
+    find_two_peaks_avx2,
+    find_two_peaks_q15_avx2,
+    int8_to_cf32_avx2,
+    int16_to_cf32_avx2,
+    int8_to_q15_avx2,
+    dot_rows_avx2,
+};
+
+// ── AVX-512F (8 complex / 16 floats per vector) ──
+
+__attribute__((target("avx512f")))
+inline __m512 cmul_avx512(__m512 a, __m512 b)
+{
+    // No addsub in AVX-512: negate the even lanes of the cross term and add,
+    // which rounds exactly like the scalar subtraction.
+    const __m512i even_sign = _mm512_set_epi32(
+        0, INT32_MIN, 0, INT32_MIN, 0, INT32_MIN, 0, INT32_MIN,
+        0, INT32_MIN, 0, INT32_MIN, 0, INT32_MIN, 0, INT32_MIN);
+    // Masked forms with a zeroed source: the unmasked intrinsics pass an
+    // undefined vector through, which GCC flags as maybe-uninitialized in
+    // every LTO link that inlines this.
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 br = _mm512_mask_moveldup_ps(zero, 0xFFFF, b);
+    const __m512 bi = _mm512_mask_movehdup_ps(zero, 0xFFFF, b);
+    const __m512 a_swapped = _mm512_mask_permute_ps(zero, 0xFFFF, a, 0xB1);
+    const __m512 cross = _mm512_castsi512_ps(_mm512_xor_si512(
+        _mm512_castps_si512(_mm512_mul_ps(a_swapped, bi)), even_sign));
+    return _mm512_add_ps(_mm512_mul_ps(a, br), cross);
+}
+
+__attribute__((target("avx512f")))
+inline __m512 load8_avx512(const std::complex<float>* p, int stride, __m512i gather_idx)
+{
+    if (stride == 1) {
+        return _mm512_loadu_ps(reinterpret_cast<const float*>(p));
+    }
+    return _mm512_castpd_ps(_mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, gather_idx,
+                                                     reinterpret_cast<const double*>(p), 8));
+}
+
+__attribute__((target("avx512f")))
+void dechirp_avx512(const std::complex<float>* samples,
+                    const std::complex<float>* rotation,
+                    const std::complex<float>* chirp,
+                    int n,
+                    int stride,
+                    int chirp_stride,
+                    std::complex<float>* out)
+{
+    const long long s = stride;
+    const long long c = chirp_stride;
+    const __m512i gather_idx = _mm512_set_epi64(7 * s, 6 * s, 5 * s, 4 * s, 3 * s, 2 * s, s, 0);
+    const __m512i chirp_idx = _mm512_set_epi64(7 * c, 6 * c, 5 * c, 4 * c, 3 * c, 2 * c, c, 0);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m512 v = load8_avx512(samples + static_cast<std::size_t>(k) * stride, stride, gather_idx);
+        if (rotation != nullptr) {
+            v = cmul_avx512(v, _mm512_loadu_ps(reinterpret_cast<const float*>(rotation + k)));
+        }
+        v = cmul_avx512(v, load8_avx512(chirp + static_cast<std::size_t>(k) * chirp_stride, chirp_stride,
+                                        chirp_idx));
+        _mm512_storeu_ps(reinterpret_cast<float*>(out + k), v);
+    }
+    dechirp_scalar_from(samples, rotation, chirp, k, n, stride, chirp_stride, out);
+}
+
+__attribute__((target("avx512f")))
+void dechirp_fold_avx512(const std::complex<float>* samples,
+                         const std::complex<float>* chirp,
+                         int n,
+                         int os,
+                         int fold_stride,
+                         std::complex<float>* out)
+{
+    const long long s = os;
+    const __m512i gather_idx = _mm512_set_epi64(7 * s, 6 * s, 5 * s, 4 * s, 3 * s, 2 * s, s, 0);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m512 acc = _mm512_setzero_ps();
+        for (int m = 0; m < os; m += fold_stride) {
+            const std::size_t idx = static_cast<std::size_t>(k) * os + m;
+            acc = _mm512_add_ps(acc, cmul_avx512(load8_avx512(samples + idx, os, gather_idx),
+                                                 load8_avx512(chirp + idx, os, gather_idx)));
+        }
+        _mm512_storeu_ps(reinterpret_cast<float*>(out + k), acc);
+    }
+    dechirp_fold_scalar_from(samples, chirp, k, n, os, fold_stride, out);
+}
+
+__attribute__((target("avx512f")))
+void dechirp_split_avx512(const float* re,
+                          const float* im,
+                          const std::complex<float>* rotation,
+                          const float* chirp_re,
+                          const float* chirp_im,
+                          int n,
+                          std::complex<float>* out)
+{
+    const __m512i even = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i odd = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+    const __m512i low_pairs = _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0);
+    const __m512i high_pairs = _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8);
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m512 vr = _mm512_loadu_ps(re + k);
+        __m512 vi = _mm512_loadu_ps(im + k);
+        if (rotation != nullptr) {
+            const auto* r = reinterpret_cast<const float*>(rotation + k);
+            const __m512 lo = _mm512_loadu_ps(r);
+            const __m512 hi = _mm512_loadu_ps(r + 16);
+            const __m512 rr = _mm512_permutex2var_ps(lo, even, hi);
+            const __m512 ri = _mm512_permutex2var_ps(lo, odd, hi);
+            const __m512 tr = _mm512_sub_ps(_mm512_mul_ps(vr, rr), _mm512_mul_ps(vi, ri));
+            vi = _mm512_add_ps(_mm512_mul_ps(vr, ri), _mm512_mul_ps(vi, rr));
+            vr = tr;
+        }
+        const __m512 cr = _mm512_loadu_ps(chirp_re + k);
+        const __m512 ci = _mm512_loadu_ps(chirp_im + k);
+        const __m512 yr = _mm512_sub_ps(_mm512_mul_ps(vr, cr), _mm512_mul_ps(vi, ci));
+        const __m512 yi = _mm512_add_ps(_mm512_mul_ps(vr, ci), _mm512_mul_ps(vi, cr));
+        auto* y = reinterpret_cast<float*>(out + k);
+        _mm512_storeu_ps(y, _mm512_permutex2var_ps(yr, low_pairs, yi));
+        _mm512_storeu_ps(y + 16, _mm512_permutex2var_ps(yr, high_pairs, yi));
+    }
+    dechirp_split_scalar_from(re, im, rotation, chirp_re, chirp_im, k, n, out);
+}
+
+__attribute__((target("avx512f")))
+PeakPair find_two_peaks_avx512(const std::complex<float>* spectrum, int n, float* mag_out)
+{
+    constexpr int W = 16;
+    const float* x = reinterpret_cast<const float*>(spectrum);
+    const __m512i re_idx = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14,
+                                             16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i im_idx = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15,
+                                             17, 19, 21, 23, 25, 27, 29, 31);
+    __m512 best = _mm512_set1_ps(-1.0f);
+    __m512 second = best;
+    __m512i best_bin = _mm512_setzero_si512();
+    __m512i second_bin = best_bin;
+    __m512i bins = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                     8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i step = _mm512_set1_epi32(W);
+
+    int k = 0;
+    for (; k + W <= n; k += W) {
+        const __m512 a = _mm512_loadu_ps(x + 2 * k);
+        const __m512 b = _mm512_loadu_ps(x + 2 * k + 16);
+        const __m512 re = _mm512_permutex2var_ps(a, re_idx, b);
+        const __m512 im = _mm512_permutex2var_ps(a, im_idx, b);
+        const __m512 mag = _mm512_add_ps(_mm512_mul_ps(re, re), _mm512_mul_ps(im, im));
+        if (mag_out != nullptr) {
+            _mm512_storeu_ps(mag_out + k, mag);
+        }
+
+        const __mmask16 gt_best = _mm512_cmp_ps_mask(mag, best, _CMP_GT_OQ);
+        const __mmask16 gt_second = static_cast<__mmask16>(
+            ~gt_best & _mm512_cmp_ps_mask(mag, second, _CMP_GT_OQ));
+        second = _mm512_mask_blend_ps(gt_best, second, best);
+        second_bin = _mm512_mask_blend_epi32(gt_best, second_bin, best_bin);
+        second = _mm512_mask_blend_ps(gt_second, second, mag);
+        second_bin = _mm512_mask_blend_epi32(gt_second, second_bin, bins);
+        best = _mm512_mask_blend_ps(gt_best, best, mag);
+        best_bin = _mm512_mask_blend_epi32(gt_best, best_bin, bins);
+        bins = _mm512_add_epi32(bins, step);
+    }
+
+    alignas(64) float best_v[W];
+    alignas(64) float second_v[W];
+    alignas(64) int32_t best_i[W];
+    alignas(64) int32_t second_i[W];
+    _mm512_store_ps(best_v, best);
+    _mm512_store_ps(second_v, second);
+    _mm512_store_si512(best_i, best_bin);
+    _mm512_store_si512(second_i, second_bin);
+
+    LaneState<float> lanes[W];
+    for (int l = 0; l < W; ++l) {
+        lanes[l] = {best_v[l], best_i[l], second_v[l], second_i[l]};
+    }
+    for (int t = 0; k < n; ++k, ++t) {
+        const float mag = power(spectrum[k]);
+        if (mag_out != nullptr) {
+            mag_out[k] = mag;
+        }
+        lane_update(lanes[t], mag, k);
+    }
+    return merge_lanes<float, PeakPair>(lanes, W);
+}
+
+__attribute__((target("avx512f")))
+void int8_to_cf32_avx512(const int8_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    const __m512 scale = _mm512_set1_ps(kInt8Scale);
+    float* dst = reinterpret_cast<float*>(out);
+    std::size_t k = 0;
+    for (; k + 8 <= n_samples; k += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iq + 2 * k));
+        // Zero-masking forms: see cmul_avx512.
+        const __m512 v = _mm512_maskz_cvtepi32_ps(0xFFFF, _mm512_maskz_cvtepi8_epi32(0xFFFF, raw));
+        _mm512_storeu_ps(dst + 2 * k, _mm512_mul_ps(v, scale));
+    }
+    int8_to_cf32_scalar_from(iq, k, n_samples, out);
+}
+
+__attribute__((target("avx512f")))
+void int16_to_cf32_avx512(const int16_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    const __m512 scale = _mm512_set1_ps(kInt16Scale);
+    float* dst = reinterpret_cast<float*>(out);
+    std::size_t k = 0;
+    for (; k + 8 <= n_samples; k += 8) {
+        const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(iq + 2 * k));
+        const __m512 v = _mm512_maskz_cvtepi32_ps(0xFFFF, _mm512_maskz_cvtepi16_epi32(0xFFFF, raw));
+        _mm512_storeu_ps(dst + 2 * k, _mm512_mul_ps(v, scale));
+    }
+    int16_to_cf32_scalar_from(iq, k, n_samples, out);
+}
+
+__attribute__((target("avx512f")))
+void dot_rows_avx512(const std::complex<float>* x,
+                     const std::complex<float>* rows,
+                     int n,
+                     int count,
+                     std::complex<float>* out)
+{
+    const auto* xf = reinterpret_cast<const float*>(x);
+    for (int r = 0; r < count; ++r) {
+        const auto* row = rows + static_cast<std::size_t>(r) * n;
+        const auto* rf = reinterpret_cast<const float*>(row);
+        __m512 acc = _mm512_setzero_ps();
+        int k = 0;
+        for (; k + kDotLanes <= n; k += kDotLanes) {
+            acc = _mm512_add_ps(acc, cmul_avx512(_mm512_loadu_ps(xf + 2 * k), _mm512_loadu_ps(rf + 2 * k)));
+        }
+        std::complex<float> lanes[kDotLanes];
+        _mm512_storeu_ps(reinterpret_cast<float*>(lanes), acc);
+        dot_rows_scalar_from(x, row, k, n, lanes);
+        out[r] = sum_lanes(lanes);
+    }
+}
+
+// The Q15 peak search is bound by the int64 compares and the int8 → Q15
+// widening needs 16-bit lanes; AVX2 is as wide as either usefully gets
+// without AVX-512BW, so the AVX-512 table reuses those variants.
+constexpr KernelTable kAvx512Table{
+    Isa::avx512,
+    dechirp_avx512,
+    dechirp_fold_avx512,
+    dechirp_split_avx512,
+    find_two_peaks_avx512,
+    find_two_peaks_q15_avx2,
+    int8_to_cf32_avx512,
+    int16_to_cf32_avx512,
+    int8_to_q15_avx2,
+    dot_rows_avx512,
+};
+
+#endif // HOST_SIM_KERNELS_X86
+
+#if defined(HOST_SIM_KERNELS_NEON)
+
+// ── NEON (4 complex, split re/im via vld2q) ──
+
+inline void cmul_neon(float32x4_t ar, float32x4_t ai, float32x4_t br, float32x4_t bi,
+                      float32x4_t& re, float32x4_t& im)
+{
+    re = vsubq_f32(vmulq_f32(ar, br), vmulq_f32(ai, bi));
+    im = vaddq_f32(vmulq_f32(ar, bi), vmulq_f32(ai, br));
+}
+
+inline float32x4x2_t load4_neon(const std::complex<float>* p, int stride)
+{
+    if (stride == 1) {
+        return vld2q_f32(reinterpret_cast<const float*>(p));
+    }
+    float32x4x2_t v;
+    const float lanes_re[4] = {p[0].real(), p[stride].real(), p[2 * stride].real(), p[3 * stride].real()};
+    const float lanes_im[4] = {p[0].imag(), p[stride].imag(), p[2 * stride].imag(), p[3 * stride].imag()};
+    v.val[0] = vld1q_f32(lanes_re);
+    v.val[1] = vld1q_f32(lanes_im);
+    return v;
+}
+
+void dechirp_neon(const std::complex<float>* samples,
+                  const std::complex<float>* rotation,
+                  const std::complex<float>* chirp,
+                  int n,
+                  int stride,
+                  int chirp_stride,
+                  std::complex<float>* out)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        float32x4x2_t v = load4_neon(samples + static_cast<std::size_t>(k) * stride, stride);
+        if (rotation != nullptr) {
+            const float32x4x2_t r = vld2q_f32(reinterpret_cast<const float*>(rotation + k));
+            cmul_neon(v.val[0], v.val[1], r.val[0], r.val[1], v.val[0], v.val[1]);
+        }
+        const float32x4x2_t c = load4_neon(chirp + static_cast<std::size_t>(k) * chirp_stride, chirp_stride);
+        float32x4x2_t result;
+        cmul_neon(v.val[0], v.val[1], c.val[0], c.val[1], result.val[0], result.val[1]);
+        vst2q_f32(reinterpret_cast<float*>(out + k), result);
+    }
+    dechirp_scalar_from(samples, rotation, chirp, k, n, stride, chirp_stride, out);
+}
+
+void dechirp_fold_neon(const std::complex<float>* samples,
+                       const std::complex<float>* chirp,
+                       int n,
+                       int os,
+                       int fold_stride,
+                       std::complex<float>* out)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        float32x4x2_t acc;
+        acc.val[0] = vdupq_n_f32(0.0f);
+        acc.val[1] = vdupq_n_f32(0.0f);
+        for (int m = 0; m < os; m += fold_stride) {
+            const std::size_t idx = static_cast<std::size_t>(k) * os + m;
+            const float32x4x2_t s = load4_neon(samples + idx, os);
+            const float32x4x2_t c = load4_neon(chirp + idx, os);
+            float32x4_t re;
+            float32x4_t im;
+            cmul_neon(s.val[0], s.val[1], c.val[0], c.val[1], re, im);
+            acc.val[0] = vaddq_f32(acc.val[0], re);
+            acc.val[1] = vaddq_f32(acc.val[1], im);
+        }
+        vst2q_f32(reinterpret_cast<float*>(out + k), acc);
+    }
+    dechirp_fold_scalar_from(samples, chirp, k, n, os, fold_stride, out);
+}
+
+void dechirp_split_neon(const float* re,
+                        const float* im,
+                        const std::complex<float>* rotation,
+                        const float* chirp_re,
+                        const float* chirp_im,
+                        int n,
+                        std::complex<float>* out)
+{
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        float32x4_t vr = vld1q_f32(re + k);
+        float32x4_t vi = vld1q_f32(im + k);
+        if (rotation != nullptr) {
+            const float32x4x2_t r = vld2q_f32(reinterpret_cast<const float*>(rotation + k));
+            cmul_neon(vr, vi, r.val[0], r.val[1], vr, vi);
+        }
+        float32x4x2_t result;
+        cmul_neon(vr, vi, vld1q_f32(chirp_re + k), vld1q_f32(chirp_im + k), result.val[0], result.val[1]);
+        vst2q_f32(reinterpret_cast<float*>(out + k), result);
+    }
+    dechirp_split_scalar_from(re, im, rotation, chirp_re, chirp_im, k, n, out);
+}
+
+PeakPair find_two_peaks_neon(const std::complex<float>* spectrum, int n, float* mag_out)
+{
+    constexpr int W = 4;
+    float32x4_t best = vdupq_n_f32(-1.0f);
+    float32x4_t second = best;
+    uint32x4_t best_bin = vdupq_n_u32(0);
+    uint32x4_t second_bin = best_bin;
+    const uint32_t bins_init[W] = {0, 1, 2, 3};
+    uint32x4_t bins = vld1q_u32(bins_init);
+    const uint32x4_t step = vdupq_n_u32(W);
+
+    int k = 0;
+    for (; k + W <= n; k += W) {
+        const float32x4x2_t v = vld2q_f32(reinterpret_cast<const float*>(spectrum + k));
+        const float32x4_t mag = vaddq_f32(vmulq_f32(v.val[0], v.val[0]),
+                                          vmulq_f32(v.val[1], v.val[1]));
+        if (mag_out != nullptr) {
+            vst1q_f32(mag_out + k, mag);
+        }
+        const uint32x4_t gt_best = vcgtq_f32(mag, best);
+        const uint32x4_t gt_second = vbicq_u32(vcgtq_f32(mag, second), gt_best);
+        second = vbslq_f32(gt_best, best, second);
+        second_bin = vbslq_u32(gt_best, best_bin, second_bin);
+        second = vbslq_f32(gt_second, mag, second);
+        second_bin = vbslq_u32(gt_second, bins, second_bin);
+        best = vbslq_f32(gt_best, mag, best);
+        best_bin = vbslq_u32(gt_best, bins, best_bin);
+        bins = vaddq_u32(bins, step);
+    }
+
+    float best_v[W];
+    float second_v[W];
+    uint32_t best_i[W];
+    uint32_t second_i[W];
+    vst1q_f32(best_v, best);
+    vst1q_f32(second_v, second);
+    vst1q_u32(best_i, best_bin);
+    vst1q_u32(second_i, second_bin);
+
+    LaneState<float> lanes[W];
+    for (int l = 0; l < W; ++l) {
+        lanes[l] = {best_v[l], static_cast<int>(best_i[l]),
+                    second_v[l], static_cast<int>(second_i[l])};
+    }
+    for (int t = 0; k < n; ++k, ++t) {
+        const float mag = power(spectrum[k]);
+        if (mag_out != nullptr) {
+            mag_out[k] = mag;
+        }
+        lane_update(lanes[t], mag, k);
+    }
+    return merge_lanes<float, PeakPair>(lanes, W);
+}
+
+void int8_to_cf32_neon(const int8_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    float* dst = reinterpret_cast<float*>(out);
+    std::size_t k = 0;
+    for (; k + 4 <= n_samples; k += 4) {
+        const int16x8_t wide = vmovl_s8(vld1_s8(iq + 2 * k));
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+        vst1q_f32(dst + 2 * k, vmulq_n_f32(lo, kInt8Scale));
+        vst1q_f32(dst + 2 * k + 4, vmulq_n_f32(hi, kInt8Scale));
+    }
+    int8_to_cf32_scalar_from(iq, k, n_samples, out);
+}
+
+void int16_to_cf32_neon(const int16_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    float* dst = reinterpret_cast<float*>(out);
+    std::size_t k = 0;
+    for (; k + 4 <= n_samples; k += 4) {
+        const int16x8_t raw = vld1q_s16(iq + 2 * k);
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw)));
+        vst1q_f32(dst + 2 * k, vmulq_n_f32(lo, kInt16Scale));
+        vst1q_f32(dst + 2 * k + 4, vmulq_n_f32(hi, kInt16Scale));
+    }
+    int16_to_cf32_scalar_from(iq, k, n_samples, out);
+}
+
+void int8_to_q15_neon(const int8_t* iq, std::size_t n_samples, int16_t* out_iq)
+{
+    std::size_t k = 0;
+    for (; k + 8 <= n_samples; k += 8) {
+        const int8x16_t raw = vld1q_s8(iq + 2 * k);
+        vst1q_s16(out_iq + 2 * k, vshlq_n_s16(vmovl_s8(vget_low_s8(raw)), 8));
+        vst1q_s16(out_iq + 2 * k + 8, vshlq_n_s16(vmovl_s8(vget_high_s8(raw)), 8));
+    }
+    int8_to_q15_scalar_from(iq, k, n_samples, out_iq);
+}
+
+// dot_rows() has no NEON variant yet; the scalar loop keeps it exact.
+constexpr KernelTable kNeonTable{
+    Isa::neon,
+    dechirp_neon,
+    dechirp_fold_neon,
+    dechirp_split_neon,
+    find_two_peaks_neon,
+    find_two_peaks_q15_scalar,
+    int8_to_cf32_neon,
+    int16_to_cf32_neon,
+    int8_to_q15_neon,
+    dot_rows_scalar,
+};
+
+#endif // HOST_SIM_KERNELS_NEON
+
+// ── Dispatch ──
+
+const KernelTable* table_for(Isa isa)
+{
+#if defined(HOST_SIM_KERNELS_X86)
+    __builtin_cpu_init();
+#endif
+    switch (isa) {
+    case Isa::scalar:
+        return &kScalarTable;
+#if defined(HOST_SIM_KERNELS_X86)
+    case Isa::avx2:
+        return __builtin_cpu_supports("avx2") ? &kAvx2Table : nullptr;
+    case Isa::avx512:
+        return __builtin_cpu_supports("avx512f") ? &kAvx512Table : nullptr;
+#endif
+#if defined(HOST_SIM_KERNELS_NEON)
+    case Isa::neon:
+        return &kNeonTable;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const KernelTable* select_default()
+{
+    if (const char* forced = std::getenv("HOST_SIM_KERNEL_ISA")) {
+        const std::string_view name(forced);
+        for (Isa isa : {Isa::scalar, Isa::avx2, Isa::avx512, Isa::neon}) {
+            if (name == isa_name(isa)) {
+                if (const KernelTable* table = table_for(isa)) {
+                    return table;
+                }
+            }
+        }
+    }
+    for (Isa isa : {Isa::avx512, Isa::avx2, Isa::neon}) {
+        if (const KernelTable* table = table_for(isa)) {
+            return table;
+        }
+    }
+    return &kScalarTable;
+}
+
+std::atomic<const KernelTable*>& current_table()
+{
+    static std::atomic<const KernelTable*> table{select_default()};
+    return table;
+}
+
+inline const KernelTable& kernels()
+{
+    return *current_table().load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+Isa active_isa()
+{
+    return kernels().isa;
+}
+
+const char* isa_name(Isa isa)
+{
+    switch (isa) {
+    case Isa::scalar:
+        return "scalar";
+    case Isa::avx2:
+        return "avx2";
+    case Isa::avx512:
+        return "avx512";
+    case Isa::neon:
+        return "neon";
+    }
+    return "unknown";
+}
+
+bool isa_supported(Isa isa)
+{
+    return table_for(isa) != nullptr;
+}
+
+bool set_isa(Isa isa)
+{
+    const KernelTable* table = table_for(isa);
+    if (table == nullptr) {
+        return false;
+    }
+    current_table().store(table, std::memory_order_relaxed);
+    return true;
+}
+
+void dechirp(const std::complex<float>* samples,
+             const std::complex<float>* rotation,
+             const std::complex<float>* chirp,
+             int n,
+             int stride,
+             std::complex<float>* out)
+{
+    kernels().dechirp(samples, rotation, chirp, n, stride, stride, out);
+}
+
+void dechirp_decimated(const std::complex<float>* samples,
+                       const std::complex<float>* rotation,
+                       const std::complex<float>* taps,
+                       int n,
+                       int stride,
+                       std::complex<float>* out)
+{
+    kernels().dechirp(samples, rotation, taps, n, stride, 1, out);
+}
+
+void dechirp_fold(const std::complex<float>* samples,
+                  const std::complex<float>* chirp,
+                  int n,
+                  int os,
+                  int fold_stride,
+                  std::complex<float>* out)
+{
+    kernels().dechirp_fold(samples, chirp, n, os, fold_stride, out);
+}
+
+void dechirp_split(const float* re,
+                   const float* im,
+                   const std::complex<float>* rotation,
+                   const float* chirp_re,
+                   const float* chirp_im,
+                   int n,
+                   std::complex<float>* out)
+{
+    kernels().dechirp_split(re, im, rotation, chirp_re, chirp_im, n, out);
+}
+
+void magnitude_sq(const std::complex<float>* spectrum, int n, float* out)
+{
+    kernels().find_two_peaks(spectrum, n, out);
+}
+
+PeakPair find_two_peaks(const std::complex<float>* spectrum, int n, float* mag_out)
+{
+    return kernels().find_two_peaks(spectrum, n, mag_out);
+}
+
+PeakPairQ15 find_two_peaks_q15(const int16_t* spectrum_iq, int n)
+{
+    return kernels().find_two_peaks_q15(spectrum_iq, n);
+}
+
+void int8_to_cf32(const int8_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    kernels().int8_to_cf32(iq, n_samples, out);
+}
+
+void int16_to_cf32(const int16_t* iq, std::size_t n_samples, std::complex<float>* out)
+{
+    kernels().int16_to_cf32(iq, n_samples, out);
+}
+
+void int8_to_q15(const int8_t* iq, std::size_t n_samples, int16_t* out_iq)
+{
+    kernels().int8_to_q15(iq, n_samples, out_iq);
+}
+
+void dot_rows(const std::complex<float>* x,
+              const std::complex<float>* rows,
+              int n,
+              int count,
+              std::complex<float>* out)
+{
+    kernels().dot_rows(x, rows, n, count, out);
+}
+
+} // namespace host_sim::kernels
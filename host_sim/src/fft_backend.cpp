@@ -0,0 +1,341 @@
+#include "host_sim/fft_backend.hpp"
+
+#include "host_sim/gpu_demod.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern "C" {
+#include "kiss_fft.h"
+}
+
+#if defined(HOST_SIM_WITH_FFTW)
+#include <fftw3.h>
+#endif
+
+#ifndef HOST_SIM_FFT_DEFAULT_BACKEND
+#define HOST_SIM_FFT_DEFAULT_BACKEND kissfft
+#endif
+
+namespace host_sim
+{
+
+namespace
+{
+
+static_assert(sizeof(kiss_fft_cpx) == sizeof(std::complex<float>));
+
+// ── KissFFT (vendored, default) ──
+
+class KissFftPlan final : public FftPlan
+{
+public:
+    explicit KissFftPlan(int size)
+        : FftPlan(size), cfg_(kiss_fft_alloc(size, 0, nullptr, nullptr))
+    {
+        if (!cfg_) {
+            throw std::runtime_error("Failed to allocate KISS FFT configuration");
+        }
+    }
+
+    ~KissFftPlan() override { free(cfg_); }
+
+    KissFftPlan(const KissFftPlan&) = delete;
+    KissFftPlan& operator=(const KissFftPlan&) = delete;
+
+    void forward(const std::complex<float>* in, std::complex<float>* out) const override
+    {
+        // Out-of-place kiss_fft only reads the config, so this is reentrant.
+        kiss_fft(cfg_, reinterpret_cast<const kiss_fft_cpx*>(in),
+                 reinterpret_cast<kiss_fft_cpx*>(out));
+    }
+
+private:
+    kiss_fft_cfg cfg_;
+};
+
+// ── In-tree radix-4 (power-of-two sizes) ──
+//
+// Iterative decimation-in-time: bit-reversed load, one radix-2 stage when
+// log2(N) is odd, then radix-4 stages.  Within each group of 4L outputs
+// the four length-L sub-DFTs hold residues 0, 2, 1, 3 (mod 4) of the
+// input, so a single butterfly merges what would be two radix-2 stages:
+//   X[k]    = a + b + (c + d)      X[k+2L] = a + b − (c + d)
+//   X[k+L]  = a − b − j(c − d)     X[k+3L] = a − b + j(c − d)
+// with a = r0, b = W²ᵏ·r2, c = Wᵏ·r1, d = W³ᵏ·r3 and W = e^{-j2π/4L}.
+// Twiddles are computed in double and stored contiguously per stage.
+
+class Radix4FftPlan final : public FftPlan
+{
+public:
+    explicit Radix4FftPlan(int size) : FftPlan(size)
+    {
+        int log2n = 0;
+        while ((1 << log2n) < size) {
+            ++log2n;
+        }
+        bitrev_.resize(static_cast<std::size_t>(size));
+        for (int i = 0; i < size; ++i) {
+            uint32_t r = 0;
+            for (int b = 0; b < log2n; ++b) {
+                r |= ((static_cast<uint32_t>(i) >> b) & 1u) << (log2n - 1 - b);
+            }
+            bitrev_[static_cast<std::size_t>(i)] = r;
+        }
+        radix2_first_ = (log2n % 2) != 0;
+        for (int len = radix2_first_ ? 2 : 1; len < size; len *= 4) {
+            const double step = -2.0 * std::numbers::pi / (4.0 * len);
+            for (int k = 0; k < len; ++k) {
+                for (int r = 1; r <= 3; ++r) {
+                    const std::complex<double> w = std::polar(1.0, step * r * k);
+                    twiddles_.emplace_back(static_cast<float>(w.real()),
+                                           static_cast<float>(w.imag()));
+                }
+            }
+        }
+    }
+
+    void forward(const std::complex<float>* in, std::complex<float>* out) const override
+    {
+        const int n = size();
+        for (int i = 0; i < n; ++i) {
+            out[i] = in[bitrev_[static_cast<std::size_t>(i)]];
+        }
+
+        int len = 1;
+        if (radix2_first_) {
+            for (int i = 0; i < n; i += 2) {
+                const std::complex<float> a = out[i];
+                const std::complex<float> b = out[i + 1];
+                out[i] = a + b;
+                out[i + 1] = a - b;
+            }
+            len = 2;
+        }
+
+        const std::complex<float>* tw = twiddles_.data();
+        for (; len < n; len *= 4) {
+            for (int group = 0; group < n; group += 4 * len) {
+                std::complex<float>* x0 = out + group;
+                std::complex<float>* x1 = x0 + len;
+                std::complex<float>* x2 = x1 + len;
+                std::complex<float>* x3 = x2 + len;
+                for (int k = 0; k < len; ++k) {
+                    const std::complex<float> a = x0[k];
+                    const std::complex<float> b = mul(x1[k], tw[3 * k + 1]);
+                    const std::complex<float> c = mul(x2[k], tw[3 * k]);
+                    const std::complex<float> d = mul(x3[k], tw[3 * k + 2]);
+                    const std::complex<float> s0 = a + b;
+                    const std::complex<float> s1 = a - b;
+                    const std::complex<float> s2 = c + d;
+                    const std::complex<float> s3 = c - d;
+                    // −j·s3 = (s3.imag, −s3.real)
+                    const std::complex<float> js3(s3.imag(), -s3.real());
+                    x0[k] = s0 + s2;
+                    x1[k] = s1 + js3;
+                    x2[k] = s0 - s2;
+                    x3[k] = s1 - js3;
+                }
+            }
+            tw += 3 * len;
+        }
+    }
+
+private:
+    std::vector<uint32_t> bitrev_;
+    std::vector<std::complex<float>> twiddles_;
+    bool radix2_first_{false};
+
+    static std::complex<float> mul(std::complex<float> a, std::complex<float> b)
+    {
+        return {a.real() * b.real() - a.imag() * b.imag(),
+                a.real() * b.imag() + a.imag() * b.real()};
+    }
+};
+
+#if defined(HOST_SIM_WITH_FFTW)
+
+// ── FFTW3 (single precision) ──
+//
+// Planning is not thread-safe in FFTW, so plans are only ever created under
+// plan_mutex() (see fft_plan()).  With HOST_SIM_FFTW_WISDOM pointing to a
+// file, wisdom is imported before the first plan, planning uses
+// FFTW_MEASURE, and the accumulated wisdom is written back after each new
+// plan; without it, FFTW_ESTIMATE keeps start-up cheap.
+
+class FftwPlan final : public FftPlan
+{
+public:
+    explicit FftwPlan(int size) : FftPlan(size)
+    {
+        const char* wisdom = std::getenv("HOST_SIM_FFTW_WISDOM");
+        static const bool imported = wisdom != nullptr &&
+                                     fftwf_import_wisdom_from_filename(wisdom) != 0;
+        (void)imported;
+
+        const unsigned flags = FFTW_UNALIGNED | (wisdom ? FFTW_MEASURE : FFTW_ESTIMATE);
+        fftwf_complex* in = fftwf_alloc_complex(static_cast<std::size_t>(size));
+        fftwf_complex* out = fftwf_alloc_complex(static_cast<std::size_t>(size));
+        plan_ = fftwf_plan_dft_1d(size, in, out, FFTW_FORWARD, flags);
+        fftwf_free(in);
+        fftwf_free(out);
+        if (!plan_) {
+            throw std::runtime_error("Failed to create FFTW plan");
+        }
+        if (wisdom) {
+            fftwf_export_wisdom_to_filename(wisdom);
+        }
+    }
+
+    ~FftwPlan() override { fftwf_destroy_plan(plan_); }
+
+    FftwPlan(const FftwPlan&) = delete;
+    FftwPlan& operator=(const FftwPlan&) = delete;
+
+    void forward(const std::complex<float>* in, std::complex<float>* out) const override
+    {
+        // New-array execute is thread-safe; out-of-place c2c leaves `in` intact.
+        fftwf_execute_dft(plan_,
+                          reinterpret_cast<fftwf_complex*>(const_cast<std::complex<float>*>(in)),
+                          reinterpret_cast<fftwf_complex*>(out));
+    }
+
+private:
+    fftwf_plan plan_{nullptr};
+};
+
+#endif // HOST_SIM_WITH_FFTW
+
+bool is_power_of_two(int n)
+{
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+FftBackend select_backend()
+{
+    if (const char* forced = std::getenv("HOST_SIM_FFT_BACKEND")) {
+        const std::string_view name(forced);
+        for (FftBackend backend : {FftBackend::kissfft, FftBackend::radix4, FftBackend::fftw, FftBackend::cuda}) {
+            if (name == fft_backend_name(backend) && fft_backend_available(backend)) {
+                return backend;
+            }
+        }
+    }
+    return FftBackend::HOST_SIM_FFT_DEFAULT_BACKEND;
+}
+
+std::mutex& plan_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Power-of-two sizes up to 2^kMaxCachedLog2 get a per-thread direct slot.
+constexpr int kMaxCachedLog2 = 20;
+
+} // namespace
+
+FftBackend active_fft_backend()
+{
+    static const FftBackend backend = select_backend();
+    return backend;
+}
+
+const char* fft_backend_name(FftBackend backend)
+{
+    switch (backend) {
+    case FftBackend::kissfft:
+        return "kissfft";
+    case FftBackend::radix4:
+        return "radix4";
+    case FftBackend::fftw:
+        return "fftw";
+    case FftBackend::cuda:
+        return "cuda";
+    }
+    return "unknown";
+}
+
+bool fft_backend_available(FftBackend backend)
+{
+    if (backend == FftBackend::cuda) {
+        return gpu_available();
+    }
+#if defined(HOST_SIM_WITH_FFTW)
+    return true;
+#else
+    return backend != FftBackend::fftw;
+#endif
+}
+
+std::unique_ptr<FftPlan> make_fft_plan(FftBackend backend, int size)
+{
+    if (size <= 0) {
+        throw std::runtime_error("FFT size must be positive");
+    }
+    switch (backend) {
+    case FftBackend::kissfft:
+        return std::make_unique<KissFftPlan>(size);
+    case FftBackend::radix4:
+        if (is_power_of_two(size)) {
+            return std::make_unique<Radix4FftPlan>(size);
+        }
+        return std::make_unique<KissFftPlan>(size);
+    case FftBackend::fftw:
+#if defined(HOST_SIM_WITH_FFTW)
+        return std::make_unique<FftwPlan>(size);
+#else
+        break;
+#endif
+    case FftBackend::cuda:
+        // The GPU only takes whole demodulate_block() batches; a single
+        // transform is not worth the round trip.
+#if defined(HOST_SIM_WITH_CUDA)
+        return make_fft_plan(FftBackend::HOST_SIM_FFT_DEFAULT_BACKEND, size);
+#else
+        break;
+#endif
+    }
+    throw std::runtime_error(std::string("FFT backend not built: ") + fft_backend_name(backend));
+}
+
+const FftPlan& fft_plan(int size)
+{
+    thread_local std::array<const FftPlan*, kMaxCachedLog2 + 1> local_cache{};
+    int slot = -1;
+    if (is_power_of_two(size)) {
+        slot = 0;
+        while ((1 << slot) < size) {
+            ++slot;
+        }
+        if (slot <= kMaxCachedLog2 && local_cache[static_cast<std::size_t>(slot)] != nullptr) {
+            return *local_cache[static_cast<std::size_t>(slot)];
+        }
+    }
+
+    static std::map<int, std::unique_ptr<FftPlan>> plans;
+    const FftPlan* plan = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(plan_mutex());
+        auto& entry = plans[size];
+        if (!entry) {
+            entry = make_fft_plan(active_fft_backend(), size);
+        }
+        plan = entry.get();
+    }
+    if (slot >= 0 && slot <= kMaxCachedLog2) {
+        local_cache[static_cast<std::size_t>(slot)] = plan;
+    }
+    return *plan;
+}
+
+} // namespace host_sim
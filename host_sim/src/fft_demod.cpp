@@ -1,11 +1,14 @@
 #include "host_sim/fft_demod.hpp"
+#include "host_sim/dsp_kernels.hpp"
+#include "host_sim/trace.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <numeric>
-#include <iostream>
 #include <stdexcept>
+#include <iostream>
 
 namespace host_sim
 {
@@ -21,142 +24,297 @@ FftDemodulator::FftDemodulator(int sf, int sample_rate, int bandwidth)
         oversample_factor_ = 1;
     }
     samples_per_symbol_ = n_bins_ * oversample_factor_;
-    chirps_ = build_chirps(sf_, oversample_factor_);
-    initialize_fft();
-}
+    chirps_ = shared_chirps(sf_, oversample_factor_);
 
-FftDemodulator::~FftDemodulator()
-{
-    if (kiss_cfg_ != nullptr) {
-        free(kiss_cfg_);
-        kiss_cfg_ = nullptr;
+    // Decimation tap within each chip group.
+    //
+    // At high oversampling (os > 4, e.g. OTA captures at 2 MHz), we
+    // MUST use base=0.  The LoRa chirp wraps at n_fold = sps - V*os,
+    // which always falls on a chip boundary (multiple of os).  Picking
+    // sample 0 of each chip group guarantees every tap sits inside one
+    // chirp segment, so the N-point FFT peak lands on the correct bin
+    // for any symbol value and any CFO.  Other bases (including the
+    // "middle" base) break because the two chirp segments contribute
+    // with a phase mismatch that shifts the peak for ~28% of symbols.
+    //
+    // At low oversampling (os ≤ 4) we keep the legacy base to stay
+    // bit-exact with the reference demodulator and existing stage files.
+    if (oversample_factor_ <= 4) {
+        base_tap_ = oversample_factor_ / 2;
+        if (oversample_factor_ > 1 && (oversample_factor_ % 2) == 0) {
+            base_tap_ = std::max(0, base_tap_ - 1);
+        }
     }
+    derotator_.configure(n_bins_, oversample_factor_, base_tap_);
+    dechirp_kernel_ = shared_dechirp_kernel(sf_, oversample_factor_, base_tap_);
+    initialize_fft();
 }
 
 void FftDemodulator::initialize_fft()
 {
-    if (kiss_cfg_ != nullptr) {
-        free(kiss_cfg_);
-        kiss_cfg_ = nullptr;
-    }
-    kiss_cfg_ = kiss_fft_alloc(n_bins_, 0, nullptr, nullptr);
-    if (!kiss_cfg_) {
-        throw std::runtime_error("Failed to allocate KISS FFT configuration");
-    }
+    fft_plan_ = &fft_plan(n_bins_);
     fft_in_.resize(n_bins_);
     fft_out_.resize(n_bins_);
+    mag_sq_buf_.resize(n_bins_);
     symbol_counter_ = 0;
 }
 
 void FftDemodulator::compute_fft(const std::complex<float>* symbol_samples,
-                                 kiss_fft_cpx* output) const
+                                 std::complex<float>* output) const
 {
-    for (int bin = 0; bin < n_bins_; ++bin) {
-        std::complex<float> acc{0.0f, 0.0f};
-        for (int m = 0; m < oversample_factor_; ++m) {
-            const int idx = bin * oversample_factor_ + m;
-            acc += symbol_samples[idx] * chirps_.downchirp[idx];
-        }
-        fft_in_[bin].r = acc.real();
-        fft_in_[bin].i = acc.imag();
-    }
+    kernels::dechirp_fold(symbol_samples, chirps_->downchirp.data(), n_bins_,
+                          oversample_factor_, 1, fft_in_.data());
 
-    kiss_fft(kiss_cfg_, fft_in_.data(), fft_out_.data());
+    fft_plan_->forward(fft_in_.data(), fft_out_.data());
+    HOST_SIM_TRACE_COUNT(ffts, 1);
     if (output != nullptr) {
         std::copy(fft_out_.begin(), fft_out_.end(), output);
     }
 }
 
-uint16_t FftDemodulator::demodulate(const std::complex<float>* symbol_samples) const
+namespace
 {
-    static const bool debug_fft = (std::getenv("HOST_SIM_DEBUG_FFT_DETAIL") != nullptr);
-    const float fractional_offset =
-        cfo_frac_ + sfo_slope_ * static_cast<float>(symbol_counter_);
-    const bool apply_sfo = std::abs(sfo_slope_) > 0.0f;
-    const float sfo_factor = apply_sfo
-        ? -2.0f * static_cast<float>(M_PI) * sfo_slope_ * static_cast<float>(symbol_counter_) /
-              static_cast<float>(samples_per_symbol_)
-        : 0.0f;
 
+// Symbols per dechirp/FFT pass in demodulate_block().
+constexpr std::size_t kBlockChunk = 8;
+
+std::size_t block_offset(std::size_t index, double stride)
+{
+    return static_cast<std::size_t>(std::round(static_cast<double>(index) * stride));
+}
+
+// Set by the first CUDA error; the process stays on the CPU after it.
+std::atomic<bool> gpu_failed{false};
+
+// Adjacent near-tie: two neighbouring bins within float rounding of each
+// other are one peak split in two, and the higher bin is kept.
+int peak_bin(const kernels::PeakPair& peaks)
+{
+    if (peaks.second_mag >= 0.0f) {
+        const float diff = peaks.best_mag - peaks.second_mag;
+        const float threshold = peaks.best_mag * 1e-6f + 1e-6f;
+        if (diff < threshold && peaks.second_bin == peaks.best_bin + 1) {
+            return peaks.second_bin;
+        }
+    }
+    return peaks.best_bin;
+}
+
+} // namespace
+
+const std::complex<float>* FftDemodulator::rotation_for(std::size_t symbol_index) const
+{
+    // The rotation ramp comes from derotator_, which only regenerates it
+    // when the combined phase step changes (see derotator.hpp).
+    const double phase_step = Derotator::phase_step(
+        cfo_frac_, sfo_slope_, symbol_index, samples_per_symbol_);
+    return Derotator::is_identity(phase_step) ? nullptr : derotator_.ramp(phase_step).data();
+}
+
+void FftDemodulator::dechirp_symbol(const std::complex<float>* symbol_samples,
+                                    std::size_t symbol_index,
+                                    std::complex<float>* output) const
+{
     // Single-tap decimation with per-sample CFO/SFO phase correction.
-    //
-    // At high oversampling (os > 4, e.g. OTA captures at 2 MHz), we
-    // MUST use base=0.  The LoRa chirp wraps at n_fold = sps - V*os,
-    // which always falls on a chip boundary (multiple of os).  Picking
-    // sample 0 of each chip group guarantees every tap sits inside one
-    // chirp segment, so the N-point FFT peak lands on the correct bin
-    // for any symbol value and any CFO.  Other bases (including the
-    // "middle" base) break because the two chirp segments contribute
-    // with a phase mismatch that shifts the peak for ~28% of symbols.
-    //
-    // At low oversampling (os ≤ 4) we keep the legacy base to stay
-    // bit-exact with the reference demodulator and existing stage files.
-    {
-        int base = 0;
-        if (oversample_factor_ <= 4) {
-            base = oversample_factor_ / 2;
-            if (oversample_factor_ > 1 && (oversample_factor_ % 2) == 0) {
-                base = std::max(0, base - 1);
+    const auto* samples = symbol_samples + base_tap_;
+    const std::complex<float>* rotation = rotation_for(symbol_index);
+    if (dechirp_kernel_) {
+        dechirp_kernel_->dechirp(samples, rotation, output);
+        return;
+    }
+    const auto* downchirp = chirps_->downchirp.data() + base_tap_;
+    kernels::dechirp(samples, rotation, downchirp, n_bins_, oversample_factor_, output);
+}
+
+void FftDemodulator::dechirp_symbol(const PolyphaseSamples& samples,
+                                    std::size_t start,
+                                    std::size_t symbol_index,
+                                    std::complex<float>* output) const
+{
+    if (!dechirp_kernel_) {
+        dechirp_symbol(samples.interleaved().data() + start, symbol_index, output);
+        return;
+    }
+    const std::size_t tap = start + static_cast<std::size_t>(base_tap_);
+    dechirp_kernel_->dechirp_split(samples.real_from(tap), samples.imag_from(tap),
+                                   rotation_for(symbol_index), output);
+}
+
+uint16_t FftDemodulator::demodulate(const std::complex<float>* symbol_samples) const
+{
+    dechirp_symbol(symbol_samples, symbol_counter_, fft_in_.data());
+    fft_plan_->forward(fft_in_.data(), fft_out_.data());
+    HOST_SIM_TRACE_COUNT(ffts, 1);
+    return pick_symbol(fft_out_.data(), mag_sq_buf_.data());
+}
+
+template <typename Dechirp>
+void FftDemodulator::demodulate_windows(std::size_t n_symbols,
+                                        const Dechirp& dechirp,
+                                        uint16_t* out,
+                                        float* residuals,
+                                        float* mag_sq_out) const
+{
+    if (n_symbols == 0) {
+        return;
+    }
+    // With CFO tracking each symbol's derotation depends on the previous
+    // decision, so the batch degenerates to one symbol per pass.
+    const std::size_t chunk = (cfo_track_alpha_ > 0.0f) ? 1 : kBlockChunk;
+    const auto n = static_cast<std::size_t>(n_bins_);
+    block_in_.resize(chunk * n);
+    block_out_.resize(chunk * n);
+
+    for (std::size_t start = 0; start < n_symbols; start += chunk) {
+        const std::size_t count = std::min(chunk, n_symbols - start);
+        for (std::size_t j = 0; j < count; ++j) {
+            dechirp(start + j, symbol_counter_ + j, block_in_.data() + j * n);
+        }
+        fft_plan_->forward_batch(block_in_.data(), block_out_.data(), count);
+        HOST_SIM_TRACE_COUNT(ffts, count);
+        for (std::size_t j = 0; j < count; ++j) {
+            const std::size_t sym = start + j;
+            float* mags = mag_sq_out ? mag_sq_out + sym * n : mag_sq_buf_.data();
+            out[sym] = pick_symbol(block_out_.data() + j * n, mags);
+            if (residuals) {
+                residuals[sym] = last_residual_;
             }
         }
+    }
 
-        for (int bin = 0; bin < n_bins_; ++bin) {
-            const int sample_idx = bin * oversample_factor_ + base;
-
-            const float chip = static_cast<float>(sample_idx) /
-                               static_cast<float>(oversample_factor_);
-            const float phase = -2.0f * static_cast<float>(M_PI) * fractional_offset *
-                                chip / static_cast<float>(n_bins_);
-            std::complex<float> rot(std::cos(phase), std::sin(phase));
-            if (apply_sfo) {
-                const float sfo_phase = sfo_factor * static_cast<float>(sample_idx);
-                rot *= std::complex<float>(std::cos(sfo_phase), std::sin(sfo_phase));
-            }
+    // Leave the last spectrum where get_fft_magnitudes_sq() expects it.
+    const std::size_t last = (n_symbols - 1) % chunk;
+    std::copy_n(block_out_.begin() + static_cast<std::ptrdiff_t>(last * n), n, fft_out_.begin());
+}
 
-            const std::complex<float> value =
-                symbol_samples[sample_idx] * rot * chirps_.downchirp[sample_idx];
-            fft_in_[bin].r = value.real();
-            fft_in_[bin].i = value.imag();
-        }
+void FftDemodulator::demodulate_block(const std::complex<float>* samples,
+                                      std::size_t n_symbols,
+                                      double stride,
+                                      uint16_t* out,
+                                      float* residuals,
+                                      float* mag_sq_out) const
+{
+    if (demodulate_on_gpu(samples, 0, n_symbols, stride, out, residuals, mag_sq_out)) {
+        return;
     }
+    demodulate_windows(
+        n_symbols,
+        [&](std::size_t index, std::size_t symbol_index, std::complex<float>* output) {
+            dechirp_symbol(samples + block_offset(index, stride), symbol_index, output);
+        },
+        out, residuals, mag_sq_out);
+}
 
-    kiss_fft(kiss_cfg_, fft_in_.data(), fft_out_.data());
-
-    int best_bin = 0;
-    int second_bin = 0;
-    float best_mag = -1.0f;
-    float second_mag = -1.0f;
-    for (int bin = 0; bin < n_bins_; ++bin) {
-        const float re = fft_out_[bin].r;
-        const float im = fft_out_[bin].i;
-        const float magnitude_sq = re * re + im * im;
-        if (magnitude_sq > best_mag) {
-            second_mag = best_mag;
-            second_bin = best_bin;
-            best_mag = magnitude_sq;
-            best_bin = bin;
-        } else if (magnitude_sq > second_mag) {
-            second_mag = magnitude_sq;
-            second_bin = bin;
+void FftDemodulator::demodulate_block(const PolyphaseSamples& samples,
+                                      std::size_t first,
+                                      std::size_t n_symbols,
+                                      double stride,
+                                      uint16_t* out,
+                                      float* residuals,
+                                      float* mag_sq_out) const
+{
+    if (samples.oversample_factor() != oversample_factor_) {
+        throw std::runtime_error("FftDemodulator: polyphase planes do not match the oversampling factor");
+    }
+    if (demodulate_on_gpu(samples.interleaved().data(), first, n_symbols, stride, out, residuals, mag_sq_out)) {
+        return;
+    }
+    demodulate_windows(
+        n_symbols,
+        [&](std::size_t index, std::size_t symbol_index, std::complex<float>* output) {
+            dechirp_symbol(samples, first + block_offset(index, stride), symbol_index, output);
+        },
+        out, residuals, mag_sq_out);
+}
+
+bool FftDemodulator::demodulate_on_gpu(const std::complex<float>* samples,
+                                       std::size_t first,
+                                       std::size_t n_symbols,
+                                       double stride,
+                                       uint16_t* out,
+                                       float* residuals,
+                                       float* mag_sq_out) const
+{
+    // CFO tracking feeds each decision into the next derotation, and the
+    // spectra never leave the device.
+    if (n_symbols < kGpuMinBatch || cfo_track_alpha_ > 0.0f || mag_sq_out != nullptr ||
+        active_fft_backend() != FftBackend::cuda || gpu_failed.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    try {
+        const auto gpu = shared_gpu_demodulator(sf_, oversample_factor_, base_tap_);
+        if (!gpu) {
+            return false;
+        }
+        gpu_offsets_.resize(n_symbols);
+        gpu_steps_.resize(n_symbols);
+        gpu_peaks_.resize(n_symbols);
+        for (std::size_t i = 0; i < n_symbols; ++i) {
+            gpu_offsets_[i] = first + block_offset(i, stride);
+            const double w = Derotator::phase_step(cfo_frac_, sfo_slope_, symbol_counter_ + i, samples_per_symbol_);
+            gpu_steps_[i] = Derotator::is_identity(w) ? 0.0 : w;
         }
+        gpu->demodulate(samples, gpu_offsets_.data(), gpu_steps_.data(), n_symbols, gpu_peaks_.data());
+    } catch (const std::exception& e) {
+        if (!gpu_failed.exchange(true)) {
+            std::cerr << "[gpu] " << e.what() << "; demodulating on the CPU from here on\n";
+        }
+        return false;
     }
+    HOST_SIM_TRACE_COUNT(ffts, n_symbols);
 
-    if (second_mag >= 0.0f) {
-        const float diff = best_mag - second_mag;
-        const float threshold = best_mag * 1e-6f + 1e-6f;
-        if (diff < threshold && std::abs(second_bin - best_bin) == 1) {
-            if (second_bin > best_bin) {
-                best_bin = second_bin;
-            }
+    for (std::size_t i = 0; i < n_symbols; ++i) {
+        const GpuPeak& p = gpu_peaks_[i];
+        out[i] = decide_symbol(p.peaks, peak_bin(p.peaks), p.prev_mag, p.next_mag);
+        if (residuals) {
+            residuals[i] = last_residual_;
         }
     }
 
-    const int prev_bin = (best_bin - 1 + n_bins_) % n_bins_;
-    const int next_bin = (best_bin + 1) % n_bins_;
-    const float mag_prev = fft_out_[prev_bin].r * fft_out_[prev_bin].r +
-                           fft_out_[prev_bin].i * fft_out_[prev_bin].i;
-    const float mag_next = fft_out_[next_bin].r * fft_out_[next_bin].r +
-                           fft_out_[next_bin].i * fft_out_[next_bin].i;
+    // get_fft_magnitudes_sq() reads the last spectrum, which stayed on the
+    // device: redo that one window here.
+    dechirp_symbol(samples + gpu_offsets_.back(), symbol_counter_ - 1, fft_in_.data());
+    fft_plan_->forward(fft_in_.data(), fft_out_.data());
+    return true;
+}
+
+std::size_t FftDemodulator::block_capacity(std::size_t n_samples, double stride) const
+{
+    const auto sps = static_cast<std::size_t>(samples_per_symbol_);
+    if (n_samples < sps || stride <= 0.0) {
+        return 0;
+    }
+    auto fits = [&](std::size_t index) { return block_offset(index, stride) + sps <= n_samples; };
+    auto count = static_cast<std::size_t>(static_cast<double>(n_samples - sps) / stride) + 1;
+    while (count > 0 && !fits(count - 1)) {
+        --count;
+    }
+    while (fits(count)) {
+        ++count;
+    }
+    return count;
+}
+
+uint16_t FftDemodulator::pick_symbol(const std::complex<float>* spectrum, float* mag_sq) const
+{
+    // Fused |X|² + two-best argmax; the powers stay in mag_sq for the
+    // interpolation in decide_symbol().
+    const kernels::PeakPair peaks = kernels::find_two_peaks(spectrum, n_bins_, mag_sq);
+    const int bin = peak_bin(peaks);
+    return decide_symbol(peaks, bin, mag_sq[(bin - 1 + n_bins_) % n_bins_], mag_sq[(bin + 1) % n_bins_]);
+}
+
+uint16_t FftDemodulator::decide_symbol(const kernels::PeakPair& peaks,
+                                       int bin,
+                                       float mag_prev,
+                                       float mag_next) const
+{
+    static const bool debug_fft = (std::getenv("HOST_SIM_DEBUG_FFT_DETAIL") != nullptr);
+
+    const int best_bin = bin;
+    const int second_bin = peaks.second_bin;
+    const float best_mag = peaks.best_mag;
+    const float second_mag = peaks.second_mag;
 
     // Log-domain (Gaussian) parabolic interpolation.
     // More accurate than power-domain for sinc/Dirichlet-shaped peaks,
@@ -217,10 +375,7 @@ uint16_t FftDemodulator::demodulate(const std::complex<float>* symbol_samples) c
 
 const std::vector<float>& FftDemodulator::get_fft_magnitudes_sq() const
 {
-    mag_sq_buf_.resize(n_bins_);
-    for (int i = 0; i < n_bins_; ++i) {
-        mag_sq_buf_[i] = fft_out_[i].r * fft_out_[i].r + fft_out_[i].i * fft_out_[i].i;
-    }
+    kernels::magnitude_sq(fft_out_.data(), n_bins_, mag_sq_buf_.data());
     return mag_sq_buf_;
 }
 
@@ -228,24 +383,47 @@ FftDemodulator::FrequencyEstimate FftDemodulator::estimate_frequency_offsets(
     const std::complex<float>* samples,
     int symbol_count) const
 {
-    FrequencyEstimate estimate{};
     if (symbol_count <= 0) {
-        return estimate;
+        return FrequencyEstimate{};
     }
 
-    std::vector<std::vector<std::complex<float>>> fft_vals(
-        symbol_count, std::vector<std::complex<float>>(n_bins_));
-    std::vector<float> power_accum(n_bins_, 0.0f);
-
-    std::vector<kiss_fft_cpx> local_fft(n_bins_);
+    // Same dechirp fold and FFT as compute_fft(), written straight into
+    // the workspace.
+    const auto n = static_cast<std::size_t>(n_bins_);
+    estimate_spectra_.resize(static_cast<std::size_t>(symbol_count) * n);
     for (int sym = 0; sym < symbol_count; ++sym) {
         const std::complex<float>* symbol_ptr =
             samples + static_cast<std::size_t>(sym) * samples_per_symbol_;
-        compute_fft(symbol_ptr, local_fft.data());
+        kernels::dechirp_fold(symbol_ptr, chirps_->downchirp.data(), n_bins_,
+                              oversample_factor_, 1, fft_in_.data());
+        fft_plan_->forward(fft_in_.data(), estimate_spectra_.data() + static_cast<std::size_t>(sym) * n);
+        HOST_SIM_TRACE_COUNT(ffts, 1);
+    }
+    return estimate_frequency_offsets(
+        std::span<const std::complex<float>>(estimate_spectra_.data(), estimate_spectra_.size()),
+        symbol_count);
+}
+
+FftDemodulator::FrequencyEstimate FftDemodulator::estimate_frequency_offsets(
+    std::span<const std::complex<float>> spectra,
+    int symbol_count) const
+{
+    FrequencyEstimate estimate{};
+    if (symbol_count <= 0) {
+        return estimate;
+    }
+    const auto n = static_cast<std::size_t>(n_bins_);
+    if (spectra.size() < static_cast<std::size_t>(symbol_count) * n) {
+        throw std::runtime_error("estimate_frequency_offsets: spectra hold fewer than symbol_count symbols");
+    }
+    auto fft_vals = [&](int sym) { return spectra.data() + static_cast<std::size_t>(sym) * n; };
 
+    std::vector<float>& power_accum = estimate_power_;
+    power_accum.assign(n, 0.0f);
+    for (int sym = 0; sym < symbol_count; ++sym) {
+        const std::complex<float>* spectrum = fft_vals(sym);
         for (int bin = 0; bin < n_bins_; ++bin) {
-            const std::complex<float> value(local_fft[bin].r, local_fft[bin].i);
-            fft_vals[sym][bin] = value;
+            const std::complex<float> value = spectrum[bin];
             const float magnitude_sq =
                 value.real() * value.real() + value.imag() * value.imag();
             power_accum[bin] += magnitude_sq;
@@ -259,8 +437,8 @@ FftDemodulator::FrequencyEstimate FftDemodulator::estimate_frequency_offsets(
     if (symbol_count > 1) {
         std::complex<double> accum{0.0, 0.0};
         for (int sym = 0; sym < symbol_count - 1; ++sym) {
-            const std::complex<double> a = fft_vals[sym][global_bin];
-            const std::complex<double> b = fft_vals[sym + 1][global_bin];
+            const std::complex<double> a = fft_vals(sym)[global_bin];
+            const std::complex<double> b = fft_vals(sym + 1)[global_bin];
             accum += a * std::conj(b);
         }
         if (std::abs(accum) > 0.0) {
@@ -298,15 +476,17 @@ FftDemodulator::FrequencyEstimate FftDemodulator::estimate_frequency_offsets(
 
     if (symbol_count >= 6) {
         // Compute fractional bin for each preamble symbol
-        std::vector<int>    inlier_indices;
-        std::vector<double> inlier_bins;
+        std::vector<int>& inlier_indices = estimate_inlier_symbols_;
+        std::vector<double>& inlier_bins = estimate_inlier_bins_;
+        inlier_indices.clear();
+        inlier_bins.clear();
 
         for (int s = 0; s < symbol_count; ++s) {
             // Find peak bin for this symbol
             int sym_best = 0;
             float sym_best_mag = -1.0f;
             for (int bin = 0; bin < n_bins_; ++bin) {
-                const auto& v = fft_vals[s][bin];
+                const auto& v = fft_vals(s)[bin];
                 const float mag = v.real() * v.real() + v.imag() * v.imag();
                 if (mag > sym_best_mag) {
                     sym_best_mag = mag;
@@ -324,9 +504,9 @@ FftDemodulator::FrequencyEstimate FftDemodulator::estimate_frequency_offsets(
             // keep all measurements on the same baseline).
             const int prev_bin = (global_bin - 1 + n_bins_) % n_bins_;
             const int next_bin = (global_bin + 1) % n_bins_;
-            const auto& vp = fft_vals[s][prev_bin];
-            const auto& vc = fft_vals[s][global_bin];
-            const auto& vn = fft_vals[s][next_bin];
+            const auto& vp = fft_vals(s)[prev_bin];
+            const auto& vc = fft_vals(s)[global_bin];
+            const auto& vn = fft_vals(s)[next_bin];
             const float mp = vp.real() * vp.real() + vp.imag() * vp.imag();
             const float mc = vc.real() * vc.real() + vc.imag() * vc.imag();
             const float mn = vn.real() * vn.real() + vn.imag() * vn.imag();
@@ -1,19 +1,18 @@
 /// Native Q15 LoRa FFT demodulator.
 ///
 /// The downchirp multiply and FFT run entirely in Q15 fixed-point
-/// arithmetic via KissFFT compiled with FIXED_POINT=16.  Only the
+/// arithmetic via Q15Fft (KissFFT compiled with FIXED_POINT=16, or
+/// CMSIS-DSP).  Only the
 /// final parabolic interpolation and CFO-tracking EMA use float.
 
 #include "host_sim/fft_demod_q15.hpp"
+#include "host_sim/dsp_kernels.hpp"
 #include "host_sim/q15.hpp"
 
-extern "C" {
-#include "kiss_fft_q15.h"
-}
-
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <stdexcept>
 
 namespace host_sim
 {
@@ -25,18 +24,23 @@ FftDemodulatorQ15::FftDemodulatorQ15(int sf, int sample_rate, int bandwidth)
       bandwidth_(bandwidth),
       oversample_factor_(std::max(1, sample_rate / bandwidth)),
       samples_per_symbol_((1 << sf) * oversample_factor_),
-      chirps_q15_(build_chirps_q15(sf, oversample_factor_))
+      chirps_q15_(shared_chirps_q15(sf, oversample_factor_)),
+      fft_(n_bins_)
 {
-    kiss_cfg_ = kiss_fft_q15_alloc(n_bins_, 0, nullptr, nullptr);
     fft_in_.resize(n_bins_);
     fft_out_.resize(n_bins_);
-}
+    downchirp_taps_.resize(n_bins_);
 
-FftDemodulatorQ15::~FftDemodulatorQ15()
-{
-    if (kiss_cfg_) {
-        kiss_fft_q15_free(kiss_cfg_);
-        kiss_cfg_ = nullptr;
+    // Base sample selection (same logic as float demod).
+    if (oversample_factor_ <= 4) {
+        base_tap_ = oversample_factor_ / 2;
+        if (oversample_factor_ > 1 && (oversample_factor_ % 2) == 0) {
+            base_tap_ = std::max(0, base_tap_ - 1);
+        }
+    }
+    derotator_.configure(n_bins_, oversample_factor_, base_tap_);
+    for (int bin = 0; bin < n_bins_; ++bin) {
+        downchirp_taps_[bin] = chirps_q15_->downchirp[bin * oversample_factor_ + base_tap_];
     }
 }
 
@@ -61,74 +65,32 @@ void FftDemodulatorQ15::set_cfo_tracking(float alpha, int delay_symbols)
 
 uint16_t FftDemodulatorQ15::demodulate(const Q15Complex* symbol_samples)
 {
-    const float fractional_offset =
-        cfo_frac_ + sfo_slope_ * static_cast<float>(symbol_counter_);
-    const bool apply_sfo = std::abs(sfo_slope_) > 0.0f;
-    const float sfo_factor = apply_sfo
-        ? -2.0f * static_cast<float>(M_PI) * sfo_slope_ *
-              static_cast<float>(symbol_counter_) /
-              static_cast<float>(samples_per_symbol_)
-        : 0.0f;
-
-    // Base sample selection (same logic as float demod).
-    int base = 0;
-    if (oversample_factor_ <= 4) {
-        base = oversample_factor_ / 2;
-        if (oversample_factor_ > 1 && (oversample_factor_ % 2) == 0) {
-            base = std::max(0, base - 1);
-        }
-    }
-
     // Single-tap decimation: downchirp multiply with phase rotation, all Q15.
+    // The rotation ramp is shared with the float demodulator's derotation
+    // engine and only regenerated when the phase step changes.
+    const double phase_step = Derotator::phase_step(
+        cfo_frac_, sfo_slope_, symbol_counter_, samples_per_symbol_);
+    const auto& rotation = derotator_.ramp_q15(phase_step);
     for (int bin = 0; bin < n_bins_; ++bin) {
-        const int sample_idx = bin * oversample_factor_ + base;
-
-        // Per-sample phase rotation for CFO/SFO.
-        const float chip = static_cast<float>(sample_idx) /
-                           static_cast<float>(oversample_factor_);
-        float phase = -2.0f * static_cast<float>(M_PI) * fractional_offset *
-                      chip / static_cast<float>(n_bins_);
-        if (apply_sfo) {
-            phase += sfo_factor * static_cast<float>(sample_idx);
-        }
-        const Q15Complex rot = float_to_q15_complex(std::cos(phase),
-                                                    std::sin(phase));
-
-        // sample × rotation × downchirp — two Q15 complex multiplies.
-        const Q15Complex rotated = q15_mul(symbol_samples[sample_idx], rot);
-        const Q15Complex dechirped = q15_mul(rotated,
-                                             chirps_q15_.downchirp[sample_idx]);
-
-        fft_in_[bin].r = dechirped.real;
-        fft_in_[bin].i = dechirped.imag;
+        fft_in_[bin] = symbol_samples[bin * oversample_factor_ + base_tap_];
     }
 
+    // sample × rotation × downchirp — two Q15 complex multiplies.
+    q15_cmplx_mult(fft_in_.data(), rotation.data(), fft_in_.data(), fft_in_.size());
+    q15_cmplx_mult(fft_in_.data(), downchirp_taps_.data(), fft_in_.data(), fft_in_.size());
+
     // Q15 FFT.
-    kiss_fft_q15(kiss_cfg_,
-                 reinterpret_cast<const kiss_fft_q15_cpx*>(fft_in_.data()),
-                 reinterpret_cast<kiss_fft_q15_cpx*>(fft_out_.data()));
+    fft_.forward(fft_in_.data(), fft_out_.data());
 
     // Peak detection in Q31 (int32 magnitude-squared avoids overflow from
     // int16 * int16 and gives ample dynamic range for comparison).
-    int best_bin = 0;
-    int second_bin = 0;
-    int64_t best_mag = -1;
-    int64_t second_mag = -1;
-    for (int bin = 0; bin < n_bins_; ++bin) {
-        const int32_t re = fft_out_[bin].r;
-        const int32_t im = fft_out_[bin].i;
-        const int64_t mag_sq = static_cast<int64_t>(re) * re +
-                               static_cast<int64_t>(im) * im;
-        if (mag_sq > best_mag) {
-            second_mag = best_mag;
-            second_bin = best_bin;
-            best_mag = mag_sq;
-            best_bin = bin;
-        } else if (mag_sq > second_mag) {
-            second_mag = mag_sq;
-            second_bin = bin;
-        }
-    }
+    static_assert(sizeof(Q15Complex) == 2 * sizeof(int16_t));
+    const kernels::PeakPairQ15 peaks = kernels::find_two_peaks_q15(
+        reinterpret_cast<const int16_t*>(fft_out_.data()), n_bins_);
+    int best_bin = peaks.best_bin;
+    const int second_bin = peaks.second_bin;
+    const int64_t best_mag = peaks.best_mag;
+    const int64_t second_mag = peaks.second_mag;
 
     // Resolve single-bin ambiguity (adjacent bins with near-equal power).
     if (second_mag >= 0) {
@@ -147,8 +109,8 @@ uint16_t FftDemodulatorQ15::demodulate(const Q15Complex* symbol_samples)
     const int next_bin = (best_bin + 1) % n_bins_;
 
     auto mag_sq_f = [&](int b) -> float {
-        const float re = static_cast<float>(fft_out_[b].r);
-        const float im = static_cast<float>(fft_out_[b].i);
+        const float re = static_cast<float>(fft_out_[b].real);
+        const float im = static_cast<float>(fft_out_[b].imag);
         return re * re + im * im;
     };
     const float fp = mag_sq_f(prev_bin);
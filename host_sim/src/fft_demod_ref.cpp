@@ -1,7 +1,9 @@
 #include "host_sim/fft_demod_ref.hpp"
+#include "host_sim/shared_cache.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <stdexcept>
+#include <utility>
 
 namespace host_sim
 {
@@ -26,6 +28,15 @@ std::vector<std::complex<float>> build_downchirp(int sf, int oversample_factor)
     }
     return downchirp;
 }
+
+// Keeps the reference's own chirp formula, but builds it once per (sf, os).
+std::shared_ptr<const std::vector<std::complex<float>>> shared_downchirp(int sf, int oversample_factor)
+{
+    static SharedCache<std::pair<int, int>, std::vector<std::complex<float>>> cache;
+    return cache.get({sf, oversample_factor}, [&] {
+        return std::make_shared<const std::vector<std::complex<float>>>(build_downchirp(sf, oversample_factor));
+    });
+}
 } // namespace
 
 FftDemodReference::FftDemodReference(int sf, int sample_rate, int bandwidth)
@@ -39,24 +50,13 @@ FftDemodReference::FftDemodReference(int sf, int sample_rate, int bandwidth)
         oversample_factor_ = 1;
     }
     samples_per_symbol_ = n_bins_ * oversample_factor_;
-    downchirp_ = build_downchirp(sf_, oversample_factor_);
+    downchirp_ = shared_downchirp(sf_, oversample_factor_);
     initialize_fft();
 }
 
-FftDemodReference::~FftDemodReference()
-{
-    if (kiss_cfg_ != nullptr) {
-        free(kiss_cfg_);
-        kiss_cfg_ = nullptr;
-    }
-}
-
 void FftDemodReference::initialize_fft()
 {
-    kiss_cfg_ = kiss_fft_alloc(n_bins_, 0, nullptr, nullptr);
-    if (!kiss_cfg_) {
-        throw std::runtime_error("Failed to allocate KISS FFT configuration for reference demod");
-    }
+    fft_plan_ = &fft_plan(n_bins_);
     fft_input_.resize(n_bins_);
     fft_output_.resize(n_bins_);
 }
@@ -90,18 +90,17 @@ uint16_t FftDemodReference::demodulate(const std::complex<float>* symbol_samples
             const float sfo_phase = sfo_factor * static_cast<float>(sample_idx);
             rot *= std::complex<float>(std::cos(sfo_phase), std::sin(sfo_phase));
         }
-        const std::complex<float> value = symbol_samples[sample_idx] * rot * downchirp_[sample_idx];
-        fft_input_[bin].r = value.real();
-        fft_input_[bin].i = value.imag();
+        const std::complex<float> value = symbol_samples[sample_idx] * rot * (*downchirp_)[sample_idx];
+        fft_input_[bin] = value;
     }
 
-    kiss_fft(kiss_cfg_, fft_input_.data(), fft_output_.data());
+    fft_plan_->forward(fft_input_.data(), fft_output_.data());
 
     int best_bin = 0;
     float best_mag = -1.0f;
     for (int bin = 0; bin < n_bins_; ++bin) {
-        const float re = fft_output_[bin].r;
-        const float im = fft_output_[bin].i;
+        const float re = fft_output_[bin].real();
+        const float im = fft_output_[bin].imag();
         const float magnitude_sq = re * re + im * im;
         if (magnitude_sq > best_mag) {
             best_mag = magnitude_sq;
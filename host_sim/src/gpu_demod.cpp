@@ -0,0 +1,51 @@
+#include "host_sim/gpu_demod.hpp"
+
+#include "host_sim/shared_cache.hpp"
+
+#include <tuple>
+
+namespace host_sim
+{
+
+#if defined(HOST_SIM_WITH_CUDA)
+// Defined in gpu_demod_cuda.cu.
+int cuda_device_count();
+std::unique_ptr<GpuDemodulator> make_cuda_demodulator(int sf, int oversample_factor, int base_tap);
+#endif
+
+bool gpu_available()
+{
+#if defined(HOST_SIM_WITH_CUDA)
+    // No driver, no device or a broken install all mean the CPU path.
+    static const bool available = [] {
+        try {
+            return cuda_device_count() > 0;
+        } catch (...) {
+            return false;
+        }
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<const GpuDemodulator> shared_gpu_demodulator(int sf, int oversample_factor, int base_tap)
+{
+    if (!gpu_available()) {
+        return nullptr;
+    }
+#if defined(HOST_SIM_WITH_CUDA)
+    static SharedCache<std::tuple<int, int, int>, GpuDemodulator> cache;
+    return cache.get({sf, oversample_factor, base_tap}, [&]() -> std::shared_ptr<const GpuDemodulator> {
+        return make_cuda_demodulator(sf, oversample_factor, base_tap);
+    });
+#else
+    (void)sf;
+    (void)oversample_factor;
+    (void)base_tap;
+    return nullptr;
+#endif
+}
+
+} // namespace host_sim
@@ -0,0 +1,397 @@
+// CUDA side of the batched demodulation backend (-DHOST_SIM_WITH_CUDA=ON);
+// see host_sim/gpu_demod.hpp.
+
+#include "host_sim/chirp.hpp"
+#include "host_sim/gpu_demod.hpp"
+
+#include <cuda_runtime.h>
+#include <cufft.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace host_sim
+{
+
+namespace
+{
+
+void check(cudaError_t status, const char* what)
+{
+    if (status != cudaSuccess) {
+        throw std::runtime_error(std::string("CUDA ") + what + ": " + cudaGetErrorString(status));
+    }
+}
+
+void check(cufftResult status, const char* what)
+{
+    if (status != CUFFT_SUCCESS) {
+        throw std::runtime_error(std::string("cuFFT ") + what + " failed (" +
+                                 std::to_string(static_cast<int>(status)) + ")");
+    }
+}
+
+// Staging budget per slot, in samples (32 MiB of complex<float>); a launch
+// covers as many windows as fit the same budget in bins, at most
+// kMaxWindows.
+constexpr std::size_t kStageSamples = std::size_t{1} << 22;
+constexpr std::size_t kMaxWindows = 8192;
+
+constexpr int kThreads = 256;
+
+// What the peak kernel writes back per window; GpuPeak on the host.
+struct DevicePeak
+{
+    int best_bin;
+    float best_mag;
+    int second_bin;
+    float second_mag;
+    float prev_mag;
+    float next_mag;
+};
+
+// Window w of the launch: tap k is staged sample offsets[w] + tap + k·os,
+// derotated by exp(j·steps[w]·(k·os + tap)) and multiplied by the
+// downchirp at the same position.
+__global__ void dechirp_kernel(const cufftComplex* samples,
+                               const unsigned long long* offsets,
+                               const double* steps,
+                               const cufftComplex* downchirp,
+                               int n_bins,
+                               int os,
+                               int tap,
+                               cufftComplex* out)
+{
+    const int k = static_cast<int>(blockIdx.x * blockDim.x + threadIdx.x);
+    if (k >= n_bins) {
+        return;
+    }
+    const int w = blockIdx.y;
+    const int idx = k * os + tap;
+    const cufftComplex s = samples[offsets[w] + static_cast<unsigned long long>(idx)];
+    const cufftComplex d = downchirp[idx];
+    float sn = 0.0f;
+    float cs = 1.0f;
+    const double step = steps[w];
+    if (step != 0.0) {
+        // The phase in double, the sine in float: |phase| stays within a
+        // few radians over one symbol.
+        sincosf(static_cast<float>(step * static_cast<double>(idx)), &sn, &cs);
+    }
+    const float rr = s.x * cs - s.y * sn;
+    const float ri = s.x * sn + s.y * cs;
+    cufftComplex o;
+    o.x = rr * d.x - ri * d.y;
+    o.y = rr * d.y + ri * d.x;
+    out[static_cast<std::size_t>(w) * static_cast<std::size_t>(n_bins) + static_cast<std::size_t>(k)] = o;
+}
+
+// (value, bin) ordering of kernels::find_two_peaks(): larger |X|² first,
+// the lower bin on a tie.
+__device__ bool beats(float mag, int bin, float other_mag, int other_bin)
+{
+    return mag > other_mag || (mag == other_mag && bin < other_bin);
+}
+
+__device__ void offer(float mag, int bin, float& b_mag, int& b_bin, float& s_mag, int& s_bin)
+{
+    if (beats(mag, bin, b_mag, b_bin)) {
+        s_mag = b_mag;
+        s_bin = b_bin;
+        b_mag = mag;
+        b_bin = bin;
+    } else if (beats(mag, bin, s_mag, s_bin)) {
+        s_mag = mag;
+        s_bin = bin;
+    }
+}
+
+// One block per window: the two strongest bins, then FftDemodulator's
+// adjacent-tie rule and the powers either side of the bin it keeps.
+__global__ void peak_kernel(const cufftComplex* spectra, int n_bins, DevicePeak* peaks)
+{
+    __shared__ float best_mag[kThreads];
+    __shared__ int best_bin[kThreads];
+    __shared__ float second_mag[kThreads];
+    __shared__ int second_bin[kThreads];
+
+    const int tid = static_cast<int>(threadIdx.x);
+    const cufftComplex* x = spectra + static_cast<std::size_t>(blockIdx.x) * static_cast<std::size_t>(n_bins);
+    float b_mag = -1.0f;
+    int b_bin = n_bins;
+    float s_mag = -1.0f;
+    int s_bin = n_bins;
+    for (int bin = tid; bin < n_bins; bin += static_cast<int>(blockDim.x)) {
+        const float mag = x[bin].x * x[bin].x + x[bin].y * x[bin].y;
+        offer(mag, bin, b_mag, b_bin, s_mag, s_bin);
+    }
+    best_mag[tid] = b_mag;
+    best_bin[tid] = b_bin;
+    second_mag[tid] = s_mag;
+    second_bin[tid] = s_bin;
+    __syncthreads();
+
+    for (int half = static_cast<int>(blockDim.x) / 2; half > 0; half /= 2) {
+        if (tid < half) {
+            const int o = tid + half;
+            offer(best_mag[o], best_bin[o], b_mag, b_bin, s_mag, s_bin);
+            offer(second_mag[o], second_bin[o], b_mag, b_bin, s_mag, s_bin);
+            best_mag[tid] = b_mag;
+            best_bin[tid] = b_bin;
+            second_mag[tid] = s_mag;
+            second_bin[tid] = s_bin;
+        }
+        __syncthreads();
+    }
+
+    if (tid == 0) {
+        int bin = b_bin;
+        if (s_mag >= 0.0f && b_mag - s_mag < b_mag * 1e-6f + 1e-6f && s_bin == b_bin + 1) {
+            bin = s_bin;
+        }
+        const int prev = (bin - 1 + n_bins) % n_bins;
+        const int next = (bin + 1) % n_bins;
+        DevicePeak p;
+        p.best_bin = b_bin;
+        p.best_mag = b_mag;
+        p.second_bin = s_bin;
+        p.second_mag = s_mag;
+        p.prev_mag = x[prev].x * x[prev].x + x[prev].y * x[prev].y;
+        p.next_mag = x[next].x * x[next].x + x[next].y * x[next].y;
+        peaks[blockIdx.x] = p;
+    }
+}
+
+template <typename T>
+T* device_alloc(std::size_t count)
+{
+    void* p = nullptr;
+    check(cudaMalloc(&p, count * sizeof(T)), "cudaMalloc");
+    return static_cast<T*>(p);
+}
+
+template <typename T>
+T* pinned_alloc(std::size_t count)
+{
+    void* p = nullptr;
+    check(cudaHostAlloc(&p, count * sizeof(T), cudaHostAllocDefault), "cudaHostAlloc");
+    return static_cast<T*>(p);
+}
+
+class CudaDemodulator final : public GpuDemodulator
+{
+public:
+    CudaDemodulator(int sf, int oversample_factor, int base_tap)
+        : GpuDemodulator(sf, oversample_factor, base_tap),
+          n_bins_(1 << sf),
+          sps_(static_cast<std::size_t>(n_bins_) * static_cast<std::size_t>(oversample_factor)),
+          stage_(std::max(kStageSamples, 2 * sps_)),
+          windows_(std::min(kMaxWindows, std::max<std::size_t>(1, kStageSamples / static_cast<std::size_t>(n_bins_))))
+    {
+        try {
+            const auto chirps = shared_chirps(sf, oversample_factor);
+            downchirp_ = device_alloc<cufftComplex>(sps_);
+            check(cudaMemcpy(downchirp_, chirps->downchirp.data(), sps_ * sizeof(cufftComplex),
+                             cudaMemcpyHostToDevice),
+                  "downchirp upload");
+            for (auto& slot : slots_) {
+                check(cudaStreamCreateWithFlags(&slot.stream, cudaStreamNonBlocking), "cudaStreamCreate");
+                slot.host_samples = pinned_alloc<cufftComplex>(stage_);
+                slot.host_offsets = pinned_alloc<unsigned long long>(windows_);
+                slot.host_steps = pinned_alloc<double>(windows_);
+                slot.host_peaks = pinned_alloc<DevicePeak>(windows_);
+                slot.samples = device_alloc<cufftComplex>(stage_);
+                slot.offsets = device_alloc<unsigned long long>(windows_);
+                slot.steps = device_alloc<double>(windows_);
+                slot.dechirped = device_alloc<cufftComplex>(windows_ * static_cast<std::size_t>(n_bins_));
+                slot.spectra = device_alloc<cufftComplex>(windows_ * static_cast<std::size_t>(n_bins_));
+                slot.peaks = device_alloc<DevicePeak>(windows_);
+                int n = n_bins_;
+                check(cufftPlanMany(&slot.plan, 1, &n, nullptr, 1, n_bins_, nullptr, 1, n_bins_, CUFFT_C2C,
+                                    static_cast<int>(windows_)),
+                      "cufftPlanMany");
+                slot.has_plan = true;
+                check(cufftSetStream(slot.plan, slot.stream), "cufftSetStream");
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~CudaDemodulator() override { release(); }
+
+    CudaDemodulator(const CudaDemodulator&) = delete;
+    CudaDemodulator& operator=(const CudaDemodulator&) = delete;
+
+    void demodulate(const std::complex<float>* samples,
+                    const std::size_t* offsets,
+                    const double* phase_steps,
+                    std::size_t count,
+                    GpuPeak* peaks) const override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& slot : slots_) {
+            // A batch left in flight by a call that threw.
+            cudaStreamSynchronize(slot.stream);
+            slot.count = 0;
+        }
+
+        // Batch b fills slot b % 2 while the other slot's kernels run; the
+        // host copy out of `samples` (often a MappedCapture, so page faults
+        // too) is what overlaps the device work.
+        std::size_t next = 0;
+        for (std::size_t batch = 0; next < count; ++batch) {
+            Slot& slot = slots_[batch % 2];
+            collect(slot, peaks);
+
+            // Grow the batch while the windows' sample span fits the stage.
+            std::size_t lo = offsets[next];
+            std::size_t hi = offsets[next] + sps_;
+            std::size_t end = next + 1;
+            while (end < count && end - next < windows_) {
+                const std::size_t new_lo = std::min(lo, offsets[end]);
+                const std::size_t new_hi = std::max(hi, offsets[end] + sps_);
+                if (new_hi - new_lo > stage_) {
+                    break;
+                }
+                lo = new_lo;
+                hi = new_hi;
+                ++end;
+            }
+            const std::size_t n = end - next;
+
+            std::memcpy(slot.host_samples, samples + lo, (hi - lo) * sizeof(cufftComplex));
+            for (std::size_t i = 0; i < n; ++i) {
+                slot.host_offsets[i] = offsets[next + i] - lo;
+                slot.host_steps[i] = phase_steps[next + i];
+            }
+            check(cudaMemcpyAsync(slot.samples, slot.host_samples, (hi - lo) * sizeof(cufftComplex),
+                                  cudaMemcpyHostToDevice, slot.stream),
+                  "sample upload");
+            check(cudaMemcpyAsync(slot.offsets, slot.host_offsets, n * sizeof(unsigned long long),
+                                  cudaMemcpyHostToDevice, slot.stream),
+                  "offset upload");
+            check(cudaMemcpyAsync(slot.steps, slot.host_steps, n * sizeof(double), cudaMemcpyHostToDevice,
+                                  slot.stream),
+                  "phase-step upload");
+
+            const dim3 grid(static_cast<unsigned>((n_bins_ + kThreads - 1) / kThreads), static_cast<unsigned>(n));
+            dechirp_kernel<<<grid, kThreads, 0, slot.stream>>>(slot.samples, slot.offsets, slot.steps, downchirp_,
+                                                              n_bins_, oversample_factor(), base_tap(),
+                                                              slot.dechirped);
+            check(cudaGetLastError(), "dechirp launch");
+            // The plan is sized for a full batch; the rows past `n` hold
+            // stale data whose spectra nobody reads.
+            check(cufftExecC2C(slot.plan, slot.dechirped, slot.spectra, CUFFT_FORWARD), "cufftExecC2C");
+            peak_kernel<<<static_cast<unsigned>(n), kThreads, 0, slot.stream>>>(slot.spectra, n_bins_, slot.peaks);
+            check(cudaGetLastError(), "peak launch");
+            check(cudaMemcpyAsync(slot.host_peaks, slot.peaks, n * sizeof(DevicePeak), cudaMemcpyDeviceToHost,
+                                  slot.stream),
+                  "peak download");
+
+            slot.first = next;
+            slot.count = n;
+            next = end;
+        }
+        for (auto& slot : slots_) {
+            collect(slot, peaks);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        cudaStream_t stream{nullptr};
+        cufftHandle plan{0};
+        bool has_plan{false};
+        cufftComplex* host_samples{nullptr};
+        unsigned long long* host_offsets{nullptr};
+        double* host_steps{nullptr};
+        DevicePeak* host_peaks{nullptr};
+        cufftComplex* samples{nullptr};
+        unsigned long long* offsets{nullptr};
+        double* steps{nullptr};
+        cufftComplex* dechirped{nullptr};
+        cufftComplex* spectra{nullptr};
+        DevicePeak* peaks{nullptr};
+        std::size_t first{0};       // window index of the batch in flight
+        std::size_t count{0};       // its windows; 0 = idle
+    };
+
+    // Wait for the slot's batch in flight, if any, and hand its peaks out.
+    void collect(Slot& slot, GpuPeak* peaks) const
+    {
+        if (slot.count == 0) {
+            return;
+        }
+        check(cudaStreamSynchronize(slot.stream), "cudaStreamSynchronize");
+        for (std::size_t i = 0; i < slot.count; ++i) {
+            const DevicePeak& p = slot.host_peaks[i];
+            GpuPeak& out = peaks[slot.first + i];
+            out.peaks = {p.best_bin, p.best_mag, p.second_bin, p.second_mag};
+            out.prev_mag = p.prev_mag;
+            out.next_mag = p.next_mag;
+        }
+        slot.count = 0;
+    }
+
+    void release() noexcept
+    {
+        for (auto& slot : slots_) {
+            if (slot.stream) {
+                cudaStreamSynchronize(slot.stream);
+            }
+            if (slot.has_plan) {
+                cufftDestroy(slot.plan);
+            }
+            cudaFreeHost(slot.host_samples);
+            cudaFreeHost(slot.host_offsets);
+            cudaFreeHost(slot.host_steps);
+            cudaFreeHost(slot.host_peaks);
+            cudaFree(slot.samples);
+            cudaFree(slot.offsets);
+            cudaFree(slot.steps);
+            cudaFree(slot.dechirped);
+            cudaFree(slot.spectra);
+            cudaFree(slot.peaks);
+            if (slot.stream) {
+                cudaStreamDestroy(slot.stream);
+            }
+            slot = Slot{};
+        }
+        cudaFree(downchirp_);
+        downchirp_ = nullptr;
+    }
+
+    int n_bins_;
+    std::size_t sps_;
+    std::size_t stage_;     // samples per staging slot
+    std::size_t windows_;   // windows per launch
+    cufftComplex* downchirp_{nullptr};
+    mutable Slot slots_[2];
+    mutable std::mutex mutex_;
+};
+
+} // namespace
+
+int cuda_device_count()
+{
+    int count = 0;
+    if (cudaGetDeviceCount(&count) != cudaSuccess) {
+        return 0;
+    }
+    return count;
+}
+
+std::unique_ptr<GpuDemodulator> make_cuda_demodulator(int sf, int oversample_factor, int base_tap)
+{
+    return std::make_unique<CudaDemodulator>(sf, oversample_factor, base_tap);
+}
+
+} // namespace host_sim
@@ -6,6 +6,14 @@ namespace host_sim
 {
 
 uint8_t hamming_decode(uint8_t codeword, int cr_app)
+{
+    if (cr_app >= 1 && cr_app <= 4) {
+        return detail::kHammingDecode[static_cast<std::size_t>(cr_app - 1)][codeword];
+    }
+    return hamming_decode_reference(codeword, cr_app);
+}
+
+uint8_t hamming_decode_reference(uint8_t codeword, int cr_app)
 {
     std::vector<bool> bits(cr_app + 4);
     for (std::size_t i = 0; i < bits.size(); ++i) {
@@ -72,14 +80,19 @@ uint8_t hamming_decode(uint8_t codeword, int cr_app)
 }
 
 std::vector<uint8_t> hamming_decode_block(const std::vector<uint8_t>& codewords, bool header, int cr)
+{
+    std::vector<uint8_t> result(codewords.size());
+    hamming_decode_block(codewords.data(), codewords.size(), header, cr, result.data());
+    return result;
+}
+
+std::size_t hamming_decode_block(const uint8_t* codewords, std::size_t count, bool header, int cr, uint8_t* out)
 {
     const int cr_app = header ? 4 : cr;
-    std::vector<uint8_t> result;
-    result.reserve(codewords.size());
-    for (uint8_t cw : codewords) {
-        result.push_back(hamming_decode(cw, cr_app));
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = hamming_decode(codewords[i], cr_app);
     }
-    return result;
+    return count;
 }
 
 } // namespace host_sim
@@ -0,0 +1,110 @@
+#include "host_sim/header_locator.hpp"
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/deinterleaver.hpp"
+#include "host_sim/hamming.hpp"
+#include "host_sim/trace.hpp"
+
+#include <array>
+
+namespace host_sim
+{
+
+namespace
+{
+
+constexpr std::size_t kHeaderBlockSymbols = 8;
+constexpr std::size_t kHeaderNibbles = 5;
+constexpr std::size_t kSyncWindow = 2;   // symbols either side of the sync prediction
+
+// Same filter the grid scans always applied: a header that contradicts
+// the metadata is a false lock, not the packet.
+bool matches_metadata(const HeaderFields& fields, const LoRaMetadata& meta)
+{
+    if (!fields.valid) {
+        return false;
+    }
+    if (meta.payload_len > 0 && fields.payload_len != meta.payload_len) {
+        return false;
+    }
+    if (meta.cr > 0 && fields.cr != meta.cr) {
+        return false;
+    }
+    return !meta.has_crc || fields.has_crc;
+}
+
+} // namespace
+
+HeaderFields decode_header_at(std::span<const uint16_t> symbols, std::size_t start, const LoRaMetadata& meta)
+{
+    const DeinterleaverConfig cfg{meta.sf, 4, true, meta.ldro};
+    std::array<uint8_t, kMaxInterleaverRows + kHeaderNibbles> nibbles{};
+    std::array<uint8_t, kMaxInterleaverRows> codewords{};
+    std::size_t have = 0;
+    std::size_t cursor = start;
+    while (have < kHeaderNibbles && cursor <= symbols.size() &&
+           symbols.size() - cursor >= kHeaderBlockSymbols) {
+        const std::size_t count =
+            deinterleave_block(symbols.data() + cursor, kHeaderBlockSymbols, cfg, codewords.data());
+        if (count == 0) {
+            break;
+        }
+        for (std::size_t i = 0; i < count && have < nibbles.size(); ++i) {
+            nibbles[have++] = hamming_decode(codewords[i], 4);
+        }
+        cursor += kHeaderBlockSymbols;
+    }
+    if (have < kHeaderNibbles) {
+        return {};
+    }
+    HeaderFields fields = parse_header_nibbles(nibbles.data());
+    fields.consumed_symbols = cursor - start;
+    return fields;
+}
+
+std::optional<HeaderLocation> locate_header(std::span<const uint16_t> symbols, const LoRaMetadata& meta)
+{
+    HOST_SIM_TRACE_SPAN("header/scan");
+    HeaderLocation location;
+    location.sync_index = find_header_symbol_index(symbols, 0x12, meta.sf);
+    if (!location.sync_index) {
+        location.sync_index = find_header_symbol_index(symbols, 0x34, meta.sf);
+    }
+
+    if (location.sync_index) {
+        const std::size_t predicted = *location.sync_index;
+        const std::size_t lo = predicted > kSyncWindow ? predicted - kSyncWindow : 0;
+        std::optional<std::size_t> best;
+        HeaderFields best_fields;
+        for (std::size_t c = lo; c <= predicted + kSyncWindow && c + kHeaderBlockSymbols <= symbols.size(); ++c) {
+            ++location.candidates;
+            const HeaderFields fields = decode_header_at(symbols, c, meta);
+            if (!matches_metadata(fields, meta)) {
+                continue;
+            }
+            const auto distance = [predicted](std::size_t i) { return i > predicted ? i - predicted : predicted - i; };
+            if (!best || distance(c) < distance(*best)) {
+                best = c;
+                best_fields = fields;
+            }
+        }
+        if (best) {
+            location.index = *best;
+            location.fields = best_fields;
+            return location;
+        }
+    }
+
+    for (std::size_t c = 0; c + kHeaderBlockSymbols <= symbols.size(); ++c) {
+        ++location.candidates;
+        const HeaderFields fields = decode_header_at(symbols, c, meta);
+        if (matches_metadata(fields, meta)) {
+            location.index = c;
+            location.fields = fields;
+            return location;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace host_sim
@@ -0,0 +1,513 @@
+// host_sim_bench — microbenchmarks for the DSP and coding kernels.
+//
+// Each benchmark runs one kernel call (or a fixed batch of them) per
+// iteration, repeating until --min-time has elapsed; the reported time is
+// the median over --repetitions.  Every result carries ns per item (the
+// kernel's natural unit: symbol, codeword, byte, call), sample throughput
+// where the kernel reads or writes IQ, and heap allocations per iteration,
+// counted by the global operator new this file replaces.  --json writes a
+// baseline that tools/compare_bench.py checks a later run against.
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/chirp.hpp"
+#include "host_sim/deinterleaver.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/fft_demod_q15.hpp"
+#include "host_sim/hamming.hpp"
+#include "host_sim/polyphase_samples.hpp"
+#include "host_sim/q15.hpp"
+#include "host_sim/soft_decode.hpp"
+#include "host_sim/tx/packet.hpp"
+#include "host_sim/whitening.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ── Allocation counting ──────────────────────────────────────────────────
+
+namespace
+{
+
+std::atomic<std::size_t> g_allocations{0};
+
+void* counted_alloc(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* counted_alloc_aligned(std::size_t size, std::align_val_t align)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto alignment = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return counted_alloc_aligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return counted_alloc_aligned(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace
+{
+
+// ── Harness ──────────────────────────────────────────────────────────────
+
+/// Keep @p value (and whatever produced it) from being optimised away.
+template <typename T>
+void keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Benchmark
+{
+    std::string name;
+    std::string unit;              ///< What one item is: symbol, codeword, byte, call
+    std::size_t items{1};          ///< Items per iteration
+    std::size_t samples{0};        ///< IQ samples read or written per iteration
+    std::function<void()> body;    ///< One iteration; setup lives in the closure
+};
+
+struct BenchResult
+{
+    const Benchmark* bench{nullptr};
+    std::size_t iterations{0};     ///< Per repetition, after calibration
+    double ns_per_iter{0.0};       ///< Median over repetitions
+    double allocs_per_iter{0.0};
+};
+
+struct BenchOptions
+{
+    std::string filter;
+    double min_time{0.2};
+    int repetitions{3};
+    bool list{false};
+    std::optional<std::filesystem::path> json;
+};
+
+double run_batch(const Benchmark& b, std::size_t iterations)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        b.body();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+BenchResult run_benchmark(const Benchmark& b, const BenchOptions& opts)
+{
+    BenchResult result;
+    result.bench = &b;
+    // Warm-up: first-use caches (FFT plans, chirp tables) stay out of the
+    // allocation count.
+    b.body();
+    const std::size_t before = g_allocations.load(std::memory_order_relaxed);
+    constexpr std::size_t kAllocProbe = 4;
+    run_batch(b, kAllocProbe);
+    result.allocs_per_iter =
+        static_cast<double>(g_allocations.load(std::memory_order_relaxed) - before) / kAllocProbe;
+
+    // Grow the batch until one takes a tenth of --min-time, then size the
+    // repetitions to --min-time each.
+    const double target_ns = opts.min_time * 1e9;
+    std::size_t iterations = 1;
+    double elapsed = run_batch(b, iterations);
+    while (elapsed < target_ns / 10.0 && iterations < (std::size_t{1} << 40)) {
+        iterations *= 2;
+        elapsed = run_batch(b, iterations);
+    }
+    const double per_iter = std::max(elapsed, 1.0) / static_cast<double>(iterations);
+    iterations = std::max<std::size_t>(1, static_cast<std::size_t>(target_ns / per_iter));
+
+    std::vector<double> times;
+    for (int r = 0; r < opts.repetitions; ++r) {
+        times.push_back(run_batch(b, iterations) / static_cast<double>(iterations));
+    }
+    std::sort(times.begin(), times.end());
+    result.iterations = iterations;
+    result.ns_per_iter = times[times.size() / 2];
+    return result;
+}
+
+// ── Inputs ───────────────────────────────────────────────────────────────
+
+constexpr int kBandwidth = 125000;
+constexpr std::size_t kDemodSymbols = 16;
+
+std::vector<uint16_t> random_symbols(int sf, std::size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint16_t> symbols(count);
+    for (auto& s : symbols) {
+        s = static_cast<uint16_t>(rng() % (1u << sf));
+    }
+    return symbols;
+}
+
+/// A modulated packet with @p data_symbols random data symbols.
+std::vector<std::complex<float>> make_packet(int sf, int os, std::size_t data_symbols)
+{
+    return host_sim::tx::modulate_packet(sf, os, 0x12, 8, random_symbols(sf, data_symbols, 7));
+}
+
+/// First sample of make_packet()'s data symbols: padding, preamble, sync
+/// and SFD come first.
+std::size_t data_start(int sf, int os, std::size_t data_symbols)
+{
+    const auto sps = (std::size_t{1} << sf) * static_cast<std::size_t>(os);
+    const auto pad = static_cast<std::size_t>(host_sim::tx::padding_symbols(8, data_symbols));
+    return (pad + 8 + 4) * sps + sps / 4;
+}
+
+// ── Benchmarks ───────────────────────────────────────────────────────────
+
+void add_demod(std::vector<Benchmark>& out, int sf, int os)
+{
+    const std::string suffix = "/sf" + std::to_string(sf) + "_os" + std::to_string(os);
+    auto demod = std::make_shared<host_sim::FftDemodulator>(sf, kBandwidth * os, kBandwidth);
+    const auto sps = static_cast<std::size_t>(demod->samples_per_symbol());
+    auto packet = std::make_shared<std::vector<std::complex<float>>>(make_packet(sf, os, kDemodSymbols));
+    const std::size_t first_window = data_start(sf, os, kDemodSymbols);
+    out.push_back({"demod/float" + suffix, "symbol", kDemodSymbols, sps * kDemodSymbols, [=] {
+        for (std::size_t i = 0; i < kDemodSymbols; ++i) {
+            keep(demod->demodulate(packet->data() + first_window + i * sps));
+        }
+    }});
+
+    auto demod_q15 = std::make_shared<host_sim::FftDemodulatorQ15>(sf, kBandwidth * os, kBandwidth);
+    auto q15 = std::make_shared<std::vector<host_sim::Q15Complex>>(sps * kDemodSymbols);
+    for (std::size_t i = 0; i < q15->size(); ++i) {
+        const auto s = (*packet)[first_window + i] * 0.5f;
+        (*q15)[i] = host_sim::float_to_q15_complex(s.real(), s.imag());
+    }
+    // The multi-symbol grid pass the decoder runs, with taps gathered from
+    // the interleaved packet or read from its polyphase planes.
+    auto symbols = std::make_shared<std::vector<uint16_t>>(kDemodSymbols);
+    out.push_back({"demod/block" + suffix, "symbol", kDemodSymbols, sps * kDemodSymbols, [=] {
+        demod->demodulate_block(packet->data() + first_window, kDemodSymbols, static_cast<double>(sps),
+                                symbols->data());
+        keep((*symbols)[0]);
+    }});
+    auto planes = std::make_shared<host_sim::PolyphaseSamples>(*packet, os);
+    out.push_back({"demod/block_split" + suffix, "symbol", kDemodSymbols, sps * kDemodSymbols, [=] {
+        demod->demodulate_block(*planes, first_window, kDemodSymbols, static_cast<double>(sps),
+                                symbols->data());
+        keep((*symbols)[0]);
+    }});
+
+    out.push_back({"demod/q15" + suffix, "symbol", kDemodSymbols, sps * kDemodSymbols, [=] {
+        for (std::size_t i = 0; i < kDemodSymbols; ++i) {
+            keep(demod_q15->demodulate(q15->data() + i * sps));
+        }
+    }});
+}
+
+void add_alignment(std::vector<Benchmark>& out, int sf)
+{
+    auto demod = std::make_shared<host_sim::FftDemodulator>(sf, kBandwidth, kBandwidth);
+    auto packet = std::make_shared<std::vector<std::complex<float>>>(make_packet(sf, 1, 16));
+    out.push_back({"align/cfo_aware/sf" + std::to_string(sf), "call", 1, packet->size(), [=] {
+        keep(host_sim::find_symbol_alignment_cfo_aware(*packet, *demod).alignment_offset);
+    }});
+}
+
+/// The full CFO-aware search with each fine-scan mode forced.
+void add_fine_scan_modes(std::vector<Benchmark>& out, int sf, int os)
+{
+    const std::string suffix = "/sf" + std::to_string(sf) + "_os" + std::to_string(os);
+    auto demod = std::make_shared<host_sim::FftDemodulator>(sf, kBandwidth * os, kBandwidth);
+    auto packet = std::make_shared<std::vector<std::complex<float>>>(make_packet(sf, os, 16));
+    for (const auto& [name, mode] : {std::pair{"fft", host_sim::FineScanMode::fft},
+                                     std::pair{"zoom", host_sim::FineScanMode::zoom}}) {
+        out.push_back({std::string("align/fine_") + name + suffix, "call", 1, packet->size(), [=] {
+            keep(host_sim::find_symbol_alignment_cfo_aware(*packet, *demod, 8, nullptr, mode).alignment_offset);
+        }});
+    }
+}
+
+void add_burst_detect(std::vector<Benchmark>& out, int sf)
+{
+    const int sps = 1 << sf;
+    auto packet = std::make_shared<std::vector<std::complex<float>>>(make_packet(sf, 1, 64));
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    for (auto& s : *packet) {
+        s += std::complex<float>(noise(rng), noise(rng));
+    }
+    out.push_back({"burst/detect_ex/sf" + std::to_string(sf), "symbol", packet->size() / sps, packet->size(), [=] {
+        const auto hit = host_sim::detect_burst_ex(packet->data(), packet->size(), sps);
+        keep(hit ? hit->burst_start : 0);
+    }});
+}
+
+void add_coding(std::vector<Benchmark>& out, int sf, int cr)
+{
+    const std::string suffix = "/sf" + std::to_string(sf) + "_cr" + std::to_string(cr);
+    const int cw_len = cr + 4;
+    constexpr std::size_t kBlocks = 8;
+    auto blocks = std::make_shared<std::vector<std::vector<uint16_t>>>();
+    for (std::size_t b = 0; b < kBlocks; ++b) {
+        blocks->push_back(random_symbols(sf, static_cast<std::size_t>(cw_len), 11 + static_cast<unsigned>(b)));
+    }
+    const host_sim::DeinterleaverConfig cfg{sf, cr, false, false};
+    out.push_back({"deinterleave" + suffix, "symbol", kBlocks * cw_len, 0, [=] {
+        std::size_t consumed = 0;
+        for (const auto& block : *blocks) {
+            keep(host_sim::deinterleave(block, cfg, consumed).size());
+        }
+    }});
+
+    std::size_t consumed = 0;
+    auto codewords = std::make_shared<std::vector<uint8_t>>(host_sim::deinterleave(blocks->front(), cfg, consumed));
+    out.push_back({"hamming/decode_block" + suffix, "codeword", codewords->size(), 0, [=] {
+        keep(host_sim::hamming_decode_block(*codewords, false, cr).size());
+    }});
+
+    std::mt19937 rng(13);
+    std::normal_distribution<float> llr(0.0f, 4.0f);
+    auto soft = std::make_shared<std::vector<float>>(kBlocks * cw_len);
+    for (auto& v : *soft) {
+        v = llr(rng);
+    }
+    out.push_back({"soft/hamming" + suffix, "codeword", kBlocks, 0, [=] {
+        for (std::size_t b = 0; b < kBlocks; ++b) {
+            keep(host_sim::hamming_decode_soft(soft->data() + b * cw_len, cr));
+        }
+    }});
+}
+
+void add_llrs(std::vector<Benchmark>& out, int sf)
+{
+    host_sim::FftDemodulator demod(sf, kBandwidth, kBandwidth);
+    const auto packet = make_packet(sf, 1, 1);
+    demod.demodulate(packet.data() + data_start(sf, 1, 1));
+    auto mags = std::make_shared<std::vector<float>>(demod.get_fft_magnitudes_sq());
+    out.push_back({"soft/llrs/sf" + std::to_string(sf), "symbol", 1, 0, [=] {
+        std::array<float, host_sim::kMaxSoftBits> llrs;
+        host_sim::compute_symbol_llrs(mags->data(), sf, false, 0, llrs.data());
+        keep(llrs[0]);
+    }});
+}
+
+std::vector<Benchmark> build_benchmarks()
+{
+    std::vector<Benchmark> out;
+    for (int sf : {7, 9, 12}) {
+        for (int os : {1, 2, 4, 8}) {
+            add_demod(out, sf, os);
+        }
+    }
+    for (int sf : {7, 9}) {
+        add_alignment(out, sf);
+    }
+    for (int sf : {9, 12}) {
+        add_fine_scan_modes(out, sf, 4);
+    }
+    for (int sf : {7, 10}) {
+        add_burst_detect(out, sf);
+    }
+    for (int sf : {7, 12}) {
+        for (int cr : {1, 4}) {
+            add_coding(out, sf, cr);
+        }
+        add_llrs(out, sf);
+    }
+
+    auto payload = std::make_shared<std::vector<uint8_t>>(255);
+    for (std::size_t i = 0; i < payload->size(); ++i) {
+        (*payload)[i] = static_cast<uint8_t>(i * 37);
+    }
+    out.push_back({"whitening/apply/255", "byte", payload->size(), 0, [=] {
+        host_sim::WhiteningSequencer whitening;
+        keep(whitening.apply(*payload).size());
+    }});
+    auto buffer = std::make_shared<std::vector<uint8_t>>(*payload);
+    out.push_back({"whitening/in_place/255", "byte", buffer->size(), 0, [=] {
+        host_sim::whiten_in_place(*buffer);
+        keep((*buffer)[0]);
+    }});
+    out.push_back({"crc16/ccitt/255", "byte", payload->size(), 0, [=] {
+        keep(host_sim::crc16_ccitt(payload->data(), payload->size()));
+    }});
+    out.push_back({"crc16/dewhiten_fused/255", "byte", buffer->size(), 0, [=] {
+        keep(host_sim::dewhiten_then_crc16(*buffer));
+    }});
+
+    for (const auto& [sf, os] : {std::pair{7, 1}, std::pair{12, 2}}) {
+        const std::size_t sps = (std::size_t{1} << sf) * static_cast<std::size_t>(os);
+        out.push_back({"chirps/build/sf" + std::to_string(sf) + "_os" + std::to_string(os), "call", 1, 2 * sps, [=] {
+            keep(host_sim::build_chirps(sf, os).upchirp.size());
+        }});
+    }
+
+    for (int sf : {7, 12}) {
+        auto symbols = std::make_shared<std::vector<uint16_t>>(random_symbols(sf, 64, 17));
+        const std::size_t samples = host_sim::tx::packet_length(sf, 1, 8, symbols->size());
+        out.push_back({"tx/modulate_packet/sf" + std::to_string(sf), "symbol", symbols->size(), samples, [=] {
+            keep(host_sim::tx::modulate_packet(sf, 1, 0x12, 8, *symbols).size());
+        }});
+    }
+    return out;
+}
+
+// ── Output ───────────────────────────────────────────────────────────────
+
+double ns_per_item(const BenchResult& r)
+{
+    return r.ns_per_iter / static_cast<double>(r.bench->items);
+}
+
+double samples_per_second(const BenchResult& r)
+{
+    return r.bench->samples ? static_cast<double>(r.bench->samples) / (r.ns_per_iter * 1e-9) : 0.0;
+}
+
+void write_json(const std::filesystem::path& path, const BenchOptions& opts, const std::vector<BenchResult>& results)
+{
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Unable to open bench output file: " + path.string());
+    }
+    out << std::setprecision(6) << "{\n"
+        << "  \"min_time_s\": " << opts.min_time << ",\n"
+        << "  \"repetitions\": " << opts.repetitions << ",\n"
+        << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\n"
+            << "      \"name\": \"" << r.bench->name << "\",\n"
+            << "      \"unit\": \"" << r.bench->unit << "\",\n"
+            << "      \"items_per_iter\": " << r.bench->items << ",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"ns_per_iter\": " << r.ns_per_iter << ",\n"
+            << "      \"ns_per_item\": " << ns_per_item(r) << ",\n"
+            << "      \"samples_per_s\": " << samples_per_second(r) << ",\n"
+            << "      \"allocs_per_iter\": " << r.allocs_per_iter << "\n"
+            << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void print_usage(const char* prog)
+{
+    std::cerr
+        << "Usage: " << prog << " [options]\n"
+        << "  --filter <text>      Only benchmarks whose name contains text\n"
+        << "  --min-time <s>       Time per repetition (default: 0.2)\n"
+        << "  --repetitions <n>    Repetitions; the median is reported (default: 3)\n"
+        << "  --json <file>        Write results as a baseline for tools/compare_bench.py\n"
+        << "  --list               List benchmark names and exit\n";
+}
+
+std::optional<BenchOptions> parse_args(int argc, char* argv[])
+{
+    BenchOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--filter") { opts.filter = next(); }
+        else if (arg == "--min-time") { opts.min_time = std::stod(next()); }
+        else if (arg == "--repetitions") { opts.repetitions = std::stoi(next()); }
+        else if (arg == "--json") { opts.json = next(); }
+        else if (arg == "--list") { opts.list = true; }
+        else if (arg == "--help" || arg == "-h") { return std::nullopt; }
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return std::nullopt;
+        }
+    }
+    if (opts.min_time < 0.0 || opts.repetitions < 1) {
+        std::cerr << "Error: --min-time must be >= 0 and --repetitions positive\n";
+        return std::nullopt;
+    }
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        const auto parsed = parse_args(argc, argv);
+        if (!parsed) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        const auto& opts = *parsed;
+
+        const auto benchmarks = build_benchmarks();
+        std::vector<BenchResult> results;
+        for (const auto& b : benchmarks) {
+            if (b.name.find(opts.filter) == std::string::npos) {
+                continue;
+            }
+            if (opts.list) {
+                std::cout << b.name << "\n";
+                continue;
+            }
+            results.push_back(run_benchmark(b, opts));
+            const auto& r = results.back();
+            std::printf("  %-32s %12.1f ns/%-8s", b.name.c_str(), ns_per_item(r), b.unit.c_str());
+            if (b.samples) {
+                std::printf(" %10.2f Msps", samples_per_second(r) * 1e-6);
+            } else {
+                std::printf(" %15s", "");
+            }
+            std::printf("  %6.2f allocs/iter\n", r.allocs_per_iter);
+            std::fflush(stdout);
+        }
+        if (opts.json && !opts.list) {
+            write_json(*opts.json, opts, results);
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,200 @@
+#include "host_sim/interference_canceller.hpp"
+
+#include "host_sim/tx/packet.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace host_sim
+{
+
+namespace
+{
+
+using Sample = std::complex<float>;
+
+// One chirp of the frame: where it sits in the replica and its length.
+struct Chirp
+{
+    std::size_t at{0};
+    std::size_t len{0};
+};
+
+// The part of a chirp placed at buffer index `pos` that lies inside a
+// buffer of `size` samples: its offset in the chirp and in the buffer.
+struct Overlap
+{
+    std::size_t ref{0};
+    std::size_t buf{0};
+    std::size_t len{0};
+};
+
+Overlap overlap(std::ptrdiff_t pos, std::size_t len, std::size_t size)
+{
+    const auto lo = std::max<std::ptrdiff_t>(pos, 0);
+    const auto hi = std::min<std::ptrdiff_t>(pos + static_cast<std::ptrdiff_t>(len), static_cast<std::ptrdiff_t>(size));
+    if (hi <= lo) {
+        return {};
+    }
+    return {static_cast<std::size_t>(lo - pos), static_cast<std::size_t>(lo), static_cast<std::size_t>(hi - lo)};
+}
+
+// Σ conj(ref)·rx over the overlap.
+std::complex<double> correlate(const Sample* ref, const Sample* rx, std::size_t n)
+{
+    double re = 0.0;
+    double im = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        re += static_cast<double>(ref[i].real()) * rx[i].real() + static_cast<double>(ref[i].imag()) * rx[i].imag();
+        im += static_cast<double>(ref[i].real()) * rx[i].imag() - static_cast<double>(ref[i].imag()) * rx[i].real();
+    }
+    return {re, im};
+}
+
+double energy(const Sample* x, std::size_t n)
+{
+    double acc = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += std::norm(x[i]);
+    }
+    return acc;
+}
+
+// |correlation| of one chirp placed at `pos`, 0 when it is not wholly in
+// the buffer (a partial chirp would favour placements off the edge).
+double chirp_score(std::span<const Sample> replica, const Chirp& c, std::span<const Sample> rx, std::ptrdiff_t pos)
+{
+    if (pos < 0 || static_cast<std::size_t>(pos) + c.len > rx.size()) {
+        return 0.0;
+    }
+    return std::abs(correlate(replica.data() + c.at, rx.data() + pos, c.len));
+}
+
+} // namespace
+
+std::optional<CancelResult> cancel_packet(std::span<std::complex<float>> samples,
+                                          const LoRaMetadata& metadata,
+                                          const CancelTarget& target)
+{
+    const int sf = metadata.sf;
+    const int os = metadata.sample_rate / metadata.bw;
+    const auto n_bins = std::size_t{1} << sf;
+    const std::size_t sps = n_bins * static_cast<std::size_t>(os);
+    const int preamble_len = std::max(metadata.preamble_len, 0);
+
+    // The transmitted frame, stripped of modulate_packet_into()'s padding.
+    const auto symbols = tx::encode_packet_symbols(sf, target.cr, target.has_crc, metadata.ldro,
+                                                   metadata.implicit_header, target.payload);
+    const auto modulator = tx::shared_modulator(sf, os);
+    std::vector<Sample> packet(tx::packet_length(sf, os, preamble_len, symbols.size()));
+    tx::modulate_packet_into(*modulator, metadata.sync_word, preamble_len, symbols, packet);
+    const auto pad = sps * static_cast<std::size_t>(tx::padding_symbols(preamble_len, symbols.size()));
+    const std::size_t frame_len = packet.size() - 2 * pad;
+    std::span<Sample> replica(packet.data() + pad, frame_len);
+
+    // Preamble and sync upchirps, 2.25 downchirps, data.
+    std::vector<Chirp> chirps;
+    const std::size_t up = static_cast<std::size_t>(preamble_len) + 2;
+    for (std::size_t i = 0; i < up + 2; ++i) {
+        chirps.push_back({i * sps, sps});
+    }
+    chirps.push_back({(up + 2) * sps, sps / 4});
+    for (std::size_t k = 0; k < symbols.size(); ++k) {
+        chirps.push_back({(up + 2) * sps + sps / 4 + k * sps, sps});
+    }
+
+    // CFO, drifting with the SFO slope as the demodulator models it.  Each
+    // chirp gets its own gain below, so its rotation starts at phase 0.
+    const double hz_per_bin = static_cast<double>(metadata.bw) / static_cast<double>(n_bins);
+    for (std::size_t k = 0; k < chirps.size(); ++k) {
+        const double hz = target.cfo_hz + 2.0 * target.sfo * static_cast<double>(k) * hz_per_bin;
+        const double w = 2.0 * std::numbers::pi * hz / static_cast<double>(metadata.sample_rate);
+        if (w == 0.0) {
+            continue;
+        }
+        const auto step = std::polar(1.0, w);
+        std::complex<double> rot{1.0, 0.0};
+        Sample* x = replica.data() + chirps[k].at;
+        for (std::size_t n = 0; n < chirps[k].len; ++n) {
+            // Re-seed exactly now and then so the recursion cannot drift.
+            if (n % 1024 == 0) {
+                rot = std::polar(1.0, w * static_cast<double>(n));
+            }
+            x[n] *= Sample(static_cast<float>(rot.real()), static_cast<float>(rot.imag()));
+            rot *= step;
+        }
+    }
+
+    // Frame start: the lock found a preamble window, not the first one, so
+    // try every upchirp it could be and score where the preamble is no
+    // help — the sync word, the SFD and the first data chirps.
+    const std::span<const Sample> rx(samples.data(), samples.size());
+    const std::size_t scored_end = std::min(chirps.size(), up + 3 + 8);
+    const auto anchor = static_cast<std::ptrdiff_t>(target.preamble_offset);
+    std::ptrdiff_t frame_start = anchor;
+    double best = -1.0;
+    for (int j = -1; j <= preamble_len + 1; ++j) {
+        for (int d = -2; d <= 2; ++d) {
+            const std::ptrdiff_t f = anchor - static_cast<std::ptrdiff_t>(j) * static_cast<std::ptrdiff_t>(sps) + d;
+            double score = 0.0;
+            for (std::size_t k = static_cast<std::size_t>(preamble_len); k < scored_end; ++k) {
+                score += chirp_score(replica, chirps[k], rx, f + static_cast<std::ptrdiff_t>(chirps[k].at));
+            }
+            if (score > best) {
+                best = score;
+                frame_start = f;
+            }
+        }
+    }
+
+    const auto frame = overlap(frame_start, frame_len, samples.size());
+    if (frame.len == 0) {
+        return std::nullopt;
+    }
+    CancelResult result;
+    result.frame_start = frame_start;
+    result.begin = frame.buf;
+    result.end = frame.buf + frame.len;
+    const double before = energy(samples.data() + result.begin, frame.len);
+
+    // Chirp by chirp: follow the timing within ±1 sample, fit the complex
+    // gain and subtract.
+    std::ptrdiff_t shift = 0;
+    for (const auto& c : chirps) {
+        const std::ptrdiff_t pos = frame_start + static_cast<std::ptrdiff_t>(c.at) + shift;
+        if (c.len == sps) {
+            int best_adj = 0;
+            double best_score = chirp_score(replica, c, rx, pos);
+            for (const int adj : {-1, 1}) {
+                const double s = chirp_score(replica, c, rx, pos + adj);
+                if (s > best_score) {
+                    best_score = s;
+                    best_adj = adj;
+                }
+            }
+            shift += best_adj;
+        }
+        const auto o = overlap(frame_start + static_cast<std::ptrdiff_t>(c.at) + shift, c.len, samples.size());
+        if (o.len == 0) {
+            continue;
+        }
+        const Sample* ref = replica.data() + c.at + o.ref;
+        Sample* x = samples.data() + o.buf;
+        const double e = energy(ref, o.len);
+        if (e <= 0.0) {
+            continue;
+        }
+        const auto g = correlate(ref, x, o.len) / e;
+        const Sample gain(static_cast<float>(g.real()), static_cast<float>(g.imag()));
+        for (std::size_t n = 0; n < o.len; ++n) {
+            x[n] -= gain * ref[n];
+        }
+    }
+
+    const double after = energy(samples.data() + result.begin, frame.len);
+    result.suppression_db = after > 0.0 && before > 0.0 ? static_cast<float>(10.0 * std::log10(before / after)) : 0.0f;
+    return result;
+}
+
+} // namespace host_sim
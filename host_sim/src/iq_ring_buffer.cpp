@@ -0,0 +1,145 @@
+#include "host_sim/iq_ring_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace host_sim
+{
+
+namespace
+{
+
+std::size_t page_size()
+{
+#if defined(__linux__)
+    const long page = ::sysconf(_SC_PAGESIZE);
+    if (page > 0) {
+        return static_cast<std::size_t>(page);
+    }
+#endif
+    return 4096;
+}
+
+#if defined(__linux__)
+/// Map @p bytes of anonymous shared memory twice, back to back.
+/// Returns nullptr when the kernel does not cooperate.
+void* map_double(std::size_t bytes)
+{
+    const int fd = ::memfd_create("host_sim_iq_ring", MFD_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    // Reserve the whole window first so nothing else can land in the
+    // second half between the two fixed mappings.
+    void* base = ::mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        ::close(fd);
+        return nullptr;
+    }
+    auto* lo = static_cast<char*>(base);
+    const bool ok =
+        ::mmap(lo, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+        ::mmap(lo + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+    ::close(fd);
+    if (!ok) {
+        ::munmap(base, 2 * bytes);
+        return nullptr;
+    }
+    return base;
+}
+#endif
+
+} // namespace
+
+IqRingBuffer::IqRingBuffer(std::size_t min_capacity)
+{
+    const std::size_t page = page_size();
+    const std::size_t bytes =
+        (std::max<std::size_t>(1, min_capacity) * sizeof(std::complex<float>) + page - 1) / page * page;
+    capacity_ = bytes / sizeof(std::complex<float>);
+
+#if defined(__linux__)
+    mapping_ = map_double(bytes);
+    if (mapping_) {
+        mapping_bytes_ = 2 * bytes;
+        base_ = static_cast<std::complex<float>*>(mapping_);
+        return;
+    }
+#endif
+    mirror_.resize(2 * capacity_);
+    base_ = mirror_.data();
+}
+
+IqRingBuffer::~IqRingBuffer()
+{
+#if defined(__linux__)
+    if (mapping_) {
+        ::munmap(mapping_, mapping_bytes_);
+    }
+#endif
+}
+
+std::size_t IqRingBuffer::write_space() const
+{
+    const auto written = write_pos_.load(std::memory_order_relaxed);
+    const auto read = read_pos_.load(std::memory_order_acquire);
+    return capacity_ - static_cast<std::size_t>(written - read);
+}
+
+std::size_t IqRingBuffer::push(const std::complex<float>* samples, std::size_t n)
+{
+    const auto written = write_pos_.load(std::memory_order_relaxed);
+    n = std::min(n, write_space());
+    if (n == 0) {
+        return 0;
+    }
+
+    const std::size_t start = static_cast<std::size_t>(written % capacity_);
+    if (mapping_) {
+        // The second mapping absorbs the wrap.
+        std::memcpy(base_ + start, samples, n * sizeof(std::complex<float>));
+    } else {
+        // Keep slot i and slot i + capacity identical so any window of up
+        // to `capacity` samples starting below `capacity` is contiguous.
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t slot = (start + i) % capacity_;
+            base_[slot] = samples[i];
+            base_[slot + capacity_] = samples[i];
+        }
+    }
+
+    write_pos_.store(written + n, std::memory_order_release);
+    return n;
+}
+
+std::size_t IqRingBuffer::readable() const
+{
+    const auto written = write_pos_.load(std::memory_order_acquire);
+    const auto read = read_pos_.load(std::memory_order_relaxed);
+    return static_cast<std::size_t>(written - read);
+}
+
+const std::complex<float>* IqRingBuffer::read_ptr() const
+{
+    const auto read = read_pos_.load(std::memory_order_relaxed);
+    return base_ + static_cast<std::size_t>(read % capacity_);
+}
+
+void IqRingBuffer::consume(std::size_t n)
+{
+    const auto read = read_pos_.load(std::memory_order_relaxed);
+    n = std::min(n, readable());
+    read_pos_.store(read + n, std::memory_order_release);
+}
+
+} // namespace host_sim
@@ -0,0 +1,759 @@
+/// Sample sources for StreamingIqReader: FILE* (stdin pipes), raw UDP and
+/// VITA-49 datagrams, ZeroMQ SUB and SoapySDR radios.
+
+#include "host_sim/iq_source.hpp"
+
+#include "host_sim/dsp_kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define HOST_SIM_WITH_UDP 1
+#endif
+
+#if defined(HOST_SIM_WITH_ZMQ)
+#include <zmq.h>
+#endif
+
+#if defined(HOST_SIM_WITH_SOAPYSDR)
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Errors.hpp>
+#include <SoapySDR/Formats.hpp>
+#endif
+
+namespace host_sim
+{
+
+namespace
+{
+
+/// How long a blocked network or radio read waits before it looks at
+/// the interrupt flag again.
+constexpr int kPollMs = 100;
+
+std::size_t bytes_per_sample(IqFormat format)
+{
+    switch (format) {
+    case IqFormat::hackrf_int8: return 2;
+    case IqFormat::sc16: return 4;
+    case IqFormat::cf32: break;
+    }
+    return 8;
+}
+
+/// Convert @p n samples of @p format at @p in (any alignment) to @p out.
+void convert_samples(IqFormat format, const std::uint8_t* in, std::size_t n, std::complex<float>* out)
+{
+    switch (format) {
+    case IqFormat::hackrf_int8:
+        kernels::int8_to_cf32(reinterpret_cast<const int8_t*>(in), n, out);
+        return;
+    case IqFormat::sc16:
+        if (reinterpret_cast<std::uintptr_t>(in) % alignof(std::int16_t) == 0) {
+            kernels::int16_to_cf32(reinterpret_cast<const int16_t*>(in), n, out);
+        } else {
+            for (std::size_t k = 0; k < n; ++k) {
+                std::int16_t iq[2];
+                std::memcpy(iq, in + 4 * k, sizeof iq);
+                out[k] = {iq[0] / 32768.0f, iq[1] / 32768.0f};
+            }
+        }
+        return;
+    case IqFormat::cf32:
+        std::memcpy(static_cast<void*>(out), in, n * sizeof(std::complex<float>));
+        return;
+    }
+}
+
+// ── FILE* ──
+
+class FileSource final : public IqSource
+{
+public:
+    FileSource(std::FILE* file, IqFormat format) : file_(file), format_(format)
+    {
+#ifdef _WIN32
+        if (file_ == stdin) {
+            _setmode(_fileno(stdin), _O_BINARY);
+        }
+#endif
+    }
+
+    IqSourceRead read(std::complex<float>* out, std::size_t max_samples) override
+    {
+        IqSourceRead result;
+        const std::size_t width = bytes_per_sample(format_);
+        const std::size_t wanted = max_samples * width;
+        std::size_t got = 0;
+        if (format_ == IqFormat::cf32) {
+            // Straight into the caller's block: complex<float> is
+            // layout-compatible with float[2].
+            got = std::fread(static_cast<void*>(out), 1, wanted, file_);
+        } else {
+            raw_.resize(wanted);
+            got = std::fread(raw_.data(), 1, wanted, file_);
+            convert_samples(format_, raw_.data(), got / width, out);
+        }
+        result.samples = got / width;
+        // fread() only comes back short at EOF (or on an error).
+        result.end = got < wanted;
+        return result;
+    }
+
+    std::string describe() const override { return file_ == stdin ? "stdin" : "file"; }
+
+private:
+    std::FILE* file_;
+    IqFormat format_;
+    std::vector<std::uint8_t> raw_;
+};
+
+// ── Datagram sources ──
+//
+// UDP and ZeroMQ deliver whole messages.  A message that fits the
+// caller's block converts straight into it; the rest of a larger one is
+// kept converted for the next read().
+
+class MessageSource : public IqSource
+{
+public:
+    IqSourceRead read(std::complex<float>* out, std::size_t max_samples) final
+    {
+        IqSourceRead result;
+        if (pending_pos_ < pending_.size()) {
+            result.samples = std::min(max_samples, pending_.size() - pending_pos_);
+            std::copy_n(pending_.begin() + static_cast<std::ptrdiff_t>(pending_pos_), result.samples, out);
+            pending_pos_ += result.samples;
+            return result;
+        }
+        Message message;
+        if (!receive(message)) {
+            result.end = true;
+            return result;
+        }
+        result.lost_samples = message.lost_samples;
+        result.overflow = message.overflow;
+        result.time_ns = message.time_ns;
+        if (message.samples <= max_samples) {
+            convert_samples(message.format, message.data, message.samples, out);
+            result.samples = message.samples;
+        } else {
+            pending_.resize(message.samples);
+            convert_samples(message.format, message.data, message.samples, pending_.data());
+            std::copy_n(pending_.begin(), max_samples, out);
+            pending_pos_ = max_samples;
+            result.samples = max_samples;
+        }
+        return result;
+    }
+
+    bool interrupt() override
+    {
+        stop_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+protected:
+    struct Message
+    {
+        const std::uint8_t* data{nullptr};   ///< Valid until the next receive()
+        std::size_t samples{0};
+        IqFormat format{IqFormat::cf32};
+        std::uint64_t lost_samples{0};
+        bool overflow{false};
+        std::optional<std::int64_t> time_ns;
+    };
+
+    /// Wait for the next message with samples.  False once interrupted.
+    virtual bool receive(Message& message) = 0;
+
+    bool stopped() const { return stop_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::vector<std::complex<float>> pending_;
+    std::size_t pending_pos_{0};
+};
+
+#if defined(HOST_SIM_WITH_UDP)
+
+std::uint32_t load_be32(const std::uint8_t* p)
+{
+    return (std::uint32_t{p[0]} << 24) | (std::uint32_t{p[1]} << 16) | (std::uint32_t{p[2]} << 8) | p[3];
+}
+
+/// The fields of a VITA-49 (VRT) packet StreamingIqReader uses.
+struct VrtPacket
+{
+    bool data{false};                       ///< IF/extension data, not context
+    int count{0};                           ///< 4-bit packet count
+    const std::uint8_t* payload{nullptr};
+    std::size_t payload_bytes{0};
+    std::optional<std::int64_t> time_ns;    ///< Integer + real-time (ps) timestamp
+};
+
+/// Parse the header of the VRT packet in @p p.  False when @p bytes does
+/// not hold the packet its header describes.
+bool parse_vrt(const std::uint8_t* p, std::size_t bytes, VrtPacket& packet)
+{
+    if (bytes < 4) {
+        return false;
+    }
+    const std::uint32_t header = load_be32(p);
+    const std::size_t size = static_cast<std::size_t>(header & 0xFFFF) * 4;
+    if (size < 4 || size > bytes) {
+        return false;
+    }
+    const unsigned type = header >> 28;
+    const bool class_id = (header >> 27) & 1;
+    const bool trailer = (header >> 26) & 1;
+    const unsigned tsi = (header >> 22) & 3;
+    const unsigned tsf = (header >> 20) & 3;
+    packet.data = type <= 3;
+    packet.count = static_cast<int>((header >> 16) & 0xF);
+
+    std::size_t offset = 4;
+    if (type != 0 && type != 2) {
+        offset += 4;   // stream ID
+    }
+    if (class_id) {
+        offset += 8;
+    }
+    std::uint32_t seconds = 0;
+    if (tsi != 0) {
+        if (offset + 4 > size) return false;
+        seconds = load_be32(p + offset);
+        offset += 4;
+    }
+    std::uint64_t fraction = 0;
+    if (tsf != 0) {
+        if (offset + 8 > size) return false;
+        fraction = (std::uint64_t{load_be32(p + offset)} << 32) | load_be32(p + offset + 4);
+        offset += 8;
+    }
+    const std::size_t end = size - ((packet.data && trailer) ? 4 : 0);
+    if (offset > end) {
+        return false;
+    }
+    // UTC or GPS seconds with a picosecond fraction (or none); a
+    // sample-count fraction would need the rate, so it is not used.
+    packet.time_ns.reset();
+    if ((tsi == 1 || tsi == 2) && (tsf == 0 || tsf == 2)) {
+        packet.time_ns = static_cast<std::int64_t>(seconds) * 1000000000 +
+                         static_cast<std::int64_t>(fraction / 1000);
+    }
+    packet.payload = p + offset;
+    packet.payload_bytes = end - offset;
+    return true;
+}
+
+class UdpSource final : public MessageSource
+{
+public:
+    explicit UdpSource(const IqSourceSpec& spec) : format_(spec.format), vita49_(spec.kind == IqSourceKind::vita49)
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+        addrinfo* found = nullptr;
+        const std::string service = std::to_string(spec.port);
+        const int rc = getaddrinfo(spec.address.empty() ? nullptr : spec.address.c_str(), service.c_str(),
+                                   &hints, &found);
+        if (rc != 0) {
+            throw std::runtime_error("Cannot resolve UDP address '" + spec.address + "': " + gai_strerror(rc));
+        }
+        for (addrinfo* ai = found; ai != nullptr && fd_ < 0; ai = ai->ai_next) {
+            fd_ = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd_ < 0) continue;
+            const int one = 1;
+            ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+            // A deep socket buffer rides out decode stalls; the kernel
+            // caps it at net.core.rmem_max.
+            const int rcvbuf = 16 << 20;
+            ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof rcvbuf);
+#ifdef SO_RXQ_OVFL
+            ::setsockopt(fd_, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof one);
+#endif
+            if (::bind(fd_, ai->ai_addr, ai->ai_addrlen) != 0) {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+        freeaddrinfo(found);
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot bind UDP port " + std::to_string(spec.port) + ": " +
+                                     std::strerror(errno));
+        }
+        sockaddr_storage bound{};
+        socklen_t length = sizeof bound;
+        ::getsockname(fd_, reinterpret_cast<sockaddr*>(&bound), &length);
+        char host[NI_MAXHOST] = {};
+        char port[NI_MAXSERV] = {};
+        getnameinfo(reinterpret_cast<sockaddr*>(&bound), length, host, sizeof host, port, sizeof port,
+                    NI_NUMERICHOST | NI_NUMERICSERV);
+        describe_ = std::string(vita49_ ? "vita49://" : "udp://") +
+                    (bound.ss_family == AF_INET6 ? "[" + std::string(host) + "]" : std::string(host)) + ":" + port;
+        // Word-aligned, and as large as a datagram can be.
+        buffer_.resize(65536 / 4);
+    }
+
+    ~UdpSource() override { ::close(fd_); }
+
+    std::string describe() const override { return describe_; }
+
+protected:
+    bool receive(Message& message) override
+    {
+        auto* bytes = reinterpret_cast<std::uint8_t*>(buffer_.data());
+        for (;;) {
+            pollfd waiting{fd_, POLLIN, 0};
+            const int ready = ::poll(&waiting, 1, kPollMs);
+            if (stopped()) {
+                return false;
+            }
+            if (ready <= 0) {
+                if (ready < 0 && errno != EINTR) {
+                    throw std::runtime_error(std::string("UDP poll failed: ") + std::strerror(errno));
+                }
+                continue;
+            }
+            iovec io{bytes, buffer_.size() * 4};
+            alignas(cmsghdr) char control[64];
+            msghdr header{};
+            header.msg_iov = &io;
+            header.msg_iovlen = 1;
+            header.msg_control = control;
+            header.msg_controllen = sizeof control;
+            const ssize_t got = ::recvmsg(fd_, &header, 0);
+            if (got < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                throw std::runtime_error(std::string("UDP receive failed: ") + std::strerror(errno));
+            }
+            std::uint64_t kernel_drops = 0;
+#ifdef SO_RXQ_OVFL
+            for (cmsghdr* c = CMSG_FIRSTHDR(&header); c != nullptr; c = CMSG_NXTHDR(&header, c)) {
+                if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_RXQ_OVFL) {
+                    std::uint32_t total = 0;
+                    std::memcpy(&total, CMSG_DATA(c), sizeof total);
+                    kernel_drops = static_cast<std::uint32_t>(total - kernel_drops_seen_);
+                    kernel_drops_seen_ = total;
+                }
+            }
+#endif
+            message = Message{};
+            if (vita49_) {
+                VrtPacket packet;
+                if (!parse_vrt(bytes, static_cast<std::size_t>(got), packet) || !packet.data) {
+                    continue;   // context packets and runts
+                }
+                message.format = IqFormat::sc16;
+                message.samples = packet.payload_bytes / 4;
+                message.time_ns = packet.time_ns;
+                if (next_count_ >= 0 && packet.count != next_count_) {
+                    // Whole packets went missing upstream; assume they
+                    // were the size of this one.
+                    const int missing = (packet.count - next_count_) & 0xF;
+                    message.lost_samples += static_cast<std::uint64_t>(missing) * message.samples;
+                }
+                next_count_ = (packet.count + 1) & 0xF;
+                swap_to_host(packet.payload, message.samples);
+                message.data = packet.payload;
+            } else {
+                message.format = format_;
+                message.samples = static_cast<std::size_t>(got) / bytes_per_sample(format_);
+                message.data = bytes;
+            }
+            if (kernel_drops > 0) {
+                message.overflow = true;
+                message.lost_samples += kernel_drops * message.samples;
+            }
+            if (message.samples > 0) {
+                return true;
+            }
+        }
+    }
+
+private:
+    /// VITA-49 sc16 is big-endian: swap the payload in place so it
+    /// converts like host sc16.
+    static void swap_to_host(const std::uint8_t* payload, std::size_t samples)
+    {
+        if constexpr (std::endian::native == std::endian::little) {
+            auto* p = const_cast<std::uint8_t*>(payload);
+            for (std::size_t k = 0; k < 2 * samples; ++k) {
+                std::swap(p[2 * k], p[2 * k + 1]);
+            }
+        }
+    }
+
+    IqFormat format_;
+    bool vita49_;
+    int fd_{-1};
+    int next_count_{-1};
+    std::uint32_t kernel_drops_seen_{0};
+    std::string describe_;
+    std::vector<std::uint32_t> buffer_;
+};
+
+#endif // HOST_SIM_WITH_UDP
+
+#if defined(HOST_SIM_WITH_ZMQ)
+
+// ── ZeroMQ SUB ──
+//
+// Each message is a block of samples in the wire encoding (what
+// gr-zeromq's PUB sink sends).  PUB sockets drop silently at their high
+// water mark, so no loss is reported.
+
+class ZmqSource final : public MessageSource
+{
+public:
+    explicit ZmqSource(const IqSourceSpec& spec) : format_(spec.format), endpoint_(spec.address)
+    {
+        context_ = zmq_ctx_new();
+        socket_ = context_ ? zmq_socket(context_, ZMQ_SUB) : nullptr;
+        const int timeout = kPollMs;
+        if (!socket_ || zmq_setsockopt(socket_, ZMQ_SUBSCRIBE, "", 0) != 0 ||
+            zmq_setsockopt(socket_, ZMQ_RCVTIMEO, &timeout, sizeof timeout) != 0 ||
+            zmq_connect(socket_, endpoint_.c_str()) != 0) {
+            const std::string error = zmq_strerror(zmq_errno());
+            close();
+            throw std::runtime_error("Cannot subscribe to " + endpoint_ + ": " + error);
+        }
+        zmq_msg_init(&message_);
+    }
+
+    ~ZmqSource() override
+    {
+        zmq_msg_close(&message_);
+        close();
+    }
+
+    std::string describe() const override { return "zmq+" + endpoint_; }
+
+protected:
+    bool receive(Message& message) override
+    {
+        for (;;) {
+            if (stopped()) {
+                return false;
+            }
+            if (zmq_msg_recv(&message_, socket_, 0) < 0) {
+                if (zmq_errno() == EAGAIN || zmq_errno() == EINTR) continue;
+                throw std::runtime_error(std::string("ZeroMQ receive failed: ") + zmq_strerror(zmq_errno()));
+            }
+            message = Message{};
+            message.format = format_;
+            message.data = static_cast<const std::uint8_t*>(zmq_msg_data(&message_));
+            message.samples = zmq_msg_size(&message_) / bytes_per_sample(format_);
+            if (message.samples > 0) {
+                return true;
+            }
+        }
+    }
+
+private:
+    void close()
+    {
+        if (socket_) zmq_close(socket_);
+        if (context_) zmq_ctx_term(context_);
+        socket_ = nullptr;
+        context_ = nullptr;
+    }
+
+    IqFormat format_;
+    std::string endpoint_;
+    void* context_{nullptr};
+    void* socket_{nullptr};
+    zmq_msg_t message_;
+};
+
+#endif // HOST_SIM_WITH_ZMQ
+
+#if defined(HOST_SIM_WITH_SOAPYSDR)
+
+// ── SoapySDR ──
+//
+// readStream() writes CF32 straight into the reader's block.  The driver
+// flags overflows; with hardware time the gap they leave is measured
+// from the timestamps.
+
+class SoapySource final : public IqSource
+{
+public:
+    explicit SoapySource(const IqSourceSpec& spec)
+        : sample_rate_(spec.sample_rate), describe_("soapy://" + spec.address)
+    {
+        if (!(spec.sample_rate > 0.0) || !(spec.frequency_hz > 0.0)) {
+            throw std::runtime_error("soapy:// sources need freq= and rate=");
+        }
+        device_ = SoapySDR::Device::make(spec.address);
+        if (!device_) {
+            throw std::runtime_error("No SoapySDR device matches '" + spec.address + "'");
+        }
+        try {
+            device_->setSampleRate(SOAPY_SDR_RX, spec.channel, spec.sample_rate);
+            device_->setFrequency(SOAPY_SDR_RX, spec.channel, spec.frequency_hz);
+            if (!spec.antenna.empty()) {
+                device_->setAntenna(SOAPY_SDR_RX, spec.channel, spec.antenna);
+            }
+            if (spec.gain_db) {
+                device_->setGain(SOAPY_SDR_RX, spec.channel, *spec.gain_db);
+            } else if (device_->hasGainMode(SOAPY_SDR_RX, spec.channel)) {
+                device_->setGainMode(SOAPY_SDR_RX, spec.channel, true);
+            }
+            stream_ = device_->setupStream(SOAPY_SDR_RX, SOAPY_SDR_CF32, {spec.channel});
+            if (device_->activateStream(stream_) != 0) {
+                throw std::runtime_error("Cannot start the SoapySDR RX stream");
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~SoapySource() override { release(); }
+
+    IqSourceRead read(std::complex<float>* out, std::size_t max_samples) override
+    {
+        IqSourceRead result;
+        for (;;) {
+            if (stop_.load(std::memory_order_relaxed)) {
+                result.end = true;
+                return result;
+            }
+            void* buffers[] = {out};
+            int flags = 0;
+            long long time_ns = 0;
+            const int n = device_->readStream(stream_, buffers, max_samples, flags, time_ns, kPollMs * 1000);
+            if (n == SOAPY_SDR_TIMEOUT) {
+                continue;
+            }
+            if (n == SOAPY_SDR_OVERFLOW) {
+                overflowed_ = true;
+                continue;
+            }
+            if (n < 0) {
+                throw std::runtime_error(std::string("SoapySDR read failed: ") + SoapySDR::errToStr(n));
+            }
+            result.samples = static_cast<std::size_t>(n);
+            result.overflow = std::exchange(overflowed_, false);
+            if (flags & SOAPY_SDR_HAS_TIME) {
+                result.time_ns = time_ns;
+                if (next_time_ns_ && time_ns > *next_time_ns_) {
+                    result.lost_samples = static_cast<std::uint64_t>(
+                        std::llround(static_cast<double>(time_ns - *next_time_ns_) * sample_rate_ * 1e-9));
+                }
+                next_time_ns_ = time_ns + static_cast<long long>(std::llround(n * 1e9 / sample_rate_));
+            }
+            return result;
+        }
+    }
+
+    bool interrupt() override
+    {
+        stop_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::string describe() const override { return describe_; }
+
+private:
+    void release()
+    {
+        if (stream_) {
+            device_->deactivateStream(stream_);
+            device_->closeStream(stream_);
+            stream_ = nullptr;
+        }
+        if (device_) {
+            SoapySDR::Device::unmake(device_);
+            device_ = nullptr;
+        }
+    }
+
+    double sample_rate_;
+    std::string describe_;
+    SoapySDR::Device* device_{nullptr};
+    SoapySDR::Stream* stream_{nullptr};
+    std::atomic<bool> stop_{false};
+    bool overflowed_{false};
+    std::optional<long long> next_time_ns_;
+};
+
+#endif // HOST_SIM_WITH_SOAPYSDR
+
+/// strtod() of the whole of @p text, or throw naming @p what.
+double parse_number(std::string_view text, const char* what)
+{
+    const std::string owned(text);
+    char* end = nullptr;
+    const double value = std::strtod(owned.c_str(), &end);
+    if (owned.empty() || end != owned.c_str() + owned.size() || !std::isfinite(value)) {
+        throw std::runtime_error(std::string("Bad ") + what + " in IQ source: '" + owned + "'");
+    }
+    return value;
+}
+
+/// Split "host:port", "[v6]:port" or ":port".
+void parse_host_port(std::string_view rest, std::string_view uri, IqSourceSpec& spec)
+{
+    const auto colon = rest.rfind(':');
+    if (colon == std::string_view::npos) {
+        throw std::runtime_error("IQ source '" + std::string(uri) + "' needs a :port");
+    }
+    std::string_view host = rest.substr(0, colon);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    const double port = parse_number(rest.substr(colon + 1), "port");
+    if (port < 0 || port > 65535 || port != std::floor(port)) {
+        throw std::runtime_error("Bad port in IQ source '" + std::string(uri) + "'");
+    }
+    spec.address = std::string(host);
+    spec.port = static_cast<std::uint16_t>(port);
+}
+
+} // namespace
+
+IqSourceSpec parse_iq_source(std::string_view uri, IqFormat format)
+{
+    IqSourceSpec spec;
+    spec.format = format;
+    if (uri == "-" || uri == "stdin") {
+        return spec;
+    }
+    if (uri.starts_with("udp://")) {
+        spec.kind = IqSourceKind::udp;
+        parse_host_port(uri.substr(6), uri, spec);
+    } else if (uri.starts_with("vita49://")) {
+        spec.kind = IqSourceKind::vita49;
+        spec.format = IqFormat::sc16;
+        parse_host_port(uri.substr(9), uri, spec);
+    } else if (uri.starts_with("zmq+")) {
+        spec.kind = IqSourceKind::zmq;
+        spec.address = std::string(uri.substr(4));
+        if (spec.address.find("://") == std::string::npos) {
+            throw std::runtime_error("IQ source '" + std::string(uri) + "' needs a ZeroMQ endpoint");
+        }
+    } else if (uri.starts_with("soapy://")) {
+        spec.kind = IqSourceKind::soapysdr;
+        std::string_view rest = uri.substr(8);
+        const auto query = rest.find('?');
+        spec.address = std::string(rest.substr(0, query));
+        rest = query == std::string_view::npos ? std::string_view{} : rest.substr(query + 1);
+        while (!rest.empty()) {
+            const auto amp = rest.find('&');
+            const std::string_view pair = rest.substr(0, amp);
+            rest = amp == std::string_view::npos ? std::string_view{} : rest.substr(amp + 1);
+            const auto eq = pair.find('=');
+            const std::string_view key = pair.substr(0, eq);
+            const std::string_view value = eq == std::string_view::npos ? std::string_view{} : pair.substr(eq + 1);
+            if (key == "freq") {
+                spec.frequency_hz = parse_number(value, "freq");
+            } else if (key == "rate") {
+                spec.sample_rate = parse_number(value, "rate");
+            } else if (key == "gain") {
+                spec.gain_db = parse_number(value, "gain");
+            } else if (key == "antenna") {
+                spec.antenna = std::string(value);
+            } else if (key == "channel") {
+                spec.channel = static_cast<std::size_t>(parse_number(value, "channel"));
+            } else {
+                throw std::runtime_error("Unknown soapy:// parameter '" + std::string(key) + "'");
+            }
+        }
+    } else {
+        throw std::runtime_error("Unknown IQ source '" + std::string(uri) +
+                                 "' (expected -, udp://, vita49://, zmq+<endpoint> or soapy://)");
+    }
+    return spec;
+}
+
+const char* iq_source_kind_name(IqSourceKind kind)
+{
+    switch (kind) {
+    case IqSourceKind::file: return "file";
+    case IqSourceKind::udp: return "udp";
+    case IqSourceKind::vita49: return "vita49";
+    case IqSourceKind::zmq: return "zmq";
+    case IqSourceKind::soapysdr: return "soapysdr";
+    }
+    return "unknown";
+}
+
+bool iq_source_available(IqSourceKind kind)
+{
+    switch (kind) {
+    case IqSourceKind::file:
+        return true;
+    case IqSourceKind::udp:
+    case IqSourceKind::vita49:
+#if defined(HOST_SIM_WITH_UDP)
+        return true;
+#else
+        return false;
+#endif
+    case IqSourceKind::zmq:
+#if defined(HOST_SIM_WITH_ZMQ)
+        return true;
+#else
+        return false;
+#endif
+    case IqSourceKind::soapysdr:
+#if defined(HOST_SIM_WITH_SOAPYSDR)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+std::unique_ptr<IqSource> open_iq_source(const IqSourceSpec& spec, std::FILE* file)
+{
+    switch (spec.kind) {
+    case IqSourceKind::file:
+        return std::make_unique<FileSource>(file, spec.format);
+    case IqSourceKind::udp:
+    case IqSourceKind::vita49:
+#if defined(HOST_SIM_WITH_UDP)
+        return std::make_unique<UdpSource>(spec);
+#else
+        break;
+#endif
+    case IqSourceKind::zmq:
+#if defined(HOST_SIM_WITH_ZMQ)
+        return std::make_unique<ZmqSource>(spec);
+#else
+        break;
+#endif
+    case IqSourceKind::soapysdr:
+#if defined(HOST_SIM_WITH_SOAPYSDR)
+        return std::make_unique<SoapySource>(spec);
+#else
+        break;
+#endif
+    }
+    throw std::runtime_error(std::string("IQ source not built: ") + iq_source_kind_name(spec.kind));
+}
+
+} // namespace host_sim
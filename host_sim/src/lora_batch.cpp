@@ -0,0 +1,567 @@
+// lora_batch — in-process batch decode of many captures.
+//
+// Takes capture directories, single .cf32 files or manifests, indexes
+// every capture's bursts once (BurstIndex) and decodes all bursts of all
+// captures with the same decode_stream_burst() lora_replay --stream runs.
+// Files and bursts share one task list on the shared worker pool, longest
+// burst first, so a few long captures do not serialise the tail of the
+// run; demodulators are kept per worker and per (SF, Fs, BW), and the
+// chirp and FFT caches behind them are process-wide.  Results are
+// collected by capture and burst index, so the report does not depend on
+// the thread count.
+
+#include "host_sim/burst_detector.hpp"
+#include "host_sim/capture.hpp"
+#include "host_sim/decode_arena.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/lora_replay/options.hpp"
+#include "host_sim/lora_replay/stage_processing.hpp"
+#include "host_sim/metrics.hpp"
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+namespace fs = std::filesystem;
+
+struct BatchOptions
+{
+    std::vector<fs::path> inputs;
+    bool recursive{false};
+    bool soft{false};
+    bool verbose{false};
+    double max_per{-1.0};   // < 0: no threshold
+    fs::path output;
+};
+
+struct CaptureJob
+{
+    fs::path capture;
+    fs::path metadata;   // empty: none found
+};
+
+struct BurstOutcome
+{
+    host_sim::BurstInterval interval;
+    float snr_db{0.0f};
+    host_sim::lora_replay::StreamDecodeResult result;
+    double decode_ms{0.0};
+    std::string error;
+    std::string report;   // decoder log, kept for --verbose
+};
+
+struct CaptureResult
+{
+    CaptureJob job;
+    std::optional<host_sim::LoRaMetadata> metadata;
+    std::optional<host_sim::MappedCapture> samples;
+    host_sim::CaptureStats stats;
+    std::string payload;   // expected bytes from payload_hex, for BER
+    std::vector<BurstOutcome> bursts;
+    std::string error;
+
+    std::size_t header_ok() const
+    {
+        return static_cast<std::size_t>(std::count_if(bursts.begin(), bursts.end(),
+                                                      [](const auto& b) { return b.result.header_ok; }));
+    }
+    std::size_t crc_ok() const
+    {
+        return static_cast<std::size_t>(std::count_if(bursts.begin(), bursts.end(),
+                                                      [](const auto& b) { return b.result.crc_ok; }));
+    }
+    std::size_t good() const
+    {
+        return static_cast<std::size_t>(std::count_if(bursts.begin(), bursts.end(), [](const auto& b) {
+            return b.result.crc_ok && !b.result.payload_failure;
+        }));
+    }
+    long long bit_errors() const
+    {
+        return std::accumulate(bursts.begin(), bursts.end(), 0LL,
+                               [](long long acc, const auto& b) { return acc + b.result.bit_errors; });
+    }
+    long long total_bits() const
+    {
+        return std::accumulate(bursts.begin(), bursts.end(), 0LL,
+                               [](long long acc, const auto& b) { return acc + b.result.total_bits; });
+    }
+
+    // Lost bursts over detected bursts; a capture with no burst at all
+    // counts as lost.
+    double per() const
+    {
+        return bursts.empty() ? 1.0 : 1.0 - static_cast<double>(good()) / static_cast<double>(bursts.size());
+    }
+    double ber() const
+    {
+        const auto bits = total_bits();
+        return bits ? static_cast<double>(bit_errors()) / static_cast<double>(bits) : 0.0;
+    }
+};
+
+void print_usage(const char* prog)
+{
+    std::cerr
+        << "Usage: " << prog << " [options] --output <summary.json> <input>...\n"
+        << "Inputs are capture directories, .cf32 files or manifests (one capture per\n"
+        << "line, optionally followed by its metadata file; '#' starts a comment).\n"
+        << "Metadata is looked up as <capture>.json, <capture>_meta.json, then\n"
+        << "metadata.json next to the capture; each file is parsed once.\n"
+        << "  --recursive            Descend into subdirectories\n"
+        << "  --soft                 Soft-decision decoding\n"
+        << "  --verbose              Print the decoder log of every lost burst\n"
+        << "  --max-per <p>          Exit non-zero when any capture's PER exceeds p\n"
+        << "  --output <file>        Merged summary JSON\n"
+        << "Threads: HOST_SIM_THREADS (default: hardware concurrency)\n";
+}
+
+std::optional<BatchOptions> parse_args(int argc, char* argv[])
+{
+    BatchOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--recursive") { opts.recursive = true; }
+        else if (arg == "--soft") { opts.soft = true; }
+        else if (arg == "--verbose") { opts.verbose = true; }
+        else if (arg == "--max-per") { opts.max_per = std::stod(next()); }
+        else if (arg == "--output") { opts.output = next(); }
+        else if (arg == "--help" || arg == "-h") { return std::nullopt; }
+        else if (arg.starts_with("--")) {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return std::nullopt;
+        }
+        else { opts.inputs.emplace_back(arg); }
+    }
+    if (opts.output.empty() || opts.inputs.empty()) {
+        std::cerr << "Error: --output and at least one input are required\n";
+        return std::nullopt;
+    }
+    return opts;
+}
+
+fs::path find_metadata(const fs::path& capture)
+{
+    const auto stem = fs::path(capture).replace_extension("").string();
+    const fs::path shared = capture.parent_path() / "metadata.json";
+    for (const fs::path& candidate : {fs::path(stem + ".json"), fs::path(stem + "_meta.json"), shared}) {
+        if (fs::is_regular_file(candidate)) {
+            return candidate;
+        }
+    }
+    return {};
+}
+
+// Every capture named by @p inputs, in order; directory listings are
+// sorted so the report order is stable.
+std::vector<CaptureJob> collect_jobs(const BatchOptions& opts)
+{
+    std::vector<CaptureJob> jobs;
+    for (const auto& input : opts.inputs) {
+        if (fs::is_directory(input)) {
+            std::vector<fs::path> found;
+            const auto take = [&](const fs::directory_entry& entry) {
+                if (entry.is_regular_file() && entry.path().extension() == ".cf32") {
+                    found.push_back(entry.path());
+                }
+            };
+            if (opts.recursive) {
+                for (const auto& entry : fs::recursive_directory_iterator(input)) {
+                    take(entry);
+                }
+            } else {
+                for (const auto& entry : fs::directory_iterator(input)) {
+                    take(entry);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            for (const auto& path : found) {
+                jobs.push_back({path, find_metadata(path)});
+            }
+        } else if (input.extension() == ".cf32") {
+            jobs.push_back({input, find_metadata(input)});
+        } else {
+            std::ifstream manifest(input);
+            if (!manifest) {
+                throw std::runtime_error("Unable to open input: " + input.string());
+            }
+            const auto base = input.parent_path();
+            std::string line;
+            while (std::getline(manifest, line)) {
+                line = line.substr(0, line.find('#'));
+                std::istringstream fields(line);
+                std::string capture;
+                std::string metadata;
+                if (!(fields >> capture)) {
+                    continue;
+                }
+                fields >> metadata;
+                const auto path = base / capture;
+                jobs.push_back({path, metadata.empty() ? find_metadata(path) : base / metadata});
+            }
+        }
+    }
+    return jobs;
+}
+
+std::string hex_to_bytes(const std::string& hex)
+{
+    std::string bytes;
+    for (std::size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes.push_back(static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+}
+
+std::string bytes_to_hex(const std::vector<uint8_t>& bytes)
+{
+    std::ostringstream out;
+    out << std::hex << std::setfill('0');
+    for (const auto b : bytes) {
+        out << std::setw(2) << static_cast<int>(b);
+    }
+    return out.str();
+}
+
+std::string json_string(const std::string& value)
+{
+    std::string out = "\"";
+    for (const char ch : value) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+        }
+        out += ch;
+    }
+    return out + "\"";
+}
+
+// Map the capture and list its decodable bursts.  Failures are recorded
+// on the capture, not thrown, so one bad file does not stop the batch.
+void index_capture(CaptureResult& capture)
+{
+    try {
+        if (!capture.metadata) {
+            throw std::runtime_error("no metadata");
+        }
+        const auto& meta = *capture.metadata;
+        if (!meta.channels.empty()) {
+            throw std::runtime_error("channelized captures are not supported; use lora_replay");
+        }
+        if (meta.payload_hex) {
+            capture.payload = hex_to_bytes(*meta.payload_hex);
+        }
+        capture.samples.emplace(capture.job.capture);
+        const auto samples = capture.samples->samples();
+        capture.stats = host_sim::analyse_capture(samples);
+        const auto sps = static_cast<std::size_t>(
+            (static_cast<long long>(meta.sample_rate) << meta.sf) / meta.bw);
+        if (sps == 0 || samples.size() < sps) {
+            return;
+        }
+        const host_sim::BurstIndex index(samples.data(), samples.size(), sps, 6.0f, 2);
+        const float noise = index.noise_floor();
+        for (const auto& interval : index.bursts()) {
+            if (interval.end - interval.start < sps * 12) {
+                continue;
+            }
+            BurstOutcome burst;
+            burst.interval = interval;
+            const float snr = noise > 0.0f ? (interval.signal_power - noise) / noise : 0.0f;
+            burst.snr_db = snr > 0.0f ? 10.0f * std::log10(snr) : -99.0f;
+            capture.bursts.push_back(std::move(burst));
+        }
+    } catch (const std::exception& ex) {
+        capture.error = ex.what();
+        capture.samples.reset();
+        capture.bursts.clear();
+    }
+}
+
+// One demodulator per (SF, Fs, BW) seen by a worker.
+using DemodBank = std::map<std::tuple<int, int, int>, std::unique_ptr<host_sim::FftDemodulator>>;
+
+void decode_bursts(std::vector<CaptureResult>& captures, const BatchOptions& opts)
+{
+    struct Task
+    {
+        std::size_t capture;
+        std::size_t burst;
+        std::size_t length;
+    };
+    std::vector<Task> tasks;
+    for (std::size_t c = 0; c < captures.size(); ++c) {
+        for (std::size_t b = 0; b < captures[c].bursts.size(); ++b) {
+            const auto& interval = captures[c].bursts[b].interval;
+            tasks.push_back({c, b, interval.end - interval.start});
+        }
+    }
+    // The pool hands indices out in order: longest first keeps the last
+    // tasks short, so threads finish together.
+    std::stable_sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) { return a.length > b.length; });
+
+    auto& pool = host_sim::WorkerPool::shared();
+    host_sim::PerWorker<DemodBank> banks(pool);
+    host_sim::PerWorker<host_sim::DecodeArena> arenas(pool);
+    pool.parallel_for(tasks.size(), [&](std::size_t i, std::size_t worker) {
+        auto& capture = captures[tasks[i].capture];
+        auto& burst = capture.bursts[tasks[i].burst];
+        const auto& meta = *capture.metadata;
+        try {
+            auto& bank = banks.get(worker, [] { return std::make_unique<DemodBank>(); });
+            auto& demod = bank[{meta.sf, meta.sample_rate, meta.bw}];
+            if (!demod) {
+                demod = std::make_unique<host_sim::FftDemodulator>(meta.sf, meta.sample_rate, meta.bw);
+            }
+            host_sim::lora_replay::Options options;
+            options.payload = capture.payload;
+            options.soft = opts.soft;
+            std::ostringstream report;
+            if (!opts.verbose) {
+                report.setstate(std::ios::badbit);   // every insertion becomes a no-op
+            }
+            const auto samples = capture.samples->samples().subspan(
+                burst.interval.start, burst.interval.end - burst.interval.start);
+            // Scratch from the worker's arena: concurrent decodes never meet
+            // in the allocator.
+            auto& arena = arenas.get(worker, [] { return std::make_unique<host_sim::DecodeArena>(); });
+            arena.reset();
+            const auto t0 = std::chrono::steady_clock::now();
+            burst.result = host_sim::lora_replay::decode_stream_burst(samples, *demod, meta, options, report,
+                                                                      arena.resource());
+            burst.decode_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            burst.report = report.str();
+        } catch (const std::exception& ex) {
+            burst.error = ex.what();   // counted as a lost burst
+        }
+    });
+}
+
+host_sim::lora_replay::SummaryReport build_summary(const CaptureResult& capture)
+{
+    host_sim::lora_replay::SummaryReport summary;
+    summary.capture_path = capture.job.capture.generic_string();
+    summary.metadata = capture.metadata;
+    if (capture.samples) {
+        summary.stats = capture.stats;
+    }
+    summary.packet_error_rate = capture.per();
+    summary.bit_error_rate = capture.ber();
+    // Per-burst decode times stand in for the per-symbol stage timings.
+    for (const auto& burst : capture.bursts) {
+        summary.stage_timings_ns.push_back(burst.decode_ms * 1e6);
+    }
+    return summary;
+}
+
+// Re-indent a nested JSON document by @p indent.
+std::string indent_json(const std::string& json, const std::string& indent)
+{
+    std::string out;
+    for (std::size_t i = 0; i < json.size(); ++i) {
+        out += json[i];
+        if (json[i] == '\n' && i + 1 < json.size()) {
+            out += indent;
+        }
+    }
+    while (!out.empty() && out.back() == '\n') {
+        out.pop_back();
+    }
+    return out;
+}
+
+void write_report(const fs::path& path, const std::vector<CaptureResult>& captures, double seconds)
+{
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Unable to open batch output file: " + path.string());
+    }
+    std::size_t failed = 0;
+    std::size_t bursts = 0;
+    std::size_t header_ok = 0;
+    std::size_t crc_ok = 0;
+    std::size_t good = 0;
+    long long bit_errors = 0;
+    long long total_bits = 0;
+    std::size_t samples = 0;
+    std::vector<double> decode_ms;
+    for (const auto& c : captures) {
+        failed += c.error.empty() ? 0 : 1;
+        bursts += c.bursts.size();
+        header_ok += c.header_ok();
+        crc_ok += c.crc_ok();
+        good += c.good();
+        bit_errors += c.bit_errors();
+        total_bits += c.total_bits();
+        samples += c.samples ? c.samples->size() : 0;
+        for (const auto& b : c.bursts) {
+            decode_ms.push_back(b.decode_ms);
+        }
+    }
+    out << std::setprecision(6) << "{\n"
+        << "  \"threads\": " << host_sim::WorkerPool::shared().worker_count() << ",\n"
+        << "  \"aggregate\": {\n"
+        << "    \"captures\": " << captures.size() << ",\n"
+        << "    \"failed_captures\": " << failed << ",\n"
+        << "    \"samples\": " << samples << ",\n"
+        << "    \"bursts\": " << bursts << ",\n"
+        << "    \"header_ok\": " << header_ok << ",\n"
+        << "    \"crc_ok\": " << crc_ok << ",\n"
+        << "    \"per\": " << (bursts ? 1.0 - static_cast<double>(good) / static_cast<double>(bursts) : 0.0) << ",\n"
+        << "    \"bit_errors\": " << bit_errors << ",\n"
+        << "    \"total_bits\": " << total_bits << ",\n"
+        << "    \"ber\": " << (total_bits ? static_cast<double>(bit_errors) / static_cast<double>(total_bits) : 0.0)
+        << ",\n"
+        << "    \"decode_ms_p50\": " << host_sim::percentile(decode_ms, 50.0) << ",\n"
+        << "    \"decode_ms_p99\": " << host_sim::percentile(decode_ms, 99.0) << ",\n"
+        << "    \"wall_s\": " << seconds << "\n"
+        << "  },\n"
+        << "  \"captures\": [\n";
+    for (std::size_t i = 0; i < captures.size(); ++i) {
+        const auto& c = captures[i];
+        out << "    {\n"
+            << "      \"capture\": " << json_string(c.job.capture.generic_string()) << ",\n"
+            << "      \"metadata_file\": " << json_string(c.job.metadata.generic_string()) << ",\n";
+        if (!c.error.empty()) {
+            out << "      \"error\": " << json_string(c.error) << ",\n";
+        }
+        out << "      \"bursts\": " << c.bursts.size() << ",\n"
+            << "      \"header_ok\": " << c.header_ok() << ",\n"
+            << "      \"crc_ok\": " << c.crc_ok() << ",\n"
+            << "      \"packets\": [";
+        for (std::size_t b = 0; b < c.bursts.size(); ++b) {
+            const auto& burst = c.bursts[b];
+            out << (b ? "," : "") << "\n        {\"start\": " << burst.interval.start
+                << ", \"length\": " << burst.interval.end - burst.interval.start
+                << ", \"snr_db\": " << burst.snr_db
+                << ", \"path\": \"" << host_sim::lora_replay::decode_path_name(burst.result.path) << "\""
+                << ", \"header_ok\": " << (burst.result.header_ok ? "true" : "false")
+                << ", \"crc_ok\": " << (burst.result.crc_ok ? "true" : "false")
+                << ", \"cr\": " << burst.result.cr
+                << ", \"cfo_hz\": " << burst.result.cfo_hz
+                << ", \"payload_hex\": \"" << bytes_to_hex(burst.result.payload) << "\"";
+            if (!burst.error.empty()) {
+                out << ", \"error\": " << json_string(burst.error);
+            }
+            out << "}";
+        }
+        out << (c.bursts.empty() ? "" : "\n      ") << "],\n";
+        std::ostringstream summary;
+        write_summary_json(summary, build_summary(c));
+        out << "      \"summary\": " << indent_json(summary.str(), "      ") << "\n"
+            << "    }" << (i + 1 < captures.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        const auto parsed = parse_args(argc, argv);
+        if (!parsed) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        const auto& opts = *parsed;
+        const auto t0 = std::chrono::steady_clock::now();
+
+        const auto jobs = collect_jobs(opts);
+        std::vector<CaptureResult> captures(jobs.size());
+        // Captures sharing a metadata file (e.g. one metadata.json per
+        // directory) parse it once.
+        std::map<fs::path, std::pair<std::optional<host_sim::LoRaMetadata>, std::string>> parsed_metadata;
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            captures[i].job = jobs[i];
+            if (jobs[i].metadata.empty()) {
+                continue;
+            }
+            auto [it, inserted] = parsed_metadata.try_emplace(jobs[i].metadata);
+            if (inserted) {
+                try {
+                    it->second.first = host_sim::load_metadata(jobs[i].metadata);
+                } catch (const std::exception& ex) {
+                    it->second.second = ex.what();
+                }
+            }
+            captures[i].metadata = it->second.first;
+            captures[i].error = it->second.second;
+        }
+        std::cout << "lora_batch: " << captures.size() << " capture(s), " << parsed_metadata.size()
+                  << " metadata file(s) on " << host_sim::WorkerPool::shared().worker_count() << " threads\n";
+
+        host_sim::WorkerPool::shared().parallel_for(captures.size(), [&](std::size_t i, std::size_t) {
+            if (captures[i].error.empty()) {
+                index_capture(captures[i]);
+            }
+        });
+        decode_bursts(captures, opts);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        bool over_threshold = false;
+        bool any_error = false;
+        std::size_t bursts = 0;
+        for (const auto& c : captures) {
+            bursts += c.bursts.size();
+            if (!c.error.empty()) {
+                any_error = true;
+                std::cerr << "lora_batch: " << c.job.capture.string() << ": " << c.error << "\n";
+                continue;
+            }
+            std::printf("  %-48s %3zu burst(s)  CRC OK %3zu  PER %.4f\n", c.job.capture.string().c_str(),
+                        c.bursts.size(), c.crc_ok(), c.per());
+            if (opts.verbose) {
+                for (std::size_t b = 0; b < c.bursts.size(); ++b) {
+                    const auto& burst = c.bursts[b];
+                    if (burst.result.crc_ok && !burst.result.payload_failure) {
+                        continue;
+                    }
+                    std::cerr << "[" << c.job.capture.string() << "] burst " << b << " at sample "
+                              << burst.interval.start << " lost" << (burst.error.empty() ? "" : ": ")
+                              << burst.error << "\n" << burst.report << "\n";
+                }
+            }
+            if (opts.max_per >= 0.0 && c.per() > opts.max_per) {
+                over_threshold = true;
+            }
+        }
+        write_report(opts.output, captures, seconds);
+        std::cout << "lora_batch: " << bursts << " burst(s) in " << std::fixed << std::setprecision(2) << seconds
+                  << " s, summary in " << opts.output.string() << "\n";
+        if (over_threshold) {
+            std::cerr << "lora_batch: PER above --max-per " << opts.max_per << "\n";
+        }
+        return over_threshold || any_error ? EXIT_FAILURE : EXIT_SUCCESS;
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
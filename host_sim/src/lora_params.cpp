@@ -80,6 +80,52 @@ bool parse_bool(const std::string& token, bool default_value)
     return default_value;
 }
 
+std::optional<double> parse_double(const std::string& token)
+{
+    try {
+        return std::stod(token);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+/// Numbers of a flat JSON array value, e.g. "channels": [868.1e6, 868.3e6].
+std::vector<double> find_number_array(const std::string& content, const std::string& key)
+{
+    std::vector<double> values;
+    const std::string pattern = "\"" + key + "\"";
+    const auto pos = content.find(pattern);
+    if (pos == std::string::npos) {
+        return values;
+    }
+    const auto open = content.find_first_not_of(" \t\r\n:", pos + pattern.size());
+    if (open == std::string::npos || content[open] != '[') {
+        return values;
+    }
+    const auto close = content.find(']', open);
+    if (close == std::string::npos) {
+        throw std::runtime_error("Unterminated array in metadata: " + key);
+    }
+    std::string body = content.substr(open + 1, close - open - 1);
+    std::size_t start = 0;
+    while (start <= body.size()) {
+        auto end = body.find(',', start);
+        if (end == std::string::npos) {
+            end = body.size();
+        }
+        const auto token = strip_spaces(body.substr(start, end - start));
+        if (!token.empty()) {
+            const auto value = parse_double(token);
+            if (!value) {
+                throw std::runtime_error("Invalid number in metadata array " + key + ": " + token);
+            }
+            values.push_back(*value);
+        }
+        start = end + 1;
+    }
+    return values;
+}
+
 std::optional<std::string> parse_string(const std::string& token)
 {
     if (token.size() >= 2 && token.front() == '"' && token.back() == '"') {
@@ -137,6 +183,13 @@ LoRaMetadata load_metadata(const std::filesystem::path& path)
     if (auto value = find_value(content, "payload_hex")) {
         meta.payload_hex = parse_string(*value);
     }
+    if (auto value = find_value(content, "capture_sample_rate")) {
+        meta.capture_sample_rate = parse_int(*value, meta.capture_sample_rate);
+    }
+    if (auto value = find_value(content, "center_freq")) {
+        meta.center_freq = parse_double(*value);
+    }
+    meta.channels = find_number_array(content, "channels");
 
     return meta;
 }
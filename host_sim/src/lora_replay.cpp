@@ -1,99 +1,60 @@
 #include "host_sim/alignment.hpp"
+#include "host_sim/bounded_queue.hpp"
+#include "host_sim/burst_detector.hpp"
 #include "host_sim/capture.hpp"
+#include "host_sim/channelizer.hpp"
+#include "host_sim/decode_phase.hpp"
 #include "host_sim/deinterleaver.hpp"
 #include "host_sim/fft_demod.hpp"
 #include "host_sim/fft_demod_ref.hpp"
 #include "host_sim/hamming.hpp"
+#include "host_sim/header_locator.hpp"
+#include "host_sim/iq_source.hpp"
 #include "host_sim/lora_params.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/lora_replay/burst_index_file.hpp"
 #include "host_sim/lora_replay/options.hpp"
+#include "host_sim/lora_replay/stage_dump.hpp"
 #include "host_sim/lora_replay/stage_processing.hpp"
+#include "host_sim/metrics.hpp"
+#include "host_sim/packet_sink.hpp"
+#include "host_sim/payload_decoder.hpp"
+#include "host_sim/receiver.hpp"
 #include "host_sim/soft_decode.hpp"
 #include "host_sim/scheduler.hpp"
 #include "host_sim/stages/demod_stage.hpp"
+#include "host_sim/trace.hpp"
 #include "host_sim/whitening.hpp"
+#include "host_sim/worker_pool.hpp"
 
 #include <algorithm>
+#include <array>
 #include <charconv>
 #include <chrono>
 #include <climits>
 #include <cmath>
 #include <cstdlib>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <cctype>
+#include <exception>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace
 {
 
-class FileSymbolSource : public host_sim::SymbolSource
-{
-public:
-    FileSymbolSource(std::vector<std::complex<float>> samples,
-                     std::size_t alignment_offset,
-                     std::size_t samples_per_symbol,
-                     std::size_t symbol_count)
-        : samples_(std::move(samples)),
-          offset_(alignment_offset),
-          samples_per_symbol_(samples_per_symbol),
-          symbol_count_(symbol_count)
-    {
-    }
-
-    void reset() override { index_ = 0; }
-
-    std::optional<host_sim::SymbolBuffer> next_symbol() override
-    {
-        if (index_ >= symbol_count_) {
-            return std::nullopt;
-        }
-        const auto start = offset_ + index_ * samples_per_symbol_;
-        if (start + samples_per_symbol_ > samples_.size()) {
-            return std::nullopt;
-        }
-        host_sim::SymbolBuffer buffer;
-        buffer.samples.insert(
-            buffer.samples.end(),
-            samples_.begin() + static_cast<std::ptrdiff_t>(start),
-            samples_.begin() + static_cast<std::ptrdiff_t>(start + samples_per_symbol_));
-        ++index_;
-        return buffer;
-    }
-
-private:
-    std::vector<std::complex<float>> samples_;
-    std::size_t offset_;
-    std::size_t samples_per_symbol_;
-    std::size_t symbol_count_;
-    std::size_t index_{0};
-};
-
-// Local CRC-16/CCITT: computes CRC over ALL input bytes (no XOR with trailing bytes).
-// Different from host_sim::lora_replay::compute_lora_crc which includes the
-// gr-lora_sdr last-2-byte XOR.  Used by probe_payload_crc which does the XOR manually.
-uint16_t compute_raw_crc16(const std::vector<uint8_t>& payload)
-{
-    uint16_t crc = 0x0000;
-    for (uint8_t byte : payload) {
-        crc ^= static_cast<uint16_t>(byte) << 8;
-        for (int bit = 0; bit < 8; ++bit) {
-            if (crc & 0x8000) {
-                crc = static_cast<uint16_t>((crc << 1) ^ 0x1021);
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    return crc;
-}
-
 std::size_t compute_samples_per_symbol(const host_sim::LoRaMetadata& meta)
 {
     const std::size_t chips = static_cast<std::size_t>(1) << meta.sf;
@@ -104,12 +65,17 @@ struct InstrumentationResult
 {
     std::vector<double> stage_timings_ns;
     std::vector<std::size_t> symbol_memory_bytes;
+    std::optional<host_sim::Scheduler::RealTimeStats> realtime;
 };
 
-InstrumentationResult run_scheduler_instrumentation(const std::vector<std::complex<float>>& samples,
+// Run the stage scheduler over the aligned symbols: a plain timed pass,
+// or with `realtime` a paced, pipelined run scored against symbol
+// deadlines.
+InstrumentationResult run_scheduler_instrumentation(std::span<const std::complex<float>> samples,
                                                     const host_sim::LoRaMetadata& meta,
                                                     std::size_t alignment_offset,
-                                                    std::size_t max_symbols)
+                                                    std::size_t max_symbols,
+                                                    bool realtime = false)
 {
     InstrumentationResult result;
     host_sim::Scheduler scheduler;
@@ -120,15 +86,12 @@ InstrumentationResult run_scheduler_instrumentation(const std::vector<std::compl
 
     scheduler.set_instrumentation({&result.stage_timings_ns, &result.symbol_memory_bytes});
 
-    const std::size_t samples_per_symbol = compute_samples_per_symbol(meta);
-    const std::size_t available_symbols =
-        (samples.size() > alignment_offset)
-            ? (samples.size() - alignment_offset) / samples_per_symbol
-            : 0;
-    const std::size_t symbol_count = std::min<std::size_t>(available_symbols, max_symbols);
-
-    FileSymbolSource source(samples, alignment_offset, samples_per_symbol, symbol_count);
-    scheduler.run(source);
+    host_sim::SpanSymbolSource source(samples, alignment_offset, compute_samples_per_symbol(meta), max_symbols);
+    if (realtime) {
+        result.realtime = scheduler.run_realtime(source, {});
+    } else {
+        scheduler.run(source);
+    }
 
     return result;
 }
@@ -143,11 +106,25 @@ using host_sim::lora_replay::normalize_fft_symbol;
 using host_sim::lora_replay::append_fft_gray;
 using host_sim::lora_replay::read_stage_file;
 using host_sim::lora_replay::write_stage_file;
+using host_sim::lora_replay::write_stage_dump;
 using host_sim::lora_replay::compare_stage;
 using host_sim::lora_replay::build_stage_summary_token;
 using host_sim::lora_replay::write_summary_json;
 using host_sim::lora_replay::compare_with_reference;
 using host_sim::lora_replay::compute_lora_crc;
+using host_sim::lora_replay::try_decode_header;
+using host_sim::lora_replay::probe_payload_crc;
+using host_sim::lora_replay::FallbackBudget;
+using host_sim::lora_replay::FallbackDecode;
+using host_sim::lora_replay::redemod_from_sfd;
+using host_sim::lora_replay::redemod_at_os2;
+using host_sim::lora_replay::demodulate_span;
+using host_sim::lora_replay::StreamDecodeResult;
+using host_sim::lora_replay::decode_stream_burst;
+using host_sim::lora_replay::BurstIndexEntry;
+using host_sim::lora_replay::BurstIndexFile;
+using host_sim::lora_replay::read_burst_index;
+using host_sim::lora_replay::write_burst_index;
 
 void write_stats_json(const std::filesystem::path& path,
                       const host_sim::CaptureStats& stats,
@@ -167,204 +144,294 @@ void write_stats_json(const std::filesystem::path& path,
         << "}\n";
 }
 
-HeaderDecodeResult try_decode_header(const std::vector<uint16_t>& symbols,
-                                     std::size_t start,
-                                     const host_sim::LoRaMetadata& meta)
+// One packet recovered on one channel of a wideband capture.
+struct ChannelPacket
+{
+    std::size_t start{0};       // channel-rate sample index of the burst
+    std::size_t length{0};
+    float snr_db{0.0f};
+    StreamDecodeResult result;
+    std::string report;
+};
+
+// Wideband batch decode: channelize the capture once into every channel
+// listed in the metadata, then run burst detection and the stream decoder
+// on each channel concurrently (one channel per pool task).  Channel
+// reports are printed in channel order.  Returns the process exit status.
+int decode_channelized(std::span<const std::complex<float>> samples,
+                       const host_sim::LoRaMetadata& meta, const Options& options)
 {
-    static const bool debug_header = (std::getenv("HOST_SIM_DEBUG_HEADER") != nullptr);
-    HeaderDecodeResult result;
-    if (start + 8 > symbols.size()) {
-        return result;
+    if (meta.capture_sample_rate <= 0) {
+        throw std::runtime_error("Metadata lists channels but no capture_sample_rate");
+    }
+    std::vector<double> offsets;
+    for (const double ch : meta.channels) {
+        offsets.push_back(meta.center_freq ? ch - *meta.center_freq : ch);
+    }
+    const host_sim::PolyphaseChannelizer channelizer(meta.capture_sample_rate, meta.sample_rate,
+                                                     meta.bw, offsets);
+    std::cout << "Metadata: SF=" << meta.sf << ", CR=" << meta.cr << ", BW=" << meta.bw
+              << ", Fs=" << meta.sample_rate << ", payload_len=" << meta.payload_len << "\n"
+              << "Channelizer: " << channelizer.channel_count() << " channel(s) from Fs="
+              << meta.capture_sample_rate << ", decimation " << channelizer.decimation() << ", "
+              << channelizer.branches() << " branches, " << channelizer.taps() << " taps\n";
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto streams = channelizer.channelize(samples);
+    if (options.verbose) {
+        std::cerr << "[channelizer] " << samples.size() << " samples in "
+                  << std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - t0).count()
+                  << " ms\n";
     }
 
-    host_sim::DeinterleaverConfig header_cfg{meta.sf, 4, true, meta.ldro};
-    const int block_symbols = 8;
-    std::size_t cursor = start;
-    std::size_t total_consumed = 0;
-    std::vector<uint8_t> header_nibbles;
-    std::vector<uint16_t> header_codewords;
-    while (header_nibbles.size() < 5 && cursor + block_symbols <= symbols.size()) {
-        std::vector<uint16_t> header_input(symbols.begin() + cursor,
-                                           symbols.begin() + cursor + block_symbols);
-        if (debug_header) {
-            std::cout << "Header symbols (start=" << cursor << "):";
-            for (auto value : header_input) {
-                std::cout << ' ' << value;
+    const std::size_t sps = compute_samples_per_symbol(meta);
+    std::vector<std::vector<ChannelPacket>> found(streams.size());
+    host_sim::WorkerPool::shared().parallel_for(streams.size(), [&](std::size_t c, std::size_t) {
+        const auto& stream = streams[c];
+        host_sim::FftDemodulator demod(meta.sf, meta.sample_rate, meta.bw);
+        host_sim::BurstDetector detector(sps, 6.0f, 2);
+        detector.update(stream.data(), stream.size());
+        std::size_t search = 0;
+        float tracked_noise = 0.0f;
+        while (const auto burst = detector.find_start(search, tracked_noise)) {
+            const auto extent = detector.find_end(burst->burst_start, burst->noise_floor);
+            if (extent.end <= search) {
+                break;
             }
-            std::cout << "\n";
-        }
-
-        std::size_t consumed_block = 0;
-        auto codewords = host_sim::deinterleave(header_input, header_cfg, consumed_block);
-        if (consumed_block == 0) {
-            break;
-        }
-        total_consumed += consumed_block;
-        cursor += consumed_block;
-        header_codewords.insert(header_codewords.end(), codewords.begin(), codewords.end());
-
-        if (debug_header) {
-            std::cout << "Deinterleaved codewords:";
-            for (auto cw : codewords) {
-                std::cout << ' ' << std::hex << static_cast<int>(cw) << std::dec;
+            search = extent.end;
+            tracked_noise = burst->noise_floor;
+            const std::size_t length = extent.end - burst->burst_start;
+            if (length < sps * 12) {
+                continue;
             }
-            std::cout << "\n";
+            ChannelPacket pkt;
+            pkt.start = burst->burst_start;
+            pkt.length = length;
+            const float power = extent.power_count > 0
+                ? static_cast<float>(extent.power_acc / static_cast<double>(extent.power_count))
+                : burst->signal_power;
+            const float snr = burst->noise_floor > 0.0f
+                ? (power - burst->noise_floor) / burst->noise_floor
+                : 0.0f;
+            pkt.snr_db = snr > 0.0f ? 10.0f * std::log10(snr) : -99.0f;
+            std::ostringstream report;
+            pkt.result = decode_stream_burst(
+                std::span<const std::complex<float>>(stream).subspan(pkt.start, length), demod, meta,
+                options, report);
+            pkt.report = report.str();
+            found[c].push_back(std::move(pkt));
         }
-
-        auto nibbles = host_sim::hamming_decode_block(codewords, true, 4);
-        if (debug_header) {
-            std::cout << "Header nibbles:";
-            for (auto nib : nibbles) {
-                std::cout << ' ' << std::hex << static_cast<int>(nib & 0xF) << std::dec;
+    });
+
+    bool payload_failure = false;
+    int packet_index = 0;
+    for (std::size_t c = 0; c < found.size(); ++c) {
+        std::cout << "\n=== Channel " << c << ": " << std::fixed << std::setprecision(0)
+                  << (meta.center_freq ? meta.channels[c] : channelizer.channel_offset(c))
+                  << " Hz (" << std::showpos << channelizer.channel_offset(c) << std::noshowpos
+                  << " Hz), " << found[c].size() << " packet(s) ===\n"
+                  << std::defaultfloat << std::setprecision(6);
+        for (const auto& pkt : found[c]) {
+            const double t_ms = static_cast<double>(pkt.start) / meta.sample_rate * 1000.0;
+            std::cout << "\n=== Packet #" << packet_index << " ===\n"
+                      << "Burst at sample " << pkt.start << " (" << std::fixed
+                      << std::setprecision(1) << t_ms << " ms), " << pkt.length
+                      << " samples, SNR=" << pkt.snr_db << " dB, channel " << c << "\n"
+                      << std::defaultfloat << std::setprecision(6) << pkt.report;
+            if (pkt.result.payload_failure) {
+                payload_failure = true;
             }
-            std::cout << "\n";
+            if (pkt.result.payload_mismatch) {
+                std::cout << "[payload] MISMATCH (packet #" << packet_index << ")\n";
+            }
+            if (!pkt.result.header_ok) {
+                std::cout << "[channelizer] packet #" << packet_index << ": header decode failed\n";
+            }
+            ++packet_index;
         }
-        header_nibbles.insert(header_nibbles.end(), nibbles.begin(), nibbles.end());
     }
+    std::cout << "\n[channelizer] " << packet_index << " packet(s) on " << found.size()
+              << " channel(s)\n";
+    return payload_failure ? EXIT_FAILURE : EXIT_SUCCESS;
+}
 
-    if (header_nibbles.size() < 5) {
-        result.codewords = std::move(header_codewords);
-        result.nibbles = header_nibbles;
-        result.consumed_symbols = total_consumed;
-        return result;
+// --trace: records spans and counters for the whole run and writes the
+// Chrome trace when main() returns, whichever mode it ran.
+class TraceSession
+{
+public:
+    explicit TraceSession(std::filesystem::path path) : path_(std::move(path))
+    {
+        if (!host_sim::trace::compiled_in()) {
+            throw std::runtime_error("--trace needs a build configured with -DHOST_SIM_TRACE=ON");
+        }
+        host_sim::trace::reset();
+        host_sim::trace::set_enabled(true);
     }
 
-    const int n0 = header_nibbles[0] & 0xF;
-    const int n1 = header_nibbles[1] & 0xF;
-    const int n2 = header_nibbles[2] & 0xF;
-    const int n3 = header_nibbles[3] & 0xF;
-    const int n4 = header_nibbles[4] & 0xF;
-
-    const int payload_len = (n0 << 4) | n1;
-    const bool has_crc = (n2 & 0x1) != 0;
-    const int cr = (n2 >> 1) & 0x7;
-    const int header_chk = ((n3 & 0x1) << 4) | n4;
-
-    const bool c4 = ((n0 & 0x8) >> 3) ^ ((n0 & 0x4) >> 2) ^ ((n0 & 0x2) >> 1) ^ (n0 & 0x1);
-    const bool c3 = ((n0 & 0x8) >> 3) ^ ((n1 & 0x8) >> 3) ^ ((n1 & 0x4) >> 2) ^ ((n1 & 0x2) >> 1) ^ (n2 & 0x1);
-    const bool c2 = ((n0 & 0x4) >> 2) ^ ((n1 & 0x8) >> 3) ^ (n1 & 0x1) ^ ((n2 & 0x8) >> 3) ^ ((n2 & 0x2) >> 1);
-    const bool c1 = ((n0 & 0x2) >> 1) ^ ((n1 & 0x4) >> 2) ^ (n1 & 0x1) ^ ((n2 & 0x4) >> 2) ^ ((n2 & 0x2) >> 1) ^ (n2 & 0x1);
-    const bool c0 = (n0 & 0x1) ^ ((n1 & 0x2) >> 1) ^ ((n2 & 0x8) >> 3) ^ ((n2 & 0x4) >> 2) ^ ((n2 & 0x2) >> 1) ^ (n2 & 0x1);
-    const int computed_checksum = (static_cast<int>(c4) << 4) | (static_cast<int>(c3) << 3) |
-                                  (static_cast<int>(c2) << 2) | (static_cast<int>(c1) << 1) |
-                                  static_cast<int>(c0);
-
-    result.checksum_field = header_chk;
-    result.checksum_computed = computed_checksum;
-
-    if (payload_len <= 0 || header_chk != computed_checksum) {
-        result.nibbles = header_nibbles;
-        result.payload_len = payload_len;
-        result.has_crc = has_crc;
-        result.cr = cr;
-        return result;
+    ~TraceSession()
+    {
+        host_sim::trace::set_enabled(false);
+        try {
+            const std::size_t spans = host_sim::trace::write_chrome_trace(path_);
+            std::cerr << "[trace] " << spans << " span(s)";
+            if (const auto dropped = host_sim::trace::dropped_events()) {
+                std::cerr << " (" << dropped << " overwritten)";
+            }
+            std::cerr << " written to " << path_.string() << "\n[trace]";
+            for (const auto& [name, value] : host_sim::trace::counter_list()) {
+                std::cerr << ' ' << name << '=' << value;
+            }
+            std::cerr << '\n';
+        } catch (const std::exception& ex) {
+            std::cerr << "[trace] " << ex.what() << '\n';
+        }
     }
 
-    result.success = true;
-    result.payload_len = payload_len;
-    result.has_crc = has_crc;
-    result.cr = cr;
-    result.checksum_field = header_chk;
-    result.checksum_computed = computed_checksum;
-    result.consumed_symbols = total_consumed;
-    result.codewords = std::move(header_codewords);
-    result.nibbles = std::move(header_nibbles);
-    return result;
-}
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
 
-// Upsample complex IQ data by 2x using linear interpolation.
-// Doubles the effective sample rate so the demodulator gets finer
-// timing resolution, extending SFO tolerance for long payloads.
-std::vector<std::complex<float>> upsample_2x(
-    const std::complex<float>* data, std::size_t count)
+private:
+    std::filesystem::path path_;
+};
+
+// Per-packet decode latency (ms) by the deepest effort tier reached.
+using EffortLatencies = std::array<std::vector<double>, host_sim::lora_replay::kDecodeEffortCount>;
+
+// One "<tag> <tier> effort: ..." percentile line per tier that saw packets.
+void print_effort_latencies(std::ostream& out, const char* tag, EffortLatencies& latencies)
 {
-    if (count < 2) {
-        return count == 1
-            ? std::vector<std::complex<float>>{data[0]}
-            : std::vector<std::complex<float>>{};
-    }
-    std::vector<std::complex<float>> out(count * 2 - 1);
-    for (std::size_t i = 0; i < count - 1; ++i) {
-        out[2 * i] = data[i];
-        out[2 * i + 1] = 0.5f * (data[i] + data[i + 1]);
+    for (std::size_t e = 0; e < latencies.size(); ++e) {
+        auto& tier = latencies[e];
+        if (tier.empty()) continue;
+        std::sort(tier.begin(), tier.end());
+        out << tag << ' ' << host_sim::lora_replay::decode_effort_name(static_cast<host_sim::lora_replay::DecodeEffort>(e))
+            << " effort: " << tier.size() << " packet(s), decode latency p50 "
+            << host_sim::percentile(tier, 50.0) << " ms, p99 " << host_sim::percentile(tier, 99.0) << " ms, max "
+            << tier.back() << " ms\n";
     }
-    out[2 * (count - 1)] = data[count - 1];
-    return out;
 }
 
-// Quick CRC probe: decode payload from symbols and check CRC.
-// Used for data-start timing refinement at low oversampling,
-// where SFO-induced timing drift can shift data symbols by ±1 bin.
-bool probe_payload_crc(const std::vector<uint16_t>& symbols,
-                       const HeaderDecodeResult& hdr,
-                       const host_sim::LoRaMetadata& meta)
+// End-to-end decode benchmark: push the whole capture through a fresh
+// stream Receiver `runs` times, decoding inline on this thread so every
+// phase is attributed, and report throughput, real-time factor, per-packet
+// latency and where the time went.  Returns the process exit status.
+int run_bench(const Options& options)
 {
-    if (!hdr.success) return false;
-    const int pl = hdr.payload_len > 0 ? hdr.payload_len : meta.payload_len;
-    const int cr = hdr.cr > 0 ? hdr.cr : meta.cr;
-    const bool has_crc = hdr.has_crc || meta.has_crc;
-    if (!has_crc || pl < 3) return false;
-
-    std::vector<uint8_t> payload_nibbles;
-    if (hdr.nibbles.size() > 5) {
-        for (std::size_t i = 5; i < hdr.nibbles.size(); ++i) {
-            payload_nibbles.push_back(hdr.nibbles[i]);
+    std::vector<std::complex<float>> stdin_samples;
+    std::optional<host_sim::MappedCapture> mapped_capture;
+    std::span<const std::complex<float>> samples;
+    if (options.read_stdin) {
+        if (options.iq_format == Options::IqFormat::hackrf) {
+            stdin_samples = host_sim::load_hackrf_stdin();
+        } else if (options.iq_format == Options::IqFormat::sc16) {
+            stdin_samples = host_sim::load_sc16_stdin();
+        } else {
+            stdin_samples = host_sim::load_cf32_stdin();
         }
+        samples = stdin_samples;
+    } else {
+        mapped_capture.emplace(options.iq_file);
+        samples = mapped_capture->samples();
     }
 
-    const std::size_t nibble_target =
-        static_cast<std::size_t>(pl) * 2 + 4;
-    const int cw_len = cr + 4;
-    std::size_t cursor = hdr.consumed_symbols > 0 ? hdr.consumed_symbols : 8;
-    host_sim::DeinterleaverConfig payload_cfg{meta.sf, cr, false, meta.ldro};
-
-    while (cursor + static_cast<std::size_t>(cw_len) <= symbols.size() &&
-           payload_nibbles.size() < nibble_target) {
-        std::vector<uint16_t> block(symbols.begin() + static_cast<std::ptrdiff_t>(cursor),
-                                    symbols.begin() + static_cast<std::ptrdiff_t>(cursor + cw_len));
-        std::size_t consumed = 0;
-        auto codewords = host_sim::deinterleave(block, payload_cfg, consumed);
-        if (consumed == 0) break;
-        cursor += consumed;
-        auto nibs = host_sim::hamming_decode_block(codewords, false, cr);
-        payload_nibbles.insert(payload_nibbles.end(), nibs.begin(), nibs.end());
+    std::optional<std::filesystem::path> meta_path = options.metadata;
+    if (!meta_path && !options.read_stdin) {
+        auto guess = options.iq_file;
+        guess.replace_extension(".json");
+        if (std::filesystem::exists(guess)) {
+            meta_path = guess;
+        }
+    }
+    if (!meta_path) {
+        throw std::runtime_error("--bench requires --metadata");
+    }
+    const auto meta = host_sim::load_metadata(*meta_path);
+    if (!meta.channels.empty()) {
+        throw std::runtime_error("--bench does not support channelized captures");
     }
 
-    if (payload_nibbles.size() < static_cast<std::size_t>(pl) * 2 + 4)
-        return false;
-
-    host_sim::WhiteningSequencer seq;
-    auto whitening = seq.sequence(payload_nibbles.size() / 2);
-
-    std::vector<uint8_t> unwhitened;
-    for (std::size_t i = 0; i + 1 < payload_nibbles.size() &&
-         unwhitened.size() < static_cast<std::size_t>(pl) + 2; i += 2) {
-        const std::size_t byte_idx = i / 2;
-        uint8_t lo, hi;
-        if (byte_idx < static_cast<std::size_t>(pl)) {
-            const uint8_t w = (byte_idx < whitening.size()) ? whitening[byte_idx] : 0;
-            lo = (payload_nibbles[i] & 0xF) ^ (w & 0x0F);
-            hi = (payload_nibbles[i + 1] & 0xF) ^ ((w >> 4) & 0x0F);
-        } else {
-            lo = payload_nibbles[i] & 0xF;
-            hi = payload_nibbles[i + 1] & 0xF;
+    host_sim::ReceiverConfig rx_config;
+    rx_config.metadata = meta;
+    rx_config.multi_sf = options.multi_sf;
+    rx_config.soft = options.soft;
+    rx_config.cfo_track_alpha = options.cfo_track_alpha;
+    rx_config.expected_payload = options.payload;
+    rx_config.decoder_threads = 0;
+    rx_config.chunk_samples = std::max<std::size_t>(4096, static_cast<std::size_t>(meta.sample_rate * 0.1));
+    rx_config.effort = options.effort;
+    rx_config.decode_budget_ms = options.decode_budget_ms;
+    rx_config.defer_recovery = options.defer_recovery;
+
+    const double capture_ms = static_cast<double>(samples.size()) / meta.sample_rate * 1000.0;
+    std::cout << "[bench] " << (options.read_stdin ? "<stdin>" : options.iq_file.string()) << ": "
+              << samples.size() << " samples (" << std::fixed << std::setprecision(1) << capture_ms
+              << " ms), SF=" << meta.sf << ", BW=" << meta.bw << ", Fs=" << meta.sample_rate << ", "
+              << options.bench_runs << " run(s)\n";
+
+    host_sim::PhaseTimes phases;
+    std::vector<double> latencies_ms;
+    EffortLatencies effort_latencies_ms;
+    double wall_ms = 0.0;
+    std::size_t packets = 0;
+    std::size_t crc_ok = 0;
+    for (int run = 0; run < options.bench_runs; ++run) {
+        host_sim::PhaseTimes run_phases;
+        std::size_t run_packets = 0;
+        std::size_t run_crc_ok = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        {
+            const host_sim::PhaseRecording recording(run_phases);
+            host_sim::Receiver receiver(rx_config);
+            const auto collect = [&] {
+                while (const auto pkt = receiver.pull()) {
+                    ++run_packets;
+                    run_crc_ok += pkt->result.crc_ok ? 1 : 0;
+                    latencies_ms.push_back(pkt->decode_ms);
+                    effort_latencies_ms[static_cast<std::size_t>(pkt->result.effort)].push_back(pkt->decode_ms);
+                }
+            };
+            for (std::size_t pos = 0; pos < samples.size(); pos += rx_config.chunk_samples) {
+                receiver.push(samples.subspan(pos, std::min(rx_config.chunk_samples, samples.size() - pos)));
+                collect();
+            }
+            receiver.finish();
+            collect();
         }
-        unwhitened.push_back(static_cast<uint8_t>((hi << 4) | lo));
+        const double run_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "[bench] run " << run << ": " << run_packets << " packet(s), " << run_crc_ok
+                  << " CRC OK, " << run_ms << " ms\n";
+        wall_ms += run_ms;
+        phases += run_phases;
+        packets += run_packets;
+        crc_ok += run_crc_ok;
     }
 
-    if (unwhitened.size() < static_cast<std::size_t>(pl) + 2)
-        return false;
-
-    std::vector<uint8_t> crc_data(unwhitened.begin(),
-                                  unwhitened.begin() + pl - 2);
-    uint16_t computed = compute_raw_crc16(crc_data);
-    if (pl >= 2) {
-        computed ^= unwhitened[pl - 1];
-        computed ^= static_cast<uint16_t>(unwhitened[pl - 2]) << 8;
+    const double runs = static_cast<double>(options.bench_runs);
+    const double mean_ms = wall_ms / runs;
+    std::cout << "[bench] mean run " << std::setprecision(2) << mean_ms << " ms, "
+              << static_cast<double>(packets) / (wall_ms / 1000.0) << " packets/s, real-time factor "
+              << capture_ms / mean_ms << "x, " << crc_ok << "/" << packets << " CRC OK\n";
+    if (!latencies_ms.empty()) {
+        std::sort(latencies_ms.begin(), latencies_ms.end());
+        std::cout << "[bench] per-packet decode latency: p50 " << host_sim::percentile(latencies_ms, 50.0)
+                  << " ms, p99 " << host_sim::percentile(latencies_ms, 99.0) << " ms, max " << latencies_ms.back()
+                  << " ms\n";
+        print_effort_latencies(std::cout, "[bench]", effort_latencies_ms);
     }
-    const uint16_t decoded = static_cast<uint16_t>(unwhitened[pl]) |
-                             (static_cast<uint16_t>(unwhitened[pl + 1]) << 8);
-    return computed == decoded;
+    const double total_ns = phases.total();
+    std::cout << "[bench] phase breakdown (mean ms per run):\n";
+    for (std::size_t p = 0; p < host_sim::kDecodePhaseCount; ++p) {
+        const auto phase = static_cast<host_sim::DecodePhase>(p);
+        std::cout << "  " << std::left << std::setw(10) << host_sim::phase_name(phase) << std::right
+                  << std::setw(10) << phases[phase] / 1e6 / runs << " ms  " << std::setw(5)
+                  << std::setprecision(1) << (total_ns > 0.0 ? 100.0 * phases[phase] / total_ns : 0.0)
+                  << "%\n" << std::setprecision(2);
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return EXIT_SUCCESS;
 }
 
 } // namespace
@@ -374,6 +441,13 @@ int main(int argc, char** argv)
     try {
         const Options options = parse_arguments(argc, argv);
         if (options.verbose) std::cerr << "[debug] entering lora_replay" << std::endl;
+        std::optional<TraceSession> trace_session;
+        if (options.trace_output) {
+            trace_session.emplace(*options.trace_output);
+        }
+        if (options.bench_runs > 0) {
+            return run_bench(options);
+        }
 
         // ── Streaming mode ──────────────────────────────────────
         // Reads stdin incrementally.  Uses the same burst detection
@@ -384,58 +458,130 @@ int main(int argc, char** argv)
             if (!options.metadata) {
                 throw std::runtime_error("--stream requires --metadata");
             }
-            const auto base_meta = host_sim::load_metadata(*options.metadata);
+            auto base_meta = host_sim::load_metadata(*options.metadata);
+            if (!base_meta.channels.empty()) {
+                throw std::runtime_error("--stream does not support channelized captures; "
+                                         "decode wideband metadata in batch mode");
+            }
+            // Optional front-end: the reader's I/O thread filters and
+            // decimates to --decimate-os on arrival, so everything below
+            // runs at the reduced rate.  Reported sample positions stay in
+            // capture-rate units.
+            const int capture_rate = base_meta.sample_rate;
+            std::optional<host_sim::Decimator> front_end;
+            std::size_t sample_scale = 1;
+            if (options.decimate_os > 0) {
+                const int os_in = base_meta.bw > 0 ? capture_rate / base_meta.bw : 0;
+                if (os_in * base_meta.bw != capture_rate || os_in % options.decimate_os != 0) {
+                    throw std::runtime_error("--decimate-os " + std::to_string(options.decimate_os) +
+                                             " does not divide the capture oversampling " +
+                                             std::to_string(os_in));
+                }
+                sample_scale = static_cast<std::size_t>(os_in / options.decimate_os);
+                if (sample_scale > 1) {
+                    front_end.emplace(sample_scale, 0.5 * base_meta.bw / capture_rate);
+                    base_meta.sample_rate = capture_rate / static_cast<int>(sample_scale);
+                }
+            }
             const auto iq_fmt = (options.iq_format == Options::IqFormat::hackrf)
                                     ? host_sim::IqFormat::hackrf_int8
+                                    : (options.iq_format == Options::IqFormat::sc16)
+                                    ? host_sim::IqFormat::sc16
                                     : host_sim::IqFormat::cf32;
 
             // Chunk: ~100 ms of samples per read call
             const std::size_t chunk_samples =
                 std::max<std::size_t>(4096, static_cast<std::size_t>(base_meta.sample_rate * 0.1));
-            host_sim::StreamingIqReader reader(iq_fmt, chunk_samples);
 
-            // Multi-SF demodulator bank (single entry when --multi-sf not set).
-            struct SfCtx {
-                std::unique_ptr<host_sim::FftDemodulator> demod;
-                int sps, os;
-            };
-            std::vector<SfCtx> sf_bank;
-            {
-                const int sf_lo = options.multi_sf ? 6 : base_meta.sf;
-                const int sf_hi = options.multi_sf ? 12 : base_meta.sf;
-                for (int sf_i = sf_lo; sf_i <= sf_hi; ++sf_i) {
-                    SfCtx ctx;
-                    ctx.demod = std::make_unique<host_sim::FftDemodulator>(
-                        sf_i, base_meta.sample_rate, base_meta.bw);
-                    ctx.sps = ctx.demod->samples_per_symbol();
-                    ctx.os = ctx.demod->oversample_factor();
-                    sf_bank.push_back(std::move(ctx));
+            // Detection and decoding run in the library receiver, one
+            // decoder thread (and demodulator bank) per pool worker, up to 4.
+            host_sim::ReceiverConfig rx_config;
+            rx_config.metadata = base_meta;
+            rx_config.multi_sf = options.multi_sf;
+            rx_config.soft = options.soft;
+            rx_config.cfo_track_alpha = options.cfo_track_alpha;
+            rx_config.expected_payload = options.payload;
+            rx_config.decoder_threads = std::clamp<std::size_t>(
+                host_sim::WorkerPool::shared().worker_count(), 1, 4);
+            // Incremental decoding steps (and reads) a symbol at a time.
+            rx_config.chunk_samples = options.incremental ? 0 : chunk_samples;
+            rx_config.incremental = options.incremental;
+            rx_config.cancel_collisions = options.cancel_collisions;
+            rx_config.drop_on_overflow = options.drop_on_overflow;
+            rx_config.verbose = options.verbose;
+            rx_config.effort = options.effort;
+            rx_config.decode_budget_ms = options.decode_budget_ms;
+            rx_config.defer_recovery = options.defer_recovery;
+            const auto packet_format = (options.packet_format == Options::PacketFormat::ndjson)
+                                           ? host_sim::PacketFormat::ndjson
+                                           : (options.packet_format == Options::PacketFormat::binary)
+                                           ? host_sim::PacketFormat::binary
+                                           : host_sim::PacketFormat::text;
+            rx_config.reports = packet_format == host_sim::PacketFormat::text;
+            host_sim::Receiver receiver(rx_config);
+            // Records on stdout push the human-readable lines to stderr.
+            std::ostream& log = (packet_format == host_sim::PacketFormat::text || options.packet_output)
+                                    ? std::cout
+                                    : std::cerr;
+            const std::size_t max_sps = receiver.max_samples_per_symbol();
+
+            // The ring holds several detection windows plus a long burst,
+            // as the receiver's own buffer does; it only fills when the
+            // receiver falls behind.
+            // --source picks UDP, VITA-49, ZeroMQ or a SoapySDR radio
+            // instead of the stdin pipe.
+            host_sim::IqSourceSpec source_spec = host_sim::parse_iq_source(options.source, iq_fmt);
+            if (source_spec.kind == host_sim::IqSourceKind::soapysdr) {
+                if (source_spec.sample_rate == 0.0) {
+                    source_spec.sample_rate = capture_rate;
+                } else if (source_spec.sample_rate != capture_rate) {
+                    throw std::runtime_error("--source rate= differs from the metadata sample_rate");
                 }
             }
-            // Accumulate enough data for the largest SF.
-            const int max_sps = sf_bank.back().sps;
-            const std::size_t min_accumulate =
-                static_cast<std::size_t>(max_sps) * 60;
+            host_sim::StreamingIqReader reader(
+                host_sim::open_iq_source(source_spec), receiver.chunk_samples(),
+                std::max(4 * max_sps * 60, 64 * chunk_samples),
+                options.drop_on_overflow ? host_sim::OverflowPolicy::drop
+                                         : host_sim::OverflowPolicy::block,
+                front_end);
 
             if (options.multi_sf) {
-                std::cout << "Multi-SF: SF6–SF12, BW=" << base_meta.bw
-                          << ", Fs=" << base_meta.sample_rate << "\n";
+                log << "Multi-SF: SF6–SF12, BW=" << base_meta.bw
+                    << ", Fs=" << capture_rate << "\n";
             } else {
-                std::cout << "Metadata: SF=" << base_meta.sf
-                          << ", CR=" << base_meta.cr
-                          << ", BW=" << base_meta.bw
-                          << ", Fs=" << base_meta.sample_rate
-                          << ", payload_len=" << base_meta.payload_len << "\n";
+                log << "Metadata: SF=" << base_meta.sf
+                    << ", CR=" << base_meta.cr
+                    << ", BW=" << base_meta.bw
+                    << ", Fs=" << capture_rate
+                    << ", payload_len=" << base_meta.payload_len << "\n";
             }
-            std::cout << "[stream] Listening... (max_sps=" << max_sps
-                      << ", symbol_period="
-                      << static_cast<double>(max_sps) / base_meta.sample_rate * 1000.0
-                      << " ms)\n";
-            std::cout.flush();
-
-            std::size_t search_offset = 0;
-            int packet_index = 0;
-            float tracked_noise_floor = 0.0f;  // Adaptive noise estimate
+            if (source_spec.kind != host_sim::IqSourceKind::file) {
+                log << "[stream] source: " << reader.source_name() << "\n";
+            }
+            if (front_end) {
+                log << "[stream] front-end: decimating by " << front_end->factor()
+                    << " to Fs=" << base_meta.sample_rate << " (OS="
+                    << options.decimate_os << ", " << front_end->taps() << " taps)\n";
+            }
+            log << "[stream] Listening... (max_sps=" << max_sps
+                << ", symbol_period="
+                << static_cast<double>(max_sps) / base_meta.sample_rate * 1000.0
+                << " ms)\n";
+            log.flush();
+
+            // Packet records: text (the report above), NDJSON or binary,
+            // on their own writer thread.
+            std::ofstream packet_file;
+            if (options.packet_output) {
+                packet_file.open(*options.packet_output, std::ios::binary | std::ios::trunc);
+                if (!packet_file) {
+                    throw std::runtime_error("Failed to open packet output: " + options.packet_output->string());
+                }
+            }
+            host_sim::PacketSinkConfig sink_config;
+            sink_config.format = packet_format;
+            sink_config.show_sf = options.multi_sf;
+            host_sim::PacketSink packet_sink(options.packet_output ? packet_file : std::cout, sink_config);
 
             // PER/BER statistics counters (active when --per-stats)
             int stat_bursts = 0;        // bursts detected
@@ -444,1042 +590,178 @@ int main(int argc, char** argv)
             int stat_bit_errors = 0;    // total bit errors (when --payload given)
             int stat_total_bits = 0;    // total bits compared
             bool stream_payload_failure = false; // any payload byte mismatch
+            int packet_index = 0;
+            EffortLatencies effort_latencies_ms;
 
-            while (true) {
-                // Read more data
-                if (!reader.eof()) {
-                    reader.read_chunk();
-                }
-
-                const std::size_t avail = reader.available();
-                // Wait until we have enough for burst detection + one packet
-                if (avail - search_offset < min_accumulate && !reader.eof()) {
-                    continue;
-                }
-
-                // Burst detection: use smallest SF (finest resolution).
-                auto& detect_ctx = sf_bank.front();
-                const auto burst_det = host_sim::detect_burst_ex(
-                    reader.data(), avail, detect_ctx.sps, 6.0f,
-                    search_offset, tracked_noise_floor, 2);
-
-                if (!burst_det) {
-                    if (reader.eof()) {
-                        if (packet_index == 0 &&
-                            avail - search_offset >=
-                            static_cast<std::size_t>(detect_ctx.sps) * 12) {
-                            // Fall through with synthetic burst detection
-                        } else {
-                            break;
-                        }
-                    } else {
-                        if (avail > min_accumulate) {
-                            const std::size_t trim =
-                                avail - min_accumulate / 2;
-                            reader.consume(trim);
-                            search_offset = (search_offset > trim)
-                                                ? search_offset - trim : 0;
-                        }
-                        continue;
-                    }
-                }
-
-                // Burst boundaries (using smallest SF's window size)
-                const std::size_t burst_start_raw = burst_det
-                    ? burst_det->burst_start : search_offset;
-                const float noise_floor = burst_det
-                    ? burst_det->noise_floor : 0.0f;
-                const std::size_t det_win =
-                    static_cast<std::size_t>(detect_ctx.sps);
-                const std::size_t bp_win = burst_start_raw / det_win;
-                const std::size_t n_total_win = avail / det_win;
-                const float thr = noise_floor * 6.0f;
-
-                constexpr std::size_t tail_windows = 5;
-                std::size_t quiet_run = 0;
-                std::size_t burst_end_win = n_total_win;
-                double burst_power_acc = 0.0;
-                std::size_t burst_power_count = 0;
-                for (std::size_t w = bp_win; w < n_total_win; ++w) {
-                    double acc = 0.0;
-                    const auto* p = reader.data() + w * det_win;
-                    for (std::size_t i = 0; i < det_win; ++i) {
-                        acc += static_cast<double>(p[i].real()) * p[i].real() +
-                               static_cast<double>(p[i].imag()) * p[i].imag();
-                    }
-                    const float wp = static_cast<float>(
-                        acc / static_cast<double>(det_win));
-                    if (wp > thr) {
-                        burst_power_acc += wp;
-                        ++burst_power_count;
-                    }
-                    if (wp <= thr) {
-                        ++quiet_run;
-                        if (quiet_run >= tail_windows) {
-                            burst_end_win = w - tail_windows + 1;
-                            break;
-                        }
-                    } else {
-                        quiet_run = 0;
-                    }
-                }
-
-                if (burst_end_win == n_total_win && !reader.eof()) {
-                    continue;
-                }
-
-                constexpr std::size_t burst_tail_margin = 4;
-                const std::size_t burst_end = std::min(
-                    (burst_end_win + burst_tail_margin) * det_win, avail);
-                const std::size_t burst_len =
-                    burst_end > burst_start_raw
-                        ? burst_end - burst_start_raw : 0;
-                if (burst_len < det_win * 12) {
-                    if (options.verbose) {
-                        std::cerr << "[stream] short burst (" << burst_len
-                                  << " samples), skipping\n";
-                    }
-                    search_offset = burst_end;
-                    continue;
-                }
-                const std::size_t burst_start = burst_start_raw;
-
-                const float mean_burst_power = (burst_power_count > 0)
-                    ? static_cast<float>(burst_power_acc /
-                      static_cast<double>(burst_power_count))
-                    : (burst_det ? burst_det->signal_power : 0.0f);
-                const float snr_linear = (noise_floor > 0.0f)
-                    ? (mean_burst_power - noise_floor) / noise_floor
-                    : 0.0f;
-                const float snr_db = (snr_linear > 0.0f)
-                    ? 10.0f * std::log10(snr_linear)
-                    : -99.0f;
-
-                const std::span<const std::complex<float>> burst_samples(
-                    reader.data() + burst_start, burst_len);
-
-                // ── Multi-SF: select correct SF by demodulating preamble
-                //    at fixed offset (burst start).  The correct SF gives
-                //    consistent bins; wrong SFs scatter. ──
-                SfCtx* best_ctx = &detect_ctx;
-                if (sf_bank.size() > 1) {
-                    int best_consistency = -1;
-                    for (auto& ctx : sf_bank) {
-                        if (burst_len <
-                            static_cast<std::size_t>(ctx.sps) * 8)
-                            continue;
-                        ctx.demod->set_frequency_offsets(0.0f, 0, 0.0f);
-                        ctx.demod->reset_symbol_counter();
-                        const int n = std::min(
-                            8, static_cast<int>(burst_len / ctx.sps));
-                        // Count most-common bin among first n symbols
-                        int bin_counts[4096]{};
-                        int n_bins = 1 << ctx.demod->sf();
-                        for (int s = 0; s < n; ++s) {
-                            int b = ctx.demod->demodulate(
-                                burst_samples.data() +
-                                s * static_cast<std::size_t>(ctx.sps));
-                            if (b >= 0 && b < n_bins) ++bin_counts[b];
-                        }
-                        int mode_count = 0;
-                        for (int i = 0; i < n_bins; ++i) {
-                            if (bin_counts[i] > mode_count)
-                                mode_count = bin_counts[i];
-                        }
-                        if (options.verbose) {
-                            std::cerr << "[multi-sf-probe] SF="
-                                      << ctx.demod->sf()
-                                      << " consistency=" << mode_count
-                                      << "/" << n << "\n";
-                        }
-                        if (mode_count > best_consistency) {
-                            best_consistency = mode_count;
-                            best_ctx = &ctx;
-                        }
-                    }
-                    if (options.verbose) {
-                        std::cerr << "[multi-sf] selected SF="
-                                  << best_ctx->demod->sf() << "\n";
-                    }
-                }
-
-                auto& demod = *best_ctx->demod;
-                const int sps = best_ctx->sps;
-                const int os = best_ctx->os;
-                auto metadata = base_meta;
-                metadata.sf = demod.sf();
-
+            // Fold one packet into the statistics and hand it to the
+            // sink, whose thread formats and writes it.
+            const auto report_packet = [&](host_sim::ReceivedPacket pkt) {
                 ++stat_bursts;
-                std::cout << "\n=== Packet #" << packet_index << " ===\n";
-                {
-                    const double t_ms = static_cast<double>(burst_start) / metadata.sample_rate * 1000.0;
-                    const double len_ms = static_cast<double>(burst_len) / metadata.sample_rate * 1000.0;
-                    std::cout << "Burst at sample " << burst_start
-                              << " (" << std::fixed << std::setprecision(1) << t_ms
-                              << " ms), " << burst_len << " samples ("
-                              << len_ms << " ms), SNR=" << snr_db << " dB\n"
-                              << std::defaultfloat << std::setprecision(6);
-                }
-                std::cout.flush();
-
-                const auto decode_t0 = std::chrono::steady_clock::now();
-
-                // ── Decode this burst (reuse existing pipeline) ──
-
-                // Alignment
-                std::size_t alignment_offset = 0;
-                int detected_preamble_bin = 0;
-                {
-                    auto pr = host_sim::find_symbol_alignment_cfo_aware(
-                        burst_samples, demod, metadata.preamble_len);
-                    alignment_offset = pr.alignment_offset;
-                    detected_preamble_bin = pr.preamble_bin;
-                }
-
-                // CFO estimation
-                float estimated_sfo = 0.0f;
-                {
-                    const int avail_pream_sym = static_cast<int>(std::min<std::size_t>(
-                        (burst_samples.size() > alignment_offset
-                             ? (burst_samples.size() - alignment_offset) / static_cast<std::size_t>(sps)
-                             : 0),
-                        static_cast<std::size_t>(INT_MAX)));
-                    const int pream_to_use = std::min(std::max(metadata.preamble_len - 1, 0), avail_pream_sym);
-                    if (pream_to_use > 0) {
-                        auto freq_est = demod.estimate_frequency_offsets(
-                            burst_samples.data() + alignment_offset, pream_to_use);
-                        if (detected_preamble_bin != 0) {
-                            const int n_bins = 1 << metadata.sf;
-                            int signed_bin = detected_preamble_bin;
-                            if (signed_bin > n_bins / 2) signed_bin -= n_bins;
-                            if (std::abs(signed_bin) > std::abs(freq_est.cfo_int) + 2) {
-                                freq_est.cfo_int = signed_bin;
-                            }
-                        }
-                        demod.set_frequency_offsets(freq_est.cfo_frac, freq_est.cfo_int, freq_est.sfo_slope);
-                        estimated_sfo = freq_est.sfo_slope;
-
-                        // Report CFO in Hz
-                        {
-                            const int n_bins = 1 << metadata.sf;
-                            const double cfo_bins = static_cast<double>(freq_est.cfo_int) + freq_est.cfo_frac;
-                            const double cfo_hz = cfo_bins * static_cast<double>(metadata.bw) / n_bins;
-                            std::cout << "CFO=" << std::fixed << std::setprecision(1) << cfo_hz
-                                      << " Hz (" << std::setprecision(2) << cfo_bins << " bins)";
-                            if (std::abs(freq_est.sfo_slope) > 0.001f) {
-                                std::cout << ", SFO=" << std::setprecision(3) << freq_est.sfo_slope << " bins/sym";
-                            }
-                            std::cout << "\n" << std::defaultfloat << std::setprecision(6);
-                        }
-
-                        // Sub-sample alignment refinement (±3 samples).
-                        // At low OS, even 1–2 sample error shifts the
-                        // dechirped FFT peak and flips marginal symbols.
-                        if (os <= 4) {
-                            int best_off = 0;
-                            int best_c0 = -1;
-                            for (int try_off = -3; try_off <= 3; ++try_off) {
-                                const auto try_a = static_cast<std::size_t>(
-                                    static_cast<std::ptrdiff_t>(alignment_offset) + try_off);
-                                if (try_a + 8ULL * sps > burst_samples.size()) continue;
-                                demod.set_frequency_offsets(freq_est.cfo_frac,
-                                                            freq_est.cfo_int,
-                                                            freq_est.sfo_slope);
-                                demod.reset_symbol_counter();
-                                int c0 = 0;
-                                for (int p = 0; p < std::min(pream_to_use, 8); ++p) {
-                                    uint16_t v = demod.demodulate(
-                                        &burst_samples[try_a +
-                                                       static_cast<std::size_t>(p) * sps]);
-                                    if (v == 0) ++c0;
-                                }
-                                if (c0 > best_c0) { best_c0 = c0; best_off = try_off; }
-                            }
-                            if (best_off != 0) {
-                                alignment_offset = static_cast<std::size_t>(
-                                    static_cast<std::ptrdiff_t>(alignment_offset) + best_off);
-                            }
-                        }
-                    }
-                }
-
-                // Demodulate symbols — no SFO phase correction on preamble grid
-                demod.set_frequency_offsets(demod.current_cfo_frac(), demod.current_cfo_int(), 0.0f);
-                demod.reset_symbol_counter();
-                // Per-symbol CFO tracking (EMA).
-                // --cfo-track [alpha] CLI flag or HOST_SIM_CFO_TRACK_ALPHA env.
-                {
-                    float alpha = options.cfo_track_alpha;
-                    if (alpha == 0.0f) {
-                        static const char* alpha_env = std::getenv("HOST_SIM_CFO_TRACK_ALPHA");
-                        if (alpha_env) alpha = std::stof(alpha_env);
-                    }
-                    if (alpha > 0.0f) {
-                        demod.set_cfo_tracking(alpha, 8);
-                    }
-                }
-                const std::size_t max_sym =
-                    (burst_samples.size() - alignment_offset) /
-                    static_cast<std::size_t>(sps);
-                std::vector<uint16_t> symbols;
-                std::vector<host_sim::SymbolLLR> symbol_llrs;
-                symbols.reserve(max_sym);
-                if (options.soft) symbol_llrs.reserve(max_sym);
-                for (std::size_t i = 0; i < max_sym; ++i) {
-                    symbols.push_back(demod.demodulate(
-                        &burst_samples[alignment_offset +
-                                       i * static_cast<std::size_t>(sps)]));
-                    if (options.soft) {
-                        const auto& mags = demod.get_fft_magnitudes_sq();
-                        symbol_llrs.push_back(host_sim::compute_symbol_llrs(
-                            mags.data(), metadata.sf,
-                            (static_cast<int>(i) < 8) || metadata.ldro,
-                            demod.current_cfo_int()));
-                    }
-                }
-
-                // Try header decode (skip grid scan at high OS)
-                HeaderDecodeResult header;
-                const bool skip_grid = (os > 4) || (os == 4);
-
-                if (!skip_grid && !header.success) {
-                    for (std::size_t c = 0; c + 8 <= symbols.size(); ++c) {
-                        auto h = try_decode_header(symbols, c, metadata);
-                        if (!h.success) continue;
-                        int hlen = h.payload_len > 0 ? h.payload_len : metadata.payload_len;
-                        int hcr = h.cr > 0 ? h.cr : metadata.cr;
-                        if (metadata.payload_len > 0 && hlen != metadata.payload_len) continue;
-                        if (metadata.cr > 0 && hcr != metadata.cr) continue;
-                        if (metadata.has_crc && !h.has_crc) continue;
-                        header = std::move(h);
-                        break;
-                    }
-                }
-
-                // SFD re-demod fallback
-                if (!header.success) {
-                    auto sync_pos = host_sim::find_header_symbol_index(
-                        symbols, 0x12, metadata.sf);
-                    if (!sync_pos)
-                        sync_pos = host_sim::find_header_symbol_index(
-                            symbols, 0x34, metadata.sf);
-                    // Implicit-header fallback: if sync word not found,
-                    // estimate data start from known preamble length.
-                    // Data starts at: preamble + 2 sync + 2.25 SFD ≈ preamble + 4
-                    // (same formula find_header_symbol_index returns: sync_high_pos + 4)
-                    if (!sync_pos && metadata.implicit_header) {
-                        sync_pos = static_cast<std::size_t>(
-                            metadata.preamble_len + 4);
-                    }
-
-                    const float saved_cfo_frac = demod.current_cfo_frac();
-                    const int saved_cfo_int = demod.current_cfo_int();
-                    const int N_bins = 1 << metadata.sf;
-                    const double redemod_stride =
-                        (estimated_sfo != 0.0f)
-                            ? static_cast<double>(sps) *
-                                  (1.0 - static_cast<double>(estimated_sfo) / N_bins)
-                            : static_cast<double>(sps);
-
-                    if (sync_pos) {
-                        const std::size_t quarter =
-                            static_cast<std::size_t>(sps / 4);
-                        for (int qoff : {1, 0, 2, 3}) {
-                            if (header.success) break;
-                            const std::size_t data_sample =
-                                alignment_offset +
-                                *sync_pos * static_cast<std::size_t>(sps) +
-                                static_cast<std::size_t>(qoff) * quarter;
-                            if (data_sample + 8ULL * sps > burst_samples.size())
-                                continue;
-
-                            demod.set_frequency_offsets(
-                                saved_cfo_frac, saved_cfo_int, 0.0f);
-                            demod.reset_symbol_counter();
-                            std::vector<uint16_t> redemod;
-                            std::vector<host_sim::SymbolLLR> redemod_llrs;
-                            const std::size_t rmax =
-                                (burst_samples.size() - data_sample) / sps;
-                            // Per-symbol SFO tracking: refine stride using
-                            // residual drift from parabolic interpolation.
-                            double sfo_accum = 0.0;
-                            double sfo_stride = redemod_stride;
-                            float sfo_prev_res = 0.0f;
-                            float sfo_drift = 0.0f;
-                            constexpr float sfo_alpha = 0.01f;
-                            constexpr int sfo_delay = 8;
-                            for (std::size_t i = 0;
-                                 i < std::min<std::size_t>(rmax, 1024); ++i) {
-                                const std::size_t off =
-                                    static_cast<std::size_t>(
-                                        std::round(sfo_accum));
-                                if (data_sample + off +
-                                        static_cast<std::size_t>(sps) >
-                                    burst_samples.size())
-                                    break;
-                                redemod.push_back(demod.demodulate(
-                                    &burst_samples[data_sample + off]));
-                                if (options.soft) {
-                                    const auto& mags = demod.get_fft_magnitudes_sq();
-                                    redemod_llrs.push_back(host_sim::compute_symbol_llrs(
-                                        mags.data(), metadata.sf,
-                                        (static_cast<int>(i) < 8) || metadata.ldro,
-                                        demod.current_cfo_int()));
-                                }
-                                // Adaptive stride: track residual slope.
-                                if (static_cast<int>(i) >= sfo_delay) {
-                                    float dr = demod.last_residual() - sfo_prev_res;
-                                    if (dr > 0.5f) dr -= 1.0f;
-                                    if (dr < -0.5f) dr += 1.0f;
-                                    sfo_drift += sfo_alpha * (dr - sfo_drift);
-                                    sfo_stride = redemod_stride -
-                                        static_cast<double>(sps) *
-                                        static_cast<double>(sfo_drift) / N_bins;
-                                }
-                                sfo_prev_res = demod.last_residual();
-                                sfo_accum += sfo_stride;
-                            }
-
-                            if (metadata.implicit_header) {
-                                // Build implicit header matching batch path:
-                                // deinterleave first block at CR=4 (header rate),
-                                // prepend 5 zero nibbles (placeholder for absent
-                                // explicit header fields).
-                                HeaderDecodeResult imp;
-                                const std::size_t hdr_syms_cnt = std::min<std::size_t>(8, redemod.size());
-                                std::vector<uint16_t> first_block(
-                                    redemod.begin(),
-                                    redemod.begin() + static_cast<std::ptrdiff_t>(hdr_syms_cnt));
-                                host_sim::DeinterleaverConfig hdr_cfg{
-                                    metadata.sf, 4, true, metadata.ldro};
-                                std::size_t consumed_block = 0;
-                                auto codewords = host_sim::deinterleave(
-                                    first_block, hdr_cfg, consumed_block);
-                                auto nibs = host_sim::hamming_decode_block(
-                                    codewords, true, 4);
-                                imp.success = true;
-                                imp.payload_len = metadata.payload_len;
-                                imp.cr = metadata.cr;
-                                imp.has_crc = metadata.has_crc;
-                                imp.checksum_field = -1;
-                                imp.checksum_computed = -1;
-                                imp.consumed_symbols = consumed_block > 0
-                                    ? static_cast<int>(consumed_block) : 8;
-                                imp.codewords.assign(codewords.begin(), codewords.end());
-                                imp.nibbles.assign(5, 0);
-                                imp.nibbles.insert(imp.nibbles.end(),
-                                                   nibs.begin(), nibs.end());
-
-                                // CRC-guided timing sweep for implicit header
-                                if (metadata.has_crc &&
-                                    !probe_payload_crc(redemod, imp, metadata)) {
-                                    const int max_adj = std::max(os, 4) + 2;
-                                    bool found_adj = false;
-                                    for (int adj = -1; std::abs(adj) <= max_adj;
-                                         adj = adj > 0 ? -adj - 1 : -adj) {
-                                        const auto adj_data =
-                                            static_cast<std::size_t>(
-                                                static_cast<std::ptrdiff_t>(
-                                                    data_sample) + adj);
-                                        if (adj_data + 8ULL * sps >
-                                            burst_samples.size())
-                                            continue;
-                                        demod.set_frequency_offsets(
-                                            saved_cfo_frac, saved_cfo_int, 0.0f);
-                                        demod.reset_symbol_counter();
-                                        std::vector<uint16_t> adj_syms;
-                                        const std::size_t adj_max =
-                                            (burst_samples.size() - adj_data) / sps;
-                                        for (std::size_t i = 0;
-                                             i < std::min<std::size_t>(adj_max, 200);
-                                             ++i) {
-                                            const std::size_t so =
-                                                static_cast<std::size_t>(
-                                                    std::round(i * redemod_stride));
-                                            if (adj_data + so +
-                                                    static_cast<std::size_t>(sps) >
-                                                burst_samples.size())
-                                                break;
-                                            adj_syms.push_back(demod.demodulate(
-                                                &burst_samples[adj_data + so]));
-                                        }
-                                        // Rebuild implicit header for adjusted symbols
-                                        std::size_t adj_consumed = 0;
-                                        std::vector<uint16_t> adj_first(
-                                            adj_syms.begin(),
-                                            adj_syms.begin() + std::min<std::ptrdiff_t>(
-                                                8, static_cast<std::ptrdiff_t>(adj_syms.size())));
-                                        auto adj_cw = host_sim::deinterleave(
-                                            adj_first, hdr_cfg, adj_consumed);
-                                        auto adj_nibs = host_sim::hamming_decode_block(
-                                            adj_cw, true, 4);
-                                        HeaderDecodeResult adj_imp;
-                                        adj_imp.success = true;
-                                        adj_imp.payload_len = metadata.payload_len;
-                                        adj_imp.cr = metadata.cr;
-                                        adj_imp.has_crc = metadata.has_crc;
-                                        adj_imp.consumed_symbols = adj_consumed > 0
-                                            ? static_cast<int>(adj_consumed) : 8;
-                                        adj_imp.nibbles.assign(5, 0);
-                                        adj_imp.nibbles.insert(adj_imp.nibbles.end(),
-                                                               adj_nibs.begin(),
-                                                               adj_nibs.end());
-                                        if (probe_payload_crc(
-                                                adj_syms, adj_imp, metadata)) {
-                                            redemod = std::move(adj_syms);
-                                            redemod_llrs.clear();
-                                            imp = std::move(adj_imp);
-                                            std::cout << "SFD re-demod: implicit data start "
-                                                         "refined by "
-                                                      << adj
-                                                      << " samples (CRC verified)\n";
-                                            found_adj = true;
-                                            break;
-                                        }
-                                    }
-                                    if (!found_adj) continue;  // Try next qoff
-                                }
-                                header = std::move(imp);
-                                symbols = std::move(redemod);
-                                symbol_llrs = std::move(redemod_llrs);
-                                break;
-                            }
-
-                            auto hdr = try_decode_header(redemod, 0, metadata);
-                            if (!hdr.success) continue;
-                            int hlen = hdr.payload_len > 0
-                                           ? hdr.payload_len
-                                           : metadata.payload_len;
-                            int hcr =
-                                hdr.cr > 0 ? hdr.cr : metadata.cr;
-                            if (metadata.payload_len > 0 &&
-                                hlen != metadata.payload_len)
-                                continue;
-                            if (metadata.cr > 0 && hcr != metadata.cr)
-                                continue;
-                            if (metadata.has_crc && !hdr.has_crc)
-                                continue;
-
-                            // CRC-guided timing sweep
-                            if ((hdr.has_crc || metadata.has_crc) &&
-                                !probe_payload_crc(redemod, hdr, metadata)) {
-                                const int max_adj = std::max(os, 4) + 2;
-                                for (int adj = -1; std::abs(adj) <= max_adj;
-                                     adj = adj > 0 ? -adj - 1 : -adj) {
-                                    const auto adj_data =
-                                        static_cast<std::size_t>(
-                                            static_cast<std::ptrdiff_t>(
-                                                data_sample) +
-                                            adj);
-                                    if (adj_data + 8ULL * sps >
-                                        burst_samples.size())
-                                        continue;
-                                    demod.set_frequency_offsets(
-                                        saved_cfo_frac, saved_cfo_int, 0.0f);
-                                    demod.reset_symbol_counter();
-                                    std::vector<uint16_t> adj_syms;
-                                    const std::size_t adj_max =
-                                        (burst_samples.size() - adj_data) / sps;
-                                    for (std::size_t i = 0;
-                                         i < std::min<std::size_t>(adj_max, 200);
-                                         ++i) {
-                                        const std::size_t so =
-                                            static_cast<std::size_t>(
-                                                std::round(i * redemod_stride));
-                                        if (adj_data + so +
-                                                static_cast<std::size_t>(sps) >
-                                            burst_samples.size())
-                                            break;
-                                        adj_syms.push_back(demod.demodulate(
-                                            &burst_samples[adj_data + so]));
-                                    }
-                                    auto adj_hdr = try_decode_header(
-                                        adj_syms, 0, metadata);
-                                    if (!adj_hdr.success) continue;
-                                    if (probe_payload_crc(
-                                            adj_syms, adj_hdr, metadata)) {
-                                        redemod = std::move(adj_syms);
-                                        redemod_llrs.clear();
-                                        hdr = std::move(adj_hdr);
-                                        break;
-                                    }
-                                }
-                            }
-
-                            std::cout << "SFD re-demod: header found with "
-                                         "quarter offset "
-                                      << qoff << " (sync at symbol "
-                                      << (*sync_pos - 4) << ")\n";
-                            header = std::move(hdr);
-                            symbols = std::move(redemod);
-                            symbol_llrs = std::move(redemod_llrs);
-                            break;
-                        }
-                    }
-
-                    // ── OS=2 upsample fallback (streaming) ──────────
-                    // When native-OS decode at OS=1 fails or produces
-                    // CRC-invalid payload, upsample burst by 2x and
-                    // retry with SFO rate compensation sweep.
-                    bool need_os2 = !header.success;
-                    if (!need_os2 && os == 1 && sync_pos &&
-                        (header.has_crc || metadata.has_crc) &&
-                        !probe_payload_crc(symbols, header, metadata)) {
-                        need_os2 = true;
-                    }
-                    if (need_os2 && sync_pos && os == 1) {
-                        auto fallback_header = header;
-                        auto fallback_symbols = symbols;
-                        auto fallback_llrs = symbol_llrs;
-                        header.success = false;
-
-                        const std::size_t burst_start = alignment_offset;
-                        const std::size_t burst_len = burst_samples.size() - burst_start;
-                        auto up = upsample_2x(&burst_samples[burst_start], burst_len);
-
-                        const int sps_os2 = sps * 2;
-                        const std::size_t quarter_os2 =
-                            static_cast<std::size_t>(sps_os2 / 4);
-                        host_sim::FftDemodulator demod_os2(metadata.sf,
-                                                metadata.bw * 2,
-                                                metadata.bw);
-
-                        std::vector<std::pair<int,int>> hdr_hit_pairs;
-                        for (int os2_pass = 0;
-                             os2_pass < 2 && !header.success; ++os2_pass) {
-                        for (int sfo_cand = 0; std::abs(sfo_cand) <= 100;
-                             sfo_cand = sfo_cand >= 0 ? -sfo_cand - 10
-                                                      : -sfo_cand) {
-                            if (header.success) break;
-                            const double stride =
-                                static_cast<double>(sps_os2) *
-                                (1.0 - static_cast<double>(sfo_cand) * 1e-6);
-
-                        for (int qoff : {1, 0, 2, 3}) {
-                            if (header.success) break;
-                            if (os2_pass == 0 && qoff != 1) continue;
-                            if (os2_pass == 1) {
-                                bool was_hit = false;
-                                for (auto& p : hdr_hit_pairs)
-                                    if (p.first == sfo_cand && p.second == qoff)
-                                        was_hit = true;
-                                if (!was_hit) continue;
-                            }
-                            const std::size_t data_sample_os2 =
-                                *sync_pos * static_cast<std::size_t>(sps_os2) +
-                                static_cast<std::size_t>(qoff) * quarter_os2;
-                            if (data_sample_os2 + 8ULL * sps_os2 > up.size())
-                                continue;
-
-                            demod_os2.set_frequency_offsets(saved_cfo_frac,
-                                                           saved_cfo_int,
-                                                           0.0f);
-                            demod_os2.reset_symbol_counter();
-                            std::vector<uint16_t> os2_syms;
-                            std::vector<host_sim::SymbolLLR> os2_llrs;
-
-                            // Demod first 8 symbols (header probe)
-                            for (std::size_t i = 0; i < 8; ++i) {
-                                const auto pos = static_cast<std::size_t>(
-                                    std::round(static_cast<double>(
-                                                   data_sample_os2) +
-                                               static_cast<double>(i) * stride));
-                                if (pos + sps_os2 > up.size()) break;
-                                os2_syms.push_back(demod_os2.demodulate(&up[pos]));
-                                if (options.soft) {
-                                    const auto& mags = demod_os2.get_fft_magnitudes_sq();
-                                    os2_llrs.push_back(host_sim::compute_symbol_llrs(
-                                        mags.data(), metadata.sf,
-                                        true, demod_os2.current_cfo_int()));
-                                }
-                            }
-                            if (os2_syms.size() < 8) continue;
-
-                            // Header validation
-                            HeaderDecodeResult os2_hdr;
-                            int hlen = 0, hcr = 0;
-                            if (metadata.implicit_header) {
-                                host_sim::DeinterleaverConfig hdr_cfg{
-                                    metadata.sf, 4, true, metadata.ldro};
-                                std::size_t consumed_block = 0;
-                                std::vector<uint16_t> first8(os2_syms.begin(),
-                                    os2_syms.begin() + 8);
-                                auto cw = host_sim::deinterleave(
-                                    first8, hdr_cfg, consumed_block);
-                                auto nibs = host_sim::hamming_decode_block(cw, true, 4);
-                                os2_hdr.success = true;
-                                os2_hdr.payload_len = metadata.payload_len;
-                                os2_hdr.cr = metadata.cr;
-                                os2_hdr.has_crc = metadata.has_crc;
-                                os2_hdr.consumed_symbols = consumed_block > 0
-                                    ? static_cast<int>(consumed_block) : 8;
-                                os2_hdr.nibbles.assign(5, 0);
-                                os2_hdr.nibbles.insert(os2_hdr.nibbles.end(),
-                                                       nibs.begin(), nibs.end());
-                                hlen = metadata.payload_len;
-                                hcr = metadata.cr;
-                            } else {
-                                os2_hdr = try_decode_header(os2_syms, 0, metadata);
-                                if (!os2_hdr.success) continue;
-                                hlen = os2_hdr.payload_len > 0
-                                           ? os2_hdr.payload_len
-                                           : metadata.payload_len;
-                                hcr = os2_hdr.cr > 0 ? os2_hdr.cr : metadata.cr;
-                                if (metadata.payload_len > 0 &&
-                                    hlen != metadata.payload_len) continue;
-                                if (metadata.cr > 0 && hcr != metadata.cr) continue;
-                                if (metadata.has_crc && !os2_hdr.has_crc) continue;
-                            }
-
-                            if (os2_pass == 0) {
-                                hdr_hit_pairs.emplace_back(sfo_cand, qoff);
-                                continue;
-                            }
-
-                            // Pass 1: full payload demod + CRC check
-                            const int payload_cw = hcr + 4;
-                            const std::size_t nibbles_needed =
-                                static_cast<std::size_t>(hlen) * 2 +
-                                (os2_hdr.has_crc || metadata.has_crc ? 4 : 0);
-                            const std::size_t header_nibs =
-                                os2_hdr.nibbles.size() > 5
-                                    ? os2_hdr.nibbles.size() - 5 : 0;
-                            const std::size_t data_nibs_needed =
-                                nibbles_needed > header_nibs
-                                    ? nibbles_needed - header_nibs : 0;
-                            const std::size_t data_blocks =
-                                (data_nibs_needed + payload_cw - 1) /
-                                static_cast<std::size_t>(payload_cw);
-                            const std::size_t max_data_syms =
-                                data_blocks * static_cast<std::size_t>(payload_cw) + 4;
-                            const std::size_t total_syms =
-                                8 + max_data_syms;
-
-                            // Demod remaining symbols at variable stride
-                            for (std::size_t i = 8; i < total_syms; ++i) {
-                                const auto pos = static_cast<std::size_t>(
-                                    std::round(static_cast<double>(
-                                                   data_sample_os2) +
-                                               static_cast<double>(i) * stride));
-                                if (pos + sps_os2 > up.size()) break;
-                                os2_syms.push_back(demod_os2.demodulate(&up[pos]));
-                                if (options.soft) {
-                                    const auto& mags = demod_os2.get_fft_magnitudes_sq();
-                                    os2_llrs.push_back(host_sim::compute_symbol_llrs(
-                                        mags.data(), metadata.sf,
-                                        metadata.ldro,
-                                        demod_os2.current_cfo_int()));
-                                }
-                            }
-
-                            // CRC probe + timing adjustment sweep
-                            if ((os2_hdr.has_crc || metadata.has_crc) &&
-                                probe_payload_crc(os2_syms, os2_hdr, metadata)) {
-                                std::cout << "OS=2 fallback: CRC OK (sfo="
-                                          << sfo_cand << " ppm, qoff="
-                                          << qoff << ")\n";
-                                header = std::move(os2_hdr);
-                                symbols = std::move(os2_syms);
-                                symbol_llrs = std::move(os2_llrs);
-                                break;
-                            }
-                            // Timing adjustment sweep (±3 samples)
-                            for (int adj = -1; std::abs(adj) <= 3;
-                                 adj = adj > 0 ? -adj - 1 : -adj) {
-                                const auto adj_data = static_cast<std::size_t>(
-                                    static_cast<std::ptrdiff_t>(data_sample_os2) + adj);
-                                if (adj_data + 8ULL * sps_os2 > up.size()) continue;
-                                demod_os2.set_frequency_offsets(saved_cfo_frac,
-                                                               saved_cfo_int, 0.0f);
-                                demod_os2.reset_symbol_counter();
-                                std::vector<uint16_t> adj_syms;
-                                for (std::size_t i = 0; i < total_syms; ++i) {
-                                    const auto pos = static_cast<std::size_t>(
-                                        std::round(static_cast<double>(adj_data) +
-                                                   static_cast<double>(i) * stride));
-                                    if (pos + sps_os2 > up.size()) break;
-                                    adj_syms.push_back(demod_os2.demodulate(&up[pos]));
-                                }
-                                HeaderDecodeResult adj_hdr;
-                                if (metadata.implicit_header) {
-                                    host_sim::DeinterleaverConfig hdr_cfg{
-                                        metadata.sf, 4, true, metadata.ldro};
-                                    std::size_t adj_consumed = 0;
-                                    std::vector<uint16_t> adj_first8(adj_syms.begin(),
-                                        adj_syms.begin() + std::min<std::ptrdiff_t>(
-                                            8, static_cast<std::ptrdiff_t>(adj_syms.size())));
-                                    auto adj_cw = host_sim::deinterleave(
-                                        adj_first8, hdr_cfg, adj_consumed);
-                                    auto adj_nibs = host_sim::hamming_decode_block(
-                                        adj_cw, true, 4);
-                                    adj_hdr.success = true;
-                                    adj_hdr.payload_len = metadata.payload_len;
-                                    adj_hdr.cr = metadata.cr;
-                                    adj_hdr.has_crc = metadata.has_crc;
-                                    adj_hdr.consumed_symbols = adj_consumed > 0
-                                        ? static_cast<int>(adj_consumed) : 8;
-                                    adj_hdr.nibbles.assign(5, 0);
-                                    adj_hdr.nibbles.insert(adj_hdr.nibbles.end(),
-                                                           adj_nibs.begin(),
-                                                           adj_nibs.end());
-                                } else {
-                                    adj_hdr = try_decode_header(adj_syms, 0, metadata);
-                                    if (!adj_hdr.success) continue;
-                                }
-                                if (probe_payload_crc(adj_syms, adj_hdr, metadata)) {
-                                    std::cout << "OS=2 fallback: CRC OK after adj="
-                                              << adj << " (sfo=" << sfo_cand
-                                              << " ppm, qoff=" << qoff << ")\n";
-                                    header = std::move(adj_hdr);
-                                    symbols = std::move(adj_syms);
-                                    symbol_llrs.clear();
-                                    break;
-                                }
-                            }
-                        }}}  // qoff / sfo_cand / os2_pass
+                const auto& decoded = pkt.result;
+                if (decoded.header_ok) ++stat_decoded;
+                if (decoded.crc_ok) ++stat_crc_ok;
+                if (decoded.payload_failure) stream_payload_failure = true;
+                stat_bit_errors += decoded.bit_errors;
+                stat_total_bits += decoded.total_bits;
+                effort_latencies_ms[static_cast<std::size_t>(decoded.effort)].push_back(pkt.decode_ms);
+                const auto source_time = reader.timestamp_ns(pkt.start, base_meta.sample_rate);
+                auto record = host_sim::make_packet_record(std::move(pkt), packet_index, sample_scale, capture_rate);
+                record.source_time_ns = source_time;
+                packet_sink.write(std::move(record));
+                ++packet_index;
+            };
 
-                        // If OS=2 failed, restore native decode.
-                        if (!header.success) {
-                            header = std::move(fallback_header);
-                            symbols = std::move(fallback_symbols);
-                            symbol_llrs = std::move(fallback_llrs);
-                        }
-                    }
+            // --metrics: periodic Prometheus snapshots of the receiver and
+            // the input ring, for long unattended runs.
+            const auto stream_t0 = std::chrono::steady_clock::now();
+            auto last_snapshot = stream_t0;
+            std::uint64_t snapshot_packets = 0;
+            std::uint64_t samples_in = 0;
+            const auto write_metrics = [&](std::chrono::steady_clock::time_point now) {
+                const auto& rx_metrics = receiver.metrics();
+                const std::uint64_t packets = rx_metrics.packets.load(std::memory_order_relaxed);
+                const double interval = std::chrono::duration<double>(now - last_snapshot).count();
+                host_sim::StreamGauges gauges;
+                gauges.uptime_s = std::chrono::duration<double>(now - stream_t0).count();
+                gauges.stream_s = static_cast<double>(samples_in) / base_meta.sample_rate;
+                gauges.packets_per_s = interval > 0.0 ? static_cast<double>(packets - snapshot_packets) / interval : 0.0;
+                gauges.reader_buffered = reader.available();
+                gauges.reader_capacity = reader.capacity();
+                gauges.reader_overflows = reader.overflows();
+                gauges.reader_dropped_samples = reader.dropped_samples();
+                gauges.source_overflows = reader.source_overflows();
+                gauges.source_lost_samples = reader.source_lost_samples();
+                host_sim::write_metrics_file(*options.metrics_output,
+                                             host_sim::format_prometheus(rx_metrics, receiver.stats(), gauges));
+                last_snapshot = now;
+                snapshot_packets = packets;
+            };
+            const auto metrics_interval = std::chrono::duration<double>(options.metrics_interval_s);
+
+            while (!reader.eof()) {
+                reader.read_chunk();
+                samples_in += reader.available();
+                receiver.push(std::span<const std::complex<float>>(reader.data(), reader.available()));
+                reader.consume(reader.available());
+                while (auto pkt = receiver.pull()) {
+                    report_packet(std::move(*pkt));
                 }
-
-                // Payload decode
-                if (header.success) {
-                    ++stat_decoded;
-                    const int payload_len = header.payload_len > 0
-                                          ? header.payload_len
-                                          : metadata.payload_len;
-                    const int active_cr = header.cr > 0 ? header.cr : metadata.cr;
-                    const bool has_crc = header.has_crc || metadata.has_crc;
-
-                    std::cout << "Header: len=" << payload_len
-                              << " cr=" << active_cr
-                              << " crc=" << (has_crc ? "yes" : "no") << "\n";
-
-                    // Payload nibble target
-                    std::size_t nibble_target = static_cast<std::size_t>(payload_len) * 2;
-                    if (has_crc) nibble_target += 4;
-
-                    // At SF >= 8 the header block produces SF-2 nibbles:
-                    // first 5 are header fields, rest spill into payload.
-                    std::vector<uint8_t> payload_nibbles;
-                    if (header.nibbles.size() > 5) {
-                        for (std::size_t i = 5; i < header.nibbles.size(); ++i) {
-                            payload_nibbles.push_back(header.nibbles[i]);
-                        }
+                if (options.metrics_output) {
+                    const auto now = std::chrono::steady_clock::now();
+                    if (now - last_snapshot >= metrics_interval) {
+                        write_metrics(now);
                     }
-
-                    // Decode data symbols block-by-block
-                    const int payload_cw_len = active_cr + 4;
-                    std::size_t sym_cursor = header.consumed_symbols;
-                    host_sim::DeinterleaverConfig payload_cfg{
-                        metadata.sf, active_cr, false, metadata.ldro};
-
-                    while (static_cast<std::ptrdiff_t>(sym_cursor) + payload_cw_len <=
-                               static_cast<std::ptrdiff_t>(symbols.size()) &&
-                           payload_nibbles.size() < nibble_target) {
-                        std::vector<uint16_t> block(
-                            symbols.begin() + static_cast<std::ptrdiff_t>(sym_cursor),
-                            symbols.begin() + static_cast<std::ptrdiff_t>(sym_cursor) + payload_cw_len);
-                        std::size_t consumed = 0;
-
-                        std::vector<uint8_t> nibs;
-                        if (options.soft &&
-                            sym_cursor + static_cast<std::size_t>(payload_cw_len) <= symbol_llrs.size()) {
-                            std::vector<host_sim::SymbolLLR> block_llrs(
-                                symbol_llrs.begin() + static_cast<std::ptrdiff_t>(sym_cursor),
-                                symbol_llrs.begin() + static_cast<std::ptrdiff_t>(sym_cursor) + payload_cw_len);
-                            nibs = host_sim::soft_decode_block(
-                                block_llrs, metadata.sf, active_cr,
-                                false, metadata.ldro, consumed);
-                        } else {
-                            auto codewords = host_sim::deinterleave(block, payload_cfg, consumed);
-                            nibs = host_sim::hamming_decode_block(codewords, false, active_cr);
-                        }
-                        if (consumed == 0) break;
-                        sym_cursor += consumed;
-                        payload_nibbles.insert(payload_nibbles.end(), nibs.begin(), nibs.end());
-                    }
-
-                    // Dewhiten at nibble level, pack into bytes
-                    // (matches GNU Radio gr-lora_sdr dewhitening convention)
-                    host_sim::WhiteningSequencer seq;
-                    auto whitening = seq.sequence(payload_nibbles.size() / 2);
-
-                    std::vector<uint8_t> dewhitened;
-                    dewhitened.reserve(payload_nibbles.size() / 2);
-                    for (std::size_t i = 0; i + 1 < payload_nibbles.size(); i += 2) {
-                        const std::size_t byte_idx = i / 2;
-                        uint8_t low_nib, high_nib;
-                        if (byte_idx < static_cast<std::size_t>(payload_len)) {
-                            const uint8_t w = (byte_idx < whitening.size()) ? whitening[byte_idx] : 0;
-                            low_nib = (payload_nibbles[i] & 0xF) ^ (w & 0x0F);
-                            high_nib = (payload_nibbles[i + 1] & 0xF) ^ ((w >> 4) & 0x0F);
-                        } else {
-                            low_nib = payload_nibbles[i] & 0xF;
-                            high_nib = payload_nibbles[i + 1] & 0xF;
-                        }
-                        dewhitened.push_back(static_cast<uint8_t>((high_nib << 4) | low_nib));
-                    }
-                    if (dewhitened.size() > static_cast<std::size_t>(payload_len) + (has_crc ? 2u : 0u)) {
-                        dewhitened.resize(static_cast<std::size_t>(payload_len) + (has_crc ? 2u : 0u));
-                    }
-
-                    // Print payload
-                    std::cout << "Payload bytes (dewhitened):";
-                    for (std::size_t i = 0;
-                         i < std::min<std::size_t>(dewhitened.size(),
-                                                    static_cast<std::size_t>(payload_len));
-                         ++i) {
-                        std::cout << ' ' << std::hex << std::setw(2)
-                                  << std::setfill('0')
-                                  << static_cast<int>(dewhitened[i]);
-                    }
-                    std::cout << std::dec << "\n";
-
-                    // ASCII
-                    std::cout << "Payload ASCII: ";
-                    for (std::size_t i = 0;
-                         i < std::min<std::size_t>(dewhitened.size(),
-                                                    static_cast<std::size_t>(payload_len));
-                         ++i) {
-                        const char c = static_cast<char>(dewhitened[i]);
-                        std::cout << (std::isprint(static_cast<unsigned char>(c)) ? c : '.');
-                    }
-                    std::cout << "\n";
-
-                    // CRC check — GNU Radio convention:
-                    // 1. CRC-16/CCITT on first payload_len-2 bytes
-                    // 2. XOR with last 2 payload bytes
-                    if (has_crc && payload_len >= 2 &&
-                        static_cast<int>(dewhitened.size()) >= payload_len + 2) {
-                        std::vector<uint8_t> crc_data(
-                            dewhitened.begin(),
-                            dewhitened.begin() + payload_len - 2);
-                        uint16_t crc = compute_raw_crc16(crc_data);
-                        crc ^= dewhitened[payload_len - 1];
-                        crc ^= static_cast<uint16_t>(dewhitened[payload_len - 2]) << 8;
-                        const uint16_t decoded_crc =
-                            static_cast<uint16_t>(dewhitened[payload_len]) |
-                            (static_cast<uint16_t>(dewhitened[payload_len + 1]) << 8);
-                        const bool ok = (decoded_crc == crc);
-                        if (ok) ++stat_crc_ok;
-                        std::cout << "[payload] CRC decoded=0x" << std::hex
-                                  << std::setw(4) << std::setfill('0')
-                                  << decoded_crc << " computed=0x"
-                                  << std::setw(4) << std::setfill('0') << crc
-                                  << std::dec << (ok ? " OK" : " MISMATCH")
-                                  << "\n";
-                        if (!ok && !options.payload.empty()) {
-                            stream_payload_failure = true;
-                        }
-                    }
-
-                    // BER: compare payload against expected (--payload)
-                    if (!options.payload.empty()) {
-                        const auto& ref = options.payload;
-                        const int cmp_len = std::min(
-                            static_cast<int>(ref.size()), payload_len);
-                        for (int b = 0; b < cmp_len; ++b) {
-                            uint8_t diff = dewhitened[b] ^
-                                           static_cast<uint8_t>(ref[b]);
-                            stat_bit_errors += __builtin_popcount(diff);
-                        }
-                        stat_total_bits += cmp_len * 8;
-
-                        // Byte-exact payload verification
-                        bool match = (static_cast<int>(ref.size()) == payload_len);
-                        if (match) {
-                            for (int b = 0; b < payload_len; ++b) {
-                                if (dewhitened[b] != static_cast<uint8_t>(ref[b])) {
-                                    match = false;
-                                    break;
-                                }
-                            }
-                        }
-                        if (!match) {
-                            stream_payload_failure = true;
-                            std::cout << "[payload] MISMATCH (stream packet #"
-                                      << packet_index << ")\n";
-                        }
-                    }
-                } else {
-                    std::cout << "[stream] packet #" << packet_index
-                              << ": header decode failed\n";
-                }
-
-                const auto decode_t1 = std::chrono::steady_clock::now();
-                const auto decode_us = std::chrono::duration_cast<
-                    std::chrono::microseconds>(decode_t1 - decode_t0).count();
-                std::cout << "[stream] decode latency: " << std::fixed
-                          << std::setprecision(1) << decode_us / 1000.0
-                          << " ms\n" << std::defaultfloat << std::setprecision(6);
-                std::cout.flush();
-
-                // Advance past this burst
-                search_offset = burst_end;
-                ++packet_index;
-
-                // Update adaptive noise floor estimate for next burst
-                if (noise_floor > 0.0f) {
-                    tracked_noise_floor = noise_floor;
                 }
+            }
+            receiver.finish();
+            while (auto pkt = receiver.pull()) {
+                report_packet(std::move(*pkt));
+            }
+            packet_sink.close();
+            if (options.metrics_output) {
+                write_metrics(std::chrono::steady_clock::now());
+            }
 
-                // Periodically compact the buffer
-                if (search_offset > min_accumulate) {
-                    reader.consume(search_offset);
-                    search_offset = 0;
+            log << "\n[stream] EOF — " << packet_index
+                << " packet(s) processed\n";
+            const auto rx_stats = receiver.stats();
+            if (options.multi_sf) {
+                for (const auto& sf : rx_stats.sf) {
+                    log << "[multi-sf] SF" << sf.sf << ": "
+                        << sf.preambles << " preamble(s), "
+                        << sf.packets << " packet(s), " << std::fixed
+                        << std::setprecision(1) << sf.cpu_ms << " ms CPU\n"
+                        << std::defaultfloat << std::setprecision(6);
                 }
             }
-
-            std::cout << "\n[stream] EOF — " << packet_index
-                      << " packet(s) processed\n";
+            if (options.incremental) {
+                log << "[stream] incremental: " << rx_stats.incremental_packets
+                    << " packet(s) decoded as they arrived, " << rx_stats.incremental_fallbacks
+                    << " burst(s) decoded whole\n";
+            }
+            if (options.cancel_collisions > 0) {
+                log << "[stream] collisions: " << receiver.metrics().collision_packets.load()
+                    << " packet(s) decoded after cancelling another\n";
+            }
+            if (rx_stats.bursts_dropped > 0 || rx_stats.detector_stalls > 0 || options.per_stats) {
+                log << "[pipeline] " << rx_stats.decoders << " decoder(s): "
+                    << rx_stats.bursts_queued << " burst(s) queued, "
+                    << rx_stats.bursts_dropped << " dropped, "
+                    << rx_stats.detector_stalls << " detector stall(s), queue high-water "
+                    << rx_stats.queue_high_water << "/" << rx_stats.queue_capacity << "\n";
+            }
+            const bool effort_limits = options.effort != Options::DecodeEffort::standard ||
+                                       options.decode_budget_ms > 0.0 || options.defer_recovery;
+            if (effort_limits || options.per_stats) {
+                print_effort_latencies(log, "[effort]", effort_latencies_ms);
+            }
+            if (effort_limits) {
+                const auto& rx_metrics = receiver.metrics();
+                log << "[effort] " << host_sim::lora_replay::decode_effort_name(options.effort) << " tier, "
+                    << rx_metrics.budget_exhausted.load() << " decode(s) out of budget, "
+                    << rx_metrics.recoveries_queued.load() << " recovery(ies) queued, "
+                    << rx_metrics.recoveries_ok.load() << " recovered, "
+                    << rx_metrics.recoveries_dropped.load() << " skipped\n";
+            }
+            if (reader.overflows() > 0) {
+                log << "[stream] reader overflows: " << reader.overflows()
+                    << ", dropped samples: " << reader.dropped_samples() << "\n";
+            }
+            if (reader.source_overflows() > 0 || reader.source_lost_samples() > 0) {
+                log << "[stream] source overflows: " << reader.source_overflows()
+                    << ", lost samples: " << reader.source_lost_samples() << "\n";
+            }
 
             // PER/BER summary
             if (options.per_stats) {
-                std::cout << "\n=== PER/BER Statistics ===\n"
-                          << "  Bursts detected : " << stat_bursts << "\n"
-                          << "  Headers decoded : " << stat_decoded << "\n"
-                          << "  CRC OK          : " << stat_crc_ok << "\n";
+                log << "\n=== PER/BER Statistics ===\n"
+                    << "  Bursts detected : " << stat_bursts << "\n"
+                    << "  Headers decoded : " << stat_decoded << "\n"
+                    << "  CRC OK          : " << stat_crc_ok << "\n";
                 if (stat_bursts > 0) {
                     const double per = 1.0 - static_cast<double>(stat_crc_ok) /
                                              static_cast<double>(stat_bursts);
-                    std::cout << "  PER             : " << std::fixed
-                              << std::setprecision(4) << per << "\n"
-                              << std::defaultfloat << std::setprecision(6);
+                    log << "  PER             : " << std::fixed
+                        << std::setprecision(4) << per << "\n"
+                        << std::defaultfloat << std::setprecision(6);
                 }
                 if (stat_total_bits > 0) {
                     const double ber = static_cast<double>(stat_bit_errors) /
                                        static_cast<double>(stat_total_bits);
-                    std::cout << "  BER             : " << std::scientific
-                              << std::setprecision(2) << ber
-                              << " (" << stat_bit_errors << "/" << stat_total_bits << " bits)\n"
-                              << std::defaultfloat << std::setprecision(6);
+                    log << "  BER             : " << std::scientific
+                        << std::setprecision(2) << ber
+                        << " (" << stat_bit_errors << "/" << stat_total_bits << " bits)\n"
+                        << std::defaultfloat << std::setprecision(6);
                 }
-                std::cout << "==========================\n";
+                log << "==========================\n";
             }
 
             return stream_payload_failure ? EXIT_FAILURE : EXIT_SUCCESS;
         }
 
         // ── Batch mode (original path) ──────────────────────────
-        std::vector<std::complex<float>> samples;
+        // Files are memory-mapped rather than copied; stdin has to be
+        // buffered.  Either way the decoder sees one read-only span.
+        std::vector<std::complex<float>> stdin_samples;
+        std::optional<host_sim::MappedCapture> mapped_capture;
+        std::span<const std::complex<float>> samples;
         if (options.read_stdin) {
             if (options.verbose) std::cerr << "[debug] reading IQ from stdin"
-                << (options.iq_format == Options::IqFormat::hackrf ? " (hackrf int8)" : " (cf32)")
+                << (options.iq_format == Options::IqFormat::hackrf ? " (hackrf int8)"
+                    : options.iq_format == Options::IqFormat::sc16 ? " (sc16)" : " (cf32)")
                 << std::endl;
             if (options.iq_format == Options::IqFormat::hackrf) {
-                samples = host_sim::load_hackrf_stdin();
+                stdin_samples = host_sim::load_hackrf_stdin();
+            } else if (options.iq_format == Options::IqFormat::sc16) {
+                stdin_samples = host_sim::load_sc16_stdin();
             } else {
-                samples = host_sim::load_cf32_stdin();
+                stdin_samples = host_sim::load_cf32_stdin();
             }
+            samples = stdin_samples;
             if (options.verbose) std::cerr << "[debug] read " << samples.size() << " samples from stdin" << std::endl;
         } else {
-            samples = host_sim::load_cf32(options.iq_file);
+            mapped_capture.emplace(options.iq_file);
+            samples = mapped_capture->samples();
         }
         if (options.verbose) std::cerr << "[debug] loaded samples=" << samples.size() << std::endl;
         const auto stats = host_sim::analyse_capture(samples);
@@ -1491,8 +773,8 @@ int main(int argc, char** argv)
         }
         summary.stats = stats;
 
-        std::vector<uint16_t> symbols;
-        std::vector<host_sim::SymbolLLR> symbol_llrs;
+        std::pmr::vector<uint16_t> symbols;
+        std::pmr::vector<host_sim::SoftSymbol> symbol_llrs;
         std::size_t alignment_samples = 0;
 
         std::cout << "Loaded capture: " << (options.read_stdin ? "<stdin>" : options.iq_file.string()) << "\n"
@@ -1516,6 +798,9 @@ int main(int argc, char** argv)
         if (metadata) {
             summary.metadata = *metadata;
         }
+        if (metadata && !metadata->channels.empty()) {
+            return decode_channelized(samples, *metadata, options);
+        }
 
         bool compare_failure = false;
         bool payload_failure = false;  // payload content or CRC mismatch
@@ -1544,14 +829,57 @@ int main(int argc, char** argv)
             // Tracks where re-demod data symbols start (alignment +
             // sync_pos + quarter-offset), for multi-packet advance.
             std::size_t data_start_sample = 0;
+            // --read-index: every packet's acquisition comes from the
+            // sidecar, so the capture is only touched where packets are.
+            std::optional<BurstIndexFile> stored_index;
+            std::size_t stored_cursor = 0;
+            if (options.read_index) {
+                stored_index = read_burst_index(*options.read_index);
+                if (stored_index->capture_samples != samples.size()) {
+                    throw std::runtime_error("Burst index " + options.read_index->string() + " covers " +
+                                             std::to_string(stored_index->capture_samples) +
+                                             " samples, capture has " + std::to_string(samples.size()));
+                }
+                for (const auto& entry : stored_index->bursts) {
+                    if (entry.sf != metadata->sf) {
+                        throw std::runtime_error("Burst index " + options.read_index->string() +
+                                                 " was written for SF" + std::to_string(entry.sf));
+                    }
+                }
+                std::cout << "[index] " << stored_index->bursts.size() << " burst(s) from "
+                          << options.read_index->string() << "\n";
+            }
+            BurstIndexFile written_index;
+            written_index.capture_samples = samples.size();
+            // Window powers and noise floor over the whole capture, once:
+            // each packet's search then only scans on from its origin.
+            std::optional<host_sim::BurstIndex> burst_index;
+            if (!stored_index) {
+                burst_index.emplace(samples.data(), samples.size(), static_cast<std::size_t>(sps), 6.0f);
+            }
 
           for (;;) { // multi-packet loop (runs once unless --multi)
-            const auto burst_result = host_sim::detect_burst_start(
-                samples, sps, 6.0f, multi_search_offset);
-            const std::size_t burst_offset = burst_result.value_or(0);
-            if (!burst_result && multi_search_offset > 0) {
-                break; // no more bursts in --multi mode
+            HOST_SIM_TRACE_SPAN("decode_burst");
+            const BurstIndexEntry* indexed = nullptr;
+            std::optional<host_sim::BurstDetectResult> burst_result;
+            host_sim::PreambleSpectra preamble_spectra;   // kept by the CFO-aware alignment
+            if (stored_index) {
+                if (stored_cursor == stored_index->bursts.size()) {
+                    break; // every indexed packet decoded
+                }
+                indexed = &stored_index->bursts[stored_cursor++];
+            } else {
+                burst_result = burst_index->find_start(multi_search_offset);
+                if (!burst_result && multi_search_offset > 0) {
+                    break; // no more bursts in --multi mode
+                }
             }
+            const std::size_t burst_offset = indexed ? static_cast<std::size_t>(indexed->offset)
+                                           : burst_result ? burst_result->burst_start : 0;
+            BurstIndexEntry acquired;
+            acquired.offset = burst_offset;
+            acquired.sf = metadata->sf;
+            HOST_SIM_TRACE_COUNT(bursts, 1);
             if (burst_offset > 0) {
                 if (options.multi_packet) {
                     std::cout << "\n=== Packet #" << multi_packet_index << " ===\n";
@@ -1579,9 +907,13 @@ int main(int argc, char** argv)
             // oversampling (os>4), the legacy approach fails due to aliasing,
             // so we use the CFO-aware alignment (magnitude scoring).
             const int os = demod.oversample_factor();
-            if (os > 4) {
+            if (indexed) {
+                alignment_samples = static_cast<std::size_t>(indexed->alignment);
+                detected_preamble_bin = indexed->preamble_bin;
+                std::cout << "Alignment offset: " << alignment_samples << " samples (indexed)" << std::endl;
+            } else if (os > 4) {
                 auto pr = host_sim::find_symbol_alignment_cfo_aware(
-                    burst_view, demod, metadata->preamble_len);
+                    burst_view, demod, metadata->preamble_len, &preamble_spectra);
                 alignment_samples = burst_offset + pr.alignment_offset;
                 detected_preamble_bin = pr.preamble_bin;
                 std::cout << "Alignment offset: " << alignment_samples << " samples"
@@ -1606,12 +938,19 @@ int main(int argc, char** argv)
                 std::min(std::max(metadata->preamble_len - 1, 0), available_symbols);
             float estimated_sfo = 0.0f;
             if (preamble_symbols_to_use > 0) {
-                auto freq_est = demod.estimate_frequency_offsets(
-                    samples.data() + alignment_samples,
-                    preamble_symbols_to_use);
+                // The CFO-aware alignment keeps its preamble FFTs; reuse them.
+                const auto spectra = preamble_spectra.first(alignment_samples - burst_offset,
+                                                            preamble_symbols_to_use);
+                auto freq_est = indexed
+                    ? host_sim::FftDemodulator::FrequencyEstimate{indexed->cfo_frac, indexed->cfo_int,
+                                                                  indexed->sfo_slope}
+                    : !spectra.empty()
+                        ? demod.estimate_frequency_offsets(spectra, preamble_symbols_to_use)
+                        : demod.estimate_frequency_offsets(samples.data() + alignment_samples,
+                                                           preamble_symbols_to_use);
                 // If the CFO-aware search detected a large preamble bin that
                 // estimate_frequency_offsets missed, use the detected value.
-                if (detected_preamble_bin != 0) {
+                if (!indexed && detected_preamble_bin != 0) {
                     const int n_bins = 1 << metadata->sf;
                     int signed_bin = detected_preamble_bin;
                     if (signed_bin > n_bins / 2) signed_bin -= n_bins;
@@ -1630,7 +969,8 @@ int main(int argc, char** argv)
                 // which can flip the rounded bin on marginal symbols.
                 // Try a few offsets around the detected alignment and pick
                 // the one whose preamble symbols most agree on bin 0.
-                if (os <= 4 && !options.compare_root) {
+                if (!indexed && os <= 4 && !options.compare_root) {
+                    HOST_SIM_TRACE_SPAN("align/subsample");
                     int best_offset = 0;
                     int best_count_0 = -1;
                     for (int try_off = -3; try_off <= 3; ++try_off) {
@@ -1666,6 +1006,9 @@ int main(int argc, char** argv)
                 // applied later in the SFD re-demod loop where it helps
                 // the payload decode track timing drift.
                 estimated_sfo = freq_est.sfo_slope;
+                acquired.cfo_int = freq_est.cfo_int;
+                acquired.cfo_frac = freq_est.cfo_frac;
+                acquired.sfo_slope = freq_est.sfo_slope;
                 demod.set_frequency_offsets(freq_est.cfo_frac,
                                             freq_est.cfo_int,
                                             0.0f);
@@ -1694,22 +1037,31 @@ int main(int argc, char** argv)
                 demod.reset_symbol_counter();
             }
 
+            std::optional<host_sim::PolyphaseSamples> planes;
+            if (host_sim::lora_replay::use_polyphase_planes(demod.oversample_factor())) {
+                planes.emplace(samples, demod.oversample_factor());
+            }
+            const host_sim::PolyphaseSamples* planes_ptr = planes ? &*planes : nullptr;
+            acquired.alignment = alignment_samples;
+            acquired.preamble_bin = detected_preamble_bin;
+            // An indexed packet only needs the symbols up to its recorded end.
+            const std::size_t demod_end = indexed
+                ? static_cast<std::size_t>(indexed->offset + indexed->length)
+                : samples.size();
             const int symbol_count = static_cast<int>(std::min<std::size_t>(
-                (samples.size() > alignment_samples
-                     ? (samples.size() - alignment_samples) / static_cast<std::size_t>(sps)
+                (demod_end > alignment_samples
+                     ? (demod_end - alignment_samples) / static_cast<std::size_t>(sps)
                      : 0),
                 static_cast<std::size_t>(INT_MAX)));
             symbols.reserve(symbol_count);
+            if (symbol_count > 0) {
+                demodulate_span(demod, samples, planes_ptr, alignment_samples,
+                                static_cast<double>(sps),
+                                static_cast<std::size_t>(symbol_count), *metadata,
+                                symbols, options.soft ? &symbol_llrs : nullptr);
+            }
             for (int idx = 0; idx < symbol_count; ++idx) {
-                uint16_t value = demod.demodulate(&samples[alignment_samples + static_cast<std::size_t>(idx) * sps]);
-                symbols.push_back(value);
-                if (options.soft) {
-                    const auto& mags = demod.get_fft_magnitudes_sq();
-                    symbol_llrs.push_back(host_sim::compute_symbol_llrs(
-                        mags.data(), metadata->sf,
-                        (idx < 8) || metadata->ldro,
-                        demod.current_cfo_int()));
-                }
+                const uint16_t value = symbols[static_cast<std::size_t>(idx)];
                 uint16_t ref_value = demod_ref.demodulate(&samples[alignment_samples + static_cast<std::size_t>(idx) * sps]);
                 if (value != ref_value) {
                     ++reference_mismatches;
@@ -1760,36 +1112,10 @@ int main(int argc, char** argv)
             const bool skip_grid_scan =
                 (os > 4) || (os == 4 && !options.compare_root);
             if (!skip_grid_scan) {
-            for (std::size_t candidate = 0; candidate + 8 <= symbols.size(); ++candidate) {
-                auto candidate_header = try_decode_header(symbols, candidate, *metadata);
-                if (!candidate_header.success) {
-                    continue;
-                }
-
-                int header_len = candidate_header.payload_len;
-                if (header_len <= 0) {
-                    header_len = metadata->payload_len;
-                }
-                if (metadata->payload_len > 0 && header_len != metadata->payload_len) {
-                    continue;
-                }
-
-                int header_cr = candidate_header.cr;
-                if (header_cr <= 0) {
-                    header_cr = metadata->cr;
-                }
-                if (metadata->cr > 0 && header_cr != metadata->cr) {
-                    continue;
-                }
-
-                if (metadata->has_crc && !candidate_header.has_crc) {
-                    continue;
-                }
-
-                header = std::move(candidate_header);
-                symbol_cursor = candidate + header.consumed_symbols;
-                chosen_offset = candidate;
-                break;
+            if (const auto location = host_sim::locate_header(symbols, *metadata)) {
+                header = try_decode_header(symbols, location->index, *metadata);
+                symbol_cursor = location->index + header.consumed_symbols;
+                chosen_offset = location->index;
             }
             } // !skip_grid_scan
 
@@ -1804,6 +1130,7 @@ int main(int argc, char** argv)
             // Exception: stage-comparison mode (--compare-root) needs the
             // preamble-grid decode to stay bit-exact with the reference.
             if (!header.success && !options.compare_root) {
+                HOST_SIM_TRACE_SPAN("fallback");
                 auto sync_pos = host_sim::find_header_symbol_index(
                     symbols, 0x12, metadata->sf);
                 if (!sync_pos) {
@@ -1830,233 +1157,19 @@ int main(int argc, char** argv)
                     ? static_cast<double>(sps) * (1.0 - static_cast<double>(saved_sfo) / N_bins)
                     : static_cast<double>(sps);
 
+                // Batch mode always runs at standard effort, unbounded.
+                FallbackBudget budget(host_sim::lora_replay::DecodeEffort::standard, 0.0);
                 if (sync_pos) {
-                    const std::size_t quarter = static_cast<std::size_t>(sps / 4);
-
-                    // Try quarter-symbol offsets: 1 (standard), 0, 2, 3
-                    for (int qoff : {1, 0, 2, 3}) {
-                        if (header.success) break;
-                        const std::size_t data_sample = alignment_samples +
-                            *sync_pos * static_cast<std::size_t>(sps) +
-                            static_cast<std::size_t>(qoff) * quarter;
-                        if (data_sample + 8ULL * sps > samples.size()) continue;
-
-                        // Re-demodulate data symbols from adjusted position.
-                        // Use SFO stride for timing; sfo_slope=0 in demod.
-                        demod.set_frequency_offsets(saved_cfo_frac,
-                                                   saved_cfo_int,
-                                                   0.0f);
-                        demod.reset_symbol_counter();
-                        std::vector<uint16_t> redemod;
-                        std::vector<host_sim::SymbolLLR> redemod_llrs;
-                        const std::size_t max_sym = (samples.size() - data_sample) / sps;
-                        // Per-symbol SFO tracking: refine stride using
-                        // residual drift from parabolic interpolation.
-                        double sfo_accum = 0.0;
-                        double sfo_stride = redemod_stride;
-                        float sfo_prev_res = 0.0f;
-                        float sfo_drift = 0.0f;
-                        constexpr float sfo_alpha = 0.01f;
-                        constexpr int sfo_delay = 8;
-                        // Cap at 1024 symbols: enough for max LoRa payload (255B, any SF/CR)
-                        // while preventing multi-packet mode from consuming the entire capture.
-                        for (std::size_t i = 0; i < std::min<std::size_t>(max_sym, 1024); ++i) {
-                            const std::size_t sym_off = static_cast<std::size_t>(
-                                std::round(sfo_accum));
-                            if (data_sample + sym_off + static_cast<std::size_t>(sps) > samples.size()) break;
-                            redemod.push_back(demod.demodulate(
-                                &samples[data_sample + sym_off]));
-                            if (options.soft) {
-                                const auto& mags = demod.get_fft_magnitudes_sq();
-                                redemod_llrs.push_back(host_sim::compute_symbol_llrs(
-                                    mags.data(), metadata->sf,
-                                    (static_cast<int>(i) < 8) || metadata->ldro,
-                                    saved_cfo_int));
-                            }
-                            // Adaptive stride: track residual slope.
-                            if (static_cast<int>(i) >= sfo_delay) {
-                                float dr = demod.last_residual() - sfo_prev_res;
-                                if (dr > 0.5f) dr -= 1.0f;
-                                if (dr < -0.5f) dr += 1.0f;
-                                sfo_drift += sfo_alpha * (dr - sfo_drift);
-                                sfo_stride = redemod_stride -
-                                    static_cast<double>(sps) *
-                                    static_cast<double>(sfo_drift) / N_bins;
-                            }
-                            sfo_prev_res = demod.last_residual();
-                            sfo_accum += sfo_stride;
-                        }
-
-                        if (metadata->implicit_header) {
-                            // Helper lambda: build implicit header from symbols.
-                            auto build_implicit_header = [&](const std::vector<uint16_t>& syms)
-                                -> HeaderDecodeResult {
-                                HeaderDecodeResult h;
-                                const std::size_t hdr_syms = std::min<std::size_t>(8, syms.size());
-                                std::vector<uint16_t> first_block(syms.begin(),
-                                                                  syms.begin() + hdr_syms);
-                                host_sim::DeinterleaverConfig hdr_cfg{metadata->sf, 4, true, metadata->ldro};
-                                std::size_t consumed_block = 0;
-                                auto codewords = host_sim::deinterleave(first_block, hdr_cfg, consumed_block);
-                                auto nibs = host_sim::hamming_decode_block(codewords, true, 4);
-                                h.success = true;
-                                h.payload_len = metadata->payload_len;
-                                h.cr = metadata->cr;
-                                h.has_crc = metadata->has_crc;
-                                h.checksum_field = -1;
-                                h.checksum_computed = -1;
-                                h.consumed_symbols = consumed_block > 0 ? consumed_block : 8;
-                                h.codewords.assign(codewords.begin(), codewords.end());
-                                h.nibbles.assign(5, 0);
-                                h.nibbles.insert(h.nibbles.end(), nibs.begin(), nibs.end());
-                                return h;
-                            };
-
-                            auto imp_hdr = build_implicit_header(redemod);
-
-                            // CRC-guided timing sweep for implicit header.
-                            if (metadata->has_crc &&
-                                !probe_payload_crc(redemod, imp_hdr, *metadata)) {
-                                const int max_adj = std::max(os, 4) + 2;
-                                for (int adj = -1; std::abs(adj) <= max_adj;
-                                     adj = adj > 0 ? -adj - 1 : -adj) {
-                                    const auto adj_data = static_cast<std::size_t>(
-                                        static_cast<std::ptrdiff_t>(data_sample) + adj);
-                                    if (adj_data + 8ULL * sps > samples.size())
-                                        continue;
-                                    demod.set_frequency_offsets(saved_cfo_frac,
-                                                               saved_cfo_int,
-                                                               0.0f);
-                                    demod.reset_symbol_counter();
-                                    std::vector<uint16_t> adj_syms;
-                                    std::vector<host_sim::SymbolLLR> adj_llrs;
-                                    const std::size_t adj_max =
-                                        (samples.size() - adj_data) / sps;
-                                    for (std::size_t i = 0;
-                                         i < std::min<std::size_t>(adj_max, 200);
-                                         ++i) {
-                                        const std::size_t sym_off = static_cast<std::size_t>(
-                                            std::round(i * redemod_stride));
-                                        if (adj_data + sym_off + static_cast<std::size_t>(sps) > samples.size()) break;
-                                        adj_syms.push_back(demod.demodulate(
-                                            &samples[adj_data + sym_off]));
-                                        if (options.soft) {
-                                            const auto& mags = demod.get_fft_magnitudes_sq();
-                                            adj_llrs.push_back(host_sim::compute_symbol_llrs(
-                                                mags.data(), metadata->sf,
-                                                (static_cast<int>(i) < 8) || metadata->ldro,
-                                                saved_cfo_int));
-                                        }
-                                    }
-                                    auto adj_hdr = build_implicit_header(adj_syms);
-                                    if (probe_payload_crc(adj_syms, adj_hdr,
-                                                          *metadata)) {
-                                        redemod = std::move(adj_syms);
-                                        redemod_llrs = std::move(adj_llrs);
-                                        imp_hdr = std::move(adj_hdr);
-                                        std::cout << "SFD re-demod: implicit data start "
-                                                     "refined by "
-                                                  << adj
-                                                  << " samples (CRC verified)\n";
-                                        break;
-                                    }
-                                }
-                            }
-
-                            // Only accept this qoff if CRC validated
-                            // (or if there's no CRC to check).
-                            bool crc_ok = !metadata->has_crc ||
-                                probe_payload_crc(redemod, imp_hdr, *metadata);
-
-                            if (crc_ok) {
-                                std::cout << "SFD re-demod: implicit header, quarter offset "
-                                          << qoff << " (sync at symbol " << (*sync_pos - 4) << ")\n";
-                                header = std::move(imp_hdr);
-                                symbol_cursor = header.consumed_symbols;
-                                chosen_offset = 0;
-                                data_start_sample = data_sample;
-                                symbols = std::move(redemod);
-                                symbol_llrs = std::move(redemod_llrs);
-                                break;
-                            }
-                            // CRC failed even after timing sweep — try next qoff.
-                            continue;
-                        }
-
-                        auto hdr = try_decode_header(redemod, 0, *metadata);
-                        if (!hdr.success) continue;
-
-                        int hlen = hdr.payload_len > 0 ? hdr.payload_len : metadata->payload_len;
-                        int hcr = hdr.cr > 0 ? hdr.cr : metadata->cr;
-                        if (metadata->payload_len > 0 && hlen != metadata->payload_len) continue;
-                        if (metadata->cr > 0 && hcr != metadata->cr) continue;
-                        if (metadata->has_crc && !hdr.has_crc) continue;
-
-                        // SFO-induced timing drift between the preamble
-                        // and data start can shift data symbols by ±1 bin.
-                        // The header is robust (uses sf_app = sf-2) but the
-                        // payload is not.  Sweep small timing adjustments
-                        // around the nominal data_sample and select the one
-                        // that gives a valid CRC.
-                        if ((hdr.has_crc || metadata->has_crc) &&
-                            !probe_payload_crc(redemod, hdr, *metadata)) {
-                            const int max_adj = std::max(os, 4) + 2;
-                            for (int adj = -1; std::abs(adj) <= max_adj; adj = adj > 0 ? -adj - 1 : -adj) {
-                                const auto adj_data = static_cast<std::size_t>(
-                                    static_cast<std::ptrdiff_t>(data_sample) + adj);
-                                if (adj_data + 8ULL * sps > samples.size())
-                                    continue;
-                                demod.set_frequency_offsets(saved_cfo_frac,
-                                                           saved_cfo_int,
-                                                           0.0f);
-                                demod.reset_symbol_counter();
-                                std::vector<uint16_t> adj_syms;
-                                std::vector<host_sim::SymbolLLR> adj_llrs;
-                                const std::size_t adj_max =
-                                    (samples.size() - adj_data) / sps;
-                                for (std::size_t i = 0;
-                                     i < std::min<std::size_t>(adj_max, 200);
-                                     ++i) {
-                                    const std::size_t sym_off = static_cast<std::size_t>(
-                                        std::round(i * redemod_stride));
-                                    if (adj_data + sym_off + static_cast<std::size_t>(sps) > samples.size()) break;
-                                    adj_syms.push_back(demod.demodulate(
-                                        &samples[adj_data + sym_off]));
-                                    if (options.soft) {
-                                        const auto& mags = demod.get_fft_magnitudes_sq();
-                                        adj_llrs.push_back(host_sim::compute_symbol_llrs(
-                                            mags.data(), metadata->sf,
-                                            (static_cast<int>(i) < 8) || metadata->ldro,
-                                            saved_cfo_int));
-                                    }
-                                }
-                                auto adj_hdr =
-                                    try_decode_header(adj_syms, 0, *metadata);
-                                if (!adj_hdr.success) continue;
-                                if (probe_payload_crc(adj_syms, adj_hdr,
-                                                      *metadata)) {
-                                    redemod = std::move(adj_syms);
-                                    redemod_llrs = std::move(adj_llrs);
-                                    hdr = std::move(adj_hdr);
-                                    std::cout << "SFD re-demod: data start "
-                                                 "refined by "
-                                              << adj
-                                              << " samples (CRC verified)\n";
-                                    break;
-                                }
-                            }
-                        }
-
-                        std::cout << "SFD re-demod: header found with quarter offset "
-                                  << qoff << " (sync at symbol " << (*sync_pos - 4)
-                                  << ")\n";
-                        header = std::move(hdr);
+                    FallbackDecode found = redemod_from_sfd(demod, samples, planes_ptr, alignment_samples, *sync_pos,
+                                                            redemod_stride, *metadata, options.soft, budget,
+                                                            std::cout);
+                    if (found.header.success) {
+                        header = std::move(found.header);
                         symbol_cursor = header.consumed_symbols;
                         chosen_offset = 0;
-                        data_start_sample = data_sample;
-                        symbols = std::move(redemod);
-                        symbol_llrs = std::move(redemod_llrs);
-                        break;
+                        data_start_sample = found.data_sample;
+                        symbols = std::move(found.symbols);
+                        symbol_llrs = std::move(found.llrs);
                     }
                 }
 
@@ -2073,403 +1186,15 @@ int main(int argc, char** argv)
                     need_os2 = true;
                 }
                 if (need_os2 && sync_pos && os == 1) {
-                    // Save current decode as fallback.
-                    auto fallback_header = header;
-                    auto fallback_symbols = symbols;
-                    auto fallback_llrs = symbol_llrs;
-                    auto fallback_cursor = symbol_cursor;
-                    auto fallback_offset = chosen_offset;
-                    header.success = false;
-
-                    const std::size_t burst_start = alignment_samples;
-                    const std::size_t burst_len = samples.size() - burst_start;
-                    auto up = upsample_2x(&samples[burst_start], burst_len);
-
-                    const int sps_os2 = sps * 2;
-                    const std::size_t quarter_os2 =
-                        static_cast<std::size_t>(sps_os2 / 4);
-                    host_sim::FftDemodulator demod_os2(metadata->sf,
-                                            metadata->bw * 2,
-                                            metadata->bw);
-
-                    // Sweep SFO rate compensation: 0 first, then spiral
-                    // outward.  SFO shifts symbol boundaries by
-                    //   drift_per_sym = sfo_ppm * sps_os2 / 1e6
-                    // We compensate by adjusting the stride between
-                    // successive FFT windows.
-                    //
-                    // Two passes: pass 0 skips timing refinement (fast
-                    // reject of wrong SFO candidates), pass 1 adds ±6
-                    // sample adjustments for borderline alignments.
-                    // Track which (sfo_cand, qoff) passed header on
-                    // pass 0 so pass 1 only retries those.
-                    std::vector<std::pair<int,int>> hdr_hit_pairs;
-                    for (int os2_pass = 0;
-                         os2_pass < 2 && !header.success; ++os2_pass) {
-                    for (int sfo_cand = 0; std::abs(sfo_cand) <= 100;
-                         sfo_cand = sfo_cand >= 0 ? -sfo_cand - 10
-                                                  : -sfo_cand) {
-                        if (header.success) break;
-                        const double stride =
-                            static_cast<double>(sps_os2) *
-                            (1.0 - static_cast<double>(sfo_cand) * 1e-6);
-
-                    for (int qoff : {1, 0, 2, 3}) {
-                        if (header.success) break;
-                        // Fast pass: only try qoff=1 (most common),
-                        // skip timing-adjustment loop.
-                        if (os2_pass == 0 && qoff != 1) continue;
-                        // Full pass: only retry pairs that passed
-                        // header on pass 0 (need adj refinement).
-                        if (os2_pass == 1) {
-                            bool was_hit = false;
-                            for (auto& p : hdr_hit_pairs)
-                                if (p.first == sfo_cand && p.second == qoff)
-                                    was_hit = true;
-                            if (!was_hit) continue;
-                        }
-                        const std::size_t data_sample_os2 =
-                            *sync_pos * static_cast<std::size_t>(sps_os2) +
-                            static_cast<std::size_t>(qoff) * quarter_os2;
-                        if (data_sample_os2 + 8ULL * sps_os2 > up.size())
-                            continue;
-
-                        demod_os2.set_frequency_offsets(saved_cfo_frac,
-                                                       saved_cfo_int,
-                                                       0.0f);
-                        demod_os2.reset_symbol_counter();
-                        std::vector<uint16_t> redemod;
-                        std::vector<host_sim::SymbolLLR> redemod_llrs;
-
-                        // Phase 1: demod first 8 symbols for header probe
-                        for (std::size_t i = 0; i < 8; ++i) {
-                            const auto pos = static_cast<std::size_t>(
-                                std::round(static_cast<double>(
-                                               data_sample_os2) +
-                                           static_cast<double>(i) * stride));
-                            if (pos + static_cast<std::size_t>(sps_os2) >
-                                up.size())
-                                break;
-                            redemod.push_back(demod_os2.demodulate(&up[pos]));
-                            if (options.soft) {
-                                const auto& mags = demod_os2.get_fft_magnitudes_sq();
-                                redemod_llrs.push_back(
-                                    host_sim::compute_symbol_llrs(
-                                        mags.data(), metadata->sf,
-                                        true,
-                                        saved_cfo_int));
-                            }
-                        }
-
-                        // Early header check — skip full demod when
-                        // header clearly wrong (explicit header only).
-                        std::size_t max_syms_needed = 1024;
-                        // For implicit header, compute cap from metadata.
-                        if (metadata->implicit_header) {
-                            if (metadata->payload_len > 0 &&
-                                metadata->cr > 0) {
-                                const std::size_t nibbles =
-                                    static_cast<std::size_t>(
-                                        metadata->payload_len) * 2 + 4;
-                                const std::size_t cw =
-                                    static_cast<std::size_t>(
-                                        metadata->cr + 4);
-                                const std::size_t blocks =
-                                    (nibbles + cw - 1) / cw;
-                                max_syms_needed = 8 + blocks * cw + 4;
-                            }
-                        } else {
-                            auto hdr_probe =
-                                try_decode_header(redemod, 0, *metadata);
-                            if (!hdr_probe.success) continue;
-                            int hlen_p = hdr_probe.payload_len > 0
-                                             ? hdr_probe.payload_len
-                                             : metadata->payload_len;
-                            int hcr_p = hdr_probe.cr > 0
-                                            ? hdr_probe.cr
-                                            : metadata->cr;
-                            if (metadata->payload_len > 0 &&
-                                hlen_p != metadata->payload_len)
-                                continue;
-                            if (metadata->cr > 0 &&
-                                hcr_p != metadata->cr)
-                                continue;
-                            if (metadata->has_crc && !hdr_probe.has_crc)
-                                continue;
-                            // Cap demod to symbols needed for CRC check:
-                            // header_consumed + ceil(nibbles / cw_len) * cw_len + margin.
-                            if (hlen_p > 0 && hcr_p > 0) {
-                                const std::size_t nibbles =
-                                    static_cast<std::size_t>(hlen_p) * 2 + 4;
-                                const std::size_t cw = static_cast<std::size_t>(hcr_p + 4);
-                                const std::size_t blocks = (nibbles + cw - 1) / cw;
-                                const std::size_t hdr_sym =
-                                    hdr_probe.consumed_symbols > 0
-                                        ? hdr_probe.consumed_symbols : 8;
-                                max_syms_needed = hdr_sym + blocks * cw + 4;
-                            }
-                        }
-
-                        // Phase 2: demod remaining symbols
-                        for (std::size_t i = redemod.size();
-                             i < max_syms_needed; ++i) {
-                            const auto pos = static_cast<std::size_t>(
-                                std::round(static_cast<double>(
-                                               data_sample_os2) +
-                                           static_cast<double>(i) * stride));
-                            if (pos + static_cast<std::size_t>(sps_os2) >
-                                up.size())
-                                break;
-                            redemod.push_back(demod_os2.demodulate(&up[pos]));
-                            if (options.soft) {
-                                const auto& mags = demod_os2.get_fft_magnitudes_sq();
-                                redemod_llrs.push_back(
-                                    host_sim::compute_symbol_llrs(
-                                        mags.data(), metadata->sf,
-                                        (static_cast<int>(i) < 8) ||
-                                            metadata->ldro,
-                                        saved_cfo_int));
-                            }
-                        }
-
-                        if (metadata->implicit_header) {
-                            HeaderDecodeResult imp_hdr;
-                            {
-                                const std::size_t hdr_syms =
-                                    std::min<std::size_t>(8, redemod.size());
-                                std::vector<uint16_t> first_block(
-                                    redemod.begin(),
-                                    redemod.begin() + hdr_syms);
-                                host_sim::DeinterleaverConfig hdr_cfg{
-                                    metadata->sf, 4, true, metadata->ldro};
-                                std::size_t consumed_block = 0;
-                                auto codewords = host_sim::deinterleave(
-                                    first_block, hdr_cfg, consumed_block);
-                                auto nibs =
-                                    host_sim::hamming_decode_block(
-                                        codewords, true, 4);
-                                imp_hdr.success = true;
-                                imp_hdr.payload_len = metadata->payload_len;
-                                imp_hdr.cr = metadata->cr;
-                                imp_hdr.has_crc = metadata->has_crc;
-                                imp_hdr.checksum_field = -1;
-                                imp_hdr.checksum_computed = -1;
-                                imp_hdr.consumed_symbols =
-                                    consumed_block > 0 ? consumed_block : 8;
-                                imp_hdr.codewords.assign(
-                                    codewords.begin(), codewords.end());
-                                imp_hdr.nibbles.assign(5, 0);
-                                imp_hdr.nibbles.insert(
-                                    imp_hdr.nibbles.end(),
-                                    nibs.begin(), nibs.end());
-                            }
-
-                            if (metadata->has_crc &&
-                                !probe_payload_crc(redemod, imp_hdr,
-                                                   *metadata)) {
-                                if (os2_pass == 0) {
-                                    hdr_hit_pairs.push_back({sfo_cand, qoff});
-                                    continue;
-                                }
-                                for (int adj = -1; std::abs(adj) <= 3;
-                                     adj = adj > 0 ? -adj - 1 : -adj) {
-                                    const auto adj_data =
-                                        static_cast<std::size_t>(
-                                            static_cast<std::ptrdiff_t>(
-                                                data_sample_os2) +
-                                            adj);
-                                    if (adj_data + 8ULL * sps_os2 >
-                                        up.size())
-                                        continue;
-                                    demod_os2.set_frequency_offsets(
-                                        saved_cfo_frac, saved_cfo_int,
-                                        0.0f);
-                                    demod_os2.reset_symbol_counter();
-                                    std::vector<uint16_t> adj_syms;
-                                    for (std::size_t i = 0; i < max_syms_needed; ++i) {
-                                        const auto pos = static_cast<std::size_t>(
-                                            std::round(static_cast<double>(
-                                                           adj_data) +
-                                                       static_cast<double>(i) * stride));
-                                        if (pos + static_cast<std::size_t>(sps_os2) >
-                                            up.size())
-                                            break;
-                                        adj_syms.push_back(
-                                            demod_os2.demodulate(&up[pos]));
-                                    }
-                                    HeaderDecodeResult adj_imp;
-                                    {
-                                        const std::size_t hs =
-                                            std::min<std::size_t>(
-                                                8, adj_syms.size());
-                                        std::vector<uint16_t> fb(
-                                            adj_syms.begin(),
-                                            adj_syms.begin() + hs);
-                                        host_sim::DeinterleaverConfig
-                                            hcfg{metadata->sf, 4, true,
-                                                 metadata->ldro};
-                                        std::size_t cb = 0;
-                                        auto cw =
-                                            host_sim::deinterleave(
-                                                fb, hcfg, cb);
-                                        auto nb =
-                                            host_sim::hamming_decode_block(
-                                                cw, true, 4);
-                                        adj_imp.success = true;
-                                        adj_imp.payload_len =
-                                            metadata->payload_len;
-                                        adj_imp.cr = metadata->cr;
-                                        adj_imp.has_crc =
-                                            metadata->has_crc;
-                                        adj_imp.checksum_field = -1;
-                                        adj_imp.checksum_computed = -1;
-                                        adj_imp.consumed_symbols =
-                                            cb > 0 ? cb : 8;
-                                        adj_imp.codewords.assign(
-                                            cw.begin(), cw.end());
-                                        adj_imp.nibbles.assign(5, 0);
-                                        adj_imp.nibbles.insert(
-                                            adj_imp.nibbles.end(),
-                                            nb.begin(), nb.end());
-                                    }
-                                    if (probe_payload_crc(adj_syms, adj_imp,
-                                                          *metadata)) {
-                                        redemod = std::move(adj_syms);
-                                        imp_hdr = std::move(adj_imp);
-                                        std::cout
-                                            << "OS=2 upsample: implicit "
-                                               "data start refined by "
-                                            << adj
-                                            << " samples (CRC verified)\n";
-                                        break;
-                                    }
-                                }
-                            }
-
-                            bool crc_ok = !metadata->has_crc ||
-                                probe_payload_crc(redemod, imp_hdr,
-                                                  *metadata);
-                            if (crc_ok) {
-                                std::cout
-                                    << "OS=2 upsample: implicit header, "
-                                       "quarter offset "
-                                    << qoff;
-                                if (sfo_cand != 0) {
-                                    std::cout << " (SFO=" << sfo_cand << "ppm)";
-                                }
-                                std::cout << "\n";
-                                header = std::move(imp_hdr);
-                                symbol_cursor = header.consumed_symbols;
-                                chosen_offset = 0;
-                                data_start_sample =
-                                    alignment_samples + data_sample_os2 / 2;
-                                symbols = std::move(redemod);
-                                symbol_llrs = std::move(redemod_llrs);
-                                break;
-                            }
-                            continue;
-                        }
-
-                        auto hdr_os2 =
-                            try_decode_header(redemod, 0, *metadata);
-                        if (!hdr_os2.success) continue;
-
-                        int hlen = hdr_os2.payload_len > 0
-                                       ? hdr_os2.payload_len
-                                       : metadata->payload_len;
-                        int hcr = hdr_os2.cr > 0 ? hdr_os2.cr
-                                                  : metadata->cr;
-                        if (metadata->payload_len > 0 &&
-                            hlen != metadata->payload_len)
-                            continue;
-                        if (metadata->cr > 0 && hcr != metadata->cr)
-                            continue;
-                        if (metadata->has_crc && !hdr_os2.has_crc)
-                            continue;
-
-                        if ((hdr_os2.has_crc || metadata->has_crc) &&
-                            !probe_payload_crc(redemod, hdr_os2,
-                                               *metadata)) {
-                            if (os2_pass == 0) {
-                                hdr_hit_pairs.push_back({sfo_cand, qoff});
-                                continue;
-                            }
-                            for (int adj = -1; std::abs(adj) <= 3;
-                                 adj = adj > 0 ? -adj - 1 : -adj) {
-                                const auto adj_data =
-                                    static_cast<std::size_t>(
-                                        static_cast<std::ptrdiff_t>(
-                                            data_sample_os2) +
-                                        adj);
-                                if (adj_data + 8ULL * sps_os2 > up.size())
-                                    continue;
-                                demod_os2.set_frequency_offsets(
-                                    saved_cfo_frac, saved_cfo_int, 0.0f);
-                                demod_os2.reset_symbol_counter();
-                                std::vector<uint16_t> adj_syms;
-                                for (std::size_t i = 0; i < max_syms_needed; ++i) {
-                                    const auto pos = static_cast<std::size_t>(
-                                        std::round(static_cast<double>(
-                                                       adj_data) +
-                                                   static_cast<double>(i) * stride));
-                                    if (pos + static_cast<std::size_t>(sps_os2) >
-                                        up.size())
-                                        break;
-                                    adj_syms.push_back(
-                                        demod_os2.demodulate(&up[pos]));
-                                }
-                                auto adj_hdr = try_decode_header(
-                                    adj_syms, 0, *metadata);
-                                if (!adj_hdr.success) continue;
-                                if (probe_payload_crc(adj_syms, adj_hdr,
-                                                      *metadata)) {
-                                    redemod = std::move(adj_syms);
-                                    hdr_os2 = std::move(adj_hdr);
-                                    std::cout
-                                        << "OS=2 upsample: data start "
-                                           "refined by "
-                                        << adj
-                                        << " samples (CRC verified)\n";
-                                    break;
-                                }
-                            }
-                        }
-
-                        // Only accept if CRC passes (or no CRC).
-                        // If CRC fails, try the next SFO candidate.
-                        if ((hdr_os2.has_crc || metadata->has_crc) &&
-                            !probe_payload_crc(redemod, hdr_os2,
-                                               *metadata)) {
-                            continue;
-                        }
-
-                        std::cout << "OS=2 upsample: header found with "
-                                     "quarter offset "
-                                  << qoff;
-                        if (sfo_cand != 0) {
-                            std::cout << " (SFO=" << sfo_cand << "ppm)";
-                        }
-                        std::cout << "\n";
-                        header = std::move(hdr_os2);
+                    FallbackDecode found = redemod_at_os2(samples, alignment_samples, *sync_pos, saved_cfo_frac,
+                                                          saved_cfo_int, *metadata, options.soft, budget, std::cout);
+                    if (found.header.success) {
+                        header = std::move(found.header);
                         symbol_cursor = header.consumed_symbols;
                         chosen_offset = 0;
-                        data_start_sample =
-                            alignment_samples + data_sample_os2 / 2;
-                        symbols = std::move(redemod);
-                        symbol_llrs = std::move(redemod_llrs);
-                        break;
-                    }
-                    } // sfo_cand
-                    } // os2_pass
-
-                    // If OS=2 didn't produce CRC-valid decode, restore
-                    // the original native-OS result.
-                    if (!header.success && fallback_header.success) {
-                        header = std::move(fallback_header);
-                        symbols = std::move(fallback_symbols);
-                        symbol_llrs = std::move(fallback_llrs);
-                        symbol_cursor = fallback_cursor;
-                        chosen_offset = fallback_offset;
+                        data_start_sample = found.data_sample;
+                        symbols = std::move(found.symbols);
+                        symbol_llrs = std::move(found.llrs);
                     }
                 }
             }
@@ -2520,27 +1245,23 @@ int main(int argc, char** argv)
                     stage_outputs.hamming.push_back(static_cast<uint8_t>(header.nibbles[i] & 0xF));
                 }
 
-                std::size_t nibble_target = static_cast<std::size_t>(expected_payload_len) * 2;
-                if (expected_crc) {
-                    nibble_target += 4; // 2 bytes CRC
-                }
-
                 host_sim::DeinterleaverConfig payload_cfg{metadata->sf, active_cr, false, metadata->ldro};
-                std::vector<uint8_t> payload_nibbles;
+                // Dewhitening, byte packing and the CRC run incrementally as
+                // the nibbles arrive; it stops once payload and CRC are in.
+                host_sim::PayloadDecoder payload_decoder(
+                    {metadata->sf, active_cr, metadata->ldro, expected_payload_len, expected_crc, -1});
 
                 // For SF >= 8, the header block (8 symbols at CR=4/8)
                 // produces SF-2 nibbles: the first 5 are header fields,
                 // and the remaining SF-7 are the start of the payload.
                 // These must be prepended to the payload nibble stream.
                 if (header.nibbles.size() > 5) {
-                    for (std::size_t i = 5; i < header.nibbles.size(); ++i) {
-                        payload_nibbles.push_back(header.nibbles[i]);
-                    }
+                    payload_decoder.push_nibbles(header.nibbles.data() + 5, header.nibbles.size() - 5);
                 }
 
                 const int payload_cw_len = active_cr + 4;
                 const bool suppress_payload_stage = (metadata->sf <= 6);
-                while (symbol_cursor + payload_cw_len <= symbols.size() && payload_nibbles.size() < nibble_target) {
+                while (symbol_cursor + payload_cw_len <= symbols.size() && payload_decoder.needs_more()) {
                     std::vector<uint16_t> block(symbols.begin() + symbol_cursor,
                                                 symbols.begin() + symbol_cursor + payload_cw_len);
                     std::size_t consumed_block = 0;
@@ -2548,12 +1269,11 @@ int main(int argc, char** argv)
                     std::vector<uint8_t> nibs;
                     std::vector<uint8_t> codewords;
                     if (options.soft && symbol_cursor + payload_cw_len <= symbol_llrs.size()) {
-                        std::vector<host_sim::SymbolLLR> block_llrs(
-                            symbol_llrs.begin() + symbol_cursor,
-                            symbol_llrs.begin() + symbol_cursor + payload_cw_len);
-                        nibs = host_sim::soft_decode_block(
-                            block_llrs, metadata->sf, active_cr,
-                            false, metadata->ldro, consumed_block);
+                        uint8_t soft_nibs[host_sim::kMaxSoftBits];
+                        const std::size_t n_nibs = host_sim::soft_decode_block(
+                            symbol_llrs.data() + symbol_cursor, symbol_llrs.size() - symbol_cursor,
+                            metadata->sf, active_cr, false, metadata->ldro, soft_nibs, consumed_block);
+                        nibs.assign(soft_nibs, soft_nibs + n_nibs);
                         // Hard deinterleave for stage outputs
                         codewords = host_sim::deinterleave(block, payload_cfg, consumed_block);
                     } else {
@@ -2568,7 +1288,7 @@ int main(int argc, char** argv)
                     if (!suppress_payload_stage) {
                         append_fft_gray(block, false, metadata->ldro, metadata->sf, stage_outputs);
                     }
-                    payload_nibbles.insert(payload_nibbles.end(), nibs.begin(), nibs.end());
+                    payload_decoder.push_nibbles(nibs.data(), nibs.size());
                     if (!suppress_payload_stage) {
                         for (auto cw : codewords) {
                             stage_outputs.deinterleaver.push_back(static_cast<uint16_t>(cw));
@@ -2579,38 +1299,10 @@ int main(int argc, char** argv)
                     }
                 }
 
-                // Dewhiten nibbles first, then pack into bytes (matching GNU Radio's approach)
-                // In gr-lora_sdr dewhitening_impl.cc:
-                //   low_nib = in[2*i] ^ (whitening_seq[offset] & 0x0F);
-                //   high_nib = in[2*i+1] ^ (whitening_seq[offset] >> 4);
-                //   byte = high_nib << 4 | low_nib;
-                // Note: nibble order is: [0]=low_nib, [1]=high_nib
-                host_sim::WhiteningSequencer seq;
-                auto whitening = seq.sequence(payload_nibbles.size() / 2);
-                
-                std::vector<uint8_t> unwhitened;
-                unwhitened.reserve(payload_nibbles.size() / 2);
-                for (std::size_t i = 0; i + 1 < payload_nibbles.size(); i += 2) {
-                    std::size_t byte_idx = i / 2;
-                    // GNU Radio convention: first nibble is low_nib, second is high_nib
-                    // Note: CRC bytes are NOT dewhitened (matching GNU Radio behavior)
-                    uint8_t low_nib, high_nib;
-                    if (byte_idx < static_cast<std::size_t>(expected_payload_len)) {
-                        // Payload bytes: apply dewhitening
-                        uint8_t w = (byte_idx < whitening.size()) ? whitening[byte_idx] : 0;
-                        low_nib = (payload_nibbles[i] & 0xF) ^ (w & 0x0F);
-                        high_nib = (payload_nibbles[i + 1] & 0xF) ^ ((w >> 4) & 0x0F);
-                    } else {
-                        // CRC bytes: no dewhitening
-                        low_nib = (payload_nibbles[i] & 0xF);
-                        high_nib = (payload_nibbles[i + 1] & 0xF);
-                    }
-                    uint8_t byte = static_cast<uint8_t>((high_nib << 4) | low_nib);
-                    unwhitened.push_back(byte);
-                }
-                if (unwhitened.size() > static_cast<std::size_t>(expected_payload_len) + (expected_crc ? 2u : 0u)) {
-                    unwhitened.resize(static_cast<std::size_t>(expected_payload_len) + (expected_crc ? 2u : 0u));
-                }
+                // Dewhitened payload bytes followed by the CRC bytes, which
+                // are not whitened (gr-lora_sdr dewhitening_impl.cc: low
+                // nibble first, each XORed with its half of the sequence).
+                const std::span<const uint8_t> unwhitened = payload_decoder.bytes();
                 std::cout << "Payload bytes (dewhitened):";
                 for (std::size_t i = 0; i < std::min<std::size_t>(unwhitened.size(), static_cast<std::size_t>(expected_payload_len)); ++i) {
                     std::cout << ' ' << std::hex << std::setw(2) << std::setfill('0')
@@ -2668,23 +1360,12 @@ int main(int argc, char** argv)
                     }
                 }
 
-                if (expected_crc && expected_payload_len >= 2 && unwhitened.size() >= static_cast<std::size_t>(expected_payload_len) + 2) {
-                    // GNU Radio CRC verification algorithm:
-                    // 1. Compute CRC on first (payload_len - 2) bytes
-                    // 2. XOR with last 2 payload bytes
-                    // 3. Compare with received CRC (little-endian)
-                    std::vector<uint8_t> crc_data(unwhitened.begin(),
-                                                  unwhitened.begin() + expected_payload_len - 2);
-                    uint16_t computed_crc = compute_raw_crc16(crc_data);
-                    // XOR with last 2 payload bytes
-                    if (expected_payload_len >= 2) {
-                        computed_crc ^= unwhitened[expected_payload_len - 1];  // last byte
-                        computed_crc ^= static_cast<uint16_t>(unwhitened[expected_payload_len - 2]) << 8;  // second-to-last byte
-                    }
-                    const uint8_t crc_byte0 = unwhitened[expected_payload_len];
-                    const uint8_t crc_byte1 = unwhitened[expected_payload_len + 1];
-                    const uint16_t decoded_crc = static_cast<uint16_t>(crc_byte0) |
-                                                 (static_cast<uint16_t>(crc_byte1) << 8);
+                if (payload_decoder.crc_checked()) {
+                    // GNU Radio CRC verification: CRC-16 of the first
+                    // (payload_len - 2) bytes, XORed with the last 2 payload
+                    // bytes, against the received CRC (little-endian).
+                    const uint16_t computed_crc = payload_decoder.crc_computed();
+                    const uint16_t decoded_crc = payload_decoder.crc_received();
                     const bool crc_ok = (computed_crc == decoded_crc);
                     std::cout << "[payload] CRC decoded=0x" << std::hex << std::setw(4)
                               << std::setfill('0') << decoded_crc
@@ -2716,16 +1397,25 @@ int main(int argc, char** argv)
                     if (base.extension() == ".cf32") {
                         base.replace_extension("");
                     }
-                    auto dump_stage_file = [&](const char* suffix,
+                    auto dump_stage_file = [&](const char* stage,
                                                const auto& host_vec) {
                         std::filesystem::path path = base;
-                        path += suffix;
-                        write_stage_file(path, host_vec);
+                        path += std::string("_") + stage;
+                        if (options.stage_format == Options::StageFormat::text) {
+                            path += ".txt";
+                            write_stage_file(path, host_vec);
+                        } else {
+                            path += ".stage";
+                            write_stage_dump(path, host_vec,
+                                             options.stage_format == Options::StageFormat::delta
+                                                 ? host_sim::lora_replay::StageEncoding::delta_varint
+                                                 : host_sim::lora_replay::StageEncoding::raw);
+                        }
                     };
-                    dump_stage_file("_fft.txt", stage_outputs.fft);
-                    dump_stage_file("_gray.txt", stage_outputs.gray);
-                    dump_stage_file("_deinterleaver.txt", stage_outputs.deinterleaver);
-                    dump_stage_file("_hamming.txt", stage_outputs.hamming);
+                    dump_stage_file("fft", stage_outputs.fft);
+                    dump_stage_file("gray", stage_outputs.gray);
+                    dump_stage_file("deinterleaver", stage_outputs.deinterleaver);
+                    dump_stage_file("hamming", stage_outputs.hamming);
                     std::cout << "Dumped stage outputs using prefix " << base.generic_string() << "\n";
                 }
 
@@ -2796,7 +1486,7 @@ int main(int argc, char** argv)
                     }
                     std::cout << ci_line.str() << "\n";
                 }
-                if (options.summary_output) {
+                if (options.summary_output && !options.realtime) {
                     auto instrumentation = run_scheduler_instrumentation(
                         samples,
                         *metadata,
@@ -2805,19 +1495,64 @@ int main(int argc, char** argv)
                     summary.stage_timings_ns = std::move(instrumentation.stage_timings_ns);
                     summary.memory_usage_bytes = std::move(instrumentation.symbol_memory_bytes);
                 }
+                if (options.realtime) {
+                    const auto instrumentation = run_scheduler_instrumentation(
+                        samples, *metadata, alignment_samples, 256, true);
+                    const auto& rt = *instrumentation.realtime;
+                    const double n = rt.symbols > 0 ? static_cast<double>(rt.symbols) : 1.0;
+                    summary.realtime_mode = true;
+                    summary.rt_symbol_period_ns = rt.symbol_period_ns;
+                    summary.rt_avg_start_lag_ns = rt.sum_start_lag_ns / n;
+                    summary.rt_max_start_lag_ns = rt.max_start_lag_ns;
+                    summary.rt_avg_deadline_margin_ns = rt.sum_margin_ns / n;
+                    summary.rt_min_deadline_margin_ns = rt.min_margin_ns;
+                    summary.rt_overrun_count = rt.overruns;
+                    summary.rt_underrun_count = rt.underruns;
+                    summary.deadline_miss_count = rt.overruns;
+                    summary.min_deadline_margin_ns = rt.min_margin_ns;
+                    const auto events = [](const auto& from, std::size_t count) {
+                        std::vector<SummaryReport::RealTimeEvent> out;
+                        for (std::size_t i = 0; i < std::min(count, from.size()); ++i) {
+                            out.push_back({from[i].symbol_index, from[i].timestamp_ns, from[i].delta_ns});
+                        }
+                        return out;
+                    };
+                    summary.rt_overrun_events = events(rt.overrun_events, rt.overruns);
+                    summary.rt_underrun_events = events(rt.underrun_events, rt.underruns);
+                    summary.rt_capacity = rt.capacity(true);
+                    std::cout << "[realtime] " << rt.symbols << " symbols, period "
+                              << std::fixed << std::setprecision(1) << rt.symbol_period_ns / 1e3
+                              << " us, " << rt.overruns << " overrun(s), " << rt.underruns
+                              << " underrun(s), min margin " << rt.min_margin_ns / 1e3
+                              << " us, capacity " << rt.capacity(true) << "x real time\n"
+                              << std::defaultfloat << std::setprecision(6);
+                }
             } // end if (header.success)
 
+            // Estimate burst end: data start + consumed symbols.
+            // data_start_sample is updated by successful re-demod
+            // to track alignment + sync_pos + quarter offset.
+            const std::size_t symbols_consumed =
+                header.success ? symbol_cursor : symbols.size();
+            const std::size_t effective_start =
+                header.success ? data_start_sample : alignment_samples;
+            const std::size_t burst_end_sample = effective_start +
+                symbols_consumed * static_cast<std::size_t>(sps);
+            if (options.write_index) {
+                // Grid-path headers leave data_start_sample unset; the
+                // cursor then counts symbols from the alignment.
+                const std::size_t packet_end = std::min(
+                    std::max(burst_end_sample,
+                             alignment_samples + symbols_consumed * static_cast<std::size_t>(sps)) +
+                        static_cast<std::size_t>(sps) * 4,
+                    samples.size());
+                acquired.length = std::max<std::size_t>(packet_end, alignment_samples + 1) - burst_offset;
+                acquired.header_ok = header.success;
+                written_index.bursts.push_back(acquired);
+            }
+
             // --- multi-packet loop advance ---
             if (options.multi_packet) {
-                // Estimate burst end: data start + consumed symbols.
-                // data_start_sample is updated by successful re-demod
-                // to track alignment + sync_pos + quarter offset.
-                const std::size_t symbols_consumed =
-                    header.success ? symbol_cursor : symbols.size();
-                const std::size_t effective_start =
-                    header.success ? data_start_sample : alignment_samples;
-                const std::size_t burst_end_sample = effective_start +
-                    symbols_consumed * static_cast<std::size_t>(sps);
                 // Advance past this burst with a small gap margin
                 const std::size_t next_offset = burst_end_sample + static_cast<std::size_t>(sps) * 4;
                 // If we didn't advance (e.g., no symbols decoded), skip one symbol period
@@ -2836,6 +1571,11 @@ int main(int argc, char** argv)
             }
             break; // single-packet mode: done
           } // end multi-packet loop
+            if (options.write_index) {
+                write_burst_index(*options.write_index, written_index);
+                std::cout << "[index] wrote " << written_index.bursts.size() << " burst(s) to "
+                          << options.write_index->string() << "\n";
+            }
             summary.stage_mismatches = total_stage_mismatches;
         }
 
@@ -2883,6 +1623,9 @@ int main(int argc, char** argv)
         summary.stage_mismatches = total_stage_mismatches;
         summary.reference_mismatches = reference_mismatches;
         if (options.summary_output) {
+            if (host_sim::trace::enabled()) {
+                summary.trace_counters = host_sim::trace::counter_list();
+            }
             write_summary_json(*options.summary_output, summary);
             std::cout << "Wrote summary to " << options.summary_output->generic_string() << "\n";
         }
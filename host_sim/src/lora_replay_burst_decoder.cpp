@@ -0,0 +1,996 @@
+#include "host_sim/lora_replay/burst_decoder.hpp"
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/candidate_search.hpp"
+#include "host_sim/crc16.hpp"
+#include "host_sim/decode_phase.hpp"
+#include "host_sim/deinterleaver.hpp"
+#include "host_sim/hamming.hpp"
+#include "host_sim/header_locator.hpp"
+#include "host_sim/payload_decoder.hpp"
+#include "host_sim/polyphase_samples.hpp"
+#include "host_sim/resampler.hpp"
+#include "host_sim/symbol_timing.hpp"
+#include "host_sim/trace.hpp"
+#include "host_sim/window_cache.hpp"
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <optional>
+#include <sstream>
+#include <string_view>
+
+namespace host_sim::lora_replay
+{
+
+namespace
+{
+
+// Preamble-grid symbols demodulated past the nominal preamble before the
+// header search: sync word and SFD (4.25), up to two header blocks (16)
+// and slack for a preamble longer than announced.
+constexpr std::size_t kGridProbeSymbols = 32;
+
+// Header-block trace on stdout; a build option (-DHOST_SIM_DEBUG_HEADER=ON)
+// so the candidate scans pay nothing for it in normal builds.
+#ifdef HOST_SIM_DEBUG_HEADER
+constexpr bool kDebugHeader = true;
+#else
+constexpr bool kDebugHeader = false;
+#endif
+
+// Result of one OS=2 fallback candidate, written only by the probe that
+// owns it; redemod_at_os2() reads the winner after the search.  Candidates
+// run on pool workers, so these stay on the default resource.
+struct Os2Attempt
+{
+    bool header_hit{false};
+    HeaderDecodeResult header;
+    std::pmr::vector<uint16_t> symbols;
+    std::pmr::vector<host_sim::SoftSymbol> llrs;
+    std::size_t data_sample{0};
+    std::string log;
+};
+
+// The header at the start of `symbols` as the fallback passes take it:
+// the implicit stand-in, or an explicit header agreeing with `meta` on
+// every field it announces.
+HeaderDecodeResult fallback_header(std::span<const uint16_t> symbols,
+                                   const host_sim::LoRaMetadata& meta,
+                                   std::pmr::memory_resource* memory)
+{
+    if (meta.implicit_header) {
+        return implicit_header(symbols, meta, memory);
+    }
+    HeaderDecodeResult hdr = try_decode_header(symbols, 0, meta, memory);
+    if (!hdr.success) return hdr;
+    const int hlen = hdr.payload_len > 0 ? hdr.payload_len : meta.payload_len;
+    const int hcr = hdr.cr > 0 ? hdr.cr : meta.cr;
+    if ((meta.payload_len > 0 && hlen != meta.payload_len) || (meta.cr > 0 && hcr != meta.cr) ||
+        (meta.has_crc && !hdr.has_crc)) {
+        hdr.success = false;
+    }
+    return hdr;
+}
+
+} // namespace
+
+uint16_t compute_raw_crc16(const std::vector<uint8_t>& payload)
+{
+    return host_sim::crc16_ccitt(payload.data(), payload.size());
+}
+
+HeaderDecodeResult try_decode_header(std::span<const uint16_t> symbols,
+                                     std::size_t start,
+                                     const host_sim::LoRaMetadata& meta,
+                                     std::pmr::memory_resource* memory)
+{
+    HeaderDecodeResult result(memory);
+    if (start + 8 > symbols.size()) {
+        return result;
+    }
+    HOST_SIM_TRACE_COUNT(header_attempts, 1);
+
+    host_sim::DeinterleaverConfig header_cfg{meta.sf, 4, true, meta.ldro};
+    const int block_symbols = 8;
+    std::size_t cursor = start;
+    std::size_t total_consumed = 0;
+    // Every SF fills the five header nibbles within two blocks.
+    std::pmr::vector<uint8_t> header_nibbles(memory);
+    std::pmr::vector<uint16_t> header_codewords(memory);
+    header_nibbles.reserve(2 * host_sim::kMaxInterleaverRows);
+    header_codewords.reserve(2 * host_sim::kMaxInterleaverRows);
+    while (header_nibbles.size() < 5 && cursor + block_symbols <= symbols.size()) {
+        const std::span<const uint16_t> header_input = symbols.subspan(cursor, block_symbols);
+        if constexpr (kDebugHeader) {
+            std::cout << "Header symbols (start=" << cursor << "):";
+            for (auto value : header_input) {
+                std::cout << ' ' << value;
+            }
+            std::cout << "\n";
+        }
+
+        uint8_t codewords[host_sim::kMaxInterleaverRows];
+        const std::size_t n_codewords =
+            host_sim::deinterleave_block(header_input.data(), header_input.size(), header_cfg, codewords);
+        total_consumed += block_symbols;
+        cursor += block_symbols;
+        header_codewords.insert(header_codewords.end(), codewords, codewords + n_codewords);
+
+        if constexpr (kDebugHeader) {
+            std::cout << "Deinterleaved codewords:";
+            for (std::size_t i = 0; i < n_codewords; ++i) {
+                std::cout << ' ' << std::hex << static_cast<int>(codewords[i]) << std::dec;
+            }
+            std::cout << "\n";
+        }
+
+        const std::size_t first_nibble = header_nibbles.size();
+        header_nibbles.resize(first_nibble + n_codewords);
+        host_sim::hamming_decode_block(codewords, n_codewords, true, 4, header_nibbles.data() + first_nibble);
+        if constexpr (kDebugHeader) {
+            std::cout << "Header nibbles:";
+            for (std::size_t i = first_nibble; i < header_nibbles.size(); ++i) {
+                std::cout << ' ' << std::hex << static_cast<int>(header_nibbles[i] & 0xF) << std::dec;
+            }
+            std::cout << "\n";
+        }
+    }
+
+    if (header_nibbles.size() < 5) {
+        result.codewords = std::move(header_codewords);
+        result.nibbles = header_nibbles;
+        result.consumed_symbols = total_consumed;
+        return result;
+    }
+
+    const int n0 = header_nibbles[0] & 0xF;
+    const int n1 = header_nibbles[1] & 0xF;
+    const int n2 = header_nibbles[2] & 0xF;
+    const int n3 = header_nibbles[3] & 0xF;
+    const int n4 = header_nibbles[4] & 0xF;
+
+    const int payload_len = (n0 << 4) | n1;
+    const bool has_crc = (n2 & 0x1) != 0;
+    const int cr = (n2 >> 1) & 0x7;
+    const int header_chk = ((n3 & 0x1) << 4) | n4;
+
+    const int computed_checksum = host_sim::header_checksum(n0, n1, n2);
+
+    result.checksum_field = header_chk;
+    result.checksum_computed = computed_checksum;
+
+    // The 5-bit checksum passes one false lock in 32; a coding rate outside
+    // 4/5..4/8 is never valid and would make the payload deinterleaver throw.
+    if (payload_len <= 0 || cr < 1 || cr > 4 || header_chk != computed_checksum) {
+        result.nibbles = header_nibbles;
+        result.payload_len = payload_len;
+        result.has_crc = has_crc;
+        result.cr = cr;
+        return result;
+    }
+
+    result.success = true;
+    result.payload_len = payload_len;
+    result.has_crc = has_crc;
+    result.cr = cr;
+    result.checksum_field = header_chk;
+    result.checksum_computed = computed_checksum;
+    result.consumed_symbols = total_consumed;
+    result.codewords = std::move(header_codewords);
+    result.nibbles = std::move(header_nibbles);
+    return result;
+}
+
+HeaderDecodeResult implicit_header(std::span<const uint16_t> symbols,
+                                   const host_sim::LoRaMetadata& meta,
+                                   std::pmr::memory_resource* memory)
+{
+    HeaderDecodeResult imp(memory);
+    const std::size_t hdr_syms_cnt = std::min<std::size_t>(8, symbols.size());
+    const host_sim::DeinterleaverConfig hdr_cfg{meta.sf, 4, true, meta.ldro};
+    uint8_t codewords[host_sim::kMaxInterleaverRows];
+    const std::size_t n_codewords = host_sim::deinterleave_block(symbols.data(), hdr_syms_cnt, hdr_cfg, codewords);
+    imp.success = true;
+    imp.payload_len = meta.payload_len;
+    imp.cr = meta.cr;
+    imp.has_crc = meta.has_crc;
+    imp.checksum_field = -1;
+    imp.checksum_computed = -1;
+    imp.consumed_symbols = 8;
+    imp.codewords.assign(codewords, codewords + n_codewords);
+    imp.nibbles.assign(5 + n_codewords, 0);
+    host_sim::hamming_decode_block(codewords, n_codewords, true, 4, imp.nibbles.data() + 5);
+    return imp;
+}
+
+void upsample_2x(const std::complex<float>* data, std::size_t count, std::vector<std::complex<float>>& out)
+{
+    out.resize(count == 0 ? 0 : count * 2 - 1);
+    if (count == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        out[2 * i] = data[i];
+        out[2 * i + 1] = 0.5f * (data[i] + data[i + 1]);
+    }
+    out[2 * (count - 1)] = data[count - 1];
+}
+
+bool probe_payload_crc(std::span<const uint16_t> symbols,
+                       const HeaderDecodeResult& hdr,
+                       const host_sim::LoRaMetadata& meta)
+{
+    if (!hdr.success) return false;
+    const int pl = hdr.payload_len > 0 ? hdr.payload_len : meta.payload_len;
+    const int cr = hdr.cr > 0 ? hdr.cr : meta.cr;
+    const bool has_crc = hdr.has_crc || meta.has_crc;
+    if (!has_crc || pl < 3) return false;
+    HOST_SIM_TRACE_SPAN("crc_probe");
+    HOST_SIM_TRACE_COUNT(crc_probes, 1);
+
+    // No early abort (max_uncorrectable = -1): at low SNR a candidate with
+    // several flagged codewords still passes its CRC now and then, and the
+    // probe's cost is the re-demodulation before it, not this decode.
+    host_sim::PayloadDecoder decoder({meta.sf, cr, meta.ldro, pl, true, -1});
+    if (hdr.nibbles.size() > 5) {
+        decoder.push_nibbles(hdr.nibbles.data() + 5, hdr.nibbles.size() - 5);
+    }
+    std::size_t cursor = hdr.consumed_symbols > 0 ? hdr.consumed_symbols : 8;
+    while (decoder.needs_more() && cursor < symbols.size()) {
+        const std::size_t consumed = decoder.push_block(symbols.data() + cursor, symbols.size() - cursor);
+        if (consumed == 0) break;
+        cursor += consumed;
+    }
+    return decoder.crc_ok();
+}
+
+const char* decode_path_name(DecodePath path)
+{
+    switch (path) {
+    case DecodePath::none: return "none";
+    case DecodePath::grid: return "grid";
+    case DecodePath::sfd_redemod: return "sfd_redemod";
+    case DecodePath::os2: return "os2";
+    case DecodePath::count: break;
+    }
+    return "?";
+}
+
+const char* decode_effort_name(DecodeEffort effort)
+{
+    switch (effort) {
+    case DecodeEffort::fast: return "fast";
+    case DecodeEffort::standard: return "standard";
+    case DecodeEffort::exhaustive: return "exhaustive";
+    }
+    return "?";
+}
+
+std::vector<int> os2_sfo_candidates()
+{
+    std::vector<int> candidates;
+    for (int sfo = 0; std::abs(sfo) <= 100; sfo = sfo >= 0 ? -sfo - 10 : -sfo) {
+        candidates.push_back(sfo);
+    }
+    return candidates;
+}
+
+// Below this oversampling the taps are close enough that the gather is
+// cheaper than the split.
+constexpr int kPolyphaseMinOs = 8;
+
+bool use_polyphase_planes(int os)
+{
+    static const char* forced = std::getenv("HOST_SIM_SAMPLE_LAYOUT");
+    if (forced != nullptr && std::string_view(forced) == "interleaved") {
+        return false;
+    }
+    if (forced != nullptr && std::string_view(forced) == "split") {
+        return true;
+    }
+    return os >= kPolyphaseMinOs;
+}
+
+void demodulate_span(const host_sim::FftDemodulator& demod,
+                     std::span<const std::complex<float>> burst,
+                     const host_sim::PolyphaseSamples* planes,
+                     std::size_t offset,
+                     double stride,
+                     std::size_t max_symbols,
+                     const host_sim::LoRaMetadata& meta,
+                     std::pmr::vector<uint16_t>& symbols,
+                     std::pmr::vector<host_sim::SoftSymbol>* llrs,
+                     std::size_t first_index)
+{
+    HOST_SIM_TRACE_SPAN("demod/grid");
+    HOST_SIM_TRACE_COUNT(demod_passes, 1);
+    const std::size_t count = std::min(max_symbols, demod.block_capacity(burst.size() - offset, stride));
+    const std::size_t base = symbols.size();
+    symbols.resize(base + count);
+    std::pmr::vector<float> mags(symbols.get_allocator().resource());
+    if (llrs) {
+        mags.resize(count << meta.sf);
+        llrs->reserve(llrs->size() + count);
+    }
+    if (planes) {
+        demod.demodulate_block(*planes, offset, count, stride, symbols.data() + base, nullptr,
+                               llrs ? mags.data() : nullptr);
+    } else {
+        demod.demodulate_block(burst.data() + offset, count, stride, symbols.data() + base, nullptr,
+                               llrs ? mags.data() : nullptr);
+    }
+    if (llrs) {
+        for (std::size_t i = 0; i < count; ++i) {
+            llrs->push_back(host_sim::compute_soft_symbol(
+                mags.data() + (i << meta.sf), meta.sf, (first_index + i < 8) || meta.ldro,
+                demod.current_cfo_int()));
+        }
+    }
+}
+
+void conclude_payload(const host_sim::PayloadDecoder& decoder,
+                      int payload_len,
+                      const Options& options,
+                      StreamDecodeResult& result,
+                      std::ostream& out)
+{
+    // Dewhitened payload bytes, then the CRC bytes as received
+    // (gr-lora_sdr dewhitening convention)
+    const std::span<const uint8_t> dewhitened = decoder.bytes();
+    result.payload.assign(dewhitened.begin(),
+                          dewhitened.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(
+                              dewhitened.size(), static_cast<std::size_t>(payload_len))));
+
+    // Print payload
+    out << "Payload bytes (dewhitened):";
+    for (std::size_t i = 0;
+         i < std::min<std::size_t>(dewhitened.size(),
+                                    static_cast<std::size_t>(payload_len));
+         ++i) {
+        out << ' ' << std::hex << std::setw(2)
+            << std::setfill('0')
+            << static_cast<int>(dewhitened[i]);
+    }
+    out << std::dec << "\n";
+
+    // ASCII
+    out << "Payload ASCII: ";
+    for (std::size_t i = 0;
+         i < std::min<std::size_t>(dewhitened.size(),
+                                    static_cast<std::size_t>(payload_len));
+         ++i) {
+        const char c = static_cast<char>(dewhitened[i]);
+        out << (std::isprint(static_cast<unsigned char>(c)) ? c : '.');
+    }
+    out << "\n";
+
+    // CRC check — GNU Radio convention:
+    // 1. CRC-16/CCITT on first payload_len-2 bytes
+    // 2. XOR with last 2 payload bytes
+    if (decoder.crc_checked()) {
+        const uint16_t crc = decoder.crc_computed();
+        const uint16_t decoded_crc = decoder.crc_received();
+        const bool ok = (decoded_crc == crc);
+        result.crc_ok = ok;
+        out << "[payload] CRC decoded=0x" << std::hex
+            << std::setw(4) << std::setfill('0')
+            << decoded_crc << " computed=0x"
+            << std::setw(4) << std::setfill('0') << crc
+            << std::dec << (ok ? " OK" : " MISMATCH")
+            << "\n";
+        if (!ok && !options.payload.empty()) {
+            result.payload_failure = true;
+        }
+    }
+
+    // BER: compare payload against expected (--payload)
+    if (!options.payload.empty()) {
+        const auto& ref = options.payload;
+        const int cmp_len = std::min(
+            static_cast<int>(ref.size()), payload_len);
+        for (int b = 0; b < cmp_len; ++b) {
+            uint8_t diff = dewhitened[b] ^
+                           static_cast<uint8_t>(ref[b]);
+            result.bit_errors += __builtin_popcount(diff);
+        }
+        result.total_bits += cmp_len * 8;
+
+        // Byte-exact payload verification
+        bool match = (static_cast<int>(ref.size()) == payload_len);
+        if (match) {
+            for (int b = 0; b < payload_len; ++b) {
+                if (dewhitened[b] != static_cast<uint8_t>(ref[b])) {
+                    match = false;
+                    break;
+                }
+            }
+        }
+        if (!match) {
+            result.payload_failure = true;
+            result.payload_mismatch = true;
+        }
+    }
+}
+
+PreambleLock lock_preamble(std::span<const std::complex<float>> burst_samples,
+                           host_sim::FftDemodulator& demod,
+                           const host_sim::LoRaMetadata& metadata,
+                           std::ostream& out,
+                           std::pmr::memory_resource* memory)
+{
+    PreambleLock lock;
+    const int sps = demod.samples_per_symbol();
+    const int os = demod.oversample_factor();
+
+    // Alignment
+    std::size_t alignment_offset = 0;
+    int detected_preamble_bin = 0;
+    host_sim::PreambleSpectra preamble_spectra(memory);
+    {
+        const host_sim::PhaseScope phase(host_sim::DecodePhase::alignment);
+        auto pr = host_sim::find_symbol_alignment_cfo_aware(
+            burst_samples, demod, metadata.preamble_len, &preamble_spectra,
+            host_sim::FineScanMode::automatic, memory);
+        alignment_offset = pr.alignment_offset;
+        detected_preamble_bin = pr.preamble_bin;
+    }
+
+    // CFO estimation
+    float estimated_sfo = 0.0f;
+    {
+        const host_sim::PhaseScope phase(host_sim::DecodePhase::cfo_sfo);
+        const int avail_pream_sym = static_cast<int>(std::min<std::size_t>(
+            (burst_samples.size() > alignment_offset
+                 ? (burst_samples.size() - alignment_offset) / static_cast<std::size_t>(sps)
+                 : 0),
+            static_cast<std::size_t>(INT_MAX)));
+        const int pream_to_use = std::min(std::max(metadata.preamble_len - 1, 0), avail_pream_sym);
+        if (pream_to_use > 0) {
+            // Reuse the alignment's preamble FFTs when it kept them.
+            const auto spectra = preamble_spectra.first(alignment_offset, pream_to_use);
+            auto freq_est = spectra.empty()
+                ? demod.estimate_frequency_offsets(burst_samples.data() + alignment_offset, pream_to_use)
+                : demod.estimate_frequency_offsets(spectra, pream_to_use);
+            if (detected_preamble_bin != 0) {
+                const int n_bins = 1 << metadata.sf;
+                int signed_bin = detected_preamble_bin;
+                if (signed_bin > n_bins / 2) signed_bin -= n_bins;
+                if (std::abs(signed_bin) > std::abs(freq_est.cfo_int) + 2) {
+                    freq_est.cfo_int = signed_bin;
+                }
+            }
+            demod.set_frequency_offsets(freq_est.cfo_frac, freq_est.cfo_int, freq_est.sfo_slope);
+            estimated_sfo = freq_est.sfo_slope;
+
+            // Report CFO in Hz
+            {
+                const int n_bins = 1 << metadata.sf;
+                const double cfo_bins = static_cast<double>(freq_est.cfo_int) + freq_est.cfo_frac;
+                const double cfo_hz = cfo_bins * static_cast<double>(metadata.bw) / n_bins;
+                lock.cfo_hz = static_cast<float>(cfo_hz);
+                out << "CFO=" << std::fixed << std::setprecision(1) << cfo_hz
+                    << " Hz (" << std::setprecision(2) << cfo_bins << " bins)";
+                if (std::abs(freq_est.sfo_slope) > 0.001f) {
+                    out << ", SFO=" << std::setprecision(3) << freq_est.sfo_slope << " bins/sym";
+                }
+                out << "\n" << std::defaultfloat << std::setprecision(6);
+            }
+
+            // Sub-sample alignment refinement (±3 samples).
+            // At low OS, even 1–2 sample error shifts the
+            // dechirped FFT peak and flips marginal symbols.
+            if (os <= 4) {
+                HOST_SIM_TRACE_SPAN("align/subsample");
+                int best_off = 0;
+                int best_c0 = -1;
+                for (int try_off = -3; try_off <= 3; ++try_off) {
+                    if (static_cast<std::ptrdiff_t>(alignment_offset) + try_off < 0) continue;
+                    const auto try_a = static_cast<std::size_t>(
+                        static_cast<std::ptrdiff_t>(alignment_offset) + try_off);
+                    if (try_a + 8ULL * sps > burst_samples.size()) continue;
+                    demod.set_frequency_offsets(freq_est.cfo_frac,
+                                                freq_est.cfo_int,
+                                                freq_est.sfo_slope);
+                    demod.reset_symbol_counter();
+                    int c0 = 0;
+                    for (int p = 0; p < std::min(pream_to_use, 8); ++p) {
+                        uint16_t v = demod.demodulate(
+                            &burst_samples[try_a +
+                                           static_cast<std::size_t>(p) * sps]);
+                        if (v == 0) ++c0;
+                    }
+                    if (c0 > best_c0) { best_c0 = c0; best_off = try_off; }
+                }
+                if (best_off != 0) {
+                    alignment_offset = static_cast<std::size_t>(
+                        static_cast<std::ptrdiff_t>(alignment_offset) + best_off);
+                }
+            }
+        }
+    }
+    lock.alignment_offset = alignment_offset;
+    lock.sfo = estimated_sfo;
+    return lock;
+}
+
+FallbackBudget::FallbackBudget(DecodeEffort effort, double budget_ms)
+    : effort_(effort),
+      limited_(budget_ms > 0.0),
+      deadline_(std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double, std::milli>(budget_ms)))
+{
+}
+
+bool FallbackBudget::exhausted()
+{
+    if (!limited_) return false;
+    if (exhausted_.load(std::memory_order_relaxed)) return true;
+    if (std::chrono::steady_clock::now() < deadline_) return false;
+    exhausted_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+FallbackDecode redemod_from_sfd(host_sim::FftDemodulator& demod,
+                                std::span<const std::complex<float>> burst,
+                                const host_sim::PolyphaseSamples* planes,
+                                std::size_t alignment_offset,
+                                std::size_t sync_pos,
+                                double stride,
+                                const host_sim::LoRaMetadata& meta,
+                                bool soft,
+                                FallbackBudget& budget,
+                                std::ostream& out,
+                                std::pmr::memory_resource* memory)
+{
+    FallbackDecode result(memory);
+    const int sps = demod.samples_per_symbol();
+    const int max_adj = std::max(demod.oversample_factor(), 4) + 2;
+    const float cfo_frac = demod.current_cfo_frac();
+    const int cfo_int = demod.current_cfo_int();
+    const std::size_t quarter = static_cast<std::size_t>(sps / 4);
+
+    for (int qoff : {1, 0, 2, 3}) {
+        if (qoff != 1) {
+            if (budget.effort() == DecodeEffort::fast || budget.exhausted()) break;
+            budget.escalate(DecodeEffort::standard);
+        }
+        const std::size_t data_sample =
+            alignment_offset + sync_pos * static_cast<std::size_t>(sps) + static_cast<std::size_t>(qoff) * quarter;
+        if (data_sample + 8ULL * sps > burst.size()) continue;
+
+        // The SFO goes into the window stride; the demod's phase-domain
+        // SFO correction stays off (sfo_slope = 0).
+        demod.set_frequency_offsets(cfo_frac, cfo_int, 0.0f);
+        demod.reset_symbol_counter();
+        std::pmr::vector<uint16_t> redemod(memory);
+        std::pmr::vector<host_sim::SoftSymbol> redemod_llrs(memory);
+        const std::size_t max_sym = (burst.size() - data_sample) / sps;
+        // Closed-loop symbol timing: the tracker corrects window position
+        // and stride from each symbol's residual.  Cap at 1024 symbols:
+        // enough for the longest LoRa payload (255 B, any SF/CR) without
+        // running on through the rest of a multi-packet capture.
+        host_sim::SymbolTimingTracker timing({stride, sps, meta.sf});
+        HOST_SIM_TRACE_COUNT(redemod_passes, 1);
+        host_sim::demodulate_tracked(demod, burst, data_sample, timing, std::min<std::size_t>(max_sym, 1024), meta,
+                                     redemod, soft ? &redemod_llrs : nullptr);
+
+        HeaderDecodeResult hdr = fallback_header(redemod, meta, memory);
+        if (!hdr.success) continue;
+
+        // SFO-induced drift between the preamble and the data start can
+        // shift the data symbols by a bin.  The header block survives it
+        // (it is coded at SF-2), the payload does not: sweep small timing
+        // adjustments around the data start for one that passes the CRC.
+        // Without the sweep (fast, or out of budget) the unverified header
+        // is the best there is.
+        bool crc_ok = !(hdr.has_crc || meta.has_crc) || probe_payload_crc(redemod, hdr, meta);
+        bool sweep_cut = budget.effort() == DecodeEffort::fast;
+        if (!crc_ok && !sweep_cut) {
+            budget.escalate(DecodeEffort::standard);
+            for (int adj = -1; std::abs(adj) <= max_adj; adj = adj > 0 ? -adj - 1 : -adj) {
+                if (budget.exhausted()) {
+                    sweep_cut = true;
+                    break;
+                }
+                const auto adj_data = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(data_sample) + adj);
+                if (adj_data + 8ULL * sps > burst.size()) continue;
+                demod.set_frequency_offsets(cfo_frac, cfo_int, 0.0f);
+                demod.reset_symbol_counter();
+                std::pmr::vector<uint16_t> adj_syms(memory);
+                std::pmr::vector<host_sim::SoftSymbol> adj_llrs(memory);
+                const std::size_t adj_max = (burst.size() - adj_data) / sps;
+                HOST_SIM_TRACE_COUNT(redemod_passes, 1);
+                demodulate_span(demod, burst, planes, adj_data, stride, std::min<std::size_t>(adj_max, 200), meta,
+                                adj_syms, soft ? &adj_llrs : nullptr);
+                HeaderDecodeResult adj_hdr = meta.implicit_header ? implicit_header(adj_syms, meta, memory)
+                                                                  : try_decode_header(adj_syms, 0, meta, memory);
+                if (!adj_hdr.success || !probe_payload_crc(adj_syms, adj_hdr, meta)) continue;
+                out << "SFD re-demod: " << (meta.implicit_header ? "implicit data start" : "data start")
+                    << " refined by " << adj << " samples (CRC verified)\n";
+                redemod = std::move(adj_syms);
+                redemod_llrs = std::move(adj_llrs);
+                hdr = std::move(adj_hdr);
+                crc_ok = true;
+                break;
+            }
+        }
+        // An implicit header has no checksum of its own: only the payload
+        // CRC tells the right quarter offset from a wrong one.
+        if (meta.implicit_header && !crc_ok && !sweep_cut) continue;
+
+        out << "SFD re-demod: " << (meta.implicit_header ? "implicit header" : "header found with")
+            << " quarter offset " << qoff << " (sync at symbol " << (sync_pos - 4) << ")\n";
+        result.header = std::move(hdr);
+        result.symbols = std::move(redemod);
+        result.llrs = std::move(redemod_llrs);
+        result.data_sample = data_sample;
+        return result;
+    }
+    return result;
+}
+
+FallbackDecode redemod_at_os2(std::span<const std::complex<float>> burst,
+                              std::size_t alignment_offset,
+                              std::size_t sync_pos,
+                              float cfo_frac,
+                              int cfo_int,
+                              const host_sim::LoRaMetadata& meta,
+                              bool soft,
+                              FallbackBudget& budget,
+                              std::ostream& out)
+{
+    FallbackDecode result;
+    if (budget.effort() == DecodeEffort::fast || budget.exhausted()) return result;
+    HOST_SIM_TRACE_SPAN("fallback/os2");
+    budget.escalate(budget.effort());
+
+    // The OS=2 grid is virtual: windows are resampled from the native-rate
+    // burst only when a candidate visits them.
+    const host_sim::FarrowResampler os2_source(burst.subspan(alignment_offset));
+    const int sps_os2 = 2 << meta.sf;
+    const std::size_t quarter_os2 = static_cast<std::size_t>(sps_os2 / 4);
+    host_sim::PerWorker<host_sim::FftDemodulator> os2_demods;
+    // Every SFO/timing candidate reads its windows through one cache:
+    // their grids share most start samples.
+    host_sim::DemodWindowCache os2_windows(os2_source, 2, meta.sf, soft);
+
+    // SFO rate compensation moves each FFT window by
+    //   drift_per_sym = sfo_ppm * sps_os2 / 1e6
+    // through the stride.  One candidate per SFO rate and quarter offset,
+    // qoff-major.  Pass 0 skips the timing refinement (fast reject of
+    // wrong SFO rates) and records header hits; pass 1 retries the hits
+    // with ±3-sample adjustments for borderline alignments.  Both passes
+    // fan the candidates out over find_first_candidate(); the winner is
+    // the first in sweep order, as with a sequential loop.
+    struct Os2Candidate
+    {
+        int qoff{1};
+        int sfo{0};
+    };
+    std::vector<Os2Candidate> candidates;
+    for (int qoff : {1, 0, 2, 3}) {
+        if (qoff != 1 && budget.effort() != DecodeEffort::exhaustive) break;
+        for (int sfo : os2_sfo_candidates()) candidates.push_back({qoff, sfo});
+    }
+
+    auto try_os2 = [&](int os2_pass, const Os2Candidate& cand, const host_sim::CandidateContext& ctx,
+                       Os2Attempt& attempt) -> bool {
+        if (budget.exhausted()) return false;
+        auto& demod_os2 = os2_demods.get(ctx.worker(), [&] {
+            return std::make_unique<host_sim::FftDemodulator>(meta.sf, meta.bw, meta.bw);
+        });
+        const double stride = static_cast<double>(sps_os2) * (1.0 - static_cast<double>(cand.sfo) * 1e-6);
+        const std::size_t data_sample = sync_pos * static_cast<std::size_t>(sps_os2) +
+                                        static_cast<std::size_t>(cand.qoff) * quarter_os2;
+        if (data_sample + 8ULL * sps_os2 > os2_windows.size()) return false;
+
+        demod_os2.set_frequency_offsets(cfo_frac, cfo_int, 0.0f);
+        std::pmr::vector<uint16_t> syms;
+        std::pmr::vector<host_sim::SoftSymbol> llrs;
+
+        // Header block first: a wrong explicit header rejects the
+        // candidate before the payload is demodulated.
+        HOST_SIM_TRACE_COUNT(redemod_passes, 1);
+        os2_windows.demodulate(demod_os2, data_sample, stride, 0, 8, meta, syms, soft ? &llrs : nullptr);
+        if (syms.size() < 8) return false;
+        HeaderDecodeResult hdr = fallback_header(syms, meta, std::pmr::get_default_resource());
+        if (!hdr.success) return false;
+
+        // Then only as far as the CRC: whole payload blocks for the
+        // nibbles and CRC after the header, and a margin.
+        const int hlen = hdr.payload_len > 0 ? hdr.payload_len : meta.payload_len;
+        const int hcr = hdr.cr > 0 ? hdr.cr : meta.cr;
+        std::size_t total_syms = 1024;
+        if (hlen > 0 && hcr > 0) {
+            const std::size_t nibbles = static_cast<std::size_t>(hlen) * 2 + 4;
+            const std::size_t cw = static_cast<std::size_t>(hcr + 4);
+            total_syms = hdr.consumed_symbols + (nibbles + cw - 1) / cw * cw + 4;
+        }
+        os2_windows.demodulate(demod_os2, data_sample, stride, syms.size(), total_syms, meta, syms,
+                               soft ? &llrs : nullptr);
+
+        std::string refine_log;
+        if ((hdr.has_crc || meta.has_crc) && !probe_payload_crc(syms, hdr, meta)) {
+            if (os2_pass == 0) {
+                attempt.header_hit = true;
+                return false;
+            }
+            bool refined = false;
+            for (int adj = -1; std::abs(adj) <= 3; adj = adj > 0 ? -adj - 1 : -adj) {
+                if (ctx.superseded() || budget.exhausted()) return false;
+                const auto adj_data = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(data_sample) + adj);
+                if (adj_data + 8ULL * sps_os2 > os2_windows.size()) continue;
+                std::pmr::vector<uint16_t> adj_syms;
+                std::pmr::vector<host_sim::SoftSymbol> adj_llrs;
+                HOST_SIM_TRACE_COUNT(redemod_passes, 1);
+                os2_windows.demodulate(demod_os2, adj_data, stride, 0, total_syms, meta, adj_syms,
+                                       soft ? &adj_llrs : nullptr);
+                HeaderDecodeResult adj_hdr =
+                    meta.implicit_header ? implicit_header(adj_syms, meta) : try_decode_header(adj_syms, 0, meta);
+                if (!adj_hdr.success || !probe_payload_crc(adj_syms, adj_hdr, meta)) continue;
+                refine_log = std::string("OS=2 upsample: ") +
+                             (meta.implicit_header ? "implicit data start" : "data start") + " refined by " +
+                             std::to_string(adj) + " samples (CRC verified)\n";
+                syms = std::move(adj_syms);
+                llrs = std::move(adj_llrs);
+                hdr = std::move(adj_hdr);
+                refined = true;
+                break;
+            }
+            // Only a CRC-valid decode replaces the native one.
+            if (!refined) return false;
+        }
+
+        attempt.log = refine_log + "OS=2 upsample: " +
+                      (meta.implicit_header ? "implicit header" : "header found with") + " quarter offset " +
+                      std::to_string(cand.qoff);
+        if (cand.sfo != 0) {
+            attempt.log += " (SFO=" + std::to_string(cand.sfo) + "ppm)";
+        }
+        attempt.log += "\n";
+        attempt.header = std::move(hdr);
+        attempt.symbols = std::move(syms);
+        attempt.llrs = std::move(llrs);
+        attempt.data_sample = data_sample;
+        return true;
+    };
+
+    std::vector<Os2Attempt> probes(candidates.size());
+    auto winner = host_sim::find_first_candidate(candidates.size(), [&](const host_sim::CandidateContext& ctx) {
+        return try_os2(0, candidates[ctx.index()], ctx, probes[ctx.index()]);
+    });
+    Os2Attempt* won = winner ? &probes[*winner] : nullptr;
+    std::vector<Os2Candidate> hits;
+    for (std::size_t c = 0; !won && c < candidates.size(); ++c) {
+        if (probes[c].header_hit) hits.push_back(candidates[c]);
+    }
+    std::vector<Os2Attempt> attempts(hits.size());
+    if (!won && !hits.empty()) {
+        winner = host_sim::find_first_candidate(hits.size(), [&](const host_sim::CandidateContext& ctx) {
+            return try_os2(1, hits[ctx.index()], ctx, attempts[ctx.index()]);
+        });
+        if (winner) won = &attempts[*winner];
+    }
+    if (won) {
+        out << won->log;
+        result.header = std::move(won->header);
+        result.symbols = std::move(won->symbols);
+        result.llrs = std::move(won->llrs);
+        result.data_sample = alignment_offset + won->data_sample / 2;
+    }
+    return result;
+}
+
+StreamDecodeResult decode_stream_burst(std::span<const std::complex<float>> burst_samples,
+                                       host_sim::FftDemodulator& demod,
+                                       const host_sim::LoRaMetadata& metadata,
+                                       const Options& options,
+                                       std::ostream& out,
+                                       std::pmr::memory_resource* memory)
+{
+    HOST_SIM_TRACE_SPAN("decode_burst");
+    HOST_SIM_TRACE_COUNT(bursts, 1);
+    StreamDecodeResult result;
+    const int sps = demod.samples_per_symbol();
+    const int os = demod.oversample_factor();
+
+    FallbackBudget budget(options.effort, options.decode_budget_ms);
+
+    const PreambleLock lock = lock_preamble(burst_samples, demod, metadata, out, memory);
+    const std::size_t alignment_offset = lock.alignment_offset;
+    const float estimated_sfo = lock.sfo;
+    result.cfo_hz = lock.cfo_hz;
+    result.preamble_offset = alignment_offset;
+    result.sfo = estimated_sfo;
+
+    // Split the burst into polyphase re/im planes once when every pass
+    // below would otherwise gather its taps os samples apart.
+    std::optional<host_sim::PolyphaseSamples> planes;
+    if (use_polyphase_planes(os)) {
+        HOST_SIM_TRACE_SPAN("demod/split");
+        planes.emplace(burst_samples, os, memory);
+    }
+    const host_sim::PolyphaseSamples* planes_ptr = planes ? &*planes : nullptr;
+
+    // Demodulate symbols — no SFO phase correction on preamble grid
+    demod.set_frequency_offsets(demod.current_cfo_frac(), demod.current_cfo_int(), 0.0f);
+    demod.reset_symbol_counter();
+    // Per-symbol CFO tracking (EMA).
+    // --cfo-track [alpha] CLI flag or HOST_SIM_CFO_TRACK_ALPHA env.
+    {
+        float alpha = options.cfo_track_alpha;
+        if (alpha == 0.0f) {
+            static const char* alpha_env = std::getenv("HOST_SIM_CFO_TRACK_ALPHA");
+            if (alpha_env) alpha = std::stof(alpha_env);
+        }
+        if (alpha > 0.0f) {
+            demod.set_cfo_tracking(alpha, 8);
+        }
+    }
+    const std::size_t max_sym =
+        (burst_samples.size() - alignment_offset) /
+        static_cast<std::size_t>(sps);
+    std::pmr::vector<uint16_t> symbols(memory);
+    std::pmr::vector<host_sim::SoftSymbol> symbol_llrs(memory);
+    symbols.reserve(max_sym);
+    if (options.soft) symbol_llrs.reserve(max_sym);
+    // The preamble grid only has to reach past the sync word and header
+    // block: the payload is demodulated once, by whichever pass locks the
+    // header — usually the tracked SFD re-demod below.  The grid covers
+    // the rest of the burst only when the header locks on it.
+    const std::size_t grid_probe = std::min<std::size_t>(
+        max_sym, static_cast<std::size_t>(std::max(metadata.preamble_len, 0)) + kGridProbeSymbols);
+    {
+        const host_sim::PhaseScope phase(host_sim::DecodePhase::demod);
+        demodulate_span(demod, burst_samples, planes_ptr, alignment_offset,
+                        static_cast<double>(sps), grid_probe, metadata,
+                        symbols, options.soft ? &symbol_llrs : nullptr);
+    }
+
+    // Try header decode (skip grid scan at high OS)
+    HeaderDecodeResult header(memory);
+    const bool skip_grid = (os > 4) || (os == 4);
+
+    if (!skip_grid && !header.success) {
+        const host_sim::PhaseScope phase(host_sim::DecodePhase::header);
+        if (const auto location = host_sim::locate_header(symbols, metadata)) {
+            header = try_decode_header(symbols, location->index, metadata, memory);
+            if (header.success) result.path = DecodePath::grid;
+        }
+        if (header.success && symbols.size() < max_sym) {
+            const host_sim::PhaseScope demod_phase(host_sim::DecodePhase::demod);
+            const std::size_t done = symbols.size() * static_cast<std::size_t>(sps);
+            demodulate_span(demod, burst_samples, planes_ptr, alignment_offset + done,
+                            static_cast<double>(sps), max_sym - symbols.size(), metadata,
+                            symbols, options.soft ? &symbol_llrs : nullptr, symbols.size());
+        }
+    }
+
+    // SFD re-demod fallback
+    if (!header.success) {
+        const host_sim::PhaseScope phase(host_sim::DecodePhase::fallback);
+        HOST_SIM_TRACE_SPAN("fallback");
+        auto sync_pos = host_sim::find_header_symbol_index(
+            symbols, 0x12, metadata.sf);
+        if (!sync_pos)
+            sync_pos = host_sim::find_header_symbol_index(
+                symbols, 0x34, metadata.sf);
+        // Implicit-header fallback: if sync word not found,
+        // estimate data start from known preamble length.
+        // Data starts at: preamble + 2 sync + 2.25 SFD ≈ preamble + 4
+        // (same formula find_header_symbol_index returns: sync_high_pos + 4)
+        if (!sync_pos && metadata.implicit_header) {
+            sync_pos = static_cast<std::size_t>(
+                metadata.preamble_len + 4);
+        }
+
+        const float saved_cfo_frac = demod.current_cfo_frac();
+        const int saved_cfo_int = demod.current_cfo_int();
+        const int N_bins = 1 << metadata.sf;
+        const double redemod_stride =
+            (estimated_sfo != 0.0f)
+                ? static_cast<double>(sps) *
+                      (1.0 - static_cast<double>(estimated_sfo) / N_bins)
+                : static_cast<double>(sps);
+
+        if (sync_pos) {
+            FallbackDecode found = redemod_from_sfd(demod, burst_samples, planes_ptr, alignment_offset, *sync_pos,
+                                                    redemod_stride, metadata, options.soft, budget, out, memory);
+            if (found.header.success) {
+                header = std::move(found.header);
+                symbols = std::move(found.symbols);
+                symbol_llrs = std::move(found.llrs);
+                result.path = DecodePath::sfd_redemod;
+            }
+        }
+
+        // ── OS=2 upsample fallback (streaming) ──────────
+        // When native-OS decode at OS=1 fails or produces
+        // CRC-invalid payload, upsample burst by 2x and
+        // retry with SFO rate compensation sweep.
+        bool need_os2 = !header.success;
+        if (!need_os2 && os == 1 && sync_pos &&
+            (header.has_crc || metadata.has_crc) &&
+            !probe_payload_crc(symbols, header, metadata)) {
+            need_os2 = true;
+        }
+        if (need_os2 && sync_pos && os == 1) {
+            FallbackDecode found = redemod_at_os2(burst_samples, alignment_offset, *sync_pos, saved_cfo_frac,
+                                                  saved_cfo_int, metadata, options.soft, budget, out);
+            if (found.header.success) {
+                header = std::move(found.header);
+                symbols = std::move(found.symbols);
+                symbol_llrs = std::move(found.llrs);
+                result.path = DecodePath::os2;
+            }
+        }
+    }
+
+    result.effort = budget.reached();
+    result.budget_exhausted = budget.was_exhausted();
+    if (result.budget_exhausted) {
+        out << "Decode budget of " << options.decode_budget_ms << " ms exhausted at "
+            << decode_effort_name(result.effort) << " effort\n";
+    }
+
+    // Payload decode
+    if (header.success) {
+        const host_sim::PhaseScope phase(host_sim::DecodePhase::payload);
+        result.header_ok = true;
+        const int payload_len = header.payload_len > 0
+                              ? header.payload_len
+                              : metadata.payload_len;
+        const int active_cr = header.cr > 0 ? header.cr : metadata.cr;
+        const bool has_crc = header.has_crc || metadata.has_crc;
+        result.crc_expected = has_crc;
+        result.cr = active_cr;
+
+        out << "Header: len=" << payload_len
+            << " cr=" << active_cr
+            << " crc=" << (has_crc ? "yes" : "no") << "\n";
+
+        // Decode data symbols block-by-block.  At SF >= 8 the header
+        // block produces SF-2 nibbles: the first 5 are header fields, the
+        // rest spill into the payload.
+        host_sim::PayloadDecoder decoder(
+            {metadata.sf, active_cr, metadata.ldro, payload_len, has_crc, -1});
+        if (header.nibbles.size() > 5) {
+            decoder.push_nibbles(header.nibbles.data() + 5, header.nibbles.size() - 5);
+        }
+        const std::size_t payload_cw_len = decoder.block_symbols();
+        std::size_t sym_cursor = header.consumed_symbols;
+        while (decoder.needs_more() && sym_cursor + payload_cw_len <= symbols.size()) {
+            if (options.soft && sym_cursor + payload_cw_len <= symbol_llrs.size()) {
+                uint8_t soft_nibs[host_sim::kMaxSoftBits];
+                std::size_t consumed = 0;
+                const std::size_t n_nibs = host_sim::soft_decode_block(
+                    symbol_llrs.data() + sym_cursor, symbol_llrs.size() - sym_cursor,
+                    metadata.sf, active_cr, false, metadata.ldro, soft_nibs, consumed);
+                if (consumed == 0) break;
+                decoder.push_nibbles(soft_nibs, n_nibs);
+                sym_cursor += consumed;
+            } else {
+                const std::size_t consumed =
+                    decoder.push_block(symbols.data() + sym_cursor, symbols.size() - sym_cursor);
+                if (consumed == 0) break;
+                sym_cursor += consumed;
+            }
+        }
+
+        conclude_payload(decoder, payload_len, options, result, out);
+    }
+    return result;
+}
+
+} // namespace host_sim::lora_replay
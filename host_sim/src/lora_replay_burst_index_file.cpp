@@ -0,0 +1,120 @@
+#include "host_sim/lora_replay/burst_index_file.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace host_sim::lora_replay
+{
+
+namespace
+{
+
+constexpr char kMagic[4] = {'L', 'B', 'I', 'X'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::uint8_t kHeaderOkFlag = 1;
+
+void append_le(std::string& out, std::uint64_t value, int width)
+{
+    for (int b = 0; b < width; ++b) {
+        out.push_back(static_cast<char>((value >> (8 * b)) & 0xFF));
+    }
+}
+
+std::uint64_t read_le(const std::string& in, std::size_t pos, int width)
+{
+    std::uint64_t value = 0;
+    for (int b = 0; b < width; ++b) {
+        value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(in[pos + b])) << (8 * b);
+    }
+    return value;
+}
+
+} // namespace
+
+std::string encode_burst_index(const BurstIndexFile& index)
+{
+    std::string bytes;
+    bytes.reserve(kBurstIndexHeaderBytes + index.bursts.size() * kBurstIndexRecordBytes);
+    bytes.append(kMagic, sizeof kMagic);
+    bytes.push_back(static_cast<char>(kVersion));
+    bytes.append(3, '\0');
+    append_le(bytes, index.capture_samples, 8);
+    append_le(bytes, index.bursts.size(), 8);
+    for (const auto& burst : index.bursts) {
+        append_le(bytes, burst.offset, 8);
+        append_le(bytes, burst.length, 8);
+        append_le(bytes, burst.alignment, 8);
+        append_le(bytes, static_cast<std::uint32_t>(burst.preamble_bin), 4);
+        append_le(bytes, static_cast<std::uint32_t>(burst.cfo_int), 4);
+        append_le(bytes, std::bit_cast<std::uint32_t>(burst.cfo_frac), 4);
+        append_le(bytes, std::bit_cast<std::uint32_t>(burst.sfo_slope), 4);
+        bytes.push_back(static_cast<char>(burst.sf));
+        bytes.push_back(static_cast<char>(burst.header_ok ? kHeaderOkFlag : 0));
+        bytes.append(2, '\0');
+    }
+    return bytes;
+}
+
+BurstIndexFile decode_burst_index(const std::string& bytes)
+{
+    const auto malformed = [](const char* why) {
+        return std::runtime_error(std::string("Malformed burst index: ") + why);
+    };
+    if (bytes.size() < kBurstIndexHeaderBytes || std::memcmp(bytes.data(), kMagic, sizeof kMagic) != 0) {
+        throw malformed("bad magic");
+    }
+    if (static_cast<std::uint8_t>(bytes[4]) != kVersion) {
+        throw malformed("unknown version");
+    }
+    BurstIndexFile index;
+    index.capture_samples = read_le(bytes, 8, 8);
+    const std::uint64_t count = read_le(bytes, 16, 8);
+    const std::size_t body = bytes.size() - kBurstIndexHeaderBytes;
+    if (count > body / kBurstIndexRecordBytes || count * kBurstIndexRecordBytes != body) {
+        throw malformed("size does not match the record count");
+    }
+    index.bursts.resize(static_cast<std::size_t>(count));
+    std::size_t pos = kBurstIndexHeaderBytes;
+    for (auto& burst : index.bursts) {
+        burst.offset = read_le(bytes, pos, 8);
+        burst.length = read_le(bytes, pos + 8, 8);
+        burst.alignment = read_le(bytes, pos + 16, 8);
+        burst.preamble_bin = static_cast<std::int32_t>(read_le(bytes, pos + 24, 4));
+        burst.cfo_int = static_cast<std::int32_t>(read_le(bytes, pos + 28, 4));
+        burst.cfo_frac = std::bit_cast<float>(static_cast<std::uint32_t>(read_le(bytes, pos + 32, 4)));
+        burst.sfo_slope = std::bit_cast<float>(static_cast<std::uint32_t>(read_le(bytes, pos + 36, 4)));
+        burst.sf = static_cast<std::uint8_t>(bytes[pos + 40]);
+        burst.header_ok = (static_cast<std::uint8_t>(bytes[pos + 41]) & kHeaderOkFlag) != 0;
+        if (burst.length == 0 || burst.offset > index.capture_samples ||
+            burst.length > index.capture_samples - burst.offset ||
+            burst.alignment >= index.capture_samples) {
+            throw malformed("burst outside the capture");
+        }
+        pos += kBurstIndexRecordBytes;
+    }
+    return index;
+}
+
+void write_burst_index(const std::filesystem::path& path, const BurstIndexFile& index)
+{
+    const auto bytes = encode_burst_index(index);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Failed to write burst index: " + path.string());
+    }
+}
+
+BurstIndexFile read_burst_index(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Unable to open burst index: " + path.string());
+    }
+    const std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    return decode_burst_index(bytes);
+}
+
+} // namespace host_sim::lora_replay
@@ -1,6 +1,7 @@
 #include "host_sim/lora_replay/header_encoder.hpp"
 
 #include "host_sim/gray.hpp"
+#include "host_sim/hamming.hpp"
 #include "host_sim/lora_replay/stage_processing.hpp"
 
 #include <algorithm>
@@ -40,28 +41,7 @@ uint16_t bits_to_uint(const std::vector<bool>& bits)
 
 uint8_t hamming_encode_header(uint8_t nibble)
 {
-    const bool d3 = ((nibble >> 3) & 0x1) != 0;
-    const bool d2 = ((nibble >> 2) & 0x1) != 0;
-    const bool d1 = ((nibble >> 1) & 0x1) != 0;
-    const bool d0 = (nibble & 0x1) != 0;
-
-    const bool b4 = d3;
-    const bool b5 = d2;
-    const bool b6 = d1;
-    const bool b7 = d0;
-
-    const bool b3 = b7 ^ b6 ^ b5;
-    const bool b2 = b6 ^ b5 ^ b4;
-    const bool b1 = b7 ^ b6 ^ b4;
-    const bool parity = b7 ^ b6 ^ b5 ^ b4 ^ b3 ^ b2 ^ b1;
-    const bool b0 = parity;
-
-    uint8_t codeword = 0;
-    const bool bits_array[8] = {b7, b6, b5, b4, b3, b2, b1, b0};
-    for (bool bit : bits_array) {
-        codeword = static_cast<uint8_t>((codeword << 1) | (bit ? 1u : 0u));
-    }
-    return codeword;
+    return hamming_encode(nibble, 4);
 }
 
 } // namespace
@@ -0,0 +1,216 @@
+#include "host_sim/lora_replay/incremental_decoder.hpp"
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/decode_phase.hpp"
+#include "host_sim/trace.hpp"
+
+#include <algorithm>
+
+namespace host_sim::lora_replay
+{
+
+namespace
+{
+
+// Preamble-grid symbols past the announced preamble within which the sync
+// word must turn up: the two sync symbols plus slack for a preamble
+// longer than announced.
+constexpr std::size_t kSyncSearchSymbols = 12;
+
+// Samples lock_preamble() reads, in symbols past the preamble.
+constexpr std::size_t kLockSymbols = 9;
+
+} // namespace
+
+IncrementalBurstDecoder::IncrementalBurstDecoder(host_sim::FftDemodulator& demod,
+                                                 const host_sim::LoRaMetadata& metadata,
+                                                 const Options& options,
+                                                 std::ostream& out,
+                                                 std::pmr::memory_resource* memory)
+    : demod_(demod),
+      metadata_(metadata),
+      options_(options),
+      out_(out),
+      memory_(memory),
+      sps_(static_cast<std::size_t>(demod.samples_per_symbol())),
+      grid_(memory),
+      symbols_(memory),
+      llrs_(memory),
+      header_(memory)
+{
+    metadata_.sf = demod.sf();
+}
+
+IncrementalBurstDecoder::Status IncrementalBurstDecoder::advance(std::span<const std::complex<float>> burst)
+{
+    HOST_SIM_TRACE_SPAN("decode_incremental");
+    if (status_ != Status::pending) {
+        return status_;
+    }
+    if (stage_ == Stage::preamble && !lock(burst)) {
+        return status_;
+    }
+    if (stage_ == Stage::sync && !find_sync(burst)) {
+        return status_;
+    }
+    if (stage_ == Stage::header) {
+        const int header_rows = std::max(metadata_.sf - 2, 1);
+        const std::size_t header_symbols =
+            metadata_.implicit_header ? 8 : 8 * static_cast<std::size_t>((5 + header_rows - 1) / header_rows);
+        if (!demodulate_to(burst, header_symbols)) {
+            return status_;
+        }
+        if (!decode_header()) {
+            return status_;
+        }
+    }
+
+    const host_sim::PhaseScope phase(host_sim::DecodePhase::payload);
+    auto& decoder = *payload_;
+    while (decoder.needs_more()) {
+        if (!demodulate_to(burst, cursor_ + decoder.block_symbols())) {
+            return status_;
+        }
+        std::size_t consumed = 0;
+        if (options_.soft) {
+            uint8_t soft_nibs[host_sim::kMaxSoftBits];
+            const std::size_t n_nibs = host_sim::soft_decode_block(
+                llrs_.data() + cursor_, llrs_.size() - cursor_, metadata_.sf, result_.cr, false, metadata_.ldro,
+                soft_nibs, consumed);
+            decoder.push_nibbles(soft_nibs, n_nibs);
+        } else {
+            consumed = decoder.push_block(symbols_.data() + cursor_, symbols_.size() - cursor_);
+        }
+        if (consumed == 0) {
+            break;
+        }
+        cursor_ += consumed;
+    }
+
+    conclude_payload(decoder, payload_len_, options_, result_, out_);
+    if (result_.crc_expected && !result_.crc_ok) {
+        return fail("payload CRC failed");
+    }
+    status_ = Status::done;
+    return status_;
+}
+
+bool IncrementalBurstDecoder::lock(std::span<const std::complex<float>> burst)
+{
+    const std::size_t need =
+        (static_cast<std::size_t>(std::max(metadata_.preamble_len, 0)) + kLockSymbols) * sps_;
+    if (burst.size() < need) {
+        return false;
+    }
+    lock_ = lock_preamble(burst.first(need), demod_, metadata_, out_, memory_);
+    result_.cfo_hz = lock_.cfo_hz;
+    result_.preamble_offset = lock_.alignment_offset;
+    result_.sfo = lock_.sfo;
+    // The grid runs without SFO correction, as decode_stream_burst()'s.
+    demod_.set_frequency_offsets(demod_.current_cfo_frac(), demod_.current_cfo_int(), 0.0f);
+    demod_.reset_symbol_counter();
+    if (options_.cfo_track_alpha > 0.0f) {
+        demod_.set_cfo_tracking(options_.cfo_track_alpha, 8);
+    }
+    consumed_ = lock_.alignment_offset;
+    stage_ = Stage::sync;
+    return true;
+}
+
+bool IncrementalBurstDecoder::find_sync(std::span<const std::complex<float>> burst)
+{
+    const host_sim::PhaseScope phase(host_sim::DecodePhase::demod);
+    const std::size_t limit = static_cast<std::size_t>(std::max(metadata_.preamble_len, 0)) + kSyncSearchSymbols;
+    std::optional<std::size_t> sync_pos;
+    while (!sync_pos && grid_.size() < limit) {
+        const std::size_t start = lock_.alignment_offset + grid_.size() * sps_;
+        if (start + sps_ > burst.size()) {
+            return false;
+        }
+        grid_.push_back(demod_.demodulate(burst.data() + start));
+        consumed_ = start + sps_;
+        sync_pos = host_sim::find_header_symbol_index(grid_, 0x12, metadata_.sf);
+        if (!sync_pos) {
+            sync_pos = host_sim::find_header_symbol_index(grid_, 0x34, metadata_.sf);
+        }
+    }
+    if (!sync_pos) {
+        if (!metadata_.implicit_header) {
+            fail("no sync word on the preamble grid");
+            return false;
+        }
+        // Data starts past preamble, sync and SFD, as in the SFD re-demod.
+        sync_pos = static_cast<std::size_t>(metadata_.preamble_len) + 4;
+    }
+    sync_index_ = *sync_pos;
+
+    // Quarter offset 1 past the sync estimate, at the SFO-corrected stride:
+    // the first pass the SFD re-demod of decode_stream_burst() tries.
+    data_sample_ = lock_.alignment_offset + sync_index_ * sps_ + sps_ / 4;
+    const int n_bins = 1 << metadata_.sf;
+    const double stride = lock_.sfo != 0.0f
+        ? static_cast<double>(sps_) * (1.0 - static_cast<double>(lock_.sfo) / n_bins)
+        : static_cast<double>(sps_);
+    demod_.set_frequency_offsets(demod_.current_cfo_frac(), demod_.current_cfo_int(), 0.0f);
+    demod_.reset_symbol_counter();
+    timing_.emplace(host_sim::SymbolTimingConfig{stride, static_cast<int>(sps_), metadata_.sf});
+    stage_ = Stage::header;
+    return true;
+}
+
+bool IncrementalBurstDecoder::demodulate_to(std::span<const std::complex<float>> burst, std::size_t count)
+{
+    if (symbols_.size() < count) {
+        const host_sim::PhaseScope phase(host_sim::DecodePhase::demod);
+        host_sim::demodulate_tracked(demod_, burst, data_sample_, *timing_, count - symbols_.size(), metadata_,
+                                     symbols_, options_.soft ? &llrs_ : nullptr);
+        consumed_ = std::max(consumed_, data_sample_ + timing_->next_offset());
+    }
+    return symbols_.size() >= count;
+}
+
+bool IncrementalBurstDecoder::decode_header()
+{
+    const host_sim::PhaseScope phase(host_sim::DecodePhase::header);
+    if (metadata_.implicit_header) {
+        header_ = implicit_header(symbols_, metadata_, memory_);
+    } else {
+        header_ = try_decode_header(symbols_, 0, metadata_, memory_);
+        if (!header_.success) {
+            fail("header checksum failed");
+            return false;
+        }
+        if ((metadata_.payload_len > 0 && header_.payload_len != metadata_.payload_len) ||
+            (metadata_.cr > 0 && header_.cr != metadata_.cr) || (metadata_.has_crc && !header_.has_crc)) {
+            fail("header disagrees with the stream metadata");
+            return false;
+        }
+    }
+    payload_len_ = header_.payload_len > 0 ? header_.payload_len : metadata_.payload_len;
+    result_.cr = header_.cr > 0 ? header_.cr : metadata_.cr;
+    result_.crc_expected = header_.has_crc || metadata_.has_crc;
+    result_.header_ok = true;
+    result_.path = DecodePath::sfd_redemod;
+    out_ << "Incremental decode: sync at symbol " << (sync_index_ - 4) << ", header after " << symbols_.size()
+         << " data symbols\n";
+    out_ << "Header: len=" << payload_len_ << " cr=" << result_.cr << " crc=" << (result_.crc_expected ? "yes" : "no")
+         << "\n";
+
+    payload_.emplace(host_sim::PayloadDecoderConfig{metadata_.sf, result_.cr, metadata_.ldro, payload_len_,
+                                                    result_.crc_expected, -1});
+    if (header_.nibbles.size() > 5) {
+        payload_->push_nibbles(header_.nibbles.data() + 5, header_.nibbles.size() - 5);
+    }
+    cursor_ = static_cast<std::size_t>(header_.consumed_symbols);
+    stage_ = Stage::payload;
+    return true;
+}
+
+IncrementalBurstDecoder::Status IncrementalBurstDecoder::fail(const char* why)
+{
+    out_ << "Incremental decode: " << why << "\n";
+    status_ = Status::failed;
+    return status_;
+}
+
+} // namespace host_sim::lora_replay
@@ -11,25 +11,75 @@ namespace host_sim::lora_replay
 void print_usage(const char* binary)
 {
     std::cerr << "Usage: " << binary << " --iq <capture.cf32 | ->"
-              << " [--format cf32|hackrf]"
+              << " [--format cf32|hackrf|sc16]"
               << " [--metadata <file.json>]"
               << " [--payload <ascii>]"
               << " [--stats <file.json>]"
               << " [--dump-symbols <file.txt>]"
               << " [--dump-iq <file.cf32>]"
               << " [--compare-root <path/prefix>]"
-              << " [--dump-stages <path/prefix>]"
+              << " [--dump-stages <path/prefix> [--stage-format text|binary|delta]]"
               << " [--dump-payload <file.bin>]"
               << " [--summary <file.json>]"
+              << " [--trace <file.json>]"
               << " [--per-stats]"
+              << " [--realtime]"
               << " [--cfo-track [alpha]]"
+              << " [--decimate-os <n>]"
+              << " [--overflow block|drop]"
+              << " [--source <uri>]"
+              << " [--effort fast|standard|exhaustive] [--decode-budget <ms>] [--defer-recovery]"
+              << " [--incremental]"
+              << " [--cancel-collisions <n>]"
+              << " [--metrics <file.prom> [--metrics-interval <s>]]"
+              << " [--packet-format text|ndjson|binary] [--packet-output <file>]"
               << " [--multi]"
+              << " [--write-index <file.lbix>] [--read-index <file.lbix>]"
+              << " [--bench <runs>]"
               << " [--verbose]"
               << "\n"
               << "\n  --iq -           Read IQ samples from stdin (pipe mode)"
               << "\n  --format hackrf  Expect HackRF int8 IQ on stdin (default: cf32)"
+              << "\n  --format sc16    Expect interleaved int16 IQ on stdin"
               << "\n  --stream         Streaming mode: decode packets as they arrive"
-              << "\n                   (implies --iq - --multi)\n";
+              << "\n                   (implies --iq - --multi)"
+              << "\n  --decimate-os n  With --stream, filter and decimate the input to"
+              << "\n                   oversampling n (2 or 4) as it arrives"
+              << "\n  --source uri     Stream from udp://[addr]:port, vita49://[addr]:port,"
+              << "\n                   zmq+tcp://host:port or soapy://<args>?freq=..&rate=.."
+              << "\n                   instead of stdin (implies --stream)"
+              << "\n  --effort tier    With --stream or --bench, stop after one SFD re-demod"
+              << "\n                   pass (fast), add the timing sweeps and OS=2 fallback"
+              << "\n                   (standard, default) or run OS=2 at every quarter"
+              << "\n                   offset (exhaustive)"
+              << "\n  --decode-budget  Per-packet milliseconds after which a decode stops"
+              << "\n                   escalating and keeps its best result"
+              << "\n  --defer-recovery Re-decode packets the tier or budget cut short at"
+              << "\n                   exhaustive effort on a low-priority thread; wins"
+              << "\n                   arrive later, marked recovered"
+              << "\n  --incremental    With --stream, decode each packet symbol by symbol"
+              << "\n                   as it arrives and report it with its last symbol"
+              << "\n  --cancel-collisions n  With --stream, subtract each decoded packet"
+              << "\n                   from its burst and decode up to n more packets"
+              << "\n                   overlapping it on the same SF"
+              << "\n  --overflow drop  With --stream, drop input and bursts when the"
+              << "\n                   decoders fall behind instead of blocking"
+              << "\n  --metrics file   With --stream, rewrite a Prometheus text snapshot"
+              << "\n                   every --metrics-interval seconds (default 10)"
+              << "\n  --packet-format  With --stream, report packets as text (default),"
+              << "\n                   NDJSON or length-prefixed binary records, written"
+              << "\n                   by a separate thread to --packet-output (stdout)"
+              << "\n  --stage-format   --dump-stages as text (default), binary .stage"
+              << "\n                   files, or delta-varint packed .stage files"
+              << "\n  --bench n        Decode the capture n times through the stream"
+              << "\n                   receiver and report throughput, latency and"
+              << "\n                   per-phase time"
+              << "\n  --write-index f  Record each packet's burst offset, length, alignment,"
+              << "\n                   preamble bin, CFO/SFO and SF in a binary sidecar"
+              << "\n  --read-index f   Seek to the packets listed in a --write-index sidecar"
+              << "\n                   and reuse its acquisition instead of searching"
+              << "\n  --trace file     Record decode spans and work counters (needs a"
+              << "\n                   -DHOST_SIM_TRACE=ON build) and write a Chrome trace\n";
 }
 
 Options parse_arguments(int argc, char** argv)
@@ -46,11 +96,13 @@ Options parse_arguments(int argc, char** argv)
             const std::string_view fmt{argv[++i]};
             if (fmt == "hackrf" || fmt == "int8") {
                 opts.iq_format = Options::IqFormat::hackrf;
+            } else if (fmt == "sc16" || fmt == "int16") {
+                opts.iq_format = Options::IqFormat::sc16;
             } else if (fmt == "cf32") {
                 opts.iq_format = Options::IqFormat::cf32;
             } else {
                 throw std::runtime_error("Unknown IQ format: " + std::string(fmt) +
-                                         " (expected cf32 or hackrf)");
+                                         " (expected cf32, hackrf or sc16)");
             }
         } else if (arg == "--payload" && i + 1 < argc) {
             opts.payload = argv[++i];
@@ -62,6 +114,18 @@ Options parse_arguments(int argc, char** argv)
             opts.dump_symbols = std::filesystem::path{argv[++i]};
         } else if (arg == "--dump-iq" && i + 1 < argc) {
             opts.dump_iq = std::filesystem::path{argv[++i]};
+        } else if (arg == "--stage-format" && i + 1 < argc) {
+            const std::string_view fmt{argv[++i]};
+            if (fmt == "text") {
+                opts.stage_format = Options::StageFormat::text;
+            } else if (fmt == "binary") {
+                opts.stage_format = Options::StageFormat::binary;
+            } else if (fmt == "delta") {
+                opts.stage_format = Options::StageFormat::delta;
+            } else {
+                throw std::runtime_error("Unknown stage format: " + std::string(fmt) +
+                                         " (expected text, binary or delta)");
+            }
         } else if (arg == "--compare-root" && i + 1 < argc) {
             opts.compare_root = std::filesystem::path{argv[++i]};
         } else if (arg == "--dump-stages" && i + 1 < argc) {
@@ -70,8 +134,89 @@ Options parse_arguments(int argc, char** argv)
             opts.dump_payload = std::filesystem::path{argv[++i]};
         } else if (arg == "--summary" && i + 1 < argc) {
             opts.summary_output = std::filesystem::path{argv[++i]};
+        } else if (arg == "--trace" && i + 1 < argc) {
+            opts.trace_output = std::filesystem::path{argv[++i]};
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            opts.metrics_output = std::filesystem::path{argv[++i]};
+        } else if (arg == "--metrics-interval" && i + 1 < argc) {
+            opts.metrics_interval_s = std::atof(argv[++i]);
+            if (!(opts.metrics_interval_s > 0.0)) {
+                throw std::runtime_error("--metrics-interval expects a positive number of seconds");
+            }
+        } else if (arg == "--packet-format" && i + 1 < argc) {
+            const std::string_view fmt{argv[++i]};
+            if (fmt == "text") {
+                opts.packet_format = Options::PacketFormat::text;
+            } else if (fmt == "ndjson") {
+                opts.packet_format = Options::PacketFormat::ndjson;
+            } else if (fmt == "binary") {
+                opts.packet_format = Options::PacketFormat::binary;
+            } else {
+                throw std::runtime_error("Unknown packet format: " + std::string(fmt) +
+                                         " (expected text, ndjson or binary)");
+            }
+        } else if (arg == "--packet-output" && i + 1 < argc) {
+            opts.packet_output = std::filesystem::path{argv[++i]};
+        } else if (arg == "--write-index" && i + 1 < argc) {
+            opts.write_index = std::filesystem::path{argv[++i]};
+        } else if (arg == "--read-index" && i + 1 < argc) {
+            opts.read_index = std::filesystem::path{argv[++i]};
         } else if (arg == "--per-stats") {
             opts.per_stats = true;
+        } else if (arg == "--decimate-os" && i + 1 < argc) {
+            opts.decimate_os = std::atoi(argv[++i]);
+            if (opts.decimate_os < 1) {
+                throw std::runtime_error("--decimate-os expects a positive oversampling factor");
+            }
+        } else if (arg == "--bench" && i + 1 < argc) {
+            opts.bench_runs = std::atoi(argv[++i]);
+            if (opts.bench_runs < 1) {
+                throw std::runtime_error("--bench expects a positive run count");
+            }
+        } else if (arg == "--overflow" && i + 1 < argc) {
+            const std::string_view policy{argv[++i]};
+            if (policy == "drop") {
+                opts.drop_on_overflow = true;
+            } else if (policy == "block") {
+                opts.drop_on_overflow = false;
+            } else {
+                throw std::runtime_error("Unknown overflow policy: " + std::string(policy) +
+                                         " (expected block or drop)");
+            }
+        } else if (arg == "--effort" && i + 1 < argc) {
+            const std::string_view tier{argv[++i]};
+            if (tier == "fast") {
+                opts.effort = Options::DecodeEffort::fast;
+            } else if (tier == "standard") {
+                opts.effort = Options::DecodeEffort::standard;
+            } else if (tier == "exhaustive") {
+                opts.effort = Options::DecodeEffort::exhaustive;
+            } else {
+                throw std::runtime_error("Unknown decode effort: " + std::string(tier) +
+                                         " (expected fast, standard or exhaustive)");
+            }
+        } else if (arg == "--decode-budget" && i + 1 < argc) {
+            opts.decode_budget_ms = std::atof(argv[++i]);
+            if (!(opts.decode_budget_ms > 0.0)) {
+                throw std::runtime_error("--decode-budget expects a positive number of milliseconds");
+            }
+        } else if (arg == "--defer-recovery") {
+            opts.defer_recovery = true;
+        } else if (arg == "--incremental") {
+            opts.incremental = true;
+        } else if (arg == "--cancel-collisions" && i + 1 < argc) {
+            opts.cancel_collisions = std::atoi(argv[++i]);
+            if (opts.cancel_collisions <= 0) {
+                throw std::runtime_error("--cancel-collisions expects a positive packet count");
+            }
+        } else if (arg == "--source" && i + 1 < argc) {
+            opts.source = argv[++i];
+            opts.stream = true;
+            opts.read_stdin = true;
+            opts.multi_packet = true;
+            if (opts.iq_file.empty()) opts.iq_file = "-";
+        } else if (arg == "--realtime") {
+            opts.realtime = true;
         } else if (arg == "--multi-sf") {
             opts.multi_sf = true;
         } else if (arg == "--cfo-track") {
@@ -108,6 +253,25 @@ Options parse_arguments(int argc, char** argv)
     if (opts.iq_file.empty()) {
         throw std::runtime_error("Missing required --iq argument");
     }
+    if (opts.metrics_output && !opts.stream) {
+        throw std::runtime_error("--metrics requires --stream");
+    }
+    if ((opts.write_index || opts.read_index) && opts.stream) {
+        throw std::runtime_error("--write-index and --read-index apply to capture files, not --stream");
+    }
+    if ((opts.effort != Options::DecodeEffort::standard || opts.decode_budget_ms > 0.0 || opts.defer_recovery) &&
+        !opts.stream && opts.bench_runs == 0) {
+        throw std::runtime_error("--effort, --decode-budget and --defer-recovery require --stream or --bench");
+    }
+    if (opts.incremental && (!opts.stream || opts.multi_sf)) {
+        throw std::runtime_error("--incremental requires --stream with a single SF");
+    }
+    if (opts.cancel_collisions > 0 && (!opts.stream || opts.multi_sf)) {
+        throw std::runtime_error("--cancel-collisions requires --stream with a single SF");
+    }
+    if ((opts.packet_output || opts.packet_format != Options::PacketFormat::text) && !opts.stream) {
+        throw std::runtime_error("--packet-format and --packet-output require --stream");
+    }
     return opts;
 }
 
@@ -0,0 +1,254 @@
+#include "host_sim/lora_replay/stage_dump.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace host_sim::lora_replay
+{
+
+namespace
+{
+
+constexpr char kMagic[4] = {'L', 'S', 'T', 'G'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::uint8_t kSignedFlag = 1;
+
+// Narrowest of 1/2/4/8 bytes holding [lo, hi], unsigned when lo >= 0.
+int value_width(long long lo, long long hi)
+{
+    if (lo >= 0) {
+        const auto top = static_cast<unsigned long long>(hi);
+        return top <= 0xFFull ? 1 : top <= 0xFFFFull ? 2 : top <= 0xFFFFFFFFull ? 4 : 8;
+    }
+    const auto fits = [&](long long limit) { return lo >= -limit - 1 && hi <= limit; };
+    return fits(0x7F) ? 1 : fits(0x7FFF) ? 2 : fits(0x7FFFFFFF) ? 4 : 8;
+}
+
+void append_le(std::string& out, std::uint64_t value, int width)
+{
+    for (int b = 0; b < width; ++b) {
+        out.push_back(static_cast<char>((value >> (8 * b)) & 0xFF));
+    }
+}
+
+void append_le(std::vector<std::uint8_t>& out, std::uint64_t value, int width)
+{
+    for (int b = 0; b < width; ++b) {
+        out.push_back(static_cast<std::uint8_t>((value >> (8 * b)) & 0xFF));
+    }
+}
+
+std::uint64_t zigzag(long long value)
+{
+    const auto bits = static_cast<std::uint64_t>(value);
+    return (bits << 1) ^ (value < 0 ? ~std::uint64_t{0} : 0);
+}
+
+long long unzigzag(std::uint64_t bits)
+{
+    return static_cast<long long>((bits >> 1) ^ (~(bits & 1) + 1));
+}
+
+} // namespace
+
+// ── StageDumpEncoder ────────────────────────────────────────────────
+
+StageDumpEncoder::StageDumpEncoder(long long min_value, long long max_value, std::size_t count,
+                                   StageEncoding encoding)
+    : expected_(count), width_(value_width(min_value, max_value)), encoding_(encoding)
+{
+    bytes_.reserve(kStageDumpHeaderBytes + (encoding == StageEncoding::raw ? count * width_ : count));
+    bytes_.append(kMagic, sizeof kMagic);
+    bytes_.push_back(static_cast<char>(kVersion));
+    bytes_.push_back(static_cast<char>(encoding));
+    bytes_.push_back(static_cast<char>(width_));
+    bytes_.push_back(static_cast<char>(min_value < 0 ? kSignedFlag : 0));
+    append_le(bytes_, count, 8);
+}
+
+void StageDumpEncoder::push(long long value)
+{
+    ++pushed_;
+    if (encoding_ == StageEncoding::raw) {
+        append_le(bytes_, static_cast<std::uint64_t>(value), width_);
+        return;
+    }
+    // Wrapping difference: decoding adds it back modulo 2^64.
+    std::uint64_t bits = zigzag(static_cast<long long>(static_cast<std::uint64_t>(value) -
+                                                       static_cast<std::uint64_t>(previous_)));
+    previous_ = value;
+    while (bits >= 0x80) {
+        bytes_.push_back(static_cast<char>((bits & 0x7F) | 0x80));
+        bits >>= 7;
+    }
+    bytes_.push_back(static_cast<char>(bits));
+}
+
+std::string StageDumpEncoder::take()
+{
+    if (pushed_ != expected_) {
+        throw std::logic_error("StageDumpEncoder: " + std::to_string(pushed_) + " values pushed, " +
+                               std::to_string(expected_) + " declared");
+    }
+    return std::move(bytes_);
+}
+
+void write_stage_bytes(const std::filesystem::path& path, const std::string& bytes)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Failed to write stage dump: " + path.string());
+    }
+}
+
+// ── StageDump ───────────────────────────────────────────────────────
+
+StageDump::StageDump(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const auto file_size = static_cast<std::size_t>(std::filesystem::file_size(path, ec));
+    if (ec) {
+        throw std::runtime_error("Stage dump not found: " + path.string());
+    }
+    const std::uint8_t* file = nullptr;
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    owned_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    file = owned_.data();
+#else
+    if (file_size > 0) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open stage dump: " + path.string());
+        }
+        void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Unable to memory-map stage dump: " + path.string());
+        }
+        ::madvise(mapping, file_size, MADV_SEQUENTIAL);
+        mapping_ = mapping;
+        mapping_bytes_ = file_size;
+        file = static_cast<const std::uint8_t*>(mapping);
+    }
+#endif
+    const auto malformed = [&](const char* why) {
+        unmap();
+        return std::runtime_error("Malformed stage dump " + path.string() + ": " + why);
+    };
+    if (file_size < kStageDumpHeaderBytes || std::memcmp(file, kMagic, sizeof kMagic) != 0) {
+        throw malformed("bad magic");
+    }
+    if (file[4] != kVersion) {
+        throw malformed("unknown version");
+    }
+    const auto encoding = static_cast<StageEncoding>(file[5]);
+    const int width = file[6];
+    const bool is_signed = (file[7] & kSignedFlag) != 0;
+    if (width != 1 && width != 2 && width != 4 && width != 8) {
+        throw malformed("bad value width");
+    }
+    std::uint64_t count = 0;
+    for (int b = 0; b < 8; ++b) {
+        count |= static_cast<std::uint64_t>(file[8 + b]) << (8 * b);
+    }
+    const std::uint8_t* body = file + kStageDumpHeaderBytes;
+    const std::size_t body_bytes = file_size - kStageDumpHeaderBytes;
+
+    if (encoding == StageEncoding::raw) {
+        if (count > body_bytes / static_cast<std::size_t>(width) ||
+            count * static_cast<std::size_t>(width) != body_bytes) {
+            throw malformed("size does not match the value count");
+        }
+        values_ = body;
+    } else if (encoding == StageEncoding::delta_varint) {
+        if (count > body_bytes) {
+            throw malformed("fewer bytes than values");
+        }
+        std::vector<std::uint8_t> unpacked;
+        unpacked.reserve(static_cast<std::size_t>(count) * static_cast<std::size_t>(width));
+        std::size_t pos = 0;
+        std::uint64_t value = 0;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::uint64_t bits = 0;
+            int shift = 0;
+            for (;;) {
+                if (pos == body_bytes || shift > 63) {
+                    throw malformed("truncated or overlong varint");
+                }
+                const std::uint8_t byte = body[pos++];
+                bits |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            value += static_cast<std::uint64_t>(unzigzag(bits));
+            append_le(unpacked, value, width);
+        }
+        if (pos != body_bytes) {
+            throw malformed("trailing bytes");
+        }
+        unmap();
+        owned_ = std::move(unpacked);
+        values_ = owned_.data();
+    } else {
+        throw malformed("unknown encoding");
+    }
+    count_ = static_cast<std::size_t>(count);
+    width_ = width;
+    signed_ = is_signed;
+    encoding_ = encoding;
+}
+
+StageDump::~StageDump()
+{
+    unmap();
+}
+
+StageDump::StageDump(StageDump&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+StageDump& StageDump::operator=(StageDump&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        owned_ = std::move(other.owned_);   // keeps its buffer, so values_ stays valid
+        values_ = other.values_;
+        count_ = other.count_;
+        width_ = other.width_;
+        signed_ = other.signed_;
+        encoding_ = other.encoding_;
+        mapping_ = other.mapping_;
+        mapping_bytes_ = other.mapping_bytes_;
+        other.values_ = nullptr;
+        other.count_ = 0;
+        other.mapping_ = nullptr;
+        other.mapping_bytes_ = 0;
+    }
+    return *this;
+}
+
+void StageDump::unmap()
+{
+#ifndef _WIN32
+    if (mapping_) {
+        ::munmap(mapping_, mapping_bytes_);
+    }
+#endif
+    mapping_ = nullptr;
+    mapping_bytes_ = 0;
+}
+
+} // namespace host_sim::lora_replay
@@ -1,5 +1,8 @@
 #include "host_sim/lora_replay/stage_processing.hpp"
 
+#include "host_sim/crc16.hpp"
+#include "host_sim/lora_replay/stage_dump.hpp"
+
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
@@ -71,19 +74,7 @@ uint16_t compute_lora_crc(const std::vector<uint8_t>& payload)
         return 0x0000;
     }
 
-    const std::size_t crc_input_len = payload.size() - 2;
-    uint16_t crc = 0x0000;
-    for (std::size_t idx = 0; idx < crc_input_len; ++idx) {
-        const uint8_t byte = payload[idx];
-        crc ^= static_cast<uint16_t>(byte) << 8;
-        for (int bit = 0; bit < 8; ++bit) {
-            if (crc & 0x8000) {
-                crc = static_cast<uint16_t>((crc << 1) ^ 0x1021);
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
+    uint16_t crc = host_sim::crc16_ccitt(payload.data(), payload.size() - 2);
 
     // XOR with the last two payload bytes (MSB then LSB).
     crc = static_cast<uint16_t>(crc ^ payload[payload.size() - 1] ^ (static_cast<uint16_t>(payload[payload.size() - 2]) << 8));
@@ -97,18 +88,7 @@ uint16_t compute_lora_crc_syndrome(const std::vector<uint8_t>& payload_with_crc)
     }
     const std::size_t data_len = payload_with_crc.size() - 2;
 
-    uint16_t crc = 0x0000;
-    for (std::size_t idx = 0; idx < data_len; ++idx) {
-        const uint8_t byte = payload_with_crc[idx];
-        crc ^= static_cast<uint16_t>(byte) << 8;
-        for (int bit = 0; bit < 8; ++bit) {
-            if (crc & 0x8000) {
-                crc = static_cast<uint16_t>((crc << 1) ^ 0x1021);
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
+    const uint16_t crc = host_sim::crc16_ccitt(payload_with_crc.data(), data_len);
 
     // gr-lora_sdr's legacy "embedded CRC" syndrome:
     // CRC is embedded in the last two bytes (MSB then LSB) of the message window.
@@ -242,7 +222,11 @@ void write_summary_json(const std::filesystem::path& path, const SummaryReport&
     if (!out) {
         throw std::runtime_error("Failed to open summary output file: " + path.string());
     }
+    write_summary_json(out, report);
+}
 
+void write_summary_json(std::ostream& out, const SummaryReport& report)
+{
     std::vector<std::string> fields;
     if (report.capture_path) {
         fields.push_back("  \"capture\": \"" + json_escape(*report.capture_path) + "\"");
@@ -324,6 +308,37 @@ void write_summary_json(const std::filesystem::path& path, const SummaryReport&
         fields.push_back(mem_ss.str());
     }
 
+    if (report.realtime_mode) {
+        const auto events_json = [](const std::vector<SummaryReport::RealTimeEvent>& events) {
+            std::ostringstream ev_ss;
+            ev_ss << "[";
+            for (std::size_t i = 0; i < events.size(); ++i) {
+                if (i > 0) {
+                    ev_ss << ", ";
+                }
+                ev_ss << "{\"symbol\": " << events[i].symbol_index
+                      << ", \"timestamp_ns\": " << events[i].timestamp_ns
+                      << ", \"delta_ns\": " << events[i].delta_ns << "}";
+            }
+            ev_ss << "]";
+            return ev_ss.str();
+        };
+        std::ostringstream rt_ss;
+        rt_ss << "  \"realtime\": {\n"
+              << "    \"symbol_period_ns\": " << report.rt_symbol_period_ns << ",\n"
+              << "    \"avg_start_lag_ns\": " << report.rt_avg_start_lag_ns << ",\n"
+              << "    \"max_start_lag_ns\": " << report.rt_max_start_lag_ns << ",\n"
+              << "    \"avg_deadline_margin_ns\": " << report.rt_avg_deadline_margin_ns << ",\n"
+              << "    \"min_deadline_margin_ns\": " << report.rt_min_deadline_margin_ns << ",\n"
+              << "    \"overruns\": " << report.rt_overrun_count << ",\n"
+              << "    \"underruns\": " << report.rt_underrun_count << ",\n"
+              << "    \"capacity\": " << report.rt_capacity << ",\n"
+              << "    \"overrun_events\": " << events_json(report.rt_overrun_events) << ",\n"
+              << "    \"underrun_events\": " << events_json(report.rt_underrun_events) << "\n"
+              << "  }";
+        fields.push_back(rt_ss.str());
+    }
+
     if (!report.preview_symbols.empty()) {
         std::ostringstream preview_ss;
         preview_ss << "  \"preview_symbols\": [";
@@ -412,6 +427,21 @@ void write_summary_json(const std::filesystem::path& path, const SummaryReport&
         fields.push_back(inst_ss.str());
     }
 
+    if (!report.trace_counters.empty()) {
+        std::ostringstream trace_ss;
+        trace_ss << "  \"trace_counters\": {\n";
+        for (std::size_t i = 0; i < report.trace_counters.size(); ++i) {
+            trace_ss << "    \"" << json_escape(report.trace_counters[i].first)
+                     << "\": " << report.trace_counters[i].second;
+            if (i + 1 < report.trace_counters.size()) {
+                trace_ss << ',';
+            }
+            trace_ss << '\n';
+        }
+        trace_ss << "  }";
+        fields.push_back(trace_ss.str());
+    }
+
     out << "{\n";
     for (std::size_t i = 0; i < fields.size(); ++i) {
         out << fields[i];
@@ -431,10 +461,20 @@ std::vector<StageComparisonResult> compare_with_reference(const StageOutputs& ou
         base.replace_extension("");
     }
 
+    // A binary `<prefix>_<stage>.stage` dump is compared straight from its
+    // mapping; the text dump is the fallback.
     std::vector<StageComparisonResult> results;
-    auto compare_stage_file = [&](const char* suffix, const auto& host_vec, const char* label) {
+    auto compare_stage_file = [&](const char* stage, const auto& host_vec, const char* label) {
         std::filesystem::path path = base;
-        path += suffix;
+        path += std::string("_") + stage;
+        auto binary_path = path;
+        binary_path += ".stage";
+        if (std::filesystem::exists(binary_path)) {
+            const StageDump reference(binary_path);
+            results.push_back(compare_stage(label, host_vec, reference));
+            return;
+        }
+        path += ".txt";
         if (!std::filesystem::exists(path)) {
             StageComparisonResult missing;
             missing.label = label;
@@ -449,10 +489,10 @@ std::vector<StageComparisonResult> compare_with_reference(const StageOutputs& ou
         results.push_back(compare_stage(label, host_vec, reference));
     };
 
-    compare_stage_file("_fft.txt", outputs.fft, "FFT");
-    compare_stage_file("_gray.txt", outputs.gray, "Gray");
-    compare_stage_file("_deinterleaver.txt", outputs.deinterleaver, "Deinterleaver");
-    compare_stage_file("_hamming.txt", outputs.hamming, "Hamming");
+    compare_stage_file("fft", outputs.fft, "FFT");
+    compare_stage_file("gray", outputs.gray, "Gray");
+    compare_stage_file("deinterleaver", outputs.deinterleaver, "Deinterleaver");
+    compare_stage_file("hamming", outputs.hamming, "Hamming");
 
     return results;
 }
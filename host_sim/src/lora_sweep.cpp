@@ -0,0 +1,474 @@
+// lora_sweep — in-process PER/BER sweep.
+//
+// For every point of an SF × BW × CR × SNR × CFO × SFO grid, generate
+// packets with the host_sim_tx encoder and impairment channel, find each
+// burst with the stream receiver's BurstDetector and decode it with the
+// same decode_stream_burst() lora_replay --stream runs.  Packets of a point
+// are decoded in parallel on the shared worker pool; results are collected
+// by packet index, so every count is independent of the thread count.
+
+#include "host_sim/burst_detector.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/lora_replay/options.hpp"
+#include "host_sim/metrics.hpp"
+#include "host_sim/tx/batch.hpp"
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct SweepOptions
+{
+    std::vector<int> sf{7};
+    std::vector<int> bw{125000};
+    std::vector<int> cr{1};
+    std::vector<double> snr_db{std::numeric_limits<double>::quiet_NaN()};
+    std::vector<double> cfo_hz{0.0};
+    std::vector<double> sfo_ppm{0.0};
+    int os{1};
+    int preamble_len{8};
+    std::size_t packets{100};
+    std::size_t payload_len{16};
+    uint64_t seed{1};
+    bool soft{false};
+    bool verbose{false};
+    double max_per{-1.0};   // < 0: no threshold
+    std::filesystem::path output;
+    std::optional<std::filesystem::path> summary_dir;
+};
+
+struct SweepPoint
+{
+    int sf{7};
+    int bw{125000};
+    int cr{1};
+    double snr_db{0.0};
+    double cfo_hz{0.0};
+    double sfo_ppm{0.0};
+
+    std::string name() const
+    {
+        std::ostringstream out;
+        out << "sf" << sf << "_bw" << bw << "_cr" << cr << "_snr";
+        if (std::isnan(snr_db)) {
+            out << "off";
+        } else {
+            out << std::fixed << std::setprecision(1) << snr_db << std::defaultfloat;
+        }
+        out << std::setprecision(10) << "_cfo" << cfo_hz << "_sfo" << sfo_ppm;
+        return out.str();
+    }
+};
+
+struct PacketOutcome
+{
+    bool detected{false};
+    host_sim::lora_replay::StreamDecodeResult result;
+    double decode_ms{0.0};
+    std::string report;   // decoder log, kept for --verbose
+};
+
+struct PointResult
+{
+    SweepPoint point;
+    std::size_t packets{0};
+    std::size_t detected{0};
+    std::size_t header_ok{0};
+    std::size_t crc_ok{0};
+    std::size_t good{0};        // CRC OK and payload byte-exact
+    long long bit_errors{0};
+    long long total_bits{0};
+    std::vector<double> decode_ms;   // per packet, in index order
+
+    double per() const { return packets ? 1.0 - static_cast<double>(good) / static_cast<double>(packets) : 0.0; }
+    double ber() const { return total_bits ? static_cast<double>(bit_errors) / static_cast<double>(total_bits) : 0.0; }
+};
+
+void print_usage(const char* prog)
+{
+    std::cerr
+        << "Usage: " << prog << " [options] --output <results.json>\n"
+        << "Grid axes take comma-separated lists; --snr also accepts start:stop:step\n"
+        << "  --sf <list>            Spreading factors (default: 7)\n"
+        << "  --bw <list>            Bandwidths in Hz (default: 125000)\n"
+        << "  --cr <list>            Coding rates 1-4 (default: 1)\n"
+        << "  --snr <list|range>     SNR in dB, 'off' = no noise (default: off)\n"
+        << "  --cfo <list>           Carrier frequency offsets in Hz (default: 0)\n"
+        << "  --sfo <list>           Sampling frequency offsets in ppm (default: 0)\n"
+        << "  --os <n>               Oversampling factor, Fs = n x BW (default: 1)\n"
+        << "  --preamble <n>         Preamble length (default: 8)\n"
+        << "  --packets <n>          Packets per point (default: 100)\n"
+        << "  --payload-len <n>      Random payload bytes per packet (default: 16)\n"
+        << "  --seed <n>             Base seed; point k uses seed + k (default: 1)\n"
+        << "  --soft                 Soft-decision decoding\n"
+        << "  --verbose              Print the decoder log of every lost packet\n"
+        << "  --summary-dir <dir>    Also write one summary JSON per point, readable by\n"
+        << "                         tools/compare_summary_metrics.py\n"
+        << "  --max-per <p>          Exit non-zero when any point's PER exceeds p\n"
+        << "  --output <file>        Results JSON\n"
+        << "Threads: HOST_SIM_THREADS (default: hardware concurrency)\n";
+}
+
+std::vector<std::string> split(const std::string& text, char sep)
+{
+    std::vector<std::string> parts;
+    std::string part;
+    std::istringstream in(text);
+    while (std::getline(in, part, sep)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+std::vector<int> parse_int_list(const std::string& text)
+{
+    std::vector<int> values;
+    for (const auto& part : split(text, ',')) {
+        values.push_back(std::stoi(part));
+    }
+    return values;
+}
+
+// Comma list of values, "off" (NaN) or start:stop:step ranges.
+std::vector<double> parse_double_list(const std::string& text)
+{
+    std::vector<double> values;
+    for (const auto& part : split(text, ',')) {
+        if (part == "off") {
+            values.push_back(std::numeric_limits<double>::quiet_NaN());
+            continue;
+        }
+        const auto range = split(part, ':');
+        if (range.size() == 3) {
+            const double start = std::stod(range[0]);
+            const double stop = std::stod(range[1]);
+            const double step = std::stod(range[2]);
+            if (step == 0.0 || (stop - start) / step < 0.0) {
+                throw std::runtime_error("Bad range: " + part);
+            }
+            const auto steps = static_cast<long>(std::floor((stop - start) / step + 1e-9));
+            for (long k = 0; k <= steps; ++k) {
+                values.push_back(start + static_cast<double>(k) * step);
+            }
+            continue;
+        }
+        values.push_back(std::stod(part));
+    }
+    return values;
+}
+
+std::optional<SweepOptions> parse_args(int argc, char* argv[])
+{
+    SweepOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--sf") { opts.sf = parse_int_list(next()); }
+        else if (arg == "--bw") { opts.bw = parse_int_list(next()); }
+        else if (arg == "--cr") { opts.cr = parse_int_list(next()); }
+        else if (arg == "--snr") { opts.snr_db = parse_double_list(next()); }
+        else if (arg == "--cfo") { opts.cfo_hz = parse_double_list(next()); }
+        else if (arg == "--sfo") { opts.sfo_ppm = parse_double_list(next()); }
+        else if (arg == "--os") { opts.os = std::stoi(next()); }
+        else if (arg == "--preamble") { opts.preamble_len = std::stoi(next()); }
+        else if (arg == "--packets") { opts.packets = std::stoul(next()); }
+        else if (arg == "--payload-len") { opts.payload_len = std::stoul(next()); }
+        else if (arg == "--seed") { opts.seed = std::stoull(next()); }
+        else if (arg == "--soft") { opts.soft = true; }
+        else if (arg == "--verbose") { opts.verbose = true; }
+        else if (arg == "--summary-dir") { opts.summary_dir = next(); }
+        else if (arg == "--max-per") { opts.max_per = std::stod(next()); }
+        else if (arg == "--output") { opts.output = next(); }
+        else if (arg == "--help" || arg == "-h") { return std::nullopt; }
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return std::nullopt;
+        }
+    }
+    if (opts.output.empty()) {
+        std::cerr << "Error: --output is required\n";
+        return std::nullopt;
+    }
+    for (int sf : opts.sf) {
+        if (sf < 6 || sf > 12) {
+            std::cerr << "Error: SF must be 6-12\n";
+            return std::nullopt;
+        }
+    }
+    for (int cr : opts.cr) {
+        if (cr < 1 || cr > 4) {
+            std::cerr << "Error: CR must be 1-4\n";
+            return std::nullopt;
+        }
+    }
+    if (opts.os < 1 || opts.packets == 0 || opts.payload_len < 3 || opts.payload_len > 255) {
+        std::cerr << "Error: --os, --packets must be positive and --payload-len 3-255\n";
+        return std::nullopt;
+    }
+    return opts;
+}
+
+std::vector<SweepPoint> build_grid(const SweepOptions& opts)
+{
+    std::vector<SweepPoint> grid;
+    for (int sf : opts.sf) {
+        for (int bw : opts.bw) {
+            for (int cr : opts.cr) {
+                for (double cfo : opts.cfo_hz) {
+                    for (double sfo : opts.sfo_ppm) {
+                        for (double snr : opts.snr_db) {
+                            grid.push_back({sf, bw, cr, snr, cfo, sfo});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return grid;
+}
+
+// Find the burst the way the stream receiver does, then decode it.
+PacketOutcome decode_packet(const host_sim::tx::BatchPacket& packet,
+                            const host_sim::LoRaMetadata& meta,
+                            bool soft)
+{
+    PacketOutcome outcome;
+    host_sim::FftDemodulator demod(meta.sf, meta.sample_rate, meta.bw);
+    const auto sps = static_cast<std::size_t>(demod.samples_per_symbol());
+    host_sim::BurstDetector detector(sps, 6.0f, 2);
+    detector.update(packet.iq.data(), packet.iq.size());
+    const auto start = detector.find_start(0);
+    if (!start) {
+        return outcome;
+    }
+    const auto extent = detector.find_end(start->burst_start, start->noise_floor);
+    const std::size_t end = std::min(extent.end, packet.iq.size());
+    if (end < start->burst_start + 12 * sps) {
+        return outcome;
+    }
+    outcome.detected = true;
+
+    host_sim::lora_replay::Options options;
+    options.payload.assign(packet.payload.begin(), packet.payload.end());
+    options.soft = soft;
+    std::ostringstream report;
+    const std::span<const std::complex<float>> burst(packet.iq.data() + start->burst_start,
+                                                     end - start->burst_start);
+    const auto t0 = std::chrono::steady_clock::now();
+    outcome.result = host_sim::lora_replay::decode_stream_burst(burst, demod, meta, options, report);
+    outcome.decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    outcome.report = report.str();
+    return outcome;
+}
+
+PointResult run_point(const SweepPoint& point, std::size_t point_index, const SweepOptions& opts)
+{
+    host_sim::tx::BatchOptions batch;
+    batch.packet.sf = point.sf;
+    batch.packet.cr = point.cr;
+    batch.packet.bw = point.bw;
+    batch.packet.sample_rate = point.bw * opts.os;
+    batch.packet.preamble_len = opts.preamble_len;
+    batch.packet.ldro = host_sim::tx::ldro_required(point.sf, point.bw);
+    batch.channel = {static_cast<float>(point.snr_db), static_cast<float>(point.cfo_hz),
+                     static_cast<float>(point.sfo_ppm)};
+    batch.count = opts.packets;
+    batch.payload_len = opts.payload_len;
+    batch.seed = opts.seed + point_index;
+    const host_sim::tx::BatchGenerator generator(batch);
+
+    host_sim::LoRaMetadata meta;
+    meta.sf = point.sf;
+    meta.bw = point.bw;
+    meta.sample_rate = batch.packet.sample_rate;
+    meta.cr = point.cr;
+    meta.payload_len = static_cast<int>(opts.payload_len);
+    meta.preamble_len = opts.preamble_len;
+    meta.has_crc = true;
+    meta.ldro = batch.packet.ldro;
+
+    std::vector<PacketOutcome> outcomes(opts.packets);
+    host_sim::WorkerPool::shared().parallel_for(opts.packets, [&](std::size_t i, std::size_t) {
+        const auto packet = generator.generate(i);
+        try {
+            outcomes[i] = decode_packet(packet, meta, opts.soft);
+        } catch (const std::exception& ex) {
+            outcomes[i] = PacketOutcome{true, {}, 0.0, ex.what()};   // counted as a lost packet
+        }
+    });
+
+    PointResult result;
+    result.point = point;
+    result.packets = opts.packets;
+    for (const auto& o : outcomes) {
+        result.detected += o.detected ? 1 : 0;
+        result.header_ok += o.result.header_ok ? 1 : 0;
+        result.crc_ok += o.result.crc_ok ? 1 : 0;
+        result.good += (o.result.crc_ok && !o.result.payload_failure) ? 1 : 0;
+        result.bit_errors += o.result.bit_errors;
+        result.total_bits += o.result.total_bits;
+        if (o.detected) {
+            result.decode_ms.push_back(o.decode_ms);
+        }
+    }
+    if (opts.verbose) {
+        for (std::size_t i = 0; i < outcomes.size(); ++i) {
+            const auto& o = outcomes[i];
+            if (o.result.crc_ok && !o.result.payload_failure) {
+                continue;
+            }
+            std::cerr << "[" << point.name() << "] packet " << i << " lost"
+                      << (o.detected ? "" : " (no burst detected)") << "\n" << o.report << "\n";
+        }
+    }
+    return result;
+}
+
+// The fields shared by the results file and the per-point summaries.
+void write_point_fields(std::ostream& out, const PointResult& r, const std::string& indent)
+{
+    const auto& p = r.point;
+    out << indent << "\"sf\": " << p.sf << ",\n"
+        << indent << "\"bw\": " << p.bw << ",\n"
+        << indent << "\"cr\": " << p.cr << ",\n"
+        << indent << "\"snr_db\": ";
+    if (std::isnan(p.snr_db)) {
+        out << "null";
+    } else {
+        out << p.snr_db;
+    }
+    out << ",\n"
+        << indent << "\"cfo_hz\": " << p.cfo_hz << ",\n"
+        << indent << "\"sfo_ppm\": " << p.sfo_ppm << ",\n"
+        << indent << "\"packets\": " << r.packets << ",\n"
+        << indent << "\"detected\": " << r.detected << ",\n"
+        << indent << "\"header_ok\": " << r.header_ok << ",\n"
+        << indent << "\"crc_ok\": " << r.crc_ok << ",\n"
+        << indent << "\"per\": " << r.per() << ",\n"
+        << indent << "\"bit_errors\": " << r.bit_errors << ",\n"
+        << indent << "\"total_bits\": " << r.total_bits << ",\n"
+        << indent << "\"ber\": " << r.ber() << ",\n"
+        << indent << "\"decode_ms_p50\": " << host_sim::percentile(r.decode_ms, 50.0) << ",\n"
+        << indent << "\"decode_ms_p90\": " << host_sim::percentile(r.decode_ms, 90.0) << ",\n"
+        << indent << "\"decode_ms_p99\": " << host_sim::percentile(r.decode_ms, 99.0) << ",\n"
+        << indent << "\"decode_ms_max\": " << host_sim::percentile(r.decode_ms, 100.0);
+}
+
+void write_results(const std::filesystem::path& path, const SweepOptions& opts, const std::vector<PointResult>& results)
+{
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Unable to open sweep output file: " + path.string());
+    }
+    out << std::setprecision(6) << "{\n"
+        << "  \"seed\": " << opts.seed << ",\n"
+        << "  \"packets_per_point\": " << opts.packets << ",\n"
+        << "  \"payload_len\": " << opts.payload_len << ",\n"
+        << "  \"os\": " << opts.os << ",\n"
+        << "  \"soft\": " << (opts.soft ? "true" : "false") << ",\n"
+        << "  \"threads\": " << host_sim::WorkerPool::shared().worker_count() << ",\n"
+        << "  \"points\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        out << "    {\n"
+            << "      \"name\": \"" << results[i].point.name() << "\",\n";
+        write_point_fields(out, results[i], "      ");
+        out << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// One lora_replay-style summary per point, named <point>.json, so a
+// baseline listing "<point>.cf32" captures can be checked with
+// tools/compare_summary_metrics.py.  Decode times stand in for the
+// per-symbol stage timings.
+void write_summary(const std::filesystem::path& dir, const PointResult& r)
+{
+    const auto path = dir / (r.point.name() + ".json");
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Unable to open summary file: " + path.string());
+    }
+    out << std::setprecision(6) << "{\n"
+        << "  \"capture\": \"" << r.point.name() << ".cf32\",\n";
+    write_point_fields(out, r, "  ");
+    out << ",\n  \"stage_timings_ns\": [";
+    for (std::size_t i = 0; i < r.decode_ms.size(); ++i) {
+        out << (i ? ", " : "") << static_cast<long long>(r.decode_ms[i] * 1e6);
+    }
+    out << "]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try {
+        const auto parsed = parse_args(argc, argv);
+        if (!parsed) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        const auto& opts = *parsed;
+        if (opts.summary_dir) {
+            std::filesystem::create_directories(*opts.summary_dir);
+        }
+
+        const auto grid = build_grid(opts);
+        std::cout << "lora_sweep: " << grid.size() << " points x " << opts.packets << " packets on "
+                  << host_sim::WorkerPool::shared().worker_count() << " threads\n";
+        const auto t0 = std::chrono::steady_clock::now();
+        std::vector<PointResult> results;
+        bool over_threshold = false;
+        for (std::size_t k = 0; k < grid.size(); ++k) {
+            results.push_back(run_point(grid[k], k, opts));
+            const auto& r = results.back();
+            std::printf("  %-44s PER %.4f (%zu/%zu ok)  BER %.2e  decode p50 %.2f ms p99 %.2f ms\n",
+                        r.point.name().c_str(), r.per(), r.good, r.packets, r.ber(),
+                        host_sim::percentile(r.decode_ms, 50.0), host_sim::percentile(r.decode_ms, 99.0));
+            std::fflush(stdout);
+            if (opts.summary_dir) {
+                write_summary(*opts.summary_dir, r);
+            }
+            if (opts.max_per >= 0.0 && r.per() > opts.max_per) {
+                over_threshold = true;
+            }
+        }
+        write_results(opts.output, opts, results);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "lora_sweep: " << grid.size() * opts.packets << " packets in " << std::fixed
+                  << std::setprecision(2) << seconds << " s, results in " << opts.output << "\n";
+        if (over_threshold) {
+            std::cerr << "lora_sweep: PER above --max-per " << opts.max_per << "\n";
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,250 @@
+#include "host_sim/metrics.hpp"
+
+#include "host_sim/receiver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+namespace
+{
+
+std::uint64_t to_ns(double seconds)
+{
+    return seconds > 0.0 ? static_cast<std::uint64_t>(std::llround(seconds * 1e9)) : 0;
+}
+
+double to_s(const std::atomic<std::uint64_t>& ns)
+{
+    return static_cast<double>(ns.load(std::memory_order_relaxed)) * 1e-9;
+}
+
+std::uint64_t load(const std::atomic<std::uint64_t>& value)
+{
+    return value.load(std::memory_order_relaxed);
+}
+
+// One metric family: HELP and TYPE lines, then its samples.
+class Exposition
+{
+public:
+    void family(const char* name, const char* type, const char* help)
+    {
+        out_ << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+    }
+
+    template <typename T>
+    void sample(const std::string& name, T value, const std::string& labels = {})
+    {
+        out_ << name;
+        if (!labels.empty()) {
+            out_ << '{' << labels << '}';
+        }
+        out_ << ' ' << value << '\n';
+    }
+
+    std::string str() const { return out_.str(); }
+
+private:
+    std::ostringstream out_;
+};
+
+} // namespace
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(values.size())));
+    return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+void LatencyHistogram::observe(double seconds)
+{
+    const auto bucket = static_cast<std::size_t>(
+        std::lower_bound(kBounds.begin(), kBounds.end(), seconds) - kBounds.begin());
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(to_ns(seconds), std::memory_order_relaxed);
+}
+
+std::array<std::uint64_t, LatencyHistogram::kBuckets> LatencyHistogram::counts() const
+{
+    std::array<std::uint64_t, kBuckets> counts{};
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+        counts[b] = load(buckets_[b]);
+    }
+    return counts;
+}
+
+std::uint64_t LatencyHistogram::count() const
+{
+    std::uint64_t total = 0;
+    for (const auto& bucket : buckets_) {
+        total += load(bucket);
+    }
+    return total;
+}
+
+double LatencyHistogram::sum() const
+{
+    return to_s(sum_ns_);
+}
+
+void ReceiverMetrics::record_packet(int sf, const lora_replay::StreamDecodeResult& result, double decode_ms)
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+    packets.fetch_add(1, relaxed);
+    if (result.header_ok) headers_ok.fetch_add(1, relaxed);
+    if (result.crc_ok) crc_ok.fetch_add(1, relaxed);
+    if (result.header_ok && result.crc_expected && !result.crc_ok) crc_failed.fetch_add(1, relaxed);
+    if (result.payload_mismatch) payload_mismatches.fetch_add(1, relaxed);
+    bit_errors.fetch_add(static_cast<std::uint64_t>(std::max(result.bit_errors, 0)), relaxed);
+    payload_bits.fetch_add(static_cast<std::uint64_t>(std::max(result.total_bits, 0)), relaxed);
+    paths[static_cast<std::size_t>(result.path)].fetch_add(1, relaxed);
+    decode_latency.observe(decode_ms * 1e-3);
+    effort_latency[static_cast<std::size_t>(result.effort)].observe(decode_ms * 1e-3);
+    if (result.budget_exhausted) budget_exhausted.fetch_add(1, relaxed);
+    if (sf >= kMinSf && sf <= kMaxSf) {
+        const auto k = static_cast<std::size_t>(sf - kMinSf);
+        sf_packets[k].fetch_add(1, relaxed);
+        sf_decode_ns[k].fetch_add(to_ns(decode_ms * 1e-3), relaxed);
+    }
+}
+
+void ReceiverMetrics::add_phases(const PhaseTimes& times)
+{
+    for (std::size_t p = 0; p < kDecodePhaseCount; ++p) {
+        phase_ns[p].fetch_add(to_ns(times.ns[p] * 1e-9), std::memory_order_relaxed);
+    }
+}
+
+std::string format_prometheus(const ReceiverMetrics& metrics, const ReceiverStats& stats,
+                              const StreamGauges& gauges)
+{
+    Exposition out;
+    const auto counter = [&](const char* name, const char* help, auto value) {
+        out.family(name, "counter", help);
+        out.sample(name, value);
+    };
+    const auto gauge = [&](const char* name, const char* help, auto value) {
+        out.family(name, "gauge", help);
+        out.sample(name, value);
+    };
+
+    counter("host_sim_packets_total", "Packets decoded (one per burst or per SF found in it)", load(metrics.packets));
+    counter("host_sim_headers_ok_total", "Packets whose header decoded", load(metrics.headers_ok));
+    counter("host_sim_crc_ok_total", "Packets whose payload CRC passed", load(metrics.crc_ok));
+    counter("host_sim_crc_failed_total", "Packets with a header whose payload CRC failed", load(metrics.crc_failed));
+    counter("host_sim_payload_mismatches_total", "Packets differing from the expected payload",
+            load(metrics.payload_mismatches));
+    counter("host_sim_bit_errors_total", "Payload bit errors against the expected payload", load(metrics.bit_errors));
+    counter("host_sim_payload_bits_total", "Payload bits compared against the expected payload",
+            load(metrics.payload_bits));
+
+    out.family("host_sim_decode_path_total", "counter", "Packets by the pass that locked the header");
+    for (std::size_t p = 0; p < lora_replay::kDecodePathCount; ++p) {
+        out.sample("host_sim_decode_path_total", load(metrics.paths[p]),
+                   std::string("path=\"") + lora_replay::decode_path_name(static_cast<lora_replay::DecodePath>(p)) + '"');
+    }
+
+    // Buckets, sum and count of one histogram; @p labels prefix the le label.
+    const auto histogram = [&](const std::string& name, const LatencyHistogram& h, const std::string& labels) {
+        const auto buckets = h.counts();
+        const std::string prefix = labels.empty() ? labels : labels + ',';
+        std::uint64_t cumulative = 0;
+        for (std::size_t b = 0; b < LatencyHistogram::kBuckets; ++b) {
+            cumulative += buckets[b];
+            std::ostringstream le;
+            if (b < LatencyHistogram::kBounds.size()) {
+                le << prefix << "le=\"" << LatencyHistogram::kBounds[b] << '"';
+            } else {
+                le << prefix << "le=\"+Inf\"";
+            }
+            out.sample(name + "_bucket", cumulative, le.str());
+        }
+        out.sample(name + "_sum", h.sum(), labels);
+        out.sample(name + "_count", cumulative, labels);
+    };
+    out.family("host_sim_decode_latency_seconds", "histogram", "Wall time to decode one packet");
+    histogram("host_sim_decode_latency_seconds", metrics.decode_latency, "");
+    out.family("host_sim_decode_effort_latency_seconds", "histogram",
+               "Wall time to decode one packet, by the deepest effort tier it reached");
+    for (std::size_t e = 0; e < lora_replay::kDecodeEffortCount; ++e) {
+        histogram("host_sim_decode_effort_latency_seconds", metrics.effort_latency[e],
+                  std::string("effort=\"") + lora_replay::decode_effort_name(static_cast<lora_replay::DecodeEffort>(e)) +
+                      '"');
+    }
+    counter("host_sim_decode_budget_exhausted_total", "Decodes that stopped escalating at the time budget",
+            load(metrics.budget_exhausted));
+    counter("host_sim_recoveries_queued_total", "Failed packets handed to the recovery thread",
+            load(metrics.recoveries_queued));
+    counter("host_sim_recoveries_dropped_total", "Recoveries skipped because the recovery queue was full",
+            load(metrics.recoveries_dropped));
+    counter("host_sim_recoveries_ok_total", "Recovery re-decodes that came out clean", load(metrics.recoveries_ok));
+    counter("host_sim_collision_packets_total", "Packets decoded from a burst after cancelling another",
+            load(metrics.collision_packets));
+
+    out.family("host_sim_phase_seconds_total", "counter", "Wall time on receiver threads by decode phase");
+    for (std::size_t p = 0; p < kDecodePhaseCount; ++p) {
+        out.sample("host_sim_phase_seconds_total", to_s(metrics.phase_ns[p]),
+                   std::string("phase=\"") + phase_name(static_cast<DecodePhase>(p)) + '"');
+    }
+    counter("host_sim_decode_cpu_seconds_total", "Thread CPU time spent decoding bursts", to_s(metrics.decode_cpu_ns));
+
+    out.family("host_sim_sf_packets_total", "counter", "Packets decoded per spreading factor");
+    for (std::size_t k = 0; k < ReceiverMetrics::kSfCount; ++k) {
+        if (load(metrics.sf_packets[k]) > 0) {
+            out.sample("host_sim_sf_packets_total", load(metrics.sf_packets[k]),
+                       "sf=\"" + std::to_string(ReceiverMetrics::kMinSf + static_cast<int>(k)) + '"');
+        }
+    }
+    out.family("host_sim_sf_decode_seconds_total", "counter", "Decode wall time per spreading factor");
+    for (std::size_t k = 0; k < ReceiverMetrics::kSfCount; ++k) {
+        if (load(metrics.sf_packets[k]) > 0) {
+            out.sample("host_sim_sf_decode_seconds_total", to_s(metrics.sf_decode_ns[k]),
+                       "sf=\"" + std::to_string(ReceiverMetrics::kMinSf + static_cast<int>(k)) + '"');
+        }
+    }
+
+    counter("host_sim_bursts_queued_total", "Bursts handed to the decoders", stats.bursts_queued);
+    counter("host_sim_bursts_dropped_total", "Bursts dropped because the decoders were busy", stats.bursts_dropped);
+    counter("host_sim_detector_stalls_total", "Detection steps that waited for a free decoder", stats.detector_stalls);
+    gauge("host_sim_decoders", "Decoder threads", stats.decoders);
+    gauge("host_sim_decode_queue_high_water", "Most bursts ever waiting for a decoder", stats.queue_high_water);
+    gauge("host_sim_decode_queue_capacity", "Bursts the decode queue holds", stats.queue_capacity);
+
+    gauge("host_sim_uptime_seconds", "Wall time since the stream started", gauges.uptime_s);
+    gauge("host_sim_stream_seconds", "Input consumed, in stream time", gauges.stream_s);
+    gauge("host_sim_realtime_lag_seconds", "Wall time minus stream time; grows while decoding falls behind",
+          gauges.uptime_s - gauges.stream_s);
+    gauge("host_sim_packets_per_second", "Packet rate over the last snapshot interval", gauges.packets_per_s);
+    gauge("host_sim_reader_buffered_samples", "Samples waiting in the input ring", gauges.reader_buffered);
+    gauge("host_sim_reader_capacity_samples", "Input ring capacity", gauges.reader_capacity);
+    counter("host_sim_reader_overflows_total", "Input ring overflows", gauges.reader_overflows);
+    counter("host_sim_reader_dropped_samples_total", "Input samples dropped on overflow", gauges.reader_dropped_samples);
+    counter("host_sim_source_overflows_total", "Overflows reported by the IQ source", gauges.source_overflows);
+    counter("host_sim_source_lost_samples_total", "Samples the IQ source lost upstream", gauges.source_lost_samples);
+    return out.str();
+}
+
+void write_metrics_file(const std::filesystem::path& path, const std::string& text)
+{
+    auto staging = path;
+    staging += ".tmp";
+    {
+        std::ofstream out(staging, std::ios::trunc);
+        if (!out || !(out << text) || !out.flush()) {
+            throw std::runtime_error("Failed to write metrics file: " + staging.string());
+        }
+    }
+    std::filesystem::rename(staging, path);
+}
+
+} // namespace host_sim
@@ -0,0 +1,297 @@
+#include "host_sim/packet_sink.hpp"
+
+#include "host_sim/receiver.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace host_sim
+{
+
+namespace
+{
+
+constexpr std::uint8_t kBinaryVersion = 2;
+constexpr std::size_t kBinaryFixedBytes = 8 + 3 * 8 + 8 + 3 * 4 + 2;   // after the size field
+
+template <typename T>
+void put_le(std::string& out, T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+template <typename T>
+T get_le(const std::uint8_t* in)
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+void put_f32(std::string& out, float value)
+{
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof bits);
+    put_le(out, bits);
+}
+
+void put_f64(std::string& out, double value)
+{
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof bits);
+    put_le(out, bits);
+}
+
+float get_f32(const std::uint8_t* in)
+{
+    const auto bits = get_le<std::uint32_t>(in);
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+double get_f64(const std::uint8_t* in)
+{
+    const auto bits = get_le<std::uint64_t>(in);
+    double value = 0.0;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+const char* json_bool(bool value)
+{
+    return value ? "true" : "false";
+}
+
+} // namespace
+
+PacketRecord make_packet_record(ReceivedPacket pkt, std::uint64_t index, std::size_t sample_scale,
+                                int sample_rate)
+{
+    PacketRecord record;
+    record.index = index;
+    record.start_sample = static_cast<std::uint64_t>(pkt.start * sample_scale);
+    record.length = static_cast<std::uint64_t>(pkt.length * sample_scale);
+    record.time_s = static_cast<double>(record.start_sample) / sample_rate;
+    record.duration_s = static_cast<double>(record.length) / sample_rate;
+    record.sf = pkt.sf;
+    record.cr = pkt.result.cr;
+    record.snr_db = pkt.snr_db;
+    record.cfo_hz = pkt.result.cfo_hz;
+    record.decode_ms = pkt.decode_ms;
+    record.header_ok = pkt.result.header_ok;
+    record.crc_expected = pkt.result.crc_expected;
+    record.crc_ok = pkt.result.crc_ok;
+    record.payload_mismatch = pkt.result.payload_mismatch;
+    record.path = pkt.result.path;
+    record.effort = pkt.result.effort;
+    record.budget_exhausted = pkt.result.budget_exhausted;
+    record.recovered = pkt.recovered;
+    record.payload = std::move(pkt.result.payload);
+    record.report = std::move(pkt.report);
+    return record;
+}
+
+void append_text_record(const PacketRecord& record, bool show_sf, std::string& out)
+{
+    std::ostringstream text;
+    text << "\n=== Packet #" << record.index << " ===\n"
+         << "Burst at sample " << record.start_sample << " (" << std::fixed << std::setprecision(1)
+         << record.time_s * 1000.0 << " ms), " << record.length << " samples ("
+         << record.duration_s * 1000.0 << " ms), SNR=" << record.snr_db << " dB";
+    if (show_sf) {
+        text << ", SF=" << record.sf;
+    }
+    text << "\n" << record.report;
+    if (record.payload_mismatch) {
+        text << "[payload] MISMATCH (stream packet #" << record.index << ")\n";
+    }
+    if (!record.header_ok) {
+        text << "[stream] packet #" << record.index << ": header decode failed\n";
+    }
+    if (record.recovered) {
+        text << "[stream] packet #" << record.index << ": recovered by a deferred exhaustive decode\n";
+    }
+    text << "[stream] decode latency: " << record.decode_ms << " ms\n";
+    out += text.str();
+}
+
+void append_ndjson_record(const PacketRecord& record, std::string& out)
+{
+    std::ostringstream line;
+    line << "{\"index\":" << record.index << ",\"start_sample\":" << record.start_sample
+         << ",\"length\":" << record.length << std::fixed << std::setprecision(6)
+         << ",\"time_s\":" << record.time_s << ",\"duration_s\":" << record.duration_s
+         << ",\"sf\":" << record.sf << ",\"cr\":" << record.cr << std::setprecision(2)
+         << ",\"snr_db\":" << record.snr_db << ",\"cfo_hz\":" << record.cfo_hz
+         << ",\"header_ok\":" << json_bool(record.header_ok)
+         << ",\"crc_expected\":" << json_bool(record.crc_expected)
+         << ",\"crc_ok\":" << json_bool(record.crc_ok)
+         << ",\"payload_mismatch\":" << json_bool(record.payload_mismatch)
+         << ",\"path\":\"" << lora_replay::decode_path_name(record.path) << "\""
+         << ",\"effort\":\"" << lora_replay::decode_effort_name(record.effort) << "\"";
+    if (record.budget_exhausted) {
+        line << ",\"budget_exhausted\":true";
+    }
+    if (record.recovered) {
+        line << ",\"recovered\":true";
+    }
+    if (record.source_time_ns) {
+        line << ",\"source_time_ns\":" << *record.source_time_ns;
+    }
+    line << ",\"decode_ms\":"
+         << std::setprecision(3) << record.decode_ms << ",\"payload\":\"" << std::hex << std::setfill('0');
+    for (const std::uint8_t byte : record.payload) {
+        line << std::setw(2) << static_cast<int>(byte);
+    }
+    line << "\"}\n";
+    out += line.str();
+}
+
+void append_binary_record(const PacketRecord& record, std::string& out)
+{
+    const auto n = static_cast<std::uint16_t>(std::min<std::size_t>(record.payload.size(), 0xFFFF));
+    put_le(out, static_cast<std::uint32_t>(kBinaryFixedBytes + n + 8));
+    put_le(out, kBinaryVersion);
+    put_le(out, static_cast<std::uint8_t>((record.header_ok ? 1 : 0) | (record.crc_expected ? 2 : 0) |
+                                          (record.crc_ok ? 4 : 0) | (record.payload_mismatch ? 8 : 0) |
+                                          (record.source_time_ns ? 16 : 0) | (record.budget_exhausted ? 32 : 0) |
+                                          (record.recovered ? 64 : 0)));
+    put_le(out, static_cast<std::uint8_t>(record.sf));
+    put_le(out, static_cast<std::uint8_t>(record.cr));
+    put_le(out, static_cast<std::uint8_t>(record.path));
+    put_le(out, static_cast<std::uint8_t>(record.effort));
+    out.append(2, '\0');
+    put_le(out, record.index);
+    put_le(out, record.start_sample);
+    put_le(out, record.length);
+    put_f64(out, record.time_s);
+    put_f32(out, record.snr_db);
+    put_f32(out, record.cfo_hz);
+    put_f32(out, static_cast<float>(record.decode_ms));
+    put_le(out, n);
+    out.append(reinterpret_cast<const char*>(record.payload.data()), n);
+    put_le(out, record.source_time_ns.value_or(0));
+}
+
+std::size_t parse_binary_record(std::span<const std::uint8_t> data, PacketRecord& out)
+{
+    if (data.size() < 4) {
+        return 0;
+    }
+    const std::size_t size = get_le<std::uint32_t>(data.data());
+    if (data.size() < 4 + size) {
+        return 0;
+    }
+    const std::uint8_t* p = data.data() + 4;
+    const std::uint8_t version = p[0];
+    const std::uint8_t flags = p[1];
+    if (version < 1 || size < kBinaryFixedBytes) {
+        throw std::runtime_error("Malformed packet record (version " + std::to_string(p[0]) + ")");
+    }
+    out = PacketRecord{};
+    out.header_ok = (p[1] & 1) != 0;
+    out.crc_expected = (p[1] & 2) != 0;
+    out.crc_ok = (p[1] & 4) != 0;
+    out.payload_mismatch = (p[1] & 8) != 0;
+    out.budget_exhausted = (p[1] & 32) != 0;
+    out.recovered = (p[1] & 64) != 0;
+    out.sf = p[2];
+    out.cr = p[3];
+    out.path = p[4] < lora_replay::kDecodePathCount ? static_cast<lora_replay::DecodePath>(p[4])
+                                                    : lora_replay::DecodePath::none;
+    out.effort = p[5] < lora_replay::kDecodeEffortCount ? static_cast<lora_replay::DecodeEffort>(p[5])
+                                                        : lora_replay::DecodeEffort::fast;
+    p += 8;
+    out.index = get_le<std::uint64_t>(p);
+    out.start_sample = get_le<std::uint64_t>(p + 8);
+    out.length = get_le<std::uint64_t>(p + 16);
+    out.time_s = get_f64(p + 24);
+    out.snr_db = get_f32(p + 32);
+    out.cfo_hz = get_f32(p + 36);
+    out.decode_ms = get_f32(p + 40);
+    const std::size_t n = get_le<std::uint16_t>(p + 44);
+    if (kBinaryFixedBytes + n > size) {
+        throw std::runtime_error("Truncated packet record");
+    }
+    out.payload.assign(p + 46, p + 46 + n);
+    if (version >= 2 && (flags & 16) != 0 && kBinaryFixedBytes + n + 8 <= size) {
+        out.source_time_ns = get_le<std::int64_t>(p + 46 + n);
+    }
+    return 4 + size;
+}
+
+// ── PacketSink ──────────────────────────────────────────────────────
+
+PacketSink::PacketSink(std::ostream& out, PacketSinkConfig config)
+    : out_(out),
+      config_(config),
+      queue_(std::max<std::size_t>(config.queue_capacity, 2)),
+      writer_([this] { writer_main(); })
+{
+}
+
+PacketSink::~PacketSink()
+{
+    queue_.close();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void PacketSink::write(PacketRecord record)
+{
+    if (!queue_.push(record)) {
+        throw std::runtime_error("PacketSink::write() after close()");
+    }
+}
+
+void PacketSink::close()
+{
+    queue_.close();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void PacketSink::writer_main()
+{
+    const std::size_t max_batch = std::max<std::size_t>(config_.max_batch, 1);
+    std::string buffer;
+    PacketRecord record;
+    while (queue_.pop(record)) {
+        buffer.clear();
+        std::size_t batch = 0;
+        do {
+            switch (config_.format) {
+            case PacketFormat::text: append_text_record(record, config_.show_sf, buffer); break;
+            case PacketFormat::ndjson: append_ndjson_record(record, buffer); break;
+            case PacketFormat::binary: append_binary_record(record, buffer); break;
+            }
+            ++batch;
+        } while (batch < max_batch && queue_.try_pop(record));
+        if (error_) {
+            continue;   // keep draining so write() never blocks on a dead writer
+        }
+        out_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out_.flush();
+        if (!out_) {
+            error_ = std::make_exception_ptr(std::runtime_error("Failed to write packet output"));
+            continue;
+        }
+        written_.fetch_add(batch, std::memory_order_relaxed);
+    }
+}
+
+} // namespace host_sim
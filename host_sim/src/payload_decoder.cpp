@@ -0,0 +1,112 @@
+#include "host_sim/payload_decoder.hpp"
+
+#include "host_sim/hamming.hpp"
+#include "host_sim/whitening.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+PayloadDecoder::PayloadDecoder(const PayloadDecoderConfig& config)
+    : config_(config), block_cfg_{config.sf, config.cr, false, config.ldro}
+{
+    if (config_.cr < 1 || config_.cr > 4) {
+        throw std::runtime_error("PayloadDecoder: coding rate must be 1..4");
+    }
+    if (config_.payload_len < 0 || config_.payload_len > 255) {
+        throw std::runtime_error("PayloadDecoder: payload length must be 0..255");
+    }
+    target_ = static_cast<std::size_t>(config_.payload_len) + (config_.has_crc ? 2u : 0u);
+}
+
+void PayloadDecoder::push_nibble(uint8_t nibble)
+{
+    if (complete()) {
+        return;
+    }
+    if (pending_nibble_ < 0) {
+        pending_nibble_ = nibble & 0xF;
+        return;
+    }
+    // Low nibble first (gr-lora_sdr); settle() dewhitens the new bytes.
+    const auto byte = static_cast<uint8_t>(((nibble & 0xF) << 4) | pending_nibble_);
+    pending_nibble_ = -1;
+    bytes_[size_++] = byte;
+}
+
+void PayloadDecoder::settle(std::size_t from)
+{
+    // Only payload bytes are whitened, and the CRC covers all but the last
+    // two of them; the CRC bytes after the payload stay as received.
+    const auto pl = static_cast<std::size_t>(config_.payload_len);
+    const std::size_t white_end = std::min(size_, pl);
+    if (from >= white_end) {
+        return;
+    }
+    const std::size_t crc_end = pl >= 2 ? std::clamp(pl - 2, from, white_end) : from;
+    const std::span<uint8_t> fresh(bytes_.data() + from, white_end - from);
+    crc_ = dewhiten_then_crc16(fresh.first(crc_end - from), crc_, from);
+    whiten_in_place(fresh.subspan(crc_end - from), crc_end);
+}
+
+void PayloadDecoder::push_nibbles(const uint8_t* nibbles, std::size_t count)
+{
+    const std::size_t from = size_;
+    for (std::size_t i = 0; i < count; ++i) {
+        push_nibble(nibbles[i]);
+    }
+    settle(from);
+}
+
+std::size_t PayloadDecoder::push_block(const uint16_t* symbols, std::size_t count)
+{
+    const std::size_t cw_len = block_symbols();
+    if (!needs_more() || count < cw_len) {
+        return 0;
+    }
+    uint8_t codewords[kMaxInterleaverRows];
+    const std::size_t n = deinterleave_block(symbols, cw_len, block_cfg_, codewords);
+    const std::size_t from = size_;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (hamming_uncorrectable(codewords[i], config_.cr)) {
+            ++uncorrectable_;
+        }
+        push_nibble(hamming_decode(codewords[i], config_.cr));
+    }
+    settle(from);
+    codewords_ += n;
+    // Random symbols flag 44-75% of codewords (CR 4/8, 4/5, 4/6); a packet
+    // that can still pass its CRC, hardly ever a third.
+    if (config_.max_uncorrectable >= 0 && uncorrectable_ > static_cast<std::size_t>(config_.max_uncorrectable) &&
+        3 * uncorrectable_ > codewords_ && !complete()) {
+        aborted_ = true;
+    }
+    return cw_len;
+}
+
+bool PayloadDecoder::crc_checked() const
+{
+    return config_.has_crc && config_.payload_len >= 2 && complete();
+}
+
+uint16_t PayloadDecoder::crc_computed() const
+{
+    if (!crc_checked()) {
+        return 0;
+    }
+    const std::size_t pl = static_cast<std::size_t>(config_.payload_len);
+    return static_cast<uint16_t>(crc_ ^ bytes_[pl - 1] ^ (static_cast<uint16_t>(bytes_[pl - 2]) << 8));
+}
+
+uint16_t PayloadDecoder::crc_received() const
+{
+    if (!crc_checked()) {
+        return 0;
+    }
+    const std::size_t pl = static_cast<std::size_t>(config_.payload_len);
+    return static_cast<uint16_t>(bytes_[pl] | (static_cast<uint16_t>(bytes_[pl + 1]) << 8));
+}
+
+} // namespace host_sim
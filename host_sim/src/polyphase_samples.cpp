@@ -0,0 +1,39 @@
+#include "host_sim/polyphase_samples.hpp"
+
+#include <stdexcept>
+
+namespace host_sim
+{
+
+PolyphaseSamples::PolyphaseSamples(std::span<const std::complex<float>> samples,
+                                   int oversample_factor,
+                                   std::pmr::memory_resource* memory)
+    : samples_(samples),
+      os_(oversample_factor),
+      plane_start_(memory),
+      re_(memory),
+      im_(memory)
+{
+    if (os_ < 1) {
+        throw std::runtime_error("PolyphaseSamples: oversample factor must be >= 1");
+    }
+    const auto os = static_cast<std::size_t>(os_);
+    plane_start_.resize(os);
+    std::size_t start = 0;
+    for (std::size_t p = 0; p < os; ++p) {
+        plane_start_[p] = start;
+        start += run_length(p);
+    }
+    re_.resize(samples_.size());
+    im_.resize(samples_.size());
+    for (std::size_t p = 0; p < os; ++p) {
+        float* re = re_.data() + plane_start_[p];
+        float* im = im_.data() + plane_start_[p];
+        for (std::size_t i = p, j = 0; i < samples_.size(); i += os, ++j) {
+            re[j] = samples_[i].real();
+            im[j] = samples_[i].imag();
+        }
+    }
+}
+
+} // namespace host_sim
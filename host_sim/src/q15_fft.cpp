@@ -0,0 +1,116 @@
+/// Q15 FFT and vector kernels behind one interface: KissFFT and scalar
+/// loops by default, CMSIS-DSP (arm_cfft_q15, arm_cmplx_mult_cmplx_q15)
+/// when built with HOST_SIM_WITH_CMSIS_DSP.
+
+#include "host_sim/q15_fft.hpp"
+#include "host_sim/shared_cache.hpp"
+
+extern "C" {
+#include "kiss_fft_q15.h"
+}
+
+#if defined(HOST_SIM_WITH_CMSIS_DSP)
+#include "arm_const_structs.h"
+#include "arm_math.h"
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace host_sim
+{
+
+namespace
+{
+
+#if defined(HOST_SIM_WITH_CMSIS_DSP)
+const arm_cfft_instance_q15* cmsis_cfft_instance(int nfft)
+{
+    switch (nfft) {
+    case 16: return &arm_cfft_sR_q15_len16;
+    case 32: return &arm_cfft_sR_q15_len32;
+    case 64: return &arm_cfft_sR_q15_len64;
+    case 128: return &arm_cfft_sR_q15_len128;
+    case 256: return &arm_cfft_sR_q15_len256;
+    case 512: return &arm_cfft_sR_q15_len512;
+    case 1024: return &arm_cfft_sR_q15_len1024;
+    case 2048: return &arm_cfft_sR_q15_len2048;
+    case 4096: return &arm_cfft_sR_q15_len4096;
+    default: return nullptr;
+    }
+}
+
+static_assert(sizeof(Q15Complex) == 2 * sizeof(q15_t));
+#endif
+
+} // namespace
+
+kiss_fft_q15_cfg shared_q15_plan(int nfft)
+{
+    static SharedCache<int, kiss_fft_state> plans;
+    const auto plan = plans.get(nfft, [nfft] {
+        kiss_fft_q15_cfg cfg = kiss_fft_q15_alloc(nfft, 0, nullptr, nullptr);
+        if (!cfg) {
+            throw std::runtime_error("Failed to allocate Q15 KISS FFT configuration");
+        }
+        return std::shared_ptr<const kiss_fft_state>(cfg, [](const kiss_fft_state* p) {
+            kiss_fft_q15_free(const_cast<kiss_fft_state*>(p));
+        });
+    });
+    // The cache keeps the plan alive until exit.
+    return const_cast<kiss_fft_q15_cfg>(plan.get());
+}
+
+Q15Fft::Q15Fft(int nfft)
+    : nfft_(nfft)
+{
+#if defined(HOST_SIM_WITH_CMSIS_DSP)
+    plan_ = cmsis_cfft_instance(nfft);
+    if (!plan_) {
+        throw std::runtime_error("CMSIS-DSP has no Q15 CFFT of size " + std::to_string(nfft));
+    }
+#else
+    plan_ = shared_q15_plan(nfft);
+#endif
+}
+
+void Q15Fft::forward(const Q15Complex* in, Q15Complex* out) const
+{
+#if defined(HOST_SIM_WITH_CMSIS_DSP)
+    // arm_cfft_q15 works in place on interleaved q15_t and already
+    // scales down by one bit per radix-2 stage.
+    std::copy(in, in + nfft_, out);
+    arm_cfft_q15(static_cast<const arm_cfft_instance_q15*>(plan_), reinterpret_cast<q15_t*>(out), 0, 1);
+#else
+    kiss_fft_q15(static_cast<kiss_fft_q15_cfg>(const_cast<void*>(plan_)),
+                 reinterpret_cast<const kiss_fft_q15_cpx*>(in),
+                 reinterpret_cast<kiss_fft_q15_cpx*>(out));
+#endif
+}
+
+const char* Q15Fft::backend_name()
+{
+#if defined(HOST_SIM_WITH_CMSIS_DSP)
+    return "cmsis-dsp";
+#else
+    return "kissfft";
+#endif
+}
+
+void q15_cmplx_mult(const Q15Complex* a, const Q15Complex* b, Q15Complex* out, std::size_t n)
+{
+#if defined(HOST_SIM_WITH_CMSIS_DSP)
+    auto* dst = reinterpret_cast<q15_t*>(out);
+    arm_cmplx_mult_cmplx_q15(reinterpret_cast<const q15_t*>(a), reinterpret_cast<const q15_t*>(b), dst,
+                             static_cast<uint32_t>(n));
+    arm_shift_q15(dst, 2, dst, static_cast<uint32_t>(2 * n));
+#else
+    for (std::size_t k = 0; k < n; ++k) {
+        out[k] = q15_mul(a[k], b[k]);
+    }
+#endif
+}
+
+} // namespace host_sim
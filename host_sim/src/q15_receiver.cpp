@@ -0,0 +1,527 @@
+/// Fixed-point LoRa receive chain: integer burst detection, block AGC,
+/// Q15 alignment scan, integer CFO estimate and an MCU cycle model.
+
+#include "host_sim/q15_receiver.hpp"
+#include "host_sim/dsp_kernels.hpp"
+#include "host_sim/header_locator.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/payload_decoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+namespace
+{
+
+// atan(2^-i) in units of 2^-31 turns.
+constexpr std::array<int32_t, 16> kCordicAtan = {
+    268435456, 158466703, 83729454, 42502378, 21333666, 10677233, 5339919, 2670123,
+    1335082,   667543,    333772,   166886,   83443,    41722,    20861,   10430,
+};
+
+// Peak of a Q15 spectrum, |X|² in int64.
+kernels::PeakPairQ15 spectrum_peak(const std::vector<Q15Complex>& spectrum, int n)
+{
+    static_assert(sizeof(Q15Complex) == 2 * sizeof(int16_t));
+    return kernels::find_two_peaks_q15(reinterpret_cast<const int16_t*>(spectrum.data()), n);
+}
+
+int64_t magnitude_sq(const Q15Complex& v)
+{
+    return static_cast<int64_t>(v.real) * v.real + static_cast<int64_t>(v.imag) * v.imag;
+}
+
+} // namespace
+
+// ── Integer burst detection ──
+
+std::optional<Q15BurstStart> detect_burst_q15(const Q15Complex* samples,
+                                              std::size_t n_samples,
+                                              int samples_per_symbol,
+                                              uint32_t threshold_factor,
+                                              std::size_t search_from,
+                                              int min_consec,
+                                              Q15OpCounts* ops)
+{
+    if (!samples || n_samples == 0 || samples_per_symbol <= 0) {
+        return std::nullopt;
+    }
+    const auto window = static_cast<std::size_t>(samples_per_symbol);
+    const std::size_t n_windows = n_samples / window;
+    if (n_windows < 3) {
+        return std::nullopt;
+    }
+    // Each |x|² fits in 31 bits, so their window mean does too.
+    std::vector<uint32_t> powers(n_windows);
+    for (std::size_t w = 0; w < n_windows; ++w) {
+        const Q15Complex* p = samples + w * window;
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < window; ++i) {
+            acc += static_cast<uint64_t>(magnitude_sq(p[i]));
+        }
+        powers[w] = static_cast<uint32_t>(acc / window);
+    }
+    if (ops) {
+        ops->detect_samples += static_cast<uint64_t>(n_windows) * window;
+    }
+
+    std::vector<uint32_t> sorted(powers);
+    const std::size_t q1_end = std::max<std::size_t>(1, n_windows / 4);
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(q1_end - 1), sorted.end());
+    uint64_t noise_acc = 0;
+    for (std::size_t i = 0; i < q1_end; ++i) {
+        noise_acc += sorted[i];
+    }
+    const auto noise = static_cast<uint32_t>(noise_acc / q1_end);
+    const uint64_t threshold = static_cast<uint64_t>(noise) * threshold_factor;
+
+    const std::size_t start_window = search_from / window;
+    const int needed = std::max(1, min_consec);
+    int consec = 0;
+    std::size_t first_high = 0;
+    for (std::size_t w = start_window; w < n_windows; ++w) {
+        if (powers[w] <= threshold) {
+            consec = 0;
+            continue;
+        }
+        if (consec == 0) {
+            first_high = w;
+        }
+        if (++consec < needed) {
+            continue;
+        }
+        const std::size_t margin = std::min<std::size_t>(2, first_high - start_window);
+        return Q15BurstStart{(first_high - margin) * window, noise, powers[first_high]};
+    }
+    return std::nullopt;
+}
+
+// ── Integer phase ──
+
+int16_t atan2_q15_turns(int64_t y, int64_t x)
+{
+    if (x == 0 && y == 0) {
+        return 0;
+    }
+    // Into the right half-plane (a half-turn rotation), then bring the
+    // vector to 27..29 bits so the CORDIC gain (1.65) stays inside int32.
+    int32_t angle = 0;
+    if (x < 0) {
+        angle = y >= 0 ? (1 << 30) : -(1 << 30);
+        x = -x;
+        y = -y;
+    }
+    uint64_t span = static_cast<uint64_t>(std::max(x, y < 0 ? -y : y));
+    while (span >= (uint64_t{1} << 29)) {
+        x >>= 1;
+        y >>= 1;
+        span >>= 1;
+    }
+    while (span < (uint64_t{1} << 27)) {
+        x *= 2;
+        y *= 2;
+        span <<= 1;
+    }
+    auto xi = static_cast<int32_t>(x);
+    auto yi = static_cast<int32_t>(y);
+    for (std::size_t i = 0; i < kCordicAtan.size(); ++i) {
+        const int32_t dx = yi >> i;
+        const int32_t dy = xi >> i;
+        if (yi > 0) {
+            xi += dx;
+            yi -= dy;
+            angle += kCordicAtan[i];
+        } else {
+            xi -= dx;
+            yi += dy;
+            angle -= kCordicAtan[i];
+        }
+    }
+    // 2^-31 → 2^-16 turns; a full half turn wraps to -0.5.
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(angle >> 15) & 0xFFFF));
+}
+
+// ── Cycle model ──
+
+Q15OpCounts& Q15OpCounts::operator+=(const Q15OpCounts& other)
+{
+    detect_samples += other.detect_samples;
+    agc_samples += other.agc_samples;
+    complex_macs += other.complex_macs;
+    ffts += other.ffts;
+    fft_butterflies += other.fft_butterflies;
+    peak_bins += other.peak_bins;
+    cordic_steps += other.cordic_steps;
+    return *this;
+}
+
+std::span<const McuCostModel> mcu_cost_models()
+{
+    // M0+: 32-bit single-cycle multiplier, no SIMD.  M4F: dual 16-bit MACs
+    // (SMLAD/SMUAD) and CMSIS radix-4 butterflies.  M7: dual issue on top.
+    static const std::array<McuCostModel, 3> models = {{
+        {"cortex-m0plus", 48.0, 6.0, 5.0, 14.0, 40.0, 8.0, 8.0},
+        {"cortex-m4f", 80.0, 2.0, 2.0, 4.0, 10.0, 2.0, 5.0},
+        {"cortex-m7", 216.0, 1.0, 1.0, 2.0, 5.0, 1.0, 3.0},
+    }};
+    return models;
+}
+
+McuCycleEstimate estimate_mcu_cycles(const Q15OpCounts& ops,
+                                     std::size_t symbols,
+                                     double symbol_period_s,
+                                     const McuCostModel& model)
+{
+    McuCycleEstimate estimate;
+    estimate.name = model.name;
+    estimate.freq_mhz = model.freq_mhz;
+    estimate.cycles = static_cast<double>(ops.detect_samples) * model.detect_sample +
+                      static_cast<double>(ops.agc_samples) * model.agc_sample +
+                      static_cast<double>(ops.complex_macs) * model.complex_mac +
+                      static_cast<double>(ops.fft_butterflies) * model.fft_butterfly +
+                      static_cast<double>(ops.peak_bins) * model.peak_bin +
+                      static_cast<double>(ops.cordic_steps) * model.cordic_step;
+    estimate.cycles_per_symbol_budget = model.freq_mhz * 1e6 * symbol_period_s;
+    if (symbols > 0) {
+        estimate.cycles_per_symbol = estimate.cycles / static_cast<double>(symbols);
+    }
+    if (estimate.cycles_per_symbol_budget > 0.0) {
+        estimate.utilisation = estimate.cycles_per_symbol / estimate.cycles_per_symbol_budget;
+    }
+    return estimate;
+}
+
+// ── Q15Receiver ──
+
+Q15Receiver::Q15Receiver(int sf, int sample_rate, int bandwidth)
+    : sf_(sf),
+      n_bins_(1 << sf),
+      os_(std::max(1, sample_rate / bandwidth)),
+      sps_((1 << sf) * std::max(1, sample_rate / bandwidth)),
+      chirps_(shared_chirps_q15(sf, std::max(1, sample_rate / bandwidth))),
+      fft_(1 << sf),
+      demod_(sf, sample_rate, bandwidth)
+{
+    fft_in_.resize(static_cast<std::size_t>(n_bins_));
+    fft_out_.resize(static_cast<std::size_t>(n_bins_));
+    mag_per_bin_.resize(static_cast<std::size_t>(n_bins_));
+}
+
+void Q15Receiver::dechirp_fft(const Q15Complex* samples, int fold_stride, Q15Complex* out)
+{
+    // The taps of a bin are summed in 32 bits and scaled back by the next
+    // power of two, so the fold cannot overflow.
+    const int taps = (os_ + fold_stride - 1) / fold_stride;
+    const int shift = std::bit_width(static_cast<unsigned>(taps - 1));
+    const Q15Complex* chirp = chirps_->downchirp.data();
+    for (int k = 0; k < n_bins_; ++k) {
+        const int base = k * os_;
+        int32_t re = 0;
+        int32_t im = 0;
+        for (int m = 0; m < os_; m += fold_stride) {
+            const Q15Complex p = q15_mul(samples[base + m], chirp[base + m]);
+            re += p.real;
+            im += p.imag;
+        }
+        fft_in_[static_cast<std::size_t>(k)] = {static_cast<int16_t>(re >> shift),
+                                                static_cast<int16_t>(im >> shift)};
+    }
+    fft_.forward(fft_in_.data(), out);
+    ops_.complex_macs += static_cast<uint64_t>(n_bins_) * static_cast<uint64_t>(taps);
+    ops_.ffts += 1;
+    ops_.fft_butterflies += static_cast<uint64_t>(n_bins_ / 2) * static_cast<uint64_t>(sf_);
+}
+
+PreambleSearchResult Q15Receiver::align(std::span<const Q15Complex> samples, int preamble_symbols)
+{
+    PreambleSearchResult result{};
+    if (preamble_symbols <= 0 || samples.size() < static_cast<std::size_t>(sps_) * preamble_symbols) {
+        return result;
+    }
+    const int n = n_bins_;
+    peaks_.resize(static_cast<std::size_t>(preamble_symbols));
+
+    // Coarse scan: strided offsets, partial fold, four symbols, scored by
+    // the accumulated peak magnitude of the majority bin.
+    const int coarse_stride = std::max(1, os_ * 2);
+    const int coarse_steps = (sps_ + coarse_stride - 1) / coarse_stride;
+    const int coarse_preamble = std::min(preamble_symbols, 4);
+    const int coarse_fold_stride = std::max(1, os_ > 4 ? os_ / 2 : (os_ > 2 ? 2 : 1));
+
+    struct Candidate
+    {
+        int64_t mag{-1};
+        int offset{0};
+        int bin{0};
+    };
+    std::array<Candidate, 5> top{};
+    const int k_coarse = os_ > 4 ? 3 : 5;
+
+    for (int ci = 0; ci < coarse_steps; ++ci) {
+        const int offset = ci * coarse_stride;
+        std::fill(mag_per_bin_.begin(), mag_per_bin_.end(), 0);
+        int valid_syms = 0;
+        for (int sym = 0; sym < coarse_preamble; ++sym) {
+            const std::size_t base = static_cast<std::size_t>(offset) + static_cast<std::size_t>(sym) * sps_;
+            if (base + static_cast<std::size_t>(sps_) > samples.size()) break;
+            dechirp_fft(samples.data() + base, coarse_fold_stride, fft_out_.data());
+            const kernels::PeakPairQ15 peak = spectrum_peak(fft_out_, n);
+            ops_.peak_bins += static_cast<uint64_t>(n);
+            peaks_[static_cast<std::size_t>(sym)] = peak.best_bin;
+            mag_per_bin_[static_cast<std::size_t>(peak.best_bin)] += peak.best_mag;
+            mag_per_bin_[static_cast<std::size_t>((peak.best_bin - 1 + n) % n)] += peak.best_mag / 100;
+            mag_per_bin_[static_cast<std::size_t>((peak.best_bin + 1) % n)] += peak.best_mag / 100;
+            ++valid_syms;
+        }
+        const auto best = std::max_element(mag_per_bin_.begin(), mag_per_bin_.end());
+        const int best_bin = static_cast<int>(best - mag_per_bin_.begin());
+        int count_near = 0;
+        for (int sym = 0; sym < valid_syms; ++sym) {
+            int diff = std::abs(peaks_[static_cast<std::size_t>(sym)] - best_bin);
+            diff = std::min(diff, n - diff);
+            if (diff <= 1) ++count_near;
+        }
+        if (count_near < (coarse_preamble + 1) / 2) continue;
+        auto worst = std::min_element(top.begin(), top.begin() + k_coarse,
+                                      [](const Candidate& a, const Candidate& b) { return a.mag < b.mag; });
+        if (*best > worst->mag) {
+            *worst = {*best, offset, best_bin};
+        }
+    }
+
+    // Fine scan around each candidate with the full fold: a strided pass
+    // over four symbols, then sample by sample around its winner over the
+    // whole preamble.
+    struct Score
+    {
+        int64_t mag{-1};
+        int bin{0};
+    };
+    auto score_offset = [&](int offset, int n_syms) {
+        std::fill(mag_per_bin_.begin(), mag_per_bin_.end(), 0);
+        for (int sym = 0; sym < n_syms; ++sym) {
+            const std::size_t base = static_cast<std::size_t>(offset) + static_cast<std::size_t>(sym) * sps_;
+            if (base + static_cast<std::size_t>(sps_) > samples.size()) break;
+            dechirp_fft(samples.data() + base, 1, fft_out_.data());
+            const kernels::PeakPairQ15 peak = spectrum_peak(fft_out_, n);
+            ops_.peak_bins += static_cast<uint64_t>(n);
+            mag_per_bin_[static_cast<std::size_t>(peak.best_bin)] += peak.best_mag;
+        }
+        const auto best = std::max_element(mag_per_bin_.begin(), mag_per_bin_.end());
+        return Score{*best, static_cast<int>(best - mag_per_bin_.begin())};
+    };
+    const int fine_stride = std::max(2, os_ / 2);
+    const int fine_preamble_l1 = std::min(preamble_symbols, 4);
+
+    bool found = false;
+    int64_t best_mag = -1;
+    for (const Candidate& cand : top) {
+        if (cand.mag < 0) continue;
+        const int fine_start = std::max(0, cand.offset - coarse_stride);
+        const int fine_end = std::min(sps_ - 1, cand.offset + coarse_stride);
+        int l1_best = fine_start;
+        int64_t l1_mag = -1;
+        for (int offset = fine_start; offset <= fine_end; offset += fine_stride) {
+            const Score s = score_offset(offset, fine_preamble_l1);
+            if (s.mag > l1_mag) {
+                l1_mag = s.mag;
+                l1_best = offset;
+            }
+        }
+        const int l2_start = std::max(fine_start, l1_best - fine_stride);
+        const int l2_end = std::min(fine_end, l1_best + fine_stride);
+        for (int offset = l2_start; offset <= l2_end; ++offset) {
+            const Score s = score_offset(offset, preamble_symbols);
+            // A new offset has to beat the best so far by 0.1 %.
+            if (!found || s.mag * 1000 > best_mag * 1001) {
+                found = true;
+                best_mag = s.mag;
+                result.alignment_offset = static_cast<std::size_t>(offset);
+                result.preamble_bin = s.bin;
+            }
+        }
+    }
+    result.score = best_mag > 0 ? preamble_symbols : 0;
+    return result;
+}
+
+Q15Receiver::FrequencyEstimate Q15Receiver::estimate_frequency_offsets(const Q15Complex* samples,
+                                                                       int symbol_count)
+{
+    FrequencyEstimate estimate;
+    if (symbol_count <= 0) {
+        return estimate;
+    }
+    const auto n = static_cast<std::size_t>(n_bins_);
+    spectra_.resize(static_cast<std::size_t>(symbol_count) * n);
+    std::fill(mag_per_bin_.begin(), mag_per_bin_.end(), 0);
+    for (int sym = 0; sym < symbol_count; ++sym) {
+        Q15Complex* spectrum = spectra_.data() + static_cast<std::size_t>(sym) * n;
+        dechirp_fft(samples + static_cast<std::size_t>(sym) * sps_, 1, spectrum);
+        for (std::size_t bin = 0; bin < n; ++bin) {
+            mag_per_bin_[bin] += magnitude_sq(spectrum[bin]);
+        }
+    }
+    ops_.peak_bins += static_cast<uint64_t>(symbol_count) * n;
+    const auto global_bin = static_cast<std::size_t>(
+        std::max_element(mag_per_bin_.begin(), mag_per_bin_.end()) - mag_per_bin_.begin());
+
+    // Fractional part: phase advance of the preamble tone from one symbol
+    // to the next, Σ X_s · conj(X_s+1) in 64 bits.
+    if (symbol_count > 1) {
+        int64_t acc_re = 0;
+        int64_t acc_im = 0;
+        for (int sym = 0; sym + 1 < symbol_count; ++sym) {
+            const Q15Complex a = spectra_[static_cast<std::size_t>(sym) * n + global_bin];
+            const Q15Complex b = spectra_[static_cast<std::size_t>(sym + 1) * n + global_bin];
+            acc_re += static_cast<int64_t>(a.real) * b.real + static_cast<int64_t>(a.imag) * b.imag;
+            acc_im += static_cast<int64_t>(a.imag) * b.real - static_cast<int64_t>(a.real) * b.imag;
+        }
+        ops_.complex_macs += static_cast<uint64_t>(symbol_count - 1);
+        ops_.cordic_steps += kCordicAtan.size();
+        // -angle in turns is the offset in bins; halve it into Q15 bins,
+        // a half turn wrapping to -0.5.
+        int32_t turns = -static_cast<int32_t>(atan2_q15_turns(acc_im, acc_re));
+        if (turns == 32768) {
+            turns = -32768;
+        }
+        estimate.cfo_frac_q15 = static_cast<int16_t>(turns / 2);
+    }
+
+    int signed_bin = static_cast<int>(global_bin);
+    if (signed_bin > n_bins_ / 2) {
+        signed_bin -= n_bins_;
+    }
+    estimate.cfo_int = signed_bin;
+    return estimate;
+}
+
+Q15DecodeResult Q15Receiver::decode(std::span<const Q15Complex> burst, const LoRaMetadata& meta)
+{
+    if (meta.sf != sf_) {
+        throw std::runtime_error("Q15Receiver: metadata SF differs from the receiver's");
+    }
+    ops_ = {};
+    Q15DecodeResult result;
+    result.burst_symbols = burst.size() / static_cast<std::size_t>(sps_);
+    if (meta.implicit_header) {
+        return result;
+    }
+
+    // Block AGC: one shift for the whole burst.
+    scaled_.resize(burst.size());
+    result.agc_exponent = block_exponent_q15(burst.data(), burst.size());
+    scale_block_q15(burst.data(), burst.size(), result.agc_exponent, scaled_.data());
+    ops_.agc_samples += 2 * static_cast<uint64_t>(burst.size());
+    const std::span<const Q15Complex> samples(scaled_);
+
+    const PreambleSearchResult alignment = align(samples, meta.preamble_len);
+    std::size_t offset = alignment.alignment_offset;
+    const std::size_t available = samples.size() > offset ? (samples.size() - offset) / sps_ : 0;
+    const int preamble = static_cast<int>(
+        std::min<std::size_t>(static_cast<std::size_t>(std::max(meta.preamble_len - 1, 0)), available));
+    if (preamble <= 0) {
+        return result;
+    }
+    FrequencyEstimate cfo = estimate_frequency_offsets(samples.data() + offset, preamble);
+    if (alignment.preamble_bin != 0) {
+        int signed_bin = alignment.preamble_bin;
+        if (signed_bin > n_bins_ / 2) signed_bin -= n_bins_;
+        if (std::abs(signed_bin) > std::abs(cfo.cfo_int) + 2) {
+            cfo.cfo_int = signed_bin;
+        }
+    }
+    result.cfo_int = cfo.cfo_int;
+    result.cfo_frac_q15 = cfo.cfo_frac_q15;
+
+    // Symbols on a fixed grid from `from`, replacing symbols_.
+    auto demodulate_from = [&](std::size_t from, std::size_t max_symbols) {
+        demod_.set_frequency_offsets(q15_to_float(cfo.cfo_frac_q15), cfo.cfo_int, 0.0f);
+        demod_.reset_symbol_counter();
+        const std::size_t count = std::min(max_symbols, (samples.size() - from) / sps_);
+        symbols_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            symbols_[i] = demod_.demodulate(samples.data() + from + i * sps_);
+        }
+        ops_.complex_macs += 2 * count * static_cast<uint64_t>(n_bins_);
+        ops_.ffts += count;
+        ops_.fft_butterflies += count * static_cast<uint64_t>(n_bins_ / 2) * static_cast<uint64_t>(sf_);
+        ops_.peak_bins += count * static_cast<uint64_t>(n_bins_);
+    };
+
+    // ±3-sample refinement at low oversampling: the offset whose preamble
+    // demodulates to bin 0 most often.
+    if (os_ <= 4) {
+        int best_shift = 0;
+        int best_zeros = -1;
+        for (int shift = -3; shift <= 3; ++shift) {
+            const auto at = static_cast<std::ptrdiff_t>(offset) + shift;
+            if (at < 0 || static_cast<std::size_t>(at) + 8ULL * sps_ > samples.size()) continue;
+            demodulate_from(static_cast<std::size_t>(at), static_cast<std::size_t>(std::min(preamble, 8)));
+            const auto zeros = static_cast<int>(std::count(symbols_.begin(), symbols_.end(), 0));
+            if (zeros > best_zeros) {
+                best_zeros = zeros;
+                best_shift = shift;
+            }
+        }
+        offset = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offset) + best_shift);
+    }
+    result.alignment_offset = offset;
+
+    // Header: on the preamble grid below OS 4, else (or failing that)
+    // re-demodulated from each quarter-symbol data start after the SFD.
+    demodulate_from(offset, SIZE_MAX);
+    lora_replay::HeaderDecodeResult header;
+    std::size_t header_index = 0;
+    if (os_ < 4) {
+        if (const auto location = locate_header(symbols_, meta)) {
+            header = lora_replay::try_decode_header(symbols_, location->index, meta);
+            header_index = location->index;
+        }
+    }
+    if (!header.success) {
+        auto sync = find_header_symbol_index(symbols_, 0x12, sf_);
+        if (!sync) sync = find_header_symbol_index(symbols_, 0x34, sf_);
+        const std::size_t quarter = static_cast<std::size_t>(sps_ / 4);
+        for (int q : {1, 0, 2, 3}) {
+            if (!sync || header.success) break;
+            const std::size_t data_sample = offset + *sync * sps_ + static_cast<std::size_t>(q) * quarter;
+            if (data_sample + 8ULL * sps_ > samples.size()) continue;
+            demodulate_from(data_sample, SIZE_MAX);
+            header = lora_replay::try_decode_header(symbols_, 0, meta);
+            header_index = 0;
+        }
+    }
+    if (!header.success) {
+        return result;
+    }
+    result.header_ok = true;
+    result.payload_len = header.payload_len > 0 ? header.payload_len : meta.payload_len;
+    result.cr = header.cr > 0 ? header.cr : meta.cr;
+    const bool has_crc = header.has_crc || meta.has_crc;
+
+    PayloadDecoder decoder({sf_, result.cr, meta.ldro, result.payload_len, has_crc, -1});
+    if (header.nibbles.size() > 5) {
+        decoder.push_nibbles(header.nibbles.data() + 5, header.nibbles.size() - 5);
+    }
+    std::size_t cursor = header_index + static_cast<std::size_t>(header.consumed_symbols);
+    while (decoder.needs_more() && cursor < symbols_.size()) {
+        const std::size_t consumed = decoder.push_block(symbols_.data() + cursor, symbols_.size() - cursor);
+        if (consumed == 0) break;
+        cursor += consumed;
+    }
+    const std::span<const uint8_t> bytes = decoder.bytes();
+    result.payload.assign(bytes.begin(),
+                          bytes.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(
+                              bytes.size(), static_cast<std::size_t>(result.payload_len))));
+    result.crc_ok = has_crc && decoder.crc_ok();
+    return result;
+}
+
+} // namespace host_sim
@@ -0,0 +1,890 @@
+#include "host_sim/receiver.hpp"
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/bounded_queue.hpp"
+#include "host_sim/decode_phase.hpp"
+#include "host_sim/interference_canceller.hpp"
+#include "host_sim/lora_replay/incremental_decoder.hpp"
+#include "host_sim/trace.hpp"
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace host_sim
+{
+
+namespace
+{
+
+// CPU time consumed so far, in milliseconds, by the calling thread or
+// (with `whole_process`) the whole process.
+double cpu_time_ms(bool whole_process)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    timespec ts{};
+    ::clock_gettime(whole_process ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) * 1e-6;
+#else
+    (void)whole_process;
+    return static_cast<double>(std::clock()) * 1e3 / CLOCKS_PER_SEC;
+#endif
+}
+
+// Samples per detection step unless configured: ~100 ms.
+std::size_t default_chunk(const LoRaMetadata& meta)
+{
+    return std::max<std::size_t>(4096, static_cast<std::size_t>(meta.sample_rate * 0.1));
+}
+
+// Charges the phases of one receiver call to its metrics, unless the
+// caller already records phases on this thread (lora_replay --bench).
+class MetricsRecording
+{
+public:
+    explicit MetricsRecording(ReceiverMetrics& metrics) : metrics_(metrics)
+    {
+        if (!PhaseRecording::active()) {
+            recording_.emplace(times_);
+        }
+    }
+
+    ~MetricsRecording()
+    {
+        if (recording_) {
+            recording_.reset();
+            metrics_.add_phases(times_);
+        }
+    }
+
+    MetricsRecording(const MetricsRecording&) = delete;
+    MetricsRecording& operator=(const MetricsRecording&) = delete;
+
+private:
+    ReceiverMetrics& metrics_;
+    PhaseTimes times_;
+    std::optional<PhaseRecording> recording_;
+};
+
+} // namespace
+
+// One detected burst, copied out of the buffer so decoding never holds up
+// ingestion (inline decoding reads the buffer directly instead).
+struct Receiver::BurstJob
+{
+    std::uint64_t seq{0};
+    std::size_t start{0};       // stream index of the first burst sample
+    float snr_db{0.0f};
+    float noise_floor{0.0f};    // detector's estimate, per sample
+    int sf{0};                  // recovery jobs: the SF to re-decode at
+    std::vector<std::complex<float>> samples;
+};
+
+// The packet being decoded as it arrives, on the detection thread and its
+// own demodulator (the decoders' banks may be busy).  `start` stays a
+// valid buffer index while a decode runs: nothing is compacted then.
+struct Receiver::Incremental
+{
+    Bank bank;
+    std::optional<lora_replay::IncrementalBurstDecoder> decoder;
+    std::ostringstream report;
+    std::size_t start{0};
+    float snr_db{0.0f};
+    double decode_ms{0.0};
+    double cpu_ms{0.0};
+    bool whole_burst{false};    // the current burst failed incrementally
+};
+
+struct Receiver::Queue
+{
+    explicit Queue(std::size_t capacity) : jobs(capacity) {}
+    BoundedQueue<BurstJob> jobs;
+};
+
+Receiver::Bank Receiver::make_bank(const LoRaMetadata& meta, bool multi_sf)
+{
+    Bank bank;
+    const int sf_lo = multi_sf ? 6 : meta.sf;
+    const int sf_hi = multi_sf ? 12 : meta.sf;
+    for (int sf = sf_lo; sf <= sf_hi; ++sf) {
+        SfCtx ctx;
+        ctx.demod = std::make_unique<FftDemodulator>(sf, meta.sample_rate, meta.bw);
+        ctx.arena = std::make_unique<DecodeArena>();
+        ctx.sps = ctx.demod->samples_per_symbol();
+        bank.push_back(std::move(ctx));
+    }
+    return bank;
+}
+
+Receiver::Receiver(ReceiverConfig config)
+    : config_(std::move(config)),
+      banks_([this] {
+          if (config_.metadata.bw <= 0 || config_.metadata.sample_rate < config_.metadata.bw) {
+              throw std::runtime_error("Receiver: sample_rate must be at least bw");
+          }
+          if (config_.incremental && config_.multi_sf) {
+              throw std::runtime_error("Receiver: incremental decoding needs a single SF");
+          }
+          if (config_.cancel_collisions > 0 && config_.multi_sf) {
+              throw std::runtime_error("Receiver: collision cancellation needs a single SF");
+          }
+          std::vector<Bank> banks;
+          for (std::size_t d = 0; d < std::max<std::size_t>(1, config_.decoder_threads); ++d) {
+              banks.push_back(make_bank(config_.metadata, config_.multi_sf));
+          }
+          return banks;
+      }()),
+      chunk_(config_.chunk_samples > 0 ? config_.chunk_samples
+             : config_.incremental     ? static_cast<std::size_t>(banks_.front().back().sps)
+                                       : default_chunk(config_.metadata)),
+      // Detection runs on the smallest SF's symbol (finest resolution);
+      // buffering is sized for enough of the largest SF to hold a packet.
+      window_(static_cast<std::size_t>(banks_.front().front().sps)),
+      min_accumulate_(static_cast<std::size_t>(banks_.front().back().sps) * 60),
+      // Symbol-sized incremental steps still buffer a long packet whole.
+      capacity_(std::max(4 * min_accumulate_,
+                         64 * (config_.incremental ? std::max(chunk_, default_chunk(config_.metadata)) : chunk_))),
+      detector_(window_, 6.0f, 2)
+{
+    options_.payload = config_.expected_payload;
+    options_.soft = config_.soft;
+    options_.cfo_track_alpha = config_.cfo_track_alpha;
+    options_.verbose = config_.verbose;
+    options_.multi_sf = config_.multi_sf;
+    options_.effort = config_.effort;
+    options_.decode_budget_ms = config_.decode_budget_ms;
+    buffer_.reserve(capacity_);
+
+    if (config_.incremental) {
+        incremental_ = std::make_unique<Incremental>();
+        incremental_->bank = make_bank(config_.metadata, false);
+    }
+
+    if (config_.defer_recovery) {
+        recovery_options_ = options_;
+        recovery_options_.effort = lora_replay::DecodeEffort::exhaustive;
+        recovery_options_.decode_budget_ms = 0.0;
+        recovery_bank_ = make_bank(config_.metadata, config_.multi_sf);
+        // A few failures in flight; past that the stream is too noisy for
+        // recovery to keep up anyway, and the newest ones are skipped.
+        recovery_queue_ = std::make_unique<Queue>(8);
+        recovery_ = std::thread([this] { recovery_main(); });
+    }
+
+    counters_.decoders = config_.decoder_threads;
+    if (config_.decoder_threads > 0) {
+        // Two jobs in flight per decoder keeps them busy; beyond that the
+        // detector blocks (or drops the burst).
+        queue_ = std::make_unique<Queue>(2 * config_.decoder_threads);
+        counters_.queue_capacity = queue_->jobs.capacity();
+        for (std::size_t d = 0; d < config_.decoder_threads; ++d) {
+            decoders_.emplace_back([this, d] { decoder_main(d); });
+        }
+    }
+}
+
+Receiver::~Receiver()
+{
+    if (queue_) {
+        queue_->jobs.close();
+    }
+    for (auto& t : decoders_) {
+        t.join();
+    }
+    if (recovery_queue_) {
+        recovery_queue_->jobs.close();
+    }
+    if (recovery_.joinable()) {
+        recovery_.join();
+    }
+}
+
+std::size_t Receiver::max_samples_per_symbol() const
+{
+    return static_cast<std::size_t>(banks_.front().back().sps);
+}
+
+void Receiver::push(std::span<const std::complex<float>> samples)
+{
+    if (finished_) {
+        throw std::runtime_error("Receiver: push() after finish()");
+    }
+    const MetricsRecording recording(metrics_);
+    // One detection step per chunk of input, however the caller slices
+    // it, so results never depend on push() sizes.  A full buffer takes
+    // nothing until a step frees room, as the stream reader's ring would.
+    std::size_t pos = 0;
+    while (pos < samples.size()) {
+        const std::size_t room = capacity_ > buffer_.size() ? capacity_ - buffer_.size() : 0;
+        const std::size_t n = std::min({chunk_ - pending_, room, samples.size() - pos});
+        buffer_.insert(buffer_.end(), samples.begin() + static_cast<std::ptrdiff_t>(pos),
+                       samples.begin() + static_cast<std::ptrdiff_t>(pos + n));
+        pos += n;
+        pending_ += n;
+        if (pending_ == chunk_ || buffer_.size() >= capacity_) {
+            pending_ = 0;
+            step();
+        }
+    }
+}
+
+void Receiver::finish()
+{
+    if (finished_) {
+        return;
+    }
+    eof_ = true;
+    {
+        const MetricsRecording recording(metrics_);
+        while (step()) {
+        }
+    }
+    if (queue_) {
+        queue_->jobs.close();
+        for (auto& t : decoders_) {
+            t.join();
+        }
+        decoders_.clear();
+    }
+    // Decoders have queued their last recoveries; let them finish.
+    if (recovery_queue_) {
+        recovery_queue_->jobs.close();
+        recovery_.join();
+    }
+    const std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+}
+
+std::optional<ReceivedPacket> Receiver::pull()
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!ready_.empty()) {
+        ReceivedPacket packet = std::move(ready_.front());
+        ready_.pop_front();
+        return packet;
+    }
+    if (finished_ && completed_.empty() && error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+    return std::nullopt;
+}
+
+ReceiverStats Receiver::stats() const
+{
+    ReceiverStats stats = counters_;
+    const bool settled = finished_ || !queue_;
+    for (std::size_t k = 0; k < banks_.front().size(); ++k) {
+        ReceiverSfStats sf;
+        sf.sf = banks_.front()[k].demod->sf();
+        if (settled) {
+            for (const auto& bank : banks_) {
+                sf.preambles += bank[k].preambles;
+                sf.packets += bank[k].packets;
+                sf.cpu_ms += bank[k].cpu_ms;
+            }
+        }
+        stats.sf.push_back(sf);
+    }
+    return stats;
+}
+
+std::size_t Receiver::compact(std::size_t n)
+{
+    // Whole windows only, so the detector's grid stays aligned with the
+    // buffer head.
+    n -= n % window_;
+    buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(n));
+    buffer_origin_ += n;
+    detector_.consume(n);
+    return n;
+}
+
+bool Receiver::step()
+{
+    const PhaseScope phase(DecodePhase::detection);
+    HOST_SIM_TRACE_SPAN("burst_detect");
+    const std::size_t avail = buffer_.size();
+    const bool full = avail >= capacity_;
+    detector_.update(buffer_.data(), avail);
+    // A packet decoding as it arrives holds detection until it ends.
+    if (incremental_ && incremental_->decoder && advance_incremental()) {
+        return true;
+    }
+    // Wait until there is enough for burst detection plus one packet; an
+    // incremental decode waits for the samples it needs itself.
+    if (!incremental_ && avail - search_offset_ < min_accumulate_ && !eof_ && !full) {
+        return true;
+    }
+
+    const auto burst_det = detector_.find_start(search_offset_, tracked_noise_floor_);
+    if (!burst_det) {
+        if (!eof_) {
+            if (avail > min_accumulate_) {
+                const std::size_t trim = compact(avail - min_accumulate_ / 2);
+                search_offset_ = search_offset_ > trim ? search_offset_ - trim : 0;
+            }
+            return true;
+        }
+        // At end of input a stream without any burst is still decoded
+        // once from the search origin.
+        if (counters_.bursts_queued != 0 || avail - search_offset_ < window_ * 12) {
+            return false;
+        }
+    }
+
+    const std::size_t burst_start = burst_det ? burst_det->burst_start : search_offset_;
+    const float noise_floor = burst_det ? burst_det->noise_floor : 0.0f;
+    if (incremental_ && burst_det && !incremental_->whole_burst) {
+        const float snr_linear = noise_floor > 0.0f ? (burst_det->signal_power - noise_floor) / noise_floor : 0.0f;
+        if (noise_floor > 0.0f) {
+            tracked_noise_floor_ = noise_floor;
+        }
+        begin_incremental(burst_start, snr_linear > 0.0f ? 10.0f * std::log10(snr_linear) : -99.0f);
+        if (advance_incremental()) {
+            return true;
+        }
+    }
+    const auto extent = detector_.find_end(burst_start, noise_floor);
+    if (!extent.complete && !eof_ && !full) {
+        return true;
+    }
+    const std::size_t burst_end = extent.end;
+    const std::size_t burst_len = burst_end > burst_start ? burst_end - burst_start : 0;
+    if (burst_len < window_ * 12) {
+        if (config_.verbose) {
+            std::cerr << "[stream] short burst (" << burst_len << " samples), skipping\n";
+        }
+        search_offset_ = burst_end;
+        if (incremental_) {
+            incremental_->whole_burst = false;
+        }
+        return true;
+    }
+
+    const float mean_burst_power = extent.power_count > 0
+        ? static_cast<float>(extent.power_acc / static_cast<double>(extent.power_count))
+        : (burst_det ? burst_det->signal_power : 0.0f);
+    const float snr_linear = noise_floor > 0.0f ? (mean_burst_power - noise_floor) / noise_floor : 0.0f;
+
+    BurstJob job;
+    job.seq = counters_.bursts_queued;
+    job.start = static_cast<std::size_t>(buffer_origin_) + burst_start;
+    job.snr_db = snr_linear > 0.0f ? 10.0f * std::log10(snr_linear) : -99.0f;
+    job.noise_floor = noise_floor;
+    submit(job, std::span<const std::complex<float>>(buffer_.data() + burst_start, burst_len));
+
+    search_offset_ = burst_end;
+    if (incremental_) {
+        incremental_->whole_burst = false;
+    }
+    if (noise_floor > 0.0f) {
+        tracked_noise_floor_ = noise_floor;
+    }
+    if (search_offset_ > min_accumulate_) {
+        search_offset_ -= compact(search_offset_);
+    }
+    return true;
+}
+
+void Receiver::begin_incremental(std::size_t start, float snr_db)
+{
+    auto& inc = *incremental_;
+    auto& ctx = inc.bank.front();
+    inc.decoder.reset();
+    inc.start = start;
+    inc.snr_db = snr_db;
+    inc.decode_ms = 0.0;
+    inc.cpu_ms = 0.0;
+    inc.report.str({});
+    inc.report.clear();
+    if (!config_.reports) {
+        inc.report.setstate(std::ios::badbit);
+    }
+    ctx.arena->reset();
+    inc.decoder.emplace(*ctx.demod, config_.metadata, options_, inc.report, ctx.arena->resource());
+}
+
+bool Receiver::advance_incremental()
+{
+    using Status = lora_replay::IncrementalBurstDecoder::Status;
+    auto& inc = *incremental_;
+    Status status = Status::pending;
+    {
+        const PhaseScope decode_phase(DecodePhase::other);
+        const double t0 = cpu_time_ms(false);
+        const auto w0 = std::chrono::steady_clock::now();
+        status = inc.decoder->advance(std::span<const std::complex<float>>(buffer_).subspan(inc.start));
+        inc.decode_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - w0).count();
+        inc.cpu_ms += cpu_time_ms(false) - t0;
+    }
+    if (status == Status::pending && !eof_ && buffer_.size() < capacity_) {
+        return true;
+    }
+    if (status != Status::done) {
+        // Out of input or room, or no clean decode: every sample of the
+        // burst is still buffered for the whole-burst path.
+        if (config_.verbose) {
+            std::cerr << "[stream] incremental decode left the burst at "
+                      << static_cast<std::size_t>(buffer_origin_) + inc.start << " to a whole-burst decode\n";
+        }
+        inc.decoder.reset();
+        inc.whole_burst = true;
+        ++counters_.incremental_fallbacks;
+        return false;
+    }
+
+    std::vector<ReceivedPacket> packets(1);
+    auto& pkt = packets.front();
+    pkt.burst = counters_.bursts_queued++;
+    pkt.start = static_cast<std::size_t>(buffer_origin_) + inc.start;
+    pkt.length = inc.decoder->consumed();
+    pkt.snr_db = inc.snr_db;
+    pkt.sf = inc.bank.front().demod->sf();
+    pkt.result = inc.decoder->result();
+    pkt.report = inc.report.str();
+    pkt.decode_ms = inc.decode_ms;
+    pkt.incremental = true;
+    inc.decoder.reset();
+    ++counters_.incremental_packets;
+    account(packets, inc.cpu_ms);
+    const std::uint64_t seq = pkt.burst;
+    const std::size_t end = inc.start + pkt.length;
+    complete(seq, std::move(packets));
+
+    // The packet's samples go at once; detection resumes at the first
+    // whole window past its last symbol.
+    search_offset_ = std::min((end + window_ - 1) / window_ * window_, buffer_.size());
+    search_offset_ -= compact(search_offset_);
+    return true;
+}
+
+void Receiver::submit(BurstJob& job, std::span<const std::complex<float>> burst)
+{
+    if (!queue_) {
+        std::vector<ReceivedPacket> packets;
+        try {
+            // Decode phases scope themselves; the rest is not detection.
+            const PhaseScope decode_phase(DecodePhase::other);
+            const double t0 = cpu_time_ms(false);
+            packets = decode(job, burst, banks_.front());
+            account(packets, cpu_time_ms(false) - t0);
+            defer(job, burst, packets);
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        ++counters_.bursts_queued;
+        complete(job.seq, std::move(packets));
+        return;
+    }
+
+    job.samples.assign(burst.begin(), burst.end());
+    auto& jobs = queue_->jobs;
+    if (jobs.try_push(job)) {
+        ++counters_.bursts_queued;
+    } else if (config_.drop_on_overflow) {
+        ++counters_.bursts_dropped;
+        if (config_.verbose) {
+            std::cerr << "[stream] decoders busy, dropped burst at " << job.start << "\n";
+        }
+    } else {
+        ++counters_.detector_stalls;
+        jobs.push(job);
+        ++counters_.bursts_queued;
+    }
+    counters_.queue_high_water = std::max(counters_.queue_high_water, jobs.size());
+}
+
+void Receiver::decoder_main(std::size_t index)
+{
+    BurstJob job;
+    while (queue_->jobs.pop(job)) {
+        std::vector<ReceivedPacket> packets;
+        try {
+            const MetricsRecording recording(metrics_);
+            const double t0 = cpu_time_ms(false);
+            packets = decode(job, job.samples, banks_[index]);
+            account(packets, cpu_time_ms(false) - t0);
+            defer(job, job.samples, packets);
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        job.samples = {};
+        complete(job.seq, std::move(packets));   // an empty list keeps the order moving
+    }
+}
+
+void Receiver::defer(const BurstJob& job, std::span<const std::complex<float>> burst,
+                     const std::vector<ReceivedPacket>& packets)
+{
+    if (!recovery_queue_) {
+        return;
+    }
+    for (const auto& pkt : packets) {
+        const auto& r = pkt.result;
+        if (r.header_ok && (r.crc_ok || !r.crc_expected)) {
+            continue;
+        }
+        // An exhaustive decode that ran to completion has nothing left.
+        if (!r.budget_exhausted && config_.effort == lora_replay::DecodeEffort::exhaustive) {
+            continue;
+        }
+        BurstJob recovery;
+        recovery.seq = job.seq;
+        recovery.start = pkt.start;
+        recovery.snr_db = pkt.snr_db;
+        recovery.sf = pkt.sf;
+        const auto tail = burst.subspan(pkt.start - job.start);
+        recovery.samples.assign(tail.begin(), tail.end());
+        if (recovery_queue_->jobs.try_push(recovery)) {
+            metrics_.recoveries_queued.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            metrics_.recoveries_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Receiver::recovery_main()
+{
+#if defined(__linux__)
+    // Recovery only gets the cycles the detector and decoders leave idle.
+    const sched_param idle{};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &idle);
+#endif
+    BurstJob job;
+    while (recovery_queue_->jobs.pop(job)) {
+        try {
+            const MetricsRecording recording(metrics_);
+            const double t0 = cpu_time_ms(false);
+            const auto ctx = std::find_if(recovery_bank_.begin(), recovery_bank_.end(),
+                                          [&](const SfCtx& c) { return c.demod->sf() == job.sf; });
+            if (ctx != recovery_bank_.end()) {
+                auto metadata = config_.metadata;
+                metadata.sf = job.sf;
+                ReceivedPacket pkt;
+                pkt.sf = job.sf;
+                std::ostringstream report;
+                if (!config_.reports) {
+                    report.setstate(std::ios::badbit);
+                }
+                const auto w0 = std::chrono::steady_clock::now();
+                ctx->arena->reset();
+                pkt.result = lora_replay::decode_stream_burst(job.samples, *ctx->demod, metadata, recovery_options_,
+                                                              report, ctx->arena->resource());
+                pkt.decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - w0).count();
+                metrics_.effort_latency[static_cast<std::size_t>(pkt.result.effort)].observe(pkt.decode_ms * 1e-3);
+                if (pkt.result.header_ok && (pkt.result.crc_ok || !pkt.result.crc_expected)) {
+                    pkt.burst = job.seq;
+                    pkt.start = job.start;
+                    pkt.length = job.samples.size();
+                    pkt.snr_db = job.snr_db;
+                    pkt.report = report.str();
+                    pkt.recovered = true;
+                    metrics_.recoveries_ok.fetch_add(1, std::memory_order_relaxed);
+                    const std::lock_guard<std::mutex> lock(mutex_);
+                    ready_.push_back(std::move(pkt));
+                }
+            }
+            metrics_.decode_cpu_ns.fetch_add(static_cast<std::uint64_t>(std::max(cpu_time_ms(false) - t0, 0.0) * 1e6),
+                                             std::memory_order_relaxed);
+        } catch (...) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        job.samples = {};
+    }
+}
+
+void Receiver::account(const std::vector<ReceivedPacket>& packets, double cpu_ms)
+{
+    for (const auto& pkt : packets) {
+        metrics_.record_packet(pkt.sf, pkt.result, pkt.decode_ms);
+        if (pkt.cancelled > 0) {
+            metrics_.collision_packets.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    metrics_.decode_cpu_ns.fetch_add(static_cast<std::uint64_t>(std::max(cpu_ms, 0.0) * 1e6),
+                                     std::memory_order_relaxed);
+}
+
+void Receiver::complete(std::uint64_t burst, std::vector<ReceivedPacket> packets)
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    completed_.emplace(burst, std::move(packets));
+    for (auto it = completed_.find(next_burst_); it != completed_.end(); it = completed_.find(++next_burst_)) {
+        for (auto& packet : it->second) {
+            ready_.push_back(std::move(packet));
+        }
+        completed_.erase(it);
+    }
+}
+
+std::vector<ReceivedPacket> Receiver::decode(const BurstJob& job, std::span<const std::complex<float>> burst,
+                                             Bank& bank) const
+{
+    std::vector<ReceivedPacket> packets;
+    if (bank.size() > 1) {
+        packets = decode_multi_sf(bank, burst);
+    } else {
+        auto& ctx = bank.front();
+        auto& demod = *ctx.demod;
+        auto metadata = config_.metadata;
+        metadata.sf = demod.sf();
+        ReceivedPacket pkt;
+        pkt.sf = demod.sf();
+        std::ostringstream report;
+        if (!config_.reports) {
+            report.setstate(std::ios::badbit);   // every insertion becomes a no-op
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        ctx.arena->reset();
+        pkt.result = lora_replay::decode_stream_burst(burst, demod, metadata, options_, report, ctx.arena->resource());
+        pkt.decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        pkt.report = report.str();
+        packets.push_back(std::move(pkt));
+        if (config_.cancel_collisions > 0) {
+            decode_residual(job, burst, ctx, packets);
+        }
+    }
+    // decode_multi_sf() and decode_residual() leave burst-relative offsets
+    // in `start`.
+    for (auto& pkt : packets) {
+        pkt.burst = job.seq;
+        pkt.length = burst.size() - pkt.start;
+        pkt.start += job.start;
+        pkt.snr_db = job.snr_db;
+    }
+    return packets;
+}
+
+// Collision mode on one burst.  Each clean packet is re-synthesised and
+// subtracted from a copy of the burst; if energy above the noise floor is
+// left, the residual's preamble runs are decoded in order until one comes
+// out clean, and that packet is cancelled in turn.  A run where a
+// cancelled frame started is that frame's leftover, not a new packet.
+void Receiver::decode_residual(const BurstJob& job, std::span<const std::complex<float>> burst, SfCtx& ctx,
+                               std::vector<ReceivedPacket>& packets) const
+{
+    const auto clean = [](const ReceivedPacket& p) {
+        return p.result.header_ok && (p.result.crc_ok || !p.result.crc_expected) && !p.result.payload.empty();
+    };
+    if (packets.empty() || !clean(packets.back())) {
+        return;
+    }
+    auto& demod = *ctx.demod;
+    auto metadata = config_.metadata;
+    metadata.sf = demod.sf();
+    const auto sps = static_cast<std::ptrdiff_t>(ctx.sps);
+    const int min_run = std::max(4, metadata.preamble_len - 3);
+
+    std::vector<std::complex<float>> residual(burst.begin(), burst.end());
+    std::vector<std::ptrdiff_t> cancelled;     // frame starts subtracted so far
+    std::size_t last = packets.size() - 1;
+    for (int pass = 1; pass <= config_.cancel_collisions; ++pass) {
+        const auto& decoded = packets[last];
+        CancelTarget target;
+        target.payload = decoded.result.payload;
+        target.cr = decoded.result.cr;
+        target.has_crc = decoded.result.crc_expected;
+        target.preamble_offset = decoded.start + decoded.result.preamble_offset;
+        target.cfo_hz = decoded.result.cfo_hz;
+        target.sfo = decoded.result.sfo;
+        const auto removed = cancel_packet(residual, metadata, target);
+        if (!removed) {
+            break;
+        }
+        cancelled.push_back(removed->frame_start);
+        if (config_.verbose) {
+            std::cerr << "[collision] cancelled packet at " << job.start + removed->begin << " ("
+                      << removed->suppression_db << " dB)\n";
+        }
+        if (!detect_burst_ex(residual.data(), residual.size(), ctx.sps, 6.0f, 0, job.noise_floor, 2)) {
+            break;
+        }
+
+        demod.set_frequency_offsets(0.0f, 0, 0.0f);
+        demod.reset_symbol_counter();
+        bool found = false;
+        for (const auto& run : find_preamble_runs(residual, demod, min_run)) {
+            const auto run_at = static_cast<std::ptrdiff_t>(run.first_symbol) * sps;
+            if (std::any_of(cancelled.begin(), cancelled.end(),
+                            [&](std::ptrdiff_t f) { return std::abs(run_at - f) <= 2 * sps; })) {
+                continue;
+            }
+            ReceivedPacket pkt;
+            pkt.sf = metadata.sf;
+            pkt.start = run.first_symbol <= 1 ? 0 : static_cast<std::size_t>(run_at - sps);
+            pkt.cancelled = pass;
+            std::ostringstream report;
+            if (!config_.reports) {
+                report.setstate(std::ios::badbit);
+            }
+            const auto t0 = std::chrono::steady_clock::now();
+            ctx.arena->reset();
+            pkt.result = lora_replay::decode_stream_burst(std::span<const std::complex<float>>(residual).subspan(pkt.start),
+                                                          demod, metadata, options_, report, ctx.arena->resource());
+            pkt.decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            if (!clean(pkt)) {
+                continue;
+            }
+            pkt.report = report.str();
+            packets.push_back(std::move(pkt));
+            last = packets.size() - 1;
+            found = true;
+            break;
+        }
+        if (!found) {
+            break;
+        }
+    }
+    std::stable_sort(packets.begin(), packets.end(),
+                     [](const ReceivedPacket& a, const ReceivedPacket& b) { return a.start < b.start; });
+}
+
+// Multi-SF receive of one burst.  Every SF runs its own preamble detector
+// across the whole burst, then each SF with candidates decodes them on its
+// own demodulator — the pipelines run concurrently on the shared pool, so
+// packets of different SFs that collide in one burst are all recovered.
+// Returns the packets to report in stream order: every clean decode, or
+// the most plausible failure when nothing decoded.
+std::vector<ReceivedPacket> Receiver::decode_multi_sf(Bank& bank, std::span<const std::complex<float>> burst) const
+{
+    auto& pool = WorkerPool::shared();
+    const int min_run = std::max(4, config_.metadata.preamble_len - 3);
+
+    std::vector<std::vector<PreambleRun>> runs(bank.size());
+    pool.parallel_for(bank.size(), [&](std::size_t k, std::size_t) {
+        const double t0 = cpu_time_ms(false);
+        auto& ctx = bank[k];
+        ctx.demod->set_frequency_offsets(0.0f, 0, 0.0f);
+        ctx.demod->reset_symbol_counter();
+        runs[k] = find_preamble_runs(burst, *ctx.demod, 2);
+        ctx.cpu_ms += cpu_time_ms(false) - t0;
+    });
+
+    // A packet candidate found by one SF pipeline.
+    struct Candidate
+    {
+        std::size_t sf_index{0};
+        int preamble_run{0};
+        ReceivedPacket packet;  // start = burst-relative decode offset
+    };
+
+    // A run starting in the first window belongs to the burst start; later
+    // runs back off one symbol so alignment sees the whole preamble.
+    const auto run_offset = [&](std::size_t k, const PreambleRun& run) {
+        return run.first_symbol <= 1 ? std::size_t{0}
+                                     : (run.first_symbol - 1) * static_cast<std::size_t>(bank[k].sps);
+    };
+    std::vector<Candidate> candidates;
+    Candidate longest;
+    for (std::size_t k = 0; k < bank.size(); ++k) {
+        for (const auto& run : runs[k]) {
+            if (config_.verbose) {
+                std::cerr << "[multi-sf-probe] SF=" << bank[k].demod->sf() << " run=" << run.length
+                          << " at symbol " << run.first_symbol << " bin=" << run.bin << "\n";
+            }
+            Candidate c;
+            c.sf_index = k;
+            c.packet.start = run_offset(k, run);
+            c.preamble_run = run.length;
+            if (run.length >= min_run) {
+                ++bank[k].preambles;
+                candidates.push_back(std::move(c));
+            } else if (run.length > longest.preamble_run) {
+                longest = std::move(c);
+            }
+        }
+    }
+    if (candidates.empty()) {
+        // Nothing preamble-like: decode the likeliest SF from the burst
+        // start so the burst is still reported.
+        longest.packet.start = 0;
+        candidates.push_back(std::move(longest));
+    }
+
+    // One pipeline per SF, decoding its candidates in order.  A lone
+    // pipeline runs on this thread so its own sweeps can use the pool; its
+    // CPU time is then taken process-wide to include those helpers.
+    std::vector<std::size_t> active;
+    for (const auto& c : candidates) {
+        if (std::find(active.begin(), active.end(), c.sf_index) == active.end()) {
+            active.push_back(c.sf_index);
+        }
+    }
+    const auto run_pipeline = [&](std::size_t k, bool whole_process) {
+        auto& ctx = bank[k];
+        const double t0 = cpu_time_ms(whole_process);
+        auto metadata = config_.metadata;
+        metadata.sf = ctx.demod->sf();
+        for (auto& c : candidates) {
+            if (c.sf_index != k) {
+                continue;
+            }
+            auto& pkt = c.packet;
+            pkt.sf = metadata.sf;
+            std::ostringstream report;
+            if (!config_.reports) {
+                report.setstate(std::ios::badbit);
+            }
+            const auto w0 = std::chrono::steady_clock::now();
+            ctx.arena->reset();
+            pkt.result = lora_replay::decode_stream_burst(burst.subspan(pkt.start), *ctx.demod, metadata,
+                                                          options_, report, ctx.arena->resource());
+            pkt.decode_ms = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - w0).count();
+            pkt.report = report.str();
+        }
+        ctx.cpu_ms += cpu_time_ms(whole_process) - t0;
+    };
+    if (active.size() == 1) {
+        run_pipeline(active.front(), true);
+    } else {
+        pool.parallel_for(active.size(), [&](std::size_t a, std::size_t) { run_pipeline(active[a], false); });
+    }
+
+    const auto clean = [](const Candidate& c) {
+        return c.packet.result.header_ok && (c.packet.result.crc_ok || !c.packet.result.crc_expected);
+    };
+    std::vector<Candidate> kept;
+    for (auto& c : candidates) {
+        if (clean(c)) {
+            ++bank[c.sf_index].packets;
+            kept.push_back(std::move(c));
+        }
+    }
+    if (kept.empty()) {
+        // Prefer a decoded header, then the longest preamble, then the
+        // lowest SF (candidates are already in bank order).
+        auto best = candidates.begin();
+        for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+            if (std::make_pair(it->packet.result.header_ok, it->preamble_run) >
+                std::make_pair(best->packet.result.header_ok, best->preamble_run)) {
+                best = it;
+            }
+        }
+        kept.push_back(std::move(*best));
+    }
+    std::stable_sort(kept.begin(), kept.end(), [](const Candidate& a, const Candidate& b) {
+        return a.packet.start < b.packet.start;
+    });
+    std::vector<ReceivedPacket> packets;
+    for (auto& c : kept) {
+        packets.push_back(std::move(c.packet));
+    }
+    return packets;
+}
+
+} // namespace host_sim
@@ -0,0 +1,68 @@
+#include "host_sim/resampler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace host_sim
+{
+
+namespace
+{
+
+// Lagrange weights for taps n-1 .. n+2 at fraction mu.
+std::array<float, 4> cubic_weights(double mu)
+{
+    const double a = mu + 1.0;
+    const double b = mu - 1.0;
+    const double c = mu - 2.0;
+    return {static_cast<float>(-mu * b * c / 6.0),
+            static_cast<float>(a * b * c / 2.0),
+            static_cast<float>(-a * mu * c / 2.0),
+            static_cast<float>(a * mu * b / 6.0)};
+}
+
+} // namespace
+
+FarrowResampler::FarrowResampler(std::span<const std::complex<float>> input) : input_(input)
+{
+}
+
+std::complex<float> FarrowResampler::at(double position) const
+{
+    std::complex<float> out;
+    window(position, 1, &out);
+    return out;
+}
+
+void FarrowResampler::window(double start, std::size_t count, std::complex<float>* out) const
+{
+    if (count == 0) {
+        return;
+    }
+    const auto last = static_cast<std::int64_t>(input_.size()) - 1;
+    const double whole = std::floor(start);
+    const double mu = start - whole;
+    const auto base = static_cast<std::int64_t>(whole);
+    auto tap = [&](std::int64_t i) { return input_[static_cast<std::size_t>(std::clamp<std::int64_t>(i, 0, last))]; };
+
+    if (mu == 0.0) {
+        for (std::size_t k = 0; k < count; ++k) {
+            out[k] = tap(base + static_cast<std::int64_t>(k));
+        }
+        return;
+    }
+    const auto w = cubic_weights(mu);
+    for (std::size_t k = 0; k < count; ++k) {
+        const std::int64_t n = base + static_cast<std::int64_t>(k);
+        if (n >= 1 && n + 2 <= last) {
+            const std::complex<float>* x = input_.data() + (n - 1);
+            out[k] = w[0] * x[0] + w[1] * x[1] + w[2] * x[2] + w[3] * x[3];
+        } else {
+            out[k] = w[0] * tap(n - 1) + w[1] * tap(n) + w[2] * tap(n + 1) + w[3] * tap(n + 2);
+        }
+    }
+}
+
+} // namespace host_sim
@@ -1,13 +1,45 @@
 #include "host_sim/scheduler.hpp"
 
+#include "host_sim/bounded_queue.hpp"
 #include "host_sim/symbol_context.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
 #include <span>
+#include <stdexcept>
+#include <thread>
 
 namespace host_sim
 {
 
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double ns_between(Clock::time_point from, Clock::time_point to)
+{
+    return std::chrono::duration<double, std::nano>(to - from).count();
+}
+
+// One symbol in flight through the real-time pipeline.  Slots are
+// allocated once per run and recycled: views from a persistent source
+// are used in place, anything else is copied into the slot's buffer,
+// whose capacity is reused, so steady state never allocates beyond what
+// the source itself does.
+struct Slot
+{
+    SymbolBuffer buffer;
+    SymbolContext context;
+    double release_ns{0.0};
+};
+
+} // namespace
+
 void Scheduler::configure(const Config& config)
 {
     config_ = config;
@@ -37,22 +69,26 @@ void Scheduler::run(SymbolSource& source)
     reset();
     source.reset();
 
-    while (auto buffer = source.next_symbol()) {
-        SymbolContext context{
-            processed_symbols_,
-            std::span<const std::complex<float>>(buffer->samples.data(), buffer->samples.size()),
-        };
+    // Sources that lend views (SpanSymbolSource) make this loop
+    // allocation-free; legacy next_symbol() sources pay one buffer each.
+    while (const auto view = source.next_view()) {
+        SymbolContext context{processed_symbols_, view->samples, view->samples_q15};
+        // One clock read per stage boundary: each stage ends where the
+        // next one starts.
+        auto start = Clock::now();
         for (auto& stage : stages_) {
-            const auto start = std::chrono::steady_clock::now();
             stage->process(context);
-            const auto end = std::chrono::steady_clock::now();
-            context.stage_elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+            const auto end = Clock::now();
+            context.stage_elapsed_ns = ns_between(start, end);
+            start = end;
             if (instrumentation_.stage_timings_ns) {
                 instrumentation_.stage_timings_ns->push_back(context.stage_elapsed_ns);
             }
         }
         if (instrumentation_.symbol_memory_bytes) {
-            instrumentation_.symbol_memory_bytes->push_back(context.samples.size() * sizeof(std::complex<float>));
+            instrumentation_.symbol_memory_bytes->push_back(
+                context.samples.size() * sizeof(std::complex<float>) +
+                context.samples_q15.size() * sizeof(Q15Complex));
         }
         ++processed_symbols_;
     }
@@ -62,4 +98,206 @@ void Scheduler::run(SymbolSource& source)
     }
 }
 
+// ── Real-time mode ──────────────────────────────────────────────
+
+void Scheduler::PeriodHistogram::record(double periods)
+{
+    const double pos = (periods + kRangePeriods) / (2.0 * kRangePeriods) * static_cast<double>(kBins);
+    if (pos < 0.0) {
+        ++below;
+    } else if (pos >= static_cast<double>(kBins)) {
+        ++above;
+    } else {
+        ++bins[static_cast<std::size_t>(pos)];
+    }
+}
+
+double Scheduler::PeriodHistogram::bin_low(std::size_t i)
+{
+    return -kRangePeriods + 2.0 * kRangePeriods * static_cast<double>(i) / static_cast<double>(kBins);
+}
+
+std::size_t Scheduler::RealTimeStats::bottleneck_stage() const
+{
+    return static_cast<std::size_t>(
+        std::max_element(stage_busy_ns.begin(), stage_busy_ns.end()) - stage_busy_ns.begin());
+}
+
+double Scheduler::RealTimeStats::capacity(bool pipelined) const
+{
+    if (symbols == 0 || stage_busy_ns.empty()) {
+        return 0.0;
+    }
+    double busy = 0.0;
+    for (const double ns : stage_busy_ns) {
+        busy = pipelined ? std::max(busy, ns) : busy + ns;
+    }
+    const double per_symbol = busy / static_cast<double>(symbols);
+    return per_symbol > 0.0 ? symbol_period_ns / per_symbol : std::numeric_limits<double>::infinity();
+}
+
+const Scheduler::RealTimeStats& Scheduler::run_realtime(SymbolSource& source, const RealTimeOptions& options)
+{
+    reset();
+    source.reset();
+
+    double period = options.symbol_period_ns;
+    if (period <= 0.0) {
+        if (config_.bandwidth <= 0) {
+            throw std::runtime_error("Real-time scheduler needs a bandwidth or symbol period");
+        }
+        period = 1e9 * static_cast<double>(1 << config_.sf) / static_cast<double>(config_.bandwidth);
+    }
+    const std::size_t n_stages = stages_.size();
+    const bool pipelined = options.pipelined && n_stages > 0;
+
+    auto& st = realtime_stats_;
+    st = RealTimeStats{};
+    st.symbol_period_ns = period;
+    st.depth = pipelined ? n_stages : 1;
+    st.min_margin_ns = std::numeric_limits<double>::infinity();
+    st.stage_busy_ns.assign(n_stages, 0.0);
+    st.stage_max_ns.assign(n_stages, 0.0);
+    std::vector<Slot> slots(std::max<std::size_t>(2, options.slots));
+    const bool persistent = source.views_persist();
+
+    const auto t0 = Clock::now();
+
+    // Source side: fetch symbol k, hold it until its release time and
+    // account how late it reached the first stage.
+    const auto admit = [&](Slot& slot, std::size_t k) {
+        const auto view = source.next_view();
+        if (!view) {
+            return false;
+        }
+        SymbolView lent = *view;
+        if (!persistent) {
+            slot.buffer.samples.assign(view->samples.begin(), view->samples.end());
+            slot.buffer.samples_q15.assign(view->samples_q15.begin(), view->samples_q15.end());
+            lent = SymbolView{slot.buffer.samples, slot.buffer.samples_q15};
+        }
+        double release = static_cast<double>(k) * period;
+        if (options.pace) {
+            std::this_thread::sleep_until(t0 + std::chrono::nanoseconds(std::llround(release)));
+        }
+        const double now = ns_between(t0, Clock::now());
+        if (!options.pace) {
+            release = now;
+        }
+        const double lag = std::max(0.0, now - release);
+        st.sum_start_lag_ns += lag;
+        st.max_start_lag_ns = std::max(st.max_start_lag_ns, lag);
+        st.start_lag.record(lag / period);
+        if (lag > options.underrun_tolerance * period) {
+            if (st.underruns < RealTimeStats::kMaxEvents) {
+                st.underrun_events[st.underruns] = {k, now, lag};
+            }
+            ++st.underruns;
+        }
+        slot.release_ns = release;
+        slot.context = SymbolContext{k, lent.samples, lent.samples_q15};
+        return true;
+    };
+    // Stage i on one symbol; returns its end time (the next stage's start).
+    const auto run_stage = [&](std::size_t i, Slot& slot, Clock::time_point start) {
+        stages_[i]->process(slot.context);
+        const auto end = Clock::now();
+        const double ns = ns_between(start, end);
+        slot.context.stage_elapsed_ns = ns;
+        st.stage_busy_ns[i] += ns;
+        st.stage_max_ns[i] = std::max(st.stage_max_ns[i], ns);
+        return end;
+    };
+    // Last stage done: score the symbol against its deadline.
+    const auto complete = [&](const Slot& slot, Clock::time_point end) {
+        const double done = ns_between(t0, end);
+        const double margin = slot.release_ns + static_cast<double>(st.depth) * period - done;
+        st.sum_margin_ns += margin;
+        st.min_margin_ns = std::min(st.min_margin_ns, margin);
+        st.margin.record(margin / period);
+        if (margin < 0.0) {
+            if (st.overruns < RealTimeStats::kMaxEvents) {
+                st.overrun_events[st.overruns] = {slot.context.symbol_index, done, -margin};
+            }
+            ++st.overruns;
+        }
+    };
+
+    std::size_t admitted = 0;
+    if (!pipelined) {
+        Slot& slot = slots.front();
+        while (admit(slot, admitted)) {
+            ++admitted;
+            auto t = Clock::now();
+            for (std::size_t i = 0; i < n_stages; ++i) {
+                t = run_stage(i, slot, t);
+            }
+            complete(slot, t);
+        }
+    } else {
+        // Slot indices travel source -> stage 0 -> ... -> last stage ->
+        // free list; every queue has one producer and one consumer.
+        BoundedQueue<std::size_t> free_slots(slots.size());
+        std::vector<std::unique_ptr<BoundedQueue<std::size_t>>> inbox;
+        for (std::size_t i = 0; i < n_stages; ++i) {
+            inbox.push_back(std::make_unique<BoundedQueue<std::size_t>>(slots.size()));
+        }
+        for (std::size_t k = 0; k < slots.size(); ++k) {
+            free_slots.push(k);
+        }
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < n_stages; ++i) {
+            workers.emplace_back([&, i] {
+                std::size_t k = 0;
+                while (inbox[i]->pop(k)) {
+                    try {
+                        const auto end = run_stage(i, slots[k], Clock::now());
+                        if (i + 1 == n_stages) {
+                            complete(slots[k], end);
+                        }
+                    } catch (...) {
+                        const std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    if (i + 1 < n_stages) {
+                        inbox[i + 1]->push(k);
+                    } else {
+                        free_slots.push(k);
+                    }
+                }
+                if (i + 1 < n_stages) {
+                    inbox[i + 1]->close();
+                }
+            });
+        }
+        std::size_t k = 0;
+        while (free_slots.pop(k) && admit(slots[k], admitted)) {
+            ++admitted;
+            inbox.front()->push(k);
+        }
+        inbox.front()->close();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    st.symbols = admitted;
+    st.wall_ns = ns_between(t0, Clock::now());
+    if (admitted == 0) {
+        st.min_margin_ns = 0.0;
+    }
+    processed_symbols_ = admitted;
+    for (auto& stage : stages_) {
+        stage->flush();
+    }
+    return st;
+}
+
 } // namespace host_sim
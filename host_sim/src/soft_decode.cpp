@@ -1,8 +1,12 @@
 #include "host_sim/soft_decode.hpp"
 
+#include "host_sim/hamming.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
+#include <stdexcept>
 
 namespace host_sim
 {
@@ -15,54 +19,23 @@ inline uint16_t gray_encode(uint16_t x)
     return x ^ (x >> 1);
 }
 
-// Encode a 4-bit data nibble into a (cr_app+4)-bit codeword using the same
-// Hamming convention as our hard decoder (hamming.cpp).
-// Returns the codeword value where bit (cw_len-1) is bits[0] (MSB).
-//
-// Bit layout inside the decoder:
-//   bits[0..3] = data bits  (bits[0]=d0=LSB of nibble … bits[3]=d3=MSB)
-//   bits[4..]  = check/parity bits
-inline uint8_t hamming_encode(uint8_t nibble, int cr_app)
-{
-    const bool d0 = (nibble >> 0) & 1;
-    const bool d1 = (nibble >> 1) & 1;
-    const bool d2 = (nibble >> 2) & 1;
-    const bool d3 = (nibble >> 3) & 1;
-
-    bool bits[8] = {d0, d1, d2, d3, false, false, false, false};
-    const int cw_len = cr_app + 4;
-
-    switch (cr_app) {
-    case 4:
-        bits[4] = d0 ^ d1 ^ d2;
-        bits[5] = d1 ^ d2 ^ d3;
-        bits[6] = d0 ^ d1 ^ d3;
-        bits[7] = bits[0] ^ bits[1] ^ bits[2] ^ bits[3] ^
-                  bits[4] ^ bits[5] ^ bits[6];
-        break;
-    case 3:
-        bits[4] = d0 ^ d1 ^ d2;
-        bits[5] = d1 ^ d2 ^ d3;
-        bits[6] = d0 ^ d1 ^ d3;
-        break;
-    case 2:
-        bits[4] = d0 ^ d1 ^ d2;
-        bits[5] = d1 ^ d2 ^ d3;
-        break;
-    case 1:
-        bits[4] = d0 ^ d1 ^ d2 ^ d3;
-        break;
-    default:
-        break;
-    }
-
-    // Pack: bits[0] is MSB of value (bit cw_len-1)
-    uint8_t cw = 0;
-    for (int k = 0; k < cw_len; ++k) {
-        if (bits[k]) cw |= static_cast<uint8_t>(1u << (cw_len - 1 - k));
+// ±1 codebook per CR, stored bit-major: kSoftCodebook[cr - 1][j][d] is
+// +1 when codeword bit j (MSB first) of nibble d is 1, else -1.  Scoring
+// walks the LLRs once and updates all 16 candidates per bit, which the
+// compiler turns into a few wide multiply-adds.
+constexpr auto kSoftCodebook = [] {
+    std::array<std::array<std::array<float, 16>, 8>, 4> book{};
+    for (int cr = 1; cr <= 4; ++cr) {
+        const int cw_len = cr + 4;
+        for (int d = 0; d < 16; ++d) {
+            const uint8_t cw = hamming_encode(static_cast<uint8_t>(d), cr);
+            for (int j = 0; j < cw_len; ++j) {
+                book[cr - 1][j][d] = ((cw >> (cw_len - 1 - j)) & 1) ? 1.0f : -1.0f;
+            }
+        }
     }
-    return cw;
-}
+    return book;
+}();
 
 } // anonymous namespace
 
@@ -71,37 +44,68 @@ inline uint8_t hamming_encode(uint8_t nibble, int cr_app)
 SymbolLLR compute_symbol_llrs(const float* fft_mag_sq, int sf,
                               bool is_header_or_ldro, int cfo_int)
 {
-    const int N = 1 << sf;
     const int sf_app = is_header_or_ldro ? sf - 2 : sf;
-    const int divider = is_header_or_ldro ? 4 : 1;
-
     SymbolLLR llrs(sf_app, 0.0f);
+    compute_symbol_llrs(fft_mag_sq, sf, is_header_or_ldro, cfo_int, llrs.data());
+    return llrs;
+}
 
-    // For each bit position, compute max mag² where that bit is 1 vs 0.
-    std::vector<float> max_one(sf_app, -std::numeric_limits<float>::infinity());
-    std::vector<float> max_zero(sf_app, -std::numeric_limits<float>::infinity());
-
-    for (int n = 0; n < N; ++n) {
-        // LoRa symbol mapping: s = ((n - cfo_int - 1) mod N) / divider, then gray encode
-        const uint16_t shifted = static_cast<uint16_t>(((n - cfo_int - 1 + 2 * N) % N) / divider);
-        const uint16_t gray = gray_encode(shifted);
-        const float mag = fft_mag_sq[n];
-
-        for (int bit = 0; bit < sf_app; ++bit) {
-            // Bit numbering: MSB first (bit 0 = MSB of sf_app-bit value)
-            const int bit_val = (gray >> (sf_app - 1 - bit)) & 1;
-            if (bit_val) {
-                max_one[bit] = std::max(max_one[bit], mag);
-            } else {
-                max_zero[bit] = std::max(max_zero[bit], mag);
+void compute_symbol_llrs(const float* fft_mag_sq, int sf,
+                         bool is_header_or_ldro, int cfo_int, float* llrs)
+{
+    const int N = 1 << sf;
+    const int sf_app = is_header_or_ldro ? sf - 2 : sf;
+    const int divider = is_header_or_ldro ? 4 : 1;
+    const int values = 1 << sf_app;
+
+    // LoRa symbol mapping: s = ((n - cfo_int - 1) mod N) / divider, then
+    // gray encode.  Fold the bins into s order: level[s] is the best
+    // magnitude among the `divider` bins that map to s.
+    float level[1 << kMaxSoftBits];
+    const int base = ((cfo_int + 1) % N + N) % N;
+    for (int s = 0; s < values; ++s) {
+        float best = -std::numeric_limits<float>::infinity();
+        for (int r = 0; r < divider; ++r) {
+            int n = s * divider + r + base;
+            if (n >= N) {
+                n -= N;
             }
+            best = std::max(best, fft_mag_sq[n]);
         }
+        level[s] = best;
     }
 
-    for (int bit = 0; bit < sf_app; ++bit) {
-        llrs[bit] = max_one[bit] - max_zero[bit];
+    // Gray bit b of s is 1 exactly for s mod 2^(b+2) in [2^b, 3·2^b): at
+    // pyramid level b (maxima over aligned runs of 2^b) that is entries
+    // with index mod 4 in {1, 2}.  Halve the pyramid after each bit.
+    int len = values;
+    for (int b = 0; b < sf_app; ++b) {
+        float max_one = -std::numeric_limits<float>::infinity();
+        float max_zero = -std::numeric_limits<float>::infinity();
+        if (len >= 4) {
+            for (int p = 0; p < len; p += 4) {
+                max_zero = std::max(max_zero, std::max(level[p], level[p + 3]));
+                max_one = std::max(max_one, std::max(level[p + 1], level[p + 2]));
+            }
+        } else {
+            max_zero = level[0];
+            max_one = level[1];
+        }
+        // Bit numbering: MSB first (index 0 = MSB of the sf_app-bit value)
+        llrs[sf_app - 1 - b] = max_one - max_zero;
+
+        len /= 2;
+        for (int p = 0; p < len; ++p) {
+            level[p] = std::max(level[2 * p], level[2 * p + 1]);
+        }
     }
+}
 
+SoftSymbol compute_soft_symbol(const float* fft_mag_sq, int sf,
+                               bool is_header_or_ldro, int cfo_int)
+{
+    SoftSymbol llrs{};
+    compute_symbol_llrs(fft_mag_sq, sf, is_header_or_ldro, cfo_int, llrs.data());
     return llrs;
 }
 
@@ -134,35 +138,36 @@ std::vector<std::vector<float>> deinterleave_soft(
 
 // Soft Hamming decode: ML codeword selection.
 // cw_llrs has cw_len floats (one per codeword bit, MSB first).
-// Positive LLR → bit more likely 1.
-uint8_t hamming_decode_soft(const std::vector<float>& cw_llrs, int cr_app)
+// Positive LLR → bit more likely 1.  Candidate d scores
+// sum_j (+/-1)·llr[j], i.e. +|llr| where it agrees with the LLR sign.
+uint8_t hamming_decode_soft(const float* cw_llrs, int cr_app)
 {
     const int cw_len = cr_app + 4;
+    const auto& book = kSoftCodebook[static_cast<std::size_t>(cr_app - 1)];
+
+    alignas(64) float scores[16] = {};
+    for (int j = 0; j < cw_len; ++j) {
+        const float llr = cw_llrs[j];
+        const auto& column = book[static_cast<std::size_t>(j)];
+        for (int d = 0; d < 16; ++d) {
+            scores[d] += column[d] * llr;
+        }
+    }
 
-    float best_score = -std::numeric_limits<float>::infinity();
     int best_nibble = 0;
-
-    for (int d = 0; d < 16; ++d) {
-        const uint8_t cw = hamming_encode(static_cast<uint8_t>(d), cr_app);
-        float score = 0.0f;
-        for (int j = 0; j < cw_len; ++j) {
-            // j=0 corresponds to bits[0] = MSB of codeword value
-            const int cw_bit = (cw >> (cw_len - 1 - j)) & 1;
-            if (cw_bit == (cw_llrs[j] > 0.0f ? 1 : 0)) {
-                score += std::abs(cw_llrs[j]);
-            } else {
-                score -= std::abs(cw_llrs[j]);
-            }
-        }
-        if (score > best_score) {
-            best_score = score;
+    for (int d = 1; d < 16; ++d) {
+        if (scores[d] > scores[best_nibble]) {
             best_nibble = d;
         }
     }
-
     return static_cast<uint8_t>(best_nibble);
 }
 
+uint8_t hamming_decode_soft(const std::vector<float>& cw_llrs, int cr_app)
+{
+    return hamming_decode_soft(cw_llrs.data(), cr_app);
+}
+
 // Convenience: soft-decode a block of symbols → nibbles.
 std::vector<uint8_t> soft_decode_block(
     const std::vector<SymbolLLR>& symbol_llrs,
@@ -179,4 +184,37 @@ std::vector<uint8_t> soft_decode_block(
     return nibbles;
 }
 
+std::size_t deinterleave_soft(const SoftSymbol* symbols, std::size_t count,
+                              int sf, int cr, bool is_header, bool ldro,
+                              SoftCodeword* codewords)
+{
+    const bool use_ldro = ldro || is_header;
+    const int sf_app = use_ldro ? sf - 2 : sf;
+    const int cw_len = is_header ? 8 : cr + 4;
+    if (count < static_cast<std::size_t>(cw_len)) {
+        throw std::runtime_error("Not enough symbols to soft-deinterleave block");
+    }
+    for (int i = 0; i < cw_len; ++i) {
+        for (int j = 0; j < sf_app; ++j) {
+            const int row = ((i - j - 1) % sf_app + sf_app) % sf_app;
+            codewords[row][static_cast<std::size_t>(i)] = symbols[i][static_cast<std::size_t>(j)];
+        }
+    }
+    return static_cast<std::size_t>(sf_app);
+}
+
+std::size_t soft_decode_block(const SoftSymbol* symbols, std::size_t count,
+                              int sf, int cr, bool is_header, bool ldro,
+                              uint8_t* nibbles, std::size_t& consumed)
+{
+    SoftCodeword codewords[kMaxSoftBits];
+    const std::size_t n = deinterleave_soft(symbols, count, sf, cr, is_header, ldro, codewords);
+    const int cr_app = is_header ? 4 : cr;
+    for (std::size_t r = 0; r < n; ++r) {
+        nibbles[r] = hamming_decode_soft(codewords[r].data(), cr_app);
+    }
+    consumed = static_cast<std::size_t>(is_header ? 8 : cr + 4);
+    return n;
+}
+
 } // namespace host_sim
@@ -0,0 +1,86 @@
+#include "host_sim/symbol_source.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+namespace
+{
+
+std::size_t symbols_that_fit(std::size_t total,
+                             std::size_t offset,
+                             std::size_t samples_per_symbol,
+                             std::size_t requested)
+{
+    if (samples_per_symbol == 0) {
+        throw std::runtime_error("SpanSymbolSource needs a non-zero symbol length");
+    }
+    const std::size_t available = total > offset ? (total - offset) / samples_per_symbol : 0;
+    return std::min(available, requested);
+}
+
+} // namespace
+
+std::optional<SymbolView> SymbolSource::next_view()
+{
+    auto buffer = next_symbol();
+    if (!buffer) {
+        return std::nullopt;
+    }
+    lent_ = std::move(*buffer);
+    return SymbolView{lent_.samples, lent_.samples_q15};
+}
+
+SpanSymbolSource::SpanSymbolSource(std::span<const std::complex<float>> samples,
+                                   std::size_t offset,
+                                   std::size_t samples_per_symbol,
+                                   std::size_t symbol_count)
+    : samples_(samples),
+      offset_(offset),
+      samples_per_symbol_(samples_per_symbol),
+      symbol_count_(symbols_that_fit(samples.size(), offset, samples_per_symbol, symbol_count))
+{
+}
+
+SpanSymbolSource::SpanSymbolSource(std::span<const Q15Complex> samples,
+                                   std::size_t offset,
+                                   std::size_t samples_per_symbol,
+                                   std::size_t symbol_count)
+    : samples_q15_(samples),
+      offset_(offset),
+      samples_per_symbol_(samples_per_symbol),
+      symbol_count_(symbols_that_fit(samples.size(), offset, samples_per_symbol, symbol_count))
+{
+}
+
+std::optional<SymbolView> SpanSymbolSource::next_view()
+{
+    if (index_ >= symbol_count_) {
+        return std::nullopt;
+    }
+    const std::size_t start = offset_ + index_ * samples_per_symbol_;
+    ++index_;
+    SymbolView view;
+    if (!samples_.empty()) {
+        view.samples = samples_.subspan(start, samples_per_symbol_);
+    } else {
+        view.samples_q15 = samples_q15_.subspan(start, samples_per_symbol_);
+    }
+    return view;
+}
+
+std::optional<SymbolBuffer> SpanSymbolSource::next_symbol()
+{
+    const auto view = next_view();
+    if (!view) {
+        return std::nullopt;
+    }
+    SymbolBuffer buffer;
+    buffer.samples.assign(view->samples.begin(), view->samples.end());
+    buffer.samples_q15.assign(view->samples_q15.begin(), view->samples_q15.end());
+    return buffer;
+}
+
+} // namespace host_sim
@@ -0,0 +1,98 @@
+#include "host_sim/symbol_timing.hpp"
+
+#include "host_sim/trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+SymbolTimingTracker::SymbolTimingTracker(const SymbolTimingConfig& config)
+    : config_(config),
+      samples_per_bin_(static_cast<double>(config.samples_per_symbol) / static_cast<double>(1 << config.sf)),
+      stride_(config.nominal_stride)
+{
+    if (config_.nominal_stride <= 0.0 || config_.samples_per_symbol <= 0) {
+        throw std::runtime_error("SymbolTimingTracker: stride must be positive");
+    }
+}
+
+std::size_t SymbolTimingTracker::next_offset() const
+{
+    return static_cast<std::size_t>(std::max(0.0, std::round(position_)));
+}
+
+bool SymbolTimingTracker::reliable(const float* fft_mag_sq) const
+{
+    const std::size_t n = std::size_t{1} << config_.sf;
+    float peak = 0.0f;
+    double total = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        peak = std::max(peak, fft_mag_sq[i]);
+        total += static_cast<double>(fft_mag_sq[i]);
+    }
+    // Noise alone peaks near ln(N) times the mean bin power.
+    const double n_bins = static_cast<double>(n);
+    return static_cast<double>(peak) * n_bins > static_cast<double>(config_.peak_gate) * std::log(n_bins) * total;
+}
+
+void SymbolTimingTracker::update(float residual, bool reliable)
+{
+    double error = 0.0;
+    if (reliable && static_cast<int>(symbols_) >= config_.delay_symbols) {
+        // Windows start on whole samples: one `early` samples before the
+        // tracked position reads that many samples' worth of bins low,
+        // which is rounding, not timing error.
+        const double early = position_ - static_cast<double>(next_offset());
+        error = static_cast<double>(residual) + early / samples_per_bin_;
+        if (error > 0.5) error -= 1.0;
+        if (error < -0.5) error += 1.0;
+        const auto limit = static_cast<double>(config_.max_error);
+        error = std::clamp(error, -limit, limit);
+    }
+    // Reading high means the window is late: pull the next one in.
+    const double late = error * samples_per_bin_;
+    stride_ -= static_cast<double>(config_.ki) * late;
+    position_ += stride_ - static_cast<double>(config_.kp) * late;
+    ++symbols_;
+}
+
+std::size_t demodulate_tracked(const FftDemodulator& demod,
+                               std::span<const std::complex<float>> samples,
+                               std::size_t first,
+                               SymbolTimingTracker& tracker,
+                               std::size_t max_symbols,
+                               const LoRaMetadata& meta,
+                               std::pmr::vector<uint16_t>& symbols,
+                               std::pmr::vector<SoftSymbol>* llrs)
+{
+    HOST_SIM_TRACE_SPAN("demod/tracked");
+    HOST_SIM_TRACE_COUNT(demod_passes, 1);
+    const auto sps = static_cast<std::size_t>(demod.samples_per_symbol());
+    // Grown once: the buffers may live in a monotonic arena, where every
+    // reallocation leaves the old block behind.
+    const std::size_t room = first < samples.size() ? (samples.size() - first) / sps + 1 : 0;
+    symbols.reserve(symbols.size() + std::min(max_symbols, room));
+    if (llrs) {
+        llrs->reserve(llrs->size() + std::min(max_symbols, room));
+    }
+    std::size_t appended = 0;
+    for (std::size_t i = 0; i < max_symbols; ++i) {
+        const std::size_t start = first + tracker.next_offset();
+        if (start + sps > samples.size()) {
+            break;
+        }
+        symbols.push_back(demod.demodulate(samples.data() + start));
+        const auto& mags = demod.get_fft_magnitudes_sq();
+        if (llrs) {
+            llrs->push_back(compute_soft_symbol(mags.data(), meta.sf, tracker.symbols() < 8 || meta.ldro, demod.current_cfo_int()));
+        }
+        tracker.update(demod.last_residual(), tracker.reliable(mags.data()));
+        ++appended;
+    }
+    return appended;
+}
+
+} // namespace host_sim
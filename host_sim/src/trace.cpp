@@ -0,0 +1,243 @@
+#include "host_sim/trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_SIM_TRACE_TSC 1
+#endif
+
+namespace host_sim::trace
+{
+
+namespace detail
+{
+std::atomic<bool> enabled{false};
+} // namespace detail
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kRingEvents = std::size_t{1} << 16;
+
+struct Event
+{
+    const char* name{nullptr};
+    std::uint64_t begin{0};
+    std::uint64_t end{0};
+};
+
+// One thread's events and counters.  Only the owning thread writes; it
+// publishes each event by bumping `head` after the slot is filled.
+struct ThreadLog
+{
+    std::vector<Event> ring = std::vector<Event>(kRingEvents);
+    std::atomic<std::uint64_t> head{0};
+    std::array<std::atomic<std::uint64_t>, kCounterCount> counters{};
+    std::uint32_t tid{0};
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadLog>> logs;   // kept past thread exit
+    std::uint64_t base_ticks{0};                    // timestamps at the first enable
+    Clock::time_point base_time{};
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+ThreadLog& local_log()
+{
+    thread_local std::shared_ptr<ThreadLog> log;
+    if (!log) {
+        log = std::make_shared<ThreadLog>();
+        auto& reg = registry();
+        const std::lock_guard<std::mutex> lock(reg.mutex);
+        log->tid = static_cast<std::uint32_t>(reg.logs.size() + 1);
+        reg.logs.push_back(log);
+    }
+    return *log;
+}
+
+// Ticks per microsecond, measured against the steady clock since the
+// first enable (spinning until that spans at least 20 ms).
+double ticks_per_us(const Registry& reg)
+{
+#ifdef HOST_SIM_TRACE_TSC
+    Clock::time_point t;
+    std::uint64_t ticks = 0;
+    do {
+        t = Clock::now();
+        ticks = detail::now();
+    } while (t - reg.base_time < std::chrono::milliseconds(20));
+    const double us = std::chrono::duration<double, std::micro>(t - reg.base_time).count();
+    return static_cast<double>(ticks - reg.base_ticks) / us;
+#else
+    static_cast<void>(reg);
+    return 1000.0;   // steady-clock nanoseconds
+#endif
+}
+
+} // namespace
+
+namespace detail
+{
+
+std::uint64_t now()
+{
+#ifdef HOST_SIM_TRACE_TSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+#endif
+}
+
+void record(const char* name, std::uint64_t begin, std::uint64_t end)
+{
+    auto& log = local_log();
+    const std::uint64_t head = log.head.load(std::memory_order_relaxed);
+    log.ring[head % kRingEvents] = {name, begin, end};
+    log.head.store(head + 1, std::memory_order_release);
+}
+
+void add(Counter counter, std::uint64_t n)
+{
+    auto& slot = local_log().counters[static_cast<std::size_t>(counter)];
+    slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+const char* counter_name(Counter counter)
+{
+    switch (counter) {
+    case Counter::ffts: return "ffts";
+    case Counter::bursts: return "bursts";
+    case Counter::candidates: return "candidates";
+    case Counter::demod_passes: return "demod_passes";
+    case Counter::header_attempts: return "header_attempts";
+    case Counter::crc_probes: return "crc_probes";
+    case Counter::redemod_passes: return "redemod_passes";
+    case Counter::count: break;
+    }
+    return "?";
+}
+
+void set_enabled(bool on)
+{
+    if (on) {
+        auto& reg = registry();
+        const std::lock_guard<std::mutex> lock(reg.mutex);
+        if (reg.base_ticks == 0) {
+            reg.base_time = Clock::now();
+            reg.base_ticks = detail::now();
+        }
+    }
+    detail::enabled.store(on, std::memory_order_relaxed);
+}
+
+void reset()
+{
+    auto& reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& log : reg.logs) {
+        log->head.store(0, std::memory_order_relaxed);
+        for (auto& c : log->counters) {
+            c.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+Counters counters()
+{
+    Counters total{};
+    auto& reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& log : reg.logs) {
+        for (std::size_t i = 0; i < kCounterCount; ++i) {
+            total[i] += log->counters[i].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> counter_list()
+{
+    const Counters values = counters();
+    std::vector<std::pair<std::string, std::uint64_t>> list;
+    for (std::size_t i = 0; i < kCounterCount; ++i) {
+        list.emplace_back(counter_name(static_cast<Counter>(i)), values[i]);
+    }
+    return list;
+}
+
+std::uint64_t dropped_events()
+{
+    std::uint64_t dropped = 0;
+    auto& reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& log : reg.logs) {
+        const std::uint64_t head = log->head.load(std::memory_order_acquire);
+        dropped += head > kRingEvents ? head - kRingEvents : 0;
+    }
+    return dropped;
+}
+
+std::size_t write_chrome_trace(const std::filesystem::path& path)
+{
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Failed to open trace output file: " + path.string());
+    }
+    const Counters totals = counters();
+    const std::uint64_t dropped = dropped_events();
+
+    auto& reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    const double scale = reg.base_ticks != 0 ? 1.0 / ticks_per_us(reg) : 0.0;
+    const auto to_us = [&](std::uint64_t ticks) {
+        return ticks > reg.base_ticks ? static_cast<double>(ticks - reg.base_ticks) * scale : 0.0;
+    };
+
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+    std::size_t written = 0;
+    double last_us = 0.0;
+    for (const auto& log : reg.logs) {
+        const std::uint64_t head = log->head.load(std::memory_order_acquire);
+        for (std::uint64_t i = head > kRingEvents ? head - kRingEvents : 0; i < head; ++i) {
+            const Event& ev = log->ring[i % kRingEvents];
+            const double ts = to_us(ev.begin);
+            const double dur = ev.end > ev.begin ? static_cast<double>(ev.end - ev.begin) * scale : 0.0;
+            last_us = std::max(last_us, ts + dur);
+            out << (written++ ? ",\n" : "") << "{\"name\":\"" << ev.name
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << log->tid << ",\"ts\":" << ts
+                << ",\"dur\":" << dur << "}";
+        }
+    }
+    out << (written ? ",\n" : "") << "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":"
+        << last_us << ",\"args\":{";
+    for (std::size_t i = 0; i < kCounterCount; ++i) {
+        out << (i ? "," : "") << "\"" << counter_name(static_cast<Counter>(i)) << "\":" << totals[i];
+    }
+    out << "}}\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+    if (!out) {
+        throw std::runtime_error("Failed to write trace output file: " + path.string());
+    }
+    return written;
+}
+
+} // namespace host_sim::trace
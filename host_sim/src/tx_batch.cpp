@@ -0,0 +1,83 @@
+#include "host_sim/tx/batch.hpp"
+
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+namespace host_sim::tx
+{
+
+namespace
+{
+
+// Each packet owns two streams of the batch seed.
+constexpr uint64_t kPayloadStream = 0;
+constexpr uint64_t kNoiseStream = 1;
+
+CounterRng packet_stream(uint64_t seed, std::size_t index, uint64_t purpose)
+{
+    return CounterRng::stream(seed, static_cast<uint64_t>(index) * 2 + purpose);
+}
+
+} // namespace
+
+BatchGenerator::BatchGenerator(BatchOptions options) : options_(std::move(options))
+{
+    const auto& p = options_.packet;
+    if (p.bw <= 0 || p.sample_rate < p.bw || p.sample_rate % p.bw != 0) {
+        throw std::runtime_error("BatchGenerator: sample_rate must be a multiple of bw");
+    }
+    if (options_.payload.empty() && options_.payload_len == 0) {
+        throw std::runtime_error("BatchGenerator: empty payload");
+    }
+}
+
+BatchPacket BatchGenerator::generate(std::size_t index) const
+{
+    const auto& p = options_.packet;
+    BatchPacket packet;
+    packet.index = index;
+    if (!options_.payload.empty()) {
+        packet.payload = options_.payload;
+    } else {
+        const CounterRng rng = packet_stream(options_.seed, index, kPayloadStream);
+        packet.payload.resize(options_.payload_len);
+        for (std::size_t i = 0; i < packet.payload.size(); ++i) {
+            packet.payload[i] = static_cast<uint8_t>(rng.bits(i));
+        }
+    }
+
+    const auto symbols = encode_packet_symbols(p, packet.payload);
+    const int os = p.oversample_factor();
+    const auto modulator = shared_modulator(p.sf, os);
+    packet.iq.resize(packet_length(p.sf, os, p.preamble_len, symbols.size()));
+    modulate_packet_into(*modulator, p.sync_word, p.preamble_len, symbols, packet.iq);
+    packet.channel = apply_channel(packet.iq, options_.channel, p.sample_rate,
+                                   packet_stream(options_.seed, index, kNoiseStream));
+    return packet;
+}
+
+void BatchGenerator::run(const Sink& sink, WorkerPool* pool) const
+{
+    WorkerPool& workers = pool != nullptr ? *pool : WorkerPool::shared();
+    const std::size_t window = options_.window > 0 ? options_.window : 4 * workers.worker_count();
+    std::vector<BatchPacket> wave(std::min(window, options_.count));
+    for (std::size_t start = 0; start < options_.count; start += window) {
+        const std::size_t n = std::min(window, options_.count - start);
+        workers.parallel_for(n, [&](std::size_t i, std::size_t) { wave[i] = generate(start + i); });
+        for (std::size_t i = 0; i < n; ++i) {
+            sink(wave[i]);
+        }
+    }
+}
+
+void write_cf32(std::ostream& out, const BatchPacket& packet)
+{
+    out.write(reinterpret_cast<const char*>(packet.iq.data()),
+              static_cast<std::streamsize>(packet.iq.size() * sizeof(std::complex<float>)));
+}
+
+} // namespace host_sim::tx
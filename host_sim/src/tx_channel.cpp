@@ -0,0 +1,142 @@
+#include "host_sim/tx/channel.hpp"
+
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <numbers>
+
+namespace host_sim::tx
+{
+
+namespace
+{
+
+// Work unit for the parallel loops.  Fixed, so chunk boundaries (where the
+// CFO phasor is re-seeded and partial power sums are cut) never depend on
+// the worker count.
+constexpr std::size_t kChunk = 4096;
+
+// Samples at or below this power are the silence lora_tx pads with.
+constexpr float kSilenceFloor = 1e-10f;
+
+bool is_signal(const std::complex<float>& s)
+{
+    return s.real() * s.real() + s.imag() * s.imag() > kSilenceFloor;
+}
+
+template <typename Fn>
+void for_each_chunk(std::size_t n, WorkerPool* pool, Fn&& fn)
+{
+    const std::size_t chunks = (n + kChunk - 1) / kChunk;
+    auto run = [&](std::size_t c) { fn(c, c * kChunk, std::min(n, (c + 1) * kChunk)); };
+    if (pool == nullptr || chunks < 2) {
+        for (std::size_t c = 0; c < chunks; ++c) {
+            run(c);
+        }
+        return;
+    }
+    pool->parallel_for(chunks, [&](std::size_t c, std::size_t) { run(c); });
+}
+
+} // namespace
+
+void apply_cfo(std::span<std::complex<float>> iq, double cfo_hz, double sample_rate, WorkerPool* pool)
+{
+    const double cycles_per_sample = cfo_hz / sample_rate;
+    const double two_pi = 2.0 * std::numbers::pi;
+    const std::complex<double> step = std::polar(1.0, two_pi * cycles_per_sample);
+    for_each_chunk(iq.size(), pool, [&](std::size_t, std::size_t begin, std::size_t end) {
+        // Exact phase at the chunk start, then a short double-precision
+        // recurrence: drift stays far below float resolution.
+        const double start = cycles_per_sample * static_cast<double>(begin);
+        std::complex<double> phasor = std::polar(1.0, two_pi * (start - std::floor(start)));
+        for (std::size_t n = begin; n < end; ++n) {
+            iq[n] *= std::complex<float>(static_cast<float>(phasor.real()), static_cast<float>(phasor.imag()));
+            phasor *= step;
+        }
+    });
+}
+
+std::vector<std::complex<float>> apply_sfo(std::span<const std::complex<float>> iq, double ppm, WorkerPool* pool)
+{
+    const double rate_ratio = 1.0 + ppm * 1e-6;
+    const auto new_len = static_cast<std::size_t>(static_cast<double>(iq.size()) / rate_ratio);
+    std::vector<std::complex<float>> resampled(new_len);
+    for_each_chunk(new_len, pool, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const double src_idx = static_cast<double>(i) * rate_ratio;
+            const auto idx0 = static_cast<std::size_t>(src_idx);
+            const float frac = static_cast<float>(src_idx - static_cast<double>(idx0));
+            if (idx0 + 1 < iq.size()) {
+                resampled[i] = iq[idx0] * (1.0f - frac) + iq[idx0 + 1] * frac;
+            } else if (idx0 < iq.size()) {
+                resampled[i] = iq[idx0];
+            }
+        }
+    });
+    return resampled;
+}
+
+double signal_power(std::span<const std::complex<float>> iq, WorkerPool* pool)
+{
+    const std::size_t chunks = (iq.size() + kChunk - 1) / kChunk;
+    std::vector<double> sums(chunks, 0.0);
+    std::vector<std::size_t> counts(chunks, 0);
+    for_each_chunk(iq.size(), pool, [&](std::size_t c, std::size_t begin, std::size_t end) {
+        double sum = 0.0;
+        std::size_t count = 0;
+        for (std::size_t n = begin; n < end; ++n) {
+            if (is_signal(iq[n])) {
+                sum += static_cast<double>(std::norm(iq[n]));
+                ++count;
+            }
+        }
+        sums[c] = sum;
+        counts[c] = count;
+    });
+    double total = 0.0;
+    std::size_t count = 0;
+    for (std::size_t c = 0; c < chunks; ++c) {
+        total += sums[c];
+        count += counts[c];
+    }
+    return count > 0 ? total / static_cast<double>(count) : 1.0;
+}
+
+ChannelReport add_awgn(std::span<std::complex<float>> iq, float snr_db, const CounterRng& rng, WorkerPool* pool)
+{
+    ChannelReport report;
+    report.signal_power = signal_power(iq, pool);
+    const double noise_power = report.signal_power / std::pow(10.0, static_cast<double>(snr_db) / 10.0);
+    report.noise_std = static_cast<float>(std::sqrt(noise_power / 2.0));
+    const float sigma = report.noise_std;
+    for_each_chunk(iq.size(), pool, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t n = begin; n < end; ++n) {
+            if (is_signal(iq[n])) {
+                iq[n] += sigma * rng.normal_pair(n);
+            }
+        }
+    });
+    return report;
+}
+
+ChannelReport apply_channel(std::vector<std::complex<float>>& iq,
+                            const ChannelParams& params,
+                            double sample_rate,
+                            const CounterRng& rng,
+                            WorkerPool* pool)
+{
+    if (params.cfo_hz != 0.0f) {
+        apply_cfo(iq, params.cfo_hz, sample_rate, pool);
+    }
+    if (params.sfo_ppm != 0.0f) {
+        iq = apply_sfo(iq, params.sfo_ppm, pool);
+    }
+    ChannelReport report;
+    if (!std::isnan(params.snr_db)) {
+        report = add_awgn(iq, params.snr_db, rng, pool);
+    }
+    return report;
+}
+
+} // namespace host_sim::tx
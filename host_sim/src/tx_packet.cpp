@@ -0,0 +1,228 @@
+#include "host_sim/tx/packet.hpp"
+
+#include "host_sim/deinterleaver.hpp"
+#include "host_sim/hamming.hpp"
+#include "host_sim/lora_replay/header_encoder.hpp"
+#include "host_sim/lora_replay/stage_processing.hpp"
+#include "host_sim/shared_cache.hpp"
+#include "host_sim/whitening.hpp"
+
+#include <algorithm>
+#include <span>
+#include <utility>
+
+namespace host_sim::tx
+{
+
+namespace
+{
+
+// ---------- Interleave one block ----------
+// Takes up to sf_app codewords (each with cw_len bits), produces cw_len
+// symbols via the word-level transpose shared with the decoder.
+std::vector<uint16_t> interleave_codewords(const std::vector<uint8_t>& codewords,
+                                           int sf, int cr, bool is_header, bool ldro)
+{
+    DeinterleaverConfig cfg{sf, cr, is_header, ldro};
+    uint16_t symbols[kMaxInterleaverCols];
+    const std::size_t n = interleave_block(codewords.data(), codewords.size(), cfg, symbols);
+    return std::vector<uint16_t>(symbols, symbols + n);
+}
+
+} // namespace
+
+bool ldro_required(int sf, int bw)
+{
+    const float symbol_duration_ms = static_cast<float>(1 << sf) * 1000.0f / static_cast<float>(bw);
+    return symbol_duration_ms > 16.0f;
+}
+
+// ---------- Full payload encode ----------
+// Takes raw payload bytes, returns all data symbols (header + payload).
+//
+// The LoRa frame encodes a single nibble stream:
+//   [5 header nibbles] + [data nibbles from whitened payload+CRC]
+//
+// The first interleave block ("header block") consumes (sf-2) nibbles
+// from this stream, always encoded at CR=4 (Hamming(8,4)), with
+// sf_app = sf-2 and cw_len = 8.
+//   - Positions 0..4: the 5 header field nibbles
+//   - Positions 5..sf-3: the first (sf-7) data nibbles (only when sf>7)
+//
+// Subsequent payload blocks each consume sf_app nibbles at the
+// packet's actual CR, where sf_app = sf (no LDRO) or sf-2 (LDRO).
+std::vector<uint16_t> encode_packet_symbols(
+    int sf, int cr, bool has_crc, bool ldro, bool implicit_header,
+    const std::vector<uint8_t>& payload)
+{
+    // 1. CRC on raw payload; whiten only the payload bytes.
+    //    CRC bytes are NOT whitened (matching GNU Radio behavior).
+    //    compute_lora_crc() = CRC16(payload[0..n-3]) XOR (payload[n-2]<<8 | payload[n-1]).
+    //    One fused pass runs the CRC over the payload body and whitens it.
+    std::vector<uint8_t> data_stream;
+    data_stream.reserve(payload.size() + 2);
+    data_stream.assign(payload.begin(), payload.end());
+    const std::size_t crc_body = payload.size() >= 2 ? payload.size() - 2 : payload.size();
+    const uint16_t body_crc = crc16_then_whiten(std::span(data_stream).first(crc_body));
+    whiten_in_place(std::span(data_stream).subspan(crc_body), crc_body);
+    if (has_crc) {
+        const uint16_t crc_val = payload.size() < 2
+            ? uint16_t{0}
+            : static_cast<uint16_t>(body_crc ^ payload.back() ^ (payload[payload.size() - 2] << 8));
+        data_stream.push_back(static_cast<uint8_t>(crc_val & 0xFF));
+        data_stream.push_back(static_cast<uint8_t>((crc_val >> 8) & 0xFF));
+    }
+
+    // 2. Split data into nibbles (low nibble first for each byte)
+    std::vector<uint8_t> data_nibbles;
+    for (uint8_t byte : data_stream) {
+        data_nibbles.push_back(static_cast<uint8_t>(byte & 0xF));
+        data_nibbles.push_back(static_cast<uint8_t>((byte >> 4) & 0xF));
+    }
+
+    // 3. Build the merged nibble stream for the header block.
+    //    Explicit: 5 header nibbles + first max(0, sf-7) data nibbles
+    //    Implicit: all sf-2 nibbles are data (no header field)
+    const int sf_app_hdr = sf - 2;
+    int data_in_header;
+    std::vector<uint8_t> header_block_nibbles;
+    if (implicit_header) {
+        data_in_header = sf_app_hdr;
+        for (int i = 0; i < data_in_header && i < static_cast<int>(data_nibbles.size()); ++i) {
+            header_block_nibbles.push_back(data_nibbles[i]);
+        }
+    } else {
+        auto header_nibbles = lora_replay::build_header_nibbles(
+            static_cast<int>(payload.size()), has_crc, cr);
+        data_in_header = std::max(0, sf_app_hdr - 5);
+        header_block_nibbles = header_nibbles;
+        for (int i = 0; i < data_in_header && i < static_cast<int>(data_nibbles.size()); ++i) {
+            header_block_nibbles.push_back(data_nibbles[i]);
+        }
+    }
+
+    // 4. Encode header block: CR=4, sf_app=sf-2, cw_len=8
+    constexpr int header_cr = 4;
+    {
+        std::vector<uint8_t> header_codewords;
+        for (int i = 0; i < sf_app_hdr; ++i) {
+            uint8_t nib = (i < static_cast<int>(header_block_nibbles.size()))
+                          ? header_block_nibbles[i] : uint8_t{0};
+            header_codewords.push_back(hamming_encode(nib, header_cr));
+        }
+        auto header_symbols = interleave_codewords(header_codewords, sf, header_cr,
+                                                   true, false);
+        // Note: header block uses sf_app < sf, so interleave_codewords adds parity bit
+
+        // 5. Encode payload blocks from remaining data nibbles
+        const int payload_cr = cr;
+        const int payload_sf_app = ldro ? sf - 2 : sf;
+
+        std::vector<uint16_t> payload_symbols;
+        std::size_t idx = static_cast<std::size_t>(data_in_header);
+        while (idx < data_nibbles.size()) {
+            std::vector<uint8_t> block_codewords;
+            for (int i = 0; i < payload_sf_app && idx < data_nibbles.size(); ++i, ++idx) {
+                block_codewords.push_back(hamming_encode(data_nibbles[idx], payload_cr));
+            }
+            auto block_syms = interleave_codewords(block_codewords, sf, payload_cr,
+                                                   false, ldro);
+            payload_symbols.insert(payload_symbols.end(),
+                                   block_syms.begin(), block_syms.end());
+        }
+
+        // 6. Concatenate: header + payload
+        std::vector<uint16_t> all_symbols;
+        all_symbols.insert(all_symbols.end(),
+                           header_symbols.begin(), header_symbols.end());
+        all_symbols.insert(all_symbols.end(),
+                           payload_symbols.begin(), payload_symbols.end());
+        return all_symbols;
+    }
+}
+
+std::vector<uint16_t> encode_packet_symbols(const PacketParams& params, const std::vector<uint8_t>& payload)
+{
+    return encode_packet_symbols(params.sf, params.cr, params.has_crc, params.ldro, params.implicit_header, payload);
+}
+
+std::shared_ptr<const ChirpModulator> shared_modulator(int sf, int oversample_factor)
+{
+    static SharedCache<std::pair<int, int>, ChirpModulator> cache;
+    return cache.get({sf, oversample_factor}, [&] {
+        return std::make_shared<const ChirpModulator>(sf, oversample_factor);
+    });
+}
+
+// ---------- IQ modulation ----------
+// Use max(preamble + 12, data/2) symbols to guarantee enough margin.
+int padding_symbols(int preamble_len, std::size_t data_sym_count)
+{
+    const int signal_syms = preamble_len + 2 + 3 + static_cast<int>(data_sym_count); // preamble+sync+SFD+data
+    return std::max(preamble_len + 12, signal_syms / 2);
+}
+
+std::size_t packet_length(int sf, int os_factor, int preamble_len, std::size_t data_sym_count)
+{
+    const auto sps = static_cast<std::size_t>(1 << sf) * static_cast<std::size_t>(os_factor);
+    const auto pad = static_cast<std::size_t>(padding_symbols(preamble_len, data_sym_count));
+    const auto chirps = static_cast<std::size_t>(preamble_len) + 2 + 2 + data_sym_count;
+    return 2 * pad * sps + chirps * sps + sps / 4;
+}
+
+void modulate_packet_into(const ChirpModulator& modulator,
+                          int sync_word,
+                          int preamble_len,
+                          const std::vector<uint16_t>& data_symbols,
+                          std::span<std::complex<float>> out)
+{
+    const std::size_t sps = modulator.samples_per_symbol();
+    const auto pad_len = sps * static_cast<std::size_t>(padding_symbols(preamble_len, data_symbols.size()));
+    std::complex<float>* cursor = out.data();
+
+    std::fill_n(cursor, pad_len, std::complex<float>{0.0f, 0.0f});
+    cursor += pad_len;
+
+    // Preamble: preamble_len unmodulated upchirps
+    for (int i = 0; i < preamble_len; ++i, cursor += sps) {
+        modulator.upchirp(0, cursor);
+    }
+
+    // Sync word: 2 modulated upchirps
+    const int sw0 = ((sync_word & 0xF0) >> 4) << 3;
+    const int sw1 = (sync_word & 0x0F) << 3;
+    modulator.upchirp(sw0, cursor);
+    cursor += sps;
+    modulator.upchirp(sw1, cursor);
+    cursor += sps;
+
+    // SFD: 2.25 downchirps
+    modulator.downchirp(cursor, sps);
+    cursor += sps;
+    modulator.downchirp(cursor, sps);
+    cursor += sps;
+    modulator.downchirp(cursor, sps / 4);
+    cursor += sps / 4;
+
+    // Data symbols: modulated upchirps
+    for (uint16_t sym : data_symbols) {
+        modulator.upchirp(sym, cursor);
+        cursor += sps;
+    }
+
+    // Trailing silence
+    std::fill_n(cursor, pad_len, std::complex<float>{0.0f, 0.0f});
+}
+
+std::vector<std::complex<float>> modulate_packet(
+    int sf, int os_factor, int sync_word,
+    int preamble_len,
+    const std::vector<uint16_t>& data_symbols)
+{
+    const auto modulator = shared_modulator(sf, os_factor);
+    std::vector<std::complex<float>> iq(packet_length(sf, os_factor, preamble_len, data_symbols.size()));
+    modulate_packet_into(*modulator, sync_word, preamble_len, data_symbols, iq);
+    return iq;
+}
+
+} // namespace host_sim::tx
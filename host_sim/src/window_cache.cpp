@@ -0,0 +1,95 @@
+#include "host_sim/window_cache.hpp"
+
+#include "host_sim/trace.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace host_sim
+{
+
+DemodWindowCache::DemodWindowCache(std::span<const std::complex<float>> samples, int sf, bool keep_spectra)
+    : samples_(samples), sf_(sf), keep_spectra_(keep_spectra)
+{
+}
+
+DemodWindowCache::DemodWindowCache(const FarrowResampler& source, int factor, int sf, bool keep_spectra)
+    : source_(&source), factor_(factor), sf_(sf), keep_spectra_(keep_spectra)
+{
+    if (factor_ < 1) {
+        throw std::runtime_error("DemodWindowCache: resampling factor must be positive");
+    }
+}
+
+std::size_t DemodWindowCache::size() const
+{
+    if (!source_) {
+        return samples_.size();
+    }
+    const std::size_t n = source_->size();
+    return n == 0 ? 0 : (n - 1) * static_cast<std::size_t>(factor_) + 1;
+}
+
+const DemodWindowCache::Window& DemodWindowCache::window(const FftDemodulator& demod, std::size_t start)
+{
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = entries_.find(start);
+        if (it != entries_.end()) {
+            return it->second;
+        }
+    }
+    // Demodulate outside the lock; a racing worker computing the same
+    // window gets the same result, and the first insert wins.
+    Window computed;
+    if (source_) {
+        // Scratch per thread: parallel candidates fill windows at once.
+        thread_local std::vector<std::complex<float>> scratch;
+        scratch.resize(static_cast<std::size_t>(demod.samples_per_symbol()));
+        source_->window(static_cast<double>(start) / factor_, scratch.size(), scratch.data());
+        computed.symbol = demod.demodulate(scratch.data());
+    } else {
+        computed.symbol = demod.demodulate(samples_.data() + start);
+    }
+    if (keep_spectra_) {
+        computed.spectrum = demod.get_fft_magnitudes_sq();
+    }
+    windows_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.try_emplace(start, std::move(computed)).first->second;
+}
+
+std::size_t DemodWindowCache::demodulate(const FftDemodulator& demod,
+                                         std::size_t first,
+                                         double stride,
+                                         std::size_t begin,
+                                         std::size_t end,
+                                         const LoRaMetadata& meta,
+                                         std::pmr::vector<uint16_t>& symbols,
+                                         std::pmr::vector<SoftSymbol>* llrs)
+{
+    if (llrs && !keep_spectra_) {
+        throw std::runtime_error("DemodWindowCache: LLRs requested without kept spectra");
+    }
+    HOST_SIM_TRACE_SPAN("demod/window_cache");
+    HOST_SIM_TRACE_COUNT(demod_passes, 1);
+    const auto sps = static_cast<std::size_t>(demod.samples_per_symbol() * factor_);
+    const std::size_t limit = size();
+    std::size_t appended = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        const std::size_t start = first + static_cast<std::size_t>(std::round(static_cast<double>(i) * stride));
+        if (start + sps > limit) {
+            break;
+        }
+        const Window& w = window(demod, start);
+        symbols.push_back(w.symbol);
+        if (llrs) {
+            llrs->push_back(compute_soft_symbol(w.spectrum.data(), sf_, i < 8 || meta.ldro, demod.current_cfo_int()));
+        }
+        ++appended;
+    }
+    return appended;
+}
+
+} // namespace host_sim
@@ -0,0 +1,165 @@
+#include "host_sim/worker_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+namespace host_sim
+{
+
+namespace
+{
+
+thread_local bool in_pool_task = false;
+
+std::size_t configured_workers()
+{
+    if (const char* env = std::getenv("HOST_SIM_THREADS")) {
+        try {
+            const long requested = std::stol(env);
+            if (requested >= 1) {
+                return static_cast<std::size_t>(requested);
+            }
+        } catch (const std::exception&) {
+            // Fall through to the hardware default.
+        }
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+struct WorkerPool::Job
+{
+    const Task* task{nullptr};
+    std::size_t count{0};
+    std::atomic<std::size_t> next{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+WorkerPool::WorkerPool(std::size_t workers) : worker_count_(std::max<std::size_t>(1, workers))
+{
+    threads_.reserve(worker_count_ - 1);
+    for (std::size_t w = 1; w < worker_count_; ++w) {
+        threads_.emplace_back(&WorkerPool::worker_main, this, w);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) {
+        t.join();
+    }
+}
+
+WorkerPool& WorkerPool::shared()
+{
+    static WorkerPool pool(configured_workers());
+    return pool;
+}
+
+void WorkerPool::run_job(Job& job, std::size_t worker)
+{
+    const bool was_in_task = in_pool_task;
+    in_pool_task = true;
+    for (;;) {
+        const std::size_t index = job.next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= job.count) {
+            break;
+        }
+        try {
+            (*job.task)(index, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.error_mutex);
+            if (!job.error) {
+                job.error = std::current_exception();
+            }
+            job.next.store(job.count, std::memory_order_relaxed);
+        }
+    }
+    in_pool_task = was_in_task;
+}
+
+void WorkerPool::worker_main(std::size_t worker)
+{
+    std::uint64_t seen = 0;
+    for (;;) {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            job = job_;
+            if (!job) {
+                continue;
+            }
+            ++busy_;
+        }
+        run_job(*job, worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busy_;
+        }
+        idle_.notify_all();
+    }
+}
+
+void WorkerPool::parallel_for(std::size_t count, const Task& task)
+{
+    if (count == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> submit(submit_mutex_, std::defer_lock);
+    if (count == 1 || worker_count_ == 1 || in_pool_task || !submit.try_lock()) {
+        const bool was_in_task = in_pool_task;
+        in_pool_task = true;
+        try {
+            for (std::size_t i = 0; i < count; ++i) {
+                task(i, 0);
+            }
+        } catch (...) {
+            in_pool_task = was_in_task;
+            throw;
+        }
+        in_pool_task = was_in_task;
+        return;
+    }
+
+    Job job;
+    job.task = &task;
+    job.count = count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    run_job(job, 0);
+
+    {
+        // Late wakers see job_ == nullptr and go back to sleep; wait for
+        // the ones already inside run_job() before `job` goes out of scope.
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = nullptr;
+        idle_.wait(lock, [&] { return busy_ == 0; });
+    }
+
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+} // namespace host_sim
@@ -0,0 +1,178 @@
+/// test_bounded_queue.cpp — Verify BoundedQueue: FIFO order and the full
+/// / empty edges on one thread, every item delivered exactly once (and in
+/// per-producer order) with several producers and consumers, blocking
+/// push() as backpressure, and close() draining then waking waiters.
+
+#include "host_sim/bounded_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+int test_single_thread()
+{
+    int failures = 0;
+    host_sim::BoundedQueue<int> q(5);
+    if (q.capacity() != 8) {
+        std::fprintf(stderr, "capacity %zu, expected 8\n", q.capacity());
+        ++failures;
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 8; ++i) {
+            int v = round * 100 + i;
+            if (!q.try_push(v)) {
+                std::fprintf(stderr, "round %d: push %d refused\n", round, i);
+                return failures + 1;
+            }
+        }
+        int extra = -1;
+        if (q.try_push(extra) || extra != -1) {
+            std::fprintf(stderr, "round %d: push into a full queue\n", round);
+            ++failures;
+        }
+        for (int i = 0; i < 8; ++i) {
+            int v = -1;
+            if (!q.try_pop(v) || v != round * 100 + i) {
+                std::fprintf(stderr, "round %d: pop %d gave %d\n", round, i, v);
+                return failures + 1;
+            }
+        }
+        int none = 0;
+        if (q.try_pop(none)) {
+            std::fprintf(stderr, "round %d: pop from an empty queue\n", round);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_mpmc()
+{
+    constexpr int kProducers = 3;
+    constexpr int kConsumers = 3;
+    constexpr std::uint32_t kPerProducer = 20000;
+    host_sim::BoundedQueue<std::uint32_t> q(16);
+
+    std::vector<std::vector<std::uint32_t>> received(kConsumers);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c) {
+        consumers.emplace_back([&, c] {
+            std::uint32_t v = 0;
+            while (q.pop(v)) {
+                received[c].push_back(v);
+            }
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (std::uint32_t i = 0; i < kPerProducer; ++i) {
+                std::uint32_t v = static_cast<std::uint32_t>(p) << 24 | i;
+                q.push(v);
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    q.close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    int failures = 0;
+    std::vector<std::uint32_t> seen(kProducers * kPerProducer, 0);
+    for (const auto& items : received) {
+        std::vector<std::int64_t> last(kProducers, -1);
+        for (const auto v : items) {
+            const auto p = v >> 24;
+            const auto i = v & 0xFFFFFF;
+            if (static_cast<std::int64_t>(i) <= last[p]) {
+                std::fprintf(stderr, "mpmc: producer %u out of order at %u\n", p, i);
+                return failures + 1;
+            }
+            last[p] = i;
+            ++seen[p * kPerProducer + i];
+        }
+    }
+    for (std::size_t k = 0; k < seen.size(); ++k) {
+        if (seen[k] != 1) {
+            std::fprintf(stderr, "mpmc: item %zu delivered %u times\n", k, seen[k]);
+            return failures + 1;
+        }
+    }
+    return failures;
+}
+
+int test_backpressure_and_close()
+{
+    int failures = 0;
+    host_sim::BoundedQueue<int> q(2);
+    for (int i = 0; i < 2; ++i) {
+        q.push(i);
+    }
+
+    // A full queue holds the producer until the consumer makes room.
+    std::atomic<bool> pushed{false};
+    std::thread producer([&] {
+        int v = 2;
+        q.push(v);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    if (pushed) {
+        std::fprintf(stderr, "close: push did not block on a full queue\n");
+        ++failures;
+    }
+    int v = -1;
+    q.pop(v);
+    producer.join();
+
+    // close() lets consumers drain, then pops fail and pushes are refused.
+    q.close();
+    int late = 9;
+    if (q.push(late)) {
+        std::fprintf(stderr, "close: push accepted after close\n");
+        ++failures;
+    }
+    std::vector<int> drained;
+    while (q.pop(v)) {
+        drained.push_back(v);
+    }
+    if (drained != std::vector<int>{1, 2}) {
+        std::fprintf(stderr, "close: drained %zu items\n", drained.size());
+        ++failures;
+    }
+
+    // A consumer blocked on an empty queue wakes up on close().
+    host_sim::BoundedQueue<int> empty(4);
+    std::thread waiter([&] {
+        int x = 0;
+        if (empty.pop(x)) {
+            std::fprintf(stderr, "close: pop returned an item from an empty queue\n");
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    empty.close();
+    waiter.join();
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_single_thread();
+    failures += test_mpmc();
+    failures += test_backpressure_and_close();
+
+    std::printf("Bounded queue test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
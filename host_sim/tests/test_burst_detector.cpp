@@ -0,0 +1,280 @@
+/// test_burst_detector.cpp — Verify that BurstDetector, fed a stream in
+/// arbitrary chunks and compacted by whole windows, reaches the same
+/// burst start and noise floor as a full detect_burst_ex() rescan, that
+/// its quartile tracking survives non-aligned consumes, and that
+/// find_end() stops after the quiet tail; and that BurstIndex answers
+/// every search origin exactly like the full-rescan detector it replaced
+/// and lists each burst once.
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/burst_detector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <optional>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr std::size_t kWindow = 256;
+
+/// Noise with bursts of @p burst_windows windows every @p period windows.
+std::vector<std::complex<float>> make_stream(std::size_t n_windows, std::size_t period,
+                                             std::size_t burst_windows, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    std::vector<std::complex<float>> out(n_windows * kWindow);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        out[i] = {noise(rng), noise(rng)};
+        const std::size_t w = i / kWindow;
+        if (w % period >= period / 2 && w % period < period / 2 + burst_windows) {
+            const float phase = 0.001f * static_cast<float>(i * i % 100000);
+            out[i] += std::complex<float>(std::cos(phase), std::sin(phase)) * 0.5f;
+        }
+    }
+    return out;
+}
+
+/// Exact lowest-quartile mean of the complete windows in [0, n).
+float reference_noise(const std::complex<float>* samples, std::size_t n)
+{
+    std::vector<float> powers;
+    for (std::size_t w = 0; w + kWindow <= n; w += kWindow) {
+        double acc = 0.0;
+        for (std::size_t i = 0; i < kWindow; ++i) {
+            acc += std::norm(samples[w + i]);
+        }
+        powers.push_back(static_cast<float>(acc / kWindow));
+    }
+    std::sort(powers.begin(), powers.end());
+    const std::size_t q = std::max<std::size_t>(1, powers.size() / 4);
+    double acc = 0.0;
+    for (std::size_t i = 0; i < q; ++i) {
+        acc += powers[i];
+    }
+    return static_cast<float>(acc / static_cast<double>(q));
+}
+
+bool close(float a, float b)
+{
+    return std::fabs(a - b) <= 1e-5f * std::max(std::fabs(a), std::fabs(b));
+}
+
+int test_matches_rescan()
+{
+    const auto stream = make_stream(400, 40, 12, 1);
+    host_sim::BurstDetector detector(kWindow, 6.0f, 2);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> chunk(1, 3 * kWindow);
+
+    int failures = 0;
+    std::size_t head = 0;
+    std::size_t fed = 0;
+    std::size_t checks = 0;
+    while (fed < stream.size()) {
+        fed = std::min(stream.size(), fed + chunk(rng));
+        const std::size_t avail = fed - head;
+        detector.update(stream.data() + head, avail);
+
+        const auto got = detector.find_start(0);
+        const auto ref = host_sim::detect_burst_ex(stream.data() + head, avail,
+                                                   static_cast<int>(kWindow), 6.0f, 0, 0.0f, 2);
+        ++checks;
+        if (got.has_value() != ref.has_value() ||
+            (got && (got->burst_start != ref->burst_start || !close(got->noise_floor, ref->noise_floor)))) {
+            std::fprintf(stderr, "head %zu avail %zu: detector disagrees with rescan\n", head, avail);
+            ++failures;
+            break;
+        }
+        // Keep roughly 30 windows buffered, compacting in whole windows.
+        if (avail > 30 * kWindow) {
+            const std::size_t drop = (avail - 20 * kWindow) / kWindow * kWindow;
+            detector.consume(drop);
+            head += drop;
+        }
+    }
+    std::printf("  rescan: %zu checks\n", checks);
+    return failures;
+}
+
+int test_unaligned_consume()
+{
+    const auto stream = make_stream(120, 30, 8, 2);
+    host_sim::BurstDetector detector(kWindow, 6.0f, 2);
+    int failures = 0;
+    std::size_t head = 0;
+    for (std::size_t fed = 1000; fed <= stream.size(); fed += 1000) {
+        detector.update(stream.data() + head, fed - head);
+        const std::size_t drop = 777;
+        detector.consume(drop);
+        head += drop;
+
+        // Only windows wholly inside the buffer and on the absolute grid
+        // are kept.
+        const std::size_t first = (head + kWindow - 1) / kWindow * kWindow;
+        const std::size_t expected = first < fed ? (fed - first) / kWindow : 0;
+        if (detector.window_count() != expected) {
+            std::fprintf(stderr, "head %zu: %zu windows held, expected %zu\n", head,
+                         detector.window_count(), expected);
+            return failures + 1;
+        }
+        if (expected > 0 && !close(detector.noise_floor(),
+                                   reference_noise(stream.data() + first, fed - first))) {
+            std::fprintf(stderr, "head %zu: noise floor drifted\n", head);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_find_end()
+{
+    // Bursts occupy windows [20, 32) of each 40-window period.
+    const auto stream = make_stream(40, 40, 12, 3);
+    host_sim::BurstDetector detector(kWindow, 6.0f, 2);
+    int failures = 0;
+
+    detector.update(stream.data(), 30 * kWindow);
+    const auto start = detector.find_start(0);
+    if (!start || start->burst_start != 18 * kWindow) {
+        std::fprintf(stderr, "find_start: %zu\n", start ? start->burst_start : 0);
+        return 1;
+    }
+    const auto partial = detector.find_end(start->burst_start, start->noise_floor);
+    if (partial.complete) {
+        std::fprintf(stderr, "find_end completed before the burst ended\n");
+        ++failures;
+    }
+
+    detector.update(stream.data(), stream.size());
+    const auto full = detector.find_end(start->burst_start, start->noise_floor);
+    if (!full.complete || full.end != (32 + 4) * kWindow || full.power_count != 12) {
+        std::fprintf(stderr, "find_end: complete=%d end=%zu count=%zu\n", full.complete ? 1 : 0,
+                     full.end, full.power_count);
+        ++failures;
+    }
+    return failures;
+}
+
+// The original detect_burst_ex(): powers and a full sort on every call.
+std::optional<host_sim::BurstDetectResult> rescan(const std::vector<std::complex<float>>& samples,
+                                                  std::size_t search_from, float prior_noise, int min_consec)
+{
+    const std::size_t n_windows = samples.size() / kWindow;
+    const std::size_t start_window = search_from / kWindow;
+    if (n_windows < 3 || start_window >= n_windows) {
+        return std::nullopt;
+    }
+    std::vector<float> powers(n_windows);
+    for (std::size_t w = 0; w < n_windows; ++w) {
+        double acc = 0.0;
+        for (std::size_t i = 0; i < kWindow; ++i) {
+            const auto& v = samples[w * kWindow + i];
+            acc += static_cast<double>(v.real()) * v.real() + static_cast<double>(v.imag()) * v.imag();
+        }
+        powers[w] = static_cast<float>(acc / static_cast<double>(kWindow));
+    }
+    std::vector<float> sorted(powers);
+    std::sort(sorted.begin(), sorted.end());
+    const std::size_t q = std::max<std::size_t>(1, n_windows / 4);
+    double acc = 0.0;
+    for (std::size_t i = 0; i < q; ++i) {
+        acc += sorted[i];
+    }
+    const float fresh = static_cast<float>(acc / static_cast<double>(q));
+    const float noise = prior_noise > 0.0f ? 0.7f * prior_noise + 0.3f * fresh : fresh;
+    int consec = 0;
+    std::size_t first = 0;
+    for (std::size_t w = start_window; w < n_windows; ++w) {
+        if (powers[w] > noise * 6.0f) {
+            if (consec++ == 0) first = w;
+            if (consec >= min_consec) {
+                const std::size_t margin = std::min<std::size_t>(2, first - start_window);
+                return host_sim::BurstDetectResult{(first - margin) * kWindow, noise, powers[first]};
+            }
+        } else {
+            consec = 0;
+        }
+    }
+    return std::nullopt;
+}
+
+int test_index_matches_rescan()
+{
+    int failures = 0;
+    const auto stream = make_stream(300, 50, 14, 5);
+    for (int min_consec : {1, 2}) {
+        const host_sim::BurstIndex index(stream.data(), stream.size(), kWindow, 6.0f, min_consec);
+        for (float prior : {0.0f, 2e-4f}) {
+            for (std::size_t from = 0; from <= stream.size() + kWindow; from += 37 * kWindow / 8) {
+                const auto expected = rescan(stream, from, prior, min_consec);
+                const auto got = index.find_start(from, prior);
+                const bool same = expected.has_value() == got.has_value() &&
+                                  (!got || (got->burst_start == expected->burst_start &&
+                                            got->noise_floor == expected->noise_floor &&
+                                            got->signal_power == expected->signal_power));
+                if (!same) {
+                    std::fprintf(stderr, "BurstIndex from %zu (consec %d, prior %g): %zu, rescan %zu\n", from,
+                                 min_consec, prior, got ? got->burst_start : 0,
+                                 expected ? expected->burst_start : 0);
+                    ++failures;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+int test_index_bursts()
+{
+    int failures = 0;
+    // Bursts occupy windows [25, 39) of each 50-window period.
+    const auto stream = make_stream(300, 50, 14, 9);
+    const host_sim::BurstIndex index(stream.data(), stream.size(), kWindow);
+    const auto bursts = index.bursts();
+    if (bursts.size() != 6) {
+        std::fprintf(stderr, "BurstIndex found %zu bursts, expected 6\n", bursts.size());
+        return 1;
+    }
+    for (std::size_t i = 0; i < bursts.size(); ++i) {
+        const std::size_t first = (50 * i + 25) * kWindow;
+        const std::size_t end = (50 * i + 39 + 4) * kWindow;
+        if (bursts[i].start != first - 2 * kWindow || bursts[i].end != end || !bursts[i].complete) {
+            std::fprintf(stderr, "burst %zu: [%zu, %zu) complete=%d\n", i, bursts[i].start, bursts[i].end,
+                         bursts[i].complete ? 1 : 0);
+            ++failures;
+        }
+    }
+    // A burst running into the end of the capture is reported incomplete.
+    const host_sim::BurstIndex cut(stream.data(), 80 * kWindow, kWindow);
+    const auto partial = cut.bursts();
+    if (partial.size() != 2 || partial[1].complete || partial[1].end != 80 * kWindow) {
+        std::fprintf(stderr, "truncated capture: %zu bursts\n", partial.size());
+        ++failures;
+    }
+    if (!host_sim::BurstIndex(nullptr, 0, kWindow).bursts().empty()) {
+        std::fprintf(stderr, "empty capture produced bursts\n");
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_matches_rescan();
+    failures += test_unaligned_consume();
+    failures += test_find_end();
+    failures += test_index_matches_rescan();
+    failures += test_index_bursts();
+
+    std::printf("Burst detector test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+/// test_burst_index_file.cpp — Verify that the burst index sidecar round-
+/// trips every field (including negative bins and exact float bits),
+/// writes the documented layout, and rejects truncated, foreign or
+/// out-of-range files.
+
+#include "host_sim/lora_replay/burst_index_file.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+using host_sim::lora_replay::BurstIndexEntry;
+using host_sim::lora_replay::BurstIndexFile;
+
+template <typename Fn>
+bool throws(Fn&& fn)
+{
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+BurstIndexFile sample_index()
+{
+    BurstIndexFile index;
+    index.capture_samples = 5'000'000'000ULL;   // beyond 32 bits
+    index.bursts.push_back({1024, 30000, 1100, 0, 0, 0.125f, 0.0f, 7, true});
+    index.bursts.push_back({4'294'967'300ULL, 80000, 4'294'967'290ULL, 1021, -3, -0.4375f, 1.5e-5f, 12, false});
+    return index;
+}
+
+int test_round_trip()
+{
+    int failures = 0;
+    const auto index = sample_index();
+    const auto bytes = host_sim::lora_replay::encode_burst_index(index);
+    if (bytes.size() != host_sim::lora_replay::kBurstIndexHeaderBytes +
+                            index.bursts.size() * host_sim::lora_replay::kBurstIndexRecordBytes ||
+        bytes.compare(0, 4, "LBIX") != 0) {
+        std::fprintf(stderr, "unexpected layout (%zu bytes)\n", bytes.size());
+        ++failures;
+    }
+    const auto decoded = host_sim::lora_replay::decode_burst_index(bytes);
+    if (decoded.capture_samples != index.capture_samples || decoded.bursts != index.bursts) {
+        std::fprintf(stderr, "round trip differs\n");
+        ++failures;
+    }
+
+    const auto path = std::filesystem::temp_directory_path() / "host_sim_burst_index_test.lbix";
+    host_sim::lora_replay::write_burst_index(path, index);
+    if (host_sim::lora_replay::read_burst_index(path).bursts != index.bursts) {
+        std::fprintf(stderr, "file round trip differs\n");
+        ++failures;
+    }
+    std::filesystem::remove(path);
+
+    BurstIndexFile empty;
+    empty.capture_samples = 10;
+    if (!host_sim::lora_replay::decode_burst_index(host_sim::lora_replay::encode_burst_index(empty)).bursts.empty()) {
+        std::fprintf(stderr, "empty index did not round-trip\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_rejects_malformed()
+{
+    int failures = 0;
+    const auto bytes = host_sim::lora_replay::encode_burst_index(sample_index());
+    auto foreign = bytes;
+    foreign[0] = 'X';
+    auto version = bytes;
+    version[4] = 2;
+    BurstIndexFile outside = sample_index();
+    outside.bursts[1].length = 1'000'000'000ULL;
+    const auto outside_bytes = host_sim::lora_replay::encode_burst_index(outside);
+
+    const std::pair<const char*, std::string> cases[] = {
+        {"truncated", bytes.substr(0, bytes.size() - 1)},
+        {"extended", bytes + '\0'},
+        {"short header", bytes.substr(0, 10)},
+        {"foreign magic", foreign},
+        {"future version", version},
+        {"burst past the capture", outside_bytes},
+    };
+    for (const auto& [name, data] : cases) {
+        if (!throws([&] { host_sim::lora_replay::decode_burst_index(data); })) {
+            std::fprintf(stderr, "%s: accepted\n", name);
+            ++failures;
+        }
+    }
+    if (!throws([] { host_sim::lora_replay::read_burst_index("/nonexistent/host_sim.lbix"); })) {
+        std::fprintf(stderr, "missing file: accepted\n");
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_round_trip();
+    failures += test_rejects_malformed();
+    std::printf("Burst index file test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/// test_candidate_search.cpp — Verify that find_first_candidate() returns
+/// the lowest-index hit regardless of thread timing, evaluates every
+/// candidate below the winner exactly once, stops superseded probes, and
+/// propagates probe exceptions.
+
+#include "host_sim/candidate_search.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+int run_trial(std::size_t count, const std::vector<bool>& hits, unsigned seed)
+{
+    std::vector<std::atomic<int>> evaluated(count);
+    std::vector<int> sleep_us(count);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> jitter(0, 300);
+    for (auto& s : sleep_us) s = jitter(rng);
+
+    std::atomic<bool> bad_worker{false};
+    const auto winner = host_sim::find_first_candidate(
+        count, [&](const host_sim::CandidateContext& ctx) {
+            if (ctx.worker() >= host_sim::candidate_search_workers()) {
+                bad_worker = true;
+            }
+            evaluated[ctx.index()].fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::microseconds(sleep_us[ctx.index()]));
+            return static_cast<bool>(hits[ctx.index()]);
+        });
+
+    std::size_t expected = count;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (hits[i]) {
+            expected = i;
+            break;
+        }
+    }
+
+    int failures = 0;
+    if (expected == count ? winner.has_value() : (!winner || *winner != expected)) {
+        std::fprintf(stderr, "seed %u: winner %zd, expected %zd\n", seed,
+                     winner ? static_cast<std::ptrdiff_t>(*winner) : -1,
+                     expected == count ? -1 : static_cast<std::ptrdiff_t>(expected));
+        ++failures;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        const int n = evaluated[i].load();
+        if (n > 1 || (i <= expected && i < count && n != 1)) {
+            std::fprintf(stderr, "seed %u: candidate %zu evaluated %d times\n", seed, i, n);
+            ++failures;
+        }
+    }
+    if (bad_worker) {
+        std::fprintf(stderr, "seed %u: worker index out of range\n", seed);
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    // Several hits at random positions; the lowest must always win.
+    std::mt19937 rng(99);
+    for (unsigned trial = 0; trial < 40; ++trial) {
+        const std::size_t count = 1 + rng() % 48;
+        std::vector<bool> hits(count, false);
+        const std::size_t n_hits = rng() % 4;
+        for (std::size_t h = 0; h < n_hits; ++h) {
+            hits[rng() % count] = true;
+        }
+        failures += run_trial(count, hits, trial);
+    }
+
+    // Empty search.
+    if (host_sim::find_first_candidate(0, [](const host_sim::CandidateContext&) { return true; })) {
+        std::fprintf(stderr, "empty search returned a winner\n");
+        ++failures;
+    }
+
+    // A slow probe above an early hit either never starts or sees itself
+    // superseded and gives up; the lowest hit is never reported superseded.
+    std::atomic<bool> winner_superseded{false};
+    const auto early = host_sim::find_first_candidate(2, [&](const host_sim::CandidateContext& ctx) {
+        if (ctx.index() == 0) {
+            winner_superseded = ctx.superseded();
+            return true;
+        }
+        for (int i = 0; i < 2000 && !ctx.superseded(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    });
+    if (!early || *early != 0 || winner_superseded) {
+        std::fprintf(stderr, "supersession check failed\n");
+        ++failures;
+    }
+
+    // Exceptions from a probe reach the caller.
+    bool threw = false;
+    try {
+        host_sim::find_first_candidate(16, [](const host_sim::CandidateContext& ctx) -> bool {
+            if (ctx.index() == 5) {
+                throw std::runtime_error("probe failure");
+            }
+            return false;
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        std::fprintf(stderr, "probe exception was swallowed\n");
+        ++failures;
+    }
+
+    std::printf("Candidate search test (%zu workers): %d failures\n",
+                host_sim::candidate_search_workers(), failures);
+    return failures == 0 ? 0 : 1;
+}
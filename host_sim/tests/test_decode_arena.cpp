@@ -0,0 +1,132 @@
+/// test_decode_arena.cpp — Verify host_sim::DecodeArena: allocations come
+/// from its block until it is full, a reset after a spill grows the block
+/// so the same packet fits without the heap; and that decode_stream_burst()
+/// on a warmed arena decodes exactly as on the heap while allocating only
+/// the payload it returns.
+
+#include "alloc_counter.hpp"
+
+#include "host_sim/decode_arena.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/tx/batch.hpp"
+
+#include <cstdio>
+#include <memory_resource>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+int test_block_and_growth()
+{
+    int failures = 0;
+    host_sim::DecodeArena arena(4096);
+    {
+        std::pmr::vector<float> small(256, 0.0f, arena.resource());
+        if (arena.spilled() != 0) {
+            std::fprintf(stderr, "1 KiB spilled out of a 4 KiB block\n");
+            ++failures;
+        }
+        std::pmr::vector<float> large(4096, 0.0f, arena.resource());
+        if (arena.spilled() == 0) {
+            std::fprintf(stderr, "16 KiB fitted a 4 KiB block\n");
+            ++failures;
+        }
+    }
+    arena.reset();
+    if (arena.spilled() != 0 || arena.capacity() < 4096 + 4096 * sizeof(float)) {
+        std::fprintf(stderr, "after reset: capacity %zu, spilled %zu\n", arena.capacity(), arena.spilled());
+        ++failures;
+    }
+
+    // The same packet again: served from the grown block, no heap calls.
+    const std::size_t before = alloc_counter::count();
+    for (int packet = 0; packet < 3; ++packet) {
+        std::pmr::vector<float> small(256, 0.0f, arena.resource());
+        std::pmr::vector<float> large(4096, 0.0f, arena.resource());
+        arena.reset();
+    }
+    const std::size_t allocations = alloc_counter::count() - before;
+    if (allocations != 0) {
+        std::fprintf(stderr, "steady state made %zu allocations\n", allocations);
+        ++failures;
+    }
+    return failures;
+}
+
+struct Packet
+{
+    int sf;
+    int os;
+    bool soft;
+};
+
+int test_decode_on_arena(const Packet& p)
+{
+    int failures = 0;
+    host_sim::tx::BatchOptions tx;
+    tx.packet.sf = p.sf;
+    tx.packet.cr = 2;
+    tx.packet.sample_rate = 125000 * p.os;
+    tx.channel.snr_db = -5.0f;
+    tx.payload_len = 16;
+    tx.seed = 45;
+    std::vector<std::complex<float>> iq;
+    host_sim::tx::BatchGenerator(tx).run([&](const host_sim::tx::BatchPacket& packet) { iq = packet.iq; });
+
+    host_sim::LoRaMetadata meta;
+    meta.sf = p.sf;
+    meta.bw = 125000;
+    meta.sample_rate = tx.packet.sample_rate;
+    meta.cr = 2;
+    meta.payload_len = 16;
+    host_sim::lora_replay::Options options;
+    options.soft = p.soft;
+    host_sim::FftDemodulator demod(p.sf, meta.sample_rate, meta.bw);
+
+    auto decode = [&](std::pmr::memory_resource* memory) {
+        std::ostringstream report;
+        report.setstate(std::ios::badbit);
+        return host_sim::lora_replay::decode_stream_burst(iq, demod, meta, options, report, memory);
+    };
+    const auto reference = decode(std::pmr::get_default_resource());
+
+    host_sim::DecodeArena arena;
+    for (int packet = 0; packet < 3; ++packet) {
+        arena.reset();
+        const std::size_t before = alloc_counter::count();
+        const auto result = decode(arena.resource());
+        const std::size_t allocations = alloc_counter::count() - before;
+        if (result.crc_ok != reference.crc_ok || result.path != reference.path ||
+            result.payload != reference.payload) {
+            std::fprintf(stderr, "SF%d OS%d: arena decode differs from the heap decode\n", p.sf, p.os);
+            ++failures;
+        }
+        // The first packet sizes the block; afterwards only the returned
+        // payload reaches the heap.
+        if (packet > 0 && allocations > 1) {
+            std::fprintf(stderr, "SF%d OS%d%s: packet %d made %zu allocations\n", p.sf, p.os,
+                         p.soft ? " soft" : "", packet, allocations);
+            ++failures;
+        }
+    }
+    if (!reference.crc_ok) {
+        std::fprintf(stderr, "SF%d OS%d: reference decode failed\n", p.sf, p.os);
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_block_and_growth();
+    for (const Packet& p : {Packet{7, 1, false}, Packet{8, 2, true}, Packet{8, 4, false}, Packet{9, 8, true}}) {
+        failures += test_decode_on_arena(p);
+    }
+    std::printf("Decode arena test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/// test_decode_phase.cpp — Verify per-phase wall-time attribution: nested
+/// scopes charge their time exclusively and hand back to the outer phase,
+/// time outside any scope lands in `other`, scopes without a recording are
+/// inert, recordings refuse to nest, and other threads are not recorded.
+
+#include "host_sim/decode_phase.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+
+using host_sim::DecodePhase;
+
+void spin_ms(double ms)
+{
+    const auto until = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(ms);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+double ms(const host_sim::PhaseTimes& times, DecodePhase phase)
+{
+    return times[phase] / 1e6;
+}
+
+int test_nested_scopes()
+{
+    int failures = 0;
+    host_sim::PhaseTimes times;
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+        const host_sim::PhaseRecording recording(times);
+        spin_ms(2.0);
+        const host_sim::PhaseScope outer(DecodePhase::header);
+        spin_ms(2.0);
+        {
+            const host_sim::PhaseScope inner(DecodePhase::demod);
+            spin_ms(4.0);
+        }
+        spin_ms(2.0);
+    }
+    // Spinning only ever overshoots, and a preempted thread overshoots
+    // a lot, so bound the phases by the wall time actually spent.
+    const double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (ms(times, DecodePhase::header) < 4.0 || ms(times, DecodePhase::demod) < 4.0 ||
+        ms(times, DecodePhase::other) < 2.0 || ms(times, DecodePhase::payload) != 0.0) {
+        std::fprintf(stderr, "nested: header %.2f ms, demod %.2f ms, other %.2f ms\n",
+                     ms(times, DecodePhase::header), ms(times, DecodePhase::demod), ms(times, DecodePhase::other));
+        ++failures;
+    }
+    if (times.total() < 10.0e6 || times.total() / 1e6 > wall_ms) {
+        std::fprintf(stderr, "nested: total %.2f ms against 10 ms spun in %.2f ms\n", times.total() / 1e6, wall_ms);
+        ++failures;
+    }
+    return failures;
+}
+
+int test_inactive_and_other_threads()
+{
+    int failures = 0;
+    {
+        // No recording: nothing to charge, nothing to break.
+        const host_sim::PhaseScope idle(DecodePhase::payload);
+    }
+    host_sim::PhaseTimes times;
+    {
+        const host_sim::PhaseRecording recording(times);
+        std::thread worker([] {
+            const host_sim::PhaseScope scope(DecodePhase::alignment);
+            spin_ms(2.0);
+        });
+        worker.join();
+        bool threw = false;
+        try {
+            host_sim::PhaseTimes second;
+            const host_sim::PhaseRecording nested(second);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw) {
+            std::fprintf(stderr, "a second recording on the same thread was accepted\n");
+            ++failures;
+        }
+    }
+    if (times[DecodePhase::alignment] != 0.0 || times[DecodePhase::other] <= 0.0) {
+        std::fprintf(stderr, "worker thread charged %.2f ms to the recording\n", ms(times, DecodePhase::alignment));
+        ++failures;
+    }
+    host_sim::PhaseTimes sum = times;
+    sum += times;
+    if (sum.total() != 2.0 * times.total() || std::string_view(host_sim::phase_name(DecodePhase::cfo_sfo)) != "cfo_sfo") {
+        std::fprintf(stderr, "PhaseTimes accumulation or phase names are off\n");
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_nested_scopes();
+    failures += test_inactive_and_other_threads();
+    std::printf("Decode phase test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/// test_derotator.cpp — Verify that the cached CFO/SFO rotation ramp stays
+/// within Derotator::kTolerance of the exact per-tap rotation, and that the
+/// float and Q15 demodulators still agree on offset-corrected chirps.
+
+#include "host_sim/chirp.hpp"
+#include "host_sim/derotator.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/fft_demod_q15.hpp"
+#include "host_sim/q15.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+
+int check_ramp(int sf, int os, int base, double w)
+{
+    const int n_bins = 1 << sf;
+    host_sim::Derotator derotator;
+    derotator.configure(n_bins, os, base);
+    const auto& table = derotator.ramp(w);
+
+    double worst = 0.0;
+    for (int bin = 0; bin < n_bins; ++bin) {
+        const double sample_idx = static_cast<double>(bin) * os + base;
+        const std::complex<double> exact = std::polar(1.0, w * sample_idx);
+        const double err_re = std::abs(exact.real() - table[bin].real());
+        const double err_im = std::abs(exact.imag() - table[bin].imag());
+        worst = std::max(worst, std::max(err_re, err_im));
+    }
+    if (worst > host_sim::Derotator::kTolerance) {
+        std::fprintf(stderr, "RAMP SF%d OS%d w=%g: max error %g\n",
+                     sf, os, w, worst);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    // Ramp accuracy across SF/OS and a spread of CFO/SFO combinations.
+    const float cfo_fracs[] = {-0.49f, -0.2f, 0.13f, 0.37f};
+    const float sfo_slopes[] = {0.0f, 0.004f, -0.03f};
+    for (int sf = 7; sf <= 12; ++sf) {
+        for (int os : {1, 2, 4, 16}) {
+            const int base = (os <= 4) ? std::max(0, os / 2 - ((os > 1 && os % 2 == 0) ? 1 : 0)) : 0;
+            const int sps = (1 << sf) * os;
+            for (float cfo : cfo_fracs) {
+                for (float slope : sfo_slopes) {
+                    const double w = host_sim::Derotator::phase_step(cfo, slope, 200, sps);
+                    failures += check_ramp(sf, os, base, w);
+                }
+            }
+        }
+    }
+
+    // Float vs Q15 demodulation with a fractional CFO applied and removed.
+    int total = 0;
+    int mismatches = 0;
+    for (int sf = 7; sf <= 10; ++sf) {
+        const int n_bins = 1 << sf;
+        const int bw = 125000;
+        const float cfo_frac = 0.3f;
+
+        host_sim::FftDemodulator float_demod(sf, bw, bw);
+        host_sim::FftDemodulatorQ15 q15_demod(sf, bw, bw);
+        float_demod.set_frequency_offsets(cfo_frac, 0, 0.0f);
+        q15_demod.set_frequency_offsets(cfo_frac, 0, 0.0f);
+
+        const auto chirps = host_sim::build_chirps(sf, 1);
+        const int step = (n_bins > 64) ? (n_bins / 16) : 1;
+        for (int sym = 0; sym < n_bins; sym += step) {
+            std::vector<std::complex<float>> samples_f(n_bins);
+            std::vector<host_sim::Q15Complex> samples_q(n_bins);
+            for (int i = 0; i < n_bins; ++i) {
+                const double phase = 2.0 * M_PI * cfo_frac * i / n_bins;
+                const auto value = chirps.upchirp[(i + sym) % n_bins] *
+                                   std::complex<float>(static_cast<float>(std::cos(phase)),
+                                                       static_cast<float>(std::sin(phase)));
+                samples_f[i] = value * 0.5f;
+                samples_q[i] = host_sim::float_to_q15_complex(samples_f[i].real(),
+                                                              samples_f[i].imag());
+            }
+
+            float_demod.reset_symbol_counter();
+            q15_demod.reset_symbol_counter();
+            const uint16_t ref = float_demod.demodulate(samples_f.data());
+            const uint16_t q15 = q15_demod.demodulate(samples_q.data());
+
+            ++total;
+            if (ref != static_cast<uint16_t>(sym) || q15 != ref) {
+                std::fprintf(stderr, "MISMATCH SF%d sym=%d: float=%u q15=%u\n",
+                             sf, sym, ref, q15);
+                ++mismatches;
+            }
+        }
+    }
+
+    std::printf("Derotator test: %d ramp failures, %d/%d demod match\n",
+                failures, total - mismatches, total);
+    return (failures == 0 && mismatches == 0) ? 0 : 1;
+}
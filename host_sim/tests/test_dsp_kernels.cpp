@@ -0,0 +1,181 @@
+/// test_dsp_kernels.cpp — Verify that every SIMD kernel variant supported
+/// by this CPU is bit-identical to the scalar reference (dechirp, decimated
+/// dechirp, polyphase fold, fused |X|² + two-best argmax, Q15 argmax,
+/// int8/int16 IQ conversion, row dot products), including tail lengths and
+/// tied peaks.
+
+#include "host_sim/dsp_kernels.hpp"
+
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using host_sim::kernels::Isa;
+using cf = std::complex<float>;
+
+bool same_bits(const cf* a, const cf* b, int n)
+{
+    return std::memcmp(a, b, sizeof(cf) * static_cast<std::size_t>(n)) == 0;
+}
+
+bool same_peaks(const host_sim::kernels::PeakPair& a, const host_sim::kernels::PeakPair& b)
+{
+    return a.best_bin == b.best_bin && a.second_bin == b.second_bin &&
+           std::memcmp(&a.best_mag, &b.best_mag, sizeof(float)) == 0 &&
+           std::memcmp(&a.second_mag, &b.second_mag, sizeof(float)) == 0;
+}
+
+bool same_peaks(const host_sim::kernels::PeakPairQ15& a,
+                const host_sim::kernels::PeakPairQ15& b)
+{
+    return a.best_bin == b.best_bin && a.second_bin == b.second_bin &&
+           a.best_mag == b.best_mag && a.second_mag == b.second_mag;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+    std::uniform_int_distribution<int> q15(-32768, 32767);
+
+    const int lengths[] = {1, 3, 17, 64, 131, 4096};
+    const int oversample[] = {1, 2, 3, 8};
+    int failures = 0;
+    int checked = 0;
+
+    for (Isa isa : {Isa::avx2, Isa::avx512, Isa::neon}) {
+        if (!host_sim::kernels::isa_supported(isa)) {
+            continue;
+        }
+        for (int n : lengths) {
+            for (int os : oversample) {
+                const std::size_t total = static_cast<std::size_t>(n) * os;
+                std::vector<cf> samples(total);
+                std::vector<cf> chirp(total);
+                std::vector<cf> rotation(n);
+                for (auto& v : samples) v = {gauss(rng), gauss(rng)};
+                for (auto& v : chirp) v = {gauss(rng), gauss(rng)};
+                for (auto& v : rotation) v = {gauss(rng), gauss(rng)};
+
+                // Plant exact ties so the tie-breaking rules are exercised.
+                std::vector<cf> spectrum(samples.begin(), samples.begin() + n);
+                if (n >= 17) {
+                    spectrum[n - 1] = spectrum[3] = {9.0f, 9.0f};
+                    spectrum[n / 2] = spectrum[5] = {-7.0f, 7.0f};
+                }
+                std::vector<int16_t> spectrum_q(2 * static_cast<std::size_t>(n));
+                for (auto& v : spectrum_q) v = static_cast<int16_t>(q15(rng));
+                if (n >= 17) {
+                    spectrum_q[2] = spectrum_q[2 * (n - 2)] = -32768;
+                    spectrum_q[3] = spectrum_q[2 * (n - 2) + 1] = -32768;
+                }
+
+                std::vector<cf> ref(n), got(n);
+                std::vector<float> ref_mag(n), got_mag(n);
+                const int fold_stride = (os > 2) ? 2 : 1;
+
+                host_sim::kernels::set_isa(Isa::scalar);
+                host_sim::kernels::dechirp(samples.data(), rotation.data(), chirp.data(), n, os, ref.data());
+                std::vector<cf> ref_plain(n);
+                host_sim::kernels::dechirp(samples.data(), nullptr, chirp.data(), n, os, ref_plain.data());
+                std::vector<cf> ref_fold(n);
+                host_sim::kernels::dechirp_fold(samples.data(), chirp.data(), n, os, fold_stride, ref_fold.data());
+                // The decimated form must match dechirp() on the full-rate chirp.
+                std::vector<cf> taps(n);
+                for (int k = 0; k < n; ++k) taps[k] = chirp[static_cast<std::size_t>(k) * os];
+                host_sim::kernels::dechirp_decimated(samples.data(), rotation.data(), taps.data(), n, os, got.data());
+                if (!same_bits(ref.data(), got.data(), n)) {
+                    std::fprintf(stderr, "MISMATCH scalar decimated dechirp n=%d os=%d\n", n, os);
+                    ++failures;
+                }
+                const auto ref_peaks = host_sim::kernels::find_two_peaks(spectrum.data(), n, ref_mag.data());
+                const auto ref_q15 = host_sim::kernels::find_two_peaks_q15(spectrum_q.data(), n);
+                // The fold output against `os` rows of the chirp.
+                std::vector<cf> ref_dots(os), got_dots(os);
+                host_sim::kernels::dot_rows(ref_fold.data(), chirp.data(), n, os, ref_dots.data());
+
+                host_sim::kernels::set_isa(isa);
+                bool ok = true;
+                host_sim::kernels::dechirp(samples.data(), rotation.data(), chirp.data(), n, os, got.data());
+                ok &= same_bits(ref.data(), got.data(), n);
+                host_sim::kernels::dechirp(samples.data(), nullptr, chirp.data(), n, os, got.data());
+                ok &= same_bits(ref_plain.data(), got.data(), n);
+                host_sim::kernels::dechirp_decimated(samples.data(), rotation.data(), taps.data(), n, os, got.data());
+                ok &= same_bits(ref.data(), got.data(), n);
+                host_sim::kernels::dechirp_fold(samples.data(), chirp.data(), n, os, fold_stride, got.data());
+                ok &= same_bits(ref_fold.data(), got.data(), n);
+                const auto got_peaks = host_sim::kernels::find_two_peaks(spectrum.data(), n, got_mag.data());
+                ok &= same_peaks(ref_peaks, got_peaks);
+                ok &= std::memcmp(ref_mag.data(), got_mag.data(), sizeof(float) * n) == 0;
+                ok &= same_peaks(ref_q15, host_sim::kernels::find_two_peaks_q15(spectrum_q.data(), n));
+                host_sim::kernels::dot_rows(ref_fold.data(), chirp.data(), n, os, got_dots.data());
+                ok &= same_bits(ref_dots.data(), got_dots.data(), os);
+
+                ++checked;
+                if (!ok) {
+                    std::fprintf(stderr, "MISMATCH isa=%s n=%d os=%d\n",
+                                 host_sim::kernels::isa_name(isa), n, os);
+                    ++failures;
+                }
+            }
+        }
+
+        // Integer IQ conversion over the full input range.
+        for (int n : lengths) {
+            const std::size_t count = static_cast<std::size_t>(n) + 5;  // odd tails too
+            std::vector<int8_t> iq8(2 * count);
+            std::vector<int16_t> iq16(2 * count);
+            for (std::size_t i = 0; i < iq8.size(); ++i) {
+                iq8[i] = static_cast<int8_t>(q15(rng) >> 8);
+                iq16[i] = static_cast<int16_t>(q15(rng));
+            }
+            iq8[0] = -128;
+            iq8[1] = 127;
+            iq16[0] = -32768;
+            iq16[1] = 32767;
+
+            std::vector<cf> ref8(count), ref16(count), got8(count), got16(count);
+            std::vector<int16_t> ref_q(2 * count), got_q(2 * count);
+            host_sim::kernels::set_isa(Isa::scalar);
+            host_sim::kernels::int8_to_cf32(iq8.data(), count, ref8.data());
+            host_sim::kernels::int16_to_cf32(iq16.data(), count, ref16.data());
+            host_sim::kernels::int8_to_q15(iq8.data(), count, ref_q.data());
+
+            bool ok = true;
+            for (std::size_t k = 0; k < count; ++k) {
+                ok &= ref8[k] == cf(static_cast<float>(iq8[2 * k]) / 128.0f,
+                                    static_cast<float>(iq8[2 * k + 1]) / 128.0f);
+                ok &= ref16[k] == cf(static_cast<float>(iq16[2 * k]) / 32768.0f,
+                                     static_cast<float>(iq16[2 * k + 1]) / 32768.0f);
+                ok &= ref_q[2 * k] == static_cast<int16_t>(iq8[2 * k] * 256);
+            }
+
+            host_sim::kernels::set_isa(isa);
+            host_sim::kernels::int8_to_cf32(iq8.data(), count, got8.data());
+            host_sim::kernels::int16_to_cf32(iq16.data(), count, got16.data());
+            host_sim::kernels::int8_to_q15(iq8.data(), count, got_q.data());
+            ok &= same_bits(ref8.data(), got8.data(), static_cast<int>(count));
+            ok &= same_bits(ref16.data(), got16.data(), static_cast<int>(count));
+            ok &= ref_q == got_q;
+
+            ++checked;
+            if (!ok) {
+                std::fprintf(stderr, "MISMATCH isa=%s int conversion n=%zu\n",
+                             host_sim::kernels::isa_name(isa), count);
+                ++failures;
+            }
+        }
+    }
+
+    std::printf("DSP kernel test: %d/%d cases bit-identical to scalar\n",
+                checked - failures, checked);
+    return failures == 0 ? 0 : 1;
+}
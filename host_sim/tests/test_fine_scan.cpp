@@ -0,0 +1,93 @@
+/// test_fine_scan.cpp — Verify that the zoom fine scan of
+/// find_symbol_alignment_cfo_aware() lands on the same alignment and
+/// preamble bin as the full-FFT scan across oversampling factors, start
+/// offsets and carrier offsets (including bins that wrap around N), and
+/// that it keeps no preamble spectra.
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/chirp.hpp"
+#include "host_sim/fft_demod.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using cf = std::complex<float>;
+
+constexpr int kBw = 125000;
+constexpr int kPreamble = 8;
+
+/// Noise, an 8-symbol preamble at `start` shifted by `cfo_bins`, then
+/// random data chirps.
+std::vector<cf> make_burst(int sf, int os, std::size_t start, double cfo_bins, unsigned seed)
+{
+    const auto chirps = host_sim::build_chirps(sf, os);
+    const std::size_t sps = chirps.upchirp.size();
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> g(0.0f, 0.3f);
+    std::uniform_int_distribution<int> value(0, (1 << sf) - 1);
+    std::vector<cf> out(start + (kPreamble + 6) * sps);
+    for (auto& s : out) {
+        s = {g(rng), g(rng)};
+    }
+    const double step = 2.0 * M_PI * cfo_bins / static_cast<double>(sps);
+    for (std::size_t sym = 0; sym < kPreamble + 4; ++sym) {
+        const std::size_t shift = sym < kPreamble ? 0 : static_cast<std::size_t>(value(rng)) * os;
+        for (std::size_t i = 0; i < sps; ++i) {
+            const std::size_t at = sym * sps + i;
+            const double phase = step * static_cast<double>(at);
+            out[start + at] += chirps.upchirp[(i + shift) % sps] *
+                               cf(static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase)));
+        }
+    }
+    return out;
+}
+
+int test_zoom_matches_fft()
+{
+    int failures = 0;
+    const int sf = 9;
+    for (int os : {1, 4, 8}) {
+        host_sim::FftDemodulator demod(sf, kBw * os, kBw);
+        const std::size_t sps = static_cast<std::size_t>(demod.samples_per_symbol());
+        unsigned seed = 44;
+        for (std::size_t start : {std::size_t{0}, sps / 3, sps - 5}) {
+            for (double cfo : {0.0, 7.4, -130.6, 255.2}) {
+                const auto burst = make_burst(sf, os, start, cfo, seed++);
+                const auto fft = host_sim::find_symbol_alignment_cfo_aware(
+                    burst, demod, kPreamble, nullptr, host_sim::FineScanMode::fft);
+                host_sim::PreambleSpectra spectra;
+                spectra.symbols = -1;
+                const auto zoom = host_sim::find_symbol_alignment_cfo_aware(
+                    burst, demod, kPreamble, &spectra, host_sim::FineScanMode::zoom);
+                if (zoom.alignment_offset != fft.alignment_offset || zoom.preamble_bin != fft.preamble_bin ||
+                    zoom.score != fft.score) {
+                    std::fprintf(stderr, "OS%d start %zu CFO %.1f: zoom %zu/bin %d, fft %zu/bin %d\n", os, start,
+                                 cfo, zoom.alignment_offset, zoom.preamble_bin, fft.alignment_offset,
+                                 fft.preamble_bin);
+                    ++failures;
+                }
+                if (spectra.symbols != 0) {
+                    std::fprintf(stderr, "OS%d: zoom scan kept %d spectra\n", os, spectra.symbols);
+                    ++failures;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_zoom_matches_fft();
+    std::printf("Fine scan test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
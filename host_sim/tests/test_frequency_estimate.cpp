@@ -0,0 +1,142 @@
+/// test_frequency_estimate.cpp — Verify that estimate_frequency_offsets()
+/// gives the same result from preamble spectra kept by the CFO-aware
+/// alignment as from the samples, that it recovers an injected CFO, that
+/// repeated calls do not allocate, and that short or mismatched spectra
+/// are refused.
+
+#include "alloc_counter.hpp"
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/chirp.hpp"
+#include "host_sim/fft_demod.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+using cf = std::complex<float>;
+
+constexpr int kSf = 7;
+constexpr int kOs = 8;
+constexpr int kBw = 125000;
+constexpr int kPreamble = 8;
+constexpr std::size_t kBurstOffset = 300;
+constexpr double kCfoBins = 3.3;
+
+/// Noise, then an 8-symbol preamble at kBurstOffset shifted by kCfoBins.
+std::vector<cf> make_burst()
+{
+    const auto chirps = host_sim::build_chirps(kSf, kOs);
+    const std::size_t sps = chirps.upchirp.size();
+    std::mt19937 rng(43);
+    std::normal_distribution<float> g(0.0f, 0.05f);
+    std::vector<cf> out((kPreamble + 6) * sps);
+    for (auto& s : out) {
+        s = {g(rng), g(rng)};
+    }
+    const double step = 2.0 * M_PI * kCfoBins / static_cast<double>(sps);
+    for (std::size_t i = 0; i < kPreamble * sps; ++i) {
+        const double phase = step * static_cast<double>(i);
+        out[kBurstOffset + i] += chirps.upchirp[i % sps] *
+                                 cf(static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase)));
+    }
+    return out;
+}
+
+bool same(const host_sim::FftDemodulator::FrequencyEstimate& a,
+          const host_sim::FftDemodulator::FrequencyEstimate& b)
+{
+    return a.cfo_frac == b.cfo_frac && a.cfo_int == b.cfo_int && a.sfo_slope == b.sfo_slope;
+}
+
+int test_cached_spectra()
+{
+    int failures = 0;
+    const auto burst = make_burst();
+    host_sim::FftDemodulator demod(kSf, kBw * kOs, kBw);
+    host_sim::PreambleSpectra spectra;
+    const auto pr = host_sim::find_symbol_alignment_cfo_aware(burst, demod, kPreamble, &spectra);
+
+    // SF7 at OS8 is small enough for a serial fine scan, which always
+    // keeps the winner's spectra.
+    if (spectra.symbols != kPreamble || spectra.offset != pr.alignment_offset ||
+        spectra.bins.size() != static_cast<std::size_t>(kPreamble) << kSf) {
+        std::fprintf(stderr, "kept %d symbols at %zu (alignment %zu)\n", spectra.symbols, spectra.offset,
+                     pr.alignment_offset);
+        return failures + 1;
+    }
+
+    const int count = kPreamble - 1;
+    const auto from_samples = demod.estimate_frequency_offsets(burst.data() + pr.alignment_offset, count);
+    const auto from_spectra = demod.estimate_frequency_offsets(spectra.first(pr.alignment_offset, count), count);
+    if (!same(from_samples, from_spectra)) {
+        std::fprintf(stderr, "spectra estimate %d%+f differs from samples %d%+f\n", from_spectra.cfo_int,
+                     from_spectra.cfo_frac, from_samples.cfo_int, from_samples.cfo_frac);
+        ++failures;
+    }
+
+    // Within half a chip of the true start.
+    const double got = static_cast<double>(from_samples.cfo_int) + from_samples.cfo_frac;
+    if (pr.alignment_offset + kOs / 2 < kBurstOffset || pr.alignment_offset > kBurstOffset + kOs / 2 ||
+        std::abs(got - kCfoBins) > 0.1) {
+        std::fprintf(stderr, "alignment %zu, CFO %.3f bins (expected %zu, %.3f)\n", pr.alignment_offset, got,
+                     kBurstOffset, kCfoBins);
+        ++failures;
+    }
+
+    if (!spectra.first(pr.alignment_offset + 1, count).empty() ||
+        !spectra.first(pr.alignment_offset, kPreamble + 1).empty()) {
+        std::fprintf(stderr, "spectra handed out for the wrong offset or too many symbols\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_no_allocations()
+{
+    int failures = 0;
+    const auto burst = make_burst();
+    host_sim::FftDemodulator demod(kSf, kBw * kOs, kBw);
+    demod.estimate_frequency_offsets(burst.data(), kPreamble - 1);   // sizes the workspace
+    const std::size_t before = alloc_counter::count();
+    for (int i = 0; i < 4; ++i) {
+        demod.estimate_frequency_offsets(burst.data() + i, kPreamble - 1 - i % 2);
+    }
+    const std::size_t allocations = alloc_counter::count() - before;
+    if (allocations != 0) {
+        std::fprintf(stderr, "repeated estimates made %zu allocations\n", allocations);
+        ++failures;
+    }
+    return failures;
+}
+
+int test_short_spectra()
+{
+    host_sim::FftDemodulator demod(kSf, kBw * kOs, kBw);
+    const std::vector<cf> spectra(std::size_t{3} << kSf);
+    try {
+        demod.estimate_frequency_offsets(spectra, 4);
+    } catch (const std::runtime_error&) {
+        return 0;
+    }
+    std::fprintf(stderr, "short spectra accepted\n");
+    return 1;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_cached_spectra();
+    failures += test_no_allocations();
+    failures += test_short_spectra();
+    std::printf("Frequency estimate test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/// test_gpu_demod.cpp — Run with HOST_SIM_FFT_BACKEND=cuda: a block well
+/// past kGpuMinBatch must give the symbols, residuals and final spectrum
+/// of per-symbol demodulate() calls, on the GPU when one is present and on
+/// the CPU fallback otherwise; without a device the backend must report
+/// itself unavailable and stay off.
+
+#include "host_sim/chirp.hpp"
+#include "host_sim/fft_backend.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/gpu_demod.hpp"
+#include "host_sim/polyphase_samples.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int kSf = 8;
+constexpr int kBw = 125000;
+constexpr int kOs = 4;
+constexpr std::size_t kSymbols = 1200;
+
+// kSymbols random symbols back to back, with a fractional-bin CFO and noise.
+std::vector<std::complex<float>> make_stream(std::vector<uint16_t>& symbols)
+{
+    const int n = 1 << kSf;
+    const std::size_t sps = static_cast<std::size_t>(n) * kOs;
+    const auto chirps = host_sim::build_chirps(kSf, kOs);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> value(0, n - 1);
+    std::normal_distribution<float> gauss(0.0f, 0.1f);
+    const double w = 2.0 * std::numbers::pi * 0.2 / static_cast<double>(sps);
+
+    std::vector<std::complex<float>> stream(kSymbols * sps);
+    symbols.resize(kSymbols);
+    for (std::size_t s = 0; s < kSymbols; ++s) {
+        symbols[s] = static_cast<uint16_t>(value(rng));
+        const std::size_t shift = static_cast<std::size_t>(symbols[s]) * kOs;
+        for (std::size_t i = 0; i < sps; ++i) {
+            const std::size_t t = s * sps + i;
+            const auto rot = std::polar(1.0, w * static_cast<double>(t));
+            stream[t] = chirps.upchirp[(i + shift) % sps] *
+                            std::complex<float>(static_cast<float>(rot.real()), static_cast<float>(rot.imag())) +
+                        std::complex<float>(gauss(rng), gauss(rng));
+        }
+    }
+    return stream;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    const bool gpu = host_sim::gpu_available();
+    const bool on_cuda = host_sim::active_fft_backend() == host_sim::FftBackend::cuda;
+
+    if (host_sim::fft_backend_available(host_sim::FftBackend::cuda) != gpu || on_cuda != gpu) {
+        std::fprintf(stderr, "cuda backend: available=%d active=%d but gpu_available()=%d\n",
+                     host_sim::fft_backend_available(host_sim::FftBackend::cuda), on_cuda, gpu);
+        ++failures;
+    }
+    if (!gpu && host_sim::shared_gpu_demodulator(kSf, kOs, 1) != nullptr) {
+        std::fprintf(stderr, "shared_gpu_demodulator() returned a device demodulator without a GPU\n");
+        ++failures;
+    }
+
+    std::vector<uint16_t> sent;
+    const auto stream = make_stream(sent);
+    const std::size_t sps = static_cast<std::size_t>(1 << kSf) * kOs;
+
+    host_sim::FftDemodulator reference(kSf, kBw * kOs, kBw);
+    reference.set_frequency_offsets(0.2f, 0, 0.0f);
+    std::vector<uint16_t> expected(kSymbols);
+    std::vector<float> expected_residuals(kSymbols);
+    for (std::size_t s = 0; s < kSymbols; ++s) {
+        expected[s] = reference.demodulate(stream.data() + s * sps);
+        expected_residuals[s] = reference.last_residual();
+    }
+    const std::vector<float> expected_mags = reference.get_fft_magnitudes_sq();
+
+    int wrong = 0;
+    for (std::size_t s = 0; s < kSymbols; ++s) {
+        wrong += expected[s] != sent[s];
+    }
+    if (wrong > 0) {
+        std::fprintf(stderr, "reference demodulation: %d/%zu symbols wrong\n", wrong, kSymbols);
+        ++failures;
+    }
+
+    host_sim::FftDemodulator demod(kSf, kBw * kOs, kBw);
+    const host_sim::PolyphaseSamples planes(stream, kOs);
+    for (const bool split : {false, true}) {
+        demod.set_frequency_offsets(0.2f, 0, 0.0f);
+        std::vector<uint16_t> out(kSymbols);
+        std::vector<float> residuals(kSymbols);
+        if (split) {
+            demod.demodulate_block(planes, 0, kSymbols, static_cast<double>(sps), out.data(), residuals.data());
+        } else {
+            demod.demodulate_block(stream.data(), kSymbols, static_cast<double>(sps), out.data(), residuals.data());
+        }
+
+        int mismatches = 0;
+        float worst_residual = 0.0f;
+        for (std::size_t s = 0; s < kSymbols; ++s) {
+            mismatches += out[s] != expected[s];
+            worst_residual = std::max(worst_residual, std::abs(residuals[s] - expected_residuals[s]));
+        }
+        const auto& mags = demod.get_fft_magnitudes_sq();
+        float worst_mag = 0.0f;
+        for (std::size_t k = 0; k < mags.size(); ++k) {
+            worst_mag = std::max(worst_mag, std::abs(mags[k] - expected_mags[k]) / (expected_mags[k] + 1.0f));
+        }
+        if (mismatches > 0 || worst_residual > 1e-2f || worst_mag > 1e-3f) {
+            std::fprintf(stderr, "%s block: %d symbol mismatches, residual error %g, spectrum error %g\n",
+                         split ? "polyphase" : "interleaved", mismatches, worst_residual, worst_mag);
+            ++failures;
+        }
+    }
+
+    std::printf("GPU demod test (%s, %zu symbols): %d failures\n",
+                gpu ? "cuda" : "no GPU, CPU fallback", kSymbols, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+/// test_iq_ring_buffer.cpp — Verify that IqRingBuffer keeps wrapped data
+/// contiguous, and that StreamingIqReader delivers a lossless, in-order
+/// stream in blocking-reader-sized chunks, reports EOF like fread(), and
+/// counts overflows and drops when the ring fills.
+
+#include "host_sim/capture.hpp"
+#include "host_sim/iq_ring_buffer.hpp"
+
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+std::complex<float> tag(std::size_t i)
+{
+    return {static_cast<float>(i), -static_cast<float>(i % 1000)};
+}
+
+std::FILE* make_cf32_source(std::size_t n_samples)
+{
+    std::FILE* f = std::tmpfile();
+    if (!f) {
+        return nullptr;
+    }
+    std::vector<std::complex<float>> samples(n_samples);
+    for (std::size_t i = 0; i < n_samples; ++i) {
+        samples[i] = tag(i);
+    }
+    std::fwrite(samples.data(), sizeof(samples[0]), samples.size(), f);
+    std::rewind(f);
+    return f;
+}
+
+int test_ring_wrap()
+{
+    int failures = 0;
+    host_sim::IqRingBuffer ring(1000);
+    const std::size_t cap = ring.capacity();
+    if (cap < 1000) {
+        std::fprintf(stderr, "ring capacity %zu below request\n", cap);
+        return 1;
+    }
+
+    // Push/consume in odd-sized steps so the read window straddles the
+    // wrap many times; every window must read back as one run.
+    std::size_t next_in = 0;
+    std::size_t next_out = 0;
+    std::vector<std::complex<float>> block(cap);
+    for (int round = 0; round < 200; ++round) {
+        const std::size_t want = 1 + (round * 397) % cap;
+        for (std::size_t i = 0; i < want; ++i) {
+            block[i] = tag(next_in + i);
+        }
+        next_in += ring.push(block.data(), want);
+
+        const std::size_t avail = ring.readable();
+        const std::complex<float>* p = ring.read_ptr();
+        for (std::size_t i = 0; i < avail; ++i) {
+            if (p[i] != tag(next_out + i)) {
+                std::fprintf(stderr, "round %d: sample %zu wrong in contiguous window\n", round, i);
+                return failures + 1;
+            }
+        }
+        const std::size_t take = (avail * 2 + 1) / 3;
+        ring.consume(take);
+        next_out += take;
+    }
+    if (ring.readable() + ring.write_space() != cap) {
+        std::fprintf(stderr, "ring accounting off\n");
+        ++failures;
+    }
+    std::printf("  ring: capacity %zu, %s\n", cap, ring.double_mapped() ? "double-mapped" : "mirrored");
+    return failures;
+}
+
+int test_chunking_and_eof(std::size_t total, std::size_t chunk)
+{
+    std::FILE* f = make_cf32_source(total);
+    if (!f) {
+        std::fprintf(stderr, "tmpfile unavailable\n");
+        return 1;
+    }
+    int failures = 0;
+    {
+        host_sim::StreamingIqReader reader(host_sim::IqFormat::cf32, chunk, 0,
+                                           host_sim::OverflowPolicy::block, f);
+        std::size_t seen = 0;
+        std::size_t calls = 0;
+        while (!reader.eof()) {
+            const std::size_t n = reader.read_chunk();
+            ++calls;
+            const std::size_t expected = std::min(chunk, total - seen);
+            if (n != expected) {
+                std::fprintf(stderr, "chunk %zu: got %zu samples, expected %zu\n", calls, n, expected);
+                ++failures;
+                break;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                if (reader.data()[reader.available() - n + i] != tag(seen + i)) {
+                    std::fprintf(stderr, "sample %zu out of order\n", seen + i);
+                    ++failures;
+                    break;
+                }
+            }
+            seen += n;
+            reader.consume(reader.available());
+        }
+        // A blocking reader sees EOF on the first short read, so an exact
+        // multiple of the chunk size costs one extra empty call.
+        const std::size_t expected_calls = total / chunk + 1;
+        if (seen != total || calls != expected_calls) {
+            std::fprintf(stderr, "total %zu/%zu samples in %zu calls (expected %zu)\n",
+                         seen, total, calls, expected_calls);
+            ++failures;
+        }
+        if (reader.overflows() != 0 || reader.dropped_samples() != 0) {
+            std::fprintf(stderr, "unexpected overflow with a roomy ring\n");
+            ++failures;
+        }
+    }
+    std::fclose(f);
+    return failures;
+}
+
+int test_block_policy()
+{
+    constexpr std::size_t total = 50000;
+    std::FILE* f = make_cf32_source(total);
+    if (!f) {
+        return 1;
+    }
+    int failures = 0;
+    {
+        host_sim::StreamingIqReader reader(host_sim::IqFormat::cf32, 700, 2048,
+                                           host_sim::OverflowPolicy::block, f);
+        std::size_t seen = 0;
+        bool was_full = false;
+        while (!reader.eof()) {
+            reader.read_chunk();
+            if (!reader.full()) {
+                continue;
+            }
+            was_full = true;
+            // Drain half, checking the run is contiguous across the wrap.
+            const std::size_t take = reader.available() / 2;
+            for (std::size_t i = 0; i < take; ++i) {
+                if (reader.data()[i] != tag(seen + i)) {
+                    std::fprintf(stderr, "block policy: sample %zu lost or reordered\n", seen + i);
+                    std::fclose(f);
+                    return failures + 1;
+                }
+            }
+            reader.consume(take);
+            seen += take;
+        }
+        for (std::size_t i = 0; i < reader.available(); ++i) {
+            if (reader.data()[i] != tag(seen + i)) {
+                std::fprintf(stderr, "block policy: tail sample %zu wrong\n", seen + i);
+                ++failures;
+                break;
+            }
+        }
+        seen += reader.available();
+        if (!was_full || seen != total || reader.dropped_samples() != 0 || reader.overflows() == 0) {
+            std::fprintf(stderr, "block policy: full=%d seen=%zu dropped=%llu overflows=%llu\n",
+                         was_full ? 1 : 0, seen,
+                         static_cast<unsigned long long>(reader.dropped_samples()),
+                         static_cast<unsigned long long>(reader.overflows()));
+            ++failures;
+        }
+    }
+    std::fclose(f);
+    return failures;
+}
+
+int test_drop_policy()
+{
+    constexpr std::size_t total = 40000;
+    std::FILE* f = make_cf32_source(total);
+    if (!f) {
+        return 1;
+    }
+    int failures = 0;
+    {
+        host_sim::StreamingIqReader reader(host_sim::IqFormat::cf32, 512, 2048,
+                                           host_sim::OverflowPolicy::drop, f);
+        while (!reader.full()) {
+            reader.read_chunk();
+        }
+        // Never consuming: everything past the first ring-full is dropped.
+        const std::size_t kept = reader.available();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (reader.dropped_samples() != total - kept &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (reader.dropped_samples() != total - kept || reader.overflows() == 0) {
+            std::fprintf(stderr, "drop policy: kept %zu, dropped %llu of %zu\n", kept,
+                         static_cast<unsigned long long>(reader.dropped_samples()), total);
+            ++failures;
+        }
+        for (std::size_t i = 0; i < kept; ++i) {
+            if (reader.data()[i] != tag(i)) {
+                std::fprintf(stderr, "drop policy: kept sample %zu wrong\n", i);
+                ++failures;
+                break;
+            }
+        }
+    }
+    std::fclose(f);
+    return failures;
+}
+
+int test_hackrf_format()
+{
+    std::FILE* f = std::tmpfile();
+    if (!f) {
+        return 1;
+    }
+    const signed char raw[] = {64, -128, 127, 0, -1, 32, 5};  // trailing odd byte is dropped
+    std::fwrite(raw, 1, sizeof(raw), f);
+    std::rewind(f);
+
+    int failures = 0;
+    {
+        host_sim::StreamingIqReader reader(host_sim::IqFormat::hackrf_int8, 16, 0,
+                                           host_sim::OverflowPolicy::block, f);
+        const std::size_t n = reader.read_chunk();
+        const std::complex<float> expected[] = {{0.5f, -1.0f}, {127.0f / 128.0f, 0.0f},
+                                                {-1.0f / 128.0f, 0.25f}};
+        if (n != 3 || !reader.eof()) {
+            std::fprintf(stderr, "hackrf: %zu samples, eof=%d\n", n, reader.eof() ? 1 : 0);
+            ++failures;
+        } else {
+            for (std::size_t i = 0; i < 3; ++i) {
+                if (reader.data()[i] != expected[i]) {
+                    std::fprintf(stderr, "hackrf: sample %zu converted wrong\n", i);
+                    ++failures;
+                }
+            }
+        }
+    }
+    std::fclose(f);
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_ring_wrap();
+    failures += test_chunking_and_eof(10000, 4096);
+    failures += test_chunking_and_eof(8192, 4096);
+    failures += test_block_policy();
+    failures += test_drop_policy();
+    failures += test_hackrf_format();
+
+    std::printf("IQ ring buffer test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/// test_iq_source.cpp — Verify the StreamingIqReader sources: --source URIs
+/// parse into the right specs, raw UDP datagrams arrive in order through a
+/// reader, and VITA-49 packets are unpacked with their timestamps, context
+/// packets skipped and a packet-count gap reported as lost samples.
+
+#include "host_sim/capture.hpp"
+#include "host_sim/iq_source.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using host_sim::IqFormat;
+using host_sim::IqSourceKind;
+
+int test_parse()
+{
+    int failures = 0;
+    auto expect = [&](bool ok, const char* what) {
+        if (!ok) {
+            std::fprintf(stderr, "parse: %s\n", what);
+            ++failures;
+        }
+    };
+    auto spec = host_sim::parse_iq_source("-", IqFormat::hackrf_int8);
+    expect(spec.kind == IqSourceKind::file && spec.format == IqFormat::hackrf_int8, "stdin");
+    spec = host_sim::parse_iq_source("udp://:5000", IqFormat::sc16);
+    expect(spec.kind == IqSourceKind::udp && spec.address.empty() && spec.port == 5000, "udp any");
+    spec = host_sim::parse_iq_source("vita49://[::1]:4991", IqFormat::cf32);
+    expect(spec.kind == IqSourceKind::vita49 && spec.address == "::1" && spec.port == 4991 &&
+               spec.format == IqFormat::sc16,
+           "vita49 v6");
+    spec = host_sim::parse_iq_source("zmq+tcp://radio:5555", IqFormat::cf32);
+    expect(spec.kind == IqSourceKind::zmq && spec.address == "tcp://radio:5555", "zmq");
+    spec = host_sim::parse_iq_source("soapy://driver=hackrf,serial=42?freq=868.1e6&rate=2e6&gain=30", IqFormat::cf32);
+    expect(spec.kind == IqSourceKind::soapysdr && spec.address == "driver=hackrf,serial=42" &&
+               spec.frequency_hz == 868.1e6 && spec.sample_rate == 2e6 && spec.gain_db == 30.0,
+           "soapy");
+    for (const char* bad : {"udp://radio", "udp://:99999", "soapy://?bogus=1", "soapy://?freq=abc", "zmq+radio",
+                            "tcp://radio:1"}) {
+        try {
+            host_sim::parse_iq_source(bad, IqFormat::cf32);
+            std::fprintf(stderr, "parse: '%s' accepted\n", bad);
+            ++failures;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    for (const IqSourceKind kind : {IqSourceKind::zmq, IqSourceKind::soapysdr}) {
+        if (host_sim::iq_source_available(kind)) continue;
+        host_sim::IqSourceSpec unbuilt;
+        unbuilt.kind = kind;
+        try {
+            host_sim::open_iq_source(unbuilt);
+            std::fprintf(stderr, "open: %s opened without being built\n", host_sim::iq_source_kind_name(kind));
+            ++failures;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    return failures;
+}
+
+/// Port of a "udp://host:port" description.
+std::uint16_t described_port(const std::string& uri)
+{
+    return static_cast<std::uint16_t>(std::atoi(uri.substr(uri.rfind(':') + 1).c_str()));
+}
+
+struct Sender
+{
+    explicit Sender(std::uint16_t port) : fd(::socket(AF_INET, SOCK_DGRAM, 0))
+    {
+        to.sin_family = AF_INET;
+        to.sin_port = htons(port);
+        to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+    ~Sender() { ::close(fd); }
+
+    void send(const std::vector<std::uint8_t>& datagram) const
+    {
+        ::sendto(fd, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&to), sizeof to);
+    }
+
+    int fd;
+    sockaddr_in to{};
+};
+
+int test_udp_raw()
+{
+    int failures = 0;
+    host_sim::IqSourceSpec spec = host_sim::parse_iq_source("udp://127.0.0.1:0", IqFormat::sc16);
+    host_sim::StreamingIqReader reader(host_sim::open_iq_source(spec), 100);
+    const Sender sender(described_port(reader.source_name()));
+
+    constexpr int kDatagrams = 8;
+    constexpr int kSamples = 100;
+    for (int d = 0; d < kDatagrams; ++d) {
+        std::vector<std::uint8_t> datagram(kSamples * 4);
+        for (int k = 0; k < kSamples; ++k) {
+            const std::int16_t iq[2] = {static_cast<std::int16_t>(d * kSamples + k), static_cast<std::int16_t>(-k)};
+            std::memcpy(datagram.data() + 4 * k, iq, sizeof iq);
+        }
+        sender.send(datagram);
+    }
+    while (reader.available() < kDatagrams * kSamples) {
+        reader.read_chunk();
+    }
+    for (int n = 0; n < kDatagrams * kSamples; ++n) {
+        const auto expected = std::complex<float>(n / 32768.0f, -(n % kSamples) / 32768.0f);
+        if (reader.data()[n] != expected) {
+            std::fprintf(stderr, "udp: sample %d is (%g, %g)\n", n, reader.data()[n].real(), reader.data()[n].imag());
+            ++failures;
+            break;
+        }
+    }
+    if (reader.source_lost_samples() != 0 || reader.timestamp_ns(0, 1e6)) {
+        std::fprintf(stderr, "udp: raw datagrams reported losses or a timestamp\n");
+        ++failures;
+    }
+    return failures;
+}
+
+void put_be32(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+/// IF data packet with stream ID, UTC seconds, picosecond fraction and a
+/// trailer; sc16 big-endian samples counting from @p first.
+std::vector<std::uint8_t> vrt_data(int count, std::uint32_t seconds, std::uint64_t picoseconds, int first, int samples)
+{
+    const std::uint32_t words = 1 + 1 + 1 + 2 + static_cast<std::uint32_t>(samples) + 1;
+    std::vector<std::uint8_t> packet;
+    put_be32(packet, (0x1u << 28) | (1u << 26) | (1u << 22) | (2u << 20) | (static_cast<std::uint32_t>(count & 0xF) << 16) |
+                         words);
+    put_be32(packet, 0x1234);
+    put_be32(packet, seconds);
+    put_be32(packet, static_cast<std::uint32_t>(picoseconds >> 32));
+    put_be32(packet, static_cast<std::uint32_t>(picoseconds));
+    for (int k = 0; k < samples; ++k) {
+        put_be32(packet, (static_cast<std::uint32_t>(static_cast<std::uint16_t>(first + k)) << 16) | 0x8000u);
+    }
+    put_be32(packet, 0);   // trailer
+    return packet;
+}
+
+int test_vita49()
+{
+    int failures = 0;
+    host_sim::IqSourceSpec spec = host_sim::parse_iq_source("vita49://127.0.0.1:0", IqFormat::cf32);
+    host_sim::StreamingIqReader reader(host_sim::open_iq_source(spec), 64);
+    const Sender sender(described_port(reader.source_name()));
+
+    // 1 MS/s, 64 samples (64 µs) per packet; packet 3 never arrives and a
+    // context packet sits between 1 and 2.
+    constexpr int kSamples = 64;
+    constexpr std::uint32_t kSeconds = 1000;
+    for (int p = 0; p < 6; ++p) {
+        if (p == 3) continue;
+        if (p == 2) {
+            std::vector<std::uint8_t> context;
+            put_be32(context, (0x4u << 28) | 3u);
+            put_be32(context, 0x1234);
+            put_be32(context, 0);
+            sender.send(context);
+        }
+        sender.send(vrt_data(p, kSeconds, static_cast<std::uint64_t>(p) * kSamples * 1000000, p * kSamples, kSamples));
+    }
+    constexpr std::size_t kReceived = 5 * kSamples;
+    while (reader.available() < kReceived) {
+        reader.read_chunk();
+    }
+    if (reader.data()[0] != std::complex<float>(0.0f, -1.0f) ||
+        reader.data()[3 * kSamples] != std::complex<float>(4 * kSamples / 32768.0f, -1.0f)) {
+        std::fprintf(stderr, "vita49: payload not unpacked big-endian\n");
+        ++failures;
+    }
+    if (reader.source_lost_samples() != kSamples) {
+        std::fprintf(stderr, "vita49: %llu samples reported lost, expected %d\n",
+                     static_cast<unsigned long long>(reader.source_lost_samples()), kSamples);
+        ++failures;
+    }
+    const std::int64_t t0 = std::int64_t{kSeconds} * 1000000000;
+    const auto before_gap = reader.timestamp_ns(2 * kSamples + 5, 1e6);
+    const auto after_gap = reader.timestamp_ns(3 * kSamples + 10, 1e6);
+    if (reader.timestamp_ns(0, 1e6) != t0 || before_gap != t0 + (2 * kSamples + 5) * 1000 ||
+        after_gap != t0 + (4 * kSamples + 10) * 1000) {
+        std::fprintf(stderr, "vita49: timestamps %lld / %lld\n", static_cast<long long>(before_gap.value_or(-1)),
+                     static_cast<long long>(after_gap.value_or(-1)));
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_parse();
+    failures += test_udp_raw();
+    failures += test_vita49();
+    std::printf("IQ source test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
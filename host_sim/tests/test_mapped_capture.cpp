@@ -0,0 +1,111 @@
+/// test_mapped_capture.cpp — Verify that MappedCapture exposes exactly the
+/// samples load_cf32() reads, survives moves, handles empty files, and
+/// rejects missing or truncated captures.
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/capture.hpp"
+
+#include <complex>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+void write_file(const std::filesystem::path& path, const void* data, std::size_t bytes)
+{
+    std::ofstream out(path, std::ios::binary);
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+
+template <typename Fn>
+bool throws(Fn&& fn)
+{
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto path = dir / "host_sim_mapped_capture.cf32";
+    const auto empty_path = dir / "host_sim_mapped_capture_empty.cf32";
+    const auto bad_path = dir / "host_sim_mapped_capture_bad.cf32";
+
+    // Quiet lead-in followed by a loud burst, so burst detection has
+    // something to find through the mapped span.
+    constexpr int sps = 128;
+    std::vector<std::complex<float>> samples(sps * 40);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        const float amp = i >= static_cast<std::size_t>(sps) * 20 ? 1.0f : 0.01f;
+        samples[i] = {amp * static_cast<float>((i * 7) % 13) / 13.0f,
+                      -amp * static_cast<float>((i * 5) % 11) / 11.0f};
+    }
+    write_file(path, samples.data(), samples.size() * sizeof(samples[0]));
+
+    {
+        host_sim::MappedCapture capture(path);
+        const auto loaded = host_sim::load_cf32(path);
+        const auto view = capture.samples();
+        if (view.size() != loaded.size() || view.size() != samples.size()) {
+            std::fprintf(stderr, "size mismatch: mapped %zu, loaded %zu\n", view.size(), loaded.size());
+            ++failures;
+        } else {
+            for (std::size_t i = 0; i < view.size(); ++i) {
+                if (view[i] != loaded[i]) {
+                    std::fprintf(stderr, "sample %zu differs\n", i);
+                    ++failures;
+                    break;
+                }
+            }
+        }
+
+        const auto from_vector = host_sim::detect_burst_start(loaded, sps);
+        const auto from_mapping = host_sim::detect_burst_start(capture.data(), capture.size(), sps);
+        if (!from_mapping || from_vector != from_mapping) {
+            std::fprintf(stderr, "burst detection differs on the mapped capture\n");
+            ++failures;
+        }
+
+        host_sim::MappedCapture moved(std::move(capture));
+        if (capture.size() != 0 || moved.size() != samples.size() || moved.samples()[5] != samples[5]) {
+            std::fprintf(stderr, "move did not transfer the mapping\n");
+            ++failures;
+        }
+    }
+
+    write_file(empty_path, nullptr, 0);
+    if (host_sim::MappedCapture(empty_path).size() != 0) {
+        std::fprintf(stderr, "empty capture reported samples\n");
+        ++failures;
+    }
+
+    const float lone = 1.0f;
+    write_file(bad_path, &lone, sizeof(lone));
+    if (!throws([&] { host_sim::MappedCapture capture(bad_path); })) {
+        std::fprintf(stderr, "truncated capture was accepted\n");
+        ++failures;
+    }
+    if (!throws([&] { host_sim::MappedCapture capture(dir / "host_sim_no_such_capture.cf32"); })) {
+        std::fprintf(stderr, "missing capture was accepted\n");
+        ++failures;
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(empty_path);
+    std::filesystem::remove(bad_path);
+
+    std::printf("Mapped capture test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
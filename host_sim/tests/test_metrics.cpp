@@ -0,0 +1,199 @@
+/// test_metrics.cpp — Verify the stream metrics: histogram buckets take
+/// each observation at its upper bound and export cumulatively, packets
+/// fold into the counters by path and SF, concurrent observers lose no
+/// counts, and the snapshot file is replaced whole.
+
+#include "host_sim/metrics.hpp"
+#include "host_sim/receiver.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using host_sim::LatencyHistogram;
+using host_sim::ReceiverMetrics;
+using host_sim::lora_replay::DecodePath;
+using host_sim::lora_replay::StreamDecodeResult;
+
+bool contains(const std::string& text, const std::string& line)
+{
+    return text.find(line + "\n") != std::string::npos;
+}
+
+int test_histogram_buckets()
+{
+    int failures = 0;
+    LatencyHistogram histogram;
+    histogram.observe(0.0005);   // first bucket
+    histogram.observe(0.001);    // on a bound: that bucket
+    histogram.observe(0.003);    // (0.002, 0.005]
+    histogram.observe(60.0);     // overflow
+    const auto counts = histogram.counts();
+    if (counts[0] != 2 || counts[2] != 1 || counts[LatencyHistogram::kBuckets - 1] != 1 || histogram.count() != 4) {
+        std::fprintf(stderr, "histogram buckets: %llu %llu %llu overflow %llu\n",
+                     static_cast<unsigned long long>(counts[0]), static_cast<unsigned long long>(counts[1]),
+                     static_cast<unsigned long long>(counts[2]),
+                     static_cast<unsigned long long>(counts[LatencyHistogram::kBuckets - 1]));
+        ++failures;
+    }
+    if (histogram.sum() < 60.0045 || histogram.sum() > 60.0046) {
+        std::fprintf(stderr, "histogram sum %.6f\n", histogram.sum());
+        ++failures;
+    }
+    return failures;
+}
+
+int test_record_and_format()
+{
+    int failures = 0;
+    ReceiverMetrics metrics;
+    StreamDecodeResult ok;
+    ok.header_ok = true;
+    ok.crc_expected = true;
+    ok.crc_ok = true;
+    ok.total_bits = 64;
+    ok.path = DecodePath::grid;
+    StreamDecodeResult bad = ok;
+    bad.crc_ok = false;
+    bad.bit_errors = 3;
+    bad.path = DecodePath::os2;
+    bad.effort = host_sim::lora_replay::DecodeEffort::standard;
+    bad.budget_exhausted = true;
+    metrics.record_packet(7, ok, 2.0);
+    metrics.record_packet(7, ok, 30.0);
+    metrics.record_packet(12, bad, 400.0);
+    metrics.record_packet(99, StreamDecodeResult{}, 0.5);   // SF out of range: counted, not per-SF
+
+    if (metrics.packets != 4 || metrics.headers_ok != 3 || metrics.crc_ok != 2 || metrics.crc_failed != 1 ||
+        metrics.bit_errors != 3 || metrics.payload_bits != 192) {
+        std::fprintf(stderr, "record_packet counters wrong\n");
+        ++failures;
+    }
+    if (metrics.paths[static_cast<std::size_t>(DecodePath::grid)] != 2 ||
+        metrics.paths[static_cast<std::size_t>(DecodePath::os2)] != 1 ||
+        metrics.paths[static_cast<std::size_t>(DecodePath::none)] != 1) {
+        std::fprintf(stderr, "record_packet paths wrong\n");
+        ++failures;
+    }
+
+    host_sim::PhaseTimes phases;
+    phases[host_sim::DecodePhase::demod] = 2.5e9;
+    metrics.add_phases(phases);
+
+    host_sim::ReceiverStats stats;
+    stats.decoders = 2;
+    stats.bursts_dropped = 5;
+    host_sim::StreamGauges gauges;
+    gauges.uptime_s = 12.0;
+    gauges.stream_s = 10.0;
+    gauges.reader_dropped_samples = 640;
+    const std::string text = host_sim::format_prometheus(metrics, stats, gauges);
+    const char* expected[] = {
+        "# TYPE host_sim_packets_total counter",
+        "host_sim_packets_total 4",
+        "host_sim_crc_failed_total 1",
+        "host_sim_decode_path_total{path=\"grid\"} 2",
+        "host_sim_decode_path_total{path=\"sfd_redemod\"} 0",
+        "# TYPE host_sim_decode_latency_seconds histogram",
+        "host_sim_decode_latency_seconds_bucket{le=\"0.001\"} 1",
+        "host_sim_decode_latency_seconds_bucket{le=\"0.002\"} 2",
+        "host_sim_decode_latency_seconds_bucket{le=\"0.05\"} 3",
+        "host_sim_decode_latency_seconds_bucket{le=\"0.5\"} 4",
+        "host_sim_decode_latency_seconds_bucket{le=\"+Inf\"} 4",
+        "host_sim_decode_latency_seconds_count 4",
+        "# TYPE host_sim_decode_effort_latency_seconds histogram",
+        "host_sim_decode_effort_latency_seconds_bucket{effort=\"fast\",le=\"0.05\"} 3",
+        "host_sim_decode_effort_latency_seconds_count{effort=\"fast\"} 3",
+        "host_sim_decode_effort_latency_seconds_bucket{effort=\"standard\",le=\"0.2\"} 0",
+        "host_sim_decode_effort_latency_seconds_count{effort=\"standard\"} 1",
+        "host_sim_decode_effort_latency_seconds_count{effort=\"exhaustive\"} 0",
+        "host_sim_decode_budget_exhausted_total 1",
+        "host_sim_phase_seconds_total{phase=\"demod\"} 2.5",
+        "host_sim_sf_packets_total{sf=\"7\"} 2",
+        "host_sim_sf_packets_total{sf=\"12\"} 1",
+        "host_sim_bursts_dropped_total 5",
+        "host_sim_decoders 2",
+        "host_sim_realtime_lag_seconds 2",
+        "host_sim_reader_dropped_samples_total 640",
+    };
+    for (const char* line : expected) {
+        if (!contains(text, line)) {
+            std::fprintf(stderr, "exposition lacks \"%s\"\n", line);
+            ++failures;
+        }
+    }
+    if (text.find("sf=\"8\"") != std::string::npos) {
+        std::fprintf(stderr, "exposition lists an SF with no packets\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_concurrent_observers()
+{
+    int failures = 0;
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    ReceiverMetrics metrics;
+    StreamDecodeResult result;
+    result.path = DecodePath::sfd_redemod;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                metrics.record_packet(7 + t, result, 1.5);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const auto counts = metrics.decode_latency.counts();
+    if (metrics.packets != kThreads * kPerThread || counts[1] != kThreads * kPerThread ||
+        metrics.paths[static_cast<std::size_t>(DecodePath::sfd_redemod)] != kThreads * kPerThread ||
+        metrics.sf_packets[1] != kPerThread) {
+        std::fprintf(stderr, "concurrent observers lost counts: %llu packets\n",
+                     static_cast<unsigned long long>(metrics.packets.load()));
+        ++failures;
+    }
+    return failures;
+}
+
+int test_write_file()
+{
+    int failures = 0;
+    const auto path = std::filesystem::temp_directory_path() / "host_sim_test_metrics.prom";
+    host_sim::write_metrics_file(path, "first 1\n");
+    host_sim::write_metrics_file(path, "second 2\n");
+    std::ifstream in(path);
+    std::ostringstream text;
+    text << in.rdbuf();
+    auto staging = path;
+    staging += ".tmp";
+    if (text.str() != "second 2\n" || std::filesystem::exists(staging)) {
+        std::fprintf(stderr, "metrics file: \"%s\"\n", text.str().c_str());
+        ++failures;
+    }
+    std::filesystem::remove(path);
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_histogram_buckets();
+    failures += test_record_and_format();
+    failures += test_concurrent_observers();
+    failures += test_write_file();
+    std::printf("Metrics test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/// test_packet_sink.cpp — Verify the packet output sink: binary records
+/// round-trip and parse incrementally, NDJSON lines carry every field, the
+/// text format reproduces the stream report, and the writer thread keeps
+/// order across batches and reports a failed output on close().
+
+#include "host_sim/packet_sink.hpp"
+#include "host_sim/receiver.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using host_sim::PacketRecord;
+using host_sim::lora_replay::DecodePath;
+
+PacketRecord sample_record(std::uint64_t index)
+{
+    PacketRecord record;
+    record.index = index;
+    record.start_sample = 1000 + index;
+    record.length = 20480;
+    record.time_s = 0.0125;
+    record.duration_s = 0.04;
+    record.sf = 9;
+    record.cr = 2;
+    record.snr_db = 14.5f;
+    record.cfo_hz = -1234.5f;
+    record.decode_ms = 0.75;
+    record.header_ok = true;
+    record.crc_expected = true;
+    record.crc_ok = true;
+    record.path = DecodePath::sfd_redemod;
+    record.payload = {0x48, 0x69, 0x00, 0xff};
+    record.report = "Header: len=4 cr=2 crc=yes\n";
+    return record;
+}
+
+std::span<const std::uint8_t> bytes(const std::string& text)
+{
+    return {reinterpret_cast<const std::uint8_t*>(text.data()), text.size()};
+}
+
+int test_binary_round_trip()
+{
+    int failures = 0;
+    std::string buffer;
+    host_sim::append_binary_record(sample_record(3), buffer);
+    PacketRecord second = sample_record(4);
+    second.crc_ok = false;
+    second.payload_mismatch = true;
+    second.payload.clear();
+    second.source_time_ns = -1700000000123456789LL;
+    second.effort = host_sim::lora_replay::DecodeEffort::exhaustive;
+    second.budget_exhausted = true;
+    second.recovered = true;
+    host_sim::append_binary_record(second, buffer);
+
+    PacketRecord parsed;
+    if (host_sim::parse_binary_record(bytes(buffer).first(buffer.size() / 3), parsed) != 0) {
+        std::fprintf(stderr, "binary: a partial record parsed\n");
+        ++failures;
+    }
+    const std::size_t first = host_sim::parse_binary_record(bytes(buffer), parsed);
+    if (first == 0 || parsed.index != 3 || parsed.start_sample != 1003 || parsed.length != 20480 ||
+        parsed.sf != 9 || parsed.cr != 2 || parsed.snr_db != 14.5f || parsed.cfo_hz != -1234.5f ||
+        parsed.time_s != 0.0125 || !parsed.header_ok || !parsed.crc_ok || parsed.payload_mismatch ||
+        parsed.path != DecodePath::sfd_redemod || parsed.payload != sample_record(3).payload ||
+        parsed.source_time_ns) {
+        std::fprintf(stderr, "binary: first record did not round-trip\n");
+        ++failures;
+    }
+    const std::size_t next = host_sim::parse_binary_record(bytes(buffer).subspan(first), parsed);
+    if (first + next != buffer.size() || parsed.index != 4 || parsed.crc_ok || !parsed.payload_mismatch ||
+        !parsed.payload.empty() || parsed.source_time_ns != second.source_time_ns ||
+        parsed.effort != host_sim::lora_replay::DecodeEffort::exhaustive || !parsed.budget_exhausted ||
+        !parsed.recovered) {
+        std::fprintf(stderr, "binary: second record did not round-trip\n");
+        ++failures;
+    }
+
+    // A version-1 record (no source time) still parses.
+    std::string v1(buffer.substr(0, first - 8));
+    v1[0] = static_cast<char>(static_cast<unsigned char>(v1[0]) - 8);
+    v1[4] = 1;
+    if (host_sim::parse_binary_record(bytes(v1), parsed) != v1.size() || parsed.index != 3 ||
+        parsed.source_time_ns) {
+        std::fprintf(stderr, "binary: version-1 record did not parse\n");
+        ++failures;
+    }
+
+    std::string bad = buffer;
+    bad[4] = 0;   // version 0
+    try {
+        host_sim::parse_binary_record(bytes(bad), parsed);
+        std::fprintf(stderr, "binary: version 0 accepted\n");
+        ++failures;
+    } catch (const std::runtime_error&) {
+    }
+    return failures;
+}
+
+int test_ndjson_and_text()
+{
+    int failures = 0;
+    std::string line;
+    host_sim::append_ndjson_record(sample_record(7), line);
+    const char* fields[] = {
+        "{\"index\":7,", "\"start_sample\":1007,", "\"sf\":9,", "\"cr\":2,", "\"snr_db\":14.50,",
+        "\"cfo_hz\":-1234.50,", "\"crc_ok\":true,", "\"payload_mismatch\":false,",
+        "\"path\":\"sfd_redemod\",", "\"effort\":\"fast\",", "\"decode_ms\":0.750,",
+        "\"payload\":\"486900ff\"}",
+    };
+    for (const char* field : fields) {
+        if (line.find(field) == std::string::npos) {
+            std::fprintf(stderr, "ndjson lacks %s: %s", field, line.c_str());
+            ++failures;
+        }
+    }
+    if (line.empty() || line.back() != '\n' || line.find('\n') != line.size() - 1) {
+        std::fprintf(stderr, "ndjson is not one line\n");
+        ++failures;
+    }
+
+    std::string text;
+    auto failed = sample_record(2);
+    failed.header_ok = false;
+    host_sim::append_text_record(failed, true, text);
+    const std::string expected =
+        "\n=== Packet #2 ===\n"
+        "Burst at sample 1002 (12.5 ms), 20480 samples (40.0 ms), SNR=14.5 dB, SF=9\n"
+        "Header: len=4 cr=2 crc=yes\n"
+        "[stream] packet #2: header decode failed\n"
+        "[stream] decode latency: 0.8 ms\n";
+    if (text != expected) {
+        std::fprintf(stderr, "text record:\n%s", text.c_str());
+        ++failures;
+    }
+    return failures;
+}
+
+int test_record_from_packet()
+{
+    int failures = 0;
+    host_sim::ReceivedPacket pkt;
+    pkt.start = 500;
+    pkt.length = 1000;
+    pkt.sf = 7;
+    pkt.snr_db = 3.0f;
+    pkt.result.cr = 1;
+    pkt.result.cfo_hz = 250.0f;
+    pkt.result.path = DecodePath::grid;
+    pkt.result.payload = {1, 2, 3};
+    const auto record = host_sim::make_packet_record(pkt, 5, 4, 1000000);
+    if (record.index != 5 || record.start_sample != 2000 || record.length != 4000 || record.time_s != 0.002 ||
+        record.cr != 1 || record.cfo_hz != 250.0f || record.path != DecodePath::grid || record.payload.size() != 3) {
+        std::fprintf(stderr, "make_packet_record scaled or copied wrongly\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_sink_order_and_errors()
+{
+    int failures = 0;
+    constexpr std::uint64_t kRecords = 500;
+    std::ostringstream out;
+    {
+        host_sim::PacketSinkConfig config;
+        config.format = host_sim::PacketFormat::binary;
+        config.queue_capacity = 8;   // forces write() to wait and batches to form
+        config.max_batch = 16;
+        host_sim::PacketSink sink(out, config);
+        for (std::uint64_t i = 0; i < kRecords; ++i) {
+            sink.write(sample_record(i));
+        }
+        sink.close();
+        if (sink.written() != kRecords) {
+            std::fprintf(stderr, "sink wrote %llu of %llu records\n",
+                         static_cast<unsigned long long>(sink.written()),
+                         static_cast<unsigned long long>(kRecords));
+            ++failures;
+        }
+        sink.close();   // idempotent
+    }
+    const std::string data = out.str();
+    std::size_t pos = 0;
+    std::uint64_t expected = 0;
+    PacketRecord parsed;
+    while (const std::size_t used = host_sim::parse_binary_record(bytes(data).subspan(pos), parsed)) {
+        if (parsed.index != expected) {
+            std::fprintf(stderr, "sink reordered: record %llu at %llu\n",
+                         static_cast<unsigned long long>(parsed.index), static_cast<unsigned long long>(expected));
+            ++failures;
+            break;
+        }
+        ++expected;
+        pos += used;
+    }
+    if (expected != kRecords || pos != data.size()) {
+        std::fprintf(stderr, "sink output holds %llu records\n", static_cast<unsigned long long>(expected));
+        ++failures;
+    }
+
+    std::ostringstream broken;
+    broken.setstate(std::ios::badbit);
+    host_sim::PacketSink sink(broken, {host_sim::PacketFormat::ndjson});
+    for (std::uint64_t i = 0; i < 4; ++i) {
+        sink.write(sample_record(i));
+    }
+    try {
+        sink.close();
+        std::fprintf(stderr, "sink hid a failed output\n");
+        ++failures;
+    } catch (const std::runtime_error&) {
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_binary_round_trip();
+    failures += test_ndjson_and_text();
+    failures += test_record_from_packet();
+    failures += test_sink_order_and_errors();
+    std::printf("Packet sink test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/// test_preamble_runs.cpp — Verify find_preamble_runs(): a misaligned
+/// preamble shows up as one run at its own SF, two overlapping preambles
+/// of different SFs are each found by their own demodulator, and noise
+/// and data symbols produce no qualifying runs.
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/chirp.hpp"
+#include "host_sim/fft_demod.hpp"
+
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int kBw = 125000;
+constexpr int kOs = 2;
+constexpr int kMinRun = 5;
+
+/// Add `count` upchirps of symbol value `value` at sample `start`.
+void add_chirps(std::vector<std::complex<float>>& out, int sf, std::size_t start, int count, int value,
+                float gain)
+{
+    const auto chirps = host_sim::build_chirps(sf, kOs);
+    const std::size_t sps = chirps.upchirp.size();
+    for (int s = 0; s < count; ++s) {
+        for (std::size_t i = 0; i < sps; ++i) {
+            const std::size_t at = start + static_cast<std::size_t>(s) * sps + i;
+            if (at < out.size()) {
+                out[at] += gain * chirps.upchirp[(i + static_cast<std::size_t>(value) * kOs) % sps];
+            }
+        }
+    }
+}
+
+std::vector<std::complex<float>> noise(std::size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> g(0.0f, 0.02f);
+    std::vector<std::complex<float>> out(n);
+    for (auto& s : out) {
+        s = {g(rng), g(rng)};
+    }
+    return out;
+}
+
+std::vector<host_sim::PreambleRun> runs_at(int sf, const std::vector<std::complex<float>>& samples)
+{
+    host_sim::FftDemodulator demod(sf, kBw * kOs, kBw);
+    return host_sim::find_preamble_runs(samples, demod, kMinRun);
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    // ── SF9 preamble (8 symbols, misaligned by 300 samples) overlapped by
+    //    an SF7 preamble starting 12 SF9 symbols later ──
+    const std::size_t sps7 = std::size_t{128} * kOs;
+    const std::size_t sps9 = std::size_t{512} * kOs;
+    auto samples = noise(40 * sps9, 1);
+    add_chirps(samples, 9, 300, 8, 0, 1.0f);
+    add_chirps(samples, 7, 12 * sps9 + 77, 8, 0, 0.7f);
+
+    const auto r9 = runs_at(9, samples);
+    if (r9.size() != 1 || r9[0].first_symbol != 0 || r9[0].length < 7) {
+        std::fprintf(stderr, "SF9: %zu runs, first at %zu len %d\n", r9.size(),
+                     r9.empty() ? 0 : r9[0].first_symbol, r9.empty() ? 0 : r9[0].length);
+        ++failures;
+    }
+    const auto r7 = runs_at(7, samples);
+    const std::size_t expect7 = (12 * sps9 + 77) / sps7;
+    if (r7.size() != 1 || r7[0].first_symbol < expect7 || r7[0].first_symbol > expect7 + 1 ||
+        r7[0].length < 7) {
+        std::fprintf(stderr, "SF7: %zu runs, first at %zu (expected ~%zu)\n", r7.size(),
+                     r7.empty() ? 0 : r7[0].first_symbol, expect7);
+        ++failures;
+    }
+    for (int sf : {6, 8, 10, 11, 12}) {
+        if (!runs_at(sf, samples).empty()) {
+            std::fprintf(stderr, "SF%d: spurious preamble run\n", sf);
+            ++failures;
+        }
+    }
+
+    // ── Data symbols and noise alone do not qualify ──
+    auto data = noise(64 * sps7, 2);
+    std::mt19937 rng(3);
+    for (int s = 0; s < 64; ++s) {
+        add_chirps(data, 7, static_cast<std::size_t>(s) * sps7, 1, static_cast<int>(rng() % 128), 1.0f);
+    }
+    if (!runs_at(7, data).empty()) {
+        std::fprintf(stderr, "SF7 data symbols produced a preamble run\n");
+        ++failures;
+    }
+
+    std::printf("Preamble run test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/// test_q15_fft.cpp — Verify the Q15 kernels behind FftDemodulatorQ15 on
+/// the active backend: Q15Fft matches a double DFT scaled by 1/N to two
+/// LSB per stage at SF6-SF12, and q15_cmplx_mult() matches q15_mul() elementwise
+/// (exactly on KissFFT, to the two dropped bits on CMSIS-DSP).
+
+#include "host_sim/q15.hpp"
+#include "host_sim/q15_fft.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+int test_fft_matches_dft()
+{
+    int failures = 0;
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> uniform(-0.2f, 0.2f);
+    for (int sf = 6; sf <= 12; ++sf) {
+        const int n = 1 << sf;
+        std::vector<host_sim::Q15Complex> in(static_cast<std::size_t>(n));
+        std::vector<host_sim::Q15Complex> out(in.size());
+        // Two tones plus noise, well inside full scale.
+        const int k1 = n / 5;
+        const int k2 = n - 3;
+        for (int t = 0; t < n; ++t) {
+            const double w1 = 2.0 * std::numbers::pi * k1 * t / n;
+            const double w2 = 2.0 * std::numbers::pi * k2 * t / n;
+            const std::complex<float> x(static_cast<float>(0.4 * std::cos(w1) + 0.2 * std::cos(w2)) + uniform(rng),
+                                        static_cast<float>(0.4 * std::sin(w1) + 0.2 * std::sin(w2)) + uniform(rng));
+            in[static_cast<std::size_t>(t)] = host_sim::float_to_q15_complex(x.real(), x.imag());
+        }
+        host_sim::Q15Fft fft(n);
+        fft.forward(in.data(), out.data());
+
+        // Reference: exact DFT of the quantised input, divided by N.
+        std::vector<std::complex<double>> twiddle(static_cast<std::size_t>(n));
+        for (int t = 0; t < n; ++t) {
+            twiddle[static_cast<std::size_t>(t)] = std::polar(1.0, -2.0 * std::numbers::pi * t / n);
+        }
+        int worst = 0;
+        for (int k = 0; k < n; ++k) {
+            std::complex<double> acc{0.0, 0.0};
+            for (int t = 0; t < n; ++t) {
+                const auto& x = in[static_cast<std::size_t>(t)];
+                acc += std::complex<double>(x.real, x.imag) * twiddle[static_cast<std::size_t>((k * t) & (n - 1))];
+            }
+            acc /= static_cast<double>(n);
+            const auto& y = out[static_cast<std::size_t>(k)];
+            worst = std::max({worst, static_cast<int>(std::lround(std::abs(y.real - acc.real()))),
+                              static_cast<int>(std::lround(std::abs(y.imag - acc.imag())))});
+        }
+        // Rounding (KissFFT) or truncation (CMSIS-DSP) of the per-stage
+        // scaling: at most two LSB per radix-2 stage.
+        if (worst > 2 * sf) {
+            std::fprintf(stderr, "%s N=%d: %d LSB from the DFT\n", host_sim::Q15Fft::backend_name(), n, worst);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_cmplx_mult()
+{
+    int failures = 0;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> sample(-32768, 32767);
+    const std::size_t n = 1021;
+    std::vector<host_sim::Q15Complex> a(n);
+    std::vector<host_sim::Q15Complex> b(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        a[k] = {static_cast<int16_t>(sample(rng)), static_cast<int16_t>(sample(rng))};
+        b[k] = {static_cast<int16_t>(sample(rng)), static_cast<int16_t>(sample(rng))};
+    }
+    const int tolerance = std::strcmp(host_sim::Q15Fft::backend_name(), "kissfft") == 0 ? 0 : 4;
+
+    // In place on the first operand, as FftDemodulatorQ15 calls it.
+    std::vector<host_sim::Q15Complex> out = a;
+    host_sim::q15_cmplx_mult(out.data(), b.data(), out.data(), n);
+    for (std::size_t k = 0; k < n; ++k) {
+        const host_sim::Q15Complex ref = host_sim::q15_mul(a[k], b[k]);
+        if (std::abs(out[k].real - ref.real) > tolerance || std::abs(out[k].imag - ref.imag) > tolerance) {
+            std::fprintf(stderr, "mult[%zu]: (%d,%d) vs q15_mul (%d,%d)\n", k, out[k].real, out[k].imag, ref.real,
+                         ref.imag);
+            ++failures;
+            break;
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_fft_matches_dft();
+    failures += test_cmplx_mult();
+    std::printf("Q15 FFT test (%s): %d failures\n", host_sim::Q15Fft::backend_name(), failures);
+    return failures == 0 ? 0 : 1;
+}
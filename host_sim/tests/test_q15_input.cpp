@@ -0,0 +1,147 @@
+/// test_q15_input.cpp — Verify the native integer/Q15 input path: load_q15()
+/// converts int8, sc16 and cf32 captures to the expected Q15 values, and
+/// DemodStageQ15 fed native Q15 symbols through the scheduler produces the
+/// same symbols as the float-input path it bypasses.
+
+#include "host_sim/capture.hpp"
+#include "host_sim/chirp.hpp"
+#include "host_sim/scheduler.hpp"
+#include "host_sim/stages/demod_stage.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace
+{
+
+class VectorSource : public host_sim::SymbolSource
+{
+public:
+    explicit VectorSource(std::vector<host_sim::SymbolBuffer> symbols) : symbols_(std::move(symbols)) {}
+
+    void reset() override { index_ = 0; }
+
+    std::optional<host_sim::SymbolBuffer> next_symbol() override
+    {
+        if (index_ >= symbols_.size()) {
+            return std::nullopt;
+        }
+        return symbols_[index_++];
+    }
+
+private:
+    std::vector<host_sim::SymbolBuffer> symbols_;
+    std::size_t index_{0};
+};
+
+class CollectorStage : public host_sim::Stage
+{
+public:
+    void reset(const host_sim::StageConfig&) override { symbols.clear(); }
+    void process(host_sim::SymbolContext& ctx) override { symbols.push_back(ctx.demod_symbol); }
+    void flush() override {}
+
+    std::vector<uint16_t> symbols;
+};
+
+template <typename T>
+void write_raw(const std::filesystem::path& path, const std::vector<T>& values)
+{
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+std::vector<uint16_t> run_stage(std::vector<host_sim::SymbolBuffer> symbols, int sf, int sr, int bw)
+{
+    host_sim::Scheduler scheduler;
+    scheduler.configure({sf, bw, sr});
+    scheduler.attach_stage(std::make_shared<host_sim::DemodStageQ15>());
+    auto collector = std::make_shared<CollectorStage>();
+    scheduler.attach_stage(collector);
+    VectorSource source(std::move(symbols));
+    scheduler.run(source);
+    return collector->symbols;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    const auto dir = std::filesystem::temp_directory_path();
+
+    // ── load_q15 ──
+    const std::vector<int8_t> iq8 = {-128, 127, 0, -1, 64, -64};
+    const std::vector<int16_t> iq16 = {-32768, 32767, 0, -1, 12345, -54};
+    const std::vector<float> iqf = {-1.5f, 0.5f, 0.25f, -0.25f};
+    write_raw(dir / "host_sim_q15_input.int8", iq8);
+    write_raw(dir / "host_sim_q15_input.sc16", iq16);
+    write_raw(dir / "host_sim_q15_input.cf32", iqf);
+
+    const auto q8 = host_sim::load_q15(dir / "host_sim_q15_input.int8", host_sim::IqFormat::hackrf_int8);
+    const auto q16 = host_sim::load_q15(dir / "host_sim_q15_input.sc16", host_sim::IqFormat::sc16);
+    const auto qf = host_sim::load_q15(dir / "host_sim_q15_input.cf32", host_sim::IqFormat::cf32);
+    if (q8.size() != 3 || q16.size() != 3 || qf.size() != 2) {
+        std::fprintf(stderr, "load_q15 sizes %zu/%zu/%zu\n", q8.size(), q16.size(), qf.size());
+        ++failures;
+    } else {
+        for (std::size_t k = 0; k < 3; ++k) {
+            if (q8[k].real != iq8[2 * k] * 256 || q8[k].imag != iq8[2 * k + 1] * 256) {
+                std::fprintf(stderr, "int8 sample %zu converted wrong\n", k);
+                ++failures;
+            }
+            if (q16[k].real != iq16[2 * k] || q16[k].imag != iq16[2 * k + 1]) {
+                std::fprintf(stderr, "sc16 sample %zu converted wrong\n", k);
+                ++failures;
+            }
+        }
+        if (qf[0].real != host_sim::kQ15Min || qf[0].imag != 16384 || qf[1].real != 8192 ||
+            qf[1].imag != -8192) {
+            std::fprintf(stderr, "cf32 samples quantised wrong\n");
+            ++failures;
+        }
+    }
+    std::filesystem::remove(dir / "host_sim_q15_input.int8");
+    std::filesystem::remove(dir / "host_sim_q15_input.sc16");
+    std::filesystem::remove(dir / "host_sim_q15_input.cf32");
+
+    // ── DemodStageQ15: native Q15 vs float input ──
+    for (int sf : {7, 9}) {
+        const int bw = 125000;
+        const int os = 2;
+        const int n_bins = 1 << sf;
+        const int sps = n_bins * os;
+        const auto chirps = host_sim::build_chirps(sf, os);
+
+        std::vector<host_sim::SymbolBuffer> as_float;
+        std::vector<host_sim::SymbolBuffer> as_q15;
+        for (int sym = 0; sym < n_bins; sym += n_bins / 16 + 1) {
+            host_sim::SymbolBuffer f;
+            host_sim::SymbolBuffer q;
+            for (int i = 0; i < sps; ++i) {
+                // Half scale so the float path applies no normalisation.
+                const auto v = 0.5f * chirps.upchirp[(i + sym * os) % sps];
+                const auto qv = host_sim::float_to_q15_complex(v.real(), v.imag());
+                f.samples.emplace_back(host_sim::q15_to_float(qv.real), host_sim::q15_to_float(qv.imag));
+                q.samples_q15.push_back(qv);
+            }
+            as_float.push_back(std::move(f));
+            as_q15.push_back(std::move(q));
+        }
+
+        const auto ref = run_stage(as_float, sf, bw * os, bw);
+        const auto got = run_stage(as_q15, sf, bw * os, bw);
+        if (ref != got || ref.empty()) {
+            std::fprintf(stderr, "SF%d: native Q15 symbols differ from float input\n", sf);
+            ++failures;
+        }
+    }
+
+    std::printf("Q15 input test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,307 @@
+/// test_q15_receiver.cpp — Verify the fixed-point receive chain: the block
+/// AGC exponents, the CORDIC phase against std::atan2, integer burst
+/// detection against detect_burst_ex(), and Q15Receiver decoding the same
+/// packets as the float decode_stream_burst() (payload, alignment, CFO)
+/// across spreading factors, oversampling and carrier offsets, with a
+/// cycle report that orders the MCU cores sensibly.
+
+#include "host_sim/alignment.hpp"
+#include "host_sim/lora_replay/burst_decoder.hpp"
+#include "host_sim/q15_receiver.hpp"
+#include "host_sim/tx/batch.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+using cf = std::complex<float>;
+
+int test_block_exponent()
+{
+    int failures = 0;
+    struct Case
+    {
+        int16_t peak;
+        int exponent;
+    };
+    for (const Case c : {Case{0, 0}, Case{1, 13}, Case{100, 7}, Case{8191, 1}, Case{8192, 0},
+                         Case{16383, 0}, Case{16384, -1}, Case{-32768, -1}}) {
+        const host_sim::Q15Complex block[3] = {{0, 0}, {c.peak, 0}, {0, static_cast<int16_t>(c.peak / 2)}};
+        const int exponent = host_sim::block_exponent_q15(block, 3);
+        if (exponent != c.exponent) {
+            std::fprintf(stderr, "peak %d: exponent %d, expected %d\n", c.peak, exponent, c.exponent);
+            ++failures;
+        }
+        host_sim::Q15Complex scaled[3];
+        host_sim::scale_block_q15(block, 3, exponent, scaled);
+        const int magnitude = std::abs(static_cast<int>(scaled[1].real));
+        if (c.peak != 0 && (magnitude < (1 << 13) || magnitude > (1 << 14))) {
+            std::fprintf(stderr, "peak %d scaled to %d\n", c.peak, magnitude);
+            ++failures;
+        }
+    }
+
+    // Float blocks land in [0.25, 0.5) of full scale, for any level.
+    for (float peak : {3e-4f, 0.01f, 0.3f, 0.5f, 1.0f, 7.5f}) {
+        const cf block[2] = {{0.1f * peak, -peak}, {0.5f * peak, 0.0f}};
+        host_sim::Q15Complex out[2];
+        const int exponent = host_sim::quantise_block_q15(block, 2, out);
+        const float expected = -peak * std::ldexp(32768.0f, exponent);
+        if (std::abs(out[0].imag) < (1 << 13) || std::abs(out[0].imag) >= (1 << 14) ||
+            std::abs(static_cast<float>(out[0].imag) - expected) > 0.5f) {
+            std::fprintf(stderr, "float peak %g: exponent %d, imag %d\n", peak, exponent, out[0].imag);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_cordic()
+{
+    int failures = 0;
+    int worst = 0;
+    for (int k = -180; k < 180; ++k) {
+        const double angle = (k + 0.37) * M_PI / 180.0;
+        for (double radius : {3.0, 1e4, 1e9, 4e15}) {
+            const auto x = static_cast<int64_t>(std::llround(radius * std::cos(angle)));
+            const auto y = static_cast<int64_t>(std::llround(radius * std::sin(angle)));
+            const double exact = std::atan2(static_cast<double>(y), static_cast<double>(x)) / (2.0 * M_PI);
+            const int expected = static_cast<int>(std::lround(exact * 65536.0));
+            int diff = std::abs(host_sim::atan2_q15_turns(y, x) - expected);
+            worst = std::max(worst, std::min(diff, 65536 - diff));
+        }
+    }
+    if (worst > 4) {
+        std::fprintf(stderr, "CORDIC error %d LSB (Q15 turns)\n", worst);
+        ++failures;
+    }
+    if (host_sim::atan2_q15_turns(0, 0) != 0 || std::abs(host_sim::atan2_q15_turns(0, -5)) < 32767) {
+        std::fprintf(stderr, "CORDIC special cases wrong\n");
+        ++failures;
+    }
+    return failures;
+}
+
+struct Packet
+{
+    int sf;
+    int os;
+    float cfo_hz;
+    float snr_db;
+};
+
+/// A transmitted packet whose leading and trailing silence carries the
+/// same noise as the packet, quantised to Q15.
+struct Capture
+{
+    std::vector<cf> iq;
+    std::vector<host_sim::Q15Complex> q15;
+    std::vector<uint8_t> payload;
+    std::size_t packet_start{0};   ///< First sample of the preamble
+};
+
+Capture make_capture(const Packet& p, uint64_t seed)
+{
+    host_sim::tx::BatchOptions tx;
+    tx.packet.sf = p.sf;
+    tx.packet.cr = 2;
+    tx.packet.sample_rate = 125000 * p.os;
+    tx.channel.snr_db = p.snr_db;
+    tx.channel.cfo_hz = p.cfo_hz;
+    tx.payload_len = 16;
+    tx.seed = seed;
+    Capture capture;
+    float noise_std = 0.0f;
+    host_sim::tx::BatchGenerator(tx).run([&](const host_sim::tx::BatchPacket& packet) {
+        capture.iq = packet.iq;
+        capture.payload = packet.payload;
+        noise_std = packet.channel.noise_std;
+    });
+    while (capture.packet_start < capture.iq.size() && capture.iq[capture.packet_start] == cf{}) {
+        ++capture.packet_start;
+    }
+    std::mt19937 rng(static_cast<unsigned>(seed));
+    std::normal_distribution<float> g(0.0f, noise_std);
+    for (auto& s : capture.iq) {
+        if (s == cf{}) {
+            s = {g(rng), g(rng)};
+        }
+    }
+    // Noise at a tenth of full scale, as a front end with headroom for
+    // the packet would deliver it.
+    const float peak = 10.0f * std::max(noise_std, 0.25f);
+    for (auto& s : capture.iq) {
+        s /= peak;
+    }
+    capture.q15.resize(capture.iq.size());
+    for (std::size_t i = 0; i < capture.iq.size(); ++i) {
+        capture.q15[i] = host_sim::float_to_q15_complex(capture.iq[i].real(), capture.iq[i].imag());
+    }
+    return capture;
+}
+
+int test_detection()
+{
+    int failures = 0;
+    uint64_t seed = 46;
+    for (const Packet& p : {Packet{7, 1, 0.0f, 12.0f}, Packet{8, 4, 1500.0f, 10.0f}, Packet{9, 2, -800.0f, 15.0f}}) {
+        const Capture capture = make_capture(p, seed++);
+        const int sps = (1 << p.sf) * p.os;
+        host_sim::Q15OpCounts ops;
+        const auto q15 = host_sim::detect_burst_q15(capture.q15.data(), capture.q15.size(), sps, 6, 0, 1, &ops);
+        std::vector<cf> quantised(capture.q15.size());
+        for (std::size_t i = 0; i < quantised.size(); ++i) {
+            quantised[i] = {host_sim::q15_to_float(capture.q15[i].real), host_sim::q15_to_float(capture.q15[i].imag)};
+        }
+        const auto reference = host_sim::detect_burst_ex(quantised.data(), quantised.size(), sps, 6.0f);
+        if (!q15 || !reference || q15->burst_start != reference->burst_start) {
+            std::fprintf(stderr, "SF%d OS%d: Q15 burst start %zd, float %zd\n", p.sf, p.os,
+                         q15 ? static_cast<std::ptrdiff_t>(q15->burst_start) : -1,
+                         reference ? static_cast<std::ptrdiff_t>(reference->burst_start) : -1);
+            ++failures;
+            continue;
+        }
+        const double noise = static_cast<double>(q15->noise_floor) / (1 << 30);
+        if (std::abs(noise - reference->noise_floor) > 1e-6 + 1e-3 * reference->noise_floor) {
+            std::fprintf(stderr, "SF%d: Q15 noise floor %g, float %g\n", p.sf, noise, reference->noise_floor);
+            ++failures;
+        }
+        if (ops.detect_samples != capture.q15.size() / sps * sps) {
+            std::fprintf(stderr, "SF%d: %llu envelope samples counted\n", p.sf,
+                         static_cast<unsigned long long>(ops.detect_samples));
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_decode_matches_float()
+{
+    int failures = 0;
+    uint64_t seed = 460;
+    for (const Packet& p : {Packet{7, 1, 0.0f, 0.0f}, Packet{7, 2, 2500.0f, -3.0f}, Packet{8, 4, -1200.0f, -5.0f},
+                            Packet{9, 8, 9000.0f, -8.0f}, Packet{10, 1, -300.0f, -8.0f},
+                            Packet{12, 1, 700.0f, -15.0f}}) {
+        const Capture capture = make_capture(p, seed++);
+        const int sps = (1 << p.sf) * p.os;
+        // Below the energy detector's reach: start two symbols early.
+        const std::size_t start = capture.packet_start - 2 * static_cast<std::size_t>(sps);
+        host_sim::LoRaMetadata meta;
+        meta.sf = p.sf;
+        meta.bw = 125000;
+        meta.sample_rate = 125000 * p.os;
+        meta.cr = 2;
+        meta.payload_len = 16;
+
+        host_sim::Q15Receiver receiver(p.sf, meta.sample_rate, meta.bw);
+        const std::span<const host_sim::Q15Complex> burst =
+            std::span<const host_sim::Q15Complex>(capture.q15).subspan(start);
+        const host_sim::Q15DecodeResult q15 = receiver.decode(burst, meta);
+
+        host_sim::FftDemodulator demod(p.sf, meta.sample_rate, meta.bw);
+        std::ostringstream report;
+        report.setstate(std::ios::badbit);
+        const auto reference = host_sim::lora_replay::decode_stream_burst(
+            std::span<const cf>(capture.iq).subspan(start), demod, meta, {}, report);
+        const int decode_ffts = static_cast<int>(receiver.ops().ffts);
+
+        if (!reference.crc_ok || reference.payload != capture.payload) {
+            std::fprintf(stderr, "SF%d OS%d: float reference decode failed\n", p.sf, p.os);
+            ++failures;
+        }
+        if (!q15.crc_ok || q15.payload != capture.payload) {
+            std::fprintf(stderr, "SF%d OS%d CFO %.0f Hz: Q15 decode %s\n", p.sf, p.os, p.cfo_hz,
+                         q15.header_ok ? "failed its CRC" : "found no header");
+            ++failures;
+        }
+        // Upchirps alone cannot tell timing from CFO: an alignment d chips
+        // later sees the preamble d bins higher.  Both scans must agree on
+        // the CFO that remains once that is taken out.
+        const std::span<const cf> float_burst = std::span<const cf>(capture.iq).subspan(start);
+        const auto float_align = host_sim::find_symbol_alignment_cfo_aware(float_burst, demod, meta.preamble_len);
+        const auto q15_align = receiver.align(burst, meta.preamble_len);
+        const auto dealiased = [&](const host_sim::PreambleSearchResult& r) {
+            return static_cast<double>(r.preamble_bin) - static_cast<double>(r.alignment_offset) / p.os;
+        };
+        const int n = 1 << p.sf;
+        double drift = std::fmod(dealiased(q15_align) - dealiased(float_align), n);
+        drift = drift > n / 2.0 ? drift - n : (drift < -n / 2.0 ? drift + n : drift);
+        if (std::abs(drift) > 1.0) {
+            std::fprintf(stderr, "SF%d OS%d: Q15 alignment %zu/bin %d, float %zu/bin %d\n", p.sf, p.os,
+                         q15_align.alignment_offset, q15_align.preamble_bin, float_align.alignment_offset,
+                         float_align.preamble_bin);
+            ++failures;
+        }
+
+        // Same preamble, same estimate.
+        const std::size_t at = float_align.alignment_offset;
+        const auto float_cfo = demod.estimate_frequency_offsets(float_burst.data() + at, meta.preamble_len - 1);
+        const auto q15_cfo = receiver.estimate_frequency_offsets(burst.data() + at, meta.preamble_len - 1);
+        const float frac_error = std::abs(q15_cfo.cfo_frac_q15 / 32768.0f - float_cfo.cfo_frac);
+        if (q15_cfo.cfo_int != float_cfo.cfo_int || std::min(frac_error, 1.0f - frac_error) > 0.01f) {
+            std::fprintf(stderr, "SF%d OS%d: Q15 CFO %d%+.3f bins, float %d%+.3f bins\n", p.sf, p.os,
+                         q15_cfo.cfo_int, q15_cfo.cfo_frac_q15 / 32768.0f, float_cfo.cfo_int, float_cfo.cfo_frac);
+            ++failures;
+        }
+        if (decode_ffts == 0 || q15.burst_symbols == 0) {
+            std::fprintf(stderr, "SF%d OS%d: work not counted\n", p.sf, p.os);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_cycle_report()
+{
+    int failures = 0;
+    const Capture capture = make_capture({8, 1, 0.0f, 0.0f}, 4600);
+    host_sim::LoRaMetadata meta;
+    meta.sf = 8;
+    meta.bw = 125000;
+    meta.sample_rate = 125000;
+    meta.cr = 2;
+    meta.payload_len = 16;
+    host_sim::Q15Receiver receiver(8, meta.sample_rate, meta.bw);
+    const auto result = receiver.decode(capture.q15, meta);
+    const double symbol_period = 256.0 / 125000.0;
+
+    double previous_utilisation = 1e30;
+    for (const host_sim::McuCostModel& model : host_sim::mcu_cost_models()) {
+        const auto estimate =
+            host_sim::estimate_mcu_cycles(receiver.ops(), result.burst_symbols, symbol_period, model);
+        if (std::abs(estimate.cycles_per_symbol_budget - model.freq_mhz * 1e6 * symbol_period) > 1e-6 ||
+            estimate.cycles <= 0.0 || estimate.utilisation >= previous_utilisation) {
+            std::fprintf(stderr, "%s: %.0f cycles/symbol of %.0f\n", estimate.name.c_str(),
+                         estimate.cycles_per_symbol, estimate.cycles_per_symbol_budget);
+            ++failures;
+        }
+        previous_utilisation = estimate.utilisation;
+    }
+    host_sim::Q15OpCounts twice = receiver.ops();
+    twice += receiver.ops();
+    if (twice.complex_macs != 2 * receiver.ops().complex_macs) {
+        std::fprintf(stderr, "op counts do not add\n");
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_block_exponent();
+    failures += test_cordic();
+    failures += test_detection();
+    failures += test_decode_matches_float();
+    failures += test_cycle_report();
+    std::printf("Q15 receiver test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,422 @@
+/// test_receiver.cpp — Verify host_sim::Receiver: a stream of back-to-back
+/// packets pushed in arbitrary slices comes out as the same packets, in
+/// order, with the transmitted payloads; results do not depend on how
+/// push() slices the input or on the number of decoder threads; the fast
+/// effort tier and a decode budget stop escalation, and deferred recovery
+/// gets back what the fast tier gave up; incremental decoding hands each
+/// packet out within a symbol or two of its last sample and leaves what
+/// it cannot decode to the whole-burst path; collision mode recovers a
+/// weaker packet overlapping a stronger one on the same SF; and the
+/// receiver refuses input after finish().
+
+#include "host_sim/receiver.hpp"
+#include "host_sim/tx/batch.hpp"
+#include "host_sim/tx/channel.hpp"
+#include "host_sim/tx/packet.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+constexpr std::size_t kPackets = 5;
+
+struct Stream
+{
+    std::vector<std::complex<float>> iq;
+    std::vector<std::size_t> offsets;           // packet start samples
+    std::vector<std::size_t> ends;              // one past each packet's last chirp sample
+    std::vector<std::vector<uint8_t>> payloads;
+};
+
+Stream make_stream()
+{
+    host_sim::tx::BatchOptions options;
+    options.packet.sf = 8;
+    options.packet.cr = 2;
+    options.count = kPackets;
+    options.payload_len = 10;
+    options.seed = 11;
+    const host_sim::tx::BatchGenerator generator(options);
+    Stream stream;
+    generator.run([&](const host_sim::tx::BatchPacket& packet) {
+        stream.offsets.push_back(stream.iq.size());
+        const auto last = std::find_if(packet.iq.rbegin(), packet.iq.rend(),
+                                       [](const std::complex<float>& v) { return v != std::complex<float>{}; });
+        stream.ends.push_back(stream.iq.size() + static_cast<std::size_t>(packet.iq.rend() - last));
+        stream.payloads.push_back(packet.payload);
+        stream.iq.insert(stream.iq.end(), packet.iq.begin(), packet.iq.end());
+    });
+    return stream;
+}
+
+host_sim::ReceiverConfig make_config(std::size_t decoder_threads)
+{
+    host_sim::ReceiverConfig config;
+    config.metadata.sf = 8;
+    config.metadata.bw = 125000;
+    config.metadata.sample_rate = 125000;
+    config.metadata.cr = 2;
+    config.metadata.payload_len = 10;
+    config.metadata.has_crc = true;
+    config.decoder_threads = decoder_threads;
+    return config;
+}
+
+std::vector<host_sim::ReceivedPacket> receive(const Stream& stream, std::size_t slice,
+                                              std::size_t decoder_threads)
+{
+    host_sim::Receiver receiver(make_config(decoder_threads));
+    std::vector<host_sim::ReceivedPacket> packets;
+    const std::span<const std::complex<float>> iq(stream.iq);
+    for (std::size_t pos = 0; pos < iq.size(); pos += slice) {
+        receiver.push(iq.subspan(pos, std::min(slice, iq.size() - pos)));
+        while (auto pkt = receiver.pull()) {
+            packets.push_back(std::move(*pkt));
+        }
+    }
+    receiver.finish();
+    while (auto pkt = receiver.pull()) {
+        packets.push_back(std::move(*pkt));
+    }
+    return packets;
+}
+
+bool same_packets(const std::vector<host_sim::ReceivedPacket>& a, const std::vector<host_sim::ReceivedPacket>& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].start != b[i].start || a[i].length != b[i].length || a[i].result.payload != b[i].result.payload ||
+            a[i].result.crc_ok != b[i].result.crc_ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int test_decodes_stream(const Stream& stream, const std::vector<host_sim::ReceivedPacket>& packets)
+{
+    int failures = 0;
+    if (packets.size() != kPackets) {
+        std::fprintf(stderr, "stream: %zu packets, expected %zu\n", packets.size(), kPackets);
+        return 1;
+    }
+    for (std::size_t i = 0; i < kPackets; ++i) {
+        const auto& pkt = packets[i];
+        if (!pkt.result.header_ok || !pkt.result.crc_ok || pkt.result.payload != stream.payloads[i]) {
+            std::fprintf(stderr, "stream: packet %zu not decoded (header %d crc %d)\n", i,
+                         pkt.result.header_ok, pkt.result.crc_ok);
+            ++failures;
+        }
+        // Positions are absolute stream indices, inside the packet's span.
+        const std::size_t end = i + 1 < kPackets ? stream.offsets[i + 1] : stream.iq.size();
+        if (pkt.burst != i || pkt.start < stream.offsets[i] || pkt.start >= end || pkt.sf != 8) {
+            std::fprintf(stderr, "stream: packet %zu at %zu (burst %llu), expected [%zu, %zu)\n", i, pkt.start,
+                         static_cast<unsigned long long>(pkt.burst), stream.offsets[i], end);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_slicing_and_threads(const Stream& stream, const std::vector<host_sim::ReceivedPacket>& reference)
+{
+    int failures = 0;
+    if (!same_packets(reference, receive(stream, stream.iq.size(), 0))) {
+        std::fprintf(stderr, "slicing: one push differs from 997-sample pushes\n");
+        ++failures;
+    }
+    if (!same_packets(reference, receive(stream, 5000, 2))) {
+        std::fprintf(stderr, "threads: 2 decoder threads differ from inline decoding\n");
+        ++failures;
+    }
+    return failures;
+}
+
+// Noisy SF9 packets with a large SFO at OS=1: several only decode through
+// the OS=2 fallback.
+std::vector<std::complex<float>> make_hard_stream()
+{
+    host_sim::tx::BatchOptions options;
+    options.packet.sf = 9;
+    options.packet.cr = 2;
+    options.channel.snr_db = -8.0f;
+    options.channel.sfo_ppm = 80.0f;
+    options.channel.cfo_hz = 300.0f;
+    options.count = 6;
+    options.payload_len = 24;
+    options.seed = 5;
+    std::vector<std::complex<float>> iq;
+    host_sim::tx::BatchGenerator(options).run([&](const host_sim::tx::BatchPacket& packet) {
+        iq.insert(iq.end(), packet.iq.begin(), packet.iq.end());
+    });
+    return iq;
+}
+
+struct EffortRun
+{
+    std::size_t clean{0};       // first decodes only
+    std::size_t os2{0};
+    std::size_t exhausted{0};
+    std::size_t recovered{0};
+    std::size_t above_tier{0};  // first decodes past the configured tier
+};
+
+EffortRun receive_with_effort(std::span<const std::complex<float>> iq, host_sim::lora_replay::DecodeEffort effort,
+                              double budget_ms, bool defer)
+{
+    auto config = make_config(0);
+    config.metadata.sf = 9;
+    config.metadata.payload_len = 24;
+    config.effort = effort;
+    config.decode_budget_ms = budget_ms;
+    config.defer_recovery = defer;
+    config.reports = false;
+    host_sim::Receiver receiver(config);
+    receiver.push(iq);
+    receiver.finish();
+    EffortRun run;
+    while (const auto pkt = receiver.pull()) {
+        const bool clean = pkt->result.header_ok && pkt->result.crc_ok;
+        if (pkt->recovered) {
+            run.recovered += clean ? 1 : 0;
+            continue;
+        }
+        run.clean += clean ? 1 : 0;
+        run.os2 += pkt->result.path == host_sim::lora_replay::DecodePath::os2 ? 1 : 0;
+        run.exhausted += pkt->result.budget_exhausted ? 1 : 0;
+        run.above_tier += pkt->result.effort > effort ? 1 : 0;
+    }
+    return run;
+}
+
+int test_effort_tiers()
+{
+    using host_sim::lora_replay::DecodeEffort;
+    int failures = 0;
+    const auto iq = make_hard_stream();
+    const auto standard = receive_with_effort(iq, DecodeEffort::standard, 0.0, false);
+    if (standard.os2 == 0 || standard.exhausted != 0 || standard.above_tier != 0) {
+        std::fprintf(stderr, "effort: standard decoded %zu via OS=2, %zu out of budget\n", standard.os2,
+                     standard.exhausted);
+        ++failures;
+    }
+    const auto fast = receive_with_effort(iq, DecodeEffort::fast, 0.0, true);
+    if (fast.os2 != 0 || fast.above_tier != 0 || fast.clean >= standard.clean) {
+        std::fprintf(stderr, "effort: fast escalated (%zu OS=2, %zu past the tier, %zu clean)\n", fast.os2,
+                     fast.above_tier, fast.clean);
+        ++failures;
+    }
+    // Recovery runs exhaustive, a superset of the standard search.
+    if (fast.clean + fast.recovered < standard.clean) {
+        std::fprintf(stderr, "effort: fast + recovery got %zu + %zu clean, standard %zu\n", fast.clean,
+                     fast.recovered, standard.clean);
+        ++failures;
+    }
+    // A 10 µs budget is gone before the first fallback.
+    const auto budget = receive_with_effort(iq, DecodeEffort::standard, 0.01, false);
+    if (budget.exhausted == 0 || budget.os2 != 0 || budget.recovered != 0) {
+        std::fprintf(stderr, "effort: budget did not stop escalation (%zu exhausted, %zu OS=2)\n", budget.exhausted,
+                     budget.os2);
+        ++failures;
+    }
+    return failures;
+}
+
+int test_incremental(const Stream& stream, const std::vector<host_sim::ReceivedPacket>& reference)
+{
+    int failures = 0;
+    auto config = make_config(0);
+    config.incremental = true;
+    host_sim::Receiver receiver(config);
+    // Quarter-symbol pushes; note how much input each packet waited for.
+    constexpr std::size_t kSps = 256;
+    const std::span<const std::complex<float>> iq(stream.iq);
+    std::vector<host_sim::ReceivedPacket> packets;
+    std::vector<std::size_t> pushed_at;
+    for (std::size_t pos = 0; pos < iq.size(); pos += kSps / 4) {
+        receiver.push(iq.subspan(pos, std::min(kSps / 4, iq.size() - pos)));
+        while (auto pkt = receiver.pull()) {
+            packets.push_back(std::move(*pkt));
+            pushed_at.push_back(std::min(pos + kSps / 4, iq.size()));
+        }
+    }
+    receiver.finish();
+    while (auto pkt = receiver.pull()) {
+        packets.push_back(std::move(*pkt));
+        pushed_at.push_back(iq.size());
+    }
+    if (packets.size() != reference.size() || receiver.stats().incremental_packets != kPackets) {
+        std::fprintf(stderr, "incremental: %zu packets, %llu decoded as they arrived\n", packets.size(),
+                     static_cast<unsigned long long>(receiver.stats().incremental_packets));
+        return 1;
+    }
+    for (std::size_t i = 0; i < packets.size(); ++i) {
+        const auto& pkt = packets[i];
+        if (!pkt.incremental || pkt.result.payload != reference[i].result.payload || !pkt.result.crc_ok ||
+            pkt.start != reference[i].start || pkt.burst != i) {
+            std::fprintf(stderr, "incremental: packet %zu differs from the whole-burst decode\n", i);
+            ++failures;
+        }
+        // Out with (about) its last symbol, which is where its span ends.
+        if (pushed_at[i] > stream.ends[i] + 2 * kSps || pkt.start + pkt.length > stream.ends[i] + kSps) {
+            std::fprintf(stderr, "incremental: packet %zu ending at %zu out after %zu samples, span to %zu\n", i,
+                         stream.ends[i], pushed_at[i], pkt.start + pkt.length);
+            ++failures;
+        }
+    }
+
+    // On the hard stream the failures fall back to whole-burst decodes,
+    // which get everything the plain receiver gets.
+    const auto iq_hard = make_hard_stream();
+    const auto plain = receive_with_effort(iq_hard, host_sim::lora_replay::DecodeEffort::standard, 0.0, false);
+    auto hard = make_config(0);
+    hard.metadata.sf = 9;
+    hard.metadata.payload_len = 24;
+    hard.reports = false;
+    hard.incremental = true;
+    host_sim::Receiver hard_receiver(hard);
+    hard_receiver.push(iq_hard);
+    hard_receiver.finish();
+    std::size_t clean = 0;
+    while (const auto pkt = hard_receiver.pull()) {
+        clean += pkt->result.header_ok && pkt->result.crc_ok ? 1 : 0;
+    }
+    if (hard_receiver.stats().incremental_fallbacks == 0 || clean < plain.clean) {
+        std::fprintf(stderr, "incremental: %llu fallbacks, %zu clean against %zu\n",
+                     static_cast<unsigned long long>(hard_receiver.stats().incremental_fallbacks), clean, plain.clean);
+        ++failures;
+    }
+
+    auto multi = make_config(0);
+    multi.multi_sf = true;
+    multi.incremental = true;
+    try {
+        host_sim::Receiver rejected(multi);
+        std::fprintf(stderr, "incremental: accepted with multi_sf\n");
+        ++failures;
+    } catch (const std::runtime_error&) {
+    }
+    return failures;
+}
+
+// Two SF8 packets on one channel: the second, 6 dB weaker and 1.5 kHz
+// off, starts in the first one's data, so the detector sees one burst.
+struct Collision
+{
+    std::vector<std::complex<float>> iq;
+    std::vector<std::vector<uint8_t>> payloads;
+};
+
+Collision make_collision()
+{
+    host_sim::tx::PacketParams params;
+    params.sf = 8;
+    params.cr = 2;
+    Collision c;
+    c.payloads = {{'s', 't', 'r', 'o', 'n', 'g', '-', 'p', 'k', 't'}, {'w', 'e', 'a', 'k', '-', 'p', 'a', 'c', 'k', 't'}};
+    auto strong = host_sim::tx::modulate_packet(8, 1, params.sync_word, params.preamble_len,
+                                                host_sim::tx::encode_packet_symbols(params, c.payloads[0]));
+    auto weak = host_sim::tx::modulate_packet(8, 1, params.sync_word, params.preamble_len,
+                                              host_sim::tx::encode_packet_symbols(params, c.payloads[1]));
+    host_sim::tx::apply_cfo(weak, 1500.0, params.sample_rate);
+    const std::size_t delay = 21 * 256 + 97;
+    c.iq.assign(strong.size() + delay, {});
+    for (std::size_t i = 0; i < strong.size(); ++i) {
+        c.iq[i] += strong[i];
+    }
+    for (std::size_t i = 0; i < weak.size(); ++i) {
+        c.iq[delay + i] += 0.5f * weak[i];
+    }
+    host_sim::tx::add_awgn(c.iq, 20.0f, host_sim::tx::CounterRng::stream(3, 0));
+    return c;
+}
+
+std::vector<host_sim::ReceivedPacket> receive_collision(const Collision& c, int cancel)
+{
+    auto config = make_config(0);
+    config.cancel_collisions = cancel;
+    host_sim::Receiver receiver(config);
+    receiver.push(c.iq);
+    receiver.finish();
+    std::vector<host_sim::ReceivedPacket> packets;
+    while (auto pkt = receiver.pull()) {
+        if (pkt->result.header_ok && pkt->result.crc_ok) {
+            packets.push_back(std::move(*pkt));
+        }
+    }
+    return packets;
+}
+
+int test_collisions()
+{
+    int failures = 0;
+    const auto c = make_collision();
+    const auto plain = receive_collision(c, 0);
+    if (plain.size() != 1 || plain.front().result.payload != c.payloads[0]) {
+        std::fprintf(stderr, "collision: %zu clean packet(s) without cancellation, expected the strong one\n",
+                     plain.size());
+        ++failures;
+    }
+    const auto cancelled = receive_collision(c, 2);
+    if (cancelled.size() != 2) {
+        std::fprintf(stderr, "collision: %zu clean packet(s) with cancellation, expected 2\n", cancelled.size());
+        return failures + 1;
+    }
+    // Stream order: the strong packet first, the weak one found after it.
+    for (std::size_t i = 0; i < 2; ++i) {
+        if (cancelled[i].result.payload != c.payloads[i] || cancelled[i].cancelled != static_cast<int>(i) ||
+            cancelled[i].burst != 0) {
+            std::fprintf(stderr, "collision: packet %zu wrong (cancelled %d, burst %llu)\n", i,
+                         cancelled[i].cancelled, static_cast<unsigned long long>(cancelled[i].burst));
+            ++failures;
+        }
+    }
+
+    auto multi = make_config(0);
+    multi.multi_sf = true;
+    multi.cancel_collisions = 1;
+    try {
+        host_sim::Receiver rejected(multi);
+        std::fprintf(stderr, "collision: accepted with multi_sf\n");
+        ++failures;
+    } catch (const std::runtime_error&) {
+    }
+    return failures;
+}
+
+int test_push_after_finish()
+{
+    host_sim::Receiver receiver(make_config(0));
+    receiver.finish();
+    const std::vector<std::complex<float>> iq(16);
+    try {
+        receiver.push(iq);
+    } catch (const std::runtime_error&) {
+        return 0;
+    }
+    std::fprintf(stderr, "finish: push() after finish() accepted\n");
+    return 1;
+}
+
+} // namespace
+
+int main()
+{
+    const Stream stream = make_stream();
+    const auto reference = receive(stream, 997, 0);
+    int failures = 0;
+    failures += test_decodes_stream(stream, reference);
+    failures += test_slicing_and_threads(stream, reference);
+    failures += test_effort_tiers();
+    failures += test_incremental(stream, reference);
+    failures += test_collisions();
+    failures += test_push_after_finish();
+    std::printf("Receiver test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -1,3 +1,5 @@
+#include "alloc_counter.hpp"
+
 #include "host_sim/alignment.hpp"
 #include "host_sim/capture.hpp"
 #include "host_sim/lora_params.hpp"
@@ -60,12 +62,22 @@ private:
     std::size_t index_{0};
 };
 
+// Collects demodulated symbols and samples the allocation counter at
+// each symbol; both vectors are reserved up front so the collector
+// itself adds nothing to the count.
 class CollectorStage : public host_sim::Stage
 {
 public:
+    explicit CollectorStage(std::size_t capacity)
+    {
+        symbols_.reserve(capacity);
+        allocations_.reserve(capacity);
+    }
+
     void reset(const host_sim::StageConfig&) override
     {
         symbols_.clear();
+        allocations_.clear();
     }
 
     void process(host_sim::SymbolContext& context) override
@@ -73,14 +85,26 @@ public:
         if (context.has_demod_symbol) {
             symbols_.push_back(context.demod_symbol);
         }
+        allocations_.push_back(alloc_counter::count());
     }
 
     void flush() override {}
 
     const std::vector<uint16_t>& symbols() const { return symbols_; }
 
+    /// Heap allocations per symbol after the first (steady state).
+    double allocations_per_symbol() const
+    {
+        if (allocations_.size() < 2) {
+            return 0.0;
+        }
+        return static_cast<double>(allocations_.back() - allocations_.front()) /
+               static_cast<double>(allocations_.size() - 1);
+    }
+
 private:
     std::vector<uint16_t> symbols_;
+    std::vector<std::size_t> allocations_;
 };
 
 std::size_t compute_samples_per_symbol(const host_sim::LoRaMetadata& meta)
@@ -122,17 +146,35 @@ int main()
     scheduler.configure({meta.sf, meta.bw, meta.sample_rate});
 
     auto demod_stage = std::make_shared<host_sim::DemodStage>();
-    auto collector = std::make_shared<CollectorStage>();
+    auto collector = std::make_shared<CollectorStage>(symbol_count);
 
     scheduler.attach_stage(demod_stage);
     scheduler.attach_stage(collector);
 
+    // Owning source first, then the lending one, which must agree
+    // symbol-for-symbol without allocating.
+    double owning_allocs = 0.0;
+    std::vector<uint16_t> owning_symbols;
     try {
         scheduler.run(source);
+        owning_allocs = collector->allocations_per_symbol();
+        owning_symbols = collector->symbols();
+        host_sim::SpanSymbolSource span_source(samples, alignment_offset, samples_per_symbol, symbol_count);
+        scheduler.run(span_source);
     } catch (const std::exception& ex) {
         std::cerr << "Scheduler run failed: " << ex.what() << "\n";
         return 1;
     }
+    std::cout << "Allocations per symbol: owning source " << owning_allocs
+              << ", span source " << collector->allocations_per_symbol() << "\n";
+    if (collector->symbols() != owning_symbols) {
+        std::cerr << "Span source symbols differ from the owning source\n";
+        return 1;
+    }
+    if (collector->allocations_per_symbol() != 0.0) {
+        std::cerr << "Span source allocated in steady state\n";
+        return 1;
+    }
 
     host_sim::FftDemodReference demod_reference(meta.sf, meta.sample_rate, meta.bw);
     std::vector<uint16_t> reference;
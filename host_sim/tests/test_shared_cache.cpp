@@ -0,0 +1,128 @@
+/// test_shared_cache.cpp — Verify the process-wide chirp-table cache:
+/// repeated and concurrent requests for one (sf, os) return the same
+/// immutable tables, matching build_chirps(); demodulators of one
+/// configuration share them instead of rebuilding; and float and Q15
+/// demodulators built from the cache still decode.
+
+#include "host_sim/chirp.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/fft_demod_q15.hpp"
+#include "host_sim/shared_cache.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+int test_cache_basics()
+{
+    int failures = 0;
+    host_sim::SharedCache<int, int> cache;
+    int builds = 0;
+    const auto a = cache.get(3, [&] { ++builds; return std::make_shared<const int>(30); });
+    const auto b = cache.get(3, [&] { ++builds; return std::make_shared<const int>(31); });
+    if (a != b || *a != 30 || builds != 1 || cache.size() != 1) {
+        std::fprintf(stderr, "cache: second get() rebuilt or returned a different value\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_shared_chirps()
+{
+    int failures = 0;
+    const auto first = host_sim::shared_chirps(9, 2);
+    const auto reference = host_sim::build_chirps(9, 2);
+    if (first->upchirp != reference.upchirp || first->downchirp != reference.downchirp) {
+        std::fprintf(stderr, "shared_chirps: contents differ from build_chirps\n");
+        ++failures;
+    }
+
+    constexpr int kThreads = 4;
+    std::vector<std::shared_ptr<const host_sim::ChirpTables>> seen(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&seen, t] { seen[static_cast<std::size_t>(t)] = host_sim::shared_chirps(9, 2); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& tables : seen) {
+        if (tables != first) {
+            std::fprintf(stderr, "shared_chirps: a thread got a different copy\n");
+            ++failures;
+        }
+    }
+
+    const auto q15 = host_sim::shared_chirps_q15(9, 2);
+    if (q15 != host_sim::shared_chirps_q15(9, 2) || q15->upchirp.size() != reference.upchirp.size()) {
+        std::fprintf(stderr, "shared_chirps_q15: not shared\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_demodulators_share()
+{
+    int failures = 0;
+    constexpr int kSf = 12;
+    constexpr int kBw = 125000;
+    constexpr int kFs = 250000;
+
+    host_sim::FftDemodulator first(kSf, kFs, kBw);
+    const std::size_t cached = host_sim::shared_chirp_cache_size();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 50; ++i) {
+        host_sim::FftDemodulator again(kSf, kFs, kBw);
+        host_sim::FftDemodulatorQ15 again_q15(kSf, kFs, kBw);
+        if (&again.chirps() != &first.chirps()) {
+            std::fprintf(stderr, "demod: instance %d rebuilt its chirps\n", i);
+            ++failures;
+            break;
+        }
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (host_sim::shared_chirp_cache_size() != cached + 1) {
+        std::fprintf(stderr, "demod: cache grew from %zu to %zu\n", cached, host_sim::shared_chirp_cache_size());
+        ++failures;
+    }
+    std::printf("  SF%d construction (float + Q15): %.1f us per pair\n", kSf, us / 50.0);
+
+    // Decode one symbol with two demods sharing tables and plans.
+    constexpr int os = kFs / kBw;
+    const int sps = (1 << kSf) * os;
+    const auto& base = host_sim::shared_chirps(kSf, os)->upchirp;
+    constexpr int kValue = 1234;
+    std::vector<std::complex<float>> symbol(static_cast<std::size_t>(sps));
+    std::vector<host_sim::Q15Complex> symbol_q15(symbol.size());
+    for (int i = 0; i < sps; ++i) {
+        const auto s = 0.5f * base[static_cast<std::size_t>((i + kValue * os) % sps)];
+        symbol[static_cast<std::size_t>(i)] = s;
+        symbol_q15[static_cast<std::size_t>(i)] = host_sim::float_to_q15_complex(s.real(), s.imag());
+    }
+    host_sim::FftDemodulatorQ15 q15_a(kSf, kFs, kBw);
+    host_sim::FftDemodulatorQ15 q15_b(kSf, kFs, kBw);
+    if (first.demodulate(symbol.data()) != kValue || q15_a.demodulate(symbol_q15.data()) != kValue ||
+        q15_b.demodulate(symbol_q15.data()) != kValue) {
+        std::fprintf(stderr, "demod: symbol %d not recovered with shared tables\n", kValue);
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_cache_basics();
+    failures += test_shared_chirps();
+    failures += test_demodulators_share();
+
+    std::printf("Shared cache test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/// test_soft_pipeline.cpp — Verify the fixed-size soft path: one-pass
+/// pyramid LLRs equal the per-bit max-log scan for every SF, CFO and
+/// header/LDRO mapping, the array-based deinterleave/decode matches the
+/// vector API, and decoding a block makes no heap allocations.
+
+#include "alloc_counter.hpp"
+
+#include "host_sim/soft_decode.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// The O(sf·N) scan the pyramid replaced.
+std::vector<float> llrs_scan(const std::vector<float>& mag, int sf, bool reduced, int cfo_int)
+{
+    const int N = 1 << sf;
+    const int sf_app = reduced ? sf - 2 : sf;
+    const int divider = reduced ? 4 : 1;
+    std::vector<float> one(sf_app, -std::numeric_limits<float>::infinity());
+    std::vector<float> zero(sf_app, -std::numeric_limits<float>::infinity());
+    for (int n = 0; n < N; ++n) {
+        const auto s = static_cast<uint16_t>(((n - cfo_int - 1 + 2 * N) % N) / divider);
+        const auto gray = static_cast<uint16_t>(s ^ (s >> 1));
+        for (int bit = 0; bit < sf_app; ++bit) {
+            auto& slot = ((gray >> (sf_app - 1 - bit)) & 1) ? one[bit] : zero[bit];
+            slot = std::max(slot, mag[n]);
+        }
+    }
+    std::vector<float> out(sf_app);
+    for (int bit = 0; bit < sf_app; ++bit) {
+        out[bit] = one[bit] - zero[bit];
+    }
+    return out;
+}
+
+int test_llrs(std::mt19937& rng)
+{
+    std::exponential_distribution<float> power(1.0f);
+    for (int sf = 5; sf <= 12; ++sf) {
+        const int N = 1 << sf;
+        std::uniform_int_distribution<int> cfo(-N / 2, N / 2);
+        for (int trial = 0; trial < 20; ++trial) {
+            std::vector<float> mag(static_cast<std::size_t>(N));
+            for (auto& m : mag) {
+                m = power(rng);
+            }
+            const int c = trial == 0 ? 0 : cfo(rng);
+            for (const bool reduced : {false, true}) {
+                if (reduced && sf < 7) {
+                    continue;
+                }
+                const auto ref = llrs_scan(mag, sf, reduced, c);
+                const auto fixed = host_sim::compute_soft_symbol(mag.data(), sf, reduced, c);
+                const auto vec = host_sim::compute_symbol_llrs(mag.data(), sf, reduced, c);
+                if (vec != ref || !std::equal(ref.begin(), ref.end(), fixed.begin())) {
+                    std::fprintf(stderr, "sf%d cfo %d reduced %d: LLRs differ from the scan\n", sf, c, reduced);
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int test_block(std::mt19937& rng)
+{
+    std::normal_distribution<float> noise(0.0f, 3.0f);
+    for (int sf = 7; sf <= 12; ++sf) {
+        for (int cr = 1; cr <= 4; ++cr) {
+            for (const bool is_header : {false, true}) {
+                const bool ldro = sf >= 11;
+                const int sf_app = (is_header || ldro) ? sf - 2 : sf;
+                const int cw_len = is_header ? 8 : cr + 4;
+                std::vector<host_sim::SymbolLLR> vec(static_cast<std::size_t>(cw_len));
+                std::vector<host_sim::SoftSymbol> fixed(static_cast<std::size_t>(cw_len));
+                for (int i = 0; i < cw_len; ++i) {
+                    vec[i].resize(static_cast<std::size_t>(sf_app));
+                    for (int j = 0; j < sf_app; ++j) {
+                        vec[i][j] = fixed[i][j] = noise(rng);
+                    }
+                }
+                std::size_t consumed_vec = 0;
+                std::size_t consumed = 0;
+                const auto ref = host_sim::soft_decode_block(vec, sf, cr, is_header, ldro, consumed_vec);
+
+                uint8_t nibbles[host_sim::kMaxSoftBits];
+                const auto before = alloc_counter::count();
+                const auto n = host_sim::soft_decode_block(fixed.data(), fixed.size(), sf, cr, is_header,
+                                                           ldro, nibbles, consumed);
+                const auto allocations = alloc_counter::count() - before;
+                if (n != ref.size() || !std::equal(ref.begin(), ref.end(), nibbles) ||
+                    consumed != consumed_vec || allocations != 0) {
+                    std::fprintf(stderr, "sf%d cr%d hdr%d: block differs (%zu allocations)\n", sf, cr,
+                                 is_header, allocations);
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int test_no_allocations()
+{
+    std::vector<float> mag(4096, 0.25f);
+    mag[1234] = 9.0f;
+    const auto before = alloc_counter::count();
+    float sink = 0.0f;
+    for (int k = 0; k < 100; ++k) {
+        sink += host_sim::compute_soft_symbol(mag.data(), 12, k % 2 == 0, k)[0];
+    }
+    const auto allocations = alloc_counter::count() - before;
+    if (allocations != 0 || sink == 0.0f) {
+        std::fprintf(stderr, "compute_soft_symbol: %zu allocations\n", allocations);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    std::mt19937 rng(19);
+    failures += test_llrs(rng);
+    failures += test_block(rng);
+    failures += test_no_allocations();
+
+    std::printf("Soft pipeline test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
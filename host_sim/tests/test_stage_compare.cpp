@@ -0,0 +1,156 @@
+/// test_stage_compare.cpp — Verify compare_stage against the exhaustive
+/// offset search it replaces: same offset (earliest on ties), mismatch
+/// count and first difference for exact matches, near matches, periodic
+/// data and unrelated data, with either side the longer one.
+
+#include "host_sim/lora_replay/stage_processing.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using host_sim::lora_replay::StageComparisonResult;
+
+// The original brute-force search: full count at every offset.
+StageComparisonResult brute_force(const std::vector<std::uint16_t>& host, const std::vector<long long>& reference)
+{
+    StageComparisonResult result;
+    result.host_count = host.size();
+    result.ref_count = reference.size();
+    const bool host_is_longer = host.size() >= reference.size();
+    const std::size_t len = host_is_longer ? reference.size() : host.size();
+    const std::size_t max_offset = (host_is_longer ? host.size() : reference.size()) - len;
+    std::size_t best = std::numeric_limits<std::size_t>::max();
+    for (std::size_t offset = 0; offset <= max_offset; ++offset) {
+        const std::size_t hs = host_is_longer ? offset : 0;
+        const std::size_t rs = host_is_longer ? 0 : offset;
+        std::size_t mismatches = 0;
+        std::optional<std::size_t> first;
+        for (std::size_t i = 0; i < len; ++i) {
+            if (static_cast<long long>(host[hs + i]) != reference[rs + i]) {
+                if (!first) {
+                    first = i;
+                }
+                ++mismatches;
+            }
+        }
+        if (mismatches < best) {
+            best = mismatches;
+            result.mismatches = mismatches;
+            result.alignment_offset = offset;
+            result.first_diff_index = first;
+            result.host_value.reset();
+            result.ref_value.reset();
+            if (first) {
+                result.host_value = host[hs + *first];
+                result.ref_value = reference[rs + *first];
+            }
+            if (best == 0) {
+                break;
+            }
+        }
+    }
+    result.alignment_relative_to_reference = !host_is_longer;
+    return result;
+}
+
+int check(const char* name, const std::vector<std::uint16_t>& host, const std::vector<long long>& reference)
+{
+    const auto expected = brute_force(host, reference);
+    const auto actual = host_sim::lora_replay::compare_stage(name, host, reference);
+    if (actual.mismatches != expected.mismatches || actual.alignment_offset != expected.alignment_offset ||
+        actual.alignment_relative_to_reference != expected.alignment_relative_to_reference ||
+        actual.first_diff_index != expected.first_diff_index || actual.host_value != expected.host_value ||
+        actual.ref_value != expected.ref_value || actual.host_count != expected.host_count ||
+        actual.ref_count != expected.ref_count) {
+        std::fprintf(stderr, "%s (host %zu, ref %zu): offset %zu mismatches %zu, expected %zu and %zu\n", name,
+                     host.size(), reference.size(), actual.alignment_offset.value_or(0), actual.mismatches,
+                     expected.alignment_offset.value_or(0), expected.mismatches);
+        return 1;
+    }
+    return 0;
+}
+
+int test_against_brute_force()
+{
+    int failures = 0;
+    std::mt19937 rng(7);
+    for (int trial = 0; trial < 400; ++trial) {
+        const int alphabet = trial % 4 == 0 ? 2 : trial % 4 == 1 ? 4 : 256;
+        std::uniform_int_distribution<int> value(0, alphabet - 1);
+        std::uniform_int_distribution<std::size_t> length(1, 120);
+        const std::size_t long_len = length(rng) + 20;
+        const std::size_t short_len = std::min(long_len, length(rng));
+        std::vector<long long> longer(long_len);
+        for (auto& v : longer) {
+            v = value(rng);
+        }
+        // Cut the shorter side out of the longer one, then corrupt some of it.
+        const std::size_t cut = std::uniform_int_distribution<std::size_t>(0, long_len - short_len)(rng);
+        std::vector<long long> shorter(longer.begin() + static_cast<std::ptrdiff_t>(cut),
+                                       longer.begin() + static_cast<std::ptrdiff_t>(cut + short_len));
+        const int flips = trial % 3 == 0 ? 0 : trial % 3 == 1 ? 1 : static_cast<int>(short_len / 3);
+        for (int f = 0; f < flips; ++f) {
+            shorter[std::uniform_int_distribution<std::size_t>(0, short_len - 1)(rng)] = value(rng);
+        }
+        if (trial % 8 == 7) {
+            for (auto& v : shorter) {
+                v = value(rng);   // unrelated data
+            }
+        }
+        const std::vector<std::uint16_t> as_host_long(longer.begin(), longer.end());
+        const std::vector<std::uint16_t> as_host_short(shorter.begin(), shorter.end());
+        const std::string name = "trial " + std::to_string(trial);
+        failures += check(name.c_str(), as_host_long, shorter);
+        failures += check(name.c_str(), as_host_short, longer);
+    }
+    return failures;
+}
+
+int test_periodic_and_edges()
+{
+    int failures = 0;
+    std::vector<long long> periodic(300);
+    for (std::size_t i = 0; i < periodic.size(); ++i) {
+        periodic[i] = static_cast<long long>(i % 5);
+    }
+    // Every shift by a multiple of five fits exactly; the earliest must win.
+    std::vector<std::uint16_t> window(periodic.begin() + 12, periodic.begin() + 112);
+    failures += check("periodic exact", window, periodic);
+    window[40] = 9;
+    failures += check("periodic near", window, periodic);
+    failures += check("equal length", std::vector<std::uint16_t>{1, 2, 3, 4}, {1, 2, 0, 4});
+    failures += check("single", std::vector<std::uint16_t>{3}, {5, 4, 3, 3});
+    failures += check("constant", std::vector<std::uint16_t>(50, 0), std::vector<long long>(80, 1));
+
+    // A long multi-packet reference against one packet of host output.
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> bin(0, 511);
+    std::vector<long long> dump(20000);
+    for (auto& v : dump) {
+        v = bin(rng);
+    }
+    std::vector<std::uint16_t> packet(dump.begin() + 15000, dump.begin() + 15400);
+    packet[3] = 600;
+    packet[399] = 601;
+    failures += check("long dump", packet, dump);
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_against_brute_force();
+    failures += test_periodic_and_edges();
+    std::printf("Stage compare test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
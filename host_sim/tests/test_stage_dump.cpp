@@ -0,0 +1,195 @@
+/// test_stage_dump.cpp — Verify binary stage dumps: raw and delta-varint
+/// files round-trip at the narrowest width, a mapped dump compares exactly
+/// like the parsed text dump, compare_with_reference prefers a .stage file
+/// over the .txt one, and malformed files are rejected.
+
+#include "host_sim/lora_replay/stage_dump.hpp"
+#include "host_sim/lora_replay/stage_processing.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+using host_sim::lora_replay::StageDump;
+using host_sim::lora_replay::StageEncoding;
+
+const auto kDir = std::filesystem::temp_directory_path();
+
+template <typename Value>
+int check_round_trip(const char* name, const std::vector<Value>& values, int expected_width)
+{
+    int failures = 0;
+    for (const auto encoding : {StageEncoding::raw, StageEncoding::delta_varint}) {
+        const auto path = kDir / (std::string("host_sim_stage_dump_") + name + ".stage");
+        host_sim::lora_replay::write_stage_dump(path, values, encoding);
+        const StageDump dump(path);
+        const char* mode = encoding == StageEncoding::raw ? "raw" : "delta";
+        if (dump.size() != values.size() || dump.width() != expected_width || dump.encoding() != encoding) {
+            std::fprintf(stderr, "%s/%s: %zu values of width %d\n", name, mode, dump.size(), dump.width());
+            ++failures;
+            continue;
+        }
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (dump[i] != static_cast<long long>(values[i])) {
+                std::fprintf(stderr, "%s/%s: value %zu is %lld, wrote %lld\n", name, mode, i, dump[i],
+                             static_cast<long long>(values[i]));
+                ++failures;
+                break;
+            }
+        }
+        std::filesystem::remove(path);
+    }
+    return failures;
+}
+
+int test_round_trip()
+{
+    int failures = 0;
+    failures += check_round_trip("u8", std::vector<std::uint8_t>{0, 15, 3, 255, 7}, 1);
+    failures += check_round_trip("u16", std::vector<std::uint16_t>{511, 0, 4095, 17, 256}, 2);
+    failures += check_round_trip("empty", std::vector<std::uint16_t>{}, 1);
+    failures += check_round_trip("s8", std::vector<long long>{-128, 127, 0, -1}, 1);
+    failures += check_round_trip("s32", std::vector<long long>{-40000, 3, 2147483647}, 4);
+    failures += check_round_trip(
+        "s64", std::vector<long long>{std::numeric_limits<long long>::min(), 0,
+                                      std::numeric_limits<long long>::max(), -5},
+        8);
+
+    // Slowly varying values pack to about a byte each.
+    std::vector<std::uint16_t> ramp(1000);
+    for (std::size_t i = 0; i < ramp.size(); ++i) {
+        ramp[i] = static_cast<std::uint16_t>(1000 + i);
+    }
+    const auto packed = host_sim::lora_replay::encode_stage_dump(ramp, StageEncoding::delta_varint);
+    const auto raw = host_sim::lora_replay::encode_stage_dump(ramp, StageEncoding::raw);
+    if (raw.size() != host_sim::lora_replay::kStageDumpHeaderBytes + 2 * ramp.size() ||
+        packed.size() > host_sim::lora_replay::kStageDumpHeaderBytes + ramp.size() + 1) {
+        std::fprintf(stderr, "ramp: raw %zu bytes, delta %zu bytes\n", raw.size(), packed.size());
+        ++failures;
+    }
+    return failures;
+}
+
+int test_compare_matches_text()
+{
+    int failures = 0;
+    const std::vector<std::uint16_t> host = {9, 1, 2, 3, 4, 5, 6, 7};
+    const std::vector<std::uint16_t> reference = {1, 2, 3, 40, 5, 6, 7};
+    const auto txt = kDir / "host_sim_stage_dump_cmp.txt";
+    const auto bin = kDir / "host_sim_stage_dump_cmp.stage";
+    host_sim::lora_replay::write_stage_file(txt, reference);
+    host_sim::lora_replay::write_stage_dump(bin, reference, StageEncoding::delta_varint);
+
+    const auto from_text =
+        host_sim::lora_replay::compare_stage("FFT", host, host_sim::lora_replay::read_stage_file(txt));
+    const auto from_dump = host_sim::lora_replay::compare_stage("FFT", host, StageDump(bin));
+    if (from_dump.mismatches != from_text.mismatches || from_dump.ref_count != from_text.ref_count ||
+        from_dump.alignment_offset != from_text.alignment_offset ||
+        from_dump.first_diff_index != from_text.first_diff_index || from_dump.host_value != from_text.host_value ||
+        from_dump.ref_value != from_text.ref_value || from_dump.mismatches != 1) {
+        std::fprintf(stderr, "mapped comparison: %zu mismatches (text: %zu)\n", from_dump.mismatches,
+                     from_text.mismatches);
+        ++failures;
+    }
+    std::filesystem::remove(txt);
+    std::filesystem::remove(bin);
+    return failures;
+}
+
+int test_reference_prefers_binary()
+{
+    int failures = 0;
+    host_sim::lora_replay::StageOutputs outputs;
+    outputs.fft = {10, 20, 30};
+    outputs.gray = {1, 2};
+    outputs.deinterleaver = {3};
+    outputs.hamming = {4, 5};
+    const auto base = kDir / "host_sim_stage_dump_ref";
+    auto stage_path = [&](const char* suffix) {
+        auto path = base;
+        path += suffix;
+        return path;
+    };
+    // The text FFT dump disagrees everywhere; the binary one matches.
+    host_sim::lora_replay::write_stage_file(stage_path("_fft.txt"), std::vector<int>{7, 7, 7});
+    host_sim::lora_replay::write_stage_dump(stage_path("_fft.stage"), outputs.fft);
+    host_sim::lora_replay::write_stage_file(stage_path("_gray.txt"), outputs.gray);
+    host_sim::lora_replay::write_stage_dump(stage_path("_hamming.stage"), outputs.hamming,
+                                            StageEncoding::delta_varint);
+
+    auto cf32 = base;
+    cf32 += ".cf32";
+    const auto results = host_sim::lora_replay::compare_with_reference(outputs, cf32);
+    if (results.size() != 4 || results[0].mismatches != 0 || results[0].ref_count != 3 ||
+        results[1].mismatches != 0 || !results[2].reference_missing || results[3].mismatches != 0 ||
+        results[3].ref_count != 2) {
+        std::fprintf(stderr, "compare_with_reference did not pick the .stage dumps\n");
+        ++failures;
+    }
+    for (const char* suffix : {"_fft.txt", "_fft.stage", "_gray.txt", "_hamming.stage"}) {
+        std::filesystem::remove(stage_path(suffix));
+    }
+    return failures;
+}
+
+int test_malformed()
+{
+    int failures = 0;
+    const auto path = kDir / "host_sim_stage_dump_bad.stage";
+    const auto good = host_sim::lora_replay::encode_stage_dump(std::vector<std::uint16_t>{300, 301, 5000},
+                                                               StageEncoding::delta_varint);
+    std::string bad_magic = good;
+    bad_magic[0] = 'X';
+    std::string bad_width = good;
+    bad_width[6] = 3;
+    const std::string truncated = good.substr(0, good.size() - 1);
+    const std::string trailing = good + '\0';
+    const std::string header_only = good.substr(0, 10);
+    std::string raw_short = host_sim::lora_replay::encode_stage_dump(std::vector<std::uint16_t>{1, 2});
+    raw_short.pop_back();
+
+    const std::pair<const char*, std::string> cases[] = {
+        {"bad magic", bad_magic},   {"bad width", bad_width},     {"truncated varint", truncated},
+        {"trailing bytes", trailing}, {"short header", header_only}, {"short raw body", raw_short},
+        {"empty file", std::string()},
+    };
+    for (const auto& [name, bytes] : cases) {
+        host_sim::lora_replay::write_stage_bytes(path, bytes);
+        try {
+            const StageDump dump(path);
+            std::fprintf(stderr, "%s: accepted\n", name);
+            ++failures;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    std::filesystem::remove(path);
+    try {
+        const StageDump dump(path);
+        std::fprintf(stderr, "missing file: accepted\n");
+        ++failures;
+    } catch (const std::runtime_error&) {
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_round_trip();
+    failures += test_compare_matches_text();
+    failures += test_reference_prefers_binary();
+    failures += test_malformed();
+    std::printf("Stage dump test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+/// test_symbol_source.cpp — Verify the lending SymbolSource path:
+/// SpanSymbolSource views point into the capture (float and Q15), stop at
+/// the last whole symbol, legacy next_symbol() sources still drive the
+/// scheduler, and Scheduler::run / run_realtime over a span source make
+/// zero heap allocations per symbol once running.
+
+#include "alloc_counter.hpp"
+
+#include "host_sim/chirp.hpp"
+#include "host_sim/scheduler.hpp"
+#include "host_sim/stages/demod_stage.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+constexpr int kSf = 7;
+constexpr int kBw = 125000;
+constexpr int kFs = 500000;
+constexpr std::size_t kSps = (std::size_t{1} << kSf) * (kFs / kBw);
+constexpr std::size_t kSymbols = 64;
+
+// Owning source that only implements next_symbol(), as older sources do.
+class CopyingSource : public host_sim::SymbolSource
+{
+public:
+    explicit CopyingSource(const std::vector<std::complex<float>>& samples) : samples_(samples) {}
+
+    void reset() override { index_ = 0; }
+
+    std::optional<host_sim::SymbolBuffer> next_symbol() override
+    {
+        if ((index_ + 1) * kSps > samples_.size()) {
+            return std::nullopt;
+        }
+        host_sim::SymbolBuffer buffer;
+        buffer.samples.assign(samples_.begin() + static_cast<std::ptrdiff_t>(index_ * kSps),
+                              samples_.begin() + static_cast<std::ptrdiff_t>((index_ + 1) * kSps));
+        ++index_;
+        return buffer;
+    }
+
+private:
+    const std::vector<std::complex<float>>& samples_;
+    std::size_t index_{0};
+};
+
+// Records demodulated symbols and the running allocation count into
+// storage reserved up front, so the probe itself never allocates.
+class ProbeStage : public host_sim::Stage
+{
+public:
+    ProbeStage()
+    {
+        symbols.reserve(kSymbols);
+        allocations.reserve(kSymbols);
+    }
+
+    void reset(const host_sim::StageConfig&) override
+    {
+        symbols.clear();
+        allocations.clear();
+    }
+
+    void process(host_sim::SymbolContext& context) override
+    {
+        symbols.push_back(context.demod_symbol);
+        allocations.push_back(alloc_counter::count());
+    }
+
+    void flush() override {}
+
+    std::size_t steady_state_allocations() const
+    {
+        return allocations.size() < 2 ? 0 : allocations.back() - allocations[1];
+    }
+
+    std::vector<uint16_t> symbols;
+    std::vector<std::size_t> allocations;
+};
+
+std::vector<std::complex<float>> make_capture(std::vector<uint16_t>& expected)
+{
+    constexpr std::size_t os = kFs / kBw;
+    const auto chirps = host_sim::build_chirps(kSf, static_cast<int>(os));
+    std::vector<std::complex<float>> capture;
+    for (std::size_t k = 0; k < kSymbols; ++k) {
+        const auto value = static_cast<uint16_t>((k * 37 + 5) % (1u << kSf));
+        expected.push_back(value);
+        for (std::size_t i = 0; i < kSps; ++i) {
+            capture.push_back(0.5f * chirps.upchirp[(i + value * os) % kSps]);
+        }
+    }
+    return capture;
+}
+
+int test_views()
+{
+    int failures = 0;
+    std::vector<std::complex<float>> capture(10 * kSps + 17);
+    for (std::size_t i = 0; i < capture.size(); ++i) {
+        capture[i] = {static_cast<float>(i), 0.0f};
+    }
+    host_sim::SpanSymbolSource source(capture, 17, kSps, 100);
+    if (source.symbol_count() != 10) {
+        std::fprintf(stderr, "views: %zu symbols fit, expected 10\n", source.symbol_count());
+        ++failures;
+    }
+    std::size_t k = 0;
+    while (const auto view = source.next_view()) {
+        if (view->samples.data() != capture.data() + 17 + k * kSps || view->samples.size() != kSps ||
+            !view->samples_q15.empty()) {
+            std::fprintf(stderr, "views: symbol %zu is not a view into the capture\n", k);
+            ++failures;
+        }
+        ++k;
+    }
+    source.reset();
+    const auto copy = source.next_symbol();
+    if (!copy || copy->samples.size() != kSps || copy->samples[0].real() != 17.0f) {
+        std::fprintf(stderr, "views: copying fallback wrong\n");
+        ++failures;
+    }
+
+    std::vector<host_sim::Q15Complex> q15(3 * kSps);
+    host_sim::SpanSymbolSource q15_source(std::span<const host_sim::Q15Complex>(q15), 0, kSps, 3);
+    const auto qv = q15_source.next_view();
+    if (!qv || qv->samples_q15.data() != q15.data() || !qv->samples.empty()) {
+        std::fprintf(stderr, "views: Q15 view wrong\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_scheduler_allocations()
+{
+    int failures = 0;
+    std::vector<uint16_t> expected;
+    const auto capture = make_capture(expected);
+
+    host_sim::Scheduler scheduler;
+    scheduler.configure({kSf, kBw, kFs});
+    scheduler.attach_stage(std::make_shared<host_sim::DemodStage>());
+    auto probe = std::make_shared<ProbeStage>();
+    scheduler.attach_stage(probe);
+
+    // Legacy owning source: still works, one allocation (at least) per symbol.
+    CopyingSource legacy(capture);
+    scheduler.run(legacy);
+    const std::size_t legacy_allocs = probe->steady_state_allocations();
+    if (probe->symbols != expected || legacy_allocs < kSymbols - 2) {
+        std::fprintf(stderr, "legacy: %zu symbols, %zu allocations\n", probe->symbols.size(), legacy_allocs);
+        ++failures;
+    }
+
+    host_sim::SpanSymbolSource span(capture, 0, kSps, kSymbols);
+    scheduler.run(span);
+    if (probe->symbols != expected || probe->steady_state_allocations() != 0) {
+        std::fprintf(stderr, "span run: %zu symbols, %zu allocations\n", probe->symbols.size(),
+                     probe->steady_state_allocations());
+        ++failures;
+    }
+
+    host_sim::Scheduler::RealTimeOptions options;
+    options.pace = false;
+    scheduler.run_realtime(span, options);
+    if (probe->symbols != expected || probe->steady_state_allocations() != 0) {
+        std::fprintf(stderr, "span run_realtime: %zu symbols, %zu allocations\n", probe->symbols.size(),
+                     probe->steady_state_allocations());
+        ++failures;
+    }
+    std::printf("  allocations/symbol: legacy %.2f, span 0\n",
+                static_cast<double>(legacy_allocs) / static_cast<double>(kSymbols - 2));
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_views();
+    failures += test_scheduler_allocations();
+
+    std::printf("Symbol source test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
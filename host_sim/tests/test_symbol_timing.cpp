@@ -0,0 +1,165 @@
+/// test_symbol_timing.cpp — Verify the closed-loop symbol timing tracker:
+/// on a chirp stream with a sampling-clock offset and no SFO estimate it
+/// converges to the true stride and keeps the symbols clean, where a fixed
+/// grid loses them; with no offset it decodes everything and leaves the
+/// stride alone; and noise alone (every peak gated) never moves it.
+
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/symbol_timing.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <memory_resource>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int kBandwidth = 125000;
+constexpr std::size_t kSymbols = 250;
+
+struct Stream
+{
+    std::vector<int> symbols;
+    std::vector<std::complex<float>> samples;
+};
+
+// Upchirp of symbol @p s at chip time @p t in [0, N), phase-continuous at
+// the frequency wrap.
+std::complex<float> chirp_sample(int n_bins, int s, double t)
+{
+    const double n = static_cast<double>(n_bins);
+    const double offset = (t < n - s) ? 0.5 : 1.5;
+    const double phase = 2.0 * std::numbers::pi * (t * t / (2.0 * n) + (s / n - offset) * t);
+    return std::polar(1.0f, static_cast<float>(phase));
+}
+
+// Random symbols sampled at os·BW by a clock @p ppm fast.
+Stream make_stream(int sf, int os, double ppm)
+{
+    const int n_bins = 1 << sf;
+    Stream stream;
+    std::mt19937 rng(static_cast<unsigned>(sf * 1000 + os));
+    for (std::size_t i = 0; i < kSymbols; ++i) {
+        stream.symbols.push_back(static_cast<int>(rng() % static_cast<unsigned>(n_bins)));
+    }
+    stream.samples.resize((kSymbols + 2) * static_cast<std::size_t>(n_bins * os));
+    for (std::size_t n = 0; n < stream.samples.size(); ++n) {
+        const double t = static_cast<double>(n) / os * (1.0 + ppm * 1e-6);
+        const auto k = static_cast<std::size_t>(t / n_bins);
+        if (k < kSymbols) {
+            stream.samples[n] = chirp_sample(n_bins, stream.symbols[k], t - static_cast<double>(k) * n_bins);
+        }
+    }
+    return stream;
+}
+
+struct Run
+{
+    int errors{0};
+    double stride{0.0};
+};
+
+Run run(const Stream& stream, int sf, int os, bool closed_loop)
+{
+    host_sim::FftDemodulator demod(sf, kBandwidth * os, kBandwidth);
+    demod.set_frequency_offsets(0.0f, 0, 0.0f);
+    host_sim::LoRaMetadata meta;
+    meta.sf = sf;
+    const int sps = demod.samples_per_symbol();
+    host_sim::SymbolTimingConfig config{static_cast<double>(sps), sps, sf};
+    if (!closed_loop) {
+        config.kp = 0.0f;
+        config.ki = 0.0f;
+    }
+    host_sim::SymbolTimingTracker tracker(config);
+    std::pmr::vector<uint16_t> symbols;
+    host_sim::demodulate_tracked(demod, stream.samples, 0, tracker, kSymbols, meta, symbols);
+    Run result;
+    result.stride = tracker.stride();
+    for (std::size_t i = 0; i < kSymbols; ++i) {
+        if (i >= symbols.size() || symbols[i] != stream.symbols[i]) {
+            ++result.errors;
+        }
+    }
+    return result;
+}
+
+int test_tracks_sfo()
+{
+    int failures = 0;
+    struct Case
+    {
+        int sf;
+        int os;
+        double ppm;
+        int max_errors;
+    };
+    // OS=2 windows land within a quarter bin and track cleanly; at OS=1 the
+    // half-sample rounding still costs a few symbols near the chirp wrap.
+    for (const Case c : {Case{8, 2, 100.0, 2}, Case{8, 2, -100.0, 2}, Case{7, 2, 200.0, 2}, Case{8, 1, 100.0, 30}}) {
+        const Stream stream = make_stream(c.sf, c.os, c.ppm);
+        const Run tracked = run(stream, c.sf, c.os, true);
+        const Run fixed = run(stream, c.sf, c.os, false);
+        const double true_stride = static_cast<double>((1 << c.sf) * c.os) / (1.0 + c.ppm * 1e-6);
+        if (tracked.errors > c.max_errors || fixed.errors < 100 || std::abs(tracked.stride - true_stride) > 0.05) {
+            std::fprintf(stderr, "SF%d OS%d %+.0f ppm: tracked %d errors (stride %.4f, true %.4f), fixed %d\n", c.sf,
+                         c.os, c.ppm, tracked.errors, tracked.stride, true_stride, fixed.errors);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_no_offset()
+{
+    int failures = 0;
+    for (int sf : {7, 10}) {
+        const Stream stream = make_stream(sf, 1, 0.0);
+        const Run tracked = run(stream, sf, 1, true);
+        if (tracked.errors != 0 || std::abs(tracked.stride - (1 << sf)) > 1e-3) {
+            std::fprintf(stderr, "SF%d no offset: %d errors, stride %.5f\n", sf, tracked.errors, tracked.stride);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+int test_noise_holds_stride()
+{
+    int failures = 0;
+    const int sf = 8;
+    host_sim::FftDemodulator demod(sf, kBandwidth, kBandwidth);
+    host_sim::LoRaMetadata meta;
+    meta.sf = sf;
+    std::mt19937 rng(9);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<std::complex<float>> samples(kSymbols * 256);
+    for (auto& s : samples) {
+        s = {noise(rng), noise(rng)};
+    }
+    host_sim::SymbolTimingTracker tracker({256.0, 256, sf});
+    std::pmr::vector<uint16_t> symbols;
+    host_sim::demodulate_tracked(demod, samples, 0, tracker, kSymbols, meta, symbols);
+    if (symbols.size() != kSymbols || tracker.stride() != 256.0) {
+        std::fprintf(stderr, "noise: %zu symbols, stride moved to %.5f\n", symbols.size(), tracker.stride());
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_tracks_sfo();
+    failures += test_no_offset();
+    failures += test_noise_holds_stride();
+    std::printf("Symbol timing test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/// test_trace.cpp — Verify the tracing layer: spans record only while
+/// enabled and nest in time, counters sum across threads and reset, each
+/// thread gets its own track in the Chrome trace, and a wrapped ring keeps
+/// its newest events and reports the overwritten ones.
+
+#include "host_sim/trace.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+namespace trace = host_sim::trace;
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream in(path);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+std::size_t occurrences(const std::string& text, const std::string& needle)
+{
+    std::size_t count = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+int test_spans_and_counters()
+{
+    int failures = 0;
+    trace::reset();
+    {
+        // Disabled: nothing is recorded.
+        const trace::Span idle("idle");
+        trace::count(trace::Counter::ffts, 5);
+    }
+    trace::set_enabled(true);
+    {
+        const trace::Span outer("outer");
+        const trace::Span inner("inner");
+        trace::count(trace::Counter::ffts, 3);
+    }
+    std::thread worker([] {
+        const trace::Span span("worker");
+        trace::count(trace::Counter::ffts, 4);
+        trace::count(trace::Counter::crc_probes);
+    });
+    worker.join();
+    trace::set_enabled(false);
+
+    const auto totals = trace::counters();
+    if (totals[static_cast<std::size_t>(trace::Counter::ffts)] != 7 ||
+        totals[static_cast<std::size_t>(trace::Counter::crc_probes)] != 1) {
+        std::fprintf(stderr, "counters: ffts %llu, crc_probes %llu\n",
+                     static_cast<unsigned long long>(totals[0]),
+                     static_cast<unsigned long long>(totals[static_cast<std::size_t>(trace::Counter::crc_probes)]));
+        ++failures;
+    }
+    const auto list = trace::counter_list();
+    if (list.size() != trace::kCounterCount || list.front().first != "ffts" || list.front().second != 7) {
+        std::fprintf(stderr, "counter_list does not follow the counters\n");
+        ++failures;
+    }
+
+    const auto path = std::filesystem::temp_directory_path() / "host_sim_test_trace.json";
+    const std::size_t spans = trace::write_chrome_trace(path);
+    const std::string json = read_file(path);
+    std::filesystem::remove(path);
+    if (spans != 3 || occurrences(json, "\"ph\":\"X\"") != 3 || json.find("\"idle\"") != std::string::npos ||
+        json.find("\"ffts\":7") == std::string::npos || json.find("\"dropped_events\":0") == std::string::npos) {
+        std::fprintf(stderr, "chrome trace: %zu spans\n%s\n", spans, json.c_str());
+        ++failures;
+    }
+    // The worker's span sits on a track of its own.
+    const auto tid_of = [&](const std::string& name) {
+        const auto at = json.find("\"tid\":", json.find("\"" + name + "\""));
+        return json.substr(at, json.find(',', at) - at);
+    };
+    if (tid_of("outer") != tid_of("inner") || tid_of("outer") == tid_of("worker")) {
+        std::fprintf(stderr, "chrome trace: tracks %s / %s / %s\n", tid_of("outer").c_str(),
+                     tid_of("inner").c_str(), tid_of("worker").c_str());
+        ++failures;
+    }
+
+    trace::reset();
+    if (trace::counters()[0] != 0 || trace::write_chrome_trace(path) != 0) {
+        std::fprintf(stderr, "reset left counters or spans behind\n");
+        ++failures;
+    }
+    std::filesystem::remove(path);
+    return failures;
+}
+
+int test_ring_wrap()
+{
+    int failures = 0;
+    constexpr std::size_t kRing = std::size_t{1} << 16;
+    trace::reset();
+    trace::set_enabled(true);
+    for (std::size_t i = 0; i < kRing + 100; ++i) {
+        const trace::Span span("tick");
+    }
+    trace::set_enabled(false);
+    const auto path = std::filesystem::temp_directory_path() / "host_sim_test_trace_wrap.json";
+    const std::size_t spans = trace::write_chrome_trace(path);
+    std::filesystem::remove(path);
+    if (spans != kRing || trace::dropped_events() != 100) {
+        std::fprintf(stderr, "ring wrap: %zu spans kept, %llu dropped\n", spans,
+                     static_cast<unsigned long long>(trace::dropped_events()));
+        ++failures;
+    }
+    trace::reset();
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_spans_and_counters();
+    failures += test_ring_wrap();
+    std::printf("Trace test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
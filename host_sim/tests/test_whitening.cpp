@@ -0,0 +1,144 @@
+/// test_whitening.cpp — Verify the whitening and Gray primitives: the
+/// constexpr LFSR table reproduces the gr-lora_sdr sequence, word-wide
+/// in-place whitening matches the byte-wise XOR at every offset and
+/// length, the fused whiten/CRC passes match whitening and CRC-16 run
+/// separately in any split, and the prefix-XOR Gray decode matches the
+/// shift loop.
+
+#include "host_sim/crc16.hpp"
+#include "host_sim/gray.hpp"
+#include "host_sim/whitening.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+
+// gr-lora_sdr tables.h, dewhitening_seq.
+constexpr uint8_t kReferenceSequence[255] = {
+    0xFF, 0xFE, 0xFC, 0xF8, 0xF0, 0xE1, 0xC2, 0x85, 0x0B, 0x17, 0x2F, 0x5E, 0xBC, 0x78, 0xF1, 0xE3,
+    0xC6, 0x8D, 0x1A, 0x34, 0x68, 0xD0, 0xA0, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x11, 0x23, 0x47,
+    0x8E, 0x1C, 0x38, 0x71, 0xE2, 0xC4, 0x89, 0x12, 0x25, 0x4B, 0x97, 0x2E, 0x5C, 0xB8, 0x70, 0xE0,
+    0xC0, 0x81, 0x03, 0x06, 0x0C, 0x19, 0x32, 0x64, 0xC9, 0x92, 0x24, 0x49, 0x93, 0x26, 0x4D, 0x9B,
+    0x37, 0x6E, 0xDC, 0xB9, 0x72, 0xE4, 0xC8, 0x90, 0x20, 0x41, 0x82, 0x05, 0x0A, 0x15, 0x2B, 0x56,
+    0xAD, 0x5B, 0xB6, 0x6D, 0xDA, 0xB5, 0x6B, 0xD6, 0xAC, 0x59, 0xB2, 0x65, 0xCB, 0x96, 0x2C, 0x58,
+    0xB0, 0x61, 0xC3, 0x87, 0x0F, 0x1F, 0x3E, 0x7D, 0xFB, 0xF6, 0xED, 0xDB, 0xB7, 0x6F, 0xDE, 0xBD,
+    0x7A, 0xF5, 0xEB, 0xD7, 0xAE, 0x5D, 0xBA, 0x74, 0xE8, 0xD1, 0xA2, 0x44, 0x88, 0x10, 0x21, 0x43,
+    0x86, 0x0D, 0x1B, 0x36, 0x6C, 0xD8, 0xB1, 0x63, 0xC7, 0x8F, 0x1E, 0x3C, 0x79, 0xF3, 0xE7, 0xCE,
+    0x9C, 0x39, 0x73, 0xE6, 0xCC, 0x98, 0x31, 0x62, 0xC5, 0x8B, 0x16, 0x2D, 0x5A, 0xB4, 0x69, 0xD2,
+    0xA4, 0x48, 0x91, 0x22, 0x45, 0x8A, 0x14, 0x29, 0x52, 0xA5, 0x4A, 0x95, 0x2A, 0x54, 0xA9, 0x53,
+    0xA7, 0x4E, 0x9D, 0x3B, 0x77, 0xEE, 0xDD, 0xBB, 0x76, 0xEC, 0xD9, 0xB3, 0x67, 0xCF, 0x9E, 0x3D,
+    0x7B, 0xF7, 0xEF, 0xDF, 0xBF, 0x7E, 0xFD, 0xFA, 0xF4, 0xE9, 0xD3, 0xA6, 0x4C, 0x99, 0x33, 0x66,
+    0xCD, 0x9A, 0x35, 0x6A, 0xD4, 0xA8, 0x51, 0xA3, 0x46, 0x8C, 0x18, 0x30, 0x60, 0xC1, 0x83, 0x07,
+    0x0E, 0x1D, 0x3A, 0x75, 0xEA, 0xD5, 0xAA, 0x55, 0xAB, 0x57, 0xAF, 0x5F, 0xBE, 0x7C, 0xF9, 0xF2,
+    0xE5, 0xCA, 0x94, 0x28, 0x50, 0xA1, 0x42, 0x84, 0x09, 0x13, 0x27, 0x4F, 0x9F, 0x3F, 0x7F};
+
+static_assert(host_sim::whitening_byte(255) == 0xFF && host_sim::whitening_byte(262) == 0x85,
+              "whitening period 255");
+static_assert(host_sim::gray_decode(0) == 0 && host_sim::gray_decode(0x0FFF) == 0x0AAA &&
+                  host_sim::gray_decode(0x8000) == 0xFFFF,
+              "gray decode");
+
+int test_sequence()
+{
+    int failures = 0;
+    for (std::size_t i = 0; i < 600; ++i) {
+        if (host_sim::whitening_byte(i) != kReferenceSequence[i % 255]) {
+            std::fprintf(stderr, "whitening byte %zu differs\n", i);
+            ++failures;
+            break;
+        }
+    }
+    const auto sequence = host_sim::WhiteningSequencer{}.sequence(300);
+    for (std::size_t i = 0; i < sequence.size(); ++i) {
+        if (sequence[i] != kReferenceSequence[i % 255]) {
+            std::fprintf(stderr, "WhiteningSequencer::sequence byte %zu differs\n", i);
+            ++failures;
+            break;
+        }
+    }
+    return failures;
+}
+
+int test_in_place_and_fused()
+{
+    int failures = 0;
+    std::mt19937 rng(3);
+    for (std::size_t len : {0u, 1u, 7u, 8u, 9u, 31u, 32u, 33u, 100u, 255u, 256u, 600u}) {
+        std::vector<uint8_t> plain(len);
+        for (auto& b : plain) {
+            b = static_cast<uint8_t>(rng());
+        }
+        for (std::size_t offset : {0u, 1u, 200u, 254u, 255u, 510u + 17u}) {
+            std::vector<uint8_t> expected = plain;
+            for (std::size_t i = 0; i < len; ++i) {
+                expected[i] ^= kReferenceSequence[(offset + i) % 255];
+            }
+            std::vector<uint8_t> in_place = plain;
+            host_sim::whiten_in_place(in_place, offset);
+            if (in_place != expected) {
+                std::fprintf(stderr, "whiten_in_place: length %zu offset %zu differs\n", len, offset);
+                ++failures;
+            }
+
+            // TX: CRC over the plain bytes, fed in two pieces.
+            const std::size_t split = len / 3;
+            std::vector<uint8_t> tx = plain;
+            uint16_t crc = host_sim::crc16_then_whiten(std::span(tx).first(split), 0x0000, offset);
+            crc = host_sim::crc16_then_whiten(std::span(tx).subspan(split), crc, offset + split);
+            if (tx != expected || crc != host_sim::crc16_ccitt(plain.data(), len)) {
+                std::fprintf(stderr, "crc16_then_whiten: length %zu offset %zu differs\n", len, offset);
+                ++failures;
+            }
+
+            // RX: back to the plain bytes, CRC over what comes out.
+            crc = host_sim::dewhiten_then_crc16(std::span(tx).first(split), 0x0000, offset);
+            crc = host_sim::dewhiten_then_crc16(std::span(tx).subspan(split), crc, offset + split);
+            if (tx != plain || crc != host_sim::crc16_ccitt(plain.data(), len)) {
+                std::fprintf(stderr, "dewhiten_then_crc16: length %zu offset %zu differs\n", len, offset);
+                ++failures;
+            }
+        }
+    }
+    const std::vector<uint8_t> payload = {'h', 'e', 'l', 'l', 'o'};
+    host_sim::WhiteningSequencer sequencer;
+    if (sequencer.undo(sequencer.apply(payload)) != payload || sequencer.apply(payload)[0] != ('h' ^ 0xFF)) {
+        std::fprintf(stderr, "WhiteningSequencer apply/undo\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_gray()
+{
+    int failures = 0;
+    for (uint32_t symbol = 0; symbol < 65536; ++symbol) {
+        auto value = static_cast<uint16_t>(symbol);
+        uint16_t expected = value;
+        while (value >>= 1u) {
+            expected ^= value;
+        }
+        if (host_sim::gray_decode(static_cast<uint16_t>(symbol)) != expected) {
+            std::fprintf(stderr, "gray_decode(%u) differs\n", symbol);
+            ++failures;
+            break;
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_sequence();
+    failures += test_in_place_and_fused();
+    failures += test_gray();
+    std::printf("Whitening test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/// test_window_cache.cpp — Verify DemodWindowCache: symbols and LLRs it
+/// assembles for any grid (offset, SFO-scaled stride, partial ranges) are
+/// exactly what a fresh demodulator returns window by window; an SFO sweep
+/// over one burst runs far fewer FFTs than it looks up; and candidates
+/// sharing the cache from parallel workers see the serial results.
+
+#include "host_sim/candidate_search.hpp"
+#include "host_sim/fft_demod.hpp"
+#include "host_sim/lora_params.hpp"
+#include "host_sim/soft_decode.hpp"
+#include "host_sim/window_cache.hpp"
+#include "host_sim/worker_pool.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr int kSf = 7;
+constexpr int kBandwidth = 125000;
+constexpr int kSampleRate = 2 * kBandwidth;
+constexpr std::size_t kSymbols = 40;
+
+std::vector<std::complex<float>> make_samples(std::size_t count)
+{
+    std::mt19937 rng(11);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<std::complex<float>> samples(count);
+    for (auto& s : samples) {
+        s = {noise(rng), noise(rng)};
+    }
+    return samples;
+}
+
+host_sim::LoRaMetadata make_meta()
+{
+    host_sim::LoRaMetadata meta;
+    meta.sf = kSf;
+    meta.bw = kBandwidth;
+    meta.sample_rate = kSampleRate;
+    meta.cr = 1;
+    return meta;
+}
+
+std::unique_ptr<host_sim::FftDemodulator> make_demod()
+{
+    auto demod = std::make_unique<host_sim::FftDemodulator>(kSf, kSampleRate, kBandwidth);
+    demod->set_frequency_offsets(0.25f, 3, 0.0f);
+    return demod;
+}
+
+double sfo_stride(int sps, double ppm)
+{
+    return static_cast<double>(sps) * (1.0 + ppm * 1e-6);
+}
+
+int test_matches_fresh_demod()
+{
+    int failures = 0;
+    const auto meta = make_meta();
+    auto demod = make_demod();
+    const int sps = demod->samples_per_symbol();
+    const auto samples = make_samples(static_cast<std::size_t>(sps) * (kSymbols + 2));
+    host_sim::DemodWindowCache cache(samples, kSf, true);
+
+    for (std::size_t first : {0, 3, 17}) {
+        for (double ppm : {0.0, 40.0, -100.0}) {
+            const double stride = sfo_stride(sps, ppm);
+            // Fetched in two pieces, as the header probe and payload do.
+            std::pmr::vector<uint16_t> symbols;
+            std::pmr::vector<host_sim::SoftSymbol> llrs;
+            cache.demodulate(*demod, first, stride, 0, 8, meta, symbols, &llrs);
+            cache.demodulate(*demod, first, stride, symbols.size(), kSymbols + 5, meta, symbols, &llrs);
+
+            auto fresh = make_demod();
+            std::size_t expected = 0;
+            for (std::size_t i = 0;; ++i) {
+                const auto start = first + static_cast<std::size_t>(std::round(static_cast<double>(i) * stride));
+                if (start + static_cast<std::size_t>(sps) > samples.size()) {
+                    break;
+                }
+                const uint16_t symbol = fresh->demodulate(&samples[start]);
+                const auto llr = host_sim::compute_soft_symbol(fresh->get_fft_magnitudes_sq().data(), kSf, i < 8,
+                                                               fresh->current_cfo_int());
+                if (i >= symbols.size() || symbols[i] != symbol || llrs[i] != llr) {
+                    std::fprintf(stderr, "fresh: first %zu ppm %.0f symbol %zu differs\n", first, ppm, i);
+                    ++failures;
+                    break;
+                }
+                ++expected;
+            }
+            if (symbols.size() != expected || llrs.size() != expected) {
+                std::fprintf(stderr, "fresh: first %zu ppm %.0f returned %zu symbols, expected %zu\n", first, ppm,
+                             symbols.size(), expected);
+                ++failures;
+            }
+        }
+    }
+
+    host_sim::DemodWindowCache hard_only(samples, kSf, false);
+    std::pmr::vector<uint16_t> symbols;
+    std::pmr::vector<host_sim::SoftSymbol> llrs;
+    bool threw = false;
+    try {
+        hard_only.demodulate(*demod, 0, sps, 0, 4, meta, symbols, &llrs);
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    if (!threw) {
+        std::fprintf(stderr, "hard-only cache produced LLRs\n");
+        ++failures;
+    }
+    return failures;
+}
+
+int test_sweep_shares_windows()
+{
+    int failures = 0;
+    const auto meta = make_meta();
+    auto demod = make_demod();
+    const int sps = demod->samples_per_symbol();
+    const auto samples = make_samples(static_cast<std::size_t>(sps) * (kSymbols + 2));
+    host_sim::DemodWindowCache cache(samples, kSf, false);
+
+    // ±100 ppm in 10 ppm steps, as the OS=2 SFO recovery sweeps it.
+    for (int ppm = -100; ppm <= 100; ppm += 10) {
+        std::pmr::vector<uint16_t> symbols;
+        cache.demodulate(*demod, 1, sfo_stride(sps, ppm), 0, kSymbols, meta, symbols);
+    }
+    if (cache.lookups() != 21 * kSymbols || cache.windows() * 4 > cache.lookups()) {
+        std::fprintf(stderr, "sweep: %zu FFTs for %zu lookups\n", cache.windows(), cache.lookups());
+        ++failures;
+    }
+    return failures;
+}
+
+int test_parallel_candidates()
+{
+    int failures = 0;
+    const auto meta = make_meta();
+    const int sps = make_demod()->samples_per_symbol();
+    const auto samples = make_samples(static_cast<std::size_t>(sps) * (kSymbols + 2));
+    constexpr std::size_t kCandidates = 21;
+
+    std::vector<std::pmr::vector<uint16_t>> serial(kCandidates);
+    {
+        auto demod = make_demod();
+        host_sim::DemodWindowCache cache(samples, kSf, false);
+        for (std::size_t c = 0; c < kCandidates; ++c) {
+            cache.demodulate(*demod, c % 3, sfo_stride(sps, -100.0 + 10.0 * c), 0, kSymbols, meta, serial[c]);
+        }
+    }
+
+    std::vector<std::pmr::vector<uint16_t>> parallel(kCandidates);
+    host_sim::DemodWindowCache cache(samples, kSf, false);
+    host_sim::PerWorker<host_sim::FftDemodulator> demods;
+    host_sim::find_first_candidate(kCandidates, [&](const host_sim::CandidateContext& ctx) {
+        auto& demod = demods.get(ctx.worker(), make_demod);
+        const std::size_t c = ctx.index();
+        cache.demodulate(demod, c % 3, sfo_stride(sps, -100.0 + 10.0 * c), 0, kSymbols, meta, parallel[c]);
+        return false;
+    });
+    for (std::size_t c = 0; c < kCandidates; ++c) {
+        if (parallel[c] != serial[c]) {
+            std::fprintf(stderr, "parallel: candidate %zu differs from the serial sweep\n", c);
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += test_matches_fresh_demod();
+    failures += test_sweep_shares_windows();
+    failures += test_parallel_candidates();
+    std::printf("Window cache test: %d failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
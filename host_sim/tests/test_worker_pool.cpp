@@ -0,0 +1,126 @@
+/// test_worker_pool.cpp — Verify that WorkerPool::parallel_for() runs every
+/// index exactly once with in-range worker slots, survives nested and
+/// concurrent callers without deadlocking, propagates task exceptions, and
+/// stays usable afterwards.
+
+#include "host_sim/worker_pool.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+int check_coverage(host_sim::WorkerPool& pool, std::size_t count, const char* label)
+{
+    std::vector<std::atomic<int>> hits(count);
+    std::atomic<bool> bad_worker{false};
+    pool.parallel_for(count, [&](std::size_t i, std::size_t worker) {
+        if (worker >= pool.worker_count()) {
+            bad_worker = true;
+        }
+        hits[i].fetch_add(1);
+    });
+
+    int failures = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (hits[i].load() != 1) {
+            std::fprintf(stderr, "%s: index %zu ran %d times\n", label, i, hits[i].load());
+            ++failures;
+        }
+    }
+    if (bad_worker) {
+        std::fprintf(stderr, "%s: worker index out of range\n", label);
+        ++failures;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    // A private pool exercises real threads even on single-core hosts.
+    host_sim::WorkerPool pool(4);
+    for (std::size_t count : {0u, 1u, 3u, 64u, 1000u}) {
+        failures += check_coverage(pool, count, "private");
+    }
+    failures += check_coverage(host_sim::WorkerPool::shared(), 257, "shared");
+
+    // Per-worker slots are private to the worker running the task.
+    {
+        host_sim::PerWorker<std::vector<int>> slots(pool);
+        std::atomic<bool> clobbered{false};
+        pool.parallel_for(500, [&](std::size_t i, std::size_t worker) {
+            auto& v = slots.get(worker, [] { return std::make_unique<std::vector<int>>(); });
+            v.push_back(static_cast<int>(i));
+            if (v.back() != static_cast<int>(i)) {
+                clobbered = true;
+            }
+        });
+        if (clobbered) {
+            std::fprintf(stderr, "per-worker slot shared between threads\n");
+            ++failures;
+        }
+    }
+
+    // Nested calls run inline instead of deadlocking.
+    std::atomic<int> nested{0};
+    pool.parallel_for(8, [&](std::size_t, std::size_t) {
+        pool.parallel_for(8, [&](std::size_t, std::size_t worker) {
+            if (worker == 0) {
+                nested.fetch_add(1);
+            }
+        });
+    });
+    if (nested.load() != 64) {
+        std::fprintf(stderr, "nested parallel_for ran %d of 64 tasks\n", nested.load());
+        ++failures;
+    }
+
+    // Several external threads submitting at once all complete.
+    {
+        std::atomic<int> total{0};
+        std::vector<std::thread> callers;
+        for (int t = 0; t < 4; ++t) {
+            callers.emplace_back([&] {
+                for (int round = 0; round < 50; ++round) {
+                    pool.parallel_for(16, [&](std::size_t, std::size_t) { total.fetch_add(1); });
+                }
+            });
+        }
+        for (auto& t : callers) {
+            t.join();
+        }
+        if (total.load() != 4 * 50 * 16) {
+            std::fprintf(stderr, "concurrent callers ran %d of %d tasks\n", total.load(), 4 * 50 * 16);
+            ++failures;
+        }
+    }
+
+    // Exceptions reach the caller and the pool keeps working.
+    bool threw = false;
+    try {
+        pool.parallel_for(100, [](std::size_t i, std::size_t) {
+            if (i == 17) {
+                throw std::runtime_error("task failure");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        std::fprintf(stderr, "task exception was swallowed\n");
+        ++failures;
+    }
+    failures += check_coverage(pool, 128, "after exception");
+
+    std::printf("Worker pool test (%zu shared workers): %d failures\n",
+                host_sim::WorkerPool::shared().worker_count(), failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+
+"""Compare host_sim_bench results against a baseline run."""
+
+from __future__ import annotations
+
+import argparse
+import json
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional
+
+
+def load_results(path: Path) -> Dict[str, dict]:
+    data = json.loads(path.read_text())
+    return {entry["name"]: entry for entry in data.get("benchmarks", [])}
+
+
+def compare(baseline: Dict[str, dict], current: Dict[str, dict], max_slowdown: float,
+            allow_missing: bool) -> List[str]:
+    failures: List[str] = []
+    for name, base in baseline.items():
+        actual = current.get(name)
+        if actual is None:
+            if not allow_missing:
+                failures.append(f"{name}: missing from current results")
+            continue
+        base_ns = float(base["ns_per_item"])
+        actual_ns = float(actual["ns_per_item"])
+        if base_ns > 0.0 and actual_ns > base_ns * (1.0 + max_slowdown):
+            failures.append(
+                f"{name}: {actual_ns:.6g} ns/{actual.get('unit', 'item')} is "
+                f"{actual_ns / base_ns - 1.0:.1%} slower than baseline {base_ns:.6g}"
+            )
+        # Allocations are deterministic: any increase is a regression.
+        if float(actual["allocs_per_iter"]) > float(base["allocs_per_iter"]):
+            failures.append(
+                f"{name}: {actual['allocs_per_iter']} allocations per iteration, "
+                f"baseline {base['allocs_per_iter']}"
+            )
+    return failures
+
+
+def main(argv: Optional[Iterable[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline", type=Path, help="Baseline host_sim_bench --json output")
+    parser.add_argument("current", type=Path, help="Current host_sim_bench --json output")
+    parser.add_argument(
+        "--max-slowdown",
+        type=float,
+        default=0.25,
+        help="Allowed ns/item increase as a fraction of the baseline (default: 0.25)",
+    )
+    parser.add_argument(
+        "--allow-missing",
+        action="store_true",
+        help="Skip baseline benchmarks absent from the current run (e.g. with --filter)",
+    )
+    args = parser.parse_args(argv)
+
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+    failures = compare(baseline, current, args.max_slowdown, args.allow_missing)
+
+    if failures:
+        print("Benchmark comparison failed:")
+        for failure in failures:
+            print(f"  - {failure}")
+        return 1
+
+    print(f"Benchmark comparison passed ({len(baseline)} benchmarks).")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -58,6 +58,10 @@ def compute_summary_metrics(summary: Dict[str, Any]) -> Dict[str, Any]:
     else:
         metrics["stage_timing_avg_ns"] = 0.0
         metrics["stage_timing_p95_ns"] = 0.0
+    # lora_sweep point summaries also carry link-level counts.
+    for key in ("packets", "header_ok", "crc_ok", "per", "ber", "decode_ms_p50", "decode_ms_p90", "decode_ms_p99"):
+        if key in summary:
+            metrics[key] = summary[key]
     return metrics
 
 
@@ -101,7 +105,7 @@ def main(argv: Optional[Iterable[str]] = None) -> int:
     parser.add_argument(
         "summary_dir",
         type=Path,
-        help="Directory containing summary JSON files produced by lora_replay",
+        help="Directory containing summary JSON files produced by lora_replay or lora_sweep",
     )
     args = parser.parse_args(argv)
 
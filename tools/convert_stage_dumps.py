@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+
+"""Convert lora_replay stage dumps between one-value-per-line text and the binary .stage format."""
+
+from __future__ import annotations
+
+import argparse
+import struct
+from pathlib import Path
+from typing import Iterable, List, Optional
+
+MAGIC = b"LSTG"
+VERSION = 1
+RAW = 0
+DELTA_VARINT = 1
+HEADER = struct.Struct("<4sBBBBQ")
+STAGES = ("fft", "gray", "deinterleaver", "hamming")
+
+
+def value_width(lo: int, hi: int) -> int:
+    """Narrowest of 1/2/4/8 bytes holding [lo, hi]; mirrors the C++ writer."""
+    for width in (1, 2, 4, 8):
+        bits = 8 * width
+        if lo >= 0 and hi < (1 << bits):
+            return width
+        if lo < 0 and -(1 << (bits - 1)) <= lo and hi < (1 << (bits - 1)):
+            return width
+    raise ValueError(f"values [{lo}, {hi}] do not fit in 64 bits")
+
+
+def _wrap64(value: int) -> int:
+    value &= (1 << 64) - 1
+    return value - (1 << 64) if value >= (1 << 63) else value
+
+
+def encode(values: List[int], encoding: int) -> bytes:
+    lo = min(values, default=0)
+    hi = max(values, default=0)
+    width = value_width(lo, hi)
+    out = bytearray(HEADER.pack(MAGIC, VERSION, encoding, width, 1 if lo < 0 else 0, len(values)))
+    if encoding == RAW:
+        mask = (1 << (8 * width)) - 1
+        for value in values:
+            out += (value & mask).to_bytes(width, "little")
+        return bytes(out)
+    previous = 0
+    for value in values:
+        delta = _wrap64(value - previous)
+        previous = value
+        bits = ((delta << 1) ^ (delta >> 63)) & ((1 << 64) - 1)
+        while bits >= 0x80:
+            out.append((bits & 0x7F) | 0x80)
+            bits >>= 7
+        out.append(bits)
+    return bytes(out)
+
+
+def decode(data: bytes) -> List[int]:
+    if len(data) < HEADER.size:
+        raise ValueError("shorter than the header")
+    magic, version, encoding, width, flags, count = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION or width not in (1, 2, 4, 8):
+        raise ValueError("not a version 1 stage dump")
+    body = data[HEADER.size:]
+    signed = bool(flags & 1)
+    if encoding == RAW:
+        if len(body) != count * width:
+            raise ValueError("size does not match the value count")
+        return [int.from_bytes(body[i:i + width], "little", signed=signed)
+                for i in range(0, len(body), width)]
+    if encoding != DELTA_VARINT:
+        raise ValueError(f"unknown encoding {encoding}")
+    values: List[int] = []
+    value = 0
+    pos = 0
+    for _ in range(count):
+        bits = 0
+        shift = 0
+        while True:
+            if pos == len(body) or shift > 63:
+                raise ValueError("truncated or overlong varint")
+            byte = body[pos]
+            pos += 1
+            bits |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        value = _wrap64(value + ((bits >> 1) ^ -(bits & 1)))
+        values.append(value)
+    if pos != len(body):
+        raise ValueError("trailing bytes")
+    return values
+
+
+def read_text(path: Path) -> List[int]:
+    return [int(line) for line in path.read_text().split()]
+
+
+def write_text(path: Path, values: List[int]) -> None:
+    path.write_text("".join(f"{value}\n" for value in values))
+
+
+def collect(paths: Iterable[Path], suffix: str) -> List[Path]:
+    files: List[Path] = []
+    for path in paths:
+        if path.is_dir():
+            for stage in STAGES:
+                files.extend(sorted(path.rglob(f"*_{stage}{suffix}")))
+        else:
+            files.append(path)
+    return files
+
+
+def main(argv: Optional[Iterable[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("paths", type=Path, nargs="+",
+                        help="Stage dump files, or directories searched for *_<stage> dumps")
+    parser.add_argument("--to", choices=("binary", "delta", "text"), default="binary",
+                        help="Output form (default: binary); text converts .stage files back")
+    parser.add_argument("--remove", action="store_true", help="Delete each source after converting it")
+    args = parser.parse_args(argv)
+
+    to_text = args.to == "text"
+    sources = collect(args.paths, ".stage" if to_text else ".txt")
+    for source in sources:
+        if to_text:
+            target = source.with_suffix(".txt")
+            write_text(target, decode(source.read_bytes()))
+        else:
+            target = source.with_suffix(".stage")
+            target.write_bytes(encode(read_text(source), DELTA_VARINT if args.to == "delta" else RAW))
+        if args.remove:
+            source.unlink()
+        print(f"{source} -> {target}")
+
+    print(f"Converted {len(sources)} stage dump(s).")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())